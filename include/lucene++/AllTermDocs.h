@@ -19,7 +19,7 @@ public:
     LUCENE_CLASS(AllTermDocs);
 
 protected:
-    BitVectorWeakPtr _deletedDocs;
+    BitVectorPtr deletedDocs;
 
 public:
     virtual bool isDeleted(int32_t doc);
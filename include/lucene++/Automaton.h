@@ -0,0 +1,112 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOMATON_H
+#define AUTOMATON_H
+
+#include "LuceneObject.h"
+
+namespace Lucene {
+
+/// A transition of an {@link Automaton} on every label from min to max (inclusive) to the state dest.
+struct AutomatonTransition {
+    int32_t min;
+    int32_t max;
+    int32_t dest;
+};
+
+/// Finite-state automaton over the characters of a term, used to match terms without comparing each
+/// one against the query, see {@link AutomatonTermEnum}.
+///
+/// States are numbered from 0 in the order they are created, state 0 being the initial state.  An
+/// automaton is built non-deterministic, with overlapping transitions and epsilon transitions allowed,
+/// and {@link #determinize()} turns it into the equivalent deterministic automaton that can be {@link
+/// #step}ped through, which {@link #minimize()} reduces to the fewest states.  Labels are the values of
+/// the characters (code points unless wchar_t is 16 bits).
+class LPPAPI Automaton : public LuceneObject {
+public:
+    Automaton();
+    virtual ~Automaton();
+
+    LUCENE_CLASS(Automaton);
+
+public:
+    /// Smallest and largest label of a transition.
+    static const int32_t MIN_LABEL;
+    static const int32_t MAX_LABEL;
+
+    /// Default limit on the states of {@link #determinize()}, which can take exponential time and space.
+    static const int32_t DEFAULT_MAX_DETERMINIZED_STATES;
+
+protected:
+    Collection<uint8_t> accept;
+    Collection< Collection<AutomatonTransition> > transitions;
+    Collection< Collection<int32_t> > epsilons;
+    bool deterministic;
+
+public:
+    /// Add a state, returning its number.
+    int32_t createState();
+
+    int32_t getNumStates();
+
+    void setAccept(int32_t state, bool accept);
+    bool isAccept(int32_t state);
+
+    /// Add a transition on the labels min to max (inclusive).
+    void addTransition(int32_t source, int32_t dest, int32_t min, int32_t max);
+
+    /// Add a transition on a single label.
+    void addTransition(int32_t source, int32_t dest, int32_t label);
+
+    /// Add a transition that consumes no label.
+    void addEpsilon(int32_t source, int32_t dest);
+
+    int32_t getNumTransitions(int32_t state);
+
+    /// Returns the transitions of a state, sorted by label once the automaton is deterministic.
+    const AutomatonTransition& getTransition(int32_t state, int32_t index);
+
+    /// Returns true if this automaton was returned by {@link #determinize()} or {@link #minimize()}.
+    bool isDeterministic();
+
+    /// Returns the equivalent deterministic automaton, built by subset construction.  It has no dead
+    /// states: every state but a non-accepting initial state can reach an accepting state, so a state
+    /// that doesn't accept always has a transition.
+    /// @param maxDeterminizedStates Throw IllegalArgumentException rather than build more states than this.
+    AutomatonPtr determinize(int32_t maxDeterminizedStates = DEFAULT_MAX_DETERMINIZED_STATES);
+
+    /// Returns the equivalent deterministic automaton with the fewest states, determinizing first if needed.
+    /// @param maxDeterminizedStates Throw IllegalArgumentException rather than determinize to more states than this.
+    AutomatonPtr minimize(int32_t maxDeterminizedStates = DEFAULT_MAX_DETERMINIZED_STATES);
+
+    /// Returns the state reached from state on label, or -1 if there is none.  Deterministic only.
+    int32_t step(int32_t state, int32_t label);
+
+    /// Returns true if the automaton accepts the text.  Deterministic only.
+    bool run(const String& text);
+
+    /// Returns true if the automaton accepts no strings at all.  Deterministic only.
+    bool isEmpty();
+
+    /// Returns true if the automaton accepts a finite number of strings, ie. has no loop.
+    /// Deterministic only.
+    bool isFinite();
+
+    virtual String toString();
+
+protected:
+    /// Add to the sorted set of states every state reachable from it through epsilon transitions.
+    void closure(Collection<int32_t> states);
+
+    /// Returns a copy without the states that can't be reached from the initial state or can't reach
+    /// an accepting state.
+    AutomatonPtr removeDeadStates();
+};
+
+}
+
+#endif
@@ -0,0 +1,68 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOMATONFUZZYTERMENUM_H
+#define AUTOMATONFUZZYTERMENUM_H
+
+#include "AutomatonTermEnum.h"
+
+namespace Lucene {
+
+/// Subclass of AutomatonTermEnum for enumerating all terms that are similar to the specified filter term,
+/// driven by {@link LevenshteinAutomata} so that only the terms close to the matches are read, rather
+/// than every term sharing the prefix as {@link FuzzyTermEnum} does.
+///
+/// Term enumerations are always ordered by Term.compareTo().  Each term in the enumeration is greater
+/// than all that precede it.
+class LPPAPI AutomatonFuzzyTermEnum : public AutomatonTermEnum {
+public:
+    /// Enumerate the terms {@link FuzzyTermEnum} would, with the same {@link #difference()}.  Only
+    /// possible when {@link #maxEditsForSimilarity} is at most {@link
+    /// LevenshteinAutomata#MAXIMUM_SUPPORTED_DISTANCE}.
+    AutomatonFuzzyTermEnum(const IndexReaderPtr& reader, const TermPtr& term, double minSimilarity, int32_t prefixLength);
+
+    /// Enumerate the terms {@link FuzzyTermEnum} would that are also within maxEdits edits of term, with
+    /// the same {@link #difference()}.
+    AutomatonFuzzyTermEnum(const IndexReaderPtr& reader, const TermPtr& term, double minSimilarity, int32_t prefixLength, int32_t maxEdits);
+
+    /// Enumerate the terms within maxEdits edits of term that start with its first prefixLength characters.
+    /// The difference of a term is 1 - edits / (maxEdits + 1).
+    /// @param transpositions Whether the transposition of two adjacent characters counts as one edit
+    AutomatonFuzzyTermEnum(const IndexReaderPtr& reader, const TermPtr& term, int32_t maxEdits, int32_t prefixLength, bool transpositions);
+
+    virtual ~AutomatonFuzzyTermEnum();
+
+    LUCENE_CLASS(AutomatonFuzzyTermEnum);
+
+protected:
+    /// Automata accepting the terms within 0 to maxEdits edits.
+    Collection<AutomatonPtr> automata;
+    int32_t maxEdits;
+    bool raw;
+
+    String text;
+    String prefix;
+
+    double _similarity;
+    double minimumSimilarity;
+    double scale_factor;
+
+public:
+    /// Returns the number of edits a term with a similarity greater than minSimilarity can be from term.
+    static int32_t maxEditsForSimilarity(const TermPtr& term, double minSimilarity);
+
+    virtual double difference();
+
+protected:
+    void ConstructSimilarityTermEnum(const IndexReaderPtr& reader, const TermPtr& term, double minSimilarity, int32_t prefixLength, int32_t maxEdits);
+    void ConstructFuzzyTermEnum(const IndexReaderPtr& reader, const TermPtr& term, int32_t prefixLength, bool transpositions);
+
+    virtual bool termCompare(const TermPtr& term);
+};
+
+}
+
+#endif
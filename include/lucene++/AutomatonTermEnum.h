@@ -0,0 +1,92 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOMATONTERMENUM_H
+#define AUTOMATONTERMENUM_H
+
+#include "FilteredTermEnum.h"
+
+namespace Lucene {
+
+/// Subclass of FilteredTermEnum for enumerating the terms of a field accepted by a deterministic {@link
+/// Automaton}.
+///
+/// Rather than testing every term of the field, when a term is rejected the enumeration computes the
+/// next string after it that the automaton could accept and seeks the terms there, so that only the
+/// terms around the matches are read.  Where the automaton loops, so that most terms are likely to
+/// match, the terms are read in sequence instead.
+///
+/// Term enumerations are always ordered by Term.compareTo().  Each term in the enumeration is greater
+/// than all that precede it.
+class LPPAPI AutomatonTermEnum : public FilteredTermEnum {
+public:
+    /// @param automaton A deterministic automaton, as returned by {@link Automaton#determinize()}
+    AutomatonTermEnum(const IndexReaderPtr& reader, const String& field, const AutomatonPtr& automaton);
+    virtual ~AutomatonTermEnum();
+
+    LUCENE_CLASS(AutomatonTermEnum);
+
+protected:
+    AutomatonTermEnum();
+
+protected:
+    IndexReaderPtr reader;
+    String field;
+    AutomatonPtr automaton;
+    bool finite;
+    bool _endEnum;
+
+    /// The string to seek to, built by {@link #nextString}.
+    String seekText;
+
+    /// State reached after each character of seekText.
+    Collection<int32_t> savedStates;
+
+    /// Marks the states visited by the current {@link #nextString} call.
+    Collection<int32_t> visited;
+    int32_t curGen;
+
+    /// When set, the terms less than linearUpperBound are read in sequence rather than sought.
+    bool linear;
+    String linearUpperBound;
+
+public:
+    virtual double difference();
+    virtual bool next();
+    virtual void close();
+
+protected:
+    void ConstructTermEnum(const IndexReaderPtr& reader, const String& field, const AutomatonPtr& automaton);
+
+    virtual bool termCompare(const TermPtr& term);
+    virtual bool endEnum();
+
+    /// Position on the first term at or after the current one that matches.
+    bool findTerm();
+
+    /// Reposition the underlying enumeration on the first term greater than or equal to text.
+    void seek(const String& text);
+
+    /// Set seekText to the smallest string greater than text the automaton could accept, returning
+    /// false if there is none.
+    bool nextString(const String& text);
+
+    /// Set seekText to its first position characters followed by the smallest string accepted from
+    /// state that is greater than the rest of seekText, returning false if there is none.
+    bool nextString(int32_t state, int32_t position);
+
+    /// Increment the last character of seekText that can be, dropping the ones after it, returning its
+    /// position or -1 if there is none.
+    int32_t backtrack(int32_t position);
+
+    /// Record that the automaton loops at position of seekText, so the terms up to the end of the
+    /// transition taken there can be read in sequence.
+    void setLinear(int32_t position);
+};
+
+}
+
+#endif
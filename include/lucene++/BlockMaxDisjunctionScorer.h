@@ -0,0 +1,84 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef BLOCKMAXDISJUNCTIONSCORER_H
+#define BLOCKMAXDISJUNCTIONSCORER_H
+
+#include "Scorer.h"
+
+namespace Lucene {
+
+/// A Scorer for disjunctions of terms that skips documents which can't score above the threshold given to
+/// {@link #setMinCompetitiveScore(double)}, using the block-max MaxScore algorithm.
+///
+/// Docs are visited in windows that end where the first of the terms' current skip intervals ends.  Within a
+/// window each term's score is bounded using the competitive pairs of term freq and norm stored in its skip
+/// data.  Terms are sorted by these bounds and the terms whose bounds sum up to no more than the
+/// threshold are non-essential: a doc matching only non-essential terms can't compete, so candidates are
+/// drawn from the essential terms alone and non-essential terms are only advanced to candidates that may
+/// still compete.  Windows in which no doc can compete are skipped without decoding any postings.
+///
+/// Scores are computed exactly as by {@link BooleanScorer}, so the top hits are the same.
+class LPPAPI BlockMaxDisjunctionScorer : public Scorer {
+public:
+    /// @param similarity The similarity providing the coord factors.
+    /// @param scorers The scorers of the terms.
+    /// @param impacts Term docs seeked to each of the terms, used only to read impacts.
+    BlockMaxDisjunctionScorer(const SimilarityPtr& similarity, Collection<TermScorerPtr> scorers, Collection<SegmentTermDocsPtr> impacts);
+    virtual ~BlockMaxDisjunctionScorer();
+
+    LUCENE_CLASS(BlockMaxDisjunctionScorer);
+
+protected:
+    Collection<TermScorerPtr> scorers;
+    Collection<SegmentTermDocsPtr> impacts;
+
+    Collection<double> coordFactors;
+    double maxCoord;
+
+    /// Score bound of every term within the current window
+    Collection<double> blockMaxScores;
+
+    /// Terms ordered by ascending score bound, the first numNonEssential of them are non-essential
+    Collection<int32_t> order;
+    Collection<double> boundSums; // boundSums[i] is the sum of the bounds of the first i terms in order
+    int32_t numNonEssential;
+
+    /// Scores of the terms matching the current candidate
+    Collection<double> termScores;
+    Collection<uint8_t> termMatches;
+
+    double minCompetitiveScore;
+    int32_t windowEnd; // last doc of the current window, inclusive
+
+    int32_t doc;
+    double currentScore;
+
+public:
+    virtual int32_t docID();
+    virtual int32_t nextDoc();
+    virtual int32_t advance(int32_t target);
+    virtual double score();
+    virtual void setMinCompetitiveScore(double minScore);
+
+protected:
+    /// Start a new window at or after target, returns the first doc of the window or NO_MORE_DOCS if no doc
+    /// from target on can compete.
+    int32_t updateWindow(int32_t target);
+
+    /// Sort the terms by their score bounds in the current window and find the non-essential ones.
+    void updatePartition();
+
+    /// Returns true if docs whose score is at most bound can't compete.
+    bool canPrune(double bound);
+
+    /// Returns the score bound of a term within the current window.
+    double blockMaxScore(int32_t term);
+};
+
+}
+
+#endif
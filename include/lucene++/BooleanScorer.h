@@ -14,8 +14,8 @@ namespace Lucene {
 
 /// BooleanScorer uses a ~16k array to score windows of docs. So it scores docs 0-16k first, then docs 16-32k,
 /// etc. For each window it iterates through all query terms and accumulates a score in table[doc%16k]. It also
-/// stores in the table a bitmask representing which terms contributed to the score.  Non-zero scores are chained
-/// in a linked list. At the end of scoring each window it then iterates through the linked list and, if the
+/// stores in the table a bitmask representing which terms contributed to the score.  The buckets filled are listed
+/// in the order they were filled. At the end of scoring each window it then iterates through that list and, if the
 /// bitmask matches the boolean constraints, collects a hit.  For boolean queries with lots of frequent terms this
 /// can be much faster, since it does not need to update a priority queue for each posting, instead performing
 /// constant-time operations per posting.  The only downside is that it results in hits being delivered out-of-order
@@ -33,7 +33,6 @@ public:
     virtual ~BooleanScorer();
 
     LUCENE_CLASS(BooleanScorer);
-    
 
 protected:
     SubScorerPtr scorers;
@@ -45,43 +44,24 @@ protected:
     int32_t nextMask;
     int32_t minNrShouldMatch;
     int32_t end;
-    BucketPtr current;
-    Bucket* __current = nullptr;
+    int32_t current; // bucket of the current doc
     int32_t doc;
 
 protected:
     // firstDocID is ignored since nextDoc() initializes 'current'
     virtual bool score(const CollectorPtr& collector, int32_t max, int32_t firstDocID);
 
+    /// Score the next window of docs into the bucket table, returning true if any sub-scorer has docs beyond it.
+    bool nextWindow();
+
 public:
     virtual int32_t advance(int32_t target);
     virtual int32_t docID();
     virtual int32_t nextDoc();
     virtual double score();
+    virtual int32_t scoreBatch(Collection<int32_t> docs, Collection<double> scores, int32_t max);
     virtual void score(const CollectorPtr& collector);
     virtual String toString();
-
-};
-
-class BooleanScorerCollector : public Collector {
-public:
-    BooleanScorerCollector(int32_t mask, const BucketTablePtr& bucketTable);
-    virtual ~BooleanScorerCollector();
-
-    LUCENE_CLASS(BooleanScorerCollector);
-
-protected:
-    BucketTableWeakPtr _bucketTable;
-    BucketTable* __bucketTable = nullptr;
-    int32_t mask;
-    ScorerWeakPtr _scorer;
-    Scorer* __scorer = nullptr;
-
-public:
-    virtual void collect(int32_t doc);
-    virtual void setNextReader(const IndexReaderPtr& reader, int32_t docBase);
-    virtual void setScorer(const ScorerPtr& scorer);
-    virtual bool acceptsDocsOutOfOrder();
 };
 
 // An internal class which is used in score(Collector, int32_t) for setting the current score. This is required
@@ -92,42 +72,24 @@ public:
     BucketScorer();
     virtual ~BucketScorer();
 
-    
-    int32_t freq;
     LUCENE_CLASS(BucketScorer);
-    float termFreq(){
-        return freq;
-    }
-
 
 public:
     double _score;
     int32_t doc;
+    int32_t freq;
 
 public:
     virtual int32_t advance(int32_t target);
     virtual int32_t docID();
     virtual int32_t nextDoc();
     virtual double score();
+    virtual float termFreq();
 };
 
-class Bucket : public LuceneObject {
-public:
-    Bucket();
-    virtual ~Bucket();
-
-    LUCENE_CLASS(Bucket);
-
-public:
-    int32_t doc; // tells if bucket is valid
-    double score; // incremental score
-    int32_t bits; // used for bool constraints
-    int32_t coord; // count of terms in score
-    BucketWeakPtr _next; // next valid bucket
-    Bucket* __next = nullptr; // next valid bucket
-};
-
-/// A simple hash table of document scores within a range.
+/// A simple hash table of document scores within a range.  The buckets are held as parallel arrays, indexed by
+/// doc modulo SIZE, and the buckets filled in the current window are listed in valid.  A bucket is only valid
+/// if its doc is one of the current window, so the table never needs clearing.
 class BucketTable : public LuceneObject {
 public:
     BucketTable();
@@ -139,18 +101,37 @@ public:
     static const int32_t SIZE;
     static const int32_t MASK;
 
-    Collection<BucketPtr> buckets;
-    BucketPtr first; // head of valid list
-    Bucket* __first = nullptr; // head of valid list
+    /// Number of postings read from a sub-scorer before adding them to the buckets.
+    static const int32_t BATCH_SIZE;
+
+    Collection<int32_t> docs; // tells if bucket is valid
+    Collection<double> scores; // incremental score
+    Collection<int32_t> bits; // used for bool constraints
+    Collection<int32_t> coords; // count of terms in score
+
+    Collection<int32_t> valid; // buckets filled in the current window, in the order they were filled
+    int32_t numValid;
+    int32_t pos; // next entry of valid to visit
+
+protected:
+    Collection<int32_t> docBuffer;
+    Collection<double> scoreBuffer;
 
 public:
-    CollectorPtr newCollector(int32_t mask);
+    /// Forget the buckets of the previous window.
+    void clear();
+
+    /// Add the docs of scorer before end to the buckets, flagged with mask.  Postings are scored a batch at a
+    /// time by {@link Scorer#scoreBatch} and then added in one tight loop over the arrays.  Returns the scorer's
+    /// next doc.
+    int32_t collect(const ScorerPtr& scorer, int32_t mask, int32_t end);
+
     int32_t size();
 };
 
 class SubScorer : public LuceneObject {
 public:
-    SubScorer(const ScorerPtr& scorer, bool required, bool prohibited, const CollectorPtr& collector, const SubScorerPtr& next);
+    SubScorer(const ScorerPtr& scorer, bool required, bool prohibited, int32_t mask, const SubScorerPtr& next);
     virtual ~SubScorer();
 
     LUCENE_CLASS(SubScorer);
@@ -159,7 +140,7 @@ public:
     ScorerPtr scorer;
     bool required;
     bool prohibited;
-    CollectorPtr collector;
+    int32_t mask;
     SubScorerPtr next;
 };
 
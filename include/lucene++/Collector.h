@@ -115,6 +115,15 @@ public:
     /// every hit.  Doing so can slow searches by an order of magnitude or more.
     virtual void collect(int32_t doc) = 0;
 
+    /// Called with a batch of matching documents and their scores, as filled by {@link Scorer#scoreBatch}, in
+    /// place of {@link #setScorer} and {@link #collect(int32_t)}.  Collectors that only need the scores can
+    /// take the whole batch in one loop.  The default implementation sets a scorer returning the batch's
+    /// scores, replacing any scorer set before, and then collects each document.
+    /// @param docs The unbased document numbers.
+    /// @param scores The score of each document.
+    /// @param count The number of documents in the batch, from the start of docs and scores.
+    virtual void collectBatch(Collection<int32_t> docs, Collection<double> scores, int32_t count);
+
     /// Called before collecting from each IndexReader. All doc ids in {@link #collect(int32_t)} will
     /// correspond to reader.  Add docBase to the current IndexReaders internal document id to re-base ids
     /// in {@link #collect(int32_t)}.
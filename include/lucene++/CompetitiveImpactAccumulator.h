@@ -0,0 +1,54 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef COMPETITIVEIMPACTACCUMULATOR_H
+#define COMPETITIVEIMPACTACCUMULATOR_H
+
+#include "LuceneObject.h"
+
+namespace Lucene {
+
+/// Collects the (term freq, byte-encoded norm) pairs of a range of postings and keeps the competitive ones: a
+/// pair is competitive unless another pair has both a freq and a norm at least as large, since such a doc
+/// scores at least as high.  The competitive pairs bound the scores of every doc of the range and are stored
+/// in the skip data, see {@link TermInfosWriter#FORMAT_SKIP_IMPACTS}.
+class LPPAPI CompetitiveImpactAccumulator : public LuceneObject {
+public:
+    CompetitiveImpactAccumulator();
+    virtual ~CompetitiveImpactAccumulator();
+
+    LUCENE_CLASS(CompetitiveImpactAccumulator);
+
+protected:
+    IntArray maxFreqs; // largest freq added with each norm, 0 if none
+    int32_t minNorm; // range of the norms added, empty if minNorm > maxNorm
+    int32_t maxNorm;
+
+public:
+    /// Add the freq and norm of a doc.
+    void add(int32_t freq, uint8_t norm);
+
+    /// Add all pairs collected by another accumulator.
+    void addAll(const CompetitiveImpactAccumulatorPtr& other);
+
+    /// Forget all pairs.
+    void clear();
+
+    /// Sets impacts to the competitive pairs as freq0, norm0, freq1, norm1, ... ordered by descending norm and
+    /// ascending freq, so the last pair holds the largest freq.
+    void getCompetitiveImpacts(Collection<int32_t> impacts);
+
+    /// Write the competitive pairs: their count as a VInt, then for each pair in the order of {@link
+    /// #getCompetitiveImpacts} the freq increase from the previous pair as a VInt and the norm as a byte.
+    void write(const IndexOutputPtr& output);
+
+    /// Read pairs written by {@link #write} into impacts, as returned by {@link #getCompetitiveImpacts}.
+    static void read(const IndexInputPtr& input, Collection<int32_t> impacts);
+};
+
+}
+
+#endif
@@ -40,6 +40,14 @@ public:
     /// Decompress the byte array previously returned by compressString back into a String
     static String decompressString(ByteArray value);
 
+    /// Compresses the specified byte range with a fast LZ4 style codec, which trades compression ratio for
+    /// speed: it only replaces repeated sequences of at least 4 bytes by back references.
+    static ByteArray compressFast(const uint8_t* value, int32_t offset, int32_t length);
+
+    /// Decompress the compressedLength bytes previously returned by compressFast into the length bytes at result.
+    /// Throws CompressionException if the bytes are corrupt or don't decompress to exactly length bytes.
+    static void decompressFast(const uint8_t* value, int32_t compressedLength, uint8_t* result, int32_t length);
+
 protected:
     static const int32_t COMPRESS_BUFFER;
 };
@@ -23,6 +23,12 @@ public:
 
     LUCENE_CLASS(ConcurrentMergeScheduler);
 
+public:
+    /// Bounds of the per merge write rate when it is tuned automatically, see {@link #setAutoIOThrottle}.
+    static const double MIN_MERGE_MB_PER_SEC;
+    static const double START_MERGE_MB_PER_SEC;
+    static const double MAX_MERGE_MB_PER_SEC;
+
 protected:
     int32_t mergeThreadPriority;
 
@@ -41,6 +47,20 @@ protected:
     bool suppressExceptions;
     static bool anyExceptions;
 
+    /// Optional thread pool that merges are run on instead of dedicated threads
+    ThreadPoolPtr threadPool;
+
+    /// Write rate of each merge in MB per second, 0 for no limit
+    double mergeMBPerSec;
+    bool autoIOThrottle;
+
+    /// Parent of the rate limiter of every merge, limits the combined write rate of all merges
+    RateLimiterPtr totalRateLimiter;
+
+    /// Throttling statistics of the merges that have finished
+    int64_t finishedBytesThrottled;
+    int64_t finishedPausedMillis;
+
 public:
     virtual void initialize();
 
@@ -59,6 +79,44 @@ public:
     /// Set the priority that merge threads run at.
     virtual void setMergeThreadPriority(int32_t pri);
 
+    /// Run merges as tasks on the given thread pool rather than on a dedicated thread per merge.  Merges
+    /// still stall incoming threads once {@link #getMaxThreadCount} merges are running.  Note merge thread
+    /// priority is not applied to pooled threads.  Pass null to revert to dedicated merge threads.
+    virtual void setThreadPool(const ThreadPoolPtr& threadPool);
+
+    /// Return the thread pool merges are run on, or null if each merge runs on its own thread.
+    virtual ThreadPoolPtr getThreadPool();
+
+    /// Limits how fast each merge may write its files, in MB per second, so that merges don't starve
+    /// searches and indexing of disk bandwidth.  0, the default, means no limit.  Applies to running
+    /// merges too if they were started with a limit.
+    virtual void setMergeMBPerSec(double mbPerSec);
+
+    /// Return the write rate of each merge, in MB per second. @see #setMergeMBPerSec.
+    virtual double getMergeMBPerSec();
+
+    /// Limits the combined write rate of all running merges, in MB per second.  0, the default, means
+    /// no limit.
+    virtual void setTotalMergeMBPerSec(double mbPerSec);
+
+    /// Return the combined write rate of all merges, in MB per second. @see #setTotalMergeMBPerSec.
+    virtual double getTotalMergeMBPerSec();
+
+    /// When enabled the write rate of each merge is tuned automatically, starting at {@link
+    /// #START_MERGE_MB_PER_SEC}: it is raised while merges are backing up, that is when incoming threads
+    /// stall for a merge thread or several merges are pending at once, and lowered otherwise, between
+    /// {@link #MIN_MERGE_MB_PER_SEC} and {@link #MAX_MERGE_MB_PER_SEC}.  Disabling it removes the limit.
+    virtual void setAutoIOThrottle(bool autoIOThrottle);
+
+    /// Return whether the write rate of merges is tuned automatically. @see #setAutoIOThrottle.
+    virtual bool getAutoIOThrottle();
+
+    /// Return the number of bytes merges have written only after pausing for the rate limit.
+    virtual int64_t getMergeBytesThrottled();
+
+    /// Return the total time, in milliseconds, merges have paused for the rate limit.
+    virtual int64_t getMergePausedMillis();
+
     virtual void close();
 
     virtual void sync();
@@ -87,6 +145,18 @@ protected:
 
     virtual MergeThreadPtr getMergeThread(const IndexWriterPtr& writer, const OneMergePtr& merge);
 
+    /// Gives the merge a rate limiter, if merges are rate limited, before it starts.
+    virtual void initMergeRateLimiter(const OneMergePtr& merge);
+
+    /// Adjusts the write rate of merges for the merge backlog when {@link #setAutoIOThrottle} is enabled.
+    virtual void updateAutoIOThrottle(bool backlog);
+
+    /// Applies the current write rate to the running merges.
+    virtual void updateMergeRates();
+
+    /// Adds the throttling statistics of a finished merge to the totals.
+    virtual void mergeFinished(const OneMergePtr& merge);
+
     /// Called when an exception is hit in a background merge thread
     virtual void handleMergeException(const LuceneException& exc);
 
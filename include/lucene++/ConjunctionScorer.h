@@ -12,7 +12,7 @@
 namespace Lucene {
 
 /// Scorer for conjunctions, sets of queries, all of which are required.
-class ConjunctionScorer : public Scorer {
+class LPPAPI ConjunctionScorer : public Scorer {
 public:
     ConjunctionScorer(const SimilarityPtr& similarity, Collection<ScorerPtr> scorers);
     virtual ~ConjunctionScorer();
@@ -29,6 +29,7 @@ public:
     virtual int32_t docID();
     virtual int32_t nextDoc();
     virtual double score();
+    virtual int32_t scoreBatch(Collection<int32_t> docs, Collection<double> scores, int32_t max);
 
 protected:
     int32_t doNext();
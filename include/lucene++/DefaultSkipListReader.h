@@ -14,7 +14,7 @@ namespace Lucene {
 /// Implements the skip list reader for the default posting list format that stores positions and payloads.
 class DefaultSkipListReader : public MultiLevelSkipListReader {
 public:
-    DefaultSkipListReader(const IndexInputPtr& skipStream, int32_t maxSkipLevels, int32_t skipInterval);
+    DefaultSkipListReader(const IndexInputPtr& skipStream, int32_t maxSkipLevels, int32_t skipInterval, bool hasImpacts = false);
     virtual ~DefaultSkipListReader();
 
     LUCENE_CLASS(DefaultSkipListReader);
@@ -25,6 +25,11 @@ protected:
     Collection<int64_t> proxPointer;
     Collection<int32_t> payloadLength;
 
+    /// Competitive (freq, norm) pairs, only stored by segments written with {@link TermInfosWriter#FORMAT_SKIP_IMPACTS}
+    bool hasImpacts;
+    Collection< Collection<int32_t> > impacts;
+    Collection<int32_t> termImpacts;
+
     int64_t lastFreqPointer;
     int64_t lastProxPointer;
     int32_t lastPayloadLength;
@@ -44,6 +49,19 @@ public:
     /// MultiLevelSkipListReader#skipTo(int)} has skipped.
     int32_t getPayloadLength();
 
+    /// Returns the competitive (freq, norm) pairs of all docs of the term as freq0, norm0, freq1, norm1, ... with
+    /// the largest freq last, see {@link CompetitiveImpactAccumulator}.  Empty if the skip data doesn't hold them.
+    Collection<int32_t> getTermImpacts();
+
+    /// Returns the doc of the skip entry following the last call of {@link MultiLevelSkipListReader#skipTo(int)},
+    /// the last doc of the interval holding the target, or INT_MAX if there is no such entry.
+    int32_t getNextSkipDoc();
+
+    /// Returns the competitive (freq, norm) pairs of the docs up to and including {@link #getNextSkipDoc()} that
+    /// follow the doc skipped to, ordered as by {@link #getTermImpacts()}.  Empty if the skip data doesn't hold
+    /// them.  Only valid if getNextSkipDoc() isn't INT_MAX.
+    Collection<int32_t> getNextSkipImpacts();
+
 protected:
     /// Seeks the skip entry on the given level
     virtual void seekChild(int32_t level);
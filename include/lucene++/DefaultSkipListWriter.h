@@ -14,7 +14,7 @@ namespace Lucene {
 /// Implements the skip list writer for the default posting list format that stores positions and payloads.
 class DefaultSkipListWriter : public MultiLevelSkipListWriter {
 public:
-    DefaultSkipListWriter(int32_t skipInterval, int32_t numberOfSkipLevels, int32_t docCount, const IndexOutputPtr& freqOutput, const IndexOutputPtr& proxOutput);
+    DefaultSkipListWriter(int32_t skipInterval, int32_t numberOfSkipLevels, int32_t docCount, const IndexOutputPtr& freqOutput, const IndexOutputPtr& proxOutput, bool hasImpacts = false);
     virtual ~DefaultSkipListWriter();
 
     LUCENE_CLASS(DefaultSkipListWriter);
@@ -24,6 +24,8 @@ protected:
     Collection<int32_t> lastSkipPayloadLength;
     Collection<int64_t> lastSkipFreqPointer;
     Collection<int64_t> lastSkipProxPointer;
+    bool hasImpacts;
+    Collection<CompetitiveImpactAccumulatorPtr> skipImpacts; // impacts since the last skip entry of each level
 
     IndexOutputPtr freqOutput;
     IndexOutputPtr proxOutput;
@@ -33,17 +35,24 @@ protected:
     int32_t curPayloadLength;
     int64_t curFreqPointer;
     int64_t curProxPointer;
+    CompetitiveImpactAccumulatorPtr termImpacts;
 
 public:
     void setFreqOutput(const IndexOutputPtr& freqOutput);
     void setProxOutput(const IndexOutputPtr& proxOutput);
 
     /// Sets the values for the current skip data.
-    void setSkipData(int32_t doc, bool storePayloads, int32_t payloadLength);
+    /// @param impacts the freqs and norms of the docs added since the previous skip data, ignored unless
+    /// the skip data has impacts
+    void setSkipData(int32_t doc, bool storePayloads, int32_t payloadLength, const CompetitiveImpactAccumulatorPtr& impacts);
+
+    /// Sets the freqs and norms of all docs of the current term, written ahead of its skip levels.
+    void setTermImpacts(const CompetitiveImpactAccumulatorPtr& impacts);
 
 protected:
     virtual void resetSkip();
     virtual void writeSkipData(int32_t level, const IndexOutputPtr& skipBuffer);
+    virtual void writeSkipHeader(const IndexOutputPtr& output);
 
     friend class FormatPostingsTermsWriter;
 };
@@ -58,6 +58,11 @@ protected:
     // in case we were opened on a past IndexCommit
     int64_t maxIndexVersion;
 
+    IndexReaderWarmerPtr reopenWarmer;
+
+    // Change count of the writer when a near real-time reader was opened
+    int64_t writerChangeCount;
+
 public:
     void _initialize(Collection<SegmentReaderPtr> subReaders);
 
@@ -70,6 +75,14 @@ public:
     virtual IndexReaderPtr reopen(bool openReadOnly);
     virtual IndexReaderPtr reopen(const IndexCommitPtr& commit);
 
+    /// Set a warmer that each reader returned by {@link #reopen} is passed to before it is returned, so that
+    /// searches on it don't pay for loading its new segments, for example a {@link FieldCacheWarmer}.  The
+    /// warmer carries over to reopened and cloned readers.
+    virtual void setReopenWarmer(const IndexReaderWarmerPtr& warmer);
+
+    /// Returns the current reopen warmer.  See {@link #setReopenWarmer}.
+    virtual IndexReaderWarmerPtr getReopenWarmer();
+
     /// Version number when this IndexReader was opened.
     virtual int64_t getVersion();
 
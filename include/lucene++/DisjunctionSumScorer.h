@@ -13,7 +13,7 @@ namespace Lucene {
 
 /// A Scorer for OR like queries, counterpart of ConjunctionScorer.  This Scorer implements {@link
 /// Scorer#skipTo(int32_t)} and uses skipTo() on the given Scorers.
-class DisjunctionSumScorer : public Scorer {
+class LPPAPI DisjunctionSumScorer : public Scorer {
 public:
     DisjunctionSumScorer(Collection<ScorerPtr> subScorers, int32_t minimumNrMatchers = 1);
     virtual ~DisjunctionSumScorer();
@@ -56,6 +56,7 @@ public:
     /// Returns the score of the current document matching the query. Initially invalid, until {@link #next()}
     /// is called the first time.
     virtual double score();
+    virtual int32_t scoreBatch(Collection<int32_t> docs, Collection<double> scores, int32_t max);
 
     virtual int32_t docID();
 
@@ -26,6 +26,7 @@ public:
     FieldInfosPtr fieldInfos;
     DocFieldConsumerPtr consumer;
     StoredFieldsWriterPtr fieldsWriter;
+    DocValuesWriterPtr docValuesWriter;
 
 public:
     virtual void closeDocStore(const SegmentWriteStatePtr& state);
@@ -37,6 +37,7 @@ public:
     int32_t totalFieldCount;
 
     StoredFieldsWriterPerThreadPtr fieldsWriter;
+    DocValuesWriterPerThreadPtr docValuesWriter;
     DocStatePtr docState;
 
     Collection<DocFieldProcessorPerThreadPerDocPtr> docFreeList;
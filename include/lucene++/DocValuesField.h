@@ -0,0 +1,71 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef DOCVALUESFIELD_H
+#define DOCVALUESFIELD_H
+
+#include "Field.h"
+#include "NumericDocValues.h"
+
+namespace Lucene {
+
+/// A field holding one numeric value per document that is neither indexed nor stored, but written column-stride
+/// to a per-segment file at index time.  The values of a segment are read back as a {@link NumericDocValues} with
+/// {@link IndexReader#getNumericDocValues}, and {@link FieldCache} loads int, long and double arrays from them instead of
+/// un-inverting the terms of the field, so sorting and function queries on the field don't have to walk the
+/// terms dictionary when a reader is opened.
+///
+/// A document may have a {@link NumericField} with the same name, to also support range queries on the values.
+/// Documents without a value read as 0; if a document has several values for the field, the last one wins.  A
+/// field that is given both int/long and double values is stored as double.
+///
+/// <pre>
+/// DocValuesFieldPtr price(newLucene<DocValuesField>(L"price"));
+/// doc->add(price);
+/// price->setDoubleValue(9.99);
+/// </pre>
+class LPPAPI DocValuesField : public AbstractField {
+public:
+    DocValuesField(const String& name);
+    virtual ~DocValuesField();
+
+    LUCENE_CLASS(DocValuesField);
+
+public:
+    /// Returns always null for doc values fields
+    virtual TokenStreamPtr tokenStreamValue();
+
+    /// Returns always null for doc values fields
+    virtual ByteArray getBinaryValue(ByteArray result);
+
+    /// Returns always null for doc values fields
+    virtual ReaderPtr readerValue();
+
+    /// Returns the value as a string.
+    virtual String stringValue();
+
+    /// Returns {@link NumericDocValues#TYPE_DOUBLE} if the value was set with {@link #setDoubleValue}.
+    NumericDocValues::Type getType();
+
+    /// Returns the current value, truncated if it is a double.
+    int64_t getLongValue();
+
+    /// Returns the current value as a double.
+    double getDoubleValue();
+
+    /// Initializes the field with the supplied long value.
+    DocValuesFieldPtr setLongValue(int64_t value);
+
+    /// Initializes the field with the supplied int value.
+    DocValuesFieldPtr setIntValue(int32_t value);
+
+    /// Initializes the field with the supplied double value.
+    DocValuesFieldPtr setDoubleValue(double value);
+};
+
+}
+
+#endif
@@ -0,0 +1,44 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef DOCVALUESREADER_H
+#define DOCVALUESREADER_H
+
+#include "LuceneObject.h"
+
+namespace Lucene {
+
+/// Reads the .dv file of a segment.  Only the field headers are read when the reader is opened; the values of
+/// a field are loaded the first time they are asked for and then shared by every caller.
+class DocValuesReader : public LuceneObject {
+public:
+    DocValuesReader(const DirectoryPtr& dir, const String& segment, const FieldInfosPtr& fieldInfos, int32_t maxDoc, int32_t readBufferSize);
+    virtual ~DocValuesReader();
+
+    LUCENE_CLASS(DocValuesReader);
+
+protected:
+    IndexInputPtr input;
+    int32_t maxDoc;
+
+    /// File pointers of the fields
+    HashMap<String, int64_t> pointers;
+
+    HashMap<String, NumericDocValuesPtr> loaded;
+
+public:
+    /// Returns the values of field, or null if no document of the segment has a value for it.
+    NumericDocValuesPtr getDocValues(const String& field);
+
+    /// Returns true if the segment has values for field.
+    bool hasField(const String& field);
+
+    void close();
+};
+
+}
+
+#endif
@@ -0,0 +1,44 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef DOCVALUESWRITER_H
+#define DOCVALUESWRITER_H
+
+#include "NumericDocValues.h"
+
+namespace Lucene {
+
+/// Writes the values of {@link DocValuesField}s to the segment's .dv file.  Per-thread writers buffer the
+/// values of the documents they process and are gathered when the segment is flushed.
+///
+/// The file holds a format number and the number of fields, then for each field its number, {@link
+/// DocValues#Type}, smallest value and the packed offsets of every document's value from the smallest one.
+class DocValuesWriter : public LuceneObject {
+public:
+    DocValuesWriter(const FieldInfosPtr& fieldInfos);
+    virtual ~DocValuesWriter();
+
+    LUCENE_CLASS(DocValuesWriter);
+
+public:
+    static const int32_t FORMAT;
+
+    FieldInfosPtr fieldInfos;
+
+public:
+    DocValuesWriterPerThreadPtr addThread(const DocStatePtr& docState);
+    void flush(Collection<DocValuesWriterPerThreadPtr> threads, const SegmentWriteStatePtr& state);
+
+    /// Write the header of a file holding numFields fields.
+    static void writeHeader(const IndexOutputPtr& out, int32_t numFields);
+
+    /// Write the values of one field, numDocs values in their stored form (sortable longs for doubles).
+    static void writeField(const IndexOutputPtr& out, int32_t fieldNumber, NumericDocValues::Type type, LongArray values, int32_t numDocs);
+};
+
+}
+
+#endif
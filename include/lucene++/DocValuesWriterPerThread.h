@@ -0,0 +1,41 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef DOCVALUESWRITERPERTHREAD_H
+#define DOCVALUESWRITERPERTHREAD_H
+
+#include "LuceneObject.h"
+
+namespace Lucene {
+
+/// Buffers the doc values of the documents processed by one thread, as (field, doc, value) entries.
+class DocValuesWriterPerThread : public LuceneObject {
+public:
+    DocValuesWriterPerThread(const DocStatePtr& docState);
+    virtual ~DocValuesWriterPerThread();
+
+    LUCENE_CLASS(DocValuesWriterPerThread);
+
+public:
+    DocStatePtr docState;
+
+    IntArray fieldNumbers;
+    IntArray docIDs;
+    LongArray values; // longs, or the sortable long form of doubles
+    ByteArray doubles; // whether each value is a double
+    int32_t numValues;
+
+public:
+    void addField(const DocValuesFieldPtr& field, const FieldInfoPtr& fieldInfo);
+
+    /// Discard the buffered values.
+    void reset();
+    void abort();
+};
+
+}
+
+#endif
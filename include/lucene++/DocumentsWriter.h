@@ -37,7 +37,7 @@ namespace Lucene {
 ///
 /// When flush is called by IndexWriter we forcefully idle all threads and flush only once they are all idle.
 /// This means you can call flush with a given thread even while other threads are actively adding/deleting
-/// documents.
+/// documents.  The ThreadStates share one segment, so all threads wait for the whole flush.
 ///
 /// Exceptions:
 /// Because this class directly updates in-memory posting lists, and flushes stored fields and term vectors
@@ -165,6 +165,7 @@ INTERNAL:
     InfoStreamPtr infoStream;
     int32_t maxFieldLength;
     SimilarityPtr similarity;
+    int32_t storedFieldsCompression;
 
     DocConsumerPtr consumer;
 
@@ -203,6 +204,7 @@ public:
 
     void setMaxFieldLength(int32_t maxFieldLength);
     void setSimilarity(const SimilarityPtr& similarity);
+    void setStoredFieldsCompression(int32_t compression);
 
     /// Set how much RAM we can use before flushing.
     void setRAMBufferSizeMB(double mb);
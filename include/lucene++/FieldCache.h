@@ -27,7 +27,11 @@ public:
         CACHE_LONG,
         CACHE_DOUBLE,
         CACHE_STRING,
-        CACHE_STRING_INDEX
+        CACHE_STRING_INDEX,
+        CACHE_PACKED_INT,
+        CACHE_PACKED_LONG,
+        CACHE_PACKED_DOUBLE,
+        CACHE_PACKED_STRING_INDEX
     };
 
     /// Indicator for StringIndex values in the cache.
@@ -146,6 +150,67 @@ public:
     /// @return Array of terms and index into the array for each document.
     virtual StringIndexPtr getStringIndex(const IndexReaderPtr& reader, const String& field);
 
+    /// Checks the internal cache for an appropriate entry, and if none are found, reads the terms in field as
+    /// integers and returns the value each document has in the given field, packed with as few bits per
+    /// document as the range of the values allows.  Values written with {@link DocValuesField} are returned
+    /// as they are held by the reader, without reading the terms.
+    /// @param reader Used to get field values.
+    /// @param field Which field contains the integers.
+    /// @return The values in the given field for each document.
+    virtual NumericDocValuesPtr getPackedInts(const IndexReaderPtr& reader, const String& field);
+
+    /// Checks the internal cache for an appropriate entry, and if none are found, reads the terms in field as
+    /// integers and returns the value each document has in the given field, packed with as few bits per
+    /// document as the range of the values allows.
+    /// @param reader Used to get field values.
+    /// @param field Which field contains the integers.
+    /// @param parser Computes integer for string values.
+    /// @return The values in the given field for each document.
+    virtual NumericDocValuesPtr getPackedInts(const IndexReaderPtr& reader, const String& field, const IntParserPtr& parser);
+
+    /// Checks the internal cache for an appropriate entry, and if none are found, reads the terms in field as
+    /// longs and returns the value each document has in the given field, packed with as few bits per document
+    /// as the range of the values allows.  Values written with {@link DocValuesField} are returned as they
+    /// are held by the reader, without reading the terms.
+    /// @param reader Used to get field values.
+    /// @param field Which field contains the longs.
+    /// @return The values in the given field for each document.
+    virtual NumericDocValuesPtr getPackedLongs(const IndexReaderPtr& reader, const String& field);
+
+    /// Checks the internal cache for an appropriate entry, and if none are found, reads the terms in field as
+    /// longs and returns the value each document has in the given field, packed with as few bits per document
+    /// as the range of the values allows.
+    /// @param reader Used to get field values.
+    /// @param field Which field contains the longs.
+    /// @param parser Computes long for string values.
+    /// @return The values in the given field for each document.
+    virtual NumericDocValuesPtr getPackedLongs(const IndexReaderPtr& reader, const String& field, const LongParserPtr& parser);
+
+    /// Checks the internal cache for an appropriate entry, and if none are found, reads the terms in field as
+    /// doubles and returns the value each document has in the given field, packed in their sortable long form
+    /// with as few bits per document as the range of the values allows.  Values written with {@link
+    /// DocValuesField} are returned as they are held by the reader, without reading the terms.
+    /// @param reader Used to get field values.
+    /// @param field Which field contains the doubles.
+    /// @return The values in the given field for each document.
+    virtual NumericDocValuesPtr getPackedDoubles(const IndexReaderPtr& reader, const String& field);
+
+    /// Checks the internal cache for an appropriate entry, and if none are found, reads the terms in field as
+    /// doubles and returns the value each document has in the given field, packed in their sortable long form
+    /// with as few bits per document as the range of the values allows.
+    /// @param reader Used to get field values.
+    /// @param field Which field contains the doubles.
+    /// @param parser Computes double for string values.
+    /// @return The values in the given field for each document.
+    virtual NumericDocValuesPtr getPackedDoubles(const IndexReaderPtr& reader, const String& field, const DoubleParserPtr& parser);
+
+    /// Same as {@link #getStringIndex}, except that the index into the lookup array of each document is
+    /// held in {@link StringIndex#packedOrder}, using only as many bits as the number of terms needs.
+    /// @param reader Used to get field values.
+    /// @param field Which field contains the strings.
+    /// @return Array of terms and packed index into the array for each document.
+    virtual StringIndexPtr getPackedStringIndex(const IndexReaderPtr& reader, const String& field);
+
     /// Generates an array of CacheEntry objects representing all items currently in the FieldCache.
     virtual Collection<FieldCacheEntryPtr> getCacheEntries() = 0;
 
@@ -180,6 +245,7 @@ public:
 class LPPAPI StringIndex : public LuceneObject {
 public:
     StringIndex(Collection<int32_t> values, Collection<String> lookup);
+    StringIndex(const PackedIntsPtr& values, Collection<String> lookup);
     virtual ~StringIndex();
 
     LUCENE_CLASS(StringIndex);
@@ -188,11 +254,18 @@ public:
     /// All the term values, in natural order.
     Collection<String> lookup;
 
-    /// For each document, an index into the lookup array.
+    /// For each document, an index into the lookup array.  Null for a packed index.
     Collection<int32_t> order;
 
+    /// For each document, an index into the lookup array, packed.  Only set by {@link
+    /// FieldCache#getPackedStringIndex}.
+    PackedIntsPtr packedOrder;
+
 public:
     int32_t binarySearchLookup(const String& key);
+
+    /// Returns the index into the lookup array of doc, from whichever of order and packedOrder is set.
+    int32_t getOrd(int32_t doc);
 };
 
 /// Marker interface as super-interface to all parsers.  It is used to specify a custom parser to {@link
@@ -8,6 +8,7 @@
 #define FIELDCACHEIMPL_H
 
 #include "FieldCache.h"
+#include "NumericDocValues.h"
 
 namespace Lucene {
 
@@ -44,6 +45,17 @@ public:
     virtual Collection<String> getStrings(const IndexReaderPtr& reader, const String& field);
     virtual StringIndexPtr getStringIndex(const IndexReaderPtr& reader, const String& field);
 
+    virtual NumericDocValuesPtr getPackedInts(const IndexReaderPtr& reader, const String& field);
+    virtual NumericDocValuesPtr getPackedInts(const IndexReaderPtr& reader, const String& field, const IntParserPtr& parser);
+
+    virtual NumericDocValuesPtr getPackedLongs(const IndexReaderPtr& reader, const String& field);
+    virtual NumericDocValuesPtr getPackedLongs(const IndexReaderPtr& reader, const String& field, const LongParserPtr& parser);
+
+    virtual NumericDocValuesPtr getPackedDoubles(const IndexReaderPtr& reader, const String& field);
+    virtual NumericDocValuesPtr getPackedDoubles(const IndexReaderPtr& reader, const String& field, const DoubleParserPtr& parser);
+
+    virtual StringIndexPtr getPackedStringIndex(const IndexReaderPtr& reader, const String& field);
+
     virtual void setInfoStream(const InfoStreamPtr& stream);
     virtual InfoStreamPtr getInfoStream();
 };
@@ -102,61 +114,99 @@ protected:
     virtual boost::any createValue(const IndexReaderPtr& reader, const EntryPtr& key);
 };
 
-class IntCache : public Cache {
+class StringCache : public Cache {
 public:
-    IntCache(const FieldCachePtr& wrapper = FieldCachePtr());
-    virtual ~IntCache();
+    StringCache(const FieldCachePtr& wrapper = FieldCachePtr());
+    virtual ~StringCache();
 
-    LUCENE_CLASS(IntCache);
+    LUCENE_CLASS(StringCache);
 
 protected:
     virtual boost::any createValue(const IndexReaderPtr& reader, const EntryPtr& key);
 };
 
-class LongCache : public Cache {
+class PackedIntCache : public Cache {
 public:
-    LongCache(const FieldCachePtr& wrapper = FieldCachePtr());
-    virtual ~LongCache();
+    PackedIntCache(const FieldCachePtr& wrapper = FieldCachePtr());
+    virtual ~PackedIntCache();
 
-    LUCENE_CLASS(LongCache);
+    LUCENE_CLASS(PackedIntCache);
 
 protected:
     virtual boost::any createValue(const IndexReaderPtr& reader, const EntryPtr& key);
 };
 
-class DoubleCache : public Cache {
+class PackedLongCache : public Cache {
 public:
-    DoubleCache(const FieldCachePtr& wrapper = FieldCachePtr());
-    virtual ~DoubleCache();
+    PackedLongCache(const FieldCachePtr& wrapper = FieldCachePtr());
+    virtual ~PackedLongCache();
 
-    LUCENE_CLASS(DoubleCache);
+    LUCENE_CLASS(PackedLongCache);
 
 protected:
     virtual boost::any createValue(const IndexReaderPtr& reader, const EntryPtr& key);
 };
 
-class StringCache : public Cache {
+class PackedDoubleCache : public Cache {
 public:
-    StringCache(const FieldCachePtr& wrapper = FieldCachePtr());
-    virtual ~StringCache();
+    PackedDoubleCache(const FieldCachePtr& wrapper = FieldCachePtr());
+    virtual ~PackedDoubleCache();
 
-    LUCENE_CLASS(StringCache);
+    LUCENE_CLASS(PackedDoubleCache);
 
 protected:
     virtual boost::any createValue(const IndexReaderPtr& reader, const EntryPtr& key);
 };
 
-class StringIndexCache : public Cache {
+class PackedStringIndexCache : public Cache {
 public:
-    StringIndexCache(const FieldCachePtr& wrapper = FieldCachePtr());
-    virtual ~StringIndexCache();
+    PackedStringIndexCache(const FieldCachePtr& wrapper = FieldCachePtr());
+    virtual ~PackedStringIndexCache();
 
-    LUCENE_CLASS(StringIndexCache);
+    LUCENE_CLASS(PackedStringIndexCache);
 
 protected:
     virtual boost::any createValue(const IndexReaderPtr& reader, const EntryPtr& key);
 };
 
+/// The values of a packed numeric cache entry.  The unpacked arrays asked for with {@link FieldCache#getInts},
+/// {@link FieldCache#getLongs} and {@link FieldCache#getDoubles} are expanded from them once and held here,
+/// so that both views of a field share a single cache entry.
+class FieldCacheNumericValues : public NumericDocValues {
+public:
+    FieldCacheNumericValues(Type type, int64_t minValue, const PackedIntsPtr& values);
+    FieldCacheNumericValues(const NumericDocValuesPtr& values);
+    virtual ~FieldCacheNumericValues();
+
+    LUCENE_CLASS(FieldCacheNumericValues);
+
+protected:
+    Collection<int32_t> ints;
+    Collection<int64_t> longs;
+    Collection<double> doubles;
+
+public:
+    Collection<int32_t> getInts();
+    Collection<int64_t> getLongs();
+    Collection<double> getDoubles();
+};
+
+/// The value of a packed string index cache entry, which holds the unpacked index asked for with {@link
+/// FieldCache#getStringIndex}, sharing its lookup array.
+class FieldCacheStringIndex : public StringIndex {
+public:
+    FieldCacheStringIndex(const PackedIntsPtr& values, Collection<String> lookup);
+    virtual ~FieldCacheStringIndex();
+
+    LUCENE_CLASS(FieldCacheStringIndex);
+
+protected:
+    StringIndexPtr unpacked;
+
+public:
+    StringIndexPtr getUnpacked();
+};
+
 class FieldCacheEntryImpl : public FieldCacheEntry {
 public:
     FieldCacheEntryImpl(const LuceneObjectPtr& readerKey, const String& fieldName, int32_t cacheType, const boost::any& custom, const boost::any& value);
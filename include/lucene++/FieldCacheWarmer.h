@@ -0,0 +1,52 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef FIELDCACHEWARMER_H
+#define FIELDCACHEWARMER_H
+
+#include "IndexWriter.h"
+
+namespace Lucene {
+
+/// Loads the {@link FieldCache} entries that sorting by a set of {@link SortField}s uses, so that the first
+/// search sorting on them doesn't pay for un-inverting the fields.  Each segment of a reader is loaded by its
+/// own task on a {@link ThreadPool}.
+///
+/// Set as the reopen warmer of a {@link DirectoryReader} to have the segments of every reopened reader loaded
+/// before the reader is returned.  Segments shared with the previous reader are already cached and cost nothing.
+class LPPAPI FieldCacheWarmer : public IndexReaderWarmer {
+public:
+    /// @param sortFields the fields to load, with the type and parser they are sorted by.  Sorts by score,
+    /// document or a custom comparator have nothing to load and are ignored.
+    /// @param threadPool the pool to load segments on, {@link ThreadPool#getInstance} if null.
+    FieldCacheWarmer(Collection<SortFieldPtr> sortFields, const ThreadPoolPtr& threadPool = ThreadPoolPtr());
+    virtual ~FieldCacheWarmer();
+
+    LUCENE_CLASS(FieldCacheWarmer);
+
+protected:
+    Collection<SortFieldPtr> sortFields;
+    ThreadPoolPtr threadPool;
+
+public:
+    /// Start loading the fields of every segment of reader and return without waiting.  The value of each
+    /// future is the number of fields loaded for its segment, or -1 if loading them failed.
+    Collection<FuturePtr> warmAsync(const IndexReaderPtr& reader);
+
+    /// Load the fields of every segment of reader and wait for them.  Rethrows the first error hit.
+    virtual void warm(const IndexReaderPtr& reader);
+
+    /// Load the cache entries that sorting reader by sortField uses, on the calling thread.  Returns false if
+    /// the sort doesn't use the field cache.
+    static bool warmField(const IndexReaderPtr& reader, const SortFieldPtr& sortField);
+
+protected:
+    Collection<FieldCacheWarmerTaskPtr> schedule(const IndexReaderPtr& reader, Collection<FuturePtr> futures);
+};
+
+}
+
+#endif
@@ -162,7 +162,7 @@ public:
     virtual void setNextReader(const IndexReaderPtr& reader, int32_t docBase);
 };
 
-/// Parses field's values as double (using {@link FieldCache#getDoubles} and sorts by ascending value
+/// Parses field's values as double (using {@link FieldCache#getPackedDoubles} and sorts by ascending value
 class LPPAPI DoubleComparator : public NumericComparator<double> {
 public:
     DoubleComparator(int32_t numHits, const String& field, const ParserPtr& parser);
@@ -172,14 +172,16 @@ public:
 
 protected:
     DoubleParserPtr parser;
+    NumericDocValuesPtr docValues; // values of the current reader
 
 public:
     virtual int32_t compare(int32_t slot1, int32_t slot2);
     virtual int32_t compareBottom(int32_t doc);
+    virtual void copy(int32_t slot, int32_t doc);
     virtual void setNextReader(const IndexReaderPtr& reader, int32_t docBase);
 };
 
-/// Parses field's values as int (using {@link FieldCache#getInts} and sorts by ascending value
+/// Parses field's values as int (using {@link FieldCache#getPackedInts} and sorts by ascending value
 class LPPAPI IntComparator : public NumericComparator<int32_t> {
 public:
     IntComparator(int32_t numHits, const String& field, const ParserPtr& parser);
@@ -189,14 +191,16 @@ public:
 
 protected:
     IntParserPtr parser;
+    NumericDocValuesPtr docValues; // values of the current reader
 
 public:
     virtual int32_t compare(int32_t slot1, int32_t slot2);
     virtual int32_t compareBottom(int32_t doc);
+    virtual void copy(int32_t slot, int32_t doc);
     virtual void setNextReader(const IndexReaderPtr& reader, int32_t docBase);
 };
 
-/// Parses field's values as long (using {@link FieldCache#getLongs} and sorts by ascending value
+/// Parses field's values as long (using {@link FieldCache#getPackedLongs} and sorts by ascending value
 class LPPAPI LongComparator : public NumericComparator<int64_t> {
 public:
     LongComparator(int32_t numHits, const String& field, const ParserPtr& parser);
@@ -206,10 +210,12 @@ public:
 
 protected:
     LongParserPtr parser;
+    NumericDocValuesPtr docValues; // values of the current reader
 
 public:
     virtual int32_t compare(int32_t slot1, int32_t slot2);
     virtual int32_t compareBottom(int32_t doc);
+    virtual void copy(int32_t slot, int32_t doc);
     virtual void setNextReader(const IndexReaderPtr& reader, int32_t docBase);
 };
 
@@ -260,7 +266,7 @@ public:
 
 /// Sorts by field's natural String sort order, using ordinals.  This is functionally equivalent to {@link
 /// StringValComparator}, but it first resolves the string to their relative ordinal positions (using the
-/// index returned by {@link FieldCache#getStringIndex}), and does most comparisons using the ordinals.
+/// index returned by {@link FieldCache#getPackedStringIndex}), and does most comparisons using the ordinals.
 /// For medium to large results, this comparator will be much faster than {@link StringValComparator}.  For
 /// very small result sets it may be slower.
 class LPPAPI StringOrdValComparator : public FieldComparator {
@@ -277,7 +283,7 @@ protected:
 
     int32_t currentReaderGen;
     Collection<String> lookup;
-    Collection<int32_t> order;
+    PackedIntsPtr order;
     String field;
 
     int32_t bottomSlot;
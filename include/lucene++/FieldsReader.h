@@ -17,7 +17,8 @@ class LPPAPI FieldsReader : public LuceneObject {
 public:
     /// Used only by clone
     FieldsReader(const FieldInfosPtr& fieldInfos, int32_t numTotalDocs, int32_t size, int32_t format, int32_t formatSize,
-                 int32_t docStoreOffset, const IndexInputPtr& cloneableFieldsStream, const IndexInputPtr& cloneableIndexStream);
+                 int32_t docStoreOffset, const IndexInputPtr& cloneableFieldsStream, const IndexInputPtr& cloneableIndexStream,
+                 int32_t compression = 0);
     FieldsReader(const DirectoryPtr& d, const String& segment, const FieldInfosPtr& fn);
     FieldsReader(const DirectoryPtr& d, const String& segment, const FieldInfosPtr& fn, int32_t readBufferSize, int32_t docStoreOffset = -1, int32_t size = 0);
 
@@ -49,6 +50,22 @@ protected:
     CloseableThreadLocal<IndexInput> fieldsStreamTL;
     bool isOriginal;
 
+    /// How the documents were compressed, one of IndexWriter's STORED_FIELDS_ constants.
+    int32_t compression;
+
+    /// The stream the fields of the current document are read from, fieldsStream or chunkStream.
+    IndexInputPtr docStream;
+
+    /// The last chunk read when the documents are compressed: its file pointer, the number of documents it holds,
+    /// where each of them starts in the decompressed chunk and the decompressed bytes.
+    int64_t chunkPointer;
+    int32_t chunkDocs;
+    Collection<int32_t> chunkDocStarts;
+    ByteArray chunkBuffer;
+    RAMFilePtr chunkFile;
+    RAMOutputStreamPtr chunkOutput;
+    IndexInputPtr chunkStream;
+
 public:
     /// Returns a cloned FieldsReader that shares open IndexInputs with the original one.  It is the caller's job not to
     /// close the original FieldsReader until all clones are called (eg, currently SegmentReader manages this logic).
@@ -66,8 +83,17 @@ public:
 
     /// Returns the length in bytes of each raw document in a contiguous range of length numDocs starting with startDocID.
     /// Returns the IndexInput (the fieldStream), already seeked to the starting point for startDocID.
+    /// When the documents are compressed, they must all be in the chunk of startDocID.
     IndexInputPtr rawDocs(Collection<int32_t> lengths, int32_t startDocID, int32_t numDocs);
 
+INTERNAL:
+    /// Returns how the documents were compressed, one of IndexWriter's STORED_FIELDS_ constants.
+    int32_t getCompression();
+
+    /// Returns the fields stream positioned at the compressed chunk holding docID, setting the position of docID
+    /// in the chunk, the number of documents in the chunk and its length in bytes.
+    IndexInputPtr rawChunk(int32_t docID, int32_t& docInChunk, int32_t& numDocs, int64_t& length);
+
 protected:
     void ConstructReader(const DirectoryPtr& d, const String& segment, const FieldInfosPtr& fn, int32_t readBufferSize, int32_t docStoreOffset, int32_t size);
 
@@ -75,6 +101,17 @@ protected:
 
     void seekIndex(int32_t docID);
 
+    /// Reads the header of the chunk at pointer, leaving the fields stream at its compressed bytes, and returns the
+    /// number of documents in the chunk.  Fills docStarts, if not null, with the start of each document and the
+    /// end of the last one.
+    int32_t readChunkHeader(int64_t pointer, Collection<int32_t> docStarts, uint8_t& codec, int32_t& compressedLength);
+
+    /// Decompresses the chunk at pointer into chunkStream, unless it is the last chunk read.
+    void loadChunk(int64_t pointer);
+
+    /// Seeks to the index entry of docID and loads its chunk, returning the position of docID in the chunk.
+    int32_t seekChunkDocument(int32_t docID);
+
     /// Skip the field.  We still have to read some of the information about the field, but can skip past the actual content.
     /// This will have the most payoff on large fields.
     void skipField(bool binary, bool compressed);
@@ -13,7 +13,7 @@ namespace Lucene {
 
 class FieldsWriter : public LuceneObject {
 public:
-    FieldsWriter(const DirectoryPtr& d, const String& segment, const FieldInfosPtr& fn);
+    FieldsWriter(const DirectoryPtr& d, const String& segment, const FieldInfosPtr& fn, int32_t compression = 0);
     FieldsWriter(const IndexOutputPtr& fdx, const IndexOutputPtr& fdt, const FieldInfosPtr& fn);
     virtual ~FieldsWriter();
 
@@ -25,6 +25,14 @@ protected:
     IndexOutputPtr indexStream;
     bool doClose;
 
+    /// One of IndexWriter's STORED_FIELDS_ constants, documents are buffered in chunkStream and written in
+    /// compressed chunks unless it is {@link IndexWriter#STORED_FIELDS_UNCOMPRESSED}.
+    int32_t compression;
+    RAMFilePtr chunkFile;
+    RAMOutputStreamPtr chunkStream;
+    Collection<int32_t> chunkDocLengths;
+    int64_t chunkDocStart;
+
 public:
     static const uint8_t FIELD_IS_TOKENIZED;
     static const uint8_t FIELD_IS_BINARY;
@@ -33,11 +41,20 @@ public:
     static const int32_t FORMAT; // Original format
     static const int32_t FORMAT_VERSION_UTF8_LENGTH_IN_BYTES; // Changed strings to UTF8
     static const int32_t FORMAT_LUCENE_3_0_NO_COMPRESSED_FIELDS; // Lucene 3.0: Removal of compressed fields
+    static const int32_t FORMAT_COMPRESSED_CHUNKS; // Documents compressed together in chunks
 
     // NOTE: if you introduce a new format, make it 1 higher than the current one, and always change this
     // if you switch to a new format!
     static const int32_t FORMAT_CURRENT;
 
+    /// A chunk is compressed once its documents take at least this many bytes.
+    static const int32_t CHUNK_SIZE;
+
+    /// Most documents in a chunk.  The index entry of a document in a chunk holds the file pointer of the chunk
+    /// shifted left by CHUNK_DOC_BITS and the position of the document in the chunk.
+    static const int32_t MAX_CHUNK_DOCS;
+    static const int32_t CHUNK_DOC_BITS;
+
 public:
     void setFieldsStream(const IndexOutputPtr& stream);
 
@@ -54,7 +71,26 @@ public:
     /// The stream IndexInput is the fieldsStream from which we should bulk-copy all bytes.
     void addRawDocuments(const IndexInputPtr& stream, Collection<int32_t> lengths, int32_t numDocs);
 
+    /// Bulk write a contiguous series of documents from a reader with the same field numbers, using lengths to hold
+    /// the length of each raw document.  Chunks of the reader that are compressed the same way as this writer compresses
+    /// them and that are wholly in the series are copied without decompressing them.
+    void addRawDocuments(const FieldsReaderPtr& reader, Collection<int32_t> lengths, int32_t startDocID, int32_t numDocs);
+
     void addDocument(const DocumentPtr& doc);
+
+    int32_t getCompression();
+
+protected:
+    /// Adds the index entry of a new document and returns the stream its fields are written to.
+    IndexOutputPtr startDocument();
+
+    /// Compresses the buffered documents once they fill a chunk.
+    void finishDocument();
+
+    /// Compresses the buffered documents and writes them as a chunk.
+    void flushChunk();
+
+    void writeField(const IndexOutputPtr& stream, const FieldInfoPtr& fi, const FieldablePtr& field);
 };
 
 }
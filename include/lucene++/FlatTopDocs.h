@@ -0,0 +1,52 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef FLATTOPDOCS_H
+#define FLATTOPDOCS_H
+
+#include "LuceneObject.h"
+
+namespace Lucene {
+
+/// A hit held by value, as collected by {@link FlatTopScoreDocCollector}.
+struct FlatScoreDoc {
+    /// The hit's document number.
+    int32_t doc;
+
+    /// The hit's score.
+    double score;
+};
+
+/// Represents hits collected by {@link FlatTopScoreDocCollector}.  Like {@link TopDocs}, except the hits are
+/// stored contiguously by value rather than as one {@link ScoreDoc} object each.
+class LPPAPI FlatTopDocs : public LuceneObject {
+public:
+    FlatTopDocs(int32_t totalHits, Collection<FlatScoreDoc> scoreDocs, double maxScore);
+    virtual ~FlatTopDocs();
+
+    LUCENE_CLASS(FlatTopDocs);
+
+public:
+    /// The total number of hits for the query.
+    int32_t totalHits;
+
+    /// The top hits for the query, by decreasing score then increasing doc.
+    Collection<FlatScoreDoc> scoreDocs;
+
+    /// Stores the maximum score value encountered, NaN if there were no hits.
+    double maxScore;
+
+public:
+    /// Returns the maximum score value encountered.
+    double getMaxScore();
+
+    /// Converts the hits to a {@link TopDocs}, for code that expects one {@link ScoreDoc} per hit.
+    TopDocsPtr toTopDocs();
+};
+
+}
+
+#endif
@@ -0,0 +1,76 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef FLATTOPSCOREDOCCOLLECTOR_H
+#define FLATTOPSCOREDOCCOLLECTOR_H
+
+#include "Collector.h"
+#include "FlatTopDocs.h"
+
+namespace Lucene {
+
+/// A {@link Collector} that collects the top-scoring hits like {@link TopScoreDocCollector}, sorted by score
+/// descending and then docID ascending, but keeps them by value in one contiguous heap of {@link FlatScoreDoc}
+/// rather than in a {@link HitQueue} of {@link ScoreDoc} objects.  Collecting allocates nothing and the heap
+/// stays in a single block of memory, which matters when many hits are requested.  The hits are returned as
+/// {@link FlatTopDocs}, which can be converted to {@link TopDocs} if needed.
+///
+/// When you create an instance of this collector you should know in advance whether documents are going to be
+/// collected in doc Id order or not.
+///
+/// NOTE: The values Nan, NEGATIVE_INFINITY and POSITIVE_INFINITY are not valid scores.  This collector will
+/// not properly collect hits with such scores.
+class LPPAPI FlatTopScoreDocCollector : public Collector {
+public:
+    FlatTopScoreDocCollector(int32_t numHits);
+    virtual ~FlatTopScoreDocCollector();
+
+    LUCENE_CLASS(FlatTopScoreDocCollector);
+
+protected:
+    int32_t numHits;
+
+    /// Binary heap of the hits, from index 1, with the weakest hit at the top.  It is filled with sentinels
+    /// that any hit beats, so it is always full.
+    Collection<FlatScoreDoc> heap;
+    FlatScoreDoc* heapArray;
+
+    /// The total number of documents that the collector encountered.
+    int32_t totalHits;
+
+    int32_t docBase;
+    ScorerWeakPtr _scorer;
+    Scorer* __scorer;
+
+public:
+    /// Creates a new {@link FlatTopScoreDocCollector} given the number of hits to collect and whether
+    /// documents are scored in order by the input {@link Scorer} to {@link #setScorer(ScorerPtr)}.
+    static FlatTopScoreDocCollectorPtr create(int32_t numHits, bool docsScoredInOrder);
+
+    virtual void setNextReader(const IndexReaderPtr& reader, int32_t docBase);
+    virtual void setScorer(const ScorerPtr& scorer);
+
+    /// The total number of documents that matched this query.
+    virtual int32_t getTotalHits();
+
+    /// Returns the top hits that were collected by this collector.
+    virtual FlatTopDocsPtr flatTopDocs();
+
+    /// Returns the hits in the range [start .. start + howMany) of the top hits collected.  Unlike {@link
+    /// TopDocsCollector#topDocs(int32_t, int32_t)} this can be called any number of times.
+    virtual FlatTopDocsPtr flatTopDocs(int32_t start, int32_t howMany);
+
+    /// Returns the top hits that were collected by this collector as {@link TopDocs}.
+    virtual TopDocsPtr topDocs();
+
+protected:
+    /// Replaces the weakest hit, at the top of the heap, and restores the heap order.
+    void updateTop(int32_t doc, double score);
+};
+
+}
+
+#endif
@@ -0,0 +1,58 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef FORUTIL_H
+#define FORUTIL_H
+
+#include "LuceneObject.h"
+
+namespace Lucene {
+
+/// Frame of reference encoding of fixed size blocks of non-negative integers, used by block encoded postings.
+///
+/// A block is written as one byte holding the number of bits required by its largest value, followed by
+/// every value packed with that many bits.  The values are interleaved over four 32-bit lanes (value i
+/// belongs to lane i % 4) and each lane is packed independently, so decoding applies identical shifts and
+/// masks to four adjacent words at a time - the layout expected by SIMD bit unpacking kernels.  A block of
+/// zeros is stored as the header byte alone.
+class LPPAPI ForUtil : public LuceneObject {
+public:
+    virtual ~ForUtil();
+    LUCENE_CLASS(ForUtil);
+
+public:
+    /// Number of values in a block.
+    static const int32_t BLOCK_SIZE;
+
+    /// Number of interleaved 32-bit lanes.
+    static const int32_t LANES;
+
+public:
+    /// Returns the number of bits needed to store the largest of the {@link #BLOCK_SIZE} given values.
+    static int32_t bitsRequired(const int32_t* values);
+
+    /// Returns the number of bytes following the header byte of a block packed with numBits bits per value.
+    static int32_t encodedSize(int32_t numBits);
+
+    /// Pack {@link #BLOCK_SIZE} values using numBits bits each into encodedSize(numBits) bytes.
+    static void pack(const int32_t* values, int32_t numBits, uint8_t* packed);
+
+    /// Unpack {@link #BLOCK_SIZE} values of numBits bits each.
+    static void unpack(const uint8_t* packed, int32_t numBits, int32_t* values);
+
+    /// Write a block of {@link #BLOCK_SIZE} values.
+    static void writeBlock(const IndexOutputPtr& out, const int32_t* values);
+
+    /// Read a block of {@link #BLOCK_SIZE} values written by {@link #writeBlock}.
+    static void readBlock(IndexInput* in, int32_t* values);
+
+    /// Skip over a block written by {@link #writeBlock}.
+    static void skipBlock(IndexInput* in);
+};
+
+}
+
+#endif
@@ -19,7 +19,8 @@ public:
 
 public:
     /// Adds a new doc in this term.  If this returns null then we just skip consuming positions/payloads.
-    virtual FormatPostingsPositionsConsumerPtr addDoc(int32_t docID, int32_t termDocFreq) = 0;
+    /// @param norm The byte-encoded norm of the doc's field, or 0 if the field omits norms.
+    virtual FormatPostingsPositionsConsumerPtr addDoc(int32_t docID, int32_t termDocFreq, uint8_t norm) = 0;
 
     /// Called when we are done adding docs to this term
     virtual void finish() = 0;
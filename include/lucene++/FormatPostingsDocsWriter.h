@@ -36,6 +36,18 @@ public:
     int32_t lastDocID;
     int32_t df;
 
+    /// Freqs and norms of the docs since the last skip point and of the whole term, stored in the skip data
+    /// when it has impacts
+    bool skipImpacts;
+    CompetitiveImpactAccumulatorPtr impactsSinceSkip;
+    CompetitiveImpactAccumulatorPtr termImpacts;
+
+    /// Doc deltas and freqs buffered until a full block can be written, used for block encoded postings
+    bool blockPostings;
+    IntArray docDeltaBuffer;
+    IntArray freqBuffer;
+    int32_t bufferUpto;
+
     TermInfoPtr termInfo; // minimize consing
     UTF8ResultPtr utf8;
 
@@ -45,12 +57,19 @@ public:
     void setField(const FieldInfoPtr& fieldInfo);
 
     /// Adds a new doc in this term.  If this returns null then we just skip consuming positions/payloads.
-    virtual FormatPostingsPositionsConsumerPtr addDoc(int32_t docID, int32_t termDocFreq);
+    virtual FormatPostingsPositionsConsumerPtr addDoc(int32_t docID, int32_t termDocFreq, uint8_t norm);
 
     /// Called when we are done adding docs to this term
     virtual void finish();
 
     void close();
+
+protected:
+    /// Write the buffered block of doc deltas and freqs and record a skip point after it
+    void flushBlock();
+
+    /// Write doc deltas and freqs that don't fill a block using variable length integers
+    void flushTail();
 };
 
 }
@@ -37,10 +37,14 @@ public:
 
 protected:
     int32_t postingUpto;
+    NormsWriterPerFieldPtr normsWriter; // of the same field and thread, null if it has no norms
 
 public:
     bool nextTerm();
     bool nextDoc();
+
+    /// Returns the byte-encoded norm of docID, as NormsWriterPerField buffered it for this field.
+    uint8_t norm();
 };
 
 }
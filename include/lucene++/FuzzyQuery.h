@@ -14,8 +14,13 @@ namespace Lucene {
 /// Implements the fuzzy search query.  The similarity measurement is based on the Levenshtein (edit
 /// distance) algorithm.
 ///
-/// Warning: this query is not very scalable with its default prefix length of 0 - in this case, *every*
-/// term will be enumerated and cause an edit score calculation.
+/// When the matching terms are within {@link LevenshteinAutomata#MAXIMUM_SUPPORTED_DISTANCE} edits of the
+/// query term, they are found by intersecting an automaton with the terms dictionary, which only reads
+/// the terms around the matches.  Otherwise, for long terms with a low minimum similarity, *every* term
+/// sharing the prefix will be enumerated and cause an edit score calculation, which doesn't scale with its
+/// default prefix length of 0.  With the default minimum similarity of 0.5 that is any term longer than 5
+/// characters, unless the edits are also bounded, see {@link #floatToEdits} and {@link
+/// QueryParser#setFuzzyBoundEdits}.
 class LPPAPI FuzzyQuery : public MultiTermQuery {
 public:
     /// Create a new FuzzyQuery that will match terms with a similarity of at least minimumSimilarity
@@ -30,6 +35,23 @@ public:
     FuzzyQuery(const TermPtr& term, double minimumSimilarity);
     FuzzyQuery(const TermPtr& term);
 
+    /// Create a new FuzzyQuery that will match terms with a similarity of at least minimumSimilarity
+    /// to term that are also within maxEdits edits of it.  Bounding the edits by at most {@link
+    /// LevenshteinAutomata#MAXIMUM_SUPPORTED_DISTANCE} keeps long terms off the full term scan.
+    /// @param term The term to search for
+    /// @param minimumSimilarity A value between 0 and 1 to set the required similarity
+    /// @param prefixLength Length of common (non-fuzzy) prefix
+    /// @param maxEdits The number of edits allowed, at most {@link LevenshteinAutomata#MAXIMUM_SUPPORTED_DISTANCE}
+    FuzzyQuery(const TermPtr& term, double minimumSimilarity, int32_t prefixLength, int32_t maxEdits);
+
+    /// Create a new FuzzyQuery that will match terms within maxEdits edits of term.
+    /// @param term The term to search for
+    /// @param maxEdits The number of edits allowed, at most {@link LevenshteinAutomata#MAXIMUM_SUPPORTED_DISTANCE}
+    /// @param prefixLength Length of common (non-fuzzy) prefix
+    /// @param transpositions Whether the transposition of two adjacent characters counts as one edit
+    /// rather than two
+    FuzzyQuery(const TermPtr& term, int32_t maxEdits, int32_t prefixLength, bool transpositions);
+
     virtual ~FuzzyQuery();
 
     LUCENE_CLASS(FuzzyQuery);
@@ -37,6 +59,9 @@ public:
 protected:
     double minimumSimilarity;
     int32_t prefixLength;
+    int32_t maxEdits; // -1 when matching by minimumSimilarity
+    int32_t maxSimilarityEdits; // -1 when the edits of a minimumSimilarity match are unbounded
+    bool transpositions;
     bool termLongEnough;
 
     TermPtr term;
@@ -45,6 +70,10 @@ public:
     static double defaultMinSimilarity();
     static const int32_t defaultPrefixLength;
 
+    /// Returns the number of edits a term of termLength characters can be from a term with a similarity
+    /// of at least minimumSimilarity, bounded by {@link LevenshteinAutomata#MAXIMUM_SUPPORTED_DISTANCE}.
+    static int32_t floatToEdits(double minimumSimilarity, int32_t termLength);
+
 public:
     using MultiTermQuery::toString;
 
@@ -56,6 +85,12 @@ public:
     /// must be identical (not fuzzy) to the query term if the query is to match that term.
     int32_t getPrefixLength();
 
+    /// Returns the number of edits allowed, or -1 if the query matches by minimum similarity.
+    int32_t getMaxEdits();
+
+    /// Returns whether the transposition of two adjacent characters counts as one edit.
+    bool getTranspositions();
+
     /// Returns the pattern term.
     TermPtr getTerm();
 
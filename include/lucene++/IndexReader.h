@@ -380,6 +380,11 @@ public:
     /// @see Field#setBoost(double)
     virtual void norms(const String& field, ByteArray norms, int32_t offset) = 0;
 
+    /// Returns the per-document values of the named field, as written for {@link DocValuesField}s, or null if
+    /// no document of this reader has a value for it.  Only segment readers hold doc values; composite readers
+    /// return null, their values are read per segment.
+    virtual NumericDocValuesPtr getNumericDocValues(const String& field);
+
     /// Resets the normalization factor for the named field of the named  document.  The norm represents
     /// the product of the field's {@link Fieldable#setBoost(double) boost} and its {@link
     /// Similarity#lengthNorm(String, int) length normalization}.  Thus, to preserve the length normalization
@@ -32,6 +32,12 @@ public:
     /// Creates a searcher searching the provided index.
     IndexSearcher(const IndexReaderPtr& reader);
 
+    /// Creates a searcher searching the provided index that scores each of the index's segments concurrently
+    /// using the given thread pool.  Top hits from {@link #search(WeightPtr, FilterPtr, int32_t)} and its sorting
+    /// variants are computed per segment and merged, the same way {@link ParallelMultiSearcher} does for a set
+    /// of {@link Searchable}s.  Searches that supply their own {@link Collector} are still run sequentially.
+    IndexSearcher(const IndexReaderPtr& reader, const ThreadPoolPtr& executor);
+
     /// Directly specify the reader, subReaders and their docID starts.
     IndexSearcher(const IndexReaderPtr& reader, Collection<IndexReaderPtr> subReaders, Collection<int32_t> docStarts);
 
@@ -50,11 +56,21 @@ protected:
 
     bool fieldSortDoTrackScores;
     bool fieldSortDoMaxScore;
+    bool totalHitsLowerBound;
+
+    /// Optional thread pool used to search segments concurrently.
+    ThreadPoolPtr executor;
+
+    /// Per-segment searchers used when searching concurrently.
+    Collection<SearchablePtr> subSearchers;
 
 public:
     /// Return the {@link IndexReader} this searches.
     IndexReaderPtr getIndexReader();
 
+    /// Return the thread pool used to search segments concurrently, or null if searches are sequential.
+    ThreadPoolPtr getExecutor();
+
     /// Note that the underlying IndexReader is not closed, if IndexSearcher was constructed with
     /// IndexSearcher(const IndexReaderPtr& reader).  If the IndexReader was supplied implicitly by specifying a
     /// directory, then the IndexReader gets closed.
@@ -91,10 +107,26 @@ public:
     /// @param doMaxScore If true, then the max score for all matching docs is computed.
     virtual void setDefaultFieldSortScoring(bool doTrackScores, bool doMaxScore);
 
+    /// By default every match is counted by searches for the top hits by score.  If totalHitsLowerBound is
+    /// true, unfiltered top hits searches let queries that support it skip documents which can't make it into
+    /// the top hits (see {@link Weight#competitiveScorer(IndexReaderPtr)}), so {@link TopDocs#totalHits} may be
+    /// a lower bound, as flagged by {@link TopDocs#totalHitsIsLowerBound}.  Disjunctions of terms use the
+    /// term freqs and norms stored in the skip lists to skip whole blocks of postings, in segments written
+    /// with {@link IndexWriter#setUseSkipImpacts(bool)}.
+    virtual void setTotalHitsLowerBound(bool totalHitsLowerBound);
+
+    /// Returns true if top hits searches may report a lower bound of the total hits.
+    virtual bool getTotalHitsLowerBound();
+
 protected:
     void ConstructSearcher(const IndexReaderPtr& reader, bool closeReader);
     void gatherSubReaders(Collection<IndexReaderPtr> allSubReaders, const IndexReaderPtr& reader);
     void searchWithFilter(const IndexReaderPtr& reader, const WeightPtr& weight, const FilterPtr& filter, const CollectorPtr& collector);
+
+    /// Returns true if top hits should be gathered by scoring each segment on the executor.
+    bool searchConcurrently();
+    TopDocsPtr searchParallel(const WeightPtr& weight, const FilterPtr& filter, int32_t n);
+    TopFieldDocsPtr searchParallel(const WeightPtr& weight, const FilterPtr& filter, int32_t n, const SortPtr& sort);
 };
 
 }
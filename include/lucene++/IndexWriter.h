@@ -144,6 +144,9 @@ protected:
     LockPtr writeLock;
 
     int32_t termIndexInterval;
+    bool useBlockPostings;
+    bool useSkipImpacts;
+    int32_t storedFieldsCompression;
 
     bool closed;
     bool closing;
@@ -193,6 +196,11 @@ protected:
     HashSet<String> syncing; // files that are now being sync'd
 
     IndexReaderWarmerPtr mergedSegmentWarmer;
+    HashSet<String> warmedSegments; // segments already passed to mergedSegmentWarmer
+
+    int32_t readerCount;
+    int64_t lastReaderLatency;
+    int64_t totalReaderLatency;
 
     /// Used only by commit; lock order is commitLock -> IW
     SynchronizePtr commitLock;
@@ -242,6 +250,15 @@ public:
     /// Sets the maximum field length to {@link #DEFAULT_MAX_FIELD_LENGTH}
     static const int32_t MaxFieldLengthLIMITED;
 
+    /// Stored fields are written one document at a time, uncompressed.  This is the default.
+    static const int32_t STORED_FIELDS_UNCOMPRESSED;
+
+    /// Stored fields are written in chunks of documents compressed with a fast LZ4 style codec.
+    static const int32_t STORED_FIELDS_COMPRESS_FAST;
+
+    /// Stored fields are written in chunks of documents compressed with zlib, for a better ratio.
+    static const int32_t STORED_FIELDS_COMPRESS_HIGH;
+
 public:
     virtual void initialize();
 
@@ -261,8 +278,11 @@ public:
     /// to determine if it's fast enough.  As this is a new and experimental feature, please report
     /// back on your findings so we can learn, improve and iterate.
     ///
-    /// The resulting reader supports {@link IndexReader#reopen}, but that call will simply forward
-    /// back to this method (though this may change in the future).
+    /// The resulting reader supports {@link IndexReader#reopen}, which returns the same reader if nothing
+    /// changed since it was opened and otherwise forwards back to this method.
+    ///
+    /// The segments of the new reader share the readers this writer pools, so segments that didn't change
+    /// since the last call keep their deletions, norms and {@link FieldCache} entries.
     ///
     /// The very first time this method is called, this writer instance will make every effort to
     /// pool the readers that it opens for doing merges, applying deletes, etc.  This means additional
@@ -270,7 +290,8 @@ public:
     ///
     /// For lower latency on reopening a reader, you should call {@link #setMergedSegmentWarmer} to
     /// pre-warm a newly merged segment before it's committed to the index.  This is important for
-    /// minimizing index-to-search delay after a large merge.
+    /// minimizing index-to-search delay after a large merge.  The same warmer is passed each newly
+    /// flushed segment before the reader containing it is returned.
     ///
     /// If an addIndexes* call is running in another thread, then this reader will only search those
     /// segments from the foreign index that have been successfully copied over, so far.
@@ -295,6 +316,16 @@ public:
     /// The default value is 1.  Set this to -1 to skip loading the terms index entirely.
     virtual IndexReaderPtr getReader(int32_t termInfosIndexDivisor);
 
+    /// Returns the number of readers returned by {@link #getReader}.
+    virtual int32_t getReaderCount();
+
+    /// Returns how long the last call to {@link #getReader} took, in milliseconds, including flushing and
+    /// warming new segments.
+    virtual int64_t getLastReaderLatency();
+
+    /// Returns how long all calls to {@link #getReader} took, in milliseconds.
+    virtual int64_t getTotalReaderLatency();
+
     /// Obtain the number of deleted docs for a pooled reader. If the reader isn't being pooled,
     /// the segmentInfo's delCount is returned.
     virtual int32_t numDeletedDocs(const SegmentInfoPtr& info);
@@ -358,6 +389,39 @@ public:
     /// @see #setTermIndexInterval(int32_t)
     virtual int32_t getTermIndexInterval();
 
+    /// Determines whether newly flushed and merged segments store the doc deltas and freqs of their postings in
+    /// bit packed blocks of {@link ForUtil#BLOCK_SIZE} docs instead of one variable length integer per value.
+    /// Block encoded postings decode a whole block at a time, which speeds up {@link TermDocs#read} and long
+    /// posting list traversals.  Segments in either format may be mixed within an index.  Default is false.
+    virtual void setUseBlockPostings(bool useBlockPostings);
+
+    /// Returns true if new segments are written with block encoded postings.
+    /// @see #setUseBlockPostings(bool)
+    virtual bool getUseBlockPostings();
+
+    /// Determines whether newly flushed and merged segments store the competitive (term freq, norm) pairs of
+    /// every skip interval in their skip data, see {@link TermInfosWriter#FORMAT_SKIP_IMPACTS}.  They bound the
+    /// score of skipped docs, which lets top hits searches of disjunctions skip blocks that can't compete, at
+    /// the cost of slightly larger .frq files.  Segments written without them are searched without pruning.
+    /// Default is false.
+    virtual void setUseSkipImpacts(bool useSkipImpacts);
+
+    /// Returns true if new segments are written with impacts in their skip data.
+    /// @see #setUseSkipImpacts(bool)
+    virtual bool getUseSkipImpacts();
+
+    /// Determines how newly flushed and merged segments store their fields, one of {@link
+    /// #STORED_FIELDS_UNCOMPRESSED}, {@link #STORED_FIELDS_COMPRESS_FAST} or {@link #STORED_FIELDS_COMPRESS_HIGH}.
+    /// Compressed stored fields group documents into chunks of about {@link FieldsWriter#CHUNK_SIZE} bytes that
+    /// are compressed together, which makes the .fdt file much smaller for similar documents, and readers keep
+    /// the last chunk they decompressed so that loading neighbouring documents decompresses it only once.
+    /// Segments in either format may be mixed within an index.  Default is {@link #STORED_FIELDS_UNCOMPRESSED}.
+    virtual void setStoredFieldsCompression(int32_t compression);
+
+    /// Returns how new segments store their fields.
+    /// @see #setStoredFieldsCompression(int32_t)
+    virtual int32_t getStoredFieldsCompression();
+
     /// Set the merge policy used by this writer.
     virtual void setMergePolicy(const MergePolicyPtr& mp);
 
@@ -762,6 +826,10 @@ public:
     /// MergePolicy.
     virtual OneMergePtr getNextMerge();
 
+    /// Returns the segments that are currently being merged, so that a {@link MergePolicy} can leave
+    /// them out of the merges it selects.
+    virtual SetSegmentInfo getMergingSegments();
+
     /// Close the IndexWriter without committing any changes that have occurred since the last commit
     /// (or since it was opened, if commit hasn't been called).  This removes any temporary files that
     /// had been created, after which the state of the index will be the same as it was when commit()
@@ -950,7 +1018,11 @@ public:
     ///   startMergeInit
     virtual bool testPoint(const String& name);
 
-    virtual bool nrtIsCurrent(const SegmentInfosPtr& infos);
+    virtual bool nrtIsCurrent(const SegmentInfosPtr& infos, int64_t changeCount);
+
+    /// Returns a count that changes each time a change to the index completes, including deletions applied
+    /// to the pooled readers.
+    virtual int64_t getChangeCount();
     virtual bool isClosed();
 
 protected:
@@ -1045,7 +1117,9 @@ protected:
     virtual bool doFlush(bool flushDocStores, bool flushDeletes);
     virtual bool doFlushInternal(bool flushDocStores, bool flushDeletes);
 
-    virtual int32_t ensureContiguousMerge(const OneMergePtr& merge);
+    /// Checks that every segment the merge policy selected is in the index.  The segments need not be
+    /// adjacent: the merged segment takes the place of the first of them.
+    virtual void ensureValidMerge(const OneMergePtr& merge);
 
     /// Carefully merges deletes for the segments we just merged.  This is tricky because, although merging
     /// will clear all deletes (compacts the documents), new deletes may have been flushed to the segments
@@ -1094,7 +1168,8 @@ protected:
 /// If {@link #getReader} has been called (ie, this writer is in near real-time mode), then after
 /// a merge completes, this class can be invoked to warm the reader on the newly merged segment,
 /// before the merge commits.  This is not required for near real-time search, but will reduce
-/// search latency on opening a new near real-time reader after a merge completes.
+/// search latency on opening a new near real-time reader after a merge completes.  Segments
+/// flushed by {@link IndexWriter#getReader} are warmed before the reader is returned.
 ///
 /// NOTE: warm is called before any deletes have been carried over to the merged segment.
 class LPPAPI IndexReaderWarmer : public LuceneObject {
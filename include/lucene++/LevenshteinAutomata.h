@@ -0,0 +1,47 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef LEVENSHTEINAUTOMATA_H
+#define LEVENSHTEINAUTOMATA_H
+
+#include "LuceneObject.h"
+
+namespace Lucene {
+
+/// Builds deterministic automata accepting the strings within a given edit distance of an input string.
+///
+/// An edit is the insertion, deletion or substitution of a character and, if enabled, the transposition
+/// of two adjacent characters (so the distance is the optimal string alignment distance).
+class LPPAPI LevenshteinAutomata : public LuceneObject {
+public:
+    /// @param input The string to match
+    /// @param transpositions Whether a transposition counts as one edit rather than two
+    LevenshteinAutomata(const String& input, bool transpositions);
+    virtual ~LevenshteinAutomata();
+
+    LUCENE_CLASS(LevenshteinAutomata);
+
+public:
+    /// Largest edit distance an automaton can be built for, the automata growing quickly with it.
+    static const int32_t MAXIMUM_SUPPORTED_DISTANCE;
+
+protected:
+    String input;
+    bool transpositions;
+
+public:
+    /// Returns an automaton accepting the strings within n edits of the input, or null if n is greater
+    /// than {@link #MAXIMUM_SUPPORTED_DISTANCE}.
+    AutomatonPtr toAutomaton(int32_t n);
+
+    /// Returns an automaton accepting prefix followed by a string within n edits of the input, or null
+    /// if n is greater than {@link #MAXIMUM_SUPPORTED_DISTANCE}.
+    AutomatonPtr toAutomaton(int32_t n, const String& prefix);
+};
+
+}
+
+#endif
@@ -8,6 +8,7 @@
 #define ALLOCATOR_H
 
 #include "Config.h"
+#include <new>
 
 namespace Lucene {
 
@@ -19,6 +20,75 @@ LPPAPI void* ReallocMemory(void* memory, size_t size);
 
 /// Release a given block of memory.
 LPPAPI void FreeMemory(void* memory);
+
+/// The functions that {@link AllocMemory}, {@link ReallocMemory} and {@link FreeMemory} get their memory
+/// from, malloc, realloc and free by default.
+struct MemoryHooks {
+    void* (*alloc)(size_t size);
+    void* (*realloc)(void* memory, size_t size);
+    void (*free)(void* memory);
+};
+
+/// Replace the functions memory is allocated with, for example to use an arena or a different malloc.
+/// Must be called before anything is allocated, as memory is freed with the hooks in place at the time.
+LPPAPI void SetMemoryHooks(const MemoryHooks& hooks);
+
+/// Small blocks that are freed are kept in a per-thread cache for each size class and handed out again by
+/// the next allocation of the same class, so that short lived objects such as terms, score docs and their
+/// shared_ptr control blocks don't go through malloc.  Enabled by default.
+LPPAPI void SetMemoryPooling(bool pooling);
+LPPAPI bool GetMemoryPooling();
+
+/// Allocation counters, only maintained while enabled with {@link SetMemoryStats}.
+struct MemoryStats {
+    int64_t allocations; // number of blocks allocated
+    int64_t frees; // number of blocks freed
+    int64_t pooledAllocations; // allocations served from a thread's cache
+    int64_t bytesAllocated; // total size of the blocks allocated
+    int64_t bytesInUse; // size of the blocks allocated and not freed since the counters were enabled
+};
+
+/// Enable or disable the allocation counters, enabling them resets them.
+LPPAPI void SetMemoryStats(bool enabled);
+LPPAPI MemoryStats GetMemoryStats();
+
+/// Standard allocator that gets its memory from {@link AllocMemory}, used by {@link newInstance} so that
+/// objects and their reference counts share one pooled block.
+template <class T>
+class LuceneAllocator {
+public:
+    typedef T value_type;
+
+    LuceneAllocator() {
+    }
+
+    template <class U>
+    LuceneAllocator(const LuceneAllocator<U>&) {
+    }
+
+    T* allocate(size_t n) {
+        void* memory = AllocMemory(n * sizeof(T));
+        if (memory == NULL) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(memory);
+    }
+
+    void deallocate(T* p, size_t) {
+        FreeMemory(p);
+    }
+
+    template <class U>
+    bool operator== (const LuceneAllocator<U>&) const {
+        return true;
+    }
+
+    template <class U>
+    bool operator!= (const LuceneAllocator<U>&) const {
+        return false;
+    }
+};
+
 }
 
 #endif
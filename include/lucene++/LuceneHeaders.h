@@ -101,6 +101,7 @@
 // Include most common files: store
 #include "FSDirectory.h"
 #include "MMapDirectory.h"
+#include "NIOFSDirectory.h"
 #include "RAMDirectory.h"
 #include "RAMFile.h"
 #include "RAMInputStream.h"
@@ -77,6 +77,7 @@ DECLARE_SHARED_PTR(AbstractField)
 DECLARE_SHARED_PTR(CompressionTools)
 DECLARE_SHARED_PTR(DateField)
 DECLARE_SHARED_PTR(DateTools)
+DECLARE_SHARED_PTR(DocValuesField)
 DECLARE_SHARED_PTR(Document)
 DECLARE_SHARED_PTR(Field)
 DECLARE_SHARED_PTR(Fieldable)
@@ -100,6 +101,7 @@ DECLARE_SHARED_PTR(CharBlockPool)
 DECLARE_SHARED_PTR(CheckAbort)
 DECLARE_SHARED_PTR(CheckIndex)
 DECLARE_SHARED_PTR(CommitPoint)
+DECLARE_SHARED_PTR(CompetitiveImpactAccumulator)
 DECLARE_SHARED_PTR(CompoundFileReader)
 DECLARE_SHARED_PTR(CompoundFileWriter)
 DECLARE_SHARED_PTR(ConcurrentMergeScheduler)
@@ -126,6 +128,9 @@ DECLARE_SHARED_PTR(DocInverter)
 DECLARE_SHARED_PTR(DocInverterPerField)
 DECLARE_SHARED_PTR(DocInverterPerThread)
 DECLARE_SHARED_PTR(DocState)
+DECLARE_SHARED_PTR(DocValuesReader)
+DECLARE_SHARED_PTR(DocValuesWriter)
+DECLARE_SHARED_PTR(DocValuesWriterPerThread)
 DECLARE_SHARED_PTR(DocumentsWriter)
 DECLARE_SHARED_PTR(DocumentsWriterThreadState)
 DECLARE_SHARED_PTR(DocWriter)
@@ -195,6 +200,7 @@ DECLARE_SHARED_PTR(NormsWriter)
 DECLARE_SHARED_PTR(NormsWriterPerField)
 DECLARE_SHARED_PTR(NormsWriterPerThread)
 DECLARE_SHARED_PTR(Num)
+DECLARE_SHARED_PTR(NumericDocValues)
 DECLARE_SHARED_PTR(OneMerge)
 DECLARE_SHARED_PTR(ParallelArrayTermVectorMapper)
 DECLARE_SHARED_PTR(ParallelReader)
@@ -255,6 +261,7 @@ DECLARE_SHARED_PTR(TermsHashConsumerPerField)
 DECLARE_SHARED_PTR(TermsHashConsumerPerThread)
 DECLARE_SHARED_PTR(TermsHashPerField)
 DECLARE_SHARED_PTR(TermsHashPerThread)
+DECLARE_SHARED_PTR(TermsIndex)
 DECLARE_SHARED_PTR(TermVectorEntry)
 DECLARE_SHARED_PTR(TermVectorEntryFreqSortedComparator)
 DECLARE_SHARED_PTR(TermVectorMapper)
@@ -268,6 +275,7 @@ DECLARE_SHARED_PTR(TermVectorsTermsWriterPerThread)
 DECLARE_SHARED_PTR(TermVectorsTermsWriterPostingList)
 DECLARE_SHARED_PTR(TermVectorsWriter)
 DECLARE_SHARED_PTR(TermVectorsPositionInfo)
+DECLARE_SHARED_PTR(TieredMergePolicy)
 DECLARE_SHARED_PTR(WaitQueue)
 
 // query parser
@@ -280,14 +288,16 @@ DECLARE_SHARED_PTR(QueryParserToken)
 DECLARE_SHARED_PTR(QueryParserTokenManager)
 
 // search
+DECLARE_SHARED_PTR(AutomatonFuzzyTermEnum)
+DECLARE_SHARED_PTR(AutomatonTermEnum)
 DECLARE_SHARED_PTR(AveragePayloadFunction)
+DECLARE_SHARED_PTR(BatchScorer)
+DECLARE_SHARED_PTR(BlockMaxDisjunctionScorer)
 DECLARE_SHARED_PTR(BooleanClause)
 DECLARE_SHARED_PTR(BooleanQuery)
 DECLARE_SHARED_PTR(BooleanScorer)
-DECLARE_SHARED_PTR(BooleanScorerCollector)
 DECLARE_SHARED_PTR(BooleanScorer2)
 DECLARE_SHARED_PTR(BooleanWeight)
-DECLARE_SHARED_PTR(Bucket)
 DECLARE_SHARED_PTR(BucketScorer)
 DECLARE_SHARED_PTR(BucketTable)
 DECLARE_SHARED_PTR(ByteCache)
@@ -329,7 +339,6 @@ DECLARE_SHARED_PTR(DisjunctionSumScorer)
 DECLARE_SHARED_PTR(DocIdSet)
 DECLARE_SHARED_PTR(DocIdSetIterator)
 DECLARE_SHARED_PTR(DocValues)
-DECLARE_SHARED_PTR(DoubleCache)
 DECLARE_SHARED_PTR(DoubleFieldSource)
 DECLARE_SHARED_PTR(DoubleParser)
 DECLARE_SHARED_PTR(EmptyDocIdSet)
@@ -342,6 +351,7 @@ DECLARE_SHARED_PTR(FieldCacheDocIdSet)
 DECLARE_SHARED_PTR(FieldCacheEntry)
 DECLARE_SHARED_PTR(FieldCacheEntryImpl)
 DECLARE_SHARED_PTR(FieldCacheImpl)
+DECLARE_SHARED_PTR(FieldCacheNumericValues)
 DECLARE_SHARED_PTR(FieldCacheRangeFilter)
 DECLARE_SHARED_PTR(FieldCacheRangeFilterByte)
 DECLARE_SHARED_PTR(FieldCacheRangeFilterDouble)
@@ -349,8 +359,11 @@ DECLARE_SHARED_PTR(FieldCacheRangeFilterInt)
 DECLARE_SHARED_PTR(FieldCacheRangeFilterLong)
 DECLARE_SHARED_PTR(FieldCacheRangeFilterString)
 DECLARE_SHARED_PTR(FieldCacheSource)
+DECLARE_SHARED_PTR(FieldCacheStringIndex)
 DECLARE_SHARED_PTR(FieldCacheTermsFilter)
 DECLARE_SHARED_PTR(FieldCacheTermsFilterDocIdSet)
+DECLARE_SHARED_PTR(FieldCacheWarmer)
+DECLARE_SHARED_PTR(FieldCacheWarmerTask)
 DECLARE_SHARED_PTR(FieldComparator)
 DECLARE_SHARED_PTR(FieldComparatorSource)
 DECLARE_SHARED_PTR(FieldDoc)
@@ -371,16 +384,16 @@ DECLARE_SHARED_PTR(FilteredQueryWeight)
 DECLARE_SHARED_PTR(FilteredTermEnum)
 DECLARE_SHARED_PTR(FilterItem)
 DECLARE_SHARED_PTR(FilterManager)
+DECLARE_SHARED_PTR(FlatTopDocs)
+DECLARE_SHARED_PTR(FlatTopScoreDocCollector)
 DECLARE_SHARED_PTR(FuzzyQuery)
 DECLARE_SHARED_PTR(FuzzyTermEnum)
 DECLARE_SHARED_PTR(HitQueue)
 DECLARE_SHARED_PTR(HitQueueBase)
 DECLARE_SHARED_PTR(IDFExplanation)
 DECLARE_SHARED_PTR(IndexSearcher)
-DECLARE_SHARED_PTR(IntCache)
 DECLARE_SHARED_PTR(IntFieldSource)
 DECLARE_SHARED_PTR(IntParser)
-DECLARE_SHARED_PTR(LongCache)
 DECLARE_SHARED_PTR(LongParser)
 DECLARE_SHARED_PTR(MatchAllDocsQuery)
 DECLARE_SHARED_PTR(MatchAllDocsWeight)
@@ -403,6 +416,10 @@ DECLARE_SHARED_PTR(NumericUtilsIntParser)
 DECLARE_SHARED_PTR(NumericUtilsLongParser)
 DECLARE_SHARED_PTR(OneComparatorFieldValueHitQueue)
 DECLARE_SHARED_PTR(OrdFieldSource)
+DECLARE_SHARED_PTR(PackedDoubleCache)
+DECLARE_SHARED_PTR(PackedIntCache)
+DECLARE_SHARED_PTR(PackedLongCache)
+DECLARE_SHARED_PTR(PackedStringIndexCache)
 DECLARE_SHARED_PTR(ParallelMultiSearcher)
 DECLARE_SHARED_PTR(Parser)
 DECLARE_SHARED_PTR(PayloadFunction)
@@ -426,6 +443,7 @@ DECLARE_SHARED_PTR(PriorityQueueScoreDocs)
 DECLARE_SHARED_PTR(Query)
 DECLARE_SHARED_PTR(QueryTermVector)
 DECLARE_SHARED_PTR(QueryWrapperFilter)
+DECLARE_SHARED_PTR(RegexpQuery)
 DECLARE_SHARED_PTR(ReqExclScorer)
 DECLARE_SHARED_PTR(ReqOptSumScorer)
 DECLARE_SHARED_PTR(RewriteMethod)
@@ -464,7 +482,6 @@ DECLARE_SHARED_PTR(SpanWeight)
 DECLARE_SHARED_PTR(StartEnd)
 DECLARE_SHARED_PTR(StringCache)
 DECLARE_SHARED_PTR(StringIndex)
-DECLARE_SHARED_PTR(StringIndexCache)
 DECLARE_SHARED_PTR(SubScorer)
 DECLARE_SHARED_PTR(TermQuery)
 DECLARE_SHARED_PTR(TermRangeFilter)
@@ -505,13 +522,19 @@ DECLARE_SHARED_PTR(MMapDirectory)
 DECLARE_SHARED_PTR(MMapIndexInput)
 DECLARE_SHARED_PTR(NativeFSLock)
 DECLARE_SHARED_PTR(NativeFSLockFactory)
+DECLARE_SHARED_PTR(NIOFSDirectory)
+DECLARE_SHARED_PTR(NIOFSIndexInput)
 DECLARE_SHARED_PTR(NoLock)
 DECLARE_SHARED_PTR(NoLockFactory)
 DECLARE_SHARED_PTR(OutputFile)
+DECLARE_SHARED_PTR(PositionalInputFile)
 DECLARE_SHARED_PTR(RAMDirectory)
 DECLARE_SHARED_PTR(RAMFile)
 DECLARE_SHARED_PTR(RAMInputStream)
 DECLARE_SHARED_PTR(RAMOutputStream)
+DECLARE_SHARED_PTR(RateLimitedDirectoryWrapper)
+DECLARE_SHARED_PTR(RateLimitedIndexOutput)
+DECLARE_SHARED_PTR(RateLimiter)
 DECLARE_SHARED_PTR(SimpleFSDirectory)
 DECLARE_SHARED_PTR(SimpleFSIndexInput)
 DECLARE_SHARED_PTR(SimpleFSIndexOutput)
@@ -525,6 +548,7 @@ DECLARE_SHARED_PTR(Attribute)
 DECLARE_SHARED_PTR(AttributeFactory)
 DECLARE_SHARED_PTR(AttributeSource)
 DECLARE_SHARED_PTR(AttributeSourceState)
+DECLARE_SHARED_PTR(Automaton)
 DECLARE_SHARED_PTR(BitSet)
 DECLARE_SHARED_PTR(BitVector)
 DECLARE_SHARED_PTR(BufferedReader)
@@ -541,6 +565,7 @@ DECLARE_SHARED_PTR(InfoStreamOut)
 DECLARE_SHARED_PTR(InputStreamReader)
 DECLARE_SHARED_PTR(Insanity)
 DECLARE_SHARED_PTR(IntRangeBuilder)
+DECLARE_SHARED_PTR(LevenshteinAutomata)
 DECLARE_SHARED_PTR(LongRangeBuilder)
 DECLARE_SHARED_PTR(LuceneObject)
 DECLARE_SHARED_PTR(LuceneSignal)
@@ -549,9 +574,12 @@ DECLARE_SHARED_PTR(NumericUtils)
 DECLARE_SHARED_PTR(OpenBitSet)
 DECLARE_SHARED_PTR(OpenBitSetDISI)
 DECLARE_SHARED_PTR(OpenBitSetIterator)
+DECLARE_SHARED_PTR(PackedInts)
 DECLARE_SHARED_PTR(Random)
 DECLARE_SHARED_PTR(Reader)
 DECLARE_SHARED_PTR(ReaderField)
+DECLARE_SHARED_PTR(RegExp)
+DECLARE_SHARED_PTR(RegExpNode)
 DECLARE_SHARED_PTR(ScorerDocQueue)
 DECLARE_SHARED_PTR(SortedVIntList)
 DECLARE_SHARED_PTR(StringReader)
@@ -14,7 +14,8 @@ namespace Lucene {
 /// File-based {@link Directory} implementation that uses mmap for reading, and {@link SimpleFSIndexOutput} for writing.
 ///
 /// NOTE: memory mapping uses up a portion of the virtual memory address space in your process equal to the size of the
-/// file being mapped.  Before using this class, be sure your have plenty of virtual address space.
+/// file being mapped.  Before using this class, be sure your have plenty of virtual address space.  Files are mapped in
+/// chunks of at most {@link #getMaxChunkSize} bytes, so files of any size can be read.
 ///
 /// NOTE: Accessing this class either directly or indirectly from a thread while it's interrupted can close the
 /// underlying channel immediately if at the same time the thread is blocked on IO.  The channel will remain closed and
@@ -30,9 +31,25 @@ public:
 
     LUCENE_CLASS(MMapDirectory);
 
+public:
+    /// Default maximum chunk size: 1GB on 64-bit platforms and 256MB on 32-bit platforms.
+    static const int64_t DEFAULT_MAX_CHUNK_SIZE;
+
+protected:
+    int32_t chunkSizePower;
+
 public:
     using FSDirectory::openInput;
 
+    /// Sets the maximum chunk size used to map files.  The size is rounded down to the nearest power of two and must
+    /// be at least the platform's mapping alignment (usually the page size).  Smaller chunks use less contiguous
+    /// virtual address space, at the cost of more mappings per file.  Only affects inputs opened after this call.
+    void setMaxChunkSize(int64_t maxChunkSize);
+
+    /// Returns the current chunk size used to map files.
+    /// @see #setMaxChunkSize
+    int64_t getMaxChunkSize();
+
     /// Creates an IndexInput for the file with the given name.
     virtual IndexInputPtr openInput(const String& name, int32_t bufferSize);
 
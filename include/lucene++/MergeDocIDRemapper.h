@@ -13,8 +13,8 @@ namespace Lucene {
 
 /// Remaps docIDs after a merge has completed, where the merged segments had at least one deletion.
 /// This is used to renumber the buffered deletes in IndexWriter when a merge of segments with deletions
-/// commits.
-class MergeDocIDRemapper : public LuceneObject {
+/// commits.  The merged segments need not be adjacent, the merged segment takes the place of the first.
+class LPPAPI MergeDocIDRemapper : public LuceneObject {
 public:
     MergeDocIDRemapper(const SegmentInfosPtr& infos, Collection< Collection<int32_t> > docMaps, Collection<int32_t> delCounts, const OneMergePtr& merge, int32_t mergedDocCount);
     virtual ~MergeDocIDRemapper();
@@ -22,11 +22,10 @@ public:
     LUCENE_CLASS(MergeDocIDRemapper);
 
 public:
-    Collection<int32_t> starts; // used for binary search of mapped docID
-    Collection<int32_t> newStarts; // starts, minus the deletes
-    Collection< Collection<int32_t> > docMaps; // maps docIDs in the merged set
-    int32_t minDocID; // minimum docID that needs renumbering
-    int32_t maxDocID; // 1+ the max docID that needs renumbering
+    Collection<int32_t> starts; // docID of the first document of each segment, used for binary search of mapped docID
+    Collection<int32_t> newStarts; // docID of the first document of each segment after the merge
+    Collection< Collection<int32_t> > docMaps; // maps docIDs of the merged segments, null for the others
+    int32_t maxDocID; // 1+ the max docID of the segments, the docIDs after are buffered documents
     int32_t docShift; // total # deleted docs that were compacted by this merge
 
 public:
@@ -90,6 +90,7 @@ public:
     int32_t maxNumSegmentsOptimize; // used by IndexWriter
     Collection<SegmentReaderPtr> readers; // used by IndexWriter
     Collection<SegmentReaderPtr> readersClone; // used by IndexWriter
+    RateLimiterPtr rateLimiter; // used by ConcurrentMergeScheduler
 
     SegmentInfosPtr segments;
     bool useCompoundFile;
@@ -69,6 +69,11 @@ protected:
     /// @param level the level skip data shall be writing for
     /// @param skipBuffer the skip buffer to write to
     virtual void writeSkipData(int32_t level, const IndexOutputPtr& skipBuffer) = 0;
+
+    /// Called before the skip levels are written if there is any skip data, subclasses may write
+    /// data that applies to the whole skip list here.
+    /// @param output the IndexOutput the skip lists are written to
+    virtual void writeSkipHeader(const IndexOutputPtr& output);
 };
 
 }
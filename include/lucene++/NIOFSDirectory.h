@@ -0,0 +1,42 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef NIOFSDIRECTORY_H
+#define NIOFSDIRECTORY_H
+
+#include "FSDirectory.h"
+
+namespace Lucene {
+
+/// An {@link FSDirectory} implementation that uses positional reads (pread on POSIX systems) when reading from
+/// files, which allows multiple threads to read from the same file without synchronizing.
+///
+/// Clones of an input opened by this directory share the same file handle but never share a file position or a
+/// lock, unlike {@link SimpleFSDirectory}, whose inputs serialize all reads of a file on a single stream.  The
+/// handle stays open until the input is closed and its clones are released.  Writing uses {@link SimpleFSIndexOutput}.
+class LPPAPI NIOFSDirectory : public FSDirectory {
+public:
+    /// Create a new NIOFSDirectory for the named location.
+    /// @param path the path of the directory.
+    /// @param lockFactory the lock factory to use, or null for the default ({@link NativeFSLockFactory})
+    NIOFSDirectory(const String& path, const LockFactoryPtr& lockFactory = LockFactoryPtr());
+    virtual ~NIOFSDirectory();
+
+    LUCENE_CLASS(NIOFSDirectory);
+
+public:
+    using FSDirectory::openInput;
+
+    /// Creates an IndexInput for the file with the given name.
+    virtual IndexInputPtr openInput(const String& name, int32_t bufferSize);
+
+    /// Creates an IndexOutput for the file with the given name.
+    virtual IndexOutputPtr createOutput(const String& name);
+};
+
+}
+
+#endif
@@ -0,0 +1,67 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef NUMERICDOCVALUES_H
+#define NUMERICDOCVALUES_H
+
+#include "PackedInts.h"
+
+namespace Lucene {
+
+/// The per-document values of one field of a segment, as added with {@link DocValuesField}.  Values are held
+/// as offsets from the smallest value of the segment, packed with just enough bits to hold the largest offset.
+/// Documents without a value for the field read as 0.
+///
+/// @see IndexReader#getNumericDocValues
+class LPPAPI NumericDocValues : public LuceneObject {
+public:
+    enum Type {
+        /// 64-bit integer values.
+        TYPE_LONG,
+
+        /// Double values, stored in their sortable long form (see {@link NumericUtils#doubleToSortableLong}).
+        TYPE_DOUBLE
+    };
+
+public:
+    NumericDocValues(Type type, int64_t minValue, const PackedIntsPtr& values);
+    virtual ~NumericDocValues();
+
+    LUCENE_CLASS(NumericDocValues);
+
+protected:
+    /// Shares the values of another instance.
+    NumericDocValues(const NumericDocValuesPtr& other);
+
+protected:
+    Type type;
+    int64_t minValue;
+    PackedIntsPtr values;
+
+public:
+    Type getType();
+
+    /// Returns the number of documents.
+    int32_t size();
+
+    /// Returns the value of doc as a long.  Double values are truncated.
+    int64_t getLong(int32_t doc);
+
+    /// Returns the value of doc as a double.
+    double getDouble(int32_t doc);
+
+    /// Returns the value of doc as stored, the sortable long form of double values.
+    inline int64_t getRaw(int32_t doc) {
+        return (int64_t)((uint64_t)minValue + (uint64_t)values->get(doc));
+    }
+
+    /// Returns the memory used by the values.
+    int64_t sizeInBytes();
+};
+
+}
+
+#endif
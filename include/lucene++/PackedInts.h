@@ -0,0 +1,73 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef PACKEDINTS_H
+#define PACKEDINTS_H
+
+#include "LuceneObject.h"
+
+namespace Lucene {
+
+/// A fixed size array of non-negative integers, each stored with the same number of bits.  Values are packed
+/// back to back into 64-bit words and may span two words, so an array of n values with b bits per value takes
+/// (n * b + 63) / 64 words whatever b is.
+class LPPAPI PackedInts : public LuceneObject {
+public:
+    /// Create an array of size values, all zero, that can hold values up to 2^bitsPerValue - 1.
+    PackedInts(int32_t size, int32_t bitsPerValue);
+    virtual ~PackedInts();
+
+    LUCENE_CLASS(PackedInts);
+
+protected:
+    LongArray words;
+    int32_t _size;
+    int32_t bitsPerValue;
+    int64_t mask;
+
+public:
+    /// Returns the number of bits needed to store values from 0 to maxValue.
+    static int32_t bitsRequired(int64_t maxValue);
+
+    /// Returns the value at index.
+    inline int64_t get(int32_t index) {
+        if (bitsPerValue == 0) {
+            return 0;
+        }
+        int64_t bitPos = (int64_t)index * bitsPerValue;
+        int32_t word = (int32_t)(bitPos >> 6);
+        int32_t shift = (int32_t)(bitPos & 63);
+        uint64_t value = (uint64_t)words[word] >> shift;
+        if (shift + bitsPerValue > 64) {
+            value |= (uint64_t)words[word + 1] << (64 - shift);
+        }
+        return (int64_t)value & mask;
+    }
+
+    /// Sets the value at index, which must fit in {@link #getBitsPerValue()} bits.
+    void set(int32_t index, int64_t value);
+
+    /// Returns the number of values.
+    int32_t size();
+
+    int32_t getBitsPerValue();
+
+    /// Returns the memory used by the packed values.
+    int64_t sizeInBytes();
+
+    /// Write the number of bits per value and the packed words.
+    void write(const IndexOutputPtr& out);
+
+    /// Read size values written by {@link #write}.
+    static PackedIntsPtr read(const IndexInputPtr& in, int32_t size);
+
+    /// Returns the number of 64-bit words holding size values of bitsPerValue bits.
+    static int32_t numWords(int32_t size, int32_t bitsPerValue);
+};
+
+}
+
+#endif
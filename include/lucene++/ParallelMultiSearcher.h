@@ -19,11 +19,20 @@ class LPPAPI ParallelMultiSearcher : public MultiSearcher {
 public:
     /// Creates a {@link Searchable} which searches searchables.
     ParallelMultiSearcher(Collection<SearchablePtr> searchables);
+
+    /// Creates a {@link Searchable} which searches searchables using the given thread pool.
+    ParallelMultiSearcher(Collection<SearchablePtr> searchables, const ThreadPoolPtr& threadPool);
     virtual ~ParallelMultiSearcher();
 
     LUCENE_CLASS(ParallelMultiSearcher);
 
+protected:
+    ThreadPoolPtr threadPool;
+
 public:
+    /// Return the thread pool searches are executed on.
+    ThreadPoolPtr getThreadPool();
+
     /// Executes each {@link Searchable}'s docFreq() in its own thread and waits for each search to
     /// complete and merge the results back together.
     virtual int32_t docFreq(const TermPtr& term);
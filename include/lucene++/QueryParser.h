@@ -148,6 +148,7 @@ public:
     int32_t phraseSlop;
     double fuzzyMinSim;
     int32_t fuzzyPrefixLength;
+    bool fuzzyBoundEdits;
     std::locale locale;
 
     // the default date resolution
@@ -193,6 +194,16 @@ public:
     /// @param fuzzyPrefixLength The fuzzyPrefixLength to set.
     void setFuzzyPrefixLength(int32_t fuzzyPrefixLength);
 
+    /// Set to true to bound the edits of fuzzy queries by {@link FuzzyQuery#floatToEdits}.
+    ///
+    /// When set, fuzzy queries on long terms are matched by automaton rather than by scanning every term,
+    /// but no longer match terms more than {@link LevenshteinAutomata#MAXIMUM_SUPPORTED_DISTANCE} edits
+    /// away, however similar.  Default: false.
+    void setFuzzyBoundEdits(bool fuzzyBoundEdits);
+
+    /// @see #setFuzzyBoundEdits(bool)
+    bool getFuzzyBoundEdits();
+
     /// Sets the default slop for phrases.  If zero, then exact phrase matches are required.
     /// Default value is zero.
     void setPhraseSlop(int32_t phraseSlop);
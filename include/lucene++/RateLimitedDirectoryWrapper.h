@@ -0,0 +1,57 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef RATELIMITEDDIRECTORYWRAPPER_H
+#define RATELIMITEDDIRECTORYWRAPPER_H
+
+#include "Directory.h"
+
+namespace Lucene {
+
+/// A Directory that passes everything through to another Directory, except that the files it creates are
+/// written no faster than the rate of a {@link RateLimiter}.  Used by {@link SegmentMerger} so that merges
+/// don't starve searches of disk bandwidth, see {@link ConcurrentMergeScheduler#setMergeMBPerSec}.
+/// Closing the wrapper does not close the wrapped directory.
+class LPPAPI RateLimitedDirectoryWrapper : public Directory {
+public:
+    RateLimitedDirectoryWrapper(const DirectoryPtr& delegate, const RateLimiterPtr& rateLimiter);
+    virtual ~RateLimitedDirectoryWrapper();
+
+    LUCENE_CLASS(RateLimitedDirectoryWrapper);
+
+protected:
+    DirectoryPtr delegate;
+    RateLimiterPtr rateLimiter;
+
+public:
+    /// Return the wrapped directory.
+    DirectoryPtr getDelegate();
+
+    RateLimiterPtr getRateLimiter();
+
+    virtual HashSet<String> listAll();
+    virtual bool fileExists(const String& name);
+    virtual uint64_t fileModified(const String& name);
+    virtual void touchFile(const String& name);
+    virtual void deleteFile(const String& name);
+    virtual int64_t fileLength(const String& name);
+
+    /// Creates a new, empty file in the wrapped directory, returning a stream that writes it at the rate of the
+    /// rate limiter.
+    virtual IndexOutputPtr createOutput(const String& name);
+
+    virtual IndexInputPtr openInput(const String& name);
+    virtual IndexInputPtr openInput(const String& name, int32_t bufferSize);
+    virtual void sync(const String& name);
+    virtual LockPtr makeLock(const String& name);
+    virtual String getLockID();
+    virtual void close();
+    virtual String toString();
+};
+
+}
+
+#endif
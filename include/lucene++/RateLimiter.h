@@ -0,0 +1,72 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef RATELIMITER_H
+#define RATELIMITER_H
+
+#include "LuceneObject.h"
+#include <atomic>
+
+namespace Lucene {
+
+/// Limits the rate at which bytes are written, by pausing the threads writing them once they get ahead of the
+/// rate, see {@link RateLimitedIndexOutput}.  A limiter may have a parent, shared by several limiters, that caps
+/// their combined rate.
+class LPPAPI RateLimiter : public LuceneObject {
+public:
+    /// @param mbPerSec the rate in MB per second, 0 for no limit.
+    RateLimiter(double mbPerSec, const RateLimiterPtr& parent = RateLimiterPtr());
+    virtual ~RateLimiter();
+
+    LUCENE_CLASS(RateLimiter);
+
+public:
+    /// Writers check whether they need to pause at most once per this many milliseconds worth of bytes.
+    static const int32_t MIN_PAUSE_CHECK_MSEC;
+
+protected:
+    double mbPerSec;
+    int64_t minPauseCheckBytes;
+    RateLimiterPtr parent;
+
+    /// The time, in microseconds, at which the bytes let through so far are paid for.
+    int64_t lastMicros;
+
+    std::atomic<int64_t> totalBytes;
+    std::atomic<int64_t> bytesThrottled;
+    std::atomic<int64_t> pausedMicros;
+
+public:
+    /// Sets the rate in MB per second, 0 for no limit.
+    void setMBPerSec(double mbPerSec);
+    double getMBPerSec();
+
+    RateLimiterPtr getParent();
+
+    /// How many bytes writers may write between calls to {@link #pause}.
+    int64_t getMinPauseCheckBytes();
+
+    /// Pauses, if necessary, so that bytes more bytes, and those let through before, don't exceed the rate of this
+    /// limiter and of its parent.  Returns the number of microseconds paused.
+    int64_t pause(int64_t bytes);
+
+    /// Number of bytes let through.
+    int64_t getTotalBytes();
+
+    /// Number of bytes let through only after pausing.
+    int64_t getBytesThrottled();
+
+    /// Total time paused, in milliseconds, including pauses for the parent's rate.
+    int64_t getPausedMillis();
+
+protected:
+    /// Pauses for the rate of this limiter only.
+    int64_t doPause(int64_t bytes);
+};
+
+}
+
+#endif
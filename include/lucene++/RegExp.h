@@ -0,0 +1,89 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef REGEXP_H
+#define REGEXP_H
+
+#include "LuceneObject.h"
+
+namespace Lucene {
+
+/// Regular expression, compiled to an {@link Automaton}.  The whole term must match, there are no anchors.
+///
+/// The syntax is:
+/// <pre>
+/// regexp     ::= unionexp
+/// unionexp   ::= concatexp '|' unionexp   (union)
+///              | concatexp
+/// concatexp  ::= repeatexp concatexp      (concatenation)
+///              | repeatexp
+/// repeatexp  ::= repeatexp '?'            (zero or one occurrence)
+///              | repeatexp '*'            (zero or more occurrences)
+///              | repeatexp '+'            (one or more occurrences)
+///              | repeatexp '{' n '}'      (n occurrences)
+///              | repeatexp '{' n ',}'     (n or more occurrences)
+///              | repeatexp '{' n ',' m '}' (n to m occurrences)
+///              | charclassexp
+/// charclassexp ::= '[' charclasses ']'    (character class)
+///              | '[^' charclasses ']'     (negated character class)
+///              | simpleexp
+/// charclasses ::= charclass charclasses
+///              | charclass
+/// charclass  ::= charexp '-' charexp      (character range)
+///              | charexp
+/// simpleexp  ::= charexp
+///              | '.'                      (any character)
+///              | '"' string '"'           (the string, without double quotes)
+///              | '()'                     (the empty string)
+///              | '(' unionexp ')'         (precedence override)
+/// charexp    ::= character                (a character other than those above)
+///              | '\' character            (the character, escaped)
+/// </pre>
+class LPPAPI RegExp : public LuceneObject {
+public:
+    /// Parse a regular expression, throwing IllegalArgumentException if it is not valid.
+    RegExp(const String& s);
+    virtual ~RegExp();
+
+    LUCENE_CLASS(RegExp);
+
+protected:
+    String originalString;
+    int32_t pos;
+    RegExpNodePtr root;
+
+public:
+    /// Returns the expression as it was parsed.
+    String getOriginalString();
+
+    /// Returns the minimal deterministic automaton accepting the strings the expression matches.
+    /// @param maxDeterminizedStates Throw IllegalArgumentException rather than build an automaton with
+    /// more states than this, before or after determinizing it, see {@link Automaton#determinize}.
+    AutomatonPtr toAutomaton(int32_t maxDeterminizedStates);
+    AutomatonPtr toAutomaton();
+
+    virtual String toString();
+
+protected:
+    bool more();
+    bool peek(const String& chars);
+    bool match(wchar_t c);
+    wchar_t next();
+    void expect(wchar_t c);
+    int32_t parseNumber();
+
+    RegExpNodePtr parseUnionExp();
+    RegExpNodePtr parseConcatExp();
+    RegExpNodePtr parseRepeatExp();
+    RegExpNodePtr parseCharClassExp();
+    void parseCharClass(Collection<int32_t> ranges);
+    RegExpNodePtr parseSimpleExp();
+    wchar_t parseCharExp();
+};
+
+}
+
+#endif
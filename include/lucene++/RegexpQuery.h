@@ -0,0 +1,60 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef REGEXPQUERY_H
+#define REGEXPQUERY_H
+
+#include "MultiTermQuery.h"
+
+namespace Lucene {
+
+/// A Query that matches documents containing terms matching a regular expression, see {@link RegExp} for
+/// the syntax.  The expression is compiled to an automaton that drives the term enumeration, which seeks
+/// past the terms that can't match rather than testing each one.  Still, an expression that can match
+/// almost any term, such as one starting with .*, needs to read much of the field.
+///
+/// This query uses the {@link MultiTermQuery#CONSTANT_SCORE_AUTO_REWRITE_DEFAULT} rewrite method.
+/// @see AutomatonTermEnum
+class LPPAPI RegexpQuery : public MultiTermQuery {
+public:
+    /// Constructs a query for terms matching the regular expression held by term, throwing
+    /// IllegalArgumentException if it is not valid or its automaton would have more than {@link
+    /// Automaton#DEFAULT_MAX_DETERMINIZED_STATES} states.
+    RegexpQuery(const TermPtr& term);
+
+    /// Constructs a query for terms matching the regular expression held by term, throwing
+    /// IllegalArgumentException if it is not valid or its automaton would have more than
+    /// maxDeterminizedStates states.
+    RegexpQuery(const TermPtr& term, int32_t maxDeterminizedStates);
+
+    virtual ~RegexpQuery();
+
+    LUCENE_CLASS(RegexpQuery);
+
+protected:
+    TermPtr term;
+    AutomatonPtr automaton;
+
+public:
+    using MultiTermQuery::toString;
+
+    /// Returns the regular expression term.
+    TermPtr getTerm();
+
+    /// Prints a user-readable version of this query.
+    virtual String toString(const String& field);
+
+    virtual LuceneObjectPtr clone(const LuceneObjectPtr& other = LuceneObjectPtr());
+    virtual int32_t hashCode();
+    virtual bool equals(const LuceneObjectPtr& other);
+
+protected:
+    virtual FilteredTermEnumPtr getEnum(const IndexReaderPtr& reader);
+};
+
+}
+
+#endif
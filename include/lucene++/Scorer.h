@@ -44,6 +44,10 @@ public:
 protected:
     SimilarityPtr similarity;
 
+public:
+    /// Number of documents scored at a time by {@link #scoreBatches}.
+    static const int32_t BATCH_SIZE;
+
 public:
     /// Returns the Similarity implementation used by this scorer.
     SimilarityPtr getSimilarity();
@@ -52,10 +56,32 @@ public:
     /// @param collector The collector to which all matching documents are passed.
     virtual void score(const CollectorPtr& collector);
 
+    /// Scores and collects all matching documents a batch at a time, through {@link #scoreBatch} and {@link
+    /// Collector#collectBatch}.  The collector may not be given this scorer, so it should only need the score
+    /// of each document.
+    /// @param collector The collector to which all matching documents are passed.
+    void scoreBatches(const CollectorPtr& collector);
+
+    /// Scores the matching documents from the current one into caller-provided buffers.  The scorer must be on
+    /// a document, reached by {@link #nextDoc()} or {@link #advance(int32_t)}.  Fills docs and scores with up to
+    /// docs.size() documents before max, and leaves the scorer on the first document it did not return.  Out of
+    /// order scorers stop at the first document they reach that is not before max.  Hook for optimization: the
+    /// default implementation calls {@link #score()} and {@link #nextDoc()} for each document.
+    /// @param docs Receives the documents.
+    /// @param scores Receives the score of each document, at least as long as docs.
+    /// @param max Do not score documents past this.
+    /// @return the number of documents scored, 0 only if the current document is not before max.
+    virtual int32_t scoreBatch(Collection<int32_t> docs, Collection<double> scores, int32_t max);
+
     /// Returns the score of the current document matching the query.  Initially invalid, until {@link
     /// #nextDoc()} or {@link #advance(int32_t)} is called the first time, or when called from within
     /// {@link Collector#collect}.
     virtual double score() = 0;
+
+    /// Called by a collector when documents scoring less than or equal to minScore can no longer make it
+    /// into its results.  Scorers that support dynamic pruning may then skip such documents without
+    /// collecting them.  Subsequent calls never decrease minScore.  The default implementation ignores it.
+    virtual void setMinCompetitiveScore(double minScore);
     
     void visitSubScorers(QueryPtr parent, BooleanClause::Occur relationship,
                          ScorerVisitor *visitor);
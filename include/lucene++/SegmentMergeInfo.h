@@ -21,6 +21,8 @@ public:
 protected:
     TermPositionsPtr postings; // use getPositions()
     Collection<int32_t> docMap; // use getDocMap()
+    ByteArray norms; // use getNorms()
+    String normsField;
 
 public:
     TermPtr term;
@@ -33,6 +35,10 @@ public:
 public:
     Collection<int32_t> getDocMap();
     TermPositionsPtr getPositions();
+
+    /// Returns the norms of the given field, as merged by {@link SegmentMerger}.  Only the norms of the last
+    /// field asked for are kept.
+    ByteArray getNorms(const String& field);
     bool next();
     void close();
 };
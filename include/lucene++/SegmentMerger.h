@@ -8,6 +8,7 @@
 #define SEGMENTMERGER_H
 
 #include "LuceneObject.h"
+#include <atomic>
 
 namespace Lucene {
 
@@ -25,10 +26,25 @@ public:
 
     LUCENE_CLASS(SegmentMerger);
 
+public:
+    /// The parts of a merge that write their own files, and so can run at the same time once the
+    /// merged field infos are known.
+    enum MergeStage {
+        STAGE_STORED_FIELDS,
+        STAGE_TERMS,
+        STAGE_NORMS,
+        STAGE_DOC_VALUES,
+        STAGE_VECTORS,
+        NUM_STAGES
+    };
+
 protected:
     DirectoryPtr directory;
     String segment;
     int32_t termIndexInterval;
+    bool useBlockPostings;
+    bool useSkipImpacts;
+    int32_t storedFieldsCompression;
 
     Collection<IndexReaderPtr> readers;
     FieldInfosPtr fieldInfos;
@@ -45,15 +61,27 @@ protected:
 
     Collection<SegmentReaderPtr> matchingSegmentReaders;
     Collection<int32_t> rawDocLengths;
-    Collection<int32_t> rawDocLengths2;
+    Collection<int32_t> rawTvdLengths;
+    Collection<int32_t> rawTvfLengths;
 
     SegmentMergeQueuePtr queue;
     bool omitTermFreqAndPositions;
+    bool omitNorms; // of the field whose terms are being merged, or when no impacts are written
+
+    /// Whether any of the merged documents has doc values
+    bool hasDocValues;
 
     ByteArray payloadBuffer;
     Collection< Collection<int32_t> > docMaps;
     Collection<int32_t> delCounts;
 
+    /// Runs the stages of a merge concurrently, or null to run them one after another
+    ThreadPoolPtr threadPool;
+
+    std::atomic<int64_t> stageWork[NUM_STAGES];
+    std::atomic<int64_t> stageTime[NUM_STAGES];
+    LuceneException stageErrors[NUM_STAGES];
+
 public:
     /// norms header placeholder
     static const uint8_t NORMS_HEADER[];
@@ -82,6 +110,24 @@ public:
     void closeReaders();
 
     HashSet<String> getMergedFiles();
+
+    /// Set the thread pool the stages of a merge run on, by default {@link ThreadPool#getInstance}.
+    /// Null runs them one after another on the merging thread.
+    void setThreadPool(const ThreadPoolPtr& threadPool);
+    ThreadPoolPtr getThreadPool();
+
+    /// Returns the units of work done so far by a stage of the merge, the same units passed to
+    /// {@link CheckAbort#work} rounded up.  May be called while merging to report progress.
+    int64_t getStageWork(MergeStage stage);
+
+    /// Returns the time in milliseconds a finished stage of the merge took, or 0.
+    int64_t getStageTime(MergeStage stage);
+
+    /// Returns the name of a stage, for logging.
+    static String getStageName(MergeStage stage);
+
+    /// Run a single stage of the merge, called on the thread pool.
+    void mergeStage(MergeStage stage);
     HashSet<String> createCompoundFile(const String& fileName);
 
     /// @return The number of documents in all of the readers
@@ -96,6 +142,20 @@ protected:
                     bool omitTFAndPositions);
 
     void setMatchingSegmentReaders();
+
+    /// Merge the field infos of the readers and write them to the new segment.
+    void mergeFieldInfos();
+
+    /// Merge the stored fields of the readers, when merging doc stores.
+    /// @return The number of documents in all of the readers
+    int32_t mergeStoredFields();
+
+    /// Record units of work done by a stage, checking whether the merge has been aborted.
+    void work(MergeStage stage, double units);
+
+    /// Run a stage on the thread pool, keeping any exception in stageErrors.
+    /// @return 0, or -1 if the stage failed
+    int32_t runStage(int32_t stage);
     int32_t copyFieldsWithDeletions(const FieldsWriterPtr& fieldsWriter, const IndexReaderPtr& reader, const FieldsReaderPtr& matchingFieldsReader);
     int32_t copyFieldsNoDeletions(const FieldsWriterPtr& fieldsWriter, const IndexReaderPtr& reader, const FieldsReaderPtr& matchingFieldsReader);
 
@@ -117,6 +177,9 @@ protected:
     int32_t appendPostings(const FormatPostingsTermsConsumerPtr& termsConsumer, Collection<SegmentMergeInfoPtr> smis, int32_t n);
 
     void mergeNorms();
+
+    /// Merge the doc values of the fields that have values in any of the segments.
+    void mergeDocValues();
 };
 
 class CheckAbort : public LuceneObject {
@@ -9,6 +9,7 @@
 
 #include "IndexReader.h"
 #include "CloseableThreadLocal.h"
+#include <atomic>
 
 namespace Lucene {
 
@@ -39,6 +40,10 @@ INTERNAL:
     FieldsReaderPtr getFieldsReader();
     MapStringNorm _norms;
 
+    /// Returns the deleted docs, or null if there are none.  The vector returned is never changed afterwards,
+    /// later deletions are made to a copy, so it can be read without holding this reader's lock.
+    BitVectorPtr getDeletedDocsSnapshot();
+
 private:
     SegmentInfoPtr si;
     int32_t readBufferSize;
@@ -46,6 +51,9 @@ private:
     bool normsDirty;
     int32_t pendingDeleteCount;
 
+    /// The deleted docs last handed out by {@link #getDeletedDocsSnapshot}, to be copied before being changed.
+    std::atomic<BitVector*> sharedDeletedDocs;
+
     bool rollbackHasChanges;
     bool rollbackDeletedDocsDirty;
     bool rollbackNormsDirty;
@@ -122,6 +130,16 @@ public:
     /// Read norms into a pre-allocated array.
     virtual void norms(const String& field, ByteArray norms, int32_t offset);
 
+    /// Returns the per-document values of the named field, loaded on first use and shared by clones.
+    virtual NumericDocValuesPtr getNumericDocValues(const String& field);
+
+    /// Returns the largest byte-encoded normalization factor of the named field, or -1 if the field has no norms.
+    int32_t maxNorm(const String& field);
+
+    /// Returns true if norms of the named field were set after the segment was written, so they may exceed the
+    /// norms stored with the term freqs in the skip data.
+    bool normsChanged(const String& field);
+
     bool termsIndexLoaded();
 
     /// NOTE: only called from IndexWriter when a near real-time reader is opened, or applyDeletes is run, sharing a
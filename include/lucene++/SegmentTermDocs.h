@@ -43,6 +43,20 @@ protected:
     bool currentFieldStoresPayloads;
     bool currentFieldOmitTermFreqAndPositions;
 
+    /// Docs and freqs of the current block, used when the segment's postings are block encoded
+    int32_t postingsBlockSize;
+    int32_t blockDocs; // number of docs of the current term held in full blocks
+    IntArray docBuffer;
+    IntArray freqBuffer;
+
+    /// Competitive (freq, norm) pairs are stored in the skip data, see {@link TermInfosWriter#FORMAT_SKIP_IMPACTS}
+    bool skipImpacts;
+    int32_t termMaxFreq; // max freq of the current term, 0 until computed
+    Collection<int32_t> termImpacts; // impacts of the current term, empty until computed
+    String currentField;
+    int32_t changedMaxNorm; // max norm of the field if its norms changed since the segment was written, -1 if not, -2 until checked
+    Collection<int32_t> changedImpacts;
+
 public:
     /// Sets this to the data for a term.
     virtual void seek(const TermPtr& term);
@@ -69,13 +83,49 @@ public:
     /// Optimized implementation.
     virtual bool skipTo(int32_t target);
 
+    /// Returns the max term freq over all docs of the current term, including deleted docs, or -1 if the
+    /// segment doesn't store it.
+    int32_t getMaxFreq();
+
+    /// Moves the skip data, but not the docs, to the interval holding target and returns the last doc of that
+    /// interval, or INT_MAX if the interval extends to the end of the postings.  Together with {@link
+    /// #getBlockImpacts()} this bounds the scores of upcoming docs without decoding them.  Targets must not
+    /// decrease and an enum used for this shouldn't also be used to iterate docs.
+    int32_t advanceShallow(int32_t target);
+
+    /// Returns the competitive (freq, norm) pairs of the docs of the interval found by the last call of {@link
+    /// #advanceShallow(int)} as freq0, norm0, freq1, norm1, ... with the largest freq last: each doc has a freq
+    /// and a byte-encoded norm that are at most those of one of the pairs.  Norms are 0 if the field omits
+    /// them.  Empty if the segment doesn't store them.
+    Collection<int32_t> getBlockImpacts();
+
+    /// Returns the max term freq of the docs of the interval found by the last call of {@link #advanceShallow(int)},
+    /// or -1 if the segment doesn't store it.
+    int32_t getBlockMaxFreq();
+
     /// Used for testing
     virtual IndexInputPtr freqStream();
     virtual void freqStream(const IndexInputPtr& freqStream);
 
 protected:
     virtual void skippingDoc();
-    virtual int32_t readNoTf(Collection<int32_t>& docs, Collection<int32_t>& freqs, int32_t length);
+    virtual int32_t readNoTf(Collection<int32_t>& docs, Collection<int32_t>& freqs, int32_t start, int32_t length);
+
+    /// Create and position the skip list reader for the current term.
+    void initSkipping();
+
+    /// Returns the impacts of all docs of the current term, empty if the segment doesn't store them.
+    Collection<int32_t> getTermImpacts();
+
+    /// Returns impacts read from the skip data, or a pair of their largest freq and the field's largest norm
+    /// if norms were set since they were written.
+    Collection<int32_t> resolveImpacts(Collection<int32_t> impacts);
+
+    /// Decode the next block of docs and freqs.
+    void readBlock();
+
+    /// Bulk copy decoded docs and freqs until the buffers are full or the blocks of this term are exhausted.
+    int32_t readBlocks(Collection<int32_t>& docs, Collection<int32_t>& freqs, int32_t length);
 
     /// Overridden by SegmentTermPositions to skip in prox stream.
     virtual void skipProx(int64_t proxPointer, int32_t payloadLength);
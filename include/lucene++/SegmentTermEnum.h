@@ -40,18 +40,26 @@ public:
     int32_t indexInterval;
     int32_t skipInterval;
     int32_t maxSkipLevels;
+    int32_t postingsBlockSize;
+    bool skipImpacts;
 
 public:
     virtual LuceneObjectPtr clone(const LuceneObjectPtr& other = LuceneObjectPtr());
 
     void seek(int64_t pointer, int64_t p, const TermPtr& t, const TermInfoPtr& ti);
 
+    /// Seek with the term given by its field and UTF-8 encoded text.
+    void seek(int64_t pointer, int64_t p, const String& field, const uint8_t* bytes, int32_t length, const TermInfoPtr& ti);
+
     /// Increments the enumeration to the next element.  True if one exists.
     virtual bool next();
 
     /// Optimized scan, without allocating new terms. Return number of invocations to next().
     int32_t scanTo(const TermPtr& term);
 
+    /// Scan to a term already held in a buffer, without encoding it.
+    int32_t scanTo(const TermBufferPtr& target);
+
     /// Returns the current Term in the enumeration.
     /// Initially invalid, valid after next() called for the first time.
     virtual TermPtr term();
@@ -59,6 +67,12 @@ public:
     /// Returns the previous Term enumerated. Initially null.
     TermPtr prev();
 
+    /// Returns the buffer holding the current term, so that it can be compared without creating a Term.
+    TermBufferPtr getTermBuffer();
+
+    /// Returns the buffer holding the previous term.
+    TermBufferPtr getPrevBuffer();
+
     /// Returns the current TermInfo in the enumeration.
     /// Initially invalid, valid after next() called for the first time.
     TermInfoPtr termInfo();
@@ -15,7 +15,7 @@ class SegmentWriteState : public LuceneObject {
 public:
     SegmentWriteState(const DocumentsWriterPtr& docWriter, const DirectoryPtr& directory, const String& segmentName,
                       const String& docStoreSegmentName, int32_t numDocs, int32_t numDocsInStore,
-                      int32_t termIndexInterval);
+                      int32_t termIndexInterval, bool blockPostings, bool skipImpacts);
     virtual ~SegmentWriteState();
 
     LUCENE_CLASS(SegmentWriteState);
@@ -27,6 +27,8 @@ public:
     String docStoreSegmentName;
     int32_t numDocs;
     int32_t termIndexInterval;
+    bool blockPostings;
+    bool skipImpacts;
     int32_t numDocsInStore;
     HashSet<String> flushedFiles;
 
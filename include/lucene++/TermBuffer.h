@@ -11,7 +11,11 @@
 
 namespace Lucene {
 
-class TermBuffer : public LuceneObject {
+/// Holds a term while the terms dictionary is enumerated.  The term text is kept as UTF-8 bytes, which is
+/// how it is stored in the index, so terms are read and compared without decoding them.  Comparing UTF-8
+/// bytes orders terms by code point, which is the order of {@link Term#compareTo} where wchar_t holds
+/// UTF-32 code units.
+class LPPAPI TermBuffer : public LuceneObject {
 public:
     TermBuffer();
     virtual ~TermBuffer();
@@ -23,12 +27,19 @@ protected:
     TermPtr term; // cached
     bool preUTF8Strings; // true if strings are stored in modified UTF8 encoding
 
-    UnicodeResultPtr text;
     UTF8ResultPtr bytes;
+    UnicodeResultPtr text; // only used to read terms stored in modified UTF8 encoding
 
 public:
     virtual int32_t compareTo(const LuceneObjectPtr& other);
 
+    /// Compares this term with a term given by its field and UTF-8 encoded text.
+    int32_t compareTo(const String& otherField, const uint8_t* otherBytes, int32_t otherLength);
+
+    /// Compares two UTF-8 encoded strings byte by byte, in the order of String::compare on their text:
+    /// code point order, or UTF-16 order where wchar_t is 2 bytes.
+    static int32_t compareBytes(const uint8_t* bytes1, int32_t len1, const uint8_t* bytes2, int32_t len2);
+
     /// Call this if the IndexInput passed to {@link #read} stores terms in the "modified UTF8" format.
     void setPreUTF8Strings();
 
@@ -36,14 +47,22 @@ public:
 
     void set(const TermPtr& term);
     void set(const TermBufferPtr& other);
+    void set(const String& field, const uint8_t* bytes, int32_t length);
     void reset();
 
+    /// Returns true if no term is held, as after {@link #reset}.
+    bool empty();
+
+    const String& getField();
+
+    /// Returns the UTF-8 encoded term text, valid until the buffer is changed.
+    const uint8_t* getBytes();
+    int32_t getLength();
+
+    /// Returns the held term, decoding its text on first access.
     TermPtr toTerm();
 
     virtual LuceneObjectPtr clone(const LuceneObjectPtr& other = LuceneObjectPtr());
-
-protected:
-    int32_t compareChars(wchar_t* chars1, int32_t len1, wchar_t* chars2, int32_t len2);
 };
 
 }
@@ -29,9 +29,7 @@ protected:
     SegmentTermEnumPtr origEnum;
     int64_t _size;
 
-    Collection<TermPtr> indexTerms;
-    Collection<TermInfoPtr> indexInfos;
-    Collection<int64_t> indexPointers;
+    TermsIndexPtr index;
 
     int32_t totalIndexInterval;
 
@@ -40,6 +38,13 @@ protected:
 public:
     int32_t getSkipInterval();
     int32_t getMaxSkipLevels();
+
+    /// Returns the number of docs per bit packed postings block, or 0 if the segment's postings are
+    /// not block encoded.
+    int32_t getPostingsBlockSize();
+
+    /// Returns true if the skip data of the segment's postings holds term freqs and norms.
+    bool hasSkipImpacts();
     void close();
 
     /// Returns the number of term/value pairs in the set.
@@ -61,9 +66,12 @@ protected:
     TermInfosReaderThreadResourcesPtr getThreadResources();
 
     /// Returns the offset of the greatest index entry which is less than or equal to term.
-    int32_t getIndexOffset(const TermPtr& term);
+    int32_t getIndexOffset(const TermBufferPtr& term);
+
+    /// Compares term with the index entry at indexOffset.
+    int32_t compareIndexTerm(const TermBufferPtr& term, int32_t indexOffset);
 
-    void seekEnum(const SegmentTermEnumPtr& enumerator, int32_t indexOffset);
+    void seekEnum(const TermInfosReaderThreadResourcesPtr& resources, int32_t indexOffset);
 
     /// Returns the TermInfo for a Term in the set, or null.
     TermInfoPtr get(const TermPtr& term, bool useCache);
@@ -82,6 +90,13 @@ public:
 
     // Used for caching the least recently looked-up Terms
     TermInfoCachePtr termInfoCache;
+
+    // Holds the UTF-8 encoded term being looked up
+    TermBufferPtr lookupBuffer;
+
+    // Used to decode terms index entries
+    UTF8ResultPtr indexText;
+    TermInfoPtr indexInfo;
 };
 
 }
@@ -13,10 +13,10 @@ namespace Lucene {
 
 /// This stores a monotonically increasing set of <Term, TermInfo> pairs in a Directory.  A TermInfos
 /// can be written once, in order.
-class TermInfosWriter : public LuceneObject {
+class LPPAPI TermInfosWriter : public LuceneObject {
 public:
-    TermInfosWriter(const DirectoryPtr& directory, const String& segment, const FieldInfosPtr& fis, int32_t interval);
-    TermInfosWriter(const DirectoryPtr& directory, const String& segment, const FieldInfosPtr& fis, int32_t interval, bool isIndex);
+    TermInfosWriter(const DirectoryPtr& directory, const String& segment, const FieldInfosPtr& fis, int32_t interval, int32_t postingsBlockSize = 0, bool skipImpacts = false);
+    TermInfosWriter(const DirectoryPtr& directory, const String& segment, const FieldInfosPtr& fis, int32_t interval, int32_t postingsBlockSize, bool skipImpacts, bool isIndex);
     virtual ~TermInfosWriter();
 
     LUCENE_CLASS(TermInfosWriter);
@@ -28,6 +28,14 @@ public:
     /// Changed strings to true utf8 with length-in-bytes not length-in-chars.
     static const int32_t FORMAT_VERSION_UTF8_LENGTH_IN_BYTES;
 
+    /// Added the postings block size, non-zero when doc deltas and freqs are stored in bit packed blocks.
+    static const int32_t FORMAT_BLOCK_POSTINGS;
+
+    /// Added the competitive (term freq, norm) pairs of every skip interval and of the whole term to the skip data.
+    static const int32_t FORMAT_SKIP_IMPACTS;
+
+    /// The newest format that can be read.  Segments are written in the oldest format holding the postings
+    /// features they use, so that those without block postings or impacts stay readable by older versions.
     /// NOTE: always change this if you switch to a new format.
     static const int32_t FORMAT_CURRENT;
 
@@ -46,6 +54,13 @@ public:
     /// in big posting lists.
     int32_t maxSkipLevels;
 
+    /// The number of docs per bit packed postings block, or 0 if postings are written one variable length
+    /// integer at a time.  Block encoded postings place a skip point at every block boundary.
+    int32_t postingsBlockSize;
+
+    /// Whether the skip data holds the competitive (term freq, norm) pairs, see {@link #FORMAT_SKIP_IMPACTS}.
+    bool skipImpacts;
+
 protected:
     FieldInfosPtr fieldInfos;
     IndexOutputPtr output;
@@ -71,6 +86,9 @@ public:
 
     void add(const TermPtr& term, const TermInfoPtr& ti);
 
+    /// Returns the format version written, the oldest one supporting the postings block size and skip impacts.
+    int32_t getFormat();
+
     /// Adds a new <<fieldNumber, termBytes>, TermInfo> pair to the set.  Term must be lexicographically
     /// greater than all previous Terms added. TermInfo pointers must be positive and greater than all previous.
     void add(int32_t fieldNumber, ByteArray termBytes, int32_t termBytesLength, const TermInfoPtr& ti);
@@ -79,7 +97,7 @@ public:
     void close();
 
 protected:
-    void initialize(const DirectoryPtr& directory, const String& segment, const FieldInfosPtr& fis, int32_t interval, bool isi);
+    void initialize(const DirectoryPtr& directory, const String& segment, const FieldInfosPtr& fis, int32_t interval, int32_t postingsBlockSize, bool skipImpacts, bool isi);
 
     /// Currently used only by assert statements
     bool initUnicodeResults();
@@ -59,6 +59,14 @@ public:
 
     virtual double score();
 
+    /// Scores the buffered postings in one loop, refilling the buffers as they run out.
+    virtual int32_t scoreBatch(Collection<int32_t> docs, Collection<double> scores, int32_t max);
+
+    /// Returns an upper bound of the score of docs with a term freq of at most maxFreq and a byte-encoded
+    /// norm of at most maxNorm, computed exactly as {@link #score()} would compute it.  Relies on {@link
+    /// Similarity#tf(int32_t)} not decreasing as the freq grows.
+    double getMaxScore(int32_t maxFreq, int32_t maxNorm);
+
     /// Advances to the first match beyond the current whose document number is greater than or equal to a
     /// given target.  The implementation uses {@link TermDocs#skipTo(int32_t)}.
     /// @param target The target document number.
@@ -0,0 +1,82 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef TERMSINDEX_H
+#define TERMSINDEX_H
+
+#include "LuceneObject.h"
+
+namespace Lucene {
+
+/// The in-memory terms index of a segment, loaded from the .tii file.  Entries are front-coded in blocks of
+/// {@link #BLOCK_SIZE}: every entry holds the length of the prefix shared with the previous entry, the
+/// remaining UTF-8 bytes, its doc freq, skip offset and the pointers into the .frq, .prx and .tis files,
+/// all VInt encoded and delta coded within the block.  The first entry of a block is stored in full, so
+/// blocks are binary searched without decoding, then scanned.  A block never spans two fields.
+///
+/// The whole index is a single byte array plus a few int arrays, it is immutable once loaded and is shared
+/// by all threads searching the segment.
+class TermsIndex : public LuceneObject {
+public:
+    /// Loads every indexDivisor-th entry of indexEnum.
+    TermsIndex(const SegmentTermEnumPtr& indexEnum, int32_t indexDivisor);
+    virtual ~TermsIndex();
+
+    LUCENE_CLASS(TermsIndex);
+
+public:
+    /// Number of entries between two fully stored ones.
+    static const int32_t BLOCK_SIZE;
+
+protected:
+    ByteArray bytes;
+    int32_t numEntries;
+
+    /// Offset of the first entry of every block in bytes.
+    Collection<int32_t> blockOffsets;
+
+    /// First entry of every block, followed by numEntries.
+    Collection<int32_t> blockEntries;
+
+    /// Sorted names of the fields, the blocks of field i are fieldBlocks[i] to fieldBlocks[i + 1].
+    Collection<String> fieldNames;
+    Collection<int32_t> fieldBlocks;
+
+public:
+    /// Returns the number of entries.
+    int32_t size();
+
+    /// Returns the offset of the greatest entry which is less than or equal to the given term, or -1 if
+    /// there is none.  The term may be a prefix: the first term starting with it is then at or after the
+    /// returned entry.
+    int32_t getIndexOffset(const String& field, const uint8_t* text, int32_t length);
+
+    /// Compares the given term with the entry at indexOffset.
+    int32_t compareTo(const String& field, const uint8_t* text, int32_t length, int32_t indexOffset);
+
+    /// Decodes the entry at indexOffset.
+    /// @return the pointer into the .tis file of the entry.
+    int64_t getEntry(int32_t indexOffset, const UTF8ResultPtr& text, const TermInfoPtr& termInfo);
+
+    /// Returns the field of the entry at indexOffset.
+    const String& getField(int32_t indexOffset);
+
+    /// Returns the number of bytes used by the entries.
+    int64_t sizeInBytes();
+
+protected:
+    int32_t getBlock(int32_t indexOffset);
+    int32_t getFieldOfBlock(int32_t block);
+
+    /// Compares the given text with the entries of a block up to and including entry last of the block, or
+    /// until an entry is greater.  Returns the number of entries that are less than or equal to text and
+    /// sets cmp to how the last visited entry compares with text.
+    int32_t scanBlock(int32_t block, const uint8_t* text, int32_t length, int32_t last, int32_t& cmp);
+};
+
+}
+
+#endif
@@ -7,26 +7,40 @@
 #ifndef THREADPOOL_H
 #define THREADPOOL_H
 
-#include <boost/asio.hpp>
+#include <atomic>
+#include <deque>
+#include <exception>
 #include <boost/any.hpp>
+#include <boost/version.hpp>
+#if BOOST_VERSION >= 107300  // Boost 1.73.0+
+#include <boost/bind/bind.hpp>
+#else
+#include <boost/bind.hpp>
+#endif
+#include <boost/function.hpp>
+#include <boost/scoped_array.hpp>
 #include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include "LuceneObject.h"
 
 namespace Lucene {
 
-
-typedef boost::asio::io_context io_context_t;
-typedef boost::asio::executor_work_guard<io_context_t::executor_type> work_t;
-
 /// A Future represents the result of an asynchronous computation. Methods are provided to check if the computation
 /// is complete, to wait for its completion, and to retrieve the result of the computation. The result can only be
 /// retrieved using method get when the computation has completed, blocking if necessary until it is ready.
-class Future : public LuceneObject {
+///
+/// If the computation throws, get rethrows its exception.
+///
+/// If get is called from one of a {@link ThreadPool}'s own worker threads, the worker keeps executing queued tasks
+/// while it waits, so tasks may safely wait on sub-tasks scheduled on the same pool.
+class LPPAPI Future : public LuceneObject {
 public:
     virtual ~Future();
 
 protected:
     boost::any value;
+    std::exception_ptr exception;
 
 public:
     void set(const boost::any& value) {
@@ -34,51 +48,132 @@ public:
         this->value = value;
     }
 
-    template <typename TYPE>
-    TYPE get() {
+    /// Complete the computation with the exception it threw, to be rethrown by get.
+    void setException(const std::exception_ptr& exception) {
         SyncLock syncLock(this);
-        while (value.empty()) {
-            wait(10);
-        }
-        return value.empty() ? TYPE() : boost::any_cast<TYPE>(value);
+        this->exception = exception;
+    }
+
+    /// Returns true if the computation has completed, either with a result or an exception.
+    bool isDone() {
+        SyncLock syncLock(this);
+        return !value.empty() || exception;
     }
+
+    template <typename TYPE>
+    TYPE get();
 };
 
 /// Utility class to handle a pool of threads.
-class ThreadPool : public LuceneObject {
+///
+/// Each worker thread owns a double-ended task queue.  Tasks scheduled from outside the pool are distributed
+/// round-robin across the workers, tasks scheduled by a worker go to its own queue.  A worker takes its newest
+/// task first and, when its own queue is empty, steals the oldest task of another worker.
+class LPPAPI ThreadPool : public LuceneObject {
 public:
-    ThreadPool();
+    /// Creates a thread pool with the given number of worker threads.
+    /// @param threadCount number of worker threads, or 0 to use {@link #getDefaultThreadCount}.
+    ThreadPool(int32_t threadCount = 0);
     virtual ~ThreadPool();
 
     LUCENE_CLASS(ThreadPool);
 
+public:
+    typedef boost::function<void()> task_t;
+
 protected:
-    io_context_t io_context;
-    work_t work;
+    /// Task queue owned by a single worker thread.
+    struct WorkerQueue {
+        boost::mutex queueMutex;
+        std::deque<task_t> tasks;
+    };
+
+    int32_t threadCount;
+    boost::scoped_array<WorkerQueue> queues;
     boost::thread_group threadGroup;
+    Collection<boost::thread*> threads; // indexed by worker, owned by threadGroup
 
-    static const int32_t THREADPOOL_SIZE;
+    boost::mutex idleMutex;
+    boost::condition_variable workAvailable;
+    std::atomic<bool> shutdown;
+
+    std::atomic<uint32_t> nextQueue;
+    std::atomic<int64_t> pendingTasks;
+    std::atomic<int64_t> completedTasks;
+    std::atomic<int64_t> stolenTasks;
 
 public:
-    /// Get singleton thread pool instance.
+    /// Get singleton thread pool instance, sized with {@link #getDefaultThreadCount}.
     static ThreadPoolPtr getInstance();
 
+    /// Return the number of hardware threads available, or 1 if this cannot be determined.
+    static int32_t getDefaultThreadCount();
+
+    /// Return the number of worker threads in this pool.
+    int32_t getThreadCount();
+
+    /// Return the number of tasks queued but not yet started.
+    int64_t getQueueDepth();
+
+    /// Return the number of tasks that have finished executing.
+    int64_t getCompletedTaskCount();
+
+    /// Return the number of tasks that were stolen from another worker's queue.
+    int64_t getStealCount();
+
     template <typename FUNC>
     FuturePtr scheduleTask(FUNC func) {
         FuturePtr future(newInstance<Future>());
-        boost::asio::post(io_context, boost::bind(&ThreadPool::execute<FUNC>, this, func, future));
+        submit(boost::bind(&ThreadPool::execute<FUNC>, this, func, future));
         return future;
     }
 
+    /// If the calling thread is a worker of a thread pool, execute one queued task of that pool.
+    /// @return true if a task was executed.
+    static bool helpCurrentWorker();
+
 protected:
+    /// Queue a task for execution by one of the worker threads.
+    void submit(const task_t& task);
+
+    /// Take the next task for the given worker, stealing from other workers if necessary.
+    bool takeTask(int32_t worker, task_t& task);
+
+    /// Execute a single task, protecting the worker thread from exceptions.
+    void runTask(const task_t& task);
+
+    /// Body of each worker thread.
+    void workerLoop(int32_t worker);
+
     // this will be executed when one of the threads is available
     template <typename FUNC>
     void execute(FUNC func, const FuturePtr& future) {
-        future->set(func());
+        try {
+            future->set(func());
+        } catch (...) {
+            future->setException(std::current_exception());
+        }
         future->notifyAll();
     }
 };
 
+template <typename TYPE>
+TYPE Future::get() {
+    while (!isDone()) {
+        if (!ThreadPool::helpCurrentWorker()) {
+            SyncLock syncLock(this);
+            if (value.empty() && !exception) {
+                wait(10);
+            }
+        }
+    }
+    SyncLock syncLock(this);
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+    return value.empty() ? TYPE() : boost::any_cast<TYPE>(value);
+}
+
 }
 
 #endif
@@ -0,0 +1,162 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef TIEREDMERGEPOLICY_H
+#define TIEREDMERGEPOLICY_H
+
+#include "MergePolicy.h"
+
+namespace Lucene {
+
+/// Merges segments of approximately equal size, subject to an allowed number of segments per tier.  This is
+/// similar to {@link LogByteSizeMergePolicy}, except this merge policy is able to merge non-adjacent segments,
+/// and separates how many segments are merged at once ({@link #setMaxMergeAtOnce}) from how many segments are
+/// allowed per tier ({@link #setSegmentsPerTier}).  This merge policy also does not over-merge (ie, cascade
+/// merges).
+///
+/// For normal merging, this policy first computes a "budget" of how many segments are allowed to be in the
+/// index.  If the index is over-budget, then the policy sorts segments by decreasing size (pro-rating by percent
+/// deletes), and then finds the least-cost merge.  Merge cost is measured by a combination of the "skew" of the
+/// merge (size of largest segment divided by smallest segment), total merge size and percent deletes reclaimed,
+/// so that merges with lower skew, smaller size and those reclaiming more deletes, are favored.
+///
+/// If a merge will produce a segment that's larger than {@link #setMaxMergedSegmentMB}, then the policy will
+/// merge fewer segments (down to 1 at once, if that one has deletions) to keep the segment size under budget.
+///
+/// NOTE: this policy freely merges non-adjacent segments, so the order of the documents is not preserved
+/// across merges, as it is by {@link LogMergePolicy}.
+class LPPAPI TieredMergePolicy : public MergePolicy {
+public:
+    TieredMergePolicy(const IndexWriterPtr& writer);
+    virtual ~TieredMergePolicy();
+
+    LUCENE_CLASS(TieredMergePolicy);
+
+public:
+    /// Default noCFSRatio.  If a merge's size is >= 10% of the index, then we disable compound file for it.
+    /// @see #setNoCFSRatio
+    static const double DEFAULT_NO_CFS_RATIO;
+
+protected:
+    int32_t maxMergeAtOnce;
+    int64_t maxMergedSegmentBytes;
+    int32_t maxMergeAtOnceExplicit;
+
+    int64_t floorSegmentBytes;
+    double segsPerTier;
+    double expungeDeletesPctAllowed;
+    bool _useCompoundFile;
+    bool _useCompoundDocStore;
+    double noCFSRatio;
+    double reclaimDeletesWeight;
+
+public:
+    /// Maximum number of segments to be merged at a time during "normal" merging.  For explicit merging (eg,
+    /// optimize or expungeDeletes was called), see {@link #setMaxMergeAtOnceExplicit}.  Default is 10.
+    void setMaxMergeAtOnce(int32_t maxMergeAtOnce);
+
+    /// @see #setMaxMergeAtOnce
+    int32_t getMaxMergeAtOnce();
+
+    /// Maximum number of segments to be merged at a time, during optimize or expungeDeletes.  Default is 30.
+    void setMaxMergeAtOnceExplicit(int32_t maxMergeAtOnceExplicit);
+
+    /// @see #setMaxMergeAtOnceExplicit
+    int32_t getMaxMergeAtOnceExplicit();
+
+    /// Maximum sized segment to produce during normal merging.  This setting is approximate: the estimate of the
+    /// merged segment size is made by summing sizes of to-be-merged segments (compensating for percent deleted
+    /// docs).  Default is 5 GB.
+    void setMaxMergedSegmentMB(double mb);
+
+    /// @see #setMaxMergedSegmentMB
+    double getMaxMergedSegmentMB();
+
+    /// Controls how aggressively merges that reclaim more deletions are favored.  Higher values favor selecting
+    /// merges that reclaim deletions.  A value of 0.0 means deletions don't impact merge selection.  Default
+    /// is 2.0.
+    void setReclaimDeletesWeight(double weight);
+
+    /// @see #setReclaimDeletesWeight
+    double getReclaimDeletesWeight();
+
+    /// Segments smaller than this are "rounded up" to this size, ie treated as equal (floor) size for merge
+    /// selection.  This is to prevent frequent flushing of tiny segments from allowing a long tail in the
+    /// index.  Default is 2 MB.
+    void setFloorSegmentMB(double mb);
+
+    /// @see #setFloorSegmentMB
+    double getFloorSegmentMB();
+
+    /// When expungeDeletes is called, we only merge away a segment if its delete percentage is over this
+    /// threshold.  Default is 10%.
+    void setExpungeDeletesPctAllowed(double pct);
+
+    /// @see #setExpungeDeletesPctAllowed
+    double getExpungeDeletesPctAllowed();
+
+    /// Sets the allowed number of segments per tier.  Smaller values mean more merging but fewer segments.
+    /// This should be >= {@link #setMaxMergeAtOnce} otherwise you'll force too much merging to occur.
+    /// Default is 10.0.
+    void setSegmentsPerTier(double segsPerTier);
+
+    /// @see #setSegmentsPerTier
+    double getSegmentsPerTier();
+
+    /// Sets whether compound file format should be used for newly flushed and newly merged segments.  Default
+    /// true.
+    void setUseCompoundFile(bool useCompoundFile);
+
+    /// @see #setUseCompoundFile
+    bool getUseCompoundFile();
+
+    /// Sets whether compound file format should be used for newly flushed and newly merged doc store segment
+    /// files (term vectors and stored fields).  Default true.
+    void setUseCompoundDocStore(bool useCompoundDocStore);
+
+    /// @see #setUseCompoundDocStore
+    bool getUseCompoundDocStore();
+
+    /// If a merged segment will be more than this percentage of the total size of the index, leave the segment
+    /// as non-compound file even if compound file is enabled.  Set to 1.0 to always use CFS regardless of merge
+    /// size.  Default is 0.1.
+    void setNoCFSRatio(double noCFSRatio);
+
+    /// @see #setNoCFSRatio
+    double getNoCFSRatio();
+
+    virtual MergeSpecificationPtr findMerges(const SegmentInfosPtr& segmentInfos);
+    virtual MergeSpecificationPtr findMergesForOptimize(const SegmentInfosPtr& segmentInfos, int32_t maxSegmentCount, SetSegmentInfo segmentsToOptimize);
+    virtual MergeSpecificationPtr findMergesToExpungeDeletes(const SegmentInfosPtr& segmentInfos);
+    virtual bool useCompoundFile(const SegmentInfosPtr& segments, const SegmentInfoPtr& newSegment);
+    virtual bool useCompoundDocStore(const SegmentInfosPtr& segments);
+    virtual void close();
+
+protected:
+    bool verbose();
+    void message(const String& message);
+
+    /// Size of the segment in bytes, pro-rated by its percentage of deleted documents.
+    int64_t size(const SegmentInfoPtr& info);
+
+    int64_t floorSize(int64_t bytes);
+
+    /// Sorts the segments by decreasing size.
+    Collection<SegmentInfoPtr> sortBySize(Collection<SegmentInfoPtr> infos);
+
+    /// Scores a candidate merge, lower scores are better.
+    double score(Collection<SegmentInfoPtr> candidate, bool hitTooLarge);
+
+    /// Returns true if this single info is optimized (has no pending norms or deletes, is in the same dir as
+    /// the writer, and matches the current compound file setting.
+    bool isOptimized(const SegmentInfoPtr& info);
+
+    OneMergePtr makeOneMerge(const SegmentInfosPtr& infos, Collection<SegmentInfoPtr> infosToMerge);
+};
+
+}
+
+#endif
@@ -35,6 +35,10 @@ public:
     /// Stores the maximum score value encountered, needed for normalizing.
     double maxScore;
 
+    /// True if documents that could not make it into the top hits may have been skipped without being
+    /// counted, in which case {@link #totalHits} is a lower bound of the number of hits.
+    bool totalHitsIsLowerBound;
+
 public:
     /// Returns the maximum score value encountered. Note that in case scores are not tracked,
     /// this returns NaN.
@@ -31,6 +31,9 @@ INTERNAL:
     ScorerWeakPtr _scorer;
     Scorer* __scorer;
 
+    /// Pass the score of the weakest top hit to the scorer, which may then skip uncompetitive documents
+    bool totalHitsLowerBound;
+
 public:
     /// Creates a new {@link TopScoreDocCollector} given the number of hits to collect and whether documents
     /// are scored in order by the input {@link Scorer} to {@link #setScorer(ScorerPtr)}.
@@ -38,6 +41,12 @@ public:
     /// NOTE: The instances returned by this method pre-allocate a full array of length numHits.
     static TopScoreDocCollectorPtr create(int32_t numHits, bool docsScoredInOrder);
 
+    /// Creates a new {@link TopScoreDocCollector}.  If totalHitsLowerBound is true then once numHits hits
+    /// have been collected the score a document needs to enter the top hits is passed on to {@link
+    /// Scorer#setMinCompetitiveScore(double)}, so scorers are free to skip the remaining uncompetitive
+    /// matches and the total hit count becomes a lower bound.  Only supported for docs scored in order.
+    static TopScoreDocCollectorPtr create(int32_t numHits, bool docsScoredInOrder, bool totalHitsLowerBound);
+
     virtual void setNextReader(const IndexReaderPtr& reader, int32_t docBase);
     virtual void setScorer(const ScorerPtr& scorer);
 
@@ -67,6 +67,13 @@ public:
     /// @return a {@link Scorer} which scores documents in/out-of order.
     virtual ScorerPtr scorer(const IndexReaderPtr& reader, bool scoreDocsInOrder, bool topScorer) = 0;
 
+    /// Returns an in-order top {@link Scorer} that may skip documents which can't score above the threshold
+    /// given to {@link Scorer#setMinCompetitiveScore(double)}, so collectors using it only see a subset of
+    /// the matches.  The default implementation returns a scorer that matches every document.
+    ///
+    /// NOTE: null can be returned if no documents will be scored by this query.
+    virtual ScorerPtr competitiveScorer(const IndexReaderPtr& reader);
+
     /// The sum of squared weights of contained query clauses.
     virtual double sumOfSquaredWeights() = 0;
 
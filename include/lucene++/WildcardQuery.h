@@ -12,9 +12,10 @@
 namespace Lucene {
 
 /// Implements the wildcard search query.  Supported wildcards are *, which matches any character sequence
-/// (including the empty one), and ?, which matches any single character. Note this query can be slow, as
-/// it needs to iterate over many terms.  In order to prevent extremely slow WildcardQueries, a Wildcard
-/// term should not start with one of the wildcards * or ?.
+/// (including the empty one), and ?, which matches any single character.  The pattern is compiled to an
+/// automaton that drives the term enumeration, which seeks past the terms that can't match rather than
+/// testing each one.  Still, a pattern starting with one of the wildcards * or ? needs to read much of the
+/// field, so can be slow.
 ///
 /// This query uses the {@link MultiTermQuery#CONSTANT_SCORE_AUTO_REWRITE_DEFAULT} rewrite method.
 /// @see WildcardTermEnum
@@ -36,6 +37,12 @@ public:
     /// Returns the pattern term.
     TermPtr getTerm();
 
+    /// Returns the minimal deterministic automaton accepting the terms matching the pattern of wildcardTerm,
+    /// throwing IllegalArgumentException if it would have more than {@link
+    /// Automaton#DEFAULT_MAX_DETERMINIZED_STATES} states, as a * followed by many ? can.  {@link
+    /// WildcardTermEnum} then falls back to testing the terms against the pattern.
+    static AutomatonPtr toAutomaton(const TermPtr& wildcardTerm);
+
     virtual QueryPtr rewrite(const IndexReaderPtr& reader);
 
     /// Prints a user-readable version of this query.
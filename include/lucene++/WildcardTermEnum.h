@@ -7,15 +7,20 @@
 #ifndef WILDCARDTERMENUM_H
 #define WILDCARDTERMENUM_H
 
-#include "FilteredTermEnum.h"
+#include "AutomatonTermEnum.h"
 
 namespace Lucene {
 
 /// Subclass of FilteredTermEnum for enumerating all terms that match the specified wildcard filter term.
 ///
+/// The pattern is compiled to an automaton (see {@link WildcardQuery#toAutomaton}), so that only the terms
+/// around the matches are read even when the pattern starts with a wildcard.  Patterns whose automaton
+/// would have too many states are instead matched against every term that starts with the text before
+/// the first wildcard, using {@link #wildcardEquals}.
+///
 /// Term enumerations are always ordered by Term.compareTo().  Each term in the enumeration is greater than
 /// all that precede it.
-class LPPAPI WildcardTermEnum : public FilteredTermEnum {
+class LPPAPI WildcardTermEnum : public AutomatonTermEnum {
 public:
     /// Creates a new WildcardTermEnum.
     ///
@@ -32,21 +37,18 @@ public:
     static const wchar_t WILDCARD_CHAR;
 
     TermPtr searchTerm;
-    String field;
     String text;
     String pre;
     int32_t preLen;
-    bool _endEnum;
 
 public:
-    virtual double difference();
+    virtual bool next();
 
     /// Determines if a word matches a wildcard pattern.
     static bool wildcardEquals(const String& pattern, int32_t patternIdx, const String& string, int32_t stringIdx);
 
 protected:
     virtual bool termCompare(const TermPtr& term);
-    virtual bool endEnum();
 };
 
 }
@@ -44,6 +44,11 @@ option(
     "Enable building demo applications"
     ON)
 
+option(
+    ENABLE_BENCH
+    "Enable building the lucene++-bench benchmark suite"
+    ON)
+
 OPTION(
     ENABLE_DOCS
     "Build the Lucene++ documentation."
@@ -0,0 +1,493 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "targetver.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstring>
+#include "LuceneHeaders.h"
+#include "NumericField.h"
+#include "NumericRangeQuery.h"
+#include "SpanNearQuery.h"
+#include "SpanTermQuery.h"
+#include "FuzzyQuery.h"
+#include "WildcardQuery.h"
+#include "TermRangeQuery.h"
+#include "Sort.h"
+#include "SortField.h"
+#include "TopFieldDocs.h"
+#include "FileUtils.h"
+
+using namespace Lucene;
+
+/// Benchmark settings, overridable from the command line.
+struct BenchOptions {
+    int32_t docs = 100000;
+    int32_t vocabulary = 50000;
+    double zipf = 1.0;
+    int32_t bodyLength = 100;
+    int32_t titleLength = 6;
+    int32_t queries = 200;
+    int32_t ramBufferMB = 16;
+    int32_t threads = 1;
+    uint32_t seed = 42;
+    std::string directory;
+    std::string output;
+};
+
+typedef std::chrono::steady_clock bench_clock;
+
+static double elapsedMillis(bench_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+/// Generates a reproducible synthetic corpus whose word frequencies follow a Zipf distribution.
+class SyntheticCorpus {
+public:
+    SyntheticCorpus(const BenchOptions& options) : options(options), random(options.seed) {
+        words.reserve(options.vocabulary);
+        cdf.reserve(options.vocabulary);
+        double total = 0.0;
+        for (int32_t rank = 0; rank < options.vocabulary; ++rank) {
+            words.push_back(makeWord(rank));
+            total += 1.0 / std::pow((double)(rank + 1), options.zipf);
+            cdf.push_back(total);
+        }
+        for (size_t i = 0; i < cdf.size(); ++i) {
+            cdf[i] /= total;
+        }
+    }
+
+protected:
+    BenchOptions options;
+    std::mt19937 random;
+    std::vector<String> words;
+    std::vector<double> cdf;
+
+public:
+    /// Word of the given frequency rank (0 is the most frequent word).
+    const String& word(int32_t rank) const {
+        return words[rank];
+    }
+
+    int32_t nextRank() {
+        double p = std::uniform_real_distribution<double>(0.0, 1.0)(random);
+        return (int32_t)(std::lower_bound(cdf.begin(), cdf.end(), p) - cdf.begin());
+    }
+
+    /// Rank drawn uniformly from the given range of the vocabulary.
+    int32_t nextRank(int32_t from, int32_t to) {
+        return std::uniform_int_distribution<int32_t>(from, std::max(from, std::min(to, options.vocabulary - 1)))(random);
+    }
+
+    int32_t nextInt(int32_t limit) {
+        return std::uniform_int_distribution<int32_t>(0, limit - 1)(random);
+    }
+
+    String text(int32_t length) {
+        StringStream buffer;
+        for (int32_t i = 0; i < length; ++i) {
+            if (i > 0) {
+                buffer << L" ";
+            }
+            buffer << words[nextRank()];
+        }
+        return buffer.str();
+    }
+
+    DocumentPtr document(int32_t id) {
+        DocumentPtr doc(newLucene<Document>());
+        doc->add(newLucene<Field>(L"id", StringUtils::toString(id), Field::STORE_YES, Field::INDEX_NOT_ANALYZED_NO_NORMS));
+        doc->add(newLucene<Field>(L"title", text(1 + nextInt(options.titleLength)), Field::STORE_YES, Field::INDEX_ANALYZED));
+        doc->add(newLucene<Field>(L"body", text(options.bodyLength / 2 + nextInt(options.bodyLength)), Field::STORE_NO, Field::INDEX_ANALYZED));
+        doc->add(newLucene<Field>(L"key", words[nextRank(0, options.vocabulary - 1)], Field::STORE_NO, Field::INDEX_NOT_ANALYZED_NO_NORMS));
+        doc->add(newLucene<Field>(L"rank", StringUtils::toString(nextInt(1000000)), Field::STORE_NO, Field::INDEX_NOT_ANALYZED_NO_NORMS));
+        doc->add(newLucene<NumericField>(L"num")->setIntValue(nextInt(1000000)));
+        return doc;
+    }
+
+protected:
+    /// Deterministic, pronounceable-ish token for a vocabulary rank.
+    static String makeWord(int32_t rank) {
+        static const wchar_t* letters = L"abcdefghijklmnopqrstuvwxyz";
+        String word;
+        int32_t value = rank;
+        do {
+            word += letters[value % 26];
+            value /= 26;
+        } while (value > 0);
+        return word + L"x";
+    }
+};
+
+/// Latency statistics for one query type.
+struct LatencyStats {
+    std::string name;
+    int32_t count = 0;
+    int64_t totalHits = 0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+
+    static LatencyStats compute(const std::string& name, std::vector<double> samples, int64_t totalHits) {
+        LatencyStats stats;
+        stats.name = name;
+        stats.count = (int32_t)samples.size();
+        stats.totalHits = totalHits;
+        if (samples.empty()) {
+            return stats;
+        }
+        std::sort(samples.begin(), samples.end());
+        double sum = 0.0;
+        for (size_t i = 0; i < samples.size(); ++i) {
+            sum += samples[i];
+        }
+        stats.mean = sum / (double)samples.size();
+        stats.p50 = percentile(samples, 0.50);
+        stats.p90 = percentile(samples, 0.90);
+        stats.p99 = percentile(samples, 0.99);
+        stats.max = samples.back();
+        return stats;
+    }
+
+    static double percentile(const std::vector<double>& sorted, double p) {
+        size_t index = (size_t)std::ceil(p * (double)sorted.size());
+        return sorted[std::min(sorted.size() - 1, index == 0 ? 0 : index - 1)];
+    }
+};
+
+/// Creates the queries of each benchmarked type.
+class QueryFactory {
+public:
+    QueryFactory(SyntheticCorpus& corpus, int32_t vocabulary) : corpus(corpus), vocabulary(vocabulary) {
+    }
+
+protected:
+    SyntheticCorpus& corpus;
+    int32_t vocabulary;
+
+public:
+    TermPtr bodyTerm(int32_t from, int32_t to) {
+        return newLucene<Term>(L"body", corpus.word(corpus.nextRank(from, to)));
+    }
+
+    QueryPtr termQuery() {
+        return newLucene<TermQuery>(bodyTerm(0, 1000));
+    }
+
+    QueryPtr booleanOrQuery() {
+        BooleanQueryPtr query(newLucene<BooleanQuery>());
+        int32_t clauses = 2 + corpus.nextInt(3);
+        for (int32_t i = 0; i < clauses; ++i) {
+            query->add(newLucene<TermQuery>(bodyTerm(0, 1000)), BooleanClause::SHOULD);
+        }
+        return query;
+    }
+
+    /// A disjunction of a fixed number of clauses, scored out of order by BooleanScorer.
+    QueryPtr disjunction(int32_t clauses) {
+        BooleanQueryPtr query(newLucene<BooleanQuery>());
+        for (int32_t i = 0; i < clauses; ++i) {
+            query->add(newLucene<TermQuery>(bodyTerm(0, 1000)), BooleanClause::SHOULD);
+        }
+        return query;
+    }
+
+    QueryPtr disjunction2Query() {
+        return disjunction(2);
+    }
+
+    QueryPtr disjunction5Query() {
+        return disjunction(5);
+    }
+
+    QueryPtr disjunction10Query() {
+        return disjunction(10);
+    }
+
+    QueryPtr booleanAndQuery() {
+        BooleanQueryPtr query(newLucene<BooleanQuery>());
+        query->add(newLucene<TermQuery>(bodyTerm(0, 50)), BooleanClause::MUST);
+        query->add(newLucene<TermQuery>(bodyTerm(0, 500)), BooleanClause::MUST);
+        return query;
+    }
+
+    QueryPtr phraseQuery() {
+        PhraseQueryPtr query(newLucene<PhraseQuery>());
+        query->add(bodyTerm(0, 20));
+        query->add(bodyTerm(0, 20));
+        return query;
+    }
+
+    QueryPtr spanQuery() {
+        Collection<SpanQueryPtr> clauses(newCollection<SpanQueryPtr>(newLucene<SpanTermQuery>(bodyTerm(0, 50)), newLucene<SpanTermQuery>(bodyTerm(0, 50))));
+        return newLucene<SpanNearQuery>(clauses, 5, false);
+    }
+
+    QueryPtr fuzzyQuery() {
+        return newLucene<FuzzyQuery>(bodyTerm(0, vocabulary - 1), 0.5, 1);
+    }
+
+    QueryPtr wildcardQuery() {
+        String word(corpus.word(corpus.nextRank(0, vocabulary - 1)));
+        return newLucene<WildcardQuery>(newLucene<Term>(L"body", word.substr(0, 1) + L"?" + (word.size() > 2 ? word.substr(2, 1) : L"") + L"*"));
+    }
+
+    QueryPtr rangeQuery() {
+        String lower(corpus.word(corpus.nextRank(0, vocabulary - 1)));
+        return newLucene<TermRangeQuery>(L"key", lower, lower + L"zzz", true, true);
+    }
+
+    QueryPtr numericRangeQuery() {
+        int32_t lower = corpus.nextInt(900000);
+        return NumericRangeQuery::newIntRange(L"num", lower, lower + 100000, true, true);
+    }
+};
+
+/// Indexes the docs with ids from, from + step, ... using a corpus of its own, as indexing threads can't share one.
+static void indexDocs(const IndexWriterPtr& writer, const BenchOptions& options, int32_t from, int32_t step, String& error) {
+    try {
+        BenchOptions threadOptions(options);
+        threadOptions.seed += (uint32_t)from;
+        SyntheticCorpus corpus(threadOptions);
+        for (int32_t id = from; id < options.docs; id += step) {
+            writer->addDocument(corpus.document(id));
+        }
+    } catch (LuceneException& e) {
+        error = e.getError();
+    }
+}
+
+typedef QueryPtr (QueryFactory::*QueryCreator)();
+
+static LatencyStats timeQueries(const std::string& name, const IndexSearcherPtr& searcher, QueryFactory& factory,
+                                QueryCreator creator, int32_t queries, const SortPtr& sort = SortPtr()) {
+    std::vector<QueryPtr> queryList;
+    for (int32_t i = 0; i < queries; ++i) {
+        queryList.push_back((factory.*creator)());
+    }
+    // warm up caches (and the field cache when sorting) before timing
+    for (size_t i = 0; i < std::min(queryList.size(), (size_t)10); ++i) {
+        if (sort) {
+            searcher->search(queryList[i], FilterPtr(), 10, sort);
+        } else {
+            searcher->search(queryList[i], 10);
+        }
+    }
+    std::vector<double> samples;
+    int64_t totalHits = 0;
+    for (size_t i = 0; i < queryList.size(); ++i) {
+        bench_clock::time_point start = bench_clock::now();
+        TopDocsPtr topDocs(sort ? TopDocsPtr(searcher->search(queryList[i], FilterPtr(), 10, sort)) : searcher->search(queryList[i], 10));
+        samples.push_back(elapsedMillis(start));
+        totalHits += topDocs->totalHits;
+    }
+    return LatencyStats::compute(name, samples, totalHits);
+}
+
+static double timeReaderOpen(const DirectoryPtr& directory, int32_t iterations) {
+    double total = 0.0;
+    for (int32_t i = 0; i < iterations; ++i) {
+        bench_clock::time_point start = bench_clock::now();
+        IndexReaderPtr reader(IndexReader::open(directory, true));
+        total += elapsedMillis(start);
+        reader->close();
+    }
+    return total / (double)iterations;
+}
+
+static void writeLatencies(std::ostream& out, const std::vector<LatencyStats>& latencies) {
+    out << "  \"queries\": [\n";
+    for (size_t i = 0; i < latencies.size(); ++i) {
+        const LatencyStats& stats = latencies[i];
+        out << "    {\"name\": \"" << stats.name << "\", \"count\": " << stats.count << ", \"totalHits\": " << stats.totalHits
+            << ", \"meanMs\": " << stats.mean << ", \"p50Ms\": " << stats.p50 << ", \"p90Ms\": " << stats.p90
+            << ", \"p99Ms\": " << stats.p99 << ", \"maxMs\": " << stats.max << "}" << (i + 1 < latencies.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+}
+
+static void usage() {
+    std::cout << "Usage: lucene++-bench [options]\n"
+              << "  -docs <n>          number of documents to index (default 100000)\n"
+              << "  -vocabulary <n>    number of distinct words (default 50000)\n"
+              << "  -zipf <s>          Zipf exponent of word frequencies (default 1.0)\n"
+              << "  -bodylength <n>    average words per body field (default 100)\n"
+              << "  -titlelength <n>   maximum words per title field (default 6)\n"
+              << "  -queries <n>       queries timed per query type (default 200)\n"
+              << "  -rambuffer <mb>    IndexWriter RAM buffer size (default 16)\n"
+              << "  -threads <n>       number of indexing threads (default 1)\n"
+              << "  -seed <n>          random seed (default 42)\n"
+              << "  -index <dir>       index on disk in this directory instead of in memory\n"
+              << "  -output <file>     write the JSON report to this file instead of stdout\n";
+}
+
+static bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int32_t i = 1; i < argc; ++i) {
+        std::string arg(argv[i]);
+        if (arg == "-help" || arg == "--help" || i + 1 >= argc) {
+            return false;
+        }
+        std::string value(argv[++i]);
+        if (arg == "-docs") {
+            options.docs = std::atoi(value.c_str());
+        } else if (arg == "-vocabulary") {
+            options.vocabulary = std::atoi(value.c_str());
+        } else if (arg == "-zipf") {
+            options.zipf = std::atof(value.c_str());
+        } else if (arg == "-bodylength") {
+            options.bodyLength = std::atoi(value.c_str());
+        } else if (arg == "-titlelength") {
+            options.titleLength = std::atoi(value.c_str());
+        } else if (arg == "-queries") {
+            options.queries = std::atoi(value.c_str());
+        } else if (arg == "-rambuffer") {
+            options.ramBufferMB = std::atoi(value.c_str());
+        } else if (arg == "-threads") {
+            options.threads = std::atoi(value.c_str());
+        } else if (arg == "-seed") {
+            options.seed = (uint32_t)std::atoi(value.c_str());
+        } else if (arg == "-index") {
+            options.directory = value;
+        } else if (arg == "-output") {
+            options.output = value;
+        } else {
+            return false;
+        }
+    }
+    return (options.docs > 0 && options.vocabulary > 0 && options.bodyLength > 0 && options.titleLength > 0 &&
+            options.queries > 0 && options.ramBufferMB > 0 && options.threads > 0);
+}
+
+/// Builds a synthetic index and reports indexing, merge, reader open and query latency figures as JSON.
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 1;
+    }
+
+    try {
+        DirectoryPtr directory;
+        if (options.directory.empty()) {
+            directory = newLucene<RAMDirectory>();
+        } else {
+            directory = FSDirectory::open(StringUtils::toUnicode(options.directory));
+        }
+
+        SyntheticCorpus corpus(options);
+
+        // indexing throughput
+        bench_clock::time_point start = bench_clock::now();
+        IndexWriterPtr writer(newLucene<IndexWriter>(directory, newLucene<StandardAnalyzer>(LuceneVersion::LUCENE_CURRENT), true, IndexWriter::MaxFieldLengthUNLIMITED));
+        writer->setRAMBufferSizeMB(options.ramBufferMB);
+        if (options.threads == 1) {
+            for (int32_t id = 0; id < options.docs; ++id) {
+                writer->addDocument(corpus.document(id));
+            }
+        } else {
+            std::vector<String> errors(options.threads);
+            std::vector<std::thread> indexers;
+            for (int32_t i = 0; i < options.threads; ++i) {
+                indexers.push_back(std::thread(indexDocs, writer, std::cref(options), i, options.threads, std::ref(errors[i])));
+            }
+            for (size_t i = 0; i < indexers.size(); ++i) {
+                indexers[i].join();
+            }
+            for (size_t i = 0; i < errors.size(); ++i) {
+                if (!errors[i].empty()) {
+                    boost::throw_exception(RuntimeException(errors[i]));
+                }
+            }
+        }
+        writer->commit();
+        double indexMillis = elapsedMillis(start);
+        int32_t segments;
+        {
+            IndexReaderPtr reader(IndexReader::open(directory, true));
+            segments = reader->getSequentialSubReaders().size();
+            reader->close();
+        }
+
+        double openMillis = timeReaderOpen(directory, 5);
+
+        // query latencies against the multi-segment index
+        std::vector<LatencyStats> latencies;
+        {
+            IndexSearcherPtr searcher(newLucene<IndexSearcher>(directory, true));
+            QueryFactory factory(corpus, options.vocabulary);
+            latencies.push_back(timeQueries("term", searcher, factory, &QueryFactory::termQuery, options.queries));
+            latencies.push_back(timeQueries("boolean_or", searcher, factory, &QueryFactory::booleanOrQuery, options.queries));
+            latencies.push_back(timeQueries("boolean_or_2", searcher, factory, &QueryFactory::disjunction2Query, options.queries));
+            latencies.push_back(timeQueries("boolean_or_5", searcher, factory, &QueryFactory::disjunction5Query, options.queries));
+            latencies.push_back(timeQueries("boolean_or_10", searcher, factory, &QueryFactory::disjunction10Query, options.queries));
+            latencies.push_back(timeQueries("boolean_and", searcher, factory, &QueryFactory::booleanAndQuery, options.queries));
+            latencies.push_back(timeQueries("phrase", searcher, factory, &QueryFactory::phraseQuery, options.queries));
+            latencies.push_back(timeQueries("span_near", searcher, factory, &QueryFactory::spanQuery, options.queries));
+            latencies.push_back(timeQueries("fuzzy", searcher, factory, &QueryFactory::fuzzyQuery, std::max(1, options.queries / 10)));
+            latencies.push_back(timeQueries("wildcard", searcher, factory, &QueryFactory::wildcardQuery, std::max(1, options.queries / 10)));
+            latencies.push_back(timeQueries("term_range", searcher, factory, &QueryFactory::rangeQuery, options.queries));
+            latencies.push_back(timeQueries("numeric_range", searcher, factory, &QueryFactory::numericRangeQuery, options.queries));
+            latencies.push_back(timeQueries("term_sort_int", searcher, factory, &QueryFactory::termQuery, options.queries,
+                                            newLucene<Sort>(newLucene<SortField>(L"rank", SortField::INT))));
+            latencies.push_back(timeQueries("term_sort_string", searcher, factory, &QueryFactory::termQuery, options.queries,
+                                            newLucene<Sort>(newLucene<SortField>(L"key", SortField::STRING))));
+            searcher->close();
+        }
+
+        // merge everything down to a single segment
+        start = bench_clock::now();
+        writer->optimize();
+        writer->close();
+        double mergeMillis = elapsedMillis(start);
+
+        double optimizedOpenMillis = timeReaderOpen(directory, 5);
+
+        std::ofstream file;
+        if (!options.output.empty()) {
+            file.open(options.output.c_str());
+            if (!file.is_open()) {
+                std::cerr << "Unable to open output file: " << options.output << "\n";
+                return 1;
+            }
+        }
+        std::ostream& out = options.output.empty() ? std::cout : file;
+        out << "{\n";
+        out << "  \"version\": \"" << StringUtils::toUTF8(Constants::LUCENE_VERSION) << "\",\n";
+        out << "  \"corpus\": {\"docs\": " << options.docs << ", \"vocabulary\": " << options.vocabulary << ", \"zipf\": " << options.zipf
+            << ", \"bodyLength\": " << options.bodyLength << ", \"titleLength\": " << options.titleLength << ", \"seed\": " << options.seed << "},\n";
+        out << "  \"indexing\": {\"threads\": " << options.threads << ", \"totalMs\": " << indexMillis << ", \"docsPerSec\": " << (options.docs * 1000.0 / std::max(indexMillis, 1.0))
+            << ", \"segments\": " << segments << "},\n";
+        out << "  \"readerOpen\": {\"multiSegmentMs\": " << openMillis << ", \"optimizedMs\": " << optimizedOpenMillis << "},\n";
+        writeLatencies(out, latencies);
+        out << "  \"merge\": {\"optimizeMs\": " << mergeMillis << "}\n";
+        out << "}\n";
+
+        directory->close();
+    } catch (LuceneException& e) {
+        std::cerr << "Exception: " << StringUtils::toUTF8(e.getError()) << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -19,6 +19,17 @@ namespace Lucene {
 
 const int32_t CompressionTools::COMPRESS_BUFFER = 4096;
 
+/// Parameters of the fast codec: the shortest repeated sequence replaced by a reference, the size of the hash
+/// table used to find them, and the furthest back a reference may point.
+static const int32_t FAST_MIN_MATCH = 4;
+static const int32_t FAST_HASH_BITS = 12;
+static const int32_t FAST_MAX_DISTANCE = 65535;
+
+/// No match starts in the last FAST_MATCH_LIMIT bytes and the last FAST_LAST_LITERALS bytes are always literals,
+/// as in the LZ4 block format.
+static const int32_t FAST_MATCH_LIMIT = 12;
+static const int32_t FAST_LAST_LITERALS = 5;
+
 String ZLibToMessage(int32_t error) {
     if (error == boost::iostreams::zlib::okay) {
         return L"okay";
@@ -141,4 +152,137 @@ String CompressionTools::decompressString(ByteArray value) {
     return StringUtils::toUnicode(bytes.get(), bytes.size());
 }
 
+static inline uint32_t readInt32(const uint8_t* bytes) {
+    uint32_t i;
+    std::memcpy(&i, bytes, sizeof(i));
+    return i;
+}
+
+static void writeFastLength(uint8_t* bytes, int32_t& pos, int32_t length) {
+    while (length >= 255) {
+        bytes[pos++] = 255;
+        length -= 255;
+    }
+    bytes[pos++] = (uint8_t)length;
+}
+
+/// Writes a sequence of literals followed by a match, or the final literals when matchLength is 0.
+static void writeFastSequence(uint8_t* bytes, int32_t& pos, const uint8_t* literals, int32_t literalLength, int32_t distance, int32_t matchLength) {
+    int32_t token = pos++;
+    bytes[token] = (uint8_t)(std::min(literalLength, 15) << 4);
+    if (literalLength >= 15) {
+        writeFastLength(bytes, pos, literalLength - 15);
+    }
+    if (literalLength > 0) {
+        MiscUtils::arrayCopy(literals, 0, bytes, pos, literalLength);
+        pos += literalLength;
+    }
+    if (matchLength > 0) {
+        bytes[pos++] = (uint8_t)(distance & 0xff);
+        bytes[pos++] = (uint8_t)(distance >> 8);
+        matchLength -= FAST_MIN_MATCH;
+        bytes[token] |= (uint8_t)std::min(matchLength, 15);
+        if (matchLength >= 15) {
+            writeFastLength(bytes, pos, matchLength - 15);
+        }
+    }
+}
+
+ByteArray CompressionTools::compressFast(const uint8_t* value, int32_t offset, int32_t length) {
+    const uint8_t* bytes = value + offset;
+    ByteArray buffer(ByteArray::newInstance(length + length / 255 + 16)); // worst case: no matches
+    int32_t pos = 0;
+
+    int32_t hashTable[1 << FAST_HASH_BITS];
+    std::fill(hashTable, hashTable + (1 << FAST_HASH_BITS), -1);
+
+    int32_t anchor = 0; // start of the literals not written yet
+    int32_t matchLimit = length - FAST_MATCH_LIMIT;
+    int32_t i = 0;
+    while (i < matchLimit) {
+        uint32_t sequence = readInt32(bytes + i);
+        uint32_t hash = (sequence * 2654435761U) >> (32 - FAST_HASH_BITS);
+        int32_t ref = hashTable[hash];
+        hashTable[hash] = i;
+        if (ref < 0 || i - ref > FAST_MAX_DISTANCE || readInt32(bytes + ref) != sequence) {
+            ++i;
+            continue;
+        }
+        int32_t matchLength = FAST_MIN_MATCH;
+        int32_t maxLength = length - FAST_LAST_LITERALS - i;
+        while (matchLength < maxLength && bytes[ref + matchLength] == bytes[i + matchLength]) {
+            ++matchLength;
+        }
+        writeFastSequence(buffer.get(), pos, bytes + anchor, i - anchor, i - ref, matchLength);
+        i += matchLength;
+        anchor = i;
+    }
+    writeFastSequence(buffer.get(), pos, bytes + anchor, length - anchor, 0, 0);
+
+    buffer.resize(pos);
+    return buffer;
+}
+
+static int32_t readFastLength(const uint8_t* bytes, int32_t& pos, int32_t end) {
+    int32_t length = 0;
+    uint8_t b;
+    do {
+        if (pos >= end) {
+            boost::throw_exception(CompressionException(L"corrupt compressed data: truncated length"));
+        }
+        b = bytes[pos++];
+        length += b;
+    } while (b == 255);
+    return length;
+}
+
+void CompressionTools::decompressFast(const uint8_t* value, int32_t compressedLength, uint8_t* result, int32_t length) {
+    int32_t pos = 0;
+    int32_t resultPos = 0;
+    while (true) {
+        if (pos >= compressedLength) {
+            boost::throw_exception(CompressionException(L"corrupt compressed data: truncated sequence"));
+        }
+        uint8_t token = value[pos++];
+
+        int32_t literalLength = token >> 4;
+        if (literalLength == 15) {
+            literalLength += readFastLength(value, pos, compressedLength);
+        }
+        if (literalLength > compressedLength - pos || literalLength > length - resultPos) {
+            boost::throw_exception(CompressionException(L"corrupt compressed data: literals out of bounds"));
+        }
+        if (literalLength > 0) {
+            MiscUtils::arrayCopy(value, pos, result, resultPos, literalLength);
+            pos += literalLength;
+            resultPos += literalLength;
+        }
+        if (pos == compressedLength) {
+            break; // the last sequence has no match
+        }
+
+        if (compressedLength - pos < 2) {
+            boost::throw_exception(CompressionException(L"corrupt compressed data: truncated match"));
+        }
+        int32_t distance = value[pos] | (value[pos + 1] << 8);
+        pos += 2;
+        int32_t matchLength = token & 0x0f;
+        if (matchLength == 15) {
+            matchLength += readFastLength(value, pos, compressedLength);
+        }
+        matchLength += FAST_MIN_MATCH;
+        if (distance == 0 || distance > resultPos || matchLength > length - resultPos) {
+            boost::throw_exception(CompressionException(L"corrupt compressed data: match out of bounds"));
+        }
+        // byte by byte, as the match may overlap the bytes it produces
+        for (int32_t ref = resultPos - distance; matchLength > 0; --matchLength) {
+            result[resultPos++] = result[ref++];
+        }
+    }
+    if (resultPos != length) {
+        boost::throw_exception(CompressionException(L"corrupt compressed data: expected " + StringUtils::toString(length) +
+                               L" bytes but got " + StringUtils::toString(resultPos)));
+    }
+}
+
 }
@@ -0,0 +1,73 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "DocValuesField.h"
+#include "StringUtils.h"
+#include "VariantUtils.h"
+
+namespace Lucene {
+
+DocValuesField::DocValuesField(const String& name)
+    : AbstractField(name, Field::STORE_NO, Field::INDEX_NO, Field::TERM_VECTOR_NO) {
+    fieldsData = (int64_t)0;
+}
+
+DocValuesField::~DocValuesField() {
+}
+
+TokenStreamPtr DocValuesField::tokenStreamValue() {
+    return TokenStreamPtr();
+}
+
+ByteArray DocValuesField::getBinaryValue(ByteArray result) {
+    return ByteArray();
+}
+
+ReaderPtr DocValuesField::readerValue() {
+    return ReaderPtr();
+}
+
+String DocValuesField::stringValue() {
+    StringStream value;
+    value << fieldsData;
+    return value.str();
+}
+
+NumericDocValues::Type DocValuesField::getType() {
+    return VariantUtils::typeOf<double>(fieldsData) ? NumericDocValues::TYPE_DOUBLE : NumericDocValues::TYPE_LONG;
+}
+
+int64_t DocValuesField::getLongValue() {
+    if (VariantUtils::typeOf<double>(fieldsData)) {
+        return (int64_t)VariantUtils::get<double>(fieldsData);
+    }
+    return VariantUtils::get<int64_t>(fieldsData);
+}
+
+double DocValuesField::getDoubleValue() {
+    if (VariantUtils::typeOf<double>(fieldsData)) {
+        return VariantUtils::get<double>(fieldsData);
+    }
+    return (double)VariantUtils::get<int64_t>(fieldsData);
+}
+
+DocValuesFieldPtr DocValuesField::setLongValue(int64_t value) {
+    fieldsData = value;
+    return shared_from_this();
+}
+
+DocValuesFieldPtr DocValuesField::setIntValue(int32_t value) {
+    fieldsData = (int64_t)value;
+    return shared_from_this();
+}
+
+DocValuesFieldPtr DocValuesField::setDoubleValue(double value) {
+    fieldsData = value;
+    return shared_from_this();
+}
+
+}
@@ -33,6 +33,10 @@ public:
     virtual void normalize(double norm);
     virtual ExplanationPtr explain(const IndexReaderPtr& reader, int32_t doc);
     virtual ScorerPtr scorer(const IndexReaderPtr& reader, bool scoreDocsInOrder, bool topScorer);
+
+    /// Returns a {@link BlockMaxDisjunctionScorer} for disjunctions of terms over segments that store impacts.
+    virtual ScorerPtr competitiveScorer(const IndexReaderPtr& reader);
+
     virtual bool scoresDocsOutOfOrder();
 };
 
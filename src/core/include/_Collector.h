@@ -0,0 +1,36 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _COLLECTOR_H
+#define _COLLECTOR_H
+
+#include "Scorer.h"
+
+namespace Lucene {
+
+/// The scorer set by {@link Collector#collectBatch}, which sets the doc and score of each document before
+/// collecting it.  Therefore the only methods that are implemented are score() and docID().
+class BatchScorer : public Scorer {
+public:
+    BatchScorer();
+    virtual ~BatchScorer();
+
+    LUCENE_CLASS(BatchScorer);
+
+public:
+    double _score;
+    int32_t doc;
+
+public:
+    virtual int32_t advance(int32_t target);
+    virtual int32_t docID();
+    virtual int32_t nextDoc();
+    virtual double score();
+};
+
+}
+
+#endif
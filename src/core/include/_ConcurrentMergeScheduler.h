@@ -23,12 +23,22 @@ protected:
     IndexWriterWeakPtr _writer;
     OneMergePtr startMerge;
     OneMergePtr runningMerge;
+    bool pooled;
 
 public:
+    /// Run this merge as a task on the given thread pool instead of starting a new thread.
+    void start(const ThreadPoolPtr& threadPool);
+    using LuceneThread::start;
+
+    virtual bool isAlive();
+
     void setRunningMerge(const OneMergePtr& merge);
     OneMergePtr getRunningMerge();
     void setThreadPriority(int32_t pri);
     virtual void run();
+
+protected:
+    bool runPooled();
 };
 
 }
@@ -50,6 +50,7 @@ public:
     virtual int32_t docID();
     virtual double score();
     virtual int32_t advance(int32_t target);
+    virtual int32_t scoreBatch(Collection<int32_t> docs, Collection<double> scores, int32_t max);
 };
 
 }
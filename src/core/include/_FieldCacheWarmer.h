@@ -0,0 +1,34 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _FIELDCACHEWARMER_H
+#define _FIELDCACHEWARMER_H
+
+#include "LuceneObject.h"
+
+namespace Lucene {
+
+/// Loads the fields of a single segment.
+class FieldCacheWarmerTask : public LuceneObject {
+public:
+    FieldCacheWarmerTask(const IndexReaderPtr& reader, Collection<SortFieldPtr> sortFields);
+    virtual ~FieldCacheWarmerTask();
+
+    LUCENE_CLASS(FieldCacheWarmerTask);
+
+public:
+    IndexReaderPtr reader;
+    Collection<SortFieldPtr> sortFields;
+    LuceneException error;
+
+public:
+    /// Returns the number of fields loaded, or -1 if loading failed, leaving the exception in error.
+    int32_t call();
+};
+
+}
+
+#endif
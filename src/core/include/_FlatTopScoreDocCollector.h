@@ -0,0 +1,44 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _FLATTOPSCOREDOCCOLLECTOR_H
+#define _FLATTOPSCOREDOCCOLLECTOR_H
+
+#include "FlatTopScoreDocCollector.h"
+
+namespace Lucene {
+
+/// Assumes docs are scored in order.
+class InOrderFlatTopScoreDocCollector : public FlatTopScoreDocCollector {
+public:
+    InOrderFlatTopScoreDocCollector(int32_t numHits);
+    virtual ~InOrderFlatTopScoreDocCollector();
+
+    LUCENE_CLASS(InOrderFlatTopScoreDocCollector);
+
+public:
+    virtual void collect(int32_t doc);
+    virtual void collectBatch(Collection<int32_t> docs, Collection<double> scores, int32_t count);
+    virtual bool acceptsDocsOutOfOrder();
+};
+
+/// Assumes docs are scored out of order.
+class OutOfOrderFlatTopScoreDocCollector : public FlatTopScoreDocCollector {
+public:
+    OutOfOrderFlatTopScoreDocCollector(int32_t numHits);
+    virtual ~OutOfOrderFlatTopScoreDocCollector();
+
+    LUCENE_CLASS(OutOfOrderFlatTopScoreDocCollector);
+
+public:
+    virtual void collect(int32_t doc);
+    virtual void collectBatch(Collection<int32_t> docs, Collection<double> scores, int32_t count);
+    virtual bool acceptsDocsOutOfOrder();
+};
+
+}
+
+#endif
@@ -12,18 +12,25 @@
 
 namespace Lucene {
 
+/// Reads a memory-mapped file.  The file is mapped in chunks of a fixed power-of-two size, so files larger than
+/// the maximum size of a single mapping can be read, and all positions are 64-bit.
 class MMapIndexInput : public IndexInput {
 public:
-    MMapIndexInput(const String& path = L"");
+    MMapIndexInput(const String& path = L"", int32_t chunkSizePower = 30);
     virtual ~MMapIndexInput();
 
     LUCENE_CLASS(MMapIndexInput);
 
 protected:
-    int32_t _length;
+    int64_t _length;
     bool isClone;
-    boost::iostreams::mapped_file_source file;
-    int32_t bufferPosition; // next byte to read
+    int32_t chunkSizePower;
+    Collection<boost::iostreams::mapped_file_source> chunks;
+
+    const uint8_t* curChunk; // chunk currently being read
+    int32_t curChunkIndex; // index of current chunk
+    int32_t curChunkLength; // number of bytes in current chunk
+    int32_t chunkPosition; // next byte to read in current chunk
 
 public:
     /// Reads and returns a single byte.
@@ -37,6 +44,21 @@ public:
     /// @see IndexOutput#writeBytes(const uint8_t*,int)
     virtual void readBytes(uint8_t* b, int32_t offset, int32_t length);
 
+    /// Reads four bytes and returns an int.
+    /// @see IndexOutput#writeInt(int32_t)
+    virtual int32_t readInt();
+
+    /// Reads an int stored in variable-length format.
+    /// @see IndexOutput#writeVInt(int32_t)
+    virtual int32_t readVInt();
+
+    /// Reads eight bytes and returns a int64.
+    /// @see IndexOutput#writeLong(int64_t)
+    virtual int64_t readLong();
+
+    /// Reads a int64 stored in variable-length format.
+    virtual int64_t readVLong();
+
     /// Returns the current position in this file, where the next read will occur.
     /// @see #seek(int64_t)
     virtual int64_t getFilePointer();
@@ -53,6 +75,13 @@ public:
 
     /// Returns a clone of this stream.
     virtual LuceneObjectPtr clone(const LuceneObjectPtr& other = LuceneObjectPtr());
+
+protected:
+    /// Make the given chunk the current chunk and position at the given offset within it.
+    void setChunk(int32_t chunkIndex, int32_t position);
+
+    /// Move to the start of the next chunk, throwing if there are no more chunks.
+    void nextChunk();
 };
 
 }
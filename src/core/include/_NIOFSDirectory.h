@@ -0,0 +1,71 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _NIOFSDIRECTORY_H
+#define _NIOFSDIRECTORY_H
+
+#include "BufferedIndexInput.h"
+
+namespace Lucene {
+
+/// A read-only file handle that supports reading at an absolute position without moving a shared file pointer.
+/// An input and its clones share the handle, which is closed when the last of them releases it, so that a
+/// clone never reads from a descriptor that was closed and maybe reused for another file.
+class PositionalInputFile : public LuceneObject {
+public:
+    PositionalInputFile(const String& path);
+    virtual ~PositionalInputFile();
+
+    LUCENE_CLASS(PositionalInputFile);
+
+protected:
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE file;
+#else
+    int file;
+#endif
+    int64_t length;
+
+public:
+    /// Read up to length bytes at the given file position.
+    /// @return the number of bytes read, 0 at end of file, or -1 on error.
+    int32_t read(uint8_t* b, int32_t offset, int32_t length, int64_t position);
+    int64_t getLength();
+
+protected:
+    void close();
+};
+
+class NIOFSIndexInput : public BufferedIndexInput {
+public:
+    NIOFSIndexInput();
+    NIOFSIndexInput(const String& path, int32_t bufferSize, int32_t chunkSize);
+    virtual ~NIOFSIndexInput();
+
+    LUCENE_CLASS(NIOFSIndexInput);
+
+protected:
+    PositionalInputFilePtr file; // null once closed
+    bool isClone;
+    int32_t chunkSize;
+
+protected:
+    virtual void readInternal(uint8_t* b, int32_t offset, int32_t length);
+    virtual void seekInternal(int64_t pos);
+
+    PositionalInputFilePtr ensureOpen();
+
+public:
+    virtual int64_t length();
+    virtual void close();
+
+    /// Returns a clone of this stream.
+    virtual LuceneObjectPtr clone(const LuceneObjectPtr& other = LuceneObjectPtr());
+};
+
+}
+
+#endif
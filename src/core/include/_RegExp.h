@@ -0,0 +1,61 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _REGEXP_H
+#define _REGEXP_H
+
+#include "LuceneObject.h"
+
+namespace Lucene {
+
+/// A node of a parsed {@link RegExp}.
+class RegExpNode : public LuceneObject {
+public:
+    enum Kind {
+        REGEXP_UNION,
+        REGEXP_CONCATENATION,
+        REGEXP_REPEAT,
+        REGEXP_CHARS,
+        REGEXP_STRING
+    };
+
+    RegExpNode(Kind kind);
+    virtual ~RegExpNode();
+
+    LUCENE_CLASS(RegExpNode);
+
+public:
+    Kind kind;
+    RegExpNodePtr exp1;
+    RegExpNodePtr exp2;
+
+    /// Pairs of the first and last character of the ranges matched by REGEXP_CHARS, sorted and disjoint.
+    Collection<int32_t> ranges;
+
+    /// The string matched by REGEXP_STRING.
+    String s;
+
+    /// Occurrences of exp1 matched by REGEXP_REPEAT, max being -1 if unbounded.
+    int32_t min;
+    int32_t max;
+
+public:
+    static RegExpNodePtr makeUnion(const RegExpNodePtr& exp1, const RegExpNodePtr& exp2);
+    static RegExpNodePtr makeConcatenation(const RegExpNodePtr& exp1, const RegExpNodePtr& exp2);
+    static RegExpNodePtr makeRepeat(const RegExpNodePtr& exp, int32_t min, int32_t max);
+    static RegExpNodePtr makeChars(Collection<int32_t> ranges, bool negate);
+    static RegExpNodePtr makeString(const String& s);
+
+    /// Add the states matching this expression after start to nfa, returning the state it ends in.
+    /// Throws IllegalArgumentException once nfa has more than maxStates states.
+    int32_t toNFA(const AutomatonPtr& nfa, int32_t start, int32_t maxStates);
+
+    virtual String toString();
+};
+
+}
+
+#endif
@@ -40,6 +40,7 @@ public:
     int32_t termsIndexDivisor;
 
     TermInfosReaderPtr tis;
+    DocValuesReaderPtr docValuesReader;
     FieldsReaderPtr fieldsReaderOrig;
     TermVectorsReaderPtr termVectorsReaderOrig;
     CompoundFileReaderPtr cfsReader;
@@ -124,6 +125,7 @@ protected:
     bool dirty;
     int32_t number;
     bool rollbackDirty;
+    int32_t _maxByte; // largest unsigned value of bytes, -1 until computed
 
 public:
     void incRef();
@@ -138,6 +140,9 @@ public:
     /// Only for testing
     SegmentReaderRefPtr bytesRef();
 
+    /// Load & cache full bytes array.  Returns the largest unsigned value of bytes.
+    uint8_t maxByte();
+
     /// Called if we intend to change a norm value.  We make a private copy of bytes if it's shared
     // with others
     ByteArray copyOnWrite();
@@ -21,6 +21,7 @@ public:
 
 public:
     virtual void collect(int32_t doc);
+    virtual void collectBatch(Collection<int32_t> docs, Collection<double> scores, int32_t count);
     virtual bool acceptsDocsOutOfOrder();
 };
 
@@ -34,6 +35,7 @@ public:
 
 public:
     virtual void collect(int32_t doc);
+    virtual void collectBatch(Collection<int32_t> docs, Collection<double> scores, int32_t count);
     virtual bool acceptsDocsOutOfOrder();
 };
 
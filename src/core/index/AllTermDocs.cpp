@@ -12,15 +12,13 @@
 namespace Lucene {
 
 AllTermDocs::AllTermDocs(const SegmentReaderPtr& parent) : AbstractAllTermDocs(parent->maxDoc()) {
-    SyncLock parentLock(parent);
-    this->_deletedDocs = parent->deletedDocs;
+    this->deletedDocs = parent->getDeletedDocsSnapshot();
 }
 
 AllTermDocs::~AllTermDocs() {
 }
 
 bool AllTermDocs::isDeleted(int32_t doc) {
-    BitVectorPtr deletedDocs(_deletedDocs.lock());
     return (deletedDocs && deletedDocs->get(_doc));
 }
 
@@ -0,0 +1,96 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "CompetitiveImpactAccumulator.h"
+#include "IndexOutput.h"
+#include "IndexInput.h"
+#include "MiscUtils.h"
+
+namespace Lucene {
+
+CompetitiveImpactAccumulator::CompetitiveImpactAccumulator() {
+    maxFreqs = IntArray::newInstance(256);
+    MiscUtils::arrayFill(maxFreqs.get(), 0, maxFreqs.size(), 0);
+    minNorm = 256;
+    maxNorm = -1;
+}
+
+CompetitiveImpactAccumulator::~CompetitiveImpactAccumulator() {
+}
+
+void CompetitiveImpactAccumulator::add(int32_t freq, uint8_t norm) {
+    int32_t* __maxFreqs = maxFreqs.get();
+    __maxFreqs[norm] = std::max(__maxFreqs[norm], freq);
+    minNorm = std::min(minNorm, (int32_t)norm);
+    maxNorm = std::max(maxNorm, (int32_t)norm);
+}
+
+void CompetitiveImpactAccumulator::addAll(const CompetitiveImpactAccumulatorPtr& other) {
+    int32_t* __maxFreqs = maxFreqs.get();
+    const int32_t* otherFreqs = other->maxFreqs.get();
+    for (int32_t norm = other->minNorm; norm <= other->maxNorm; ++norm) {
+        __maxFreqs[norm] = std::max(__maxFreqs[norm], otherFreqs[norm]);
+    }
+    minNorm = std::min(minNorm, other->minNorm);
+    maxNorm = std::max(maxNorm, other->maxNorm);
+}
+
+void CompetitiveImpactAccumulator::clear() {
+    if (minNorm <= maxNorm) {
+        MiscUtils::arrayFill(maxFreqs.get(), minNorm, maxNorm + 1, 0);
+    }
+    minNorm = 256;
+    maxNorm = -1;
+}
+
+void CompetitiveImpactAccumulator::getCompetitiveImpacts(Collection<int32_t> impacts) {
+    impacts.clear();
+    const int32_t* __maxFreqs = maxFreqs.get();
+    int32_t maxFreq = 0;
+    // a pair is competitive if its freq exceeds the freqs of all larger norms
+    for (int32_t norm = maxNorm; norm >= minNorm; --norm) {
+        if (__maxFreqs[norm] > maxFreq) {
+            maxFreq = __maxFreqs[norm];
+            impacts.add(maxFreq);
+            impacts.add(norm);
+        }
+    }
+}
+
+void CompetitiveImpactAccumulator::write(const IndexOutputPtr& output) {
+    const int32_t* __maxFreqs = maxFreqs.get();
+    int32_t count = 0;
+    int32_t maxFreq = 0;
+    for (int32_t norm = maxNorm; norm >= minNorm; --norm) {
+        if (__maxFreqs[norm] > maxFreq) {
+            maxFreq = __maxFreqs[norm];
+            ++count;
+        }
+    }
+    output->writeVInt(count);
+    maxFreq = 0;
+    for (int32_t norm = maxNorm; norm >= minNorm; --norm) {
+        if (__maxFreqs[norm] > maxFreq) {
+            output->writeVInt(__maxFreqs[norm] - maxFreq);
+            output->writeByte((uint8_t)norm);
+            maxFreq = __maxFreqs[norm];
+        }
+    }
+}
+
+void CompetitiveImpactAccumulator::read(const IndexInputPtr& input, Collection<int32_t> impacts) {
+    impacts.clear();
+    int32_t count = input->readVInt();
+    int32_t freq = 0;
+    for (int32_t i = 0; i < count; ++i) {
+        freq += input->readVInt();
+        impacts.add(freq);
+        impacts.add(input->readByte());
+    }
+}
+
+}
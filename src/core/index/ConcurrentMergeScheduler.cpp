@@ -8,20 +8,33 @@
 #include "ConcurrentMergeScheduler.h"
 #include "_ConcurrentMergeScheduler.h"
 #include "IndexWriter.h"
+#include "MergePolicy.h"
+#include "RateLimiter.h"
 #include "TestPoint.h"
 #include "StringUtils.h"
+#include <boost/bind/protect.hpp>
+#include "ThreadPool.h"
 
 namespace Lucene {
 
 Collection<ConcurrentMergeSchedulerPtr> ConcurrentMergeScheduler::allInstances;
 bool ConcurrentMergeScheduler::anyExceptions = false;
 
+const double ConcurrentMergeScheduler::MIN_MERGE_MB_PER_SEC = 5.0;
+const double ConcurrentMergeScheduler::START_MERGE_MB_PER_SEC = 20.0;
+const double ConcurrentMergeScheduler::MAX_MERGE_MB_PER_SEC = 10240.0;
+
 ConcurrentMergeScheduler::ConcurrentMergeScheduler() {
     mergeThreadPriority = -1;
     mergeThreads = SetMergeThread::newInstance();
     maxThreadCount = 1;
     suppressExceptions = false;
     closed = false;
+    mergeMBPerSec = 0.0;
+    autoIOThrottle = false;
+    totalRateLimiter = newLucene<RateLimiter>(0.0);
+    finishedBytesThrottled = 0;
+    finishedPausedMillis = 0;
 }
 
 ConcurrentMergeScheduler::~ConcurrentMergeScheduler() {
@@ -64,6 +77,128 @@ void ConcurrentMergeScheduler::setMergeThreadPriority(int32_t pri) {
     }
 }
 
+void ConcurrentMergeScheduler::setThreadPool(const ThreadPoolPtr& threadPool) {
+    SyncLock syncLock(this);
+    this->threadPool = threadPool;
+}
+
+ThreadPoolPtr ConcurrentMergeScheduler::getThreadPool() {
+    SyncLock syncLock(this);
+    return threadPool;
+}
+
+void ConcurrentMergeScheduler::setMergeMBPerSec(double mbPerSec) {
+    SyncLock syncLock(this);
+    if (mbPerSec < 0.0) {
+        boost::throw_exception(IllegalArgumentException(L"mbPerSec must be 0 or more"));
+    }
+    mergeMBPerSec = mbPerSec;
+    updateMergeRates();
+}
+
+double ConcurrentMergeScheduler::getMergeMBPerSec() {
+    SyncLock syncLock(this);
+    return mergeMBPerSec;
+}
+
+void ConcurrentMergeScheduler::setTotalMergeMBPerSec(double mbPerSec) {
+    if (mbPerSec < 0.0) {
+        boost::throw_exception(IllegalArgumentException(L"mbPerSec must be 0 or more"));
+    }
+    totalRateLimiter->setMBPerSec(mbPerSec);
+}
+
+double ConcurrentMergeScheduler::getTotalMergeMBPerSec() {
+    return totalRateLimiter->getMBPerSec();
+}
+
+void ConcurrentMergeScheduler::setAutoIOThrottle(bool autoIOThrottle) {
+    SyncLock syncLock(this);
+    if (autoIOThrottle == this->autoIOThrottle) {
+        return;
+    }
+    this->autoIOThrottle = autoIOThrottle;
+    mergeMBPerSec = autoIOThrottle ? START_MERGE_MB_PER_SEC : 0.0;
+    updateMergeRates();
+}
+
+bool ConcurrentMergeScheduler::getAutoIOThrottle() {
+    SyncLock syncLock(this);
+    return autoIOThrottle;
+}
+
+int64_t ConcurrentMergeScheduler::getMergeBytesThrottled() {
+    SyncLock syncLock(this);
+    int64_t bytes = finishedBytesThrottled;
+    for (SetMergeThread::iterator merge = mergeThreads.begin(); merge != mergeThreads.end(); ++merge) {
+        OneMergePtr runningMerge((*merge)->getRunningMerge());
+        if (runningMerge && runningMerge->rateLimiter) {
+            bytes += runningMerge->rateLimiter->getBytesThrottled();
+        }
+    }
+    return bytes;
+}
+
+int64_t ConcurrentMergeScheduler::getMergePausedMillis() {
+    SyncLock syncLock(this);
+    int64_t millis = finishedPausedMillis;
+    for (SetMergeThread::iterator merge = mergeThreads.begin(); merge != mergeThreads.end(); ++merge) {
+        OneMergePtr runningMerge((*merge)->getRunningMerge());
+        if (runningMerge && runningMerge->rateLimiter) {
+            millis += runningMerge->rateLimiter->getPausedMillis();
+        }
+    }
+    return millis;
+}
+
+void ConcurrentMergeScheduler::initMergeRateLimiter(const OneMergePtr& merge) {
+    SyncLock syncLock(this);
+    if (mergeMBPerSec > 0.0 || autoIOThrottle || totalRateLimiter->getMBPerSec() > 0.0) {
+        merge->rateLimiter = newLucene<RateLimiter>(mergeMBPerSec, totalRateLimiter);
+    } else {
+        merge->rateLimiter.reset();
+    }
+}
+
+void ConcurrentMergeScheduler::updateAutoIOThrottle(bool backlog) {
+    SyncLock syncLock(this);
+    if (!autoIOThrottle) {
+        return;
+    }
+    double newMBPerSec;
+    if (backlog) {
+        newMBPerSec = std::min(mergeMBPerSec * 1.2, MAX_MERGE_MB_PER_SEC);
+    } else {
+        newMBPerSec = std::max(mergeMBPerSec / 1.1, MIN_MERGE_MB_PER_SEC);
+    }
+    if (newMBPerSec != mergeMBPerSec) {
+        message(L"  io throttle: " + String(backlog ? L"raise" : L"lower") + L" merge rate to " + StringUtils::toString((int32_t)newMBPerSec) + L" MB/sec");
+        mergeMBPerSec = newMBPerSec;
+        updateMergeRates();
+    }
+}
+
+void ConcurrentMergeScheduler::updateMergeRates() {
+    SyncLock syncLock(this);
+    for (SetMergeThread::iterator merge = mergeThreads.begin(); merge != mergeThreads.end(); ++merge) {
+        OneMergePtr runningMerge((*merge)->getRunningMerge());
+        if (runningMerge && runningMerge->rateLimiter) {
+            runningMerge->rateLimiter->setMBPerSec(mergeMBPerSec);
+        }
+    }
+}
+
+void ConcurrentMergeScheduler::mergeFinished(const OneMergePtr& merge) {
+    SyncLock syncLock(this);
+    if (merge->rateLimiter) {
+        finishedBytesThrottled += merge->rateLimiter->getBytesThrottled();
+        finishedPausedMillis += merge->rateLimiter->getPausedMillis();
+        message(L"  merge rate limiter: throttled " + StringUtils::toString(merge->rateLimiter->getBytesThrottled()) + L" of " +
+                StringUtils::toString(merge->rateLimiter->getTotalBytes()) + L" bytes, paused " +
+                StringUtils::toString(merge->rateLimiter->getPausedMillis()) + L" msec");
+    }
+}
+
 bool ConcurrentMergeScheduler::verbose() {
     return (!_writer.expired() && IndexWriterPtr(_writer)->verbose());
 }
@@ -122,6 +257,9 @@ void ConcurrentMergeScheduler::merge(const IndexWriterPtr& writer) {
     message(L"now merge");
     message(L"  index: " + writer->segString());
 
+    // More than one merge pending at once counts as a merge backlog for the automatic io throttle
+    bool launched = false;
+
     // Iterate, pulling from the IndexWriter's queue of pending merges, until it's empty
     while (true) {
         OneMergePtr merge(writer->getNextMerge());
@@ -138,11 +276,15 @@ void ConcurrentMergeScheduler::merge(const IndexWriterPtr& writer) {
         try {
             SyncLock syncLock(this);
             MergeThreadPtr merger;
+            bool stalled = false;
             while (mergeThreadCount() >= maxThreadCount) {
                 message(L"    too many merge threads running; stalling...");
+                stalled = true;
                 wait(1000);
             }
 
+            updateAutoIOThrottle(stalled || launched);
+
             message(L"  consider merge " + merge->segString(dir));
 
             BOOST_ASSERT(mergeThreadCount() < maxThreadCount);
@@ -150,9 +292,14 @@ void ConcurrentMergeScheduler::merge(const IndexWriterPtr& writer) {
             // OK to spawn a new merge thread to handle this merge
             merger = getMergeThread(writer, merge);
             mergeThreads.add(merger);
-            message(L"    launch new thread");
-
-            merger->start();
+            if (threadPool) {
+                message(L"    launch new pooled merge");
+                merger->start(threadPool);
+            } else {
+                message(L"    launch new thread");
+                merger->start();
+            }
+            launched = true;
             success = true;
         } catch (LuceneException& e) {
             finally = e;
@@ -234,11 +381,27 @@ MergeThread::MergeThread(const ConcurrentMergeSchedulerPtr& merger, const IndexW
     this->_merger = merger;
     this->_writer = writer;
     this->startMerge = startMerge;
+    this->pooled = false;
 }
 
 MergeThread::~MergeThread() {
 }
 
+void MergeThread::start(const ThreadPoolPtr& threadPool) {
+    pooled = true;
+    setRunning(true);
+    threadPool->scheduleTask(boost::protect(boost::bind<bool>(&MergeThread::runPooled, boost::static_pointer_cast<MergeThread>(shared_from_this()))));
+}
+
+bool MergeThread::runPooled() {
+    runThread(this);
+    return true;
+}
+
+bool MergeThread::isAlive() {
+    return pooled ? isRunning() : LuceneThread::isAlive();
+}
+
 void MergeThread::setRunningMerge(const OneMergePtr& merge) {
     ConcurrentMergeSchedulerPtr merger(_merger);
     SyncLock syncLock(merger);
@@ -269,8 +432,14 @@ void MergeThread::run() {
         IndexWriterPtr writer(_writer);
 
         while (true) {
+            merger->initMergeRateLimiter(merge);
             setRunningMerge(merge);
             merger->doMerge(merge);
+            {
+                SyncLock syncLock(merger);
+                merger->mergeFinished(merge);
+                runningMerge.reset();
+            }
 
             // Subsequent times through the loop we do any new merge that writer says is necessary
             merge = writer->getNextMerge();
@@ -6,12 +6,14 @@
 
 #include "LuceneInc.h"
 #include "DefaultSkipListReader.h"
+#include "CompetitiveImpactAccumulator.h"
 #include "MiscUtils.h"
 
 namespace Lucene {
 
-DefaultSkipListReader::DefaultSkipListReader(const IndexInputPtr& skipStream, int32_t maxSkipLevels, int32_t skipInterval)
+DefaultSkipListReader::DefaultSkipListReader(const IndexInputPtr& skipStream, int32_t maxSkipLevels, int32_t skipInterval, bool hasImpacts)
     : MultiLevelSkipListReader(skipStream, maxSkipLevels, skipInterval) {
+    this->hasImpacts = hasImpacts;
     currentFieldStoresPayloads = false;
     lastFreqPointer = 0;
     lastProxPointer = 0;
@@ -20,6 +22,11 @@ DefaultSkipListReader::DefaultSkipListReader(const IndexInputPtr& skipStream, in
     freqPointer = Collection<int64_t>::newInstance(maxSkipLevels);
     proxPointer = Collection<int64_t>::newInstance(maxSkipLevels);
     payloadLength = Collection<int32_t>::newInstance(maxSkipLevels);
+    impacts = Collection< Collection<int32_t> >::newInstance(maxSkipLevels);
+    for (int32_t level = 0; level < maxSkipLevels; ++level) {
+        impacts[level] = Collection<int32_t>::newInstance();
+    }
+    termImpacts = Collection<int32_t>::newInstance();
 
     MiscUtils::arrayFill(freqPointer.begin(), 0, freqPointer.size(), 0);
     MiscUtils::arrayFill(proxPointer.begin(), 0, proxPointer.size(), 0);
@@ -30,6 +37,12 @@ DefaultSkipListReader::~DefaultSkipListReader() {
 }
 
 void DefaultSkipListReader::init(int64_t skipPointer, int64_t freqBasePointer, int64_t proxBasePointer, int32_t df, bool storesPayloads) {
+    if (hasImpacts) {
+        // the skip levels follow the impacts of the whole term
+        skipStream[0]->seek(skipPointer);
+        CompetitiveImpactAccumulator::read(skipStream[0], termImpacts);
+        skipPointer = skipStream[0]->getFilePointer();
+    }
     MultiLevelSkipListReader::init(skipPointer, df);
     this->currentFieldStoresPayloads = storesPayloads;
     lastFreqPointer = freqBasePointer;
@@ -38,6 +51,9 @@ void DefaultSkipListReader::init(int64_t skipPointer, int64_t freqBasePointer, i
     MiscUtils::arrayFill(freqPointer.begin(), 0, freqPointer.size(), freqBasePointer);
     MiscUtils::arrayFill(proxPointer.begin(), 0, proxPointer.size(), proxBasePointer);
     MiscUtils::arrayFill(payloadLength.begin(), 0, payloadLength.size(), 0);
+    for (Collection< Collection<int32_t> >::iterator levelImpacts = impacts.begin(); levelImpacts != impacts.end(); ++levelImpacts) {
+        levelImpacts->clear();
+    }
 }
 
 int64_t DefaultSkipListReader::getFreqPointer() {
@@ -52,6 +68,18 @@ int32_t DefaultSkipListReader::getPayloadLength() {
     return lastPayloadLength;
 }
 
+Collection<int32_t> DefaultSkipListReader::getTermImpacts() {
+    return termImpacts;
+}
+
+int32_t DefaultSkipListReader::getNextSkipDoc() {
+    return skipDoc[0];
+}
+
+Collection<int32_t> DefaultSkipListReader::getNextSkipImpacts() {
+    return impacts[0];
+}
+
 void DefaultSkipListReader::seekChild(int32_t level) {
     MultiLevelSkipListReader::seekChild(level);
     freqPointer[level] = lastFreqPointer;
@@ -82,6 +110,9 @@ int32_t DefaultSkipListReader::readSkipData(int32_t level, const IndexInputPtr&
 
     freqPointer[level] += skipStream->readVInt();
     proxPointer[level] += skipStream->readVInt();
+    if (hasImpacts) {
+        CompetitiveImpactAccumulator::read(skipStream, impacts[level]);
+    }
 
     return delta;
 }
@@ -7,11 +7,12 @@
 #include "LuceneInc.h"
 #include "DefaultSkipListWriter.h"
 #include "IndexOutput.h"
+#include "CompetitiveImpactAccumulator.h"
 #include "MiscUtils.h"
 
 namespace Lucene {
 
-DefaultSkipListWriter::DefaultSkipListWriter(int32_t skipInterval, int32_t numberOfSkipLevels, int32_t docCount, const IndexOutputPtr& freqOutput, const IndexOutputPtr& proxOutput) : MultiLevelSkipListWriter(skipInterval, numberOfSkipLevels, docCount) {
+DefaultSkipListWriter::DefaultSkipListWriter(int32_t skipInterval, int32_t numberOfSkipLevels, int32_t docCount, const IndexOutputPtr& freqOutput, const IndexOutputPtr& proxOutput, bool hasImpacts) : MultiLevelSkipListWriter(skipInterval, numberOfSkipLevels, docCount) {
     curDoc = 0;
     curStorePayloads = false;
     curPayloadLength = 0;
@@ -20,11 +21,16 @@ DefaultSkipListWriter::DefaultSkipListWriter(int32_t skipInterval, int32_t numbe
 
     this->freqOutput = freqOutput;
     this->proxOutput = proxOutput;
+    this->hasImpacts = hasImpacts;
 
     lastSkipDoc = Collection<int32_t>::newInstance(numberOfSkipLevels);
     lastSkipPayloadLength = Collection<int32_t>::newInstance(numberOfSkipLevels);
     lastSkipFreqPointer = Collection<int64_t>::newInstance(numberOfSkipLevels);
     lastSkipProxPointer = Collection<int64_t>::newInstance(numberOfSkipLevels);
+    skipImpacts = Collection<CompetitiveImpactAccumulatorPtr>::newInstance(hasImpacts ? numberOfSkipLevels : 0);
+    for (int32_t level = 0; level < skipImpacts.size(); ++level) {
+        skipImpacts[level] = newLucene<CompetitiveImpactAccumulator>();
+    }
 }
 
 DefaultSkipListWriter::~DefaultSkipListWriter() {
@@ -38,7 +44,11 @@ void DefaultSkipListWriter::setProxOutput(const IndexOutputPtr& proxOutput) {
     this->proxOutput = proxOutput;
 }
 
-void DefaultSkipListWriter::setSkipData(int32_t doc, bool storePayloads, int32_t payloadLength) {
+void DefaultSkipListWriter::setSkipData(int32_t doc, bool storePayloads, int32_t payloadLength, const CompetitiveImpactAccumulatorPtr& impacts) {
+    if (hasImpacts) {
+        // higher levels take over the impacts of the level below when its entry is written
+        skipImpacts[0]->addAll(impacts);
+    }
     this->curDoc = doc;
     this->curStorePayloads = storePayloads;
     this->curPayloadLength = payloadLength;
@@ -48,8 +58,15 @@ void DefaultSkipListWriter::setSkipData(int32_t doc, bool storePayloads, int32_t
     }
 }
 
+void DefaultSkipListWriter::setTermImpacts(const CompetitiveImpactAccumulatorPtr& impacts) {
+    this->termImpacts = impacts;
+}
+
 void DefaultSkipListWriter::resetSkip() {
     MultiLevelSkipListWriter::resetSkip();
+    for (Collection<CompetitiveImpactAccumulatorPtr>::iterator levelImpacts = skipImpacts.begin(); levelImpacts != skipImpacts.end(); ++levelImpacts) {
+        (*levelImpacts)->clear();
+    }
     MiscUtils::arrayFill(lastSkipDoc.begin(), 0, lastSkipDoc.size(), 0);
     MiscUtils::arrayFill(lastSkipPayloadLength.begin(), 0, lastSkipPayloadLength.size(), -1); // we don't have to write the first length in the skip list
     MiscUtils::arrayFill(lastSkipFreqPointer.begin(), 0, lastSkipFreqPointer.size(), freqOutput->getFilePointer());
@@ -79,6 +96,9 @@ void DefaultSkipListWriter::writeSkipData(int32_t level, const IndexOutputPtr& s
     //         if DocSkip is even, then it is assumed that the
     //         current payload length equals the length at the previous
     //         skip point
+    // With impacts, every SkipDatum ends with the Impacts of the docs it skips over: the competitive pairs of term freq
+    // and norm, see CompetitiveImpactAccumulator.  Together with the Impacts of the whole term in front of
+    // the skip levels they bound the score of skipped blocks.
     if (curStorePayloads) {
         int32_t delta = curDoc - lastSkipDoc[level];
         if (curPayloadLength == lastSkipPayloadLength[level]) {
@@ -98,6 +118,13 @@ void DefaultSkipListWriter::writeSkipData(int32_t level, const IndexOutputPtr& s
     }
     skipBuffer->writeVInt((int32_t)(curFreqPointer - lastSkipFreqPointer[level]));
     skipBuffer->writeVInt((int32_t)(curProxPointer - lastSkipProxPointer[level]));
+    if (hasImpacts) {
+        skipImpacts[level]->write(skipBuffer);
+        if (level + 1 < numberOfSkipLevels) {
+            skipImpacts[level + 1]->addAll(skipImpacts[level]);
+        }
+        skipImpacts[level]->clear();
+    }
 
     lastSkipDoc[level] = curDoc;
 
@@ -105,4 +132,10 @@ void DefaultSkipListWriter::writeSkipData(int32_t level, const IndexOutputPtr& s
     lastSkipProxPointer[level] = curProxPointer;
 }
 
+void DefaultSkipListWriter::writeSkipHeader(const IndexOutputPtr& output) {
+    if (hasImpacts) {
+        termImpacts->write(output);
+    }
+}
+
 }
@@ -37,6 +37,7 @@ DirectoryReader::DirectoryReader(const DirectoryPtr& directory, const SegmentInf
     synced = HashSet<String>::newInstance();
     stale = false;
     rollbackHasChanges = false;
+    writerChangeCount = 0;
 
     this->_directory = directory;
     this->readOnly = readOnly;
@@ -89,11 +90,13 @@ DirectoryReader::DirectoryReader(const IndexWriterPtr& writer, const SegmentInfo
     synced = HashSet<String>::newInstance();
     stale = false;
     rollbackHasChanges = false;
+    writerChangeCount = 0;
 
     this->_directory = writer->getDirectory();
     this->readOnly = true;
     this->segmentInfos = infos;
     this->segmentInfosStart = boost::dynamic_pointer_cast<SegmentInfos>(infos->clone());
+    this->writerChangeCount = writer->getChangeCount();
     this->termInfosIndexDivisor = termInfosIndexDivisor;
 
     if (!readOnly) {
@@ -156,6 +159,7 @@ DirectoryReader::DirectoryReader(const DirectoryPtr& directory, const SegmentInf
     synced = HashSet<String>::newInstance();
     stale = false;
     rollbackHasChanges = false;
+    writerChangeCount = 0;
 
     this->_directory = directory;
     this->readOnly = readOnly;
@@ -314,6 +318,8 @@ LuceneObjectPtr DirectoryReader::clone(bool openReadOnly, const LuceneObjectPtr&
     }
 
     newReader->_writer = _writer;
+    newReader->segmentInfosStart = segmentInfosStart;
+    newReader->writerChangeCount = writerChangeCount;
 
     // If we're cloning a non-readOnly reader, move the writeLock (if there is one) to the new reader
     if (!openReadOnly && writeLock) {
@@ -353,7 +359,12 @@ IndexReaderPtr DirectoryReader::doReopenFromWriter(bool openReadOnly, const Inde
         boost::throw_exception(IllegalArgumentException(L"a reader obtained from IndexWriter.getReader() cannot currently accept a commit"));
     }
 
-    return IndexWriterPtr(_writer)->getReader();
+    IndexWriterPtr writer(_writer);
+    if (!writer->isClosed() && isCurrent()) {
+        // nothing to flush and no new deletions, keep sharing this reader
+        return shared_from_this();
+    }
+    return writer->getReader();
 }
 
 IndexReaderPtr DirectoryReader::doReopen(bool openReadOnly, const IndexCommitPtr& commit) {
@@ -364,11 +375,33 @@ IndexReaderPtr DirectoryReader::doReopen(bool openReadOnly, const IndexCommitPtr
     IndexWriterPtr writer(_writer.lock());
 
     // If we were obtained by writer.getReader(), re-ask the writer to get a new reader.
-    if (writer) {
-        return doReopenFromWriter(openReadOnly, commit);
-    } else {
-        return doReopenNoWriter(openReadOnly, commit);
+    IndexReaderPtr newReader(writer ? doReopenFromWriter(openReadOnly, commit) : doReopenNoWriter(openReadOnly, commit));
+    if (reopenWarmer && newReader != shared_from_this()) {
+        DirectoryReaderPtr directoryReader(boost::dynamic_pointer_cast<DirectoryReader>(newReader));
+        if (directoryReader) {
+            directoryReader->reopenWarmer = reopenWarmer;
+        }
+        // warm the new reader before anyone can search it
+        LuceneException finally;
+        try {
+            reopenWarmer->warm(newReader);
+        } catch (LuceneException& e) {
+            finally = e;
+        }
+        if (!finally.isNull()) {
+            newReader->close();
+            finally.throwException();
+        }
     }
+    return newReader;
+}
+
+void DirectoryReader::setReopenWarmer(const IndexReaderWarmerPtr& warmer) {
+    reopenWarmer = warmer;
+}
+
+IndexReaderWarmerPtr DirectoryReader::getReopenWarmer() {
+    return reopenWarmer;
 }
 
 IndexReaderPtr DirectoryReader::doReopenNoWriter(bool openReadOnly, const IndexCommitPtr& commit) {
@@ -414,11 +447,14 @@ IndexReaderPtr DirectoryReader::doReopenNoWriter(bool openReadOnly, const IndexC
 
 DirectoryReaderPtr DirectoryReader::doReopen(const SegmentInfosPtr& infos, bool doClone, bool openReadOnly) {
     SyncLock syncLock(this);
+    DirectoryReaderPtr newReader;
     if (openReadOnly) {
-        return newLucene<ReadOnlyDirectoryReader>(_directory, infos, subReaders, starts, normsCache, doClone, termInfosIndexDivisor);
+        newReader = newLucene<ReadOnlyDirectoryReader>(_directory, infos, subReaders, starts, normsCache, doClone, termInfosIndexDivisor);
     } else {
-        return newLucene<DirectoryReader>(_directory, infos, subReaders, starts, normsCache, false, doClone, termInfosIndexDivisor);
+        newReader = newLucene<DirectoryReader>(_directory, infos, subReaders, starts, normsCache, false, doClone, termInfosIndexDivisor);
     }
+    newReader->reopenWarmer = reopenWarmer;
+    return newReader;
 }
 
 int64_t DirectoryReader::getVersion() {
@@ -716,7 +752,7 @@ bool DirectoryReader::isCurrent() {
         // we loaded SegmentInfos from the directory
         return (SegmentInfos::readCurrentVersion(_directory) == segmentInfos->getVersion());
     } else {
-        return writer->nrtIsCurrent(segmentInfosStart);
+        return writer->nrtIsCurrent(segmentInfosStart, writerChangeCount);
     }
 }
 
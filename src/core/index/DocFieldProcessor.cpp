@@ -10,6 +10,7 @@
 #include "DocFieldConsumerPerThread.h"
 #include "DocFieldConsumer.h"
 #include "StoredFieldsWriter.h"
+#include "DocValuesWriter.h"
 #include "SegmentWriteState.h"
 #include "IndexFileNames.h"
 #include "FieldInfos.h"
@@ -23,6 +24,7 @@ DocFieldProcessor::DocFieldProcessor(const DocumentsWriterPtr& docWriter, const
     this->consumer = consumer;
     consumer->setFieldInfos(fieldInfos);
     fieldsWriter = newLucene<StoredFieldsWriter>(docWriter, fieldInfos);
+    docValuesWriter = newLucene<DocValuesWriter>(fieldInfos);
 }
 
 DocFieldProcessor::~DocFieldProcessor() {
@@ -36,13 +38,16 @@ void DocFieldProcessor::closeDocStore(const SegmentWriteStatePtr& state) {
 void DocFieldProcessor::flush(Collection<DocConsumerPerThreadPtr> threads, const SegmentWriteStatePtr& state) {
     TestScope testScope(L"DocFieldProcessor", L"flush");
     MapDocFieldConsumerPerThreadCollectionDocFieldConsumerPerField childThreadsAndFields(MapDocFieldConsumerPerThreadCollectionDocFieldConsumerPerField::newInstance());
+    Collection<DocValuesWriterPerThreadPtr> docValuesThreads(Collection<DocValuesWriterPerThreadPtr>::newInstance());
 
     for (Collection<DocConsumerPerThreadPtr>::iterator thread = threads.begin(); thread != threads.end(); ++thread) {
         DocFieldProcessorPerThreadPtr perThread(boost::static_pointer_cast<DocFieldProcessorPerThread>(*thread));
         childThreadsAndFields.put(perThread->consumer, perThread->fields());
+        docValuesThreads.add(perThread->docValuesWriter);
         perThread->trimFields(state);
     }
     fieldsWriter->flush(state);
+    docValuesWriter->flush(docValuesThreads, state);
     consumer->flush(childThreadsAndFields, state);
 
     // Important to save after asking consumer to flush so consumer can alter the FieldInfo* if necessary.
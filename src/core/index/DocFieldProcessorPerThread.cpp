@@ -15,6 +15,9 @@
 #include "DocumentsWriter.h"
 #include "StoredFieldsWriter.h"
 #include "StoredFieldsWriterPerThread.h"
+#include "DocValuesWriter.h"
+#include "DocValuesWriterPerThread.h"
+#include "DocValuesField.h"
 #include "SegmentWriteState.h"
 #include "FieldInfo.h"
 #include "FieldInfos.h"
@@ -51,6 +54,7 @@ void DocFieldProcessorPerThread::initialize() {
     DocFieldProcessorPtr docFieldProcessor(_docFieldProcessor);
     consumer = docFieldProcessor->consumer->addThread(shared_from_this());
     fieldsWriter = docFieldProcessor->fieldsWriter->addThread(docState);
+    docValuesWriter = docFieldProcessor->docValuesWriter->addThread(docState);
 }
 
 void DocFieldProcessorPerThread::abort() {
@@ -63,6 +67,7 @@ void DocFieldProcessorPerThread::abort() {
         }
     }
     fieldsWriter->abort();
+    docValuesWriter->abort();
     consumer->abort();
 }
 
@@ -210,6 +215,10 @@ DocWriterPtr DocFieldProcessorPerThread::processDocument() {
         if ((*field)->isStored()) {
             fieldsWriter->addField(*field, fp->fieldInfo);
         }
+        DocValuesFieldPtr docValuesField(boost::dynamic_pointer_cast<DocValuesField>(*field));
+        if (docValuesField) {
+            docValuesWriter->addField(docValuesField, fp->fieldInfo);
+        }
     }
 
     // If we are writing vectors then we must visit fields in sorted order so they are written in sorted order.
@@ -0,0 +1,91 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "DocValuesReader.h"
+#include "DocValuesWriter.h"
+#include "NumericDocValues.h"
+#include "PackedInts.h"
+#include "FieldInfos.h"
+#include "IndexFileNames.h"
+#include "IndexInput.h"
+#include "Directory.h"
+#include "StringUtils.h"
+
+namespace Lucene {
+
+DocValuesReader::DocValuesReader(const DirectoryPtr& dir, const String& segment, const FieldInfosPtr& fieldInfos, int32_t maxDoc, int32_t readBufferSize) {
+    this->maxDoc = maxDoc;
+    this->pointers = HashMap<String, int64_t>::newInstance();
+    this->loaded = HashMap<String, NumericDocValuesPtr>::newInstance();
+
+    input = dir->openInput(segment + L"." + IndexFileNames::DOC_VALUES_EXTENSION(), readBufferSize);
+    bool success = false;
+    LuceneException finally;
+    try {
+        int32_t format = input->readInt();
+        if (format < DocValuesWriter::FORMAT) {
+            boost::throw_exception(CorruptIndexException(L"Incompatible doc values format version: " + StringUtils::toString(format) +
+                                   L" expected " + StringUtils::toString(DocValuesWriter::FORMAT) + L" or higher"));
+        }
+        int32_t numFields = input->readVInt();
+        for (int32_t i = 0; i < numFields; ++i) {
+            int64_t pointer = input->getFilePointer();
+            int32_t fieldNumber = input->readVInt();
+            input->readByte(); // type
+            input->readLong(); // min value
+            int32_t bitsPerValue = input->readByte();
+            pointers.put(fieldInfos->fieldName(fieldNumber), pointer);
+            input->seek(input->getFilePointer() + (int64_t)PackedInts::numWords(maxDoc, bitsPerValue) * sizeof(int64_t));
+        }
+        success = true;
+    } catch (LuceneException& e) {
+        finally = e;
+    }
+    if (!success) {
+        close();
+    }
+    finally.throwException();
+}
+
+DocValuesReader::~DocValuesReader() {
+}
+
+NumericDocValuesPtr DocValuesReader::getDocValues(const String& field) {
+    SyncLock syncLock(this);
+    NumericDocValuesPtr values(loaded.get(field));
+    if (values) {
+        return values;
+    }
+    HashMap<String, int64_t>::iterator pointer = pointers.find(field);
+    if (pointer == pointers.end()) {
+        return NumericDocValuesPtr();
+    }
+    if (!input) {
+        boost::throw_exception(AlreadyClosedException(L"this DocValuesReader is closed"));
+    }
+    input->seek(pointer->second);
+    input->readVInt(); // field number
+    NumericDocValues::Type type = (NumericDocValues::Type)input->readByte();
+    int64_t minValue = input->readLong();
+    values = newLucene<NumericDocValues>(type, minValue, PackedInts::read(input, maxDoc));
+    loaded.put(field, values);
+    return values;
+}
+
+bool DocValuesReader::hasField(const String& field) {
+    return pointers.contains(field);
+}
+
+void DocValuesReader::close() {
+    SyncLock syncLock(this);
+    if (input) {
+        input->close();
+        input.reset();
+    }
+}
+
+}
@@ -0,0 +1,116 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "DocValuesWriter.h"
+#include "DocValuesWriterPerThread.h"
+#include "SegmentWriteState.h"
+#include "IndexFileNames.h"
+#include "IndexOutput.h"
+#include "Directory.h"
+#include "NumericUtils.h"
+#include "MiscUtils.h"
+
+namespace Lucene {
+
+const int32_t DocValuesWriter::FORMAT = -1;
+
+DocValuesWriter::DocValuesWriter(const FieldInfosPtr& fieldInfos) {
+    this->fieldInfos = fieldInfos;
+}
+
+DocValuesWriter::~DocValuesWriter() {
+}
+
+DocValuesWriterPerThreadPtr DocValuesWriter::addThread(const DocStatePtr& docState) {
+    return newLucene<DocValuesWriterPerThread>(docState);
+}
+
+void DocValuesWriter::flush(Collection<DocValuesWriterPerThreadPtr> threads, const SegmentWriteStatePtr& state) {
+    Set<int32_t> fields(Set<int32_t>::newInstance());
+    for (Collection<DocValuesWriterPerThreadPtr>::iterator thread = threads.begin(); thread != threads.end(); ++thread) {
+        for (int32_t i = 0; i < (*thread)->numValues; ++i) {
+            fields.add((*thread)->fieldNumbers[i]);
+        }
+    }
+    if (fields.empty()) {
+        return;
+    }
+
+    String fileName(state->segmentFileName(IndexFileNames::DOC_VALUES_EXTENSION()));
+    state->flushedFiles.add(fileName);
+    IndexOutputPtr out(state->directory->createOutput(fileName));
+
+    LuceneException finally;
+    try {
+        writeHeader(out, fields.size());
+        LongArray docValues(LongArray::newInstance(std::max(state->numDocs, 1)));
+        for (Set<int32_t>::iterator field = fields.begin(); field != fields.end(); ++field) {
+            // the field is stored as double if any document has a double value
+            bool isDouble = false;
+            for (Collection<DocValuesWriterPerThreadPtr>::iterator thread = threads.begin(); thread != threads.end() && !isDouble; ++thread) {
+                for (int32_t i = 0; i < (*thread)->numValues && !isDouble; ++i) {
+                    isDouble = ((*thread)->fieldNumbers[i] == *field && (*thread)->doubles[i] != 0);
+                }
+            }
+
+            // documents without a value are 0, the sortable long of 0.0 too
+            MiscUtils::arrayFill(docValues.get(), 0, docValues.size(), 0);
+            for (Collection<DocValuesWriterPerThreadPtr>::iterator thread = threads.begin(); thread != threads.end(); ++thread) {
+                DocValuesWriterPerThreadPtr perThread(*thread);
+                for (int32_t i = 0; i < perThread->numValues; ++i) {
+                    if (perThread->fieldNumbers[i] == *field) {
+                        BOOST_ASSERT(perThread->docIDs[i] < state->numDocs);
+                        int64_t value = perThread->values[i];
+                        if (isDouble && perThread->doubles[i] == 0) {
+                            value = NumericUtils::doubleToSortableLong((double)value);
+                        }
+                        docValues[perThread->docIDs[i]] = value;
+                    }
+                }
+            }
+
+            writeField(out, *field, isDouble ? NumericDocValues::TYPE_DOUBLE : NumericDocValues::TYPE_LONG, docValues, state->numDocs);
+        }
+    } catch (LuceneException& e) {
+        finally = e;
+    }
+
+    out->close();
+
+    for (Collection<DocValuesWriterPerThreadPtr>::iterator thread = threads.begin(); thread != threads.end(); ++thread) {
+        (*thread)->reset();
+    }
+
+    finally.throwException();
+}
+
+void DocValuesWriter::writeHeader(const IndexOutputPtr& out, int32_t numFields) {
+    out->writeInt(FORMAT);
+    out->writeVInt(numFields);
+}
+
+void DocValuesWriter::writeField(const IndexOutputPtr& out, int32_t fieldNumber, NumericDocValues::Type type, LongArray values, int32_t numDocs) {
+    int64_t minValue = numDocs == 0 ? 0 : values[0];
+    int64_t maxValue = minValue;
+    for (int32_t i = 1; i < numDocs; ++i) {
+        minValue = std::min(minValue, values[i]);
+        maxValue = std::max(maxValue, values[i]);
+    }
+
+    // offsets from the smallest value, unsigned so that the full range of longs fits in 64 bits
+    PackedIntsPtr packed(newLucene<PackedInts>(numDocs, PackedInts::bitsRequired((int64_t)((uint64_t)maxValue - (uint64_t)minValue))));
+    for (int32_t i = 0; i < numDocs; ++i) {
+        packed->set(i, (int64_t)((uint64_t)values[i] - (uint64_t)minValue));
+    }
+
+    out->writeVInt(fieldNumber);
+    out->writeByte((uint8_t)type);
+    out->writeLong(minValue);
+    packed->write(out);
+}
+
+}
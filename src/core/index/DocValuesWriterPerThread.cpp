@@ -0,0 +1,53 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "DocValuesWriterPerThread.h"
+#include "DocValuesField.h"
+#include "DocumentsWriter.h"
+#include "FieldInfo.h"
+#include "NumericUtils.h"
+#include "MiscUtils.h"
+
+namespace Lucene {
+
+DocValuesWriterPerThread::DocValuesWriterPerThread(const DocStatePtr& docState) {
+    this->docState = docState;
+    numValues = 0;
+}
+
+DocValuesWriterPerThread::~DocValuesWriterPerThread() {
+}
+
+void DocValuesWriterPerThread::addField(const DocValuesFieldPtr& field, const FieldInfoPtr& fieldInfo) {
+    if (!values || numValues == values.size()) {
+        int32_t newSize = MiscUtils::getNextSize(numValues + 1);
+        fieldNumbers.resize(newSize);
+        docIDs.resize(newSize);
+        values.resize(newSize);
+        doubles.resize(newSize);
+    }
+    bool isDouble = (field->getType() == NumericDocValues::TYPE_DOUBLE);
+    fieldNumbers[numValues] = fieldInfo->number;
+    docIDs[numValues] = docState->docID;
+    values[numValues] = isDouble ? NumericUtils::doubleToSortableLong(field->getDoubleValue()) : field->getLongValue();
+    doubles[numValues] = isDouble ? 1 : 0;
+    ++numValues;
+}
+
+void DocValuesWriterPerThread::reset() {
+    numValues = 0;
+    fieldNumbers.reset();
+    docIDs.reset();
+    values.reset();
+    doubles.reset();
+}
+
+void DocValuesWriterPerThread::abort() {
+    reset();
+}
+
+}
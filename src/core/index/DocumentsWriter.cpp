@@ -147,6 +147,7 @@ void DocumentsWriter::initialize() {
 
     IndexWriterPtr writer(_writer);
     this->similarity = writer->getSimilarity();
+    this->storedFieldsCompression = writer->getStoredFieldsCompression();
     flushedDocCount = writer->maxDoc();
 
     consumer = indexingChain->getChain(shared_from_this());
@@ -209,6 +210,11 @@ void DocumentsWriter::setSimilarity(const SimilarityPtr& similarity) {
     }
 }
 
+void DocumentsWriter::setStoredFieldsCompression(int32_t compression) {
+    SyncLock syncLock(this);
+    this->storedFieldsCompression = compression;
+}
+
 void DocumentsWriter::setRAMBufferSizeMB(double mb) {
     SyncLock syncLock(this);
     if (mb == IndexWriter::DISABLE_AUTO_FLUSH) {
@@ -448,7 +454,8 @@ bool DocumentsWriter::anyChanges() {
 void DocumentsWriter::initFlushState(bool onlyDocStore) {
     SyncLock syncLock(this);
     initSegmentName(onlyDocStore);
-    flushState = newLucene<SegmentWriteState>(shared_from_this(), directory, segment, docStoreSegment, numDocsInRAM, numDocsInStore, IndexWriterPtr(_writer)->getTermIndexInterval());
+    IndexWriterPtr writer(_writer);
+    flushState = newLucene<SegmentWriteState>(shared_from_this(), directory, segment, docStoreSegment, numDocsInRAM, numDocsInStore, writer->getTermIndexInterval(), writer->getUseBlockPostings(), writer->getUseSkipImpacts());
 }
 
 int32_t DocumentsWriter::flush(bool _closeDocStore) {
@@ -16,6 +16,10 @@
 #include "Document.h"
 #include "Field.h"
 #include "CompressionTools.h"
+#include "IndexWriter.h"
+#include "RAMOutputStream.h"
+#include "RAMInputStream.h"
+#include "RAMFile.h"
 #include "MiscUtils.h"
 #include "StringUtils.h"
 #include "VariantUtils.h"
@@ -24,9 +28,12 @@ namespace Lucene {
 
 FieldsReader::FieldsReader(const FieldInfosPtr& fieldInfos, int32_t numTotalDocs, int32_t size, int32_t format,
                            int32_t formatSize, int32_t docStoreOffset, const IndexInputPtr& cloneableFieldsStream,
-                           const IndexInputPtr& cloneableIndexStream) {
+                           const IndexInputPtr& cloneableIndexStream, int32_t compression) {
     closed = false;
     isOriginal = false;
+    this->compression = compression;
+    chunkPointer = -1;
+    chunkDocs = 0;
     this->fieldInfos = fieldInfos;
     this->numTotalDocs = numTotalDocs;
     this->_size = size;
@@ -58,6 +65,9 @@ void FieldsReader::ConstructReader(const DirectoryPtr& d, const String& segment,
     closed = false;
     format = 0;
     formatSize = 0;
+    compression = IndexWriter::STORED_FIELDS_UNCOMPRESSED;
+    chunkPointer = -1;
+    chunkDocs = 0;
     docStoreOffset = docStoreOffset;
     LuceneException finally;
     try {
@@ -81,6 +91,14 @@ void FieldsReader::ConstructReader(const DirectoryPtr& d, const String& segment,
             cloneableFieldsStream->setModifiedUTF8StringsMode();
         }
 
+        if (format >= FieldsWriter::FORMAT_COMPRESSED_CHUNKS) {
+            cloneableFieldsStream->seek(formatSize);
+            compression = cloneableFieldsStream->readByte();
+            if (compression != IndexWriter::STORED_FIELDS_COMPRESS_FAST && compression != IndexWriter::STORED_FIELDS_COMPRESS_HIGH) {
+                boost::throw_exception(CorruptIndexException(L"Unknown stored fields compression: " + StringUtils::toString(compression)));
+            }
+        }
+
         fieldsStream = boost::dynamic_pointer_cast<IndexInput>(cloneableFieldsStream->clone());
 
         int64_t indexSize = cloneableIndexStream->length() - formatSize;
@@ -113,7 +131,7 @@ void FieldsReader::ConstructReader(const DirectoryPtr& d, const String& segment,
 
 LuceneObjectPtr FieldsReader::clone(const LuceneObjectPtr& other) {
     ensureOpen();
-    return newLucene<FieldsReader>(fieldInfos, numTotalDocs, _size, format, formatSize, docStoreOffset, cloneableFieldsStream, cloneableIndexStream);
+    return newLucene<FieldsReader>(fieldInfos, numTotalDocs, _size, format, formatSize, docStoreOffset, cloneableFieldsStream, cloneableIndexStream, compression);
 }
 
 void FieldsReader::ensureOpen() {
@@ -139,6 +157,10 @@ void FieldsReader::close() {
             indexStream->close();
         }
         fieldsStreamTL.close();
+        chunkStream.reset();
+        chunkOutput.reset();
+        chunkFile.reset();
+        docStream.reset();
         closed = true;
     }
 }
@@ -159,18 +181,25 @@ bool FieldsReader::canReadRawDocs() {
 }
 
 DocumentPtr FieldsReader::doc(int32_t n, const FieldSelectorPtr& fieldSelector) {
-    seekIndex(n);
-    int64_t position = indexStream->readLong();
-    fieldsStream->seek(position);
+    if (compression != IndexWriter::STORED_FIELDS_UNCOMPRESSED) {
+        int32_t docInChunk = seekChunkDocument(n);
+        docStream = chunkStream;
+        docStream->seek(chunkDocStarts[docInChunk]);
+    } else {
+        seekIndex(n);
+        int64_t position = indexStream->readLong();
+        docStream = fieldsStream;
+        docStream->seek(position);
+    }
 
     DocumentPtr doc(newLucene<Document>());
-    int32_t numFields = fieldsStream->readVInt();
+    int32_t numFields = docStream->readVInt();
     for (int32_t i = 0; i < numFields; ++i) {
-        int32_t fieldNumber = fieldsStream->readVInt();
+        int32_t fieldNumber = docStream->readVInt();
         FieldInfoPtr fi = fieldInfos->fieldInfo(fieldNumber);
         FieldSelector::FieldSelectorResult acceptField = fieldSelector ? fieldSelector->accept(fi->name) : FieldSelector::SELECTOR_LOAD;
 
-        uint8_t bits = fieldsStream->readByte();
+        uint8_t bits = docStream->readByte();
         if (bits > FieldsWriter::FIELD_IS_COMPRESSED + FieldsWriter::FIELD_IS_TOKENIZED + FieldsWriter::FIELD_IS_BINARY) {
             bits = bits & (FieldsWriter::FIELD_IS_COMPRESSED + FieldsWriter::FIELD_IS_TOKENIZED + FieldsWriter::FIELD_IS_BINARY);
         }
@@ -190,7 +219,12 @@ DocumentPtr FieldsReader::doc(int32_t n, const FieldSelectorPtr& fieldSelector)
             addField(doc, fi, binary, compressed, tokenize);
             break; // Get out of this loop
         } else if (acceptField == FieldSelector::SELECTOR_LAZY_LOAD) {
-            addFieldLazy(doc, fi, binary, compressed, tokenize);
+            if (compression != IndexWriter::STORED_FIELDS_UNCOMPRESSED) {
+                // the document is decompressed already, so there is nothing to gain by loading it later
+                addField(doc, fi, binary, compressed, tokenize);
+            } else {
+                addFieldLazy(doc, fi, binary, compressed, tokenize);
+            }
         } else if (acceptField == FieldSelector::SELECTOR_SIZE) {
             skipField(binary, compressed, addFieldSize(doc, fi, binary, compressed));
         } else if (acceptField == FieldSelector::SELECTOR_SIZE_AND_BREAK) {
@@ -205,6 +239,18 @@ DocumentPtr FieldsReader::doc(int32_t n, const FieldSelectorPtr& fieldSelector)
 }
 
 IndexInputPtr FieldsReader::rawDocs(Collection<int32_t> lengths, int32_t startDocID, int32_t numDocs) {
+    if (compression != IndexWriter::STORED_FIELDS_UNCOMPRESSED) {
+        int32_t docInChunk = seekChunkDocument(startDocID);
+        if (docInChunk + numDocs > chunkDocs) {
+            boost::throw_exception(IllegalArgumentException(L"raw documents must all be in the same compressed chunk"));
+        }
+        for (int32_t i = 0; i < numDocs; ++i) {
+            lengths[i] = chunkDocStarts[docInChunk + i + 1] - chunkDocStarts[docInChunk + i];
+        }
+        chunkStream->seek(chunkDocStarts[docInChunk]);
+        return chunkStream;
+    }
+
     seekIndex(startDocID);
     int64_t startOffset = indexStream->readLong();
     int64_t lastOffset = startOffset;
@@ -222,25 +268,118 @@ IndexInputPtr FieldsReader::rawDocs(Collection<int32_t> lengths, int32_t startDo
     return fieldsStream;
 }
 
+int32_t FieldsReader::getCompression() {
+    return compression;
+}
+
+int32_t FieldsReader::readChunkHeader(int64_t pointer, Collection<int32_t> docStarts, uint8_t& codec, int32_t& compressedLength) {
+    fieldsStream->seek(pointer);
+    int32_t numDocs = fieldsStream->readVInt();
+    if (numDocs <= 0 || numDocs > FieldsWriter::MAX_CHUNK_DOCS) {
+        boost::throw_exception(CorruptIndexException(L"invalid number of documents in stored fields chunk: " + StringUtils::toString(numDocs)));
+    }
+    int32_t start = 0;
+    for (int32_t i = 0; i < numDocs; ++i) {
+        if (docStarts) {
+            docStarts[i] = start;
+        }
+        start += fieldsStream->readVInt();
+    }
+    if (docStarts) {
+        docStarts[numDocs] = start;
+    }
+    codec = fieldsStream->readByte();
+    compressedLength = fieldsStream->readVInt();
+    return numDocs;
+}
+
+void FieldsReader::loadChunk(int64_t pointer) {
+    if (pointer == chunkPointer) {
+        return;
+    }
+    if (!chunkDocStarts) {
+        chunkDocStarts = Collection<int32_t>::newInstance(FieldsWriter::MAX_CHUNK_DOCS + 1);
+        chunkFile = newLucene<RAMFile>();
+        chunkOutput = newLucene<RAMOutputStream>(chunkFile);
+    }
+    chunkPointer = -1;
+    uint8_t codec = 0;
+    int32_t compressedLength = 0;
+    int32_t numDocs = readChunkHeader(pointer, chunkDocStarts, codec, compressedLength);
+    int32_t length = chunkDocStarts[numDocs];
+
+    chunkOutput->reset();
+    if (codec == IndexWriter::STORED_FIELDS_COMPRESS_FAST) {
+        int32_t bufferSize = compressedLength + length;
+        if (!chunkBuffer || chunkBuffer.size() < bufferSize) {
+            chunkBuffer = ByteArray::newInstance(MiscUtils::getNextSize(bufferSize));
+        }
+        // the compressed bytes followed by the decompressed ones
+        fieldsStream->readBytes(chunkBuffer.get(), 0, compressedLength);
+        CompressionTools::decompressFast(chunkBuffer.get(), compressedLength, chunkBuffer.get() + compressedLength, length);
+        chunkOutput->writeBytes(chunkBuffer.get(), compressedLength, length);
+    } else if (codec == IndexWriter::STORED_FIELDS_COMPRESS_HIGH) {
+        ByteArray compressed(ByteArray::newInstance(compressedLength));
+        fieldsStream->readBytes(compressed.get(), 0, compressedLength);
+        ByteArray bytes(CompressionTools::decompress(compressed));
+        if (bytes.size() != length) {
+            boost::throw_exception(CorruptIndexException(L"stored fields chunk decompressed to " + StringUtils::toString(bytes.size()) +
+                                   L" bytes instead of " + StringUtils::toString(length)));
+        }
+        chunkOutput->writeBytes(bytes.get(), 0, length);
+    } else {
+        boost::throw_exception(CorruptIndexException(L"Unknown stored fields codec: " + StringUtils::toString((int32_t)codec)));
+    }
+    chunkOutput->flush();
+
+    chunkStream = newLucene<RAMInputStream>(chunkFile);
+    chunkDocs = numDocs;
+    chunkPointer = pointer;
+}
+
+int32_t FieldsReader::seekChunkDocument(int32_t docID) {
+    seekIndex(docID);
+    int64_t position = indexStream->readLong();
+    loadChunk(MiscUtils::unsignedShift(position, (int64_t)FieldsWriter::CHUNK_DOC_BITS));
+    int32_t docInChunk = (int32_t)(position & ((1 << FieldsWriter::CHUNK_DOC_BITS) - 1));
+    if (docInChunk >= chunkDocs) {
+        boost::throw_exception(CorruptIndexException(L"document " + StringUtils::toString(docID) + L" is not in its stored fields chunk"));
+    }
+    return docInChunk;
+}
+
+IndexInputPtr FieldsReader::rawChunk(int32_t docID, int32_t& docInChunk, int32_t& numDocs, int64_t& length) {
+    seekIndex(docID);
+    int64_t position = indexStream->readLong();
+    int64_t pointer = MiscUtils::unsignedShift(position, (int64_t)FieldsWriter::CHUNK_DOC_BITS);
+    docInChunk = (int32_t)(position & ((1 << FieldsWriter::CHUNK_DOC_BITS) - 1));
+    uint8_t codec = 0;
+    int32_t compressedLength = 0;
+    numDocs = readChunkHeader(pointer, Collection<int32_t>(), codec, compressedLength);
+    length = fieldsStream->getFilePointer() + compressedLength - pointer;
+    fieldsStream->seek(pointer);
+    return fieldsStream;
+}
+
 void FieldsReader::skipField(bool binary, bool compressed) {
-    skipField(binary, compressed, fieldsStream->readVInt());
+    skipField(binary, compressed, docStream->readVInt());
 }
 
 void FieldsReader::skipField(bool binary, bool compressed, int32_t toRead) {
     if (format >= FieldsWriter::FORMAT_VERSION_UTF8_LENGTH_IN_BYTES || binary || compressed) {
-        fieldsStream->seek(fieldsStream->getFilePointer() + toRead);
+        docStream->seek(docStream->getFilePointer() + toRead);
     } else {
         // We need to skip chars.  This will slow us down, but still better
-        fieldsStream->skipChars(toRead);
+        docStream->skipChars(toRead);
     }
 }
 
 void FieldsReader::addFieldLazy(const DocumentPtr& doc, const FieldInfoPtr& fi, bool binary, bool compressed, bool tokenize) {
     if (binary) {
-        int32_t toRead = fieldsStream->readVInt();
-        int64_t pointer = fieldsStream->getFilePointer();
+        int32_t toRead = docStream->readVInt();
+        int64_t pointer = docStream->getFilePointer();
         doc->add(newLucene<LazyField>(shared_from_this(), fi->name, Field::STORE_YES, toRead, pointer, binary, compressed));
-        fieldsStream->seek(pointer + toRead);
+        docStream->seek(pointer + toRead);
     } else {
         Field::Store store = Field::STORE_YES;
         Field::Index index = Field::toIndex(fi->isIndexed, tokenize);
@@ -248,21 +387,21 @@ void FieldsReader::addFieldLazy(const DocumentPtr& doc, const FieldInfoPtr& fi,
 
         AbstractFieldPtr f;
         if (compressed) {
-            int32_t toRead = fieldsStream->readVInt();
-            int64_t pointer = fieldsStream->getFilePointer();
+            int32_t toRead = docStream->readVInt();
+            int64_t pointer = docStream->getFilePointer();
             f = newLucene<LazyField>(shared_from_this(), fi->name, store, toRead, pointer, binary, compressed);
             // skip over the part that we aren't loading
-            fieldsStream->seek(pointer + toRead);
+            docStream->seek(pointer + toRead);
             f->setOmitNorms(fi->omitNorms);
             f->setOmitTermFreqAndPositions(fi->omitTermFreqAndPositions);
         } else {
-            int32_t length = fieldsStream->readVInt();
-            int64_t pointer = fieldsStream->getFilePointer();
+            int32_t length = docStream->readVInt();
+            int64_t pointer = docStream->getFilePointer();
             // skip ahead of where we are by the length of what is stored
             if (format >= FieldsWriter::FORMAT_VERSION_UTF8_LENGTH_IN_BYTES) {
-                fieldsStream->seek(pointer + length);
+                docStream->seek(pointer + length);
             } else {
-                fieldsStream->skipChars(length);
+                docStream->skipChars(length);
             }
             f = newLucene<LazyField>(shared_from_this(), fi->name, store, index, termVector, length, pointer, binary, compressed);
             f->setOmitNorms(fi->omitNorms);
@@ -281,7 +420,7 @@ void FieldsReader::addField(const DocumentPtr& doc, const FieldInfoPtr& fi, bool
     // we have a binary stored field, and it may be compressed
     if (binary) {
         try {
-            int32_t toRead = fieldsStream->readVInt();
+            int32_t toRead = docStream->readVInt();
             if (toRead < 0) {
                 return;
             }
@@ -293,7 +432,7 @@ void FieldsReader::addField(const DocumentPtr& doc, const FieldInfoPtr& fi, bool
                     return;
                 }
                 
-                fieldsStream->readBytes(b.get(), 0, b.size());
+                docStream->readBytes(b.get(), 0, b.size());
                 
                 // Create field object outside the doc->add call to allow for null checking
                 FieldPtr field;
@@ -334,7 +473,7 @@ void FieldsReader::addField(const DocumentPtr& doc, const FieldInfoPtr& fi, bool
             AbstractFieldPtr f;
             
             if (compressed) {
-                int32_t toRead = fieldsStream->readVInt();
+                int32_t toRead = docStream->readVInt();
                 if (toRead < 0) {
                     return;
                 }
@@ -346,7 +485,7 @@ void FieldsReader::addField(const DocumentPtr& doc, const FieldInfoPtr& fi, bool
                         return;
                     }
                     
-                    fieldsStream->readBytes(b.get(), 0, b.size());
+                    docStream->readBytes(b.get(), 0, b.size());
                     
                     try {
                         String fieldValue = uncompressString(b);
@@ -363,7 +502,7 @@ void FieldsReader::addField(const DocumentPtr& doc, const FieldInfoPtr& fi, bool
                 }
             } else {
                 try {
-                    String fieldValue = fieldsStream->readString();
+                    String fieldValue = docStream->readString();
                     f = newLucene<Field>(fi->name, fieldValue, store, index, termVector);
                 } catch (...) {
                     f = newLucene<Field>(fi->name, L"", store, index, termVector);
@@ -383,7 +522,7 @@ void FieldsReader::addField(const DocumentPtr& doc, const FieldInfoPtr& fi, bool
 }
 
 int32_t FieldsReader::addFieldSize(const DocumentPtr& doc, const FieldInfoPtr& fi, bool binary, bool compressed) {
-    int32_t size = fieldsStream->readVInt();
+    int32_t size = docStream->readVInt();
     int32_t bytesize = (binary || compressed) ? size : 2 * size;
     ByteArray sizebytes(ByteArray::newInstance(4));
     sizebytes[0] = (uint8_t)MiscUtils::unsignedShift(bytesize, 24);
@@ -10,6 +10,11 @@
 #include "Directory.h"
 #include "IndexOutput.h"
 #include "RAMOutputStream.h"
+#include "RAMInputStream.h"
+#include "RAMFile.h"
+#include "FieldsReader.h"
+#include "IndexWriter.h"
+#include "CompressionTools.h"
 #include "FieldInfo.h"
 #include "FieldInfos.h"
 #include "Fieldable.h"
@@ -25,20 +30,37 @@ const uint8_t FieldsWriter::FIELD_IS_COMPRESSED = 0x4;
 const int32_t FieldsWriter::FORMAT = 0; // Original format
 const int32_t FieldsWriter::FORMAT_VERSION_UTF8_LENGTH_IN_BYTES = 1; // Changed strings to UTF8
 const int32_t FieldsWriter::FORMAT_LUCENE_3_0_NO_COMPRESSED_FIELDS = 2; // Lucene 3.0: Removal of compressed fields
+const int32_t FieldsWriter::FORMAT_COMPRESSED_CHUNKS = 3; // Documents compressed together in chunks
 
 // NOTE: if you introduce a new format, make it 1 higher than the current one, and always change this if you
 // switch to a new format!
-const int32_t FieldsWriter::FORMAT_CURRENT = FieldsWriter::FORMAT_LUCENE_3_0_NO_COMPRESSED_FIELDS;
+const int32_t FieldsWriter::FORMAT_CURRENT = FieldsWriter::FORMAT_COMPRESSED_CHUNKS;
 
-FieldsWriter::FieldsWriter(const DirectoryPtr& d, const String& segment, const FieldInfosPtr& fn) {
+const int32_t FieldsWriter::CHUNK_SIZE = 16384;
+const int32_t FieldsWriter::MAX_CHUNK_DOCS = 128;
+const int32_t FieldsWriter::CHUNK_DOC_BITS = 8;
+
+FieldsWriter::FieldsWriter(const DirectoryPtr& d, const String& segment, const FieldInfosPtr& fn, int32_t compression) {
     fieldInfos = fn;
+    this->compression = compression;
+    chunkDocStart = 0;
+    if (compression != IndexWriter::STORED_FIELDS_UNCOMPRESSED) {
+        chunkFile = newLucene<RAMFile>();
+        chunkStream = newLucene<RAMOutputStream>(chunkFile);
+        chunkDocLengths = Collection<int32_t>::newInstance();
+    }
+    // uncompressed stored fields keep the previous format so that older readers can still read them
+    int32_t format = compression == IndexWriter::STORED_FIELDS_UNCOMPRESSED ? FORMAT_LUCENE_3_0_NO_COMPRESSED_FIELDS : FORMAT_COMPRESSED_CHUNKS;
 
     bool success = false;
     String fieldsName(segment + L"." + IndexFileNames::FIELDS_EXTENSION());
     LuceneException finally;
     try {
         fieldsStream = d->createOutput(fieldsName);
-        fieldsStream->writeInt(FORMAT_CURRENT);
+        fieldsStream->writeInt(format);
+        if (compression != IndexWriter::STORED_FIELDS_UNCOMPRESSED) {
+            fieldsStream->writeByte((uint8_t)compression);
+        }
         success = true;
     } catch (LuceneException& e) {
         finally = e;
@@ -57,7 +79,7 @@ FieldsWriter::FieldsWriter(const DirectoryPtr& d, const String& segment, const F
     String indexName(segment + L"." + IndexFileNames::FIELDS_INDEX_EXTENSION());
     try {
         indexStream = d->createOutput(indexName);
-        indexStream->writeInt(FORMAT_CURRENT);
+        indexStream->writeInt(format);
         success = true;
     } catch (LuceneException& e) {
         finally = e;
@@ -81,6 +103,8 @@ FieldsWriter::FieldsWriter(const IndexOutputPtr& fdx, const IndexOutputPtr& fdt,
     fieldsStream = fdt;
     indexStream = fdx;
     doClose = false;
+    compression = IndexWriter::STORED_FIELDS_UNCOMPRESSED;
+    chunkDocStart = 0;
 }
 
 FieldsWriter::~FieldsWriter() {
@@ -90,19 +114,77 @@ void FieldsWriter::setFieldsStream(const IndexOutputPtr& stream) {
     this->fieldsStream = stream;
 }
 
+int32_t FieldsWriter::getCompression() {
+    return compression;
+}
+
+IndexOutputPtr FieldsWriter::startDocument() {
+    if (compression == IndexWriter::STORED_FIELDS_UNCOMPRESSED) {
+        indexStream->writeLong(fieldsStream->getFilePointer());
+        return fieldsStream;
+    }
+    // the chunk is written at the current end of the fields stream once it is full
+    indexStream->writeLong((fieldsStream->getFilePointer() << CHUNK_DOC_BITS) | chunkDocLengths.size());
+    chunkDocStart = chunkStream->getFilePointer();
+    return chunkStream;
+}
+
+void FieldsWriter::finishDocument() {
+    if (compression != IndexWriter::STORED_FIELDS_UNCOMPRESSED) {
+        int64_t chunkLength = chunkStream->getFilePointer();
+        chunkDocLengths.add((int32_t)(chunkLength - chunkDocStart));
+        if (chunkLength >= CHUNK_SIZE || chunkDocLengths.size() == MAX_CHUNK_DOCS) {
+            flushChunk();
+        }
+    }
+}
+
+void FieldsWriter::flushChunk() {
+    if (compression == IndexWriter::STORED_FIELDS_UNCOMPRESSED || chunkDocLengths.empty()) {
+        return;
+    }
+    chunkStream->flush();
+    int32_t length = (int32_t)chunkStream->getFilePointer();
+    ByteArray bytes(ByteArray::newInstance(std::max(length, 1)));
+    IndexInputPtr input(newLucene<RAMInputStream>(chunkFile));
+    input->readBytes(bytes.get(), 0, length);
+    input->close();
+
+    ByteArray compressed;
+    if (compression == IndexWriter::STORED_FIELDS_COMPRESS_FAST) {
+        compressed = CompressionTools::compressFast(bytes.get(), 0, length);
+    } else {
+        compressed = CompressionTools::compress(bytes.get(), 0, length);
+    }
+
+    fieldsStream->writeVInt(chunkDocLengths.size());
+    for (Collection<int32_t>::iterator docLength = chunkDocLengths.begin(); docLength != chunkDocLengths.end(); ++docLength) {
+        fieldsStream->writeVInt(*docLength);
+    }
+    fieldsStream->writeByte((uint8_t)compression);
+    fieldsStream->writeVInt(compressed.size());
+    fieldsStream->writeBytes(compressed.get(), 0, compressed.size());
+
+    chunkStream->reset();
+    chunkDocLengths.clear();
+}
+
 void FieldsWriter::flushDocument(int32_t numStoredFields, const RAMOutputStreamPtr& buffer) {
     TestScope testScope(L"FieldsWriter", L"flushDocument");
-    indexStream->writeLong(fieldsStream->getFilePointer());
-    fieldsStream->writeVInt(numStoredFields);
-    buffer->writeTo(fieldsStream);
+    IndexOutputPtr stream(startDocument());
+    stream->writeVInt(numStoredFields);
+    buffer->writeTo(stream);
+    finishDocument();
 }
 
 void FieldsWriter::skipDocument() {
-    indexStream->writeLong(fieldsStream->getFilePointer());
-    fieldsStream->writeVInt(0);
+    startDocument()->writeVInt(0);
+    finishDocument();
 }
 
 void FieldsWriter::flush() {
+    // readers may open the segment once it is flushed, so its documents must not stay buffered
+    flushChunk();
     indexStream->flush();
     fieldsStream->flush();
 }
@@ -112,6 +194,7 @@ void FieldsWriter::close() {
         LuceneException finally;
         if (fieldsStream) {
             try {
+                flushChunk();
                 fieldsStream->close();
             } catch (LuceneException& e) {
                 finally = e;
@@ -133,7 +216,11 @@ void FieldsWriter::close() {
 }
 
 void FieldsWriter::writeField(const FieldInfoPtr& fi, const FieldablePtr& field) {
-    fieldsStream->writeVInt(fi->number);
+    writeField(fieldsStream, fi, field);
+}
+
+void FieldsWriter::writeField(const IndexOutputPtr& stream, const FieldInfoPtr& fi, const FieldablePtr& field) {
+    stream->writeVInt(fi->number);
     uint8_t bits = 0;
     if (field->isTokenized()) {
         bits |= FIELD_IS_TOKENIZED;
@@ -142,21 +229,28 @@ void FieldsWriter::writeField(const FieldInfoPtr& fi, const FieldablePtr& field)
         bits |= FIELD_IS_BINARY;
     }
 
-    fieldsStream->writeByte(bits);
+    stream->writeByte(bits);
 
     if (field->isBinary()) {
         ByteArray data(field->getBinaryValue());
         int32_t len = field->getBinaryLength();
         int32_t offset = field->getBinaryOffset();
 
-        fieldsStream->writeVInt(len);
-        fieldsStream->writeBytes(data.get(), offset, len);
+        stream->writeVInt(len);
+        stream->writeBytes(data.get(), offset, len);
     } else {
-        fieldsStream->writeString(field->stringValue());
+        stream->writeString(field->stringValue());
     }
 }
 
 void FieldsWriter::addRawDocuments(const IndexInputPtr& stream, Collection<int32_t> lengths, int32_t numDocs) {
+    if (compression != IndexWriter::STORED_FIELDS_UNCOMPRESSED) {
+        for (int32_t i = 0; i < numDocs; ++i) {
+            startDocument()->copyBytes(stream, lengths[i]);
+            finishDocument();
+        }
+        return;
+    }
     int64_t position = fieldsStream->getFilePointer();
     int64_t start = position;
     for (int32_t i = 0; i < numDocs; ++i) {
@@ -167,8 +261,36 @@ void FieldsWriter::addRawDocuments(const IndexInputPtr& stream, Collection<int32
     BOOST_ASSERT(fieldsStream->getFilePointer() == position);
 }
 
+void FieldsWriter::addRawDocuments(const FieldsReaderPtr& reader, Collection<int32_t> lengths, int32_t startDocID, int32_t numDocs) {
+    if (reader->getCompression() == IndexWriter::STORED_FIELDS_UNCOMPRESSED) {
+        addRawDocuments(reader->rawDocs(lengths, startDocID, numDocs), lengths, numDocs);
+        return;
+    }
+    int32_t end = startDocID + numDocs;
+    for (int32_t docID = startDocID; docID < end;) {
+        int32_t docInChunk = 0;
+        int32_t chunkDocs = 0;
+        int64_t chunkLength = 0;
+        IndexInputPtr chunk(reader->rawChunk(docID, docInChunk, chunkDocs, chunkLength));
+        if (docInChunk == 0 && docID + chunkDocs <= end && reader->getCompression() == compression && chunkDocLengths.empty()) {
+            // copy the whole chunk as it is
+            int64_t position = fieldsStream->getFilePointer();
+            for (int32_t i = 0; i < chunkDocs; ++i) {
+                indexStream->writeLong((position << CHUNK_DOC_BITS) | i);
+            }
+            fieldsStream->copyBytes(chunk, chunkLength);
+            docID += chunkDocs;
+        } else {
+            // the documents of a chunk are contiguous once it is decompressed
+            int32_t count = std::min(end - docID, chunkDocs - docInChunk);
+            addRawDocuments(reader->rawDocs(lengths, docID, count), lengths, count);
+            docID += count;
+        }
+    }
+}
+
 void FieldsWriter::addDocument(const DocumentPtr& doc) {
-    indexStream->writeLong(fieldsStream->getFilePointer());
+    IndexOutputPtr stream(startDocument());
 
     int32_t storedCount = 0;
     Collection<FieldablePtr> fields(doc->getFields());
@@ -177,13 +299,15 @@ void FieldsWriter::addDocument(const DocumentPtr& doc) {
             ++storedCount;
         }
     }
-    fieldsStream->writeVInt(storedCount);
+    stream->writeVInt(storedCount);
 
     for (Collection<FieldablePtr>::iterator field = fields.begin(); field != fields.end(); ++field) {
         if ((*field)->isStored()) {
-            writeField(fieldInfos->fieldInfo((*field)->name()), *field);
+            writeField(stream, fieldInfos->fieldInfo((*field)->name()), *field);
         }
     }
+
+    finishDocument();
 }
 
 }
@@ -0,0 +1,140 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "ForUtil.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
+
+namespace Lucene {
+
+const int32_t ForUtil::BLOCK_SIZE = 128;
+const int32_t ForUtil::LANES = 4;
+
+/// Values held by each lane of a block.
+static const int32_t LANE_VALUES = 32;
+
+/// Largest number of bytes following the header byte of a block.
+static const int32_t MAX_ENCODED_SIZE = 512;
+
+/// Unpack the 32 values of every lane, the number of bits is a template parameter so that shifts and masks
+/// are constants and the inner loop over the lanes can be vectorized.
+template <int32_t BITS>
+static void unpackLanes(const uint32_t* words, int32_t* values) {
+    const uint32_t mask = BITS == 32 ? 0xffffffff : (((uint32_t)1 << BITS) - 1);
+    for (int32_t j = 0; j < LANE_VALUES; ++j) {
+        const int32_t bit = j * BITS;
+        const int32_t word = (bit >> 5) * 4;
+        const int32_t shift = bit & 31;
+        for (int32_t lane = 0; lane < 4; ++lane) {
+            uint32_t value = words[word + lane] >> shift;
+            if (shift + BITS > 32) {
+                value |= words[word + 4 + lane] << ((32 - shift) & 31);
+            }
+            values[j * 4 + lane] = (int32_t)(value & mask);
+        }
+    }
+}
+
+typedef void (*unpack_t)(const uint32_t*, int32_t*);
+
+static const unpack_t unpackers[] = {
+    NULL, unpackLanes<1>, unpackLanes<2>, unpackLanes<3>, unpackLanes<4>, unpackLanes<5>, unpackLanes<6>,
+    unpackLanes<7>, unpackLanes<8>, unpackLanes<9>, unpackLanes<10>, unpackLanes<11>, unpackLanes<12>,
+    unpackLanes<13>, unpackLanes<14>, unpackLanes<15>, unpackLanes<16>, unpackLanes<17>, unpackLanes<18>,
+    unpackLanes<19>, unpackLanes<20>, unpackLanes<21>, unpackLanes<22>, unpackLanes<23>, unpackLanes<24>,
+    unpackLanes<25>, unpackLanes<26>, unpackLanes<27>, unpackLanes<28>, unpackLanes<29>, unpackLanes<30>,
+    unpackLanes<31>, unpackLanes<32>
+};
+
+ForUtil::~ForUtil() {
+}
+
+int32_t ForUtil::bitsRequired(const int32_t* values) {
+    uint32_t bits = 0;
+    for (int32_t i = 0; i < BLOCK_SIZE; ++i) {
+        bits |= (uint32_t)values[i];
+    }
+    int32_t numBits = 0;
+    while (bits != 0) {
+        bits >>= 1;
+        ++numBits;
+    }
+    return numBits;
+}
+
+int32_t ForUtil::encodedSize(int32_t numBits) {
+    return numBits * BLOCK_SIZE / 8;
+}
+
+void ForUtil::pack(const int32_t* values, int32_t numBits, uint8_t* packed) {
+    uint32_t words[MAX_ENCODED_SIZE / 4];
+    int32_t numWords = numBits * LANES;
+    std::fill(words, words + numWords, 0);
+    for (int32_t j = 0; j < LANE_VALUES; ++j) {
+        int32_t bit = j * numBits;
+        int32_t word = (bit >> 5) * LANES;
+        int32_t shift = bit & 31;
+        for (int32_t lane = 0; lane < LANES; ++lane) {
+            uint32_t value = (uint32_t)values[j * LANES + lane];
+            words[word + lane] |= value << shift;
+            if (shift + numBits > 32) {
+                words[word + LANES + lane] |= value >> (32 - shift);
+            }
+        }
+    }
+    // words are stored little-endian regardless of platform
+    for (int32_t i = 0; i < numWords; ++i) {
+        packed[i * 4] = (uint8_t)words[i];
+        packed[i * 4 + 1] = (uint8_t)(words[i] >> 8);
+        packed[i * 4 + 2] = (uint8_t)(words[i] >> 16);
+        packed[i * 4 + 3] = (uint8_t)(words[i] >> 24);
+    }
+}
+
+void ForUtil::unpack(const uint8_t* packed, int32_t numBits, int32_t* values) {
+    if (numBits == 0) {
+        std::fill(values, values + BLOCK_SIZE, 0);
+        return;
+    }
+    uint32_t words[MAX_ENCODED_SIZE / 4];
+    int32_t numWords = numBits * LANES;
+    for (int32_t i = 0; i < numWords; ++i) {
+        words[i] = (uint32_t)packed[i * 4] | ((uint32_t)packed[i * 4 + 1] << 8) | ((uint32_t)packed[i * 4 + 2] << 16) | ((uint32_t)packed[i * 4 + 3] << 24);
+    }
+    unpackers[numBits](words, values);
+}
+
+void ForUtil::writeBlock(const IndexOutputPtr& out, const int32_t* values) {
+    uint8_t packed[MAX_ENCODED_SIZE];
+    int32_t numBits = bitsRequired(values);
+    out->writeByte((uint8_t)numBits);
+    if (numBits > 0) {
+        pack(values, numBits, packed);
+        out->writeBytes(packed, encodedSize(numBits));
+    }
+}
+
+void ForUtil::readBlock(IndexInput* in, int32_t* values) {
+    uint8_t packed[MAX_ENCODED_SIZE];
+    int32_t numBits = in->readByte();
+    if (numBits > 32) {
+        boost::throw_exception(CorruptIndexException(L"Invalid number of bits per value in postings block"));
+    }
+    if (numBits > 0) {
+        in->readBytes(packed, 0, encodedSize(numBits));
+    }
+    unpack(packed, numBits, values);
+}
+
+void ForUtil::skipBlock(IndexInput* in) {
+    int32_t numBits = in->readByte();
+    if (numBits > 0) {
+        in->seek(in->getFilePointer() + encodedSize(numBits));
+    }
+}
+
+}
@@ -14,9 +14,11 @@
 #include "Directory.h"
 #include "TermInfosWriter.h"
 #include "DefaultSkipListWriter.h"
+#include "CompetitiveImpactAccumulator.h"
 #include "FieldInfo.h"
 #include "IndexOutput.h"
 #include "TermInfo.h"
+#include "ForUtil.h"
 #include "MiscUtils.h"
 #include "UnicodeUtils.h"
 #include "StringUtils.h"
@@ -42,6 +44,19 @@ FormatPostingsDocsWriter::FormatPostingsDocsWriter(const SegmentWriteStatePtr& s
     skipListWriter = parentPostings->skipListWriter;
     skipListWriter->setFreqOutput(out);
 
+    blockPostings = (parentPostings->termsOut->postingsBlockSize != 0);
+    bufferUpto = 0;
+    if (blockPostings) {
+        docDeltaBuffer = IntArray::newInstance(ForUtil::BLOCK_SIZE);
+        freqBuffer = IntArray::newInstance(ForUtil::BLOCK_SIZE);
+    }
+
+    skipImpacts = parentPostings->termsOut->skipImpacts;
+    if (skipImpacts) {
+        impactsSinceSkip = newLucene<CompetitiveImpactAccumulator>();
+        termImpacts = newLucene<CompetitiveImpactAccumulator>();
+    }
+
     termInfo = newLucene<TermInfo>();
     utf8 = newLucene<UTF8Result>();
 }
@@ -60,16 +75,44 @@ void FormatPostingsDocsWriter::setField(const FieldInfoPtr& fieldInfo) {
     posWriter->setField(fieldInfo);
 }
 
-FormatPostingsPositionsConsumerPtr FormatPostingsDocsWriter::addDoc(int32_t docID, int32_t termDocFreq) {
+FormatPostingsPositionsConsumerPtr FormatPostingsDocsWriter::addDoc(int32_t docID, int32_t termDocFreq, uint8_t norm) {
     int32_t delta = docID - lastDocID;
 
     if (docID < 0 || (df > 0 && delta <= 0)) {
         boost::throw_exception(CorruptIndexException(L"docs out of order (" + StringUtils::toString(docID) + L" <= " + StringUtils::toString(lastDocID) + L" )"));
     }
 
+    int32_t freq = omitTermFreqAndPositions ? 1 : termDocFreq;
+    if (skipImpacts) {
+        termImpacts->add(freq, norm);
+    }
+
+    if (blockPostings) {
+        // the previous doc is complete, including its positions, so a full block can now be written
+        if (bufferUpto == ForUtil::BLOCK_SIZE) {
+            flushBlock();
+        }
+        if (skipImpacts) {
+            impactsSinceSkip->add(freq, norm);
+        }
+        ++df;
+        BOOST_ASSERT(docID < totalNumDocs);
+        lastDocID = docID;
+        docDeltaBuffer[bufferUpto] = delta;
+        freqBuffer[bufferUpto] = omitTermFreqAndPositions ? 0 : termDocFreq - 1;
+        ++bufferUpto;
+        return posWriter;
+    }
+
     if ((++df % skipInterval) == 0) {
-        skipListWriter->setSkipData(lastDocID, storePayloads, posWriter->lastPayloadLength);
+        skipListWriter->setSkipData(lastDocID, storePayloads, posWriter->lastPayloadLength, impactsSinceSkip);
         skipListWriter->bufferSkip(df);
+        if (skipImpacts) {
+            impactsSinceSkip->clear();
+        }
+    }
+    if (skipImpacts) {
+        impactsSinceSkip->add(freq, norm);
     }
 
     BOOST_ASSERT(docID < totalNumDocs);
@@ -87,7 +130,46 @@ FormatPostingsPositionsConsumerPtr FormatPostingsDocsWriter::addDoc(int32_t docI
     return posWriter;
 }
 
+void FormatPostingsDocsWriter::flushBlock() {
+    ForUtil::writeBlock(out, docDeltaBuffer.get());
+    if (!omitTermFreqAndPositions) {
+        ForUtil::writeBlock(out, freqBuffer.get());
+    }
+    bufferUpto = 0;
+
+    // skip points are block aligned: each one follows a block and the positions of its docs
+    skipListWriter->setSkipData(lastDocID, storePayloads, posWriter->lastPayloadLength, impactsSinceSkip);
+    skipListWriter->bufferSkip(df);
+    if (skipImpacts) {
+        impactsSinceSkip->clear();
+    }
+}
+
+void FormatPostingsDocsWriter::flushTail() {
+    for (int32_t i = 0; i < bufferUpto; ++i) {
+        int32_t delta = docDeltaBuffer[i];
+        if (omitTermFreqAndPositions) {
+            out->writeVInt(delta);
+        } else if (freqBuffer[i] == 0) {
+            out->writeVInt((delta << 1) | 1);
+        } else {
+            out->writeVInt(delta << 1);
+            out->writeVInt(freqBuffer[i] + 1);
+        }
+    }
+    bufferUpto = 0;
+}
+
 void FormatPostingsDocsWriter::finish() {
+    if (blockPostings) {
+        if (bufferUpto == ForUtil::BLOCK_SIZE) {
+            flushBlock();
+        } else {
+            flushTail();
+        }
+    }
+
+    skipListWriter->setTermImpacts(termImpacts);
     int64_t skipPointer = skipListWriter->writeSkip(out);
     FormatPostingsTermsWriterPtr parent(_parent);
     termInfo->set(df, parent->freqStart, parent->proxStart, (int32_t)(skipPointer - parent->freqStart));
@@ -100,6 +182,10 @@ void FormatPostingsDocsWriter::finish() {
 
     lastDocID = 0;
     df = 0;
+    if (skipImpacts) {
+        impactsSinceSkip->clear();
+        termImpacts->clear();
+    }
 }
 
 void FormatPostingsDocsWriter::close() {
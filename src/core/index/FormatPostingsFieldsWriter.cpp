@@ -11,6 +11,7 @@
 #include "TermInfosWriter.h"
 #include "IndexFileNames.h"
 #include "DefaultSkipListWriter.h"
+#include "ForUtil.h"
 
 namespace Lucene {
 
@@ -20,9 +21,9 @@ FormatPostingsFieldsWriter::FormatPostingsFieldsWriter(const SegmentWriteStatePt
     totalNumDocs = state->numDocs;
     this->state = state;
     this->fieldInfos = fieldInfos;
-    termsOut = newLucene<TermInfosWriter>(dir, segment, fieldInfos, state->termIndexInterval);
+    termsOut = newLucene<TermInfosWriter>(dir, segment, fieldInfos, state->termIndexInterval, state->blockPostings ? ForUtil::BLOCK_SIZE : 0, state->skipImpacts);
 
-    skipListWriter = newLucene<DefaultSkipListWriter>(termsOut->skipInterval, termsOut->maxSkipLevels, totalNumDocs, IndexOutputPtr(), IndexOutputPtr());
+    skipListWriter = newLucene<DefaultSkipListWriter>(termsOut->skipInterval, termsOut->maxSkipLevels, totalNumDocs, IndexOutputPtr(), IndexOutputPtr(), termsOut->skipImpacts);
 
     state->flushedFiles.add(state->segmentFileName(IndexFileNames::TERMS_EXTENSION()));
     state->flushedFiles.add(state->segmentFileName(IndexFileNames::TERMS_INDEX_EXTENSION()));
@@ -11,6 +11,8 @@
 #include "FreqProxTermsWriter.h"
 #include "TermsHashPerThread.h"
 #include "TermsHashPerField.h"
+#include "DocInverterPerField.h"
+#include "NormsWriterPerField.h"
 #include "ByteSliceReader.h"
 #include "DocumentsWriter.h"
 #include "CharBlockPool.h"
@@ -34,6 +36,14 @@ FreqProxFieldMergeState::FreqProxFieldMergeState(const FreqProxTermsWriterPerFie
     TermsHashPerFieldPtr termsHashPerField(field->_termsHashPerField);
     this->numPostings = termsHashPerField->numPostings;
     this->postings = termsHashPerField->sortPostings();
+
+    // the norms are flushed after the postings, so they are still buffered
+    if (!field->fieldInfo->omitNorms) {
+        DocInverterPerFieldPtr docInverterPerField(termsHashPerField->_docInverterPerField.lock());
+        if (docInverterPerField) {
+            normsWriter = boost::dynamic_pointer_cast<NormsWriterPerField>(docInverterPerField->endConsumer);
+        }
+    }
 }
 
 FreqProxFieldMergeState::~FreqProxFieldMergeState() {
@@ -97,4 +107,16 @@ bool FreqProxFieldMergeState::nextDoc() {
     return true;
 }
 
+uint8_t FreqProxFieldMergeState::norm() {
+    if (!normsWriter) {
+        return 0;
+    }
+    // the docIDs are buffered in increasing order; docs that hit an exception before their norm was
+    // computed are deleted, any norm will do
+    Collection<int32_t>::iterator begin(normsWriter->docIDs.begin());
+    Collection<int32_t>::iterator end(begin + normsWriter->upto);
+    Collection<int32_t>::iterator doc(std::lower_bound(begin, end, docID));
+    return (doc == end || *doc != docID) ? 0 : normsWriter->norms[doc - begin];
+}
+
 }
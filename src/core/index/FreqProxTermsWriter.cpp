@@ -24,6 +24,7 @@
 #include "DocumentsWriter.h"
 #include "UTF8Stream.h"
 #include "TestPoint.h"
+#include "SegmentWriteState.h"
 
 namespace Lucene {
 
@@ -116,7 +117,7 @@ void FreqProxTermsWriter::flush(MapTermsHashConsumerPerThreadCollectionTermsHash
         }
 
         // If this field has postings then add them to the segment
-        appendPostings(fields, consumer);
+        appendPostings(fields, consumer, state->skipImpacts);
 
         for (int32_t i = 0; i < fields.size(); ++i) {
             TermsHashPerFieldPtr perField(fields[i]->_termsHashPerField);
@@ -136,7 +137,7 @@ void FreqProxTermsWriter::flush(MapTermsHashConsumerPerThreadCollectionTermsHash
     consumer->finish();
 }
 
-void FreqProxTermsWriter::appendPostings(Collection<FreqProxTermsWriterPerFieldPtr> fields, const FormatPostingsFieldsConsumerPtr& consumer) {
+void FreqProxTermsWriter::appendPostings(Collection<FreqProxTermsWriterPerFieldPtr> fields, const FormatPostingsFieldsConsumerPtr& consumer, bool skipImpacts) {
     TestScope testScope(L"FreqProxTermsWriter", L"appendPostings");
     int32_t numFields = fields.size();
 
@@ -191,7 +192,10 @@ void FreqProxTermsWriter::appendPostings(Collection<FreqProxTermsWriterPerFieldP
 
             int32_t termDocFreq = minState->termFreq;
 
-            FormatPostingsPositionsConsumerPtr posConsumer(docConsumer->addDoc(minState->docID, termDocFreq));
+            // the norms are only needed for the impacts in the skip data
+            uint8_t norm = skipImpacts ? minState->norm() : 0;
+
+            FormatPostingsPositionsConsumerPtr posConsumer(docConsumer->addDoc(minState->docID, termDocFreq, norm));
 
             ByteSliceReaderPtr prox(minState->prox);
 
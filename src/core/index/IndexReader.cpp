@@ -181,6 +181,11 @@ bool IndexReader::hasChanges() {
     return _hasChanges;
 }
 
+NumericDocValuesPtr IndexReader::getNumericDocValues(const String& field) {
+    ensureOpen();
+    return NumericDocValuesPtr();
+}
+
 bool IndexReader::hasNorms(const String& field) {
     // backward compatible implementation.
     // SegmentReader has an efficient implementation.
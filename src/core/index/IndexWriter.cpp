@@ -69,6 +69,10 @@ const int32_t IndexWriter::MaxFieldLengthUNLIMITED = INT_MAX;
 /// Sets the maximum field length to {@link #DEFAULT_MAX_FIELD_LENGTH}
 const int32_t IndexWriter::MaxFieldLengthLIMITED = IndexWriter::DEFAULT_MAX_FIELD_LENGTH;
 
+const int32_t IndexWriter::STORED_FIELDS_UNCOMPRESSED = 0;
+const int32_t IndexWriter::STORED_FIELDS_COMPRESS_FAST = 1;
+const int32_t IndexWriter::STORED_FIELDS_COMPRESS_HIGH = 2;
+
 IndexWriter::IndexWriter(const DirectoryPtr& d, const AnalyzerPtr& a, bool create, int32_t mfl) {
     this->directory = d;
     this->analyzer = a;
@@ -150,12 +154,19 @@ void IndexWriter::initialize() {
     mergeGen = 0;
     flushCount = 0;
     flushDeletesCount = 0;
+    readerCount = 0;
+    lastReaderLatency = 0;
+    totalReaderLatency = 0;
+    warmedSegments = HashSet<String>::newInstance();
     localFlushedDocCount = 0;
     pendingCommitChangeCount = 0;
     mergePolicy = newLucene<LogByteSizeMergePolicy>(shared_from_this());
     mergeScheduler = newLucene<ConcurrentMergeScheduler>();
     similarity = Similarity::getDefault();
     termIndexInterval = DEFAULT_TERM_INDEX_INTERVAL;
+    useBlockPostings = false;
+    useSkipImpacts = false;
+    storedFieldsCompression = STORED_FIELDS_UNCOMPRESSED;
     commitLock  = newInstance<Synchronize>();
 
     if (!indexingChain) {
@@ -287,18 +298,80 @@ IndexReaderPtr IndexWriter::getReader(int32_t termInfosIndexDivisor) {
     // this method is called
     poolReaders = true;
 
+    int64_t start = MiscUtils::currentTimeMillis();
+
     // Prevent segmentInfos from changing while opening the reader; in theory we could do similar retry logic,
     // just like we do when loading segments_N
     IndexReaderPtr r;
+    Collection<IndexReaderPtr> newSegments(Collection<IndexReaderPtr>::newInstance());
     {
         SyncLock syncLock(this);
         flush(false, true, true);
         r = newLucene<ReadOnlyDirectoryReader>(shared_from_this(), segmentInfos, termInfosIndexDivisor);
+
+        if (mergedSegmentWarmer) {
+            // forget segments that were merged away, and find the ones not warmed yet
+            HashSet<String> liveWarmedSegments(HashSet<String>::newInstance());
+            Collection<IndexReaderPtr> subReaders(r->getSequentialSubReaders());
+            for (Collection<IndexReaderPtr>::iterator subReader = subReaders.begin(); subReader != subReaders.end(); ++subReader) {
+                String segment(boost::static_pointer_cast<SegmentReader>(*subReader)->getSegmentName());
+                if (warmedSegments.contains(segment)) {
+                    liveWarmedSegments.add(segment);
+                } else {
+                    newSegments.add(*subReader);
+                }
+            }
+            warmedSegments = liveWarmedSegments;
+        }
     }
+
+    // warm new segments outside the lock, so that indexing can go on meanwhile; a segment only counts
+    // as warmed once its warm completed, so one that failed is warmed again by the next reader
+    LuceneException finally;
+    try {
+        for (Collection<IndexReaderPtr>::iterator segment = newSegments.begin(); segment != newSegments.end(); ++segment) {
+            mergedSegmentWarmer->warm(*segment);
+            SyncLock syncLock(this);
+            warmedSegments.add(boost::static_pointer_cast<SegmentReader>(*segment)->getSegmentName());
+        }
+    } catch (LuceneException& e) {
+        finally = e;
+    }
+    if (!finally.isNull()) {
+        r->close();
+        finally.throwException();
+    }
+
     maybeMerge();
+
+    int64_t latency = MiscUtils::currentTimeMillis() - start;
+    {
+        SyncLock syncLock(this);
+        ++readerCount;
+        lastReaderLatency = latency;
+        totalReaderLatency += latency;
+    }
+    if (infoStream) {
+        message(L"getReader took " + StringUtils::toString(latency) + L" msec, warmed " + StringUtils::toString(newSegments.size()) + L" new segments");
+    }
     return r;
 }
 
+int32_t IndexWriter::getReaderCount() {
+    SyncLock syncLock(this);
+    return readerCount;
+}
+
+int64_t IndexWriter::getLastReaderLatency() {
+    SyncLock syncLock(this);
+    return lastReaderLatency;
+}
+
+int64_t IndexWriter::getTotalReaderLatency() {
+    SyncLock syncLock(this);
+    return totalReaderLatency;
+}
+
 int32_t IndexWriter::numDeletedDocs(const SegmentInfoPtr& info) {
     SegmentReaderPtr reader(readerPool->getIfExists(info));
     int32_t deletedDocs = 0;
@@ -436,6 +509,43 @@ int32_t IndexWriter::getTermIndexInterval() {
     return termIndexInterval;
 }
 
+void IndexWriter::setUseBlockPostings(bool useBlockPostings) {
+    ensureOpen();
+    this->useBlockPostings = useBlockPostings;
+}
+
+bool IndexWriter::getUseBlockPostings() {
+    // We pass false because this method is called by SegmentMerger while we are in the process of closing
+    ensureOpen(false);
+    return useBlockPostings;
+}
+
+void IndexWriter::setUseSkipImpacts(bool useSkipImpacts) {
+    ensureOpen();
+    this->useSkipImpacts = useSkipImpacts;
+}
+
+bool IndexWriter::getUseSkipImpacts() {
+    // We pass false because this method is called by SegmentMerger while we are in the process of closing
+    ensureOpen(false);
+    return useSkipImpacts;
+}
+
+void IndexWriter::setStoredFieldsCompression(int32_t compression) {
+    ensureOpen();
+    if (compression < STORED_FIELDS_UNCOMPRESSED || compression > STORED_FIELDS_COMPRESS_HIGH) {
+        boost::throw_exception(IllegalArgumentException(L"unknown stored fields compression: " + StringUtils::toString(compression)));
+    }
+    this->storedFieldsCompression = compression;
+    docWriter->setStoredFieldsCompression(compression);
+}
+
+int32_t IndexWriter::getStoredFieldsCompression() {
+    // We pass false because this method is called by SegmentMerger while we are in the process of closing
+    ensureOpen(false);
+    return storedFieldsCompression;
+}
+
 void IndexWriter::setRollbackSegmentInfos(const SegmentInfosPtr& infos) {
     SyncLock syncLock(this);
     rollbackSegmentInfos = boost::dynamic_pointer_cast<SegmentInfos>(infos->clone());
@@ -1173,14 +1283,16 @@ void IndexWriter::expungeDeletes(bool doWait) {
     {
         SyncLock syncLock(this);
         spec = mergePolicy->findMergesToExpungeDeletes(segmentInfos);
-        for (Collection<OneMergePtr>::iterator merge = spec->merges.begin(); merge != spec->merges.end(); ++merge) {
-            registerMerge(*merge);
+        if (spec) {
+            for (Collection<OneMergePtr>::iterator merge = spec->merges.begin(); merge != spec->merges.end(); ++merge) {
+                registerMerge(*merge);
+            }
         }
     }
 
     mergeScheduler->merge(shared_from_this());
 
-    if (doWait) {
+    if (spec && doWait) {
         {
             SyncLock syncLock(this);
             bool running = true;
@@ -1278,6 +1390,12 @@ OneMergePtr IndexWriter::getNextMerge() {
     }
 }
 
+SetSegmentInfo IndexWriter::getMergingSegments() {
+    SyncLock syncLock(this);
+    // a copy, as merges register and release their segments while the caller reads it
+    return SetSegmentInfo::newInstance(mergingSegments.begin(), mergingSegments.end());
+}
+
 OneMergePtr IndexWriter::getNextExternalMerge() {
     SyncLock syncLock(this);
     if (pendingMerges.empty()) {
@@ -2275,28 +2393,14 @@ int32_t IndexWriter::numRamDocs() {
     return docWriter->getNumDocsInRAM();
 }
 
-int32_t IndexWriter::ensureContiguousMerge(const OneMergePtr& merge) {
-    int32_t first = segmentInfos->find(merge->segments->info(0));
-    if (first == -1) {
-        boost::throw_exception(MergeException(L"Could not find segment " + merge->segments->info(0)->name + L" in current index " + segString()));
-    }
-
-    int32_t numSegments = segmentInfos->size();
+void IndexWriter::ensureValidMerge(const OneMergePtr& merge) {
     int32_t numSegmentsToMerge = merge->segments->size();
-
     for (int32_t i = 0; i < numSegmentsToMerge; ++i) {
         SegmentInfoPtr info(merge->segments->info(i));
-
-        if (first + i >= numSegments || !segmentInfos->info(first + i)->equals(info)) {
-            if (!segmentInfos->contains(info)) {
-                boost::throw_exception(MergeException(L"MergePolicy selected a segment (" + info->name + L") that is not in the current index " + segString()));
-            } else {
-                boost::throw_exception(MergeException(L"MergePolicy selected non-contiguous segments to merge (" + merge->segString(directory) + L" vs " + segString() + L"), which IndexWriter (currently) cannot handle"));
-            }
+        if (!segmentInfos->contains(info)) {
+            boost::throw_exception(MergeException(L"MergePolicy selected a segment (" + info->name + L") that is not in the current index " + segString()));
         }
     }
-
-    return first;
 }
 
 void IndexWriter::commitMergedDeletes(const OneMergePtr& merge, const SegmentReaderPtr& mergeReader) {
@@ -2383,7 +2487,7 @@ bool IndexWriter::commitMerge(const OneMergePtr& merge, const SegmentMergerPtr&
         return false;
     }
 
-    int32_t start = ensureContiguousMerge(merge);
+    ensureValidMerge(merge);
 
     commitMergedDeletes(merge, mergedReader);
     docWriter->remapDeletes(segmentInfos, merger->getDocMaps(), merger->getDelCounts(), merge, mergedDocCount);
@@ -2394,7 +2498,15 @@ bool IndexWriter::commitMerge(const OneMergePtr& merge, const SegmentMergerPtr&
 
     merge->info->setHasProx(merger->hasProx());
 
-    segmentInfos->remove(start, start + merge->segments->size());
+    // The merged segment takes the place of the first of the segments it replaces, which need not be adjacent
+    int32_t start = -1;
+    for (int32_t i = segmentInfos->size() - 1; i >= 0; --i) {
+        if (merge->segments->contains(segmentInfos->info(i))) {
+            segmentInfos->remove(i);
+            start = i;
+        }
+    }
+    BOOST_ASSERT(start != -1);
     BOOST_ASSERT(!segmentInfos->contains(merge->info));
     segmentInfos->add(start, merge->info);
 
@@ -2524,7 +2636,7 @@ bool IndexWriter::registerMerge(const OneMergePtr& merge) {
         }
     }
 
-    ensureContiguousMerge(merge);
+    ensureValidMerge(merge);
 
     pendingMerges.add(merge);
 
@@ -2872,6 +2984,17 @@ int32_t IndexWriter::mergeMiddle(const OneMergePtr& merge) {
         merge->info->docCount = merger->merge(merge->mergeDocStores);
         mergedDocCount = merge->info->docCount;
 
+        if (infoStream) {
+            for (int32_t stage = 0; stage < SegmentMerger::NUM_STAGES; ++stage) {
+                SegmentMerger::MergeStage mergeStage = (SegmentMerger::MergeStage)stage;
+                if (merger->getStageWork(mergeStage) > 0) {
+                    message(L"merge " + SegmentMerger::getStageName(mergeStage) + L" took " +
+                            StringUtils::toString(merger->getStageTime(mergeStage)) + L" msec, work=" +
+                            StringUtils::toString(merger->getStageWork(mergeStage)));
+                }
+            }
+        }
+
         BOOST_ASSERT(mergedDocCount == totDocCount);
 
         if (merge->useCompoundFile) {
@@ -2948,6 +3071,8 @@ int32_t IndexWriter::mergeMiddle(const OneMergePtr& merge) {
         try {
             if (poolReaders && mergedSegmentWarmer) {
                 mergedSegmentWarmer->warm(mergedReader);
+                SyncLock syncLock(this);
+                warmedSegments.add(merge->info->name);
             }
             if (!commitMerge(merge, merger, mergedDocCount, mergedReader)) {
                 // commitMerge will return false if this merge was aborted
@@ -3337,9 +3462,12 @@ bool IndexWriter::testPoint(const String& name) {
     return true;
 }
 
-bool IndexWriter::nrtIsCurrent(const SegmentInfosPtr& infos) {
+bool IndexWriter::nrtIsCurrent(const SegmentInfosPtr& infos, int64_t changeCount) {
     SyncLock syncLock(this);
-    if (!infos->equals(segmentInfos)) {
+    if (changeCount != this->changeCount) {
+        // deletions were applied to the pooled readers, or segments were replaced
+        return false;
+    } else if (!infos->equals(segmentInfos)) {
         // if any structural changes (new segments), we are stale
         return false;
     } else if (infos->getGeneration() != segmentInfos->getGeneration()) {
@@ -3350,6 +3478,11 @@ bool IndexWriter::nrtIsCurrent(const SegmentInfosPtr& infos) {
     }
 }
 
+int64_t IndexWriter::getChangeCount() {
+    SyncLock syncLock(this);
+    return changeCount;
+}
+
 bool IndexWriter::isClosed() {
     SyncLock syncLock(this);
     return closed;
@@ -13,66 +13,68 @@
 namespace Lucene {
 
 MergeDocIDRemapper::MergeDocIDRemapper(const SegmentInfosPtr& infos, Collection< Collection<int32_t> > docMaps, Collection<int32_t> delCounts, const OneMergePtr& merge, int32_t mergedDocCount) {
-    this->docMaps = docMaps;
-    SegmentInfoPtr firstSegment(merge->segments->info(0));
-    int32_t i = 0;
-    this->minDocID = 0;
-    while (true) {
-        SegmentInfoPtr info(infos->info(i));
-        if (info->equals(firstSegment)) {
-            break;
-        }
-        minDocID += info->docCount;
-        ++i;
-    }
+    int32_t numSegments = infos->size();
+    starts = Collection<int32_t>::newInstance(numSegments);
+    newStarts = Collection<int32_t>::newInstance(numSegments);
+    this->docMaps = Collection< Collection<int32_t> >::newInstance(numSegments);
 
-    int32_t numDocs = 0;
-    for (int32_t j = 0; j < docMaps.size(); ++i, ++j) {
-        numDocs += infos->info(i)->docCount;
-        BOOST_ASSERT(infos->info(i)->equals(merge->segments->info(j)));
+    // where the documents of each merged segment start in the merged segment
+    Collection<int32_t> mergedStarts(Collection<int32_t>::newInstance(docMaps.size()));
+    for (int32_t j = 1; j < docMaps.size(); ++j) {
+        mergedStarts[j] = mergedStarts[j - 1] + merge->segments->info(j - 1)->docCount - delCounts[j - 1];
     }
-    this->maxDocID = minDocID + numDocs;
-
-    starts = Collection<int32_t>::newInstance(docMaps.size());
-    newStarts = Collection<int32_t>::newInstance(docMaps.size());
 
-    starts[0] = minDocID;
-    newStarts[0] = minDocID;
-    for (i = 1; i < docMaps.size(); ++i) {
-        int32_t lastDocCount = merge->segments->info(i - 1)->docCount;
-        starts[i] = starts[i - 1] + lastDocCount;
-        newStarts[i] = newStarts[i - 1] + lastDocCount - delCounts[i - 1];
+    int32_t docID = 0;
+    int32_t newDocID = 0;
+    int32_t mergedStart = -1;
+    int32_t numMerged = 0;
+    for (int32_t i = 0; i < numSegments; ++i) {
+        SegmentInfoPtr info(infos->info(i));
+        starts[i] = docID;
+        int32_t j = merge->segments->find(info);
+        if (j == -1) {
+            newStarts[i] = newDocID;
+            newDocID += info->docCount;
+        } else {
+            if (mergedStart == -1) {
+                // the merged segment takes the place of the first merged segment
+                mergedStart = newDocID;
+                newDocID += mergedDocCount;
+            }
+            newStarts[i] = mergedStart + mergedStarts[j];
+            this->docMaps[i] = docMaps[j];
+            ++numMerged;
+        }
+        docID += info->docCount;
     }
-    this->docShift = numDocs - mergedDocCount;
+    this->maxDocID = docID;
+    this->docShift = docID - newDocID;
 
     // There are rare cases when docShift is 0.  It happens if you try to delete a docID that's
     // out of bounds, because the SegmentReader still allocates deletedDocs and pretends it has
     // deletions ... so we can't make this assert here: BOOST_ASSERT(docShift > 0);
 
     // Make sure it all adds up
-    BOOST_ASSERT(docShift == maxDocID - (newStarts[docMaps.size() - 1] + merge->segments->info(docMaps.size() - 1)->docCount - delCounts[docMaps.size() - 1]));
+    BOOST_ASSERT(numMerged == docMaps.size());
 }
 
 MergeDocIDRemapper::~MergeDocIDRemapper() {
 }
 
 int32_t MergeDocIDRemapper::remap(int32_t oldDocID) {
-    if (oldDocID < minDocID) {
-        // Unaffected by merge
-        return oldDocID;
-    } else if (oldDocID >= maxDocID) {
-        // This doc was "after" the merge, so simple shift
+    if (oldDocID >= maxDocID) {
+        // This doc was "after" the segments, so simple shift
         return oldDocID - docShift;
-    } else {
-        // Binary search to locate this document & find its new docID
-        Collection<int32_t>::iterator doc = std::upper_bound(starts.begin(), starts.begin() + docMaps.size(), oldDocID);
-        int32_t docMap = std::distance(starts.begin(), doc) - 1;
+    }
 
-        if (docMaps[docMap]) {
-            return newStarts[docMap] + docMaps[docMap][oldDocID - starts[docMap]];
-        } else {
-            return newStarts[docMap] + oldDocID - starts[docMap];
-        }
+    // Binary search to locate the segment of this document & find its new docID
+    Collection<int32_t>::iterator doc = std::upper_bound(starts.begin(), starts.end(), oldDocID);
+    int32_t segment = std::distance(starts.begin(), doc) - 1;
+
+    if (docMaps[segment]) {
+        return newStarts[segment] + docMaps[segment][oldDocID - starts[segment]];
+    } else {
+        return newStarts[segment] + oldDocID - starts[segment];
     }
 }
 
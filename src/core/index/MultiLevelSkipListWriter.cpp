@@ -71,6 +71,9 @@ int64_t MultiLevelSkipListWriter::writeSkip(const IndexOutputPtr& output) {
     if (!skipBuffer || skipBuffer.empty()) {
         return skipPointer;
     }
+    if (skipBuffer[0]->getFilePointer() > 0) {
+        writeSkipHeader(output);
+    }
 
     for (int32_t level = numberOfSkipLevels - 1; level > 0; --level) {
         int64_t length = skipBuffer[level]->getFilePointer();
@@ -83,5 +86,7 @@ int64_t MultiLevelSkipListWriter::writeSkip(const IndexOutputPtr& output) {
     return skipPointer;
 }
 
+void MultiLevelSkipListWriter::writeSkipHeader(const IndexOutputPtr& output) {
+}
 
 }
@@ -0,0 +1,48 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "NumericDocValues.h"
+#include "NumericUtils.h"
+
+namespace Lucene {
+
+NumericDocValues::NumericDocValues(Type type, int64_t minValue, const PackedIntsPtr& values) {
+    this->type = type;
+    this->minValue = minValue;
+    this->values = values;
+}
+
+NumericDocValues::NumericDocValues(const NumericDocValuesPtr& other) {
+    this->type = other->type;
+    this->minValue = other->minValue;
+    this->values = other->values;
+}
+
+NumericDocValues::~NumericDocValues() {
+}
+
+NumericDocValues::Type NumericDocValues::getType() {
+    return type;
+}
+
+int32_t NumericDocValues::size() {
+    return values->size();
+}
+
+int64_t NumericDocValues::getLong(int32_t doc) {
+    return type == TYPE_DOUBLE ? (int64_t)NumericUtils::sortableLongToDouble(getRaw(doc)) : getRaw(doc);
+}
+
+double NumericDocValues::getDouble(int32_t doc) {
+    return type == TYPE_DOUBLE ? NumericUtils::sortableLongToDouble(getRaw(doc)) : (double)getRaw(doc);
+}
+
+int64_t NumericDocValues::sizeInBytes() {
+    return values->sizeInBytes();
+}
+
+}
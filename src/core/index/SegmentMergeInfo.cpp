@@ -9,6 +9,7 @@
 #include "IndexReader.h"
 #include "TermEnum.h"
 #include "TermPositions.h"
+#include "MiscUtils.h"
 
 namespace Lucene {
 
@@ -54,6 +55,19 @@ TermPositionsPtr SegmentMergeInfo::getPositions() {
     return postings;
 }
 
+ByteArray SegmentMergeInfo::getNorms(const String& field) {
+    if (!norms || field != normsField) {
+        IndexReaderPtr reader(_reader);
+        if (!norms) {
+            norms = ByteArray::newInstance(reader->maxDoc());
+        }
+        MiscUtils::arrayFill(norms.get(), 0, norms.size(), 0);
+        reader->norms(field, norms, 0);
+        normsField = field;
+    }
+    return norms;
+}
+
 bool SegmentMergeInfo::next() {
     if (termEnum->next()) {
         term = termEnum->term();
@@ -5,6 +5,13 @@
 /////////////////////////////////////////////////////////////////////////////
 
 #include "LuceneInc.h"
+#include <boost/version.hpp>
+#if BOOST_VERSION >= 107300  // Boost 1.73.0+
+#include <boost/bind/bind.hpp>
+#else
+#include <boost/bind.hpp>
+#endif
+#include <boost/bind/protect.hpp>
 #include "SegmentMerger.h"
 #include "MergePolicy.h"
 #include "IndexWriter.h"
@@ -18,6 +25,7 @@
 #include "SegmentReader.h"
 #include "_SegmentReader.h"
 #include "Directory.h"
+#include "RateLimitedDirectoryWrapper.h"
 #include "TermPositions.h"
 #include "TermVectorsReader.h"
 #include "TermVectorsWriter.h"
@@ -28,7 +36,12 @@
 #include "SegmentMergeInfo.h"
 #include "SegmentMergeQueue.h"
 #include "SegmentWriteState.h"
+#include "DocValuesWriter.h"
+#include "NumericDocValues.h"
+#include "NumericUtils.h"
+#include "ReaderUtil.h"
 #include "TestPoint.h"
+#include "ThreadPool.h"
 #include "MiscUtils.h"
 #include "StringUtils.h"
 
@@ -44,13 +57,23 @@ const int32_t SegmentMerger::NORMS_HEADER_LENGTH = 4;
 SegmentMerger::SegmentMerger(const DirectoryPtr& dir, const String& name) {
     readers = Collection<IndexReaderPtr>::newInstance();
     termIndexInterval = IndexWriter::DEFAULT_TERM_INDEX_INTERVAL;
+    useBlockPostings = false;
+    useSkipImpacts = false;
+    storedFieldsCompression = IndexWriter::STORED_FIELDS_UNCOMPRESSED;
     mergedDocs = 0;
     mergeDocStores = false;
     omitTermFreqAndPositions = false;
+    omitNorms = false;
+    hasDocValues = false;
 
     directory = dir;
     segment = name;
     checkAbort = newLucene<CheckAbortNull>();
+    threadPool = ThreadPool::getInstance();
+    for (int32_t i = 0; i < NUM_STAGES; ++i) {
+        stageWork[i] = 0;
+        stageTime[i] = 0;
+    }
 }
 
 SegmentMerger::SegmentMerger(const IndexWriterPtr& writer, const String& name, const OneMergePtr& merge) {
@@ -58,6 +81,8 @@ SegmentMerger::SegmentMerger(const IndexWriterPtr& writer, const String& name, c
     mergedDocs = 0;
     mergeDocStores = false;
     omitTermFreqAndPositions = false;
+    omitNorms = false;
+    hasDocValues = false;
 
     directory = writer->getDirectory();
     segment = name;
@@ -67,7 +92,20 @@ SegmentMerger::SegmentMerger(const IndexWriterPtr& writer, const String& name, c
     } else {
         checkAbort = newLucene<CheckAbortNull>();
     }
+
+    if (merge && merge->rateLimiter) {
+        // only the files the merge writes are throttled
+        directory = newLucene<RateLimitedDirectoryWrapper>(directory, merge->rateLimiter);
+    }
     termIndexInterval = writer->getTermIndexInterval();
+    useBlockPostings = writer->getUseBlockPostings();
+    useSkipImpacts = writer->getUseSkipImpacts();
+    storedFieldsCompression = writer->getStoredFieldsCompression();
+    threadPool = ThreadPool::getInstance();
+    for (int32_t i = 0; i < NUM_STAGES; ++i) {
+        stageWork[i] = 0;
+        stageTime[i] = 0;
+    }
 }
 
 SegmentMerger::~SegmentMerger() {
@@ -95,17 +133,131 @@ int32_t SegmentMerger::merge(bool mergeDocStores) {
     // NOTE: it's important to add calls to checkAbort.work(...) if you make any changes to this method that will spend a lot of time.
     // The frequency of this check impacts how long IndexWriter.close(false) takes to actually stop the threads.
 
-    mergedDocs = mergeFields();
-    mergeTerms();
-    mergeNorms();
+    mergeFieldInfos();
+
+    // the stored fields stage checks that it copies this many documents
+    mergedDocs = 0;
+    for (Collection<IndexReaderPtr>::iterator reader = readers.begin(); reader != readers.end(); ++reader) {
+        mergedDocs += (*reader)->numDocs();
+    }
 
+    Collection<int32_t> stages(Collection<int32_t>::newInstance());
+    if (mergeDocStores) {
+        stages.add(STAGE_STORED_FIELDS);
+    }
+    stages.add(STAGE_TERMS);
+    stages.add(STAGE_NORMS);
+    stages.add(STAGE_DOC_VALUES);
     if (mergeDocStores && fieldInfos->hasVectors()) {
-        mergeVectors();
+        stages.add(STAGE_VECTORS);
+    }
+
+    // the stages write their own files, so run them at the same time with the merging thread taking the first
+    Collection<FuturePtr> futures(Collection<FuturePtr>::newInstance(stages.size()));
+    if (threadPool) {
+        for (int32_t i = 1; i < stages.size(); ++i) {
+            futures[i] = threadPool->scheduleTask(boost::protect(boost::bind<int32_t>(boost::mem_fn(&SegmentMerger::runStage), shared_from_this(), stages[i])));
+        }
+    }
+    for (int32_t i = 0; i < stages.size(); ++i) {
+        if (futures[i]) {
+            futures[i]->get<int32_t>();
+        } else if (runStage(stages[i]) != 0 && !threadPool) {
+            break;
+        }
+    }
+
+    // wait for every stage to finish before reporting the first failure, so no file is still being written
+    for (Collection<int32_t>::iterator stage = stages.begin(); stage != stages.end(); ++stage) {
+        stageErrors[*stage].throwException();
     }
 
     return mergedDocs;
 }
 
+void SegmentMerger::mergeStage(MergeStage stage) {
+    int64_t start = MiscUtils::currentTimeMillis();
+    switch (stage) {
+    case STAGE_STORED_FIELDS: {
+        int32_t docCount = mergeStoredFields();
+        if (docCount != mergedDocs) {
+            boost::throw_exception(RuntimeException(L"mergeFields produced an invalid result: docCount is " +
+                                                    StringUtils::toString(docCount) + L" but readers have " +
+                                                    StringUtils::toString(mergedDocs) + L" documents" +
+                                                    L"; now aborting this merge to prevent index corruption"));
+        }
+        break;
+    }
+    case STAGE_TERMS:
+        mergeTerms();
+        break;
+    case STAGE_NORMS:
+        mergeNorms();
+        break;
+    case STAGE_DOC_VALUES:
+        mergeDocValues();
+        break;
+    case STAGE_VECTORS:
+        mergeVectors();
+        break;
+    default:
+        boost::throw_exception(IllegalArgumentException(L"unknown merge stage " + StringUtils::toString((int32_t)stage)));
+    }
+    stageTime[stage] = MiscUtils::currentTimeMillis() - start;
+}
+
+int32_t SegmentMerger::runStage(int32_t stage) {
+    try {
+        mergeStage((MergeStage)stage);
+        return 0;
+    } catch (LuceneException& e) {
+        stageErrors[stage] = e;
+    } catch (std::exception& e) {
+        stageErrors[stage] = RuntimeException(StringUtils::toUnicode(e.what()));
+    } catch (...) {
+        stageErrors[stage] = RuntimeException(L"unknown exception merging " + getStageName((MergeStage)stage));
+    }
+    return -1;
+}
+
+void SegmentMerger::work(MergeStage stage, double units) {
+    stageWork[stage] += (int64_t)std::ceil(units);
+    checkAbort->work(units);
+}
+
+void SegmentMerger::setThreadPool(const ThreadPoolPtr& threadPool) {
+    this->threadPool = threadPool;
+}
+
+ThreadPoolPtr SegmentMerger::getThreadPool() {
+    return threadPool;
+}
+
+int64_t SegmentMerger::getStageWork(MergeStage stage) {
+    return stageWork[stage];
+}
+
+int64_t SegmentMerger::getStageTime(MergeStage stage) {
+    return stageTime[stage];
+}
+
+String SegmentMerger::getStageName(MergeStage stage) {
+    switch (stage) {
+    case STAGE_STORED_FIELDS:
+        return L"stored fields";
+    case STAGE_TERMS:
+        return L"terms";
+    case STAGE_NORMS:
+        return L"norms";
+    case STAGE_DOC_VALUES:
+        return L"doc values";
+    case STAGE_VECTORS:
+        return L"vectors";
+    default:
+        return L"unknown";
+    }
+}
+
 void SegmentMerger::closeReaders() {
     for (Collection<IndexReaderPtr>::iterator reader = readers.begin(); reader != readers.end(); ++reader) {
         (*reader)->close();
@@ -135,6 +287,10 @@ HashSet<String> SegmentMerger::getMergedFiles() {
         }
     }
 
+    if (hasDocValues) {
+        fileSet.add(segment + L"." + IndexFileNames::DOC_VALUES_EXTENSION());
+    }
+
     // Vector files
     if (fieldInfos->hasVectors() && mergeDocStores) {
         for (HashSet<String>::iterator ext = IndexFileNames::VECTOR_EXTENSIONS().begin(); ext != IndexFileNames::VECTOR_EXTENSIONS().end(); ++ext) {
@@ -193,12 +349,18 @@ void SegmentMerger::setMatchingSegmentReaders() {
         }
     }
 
-    // Used for bulk-reading raw bytes for stored fields
+    // Used for bulk-reading raw bytes for stored fields and vectors, separately as they are merged at the same time
     rawDocLengths = Collection<int32_t>::newInstance(MAX_RAW_MERGE_DOCS);
-    rawDocLengths2 = Collection<int32_t>::newInstance(MAX_RAW_MERGE_DOCS);
+    rawTvdLengths = Collection<int32_t>::newInstance(MAX_RAW_MERGE_DOCS);
+    rawTvfLengths = Collection<int32_t>::newInstance(MAX_RAW_MERGE_DOCS);
 }
 
 int32_t SegmentMerger::mergeFields() {
+    mergeFieldInfos();
+    return mergeStoredFields();
+}
+
+void SegmentMerger::mergeFieldInfos() {
     if (!mergeDocStores) {
         // When we are not merging by doc stores, their field name -> number mapping are the same.
         // So, we start with the fieldInfos of the last segment in this case, to keep that numbering
@@ -231,13 +393,15 @@ int32_t SegmentMerger::mergeFields() {
     }
     fieldInfos->write(directory, segment + L".fnm");
 
-    int32_t docCount = 0;
-
     setMatchingSegmentReaders();
+}
+
+int32_t SegmentMerger::mergeStoredFields() {
+    int32_t docCount = 0;
 
     if (mergeDocStores) {
         // merge field values
-        FieldsWriterPtr fieldsWriter(newLucene<FieldsWriter>(directory, segment, fieldInfos));
+        FieldsWriterPtr fieldsWriter(newLucene<FieldsWriter>(directory, segment, fieldInfos, storedFieldsCompression));
 
         LuceneException finally;
         try {
@@ -310,10 +474,9 @@ int32_t SegmentMerger::copyFieldsWithDeletions(const FieldsWriterPtr& fieldsWrit
                 }
             } while (numDocs < MAX_RAW_MERGE_DOCS);
 
-            IndexInputPtr stream(matchingFieldsReader->rawDocs(rawDocLengths, start, numDocs));
-            fieldsWriter->addRawDocuments(stream, rawDocLengths, numDocs);
+            fieldsWriter->addRawDocuments(matchingFieldsReader, rawDocLengths, start, numDocs);
             docCount += numDocs;
-            checkAbort->work(300 * numDocs);
+            work(STAGE_STORED_FIELDS, 300 * numDocs);
         }
     } else {
         for (int32_t j = 0; j < maxDoc; ++j) {
@@ -325,7 +488,7 @@ int32_t SegmentMerger::copyFieldsWithDeletions(const FieldsWriterPtr& fieldsWrit
             // NOTE: it's very important to first assign to doc then pass it to termVectorsWriter.addAllDocVectors
             fieldsWriter->addDocument(reader->document(j));
             ++docCount;
-            checkAbort->work(300);
+            work(STAGE_STORED_FIELDS, 300);
         }
     }
     return docCount;
@@ -338,16 +501,15 @@ int32_t SegmentMerger::copyFieldsNoDeletions(const FieldsWriterPtr& fieldsWriter
         // We can bulk-copy because the fieldInfos are "congruent"
         while (docCount < maxDoc) {
             int32_t len = std::min(MAX_RAW_MERGE_DOCS, maxDoc - docCount);
-            IndexInputPtr stream(matchingFieldsReader->rawDocs(rawDocLengths, docCount, len));
-            fieldsWriter->addRawDocuments(stream, rawDocLengths, len);
+            fieldsWriter->addRawDocuments(matchingFieldsReader, rawDocLengths, docCount, len);
             docCount += len;
-            checkAbort->work(300 * len);
+            work(STAGE_STORED_FIELDS, 300 * len);
         }
     } else {
         for (; docCount < maxDoc; ++docCount) {
             // NOTE: it's very important to first assign to doc then pass it to termVectorsWriter.addAllDocVectors
             fieldsWriter->addDocument(reader->document(docCount));
-            checkAbort->work(300);
+            work(STAGE_STORED_FIELDS, 300);
         }
     }
     return docCount;
@@ -419,9 +581,9 @@ void SegmentMerger::copyVectorsWithDeletions(const TermVectorsWriterPtr& termVec
                 }
             } while (numDocs < MAX_RAW_MERGE_DOCS);
 
-            matchingVectorsReader->rawDocs(rawDocLengths, rawDocLengths2, start, numDocs);
-            termVectorsWriter->addRawDocuments(matchingVectorsReader, rawDocLengths, rawDocLengths2, numDocs);
-            checkAbort->work(300 * numDocs);
+            matchingVectorsReader->rawDocs(rawTvdLengths, rawTvfLengths, start, numDocs);
+            termVectorsWriter->addRawDocuments(matchingVectorsReader, rawTvdLengths, rawTvfLengths, numDocs);
+            work(STAGE_VECTORS, 300 * numDocs);
         }
     } else {
         for (int32_t docNum = 0; docNum < maxDoc; ++docNum) {
@@ -432,7 +594,7 @@ void SegmentMerger::copyVectorsWithDeletions(const TermVectorsWriterPtr& termVec
 
             // NOTE: it's very important to first assign to vectors then pass it to termVectorsWriter.addAllDocVectors
             termVectorsWriter->addAllDocVectors(reader->getTermFreqVectors(docNum));
-            checkAbort->work(300);
+            work(STAGE_VECTORS, 300);
         }
     }
 }
@@ -444,16 +606,16 @@ void SegmentMerger::copyVectorsNoDeletions(const TermVectorsWriterPtr& termVecto
         int32_t docCount = 0;
         while (docCount < maxDoc) {
             int32_t len = std::min(MAX_RAW_MERGE_DOCS, maxDoc - docCount);
-            matchingVectorsReader->rawDocs(rawDocLengths, rawDocLengths2, docCount, len);
-            termVectorsWriter->addRawDocuments(matchingVectorsReader, rawDocLengths, rawDocLengths2, len);
+            matchingVectorsReader->rawDocs(rawTvdLengths, rawTvfLengths, docCount, len);
+            termVectorsWriter->addRawDocuments(matchingVectorsReader, rawTvdLengths, rawTvfLengths, len);
             docCount += len;
-            checkAbort->work(300 * len);
+            work(STAGE_VECTORS, 300 * len);
         }
     } else {
         for (int32_t docNum = 0; docNum < maxDoc; ++docNum) {
             // NOTE: it's very important to first assign to vectors then pass it to termVectorsWriter.addAllDocVectors
             termVectorsWriter->addAllDocVectors(reader->getTermFreqVectors(docNum));
-            checkAbort->work(300);
+            work(STAGE_VECTORS, 300);
         }
     }
 }
@@ -461,7 +623,7 @@ void SegmentMerger::copyVectorsNoDeletions(const TermVectorsWriterPtr& termVecto
 void SegmentMerger::mergeTerms() {
     TestScope testScope(L"SegmentMerger", L"mergeTerms");
 
-    SegmentWriteStatePtr state(newLucene<SegmentWriteState>(DocumentsWriterPtr(), directory, segment, L"", mergedDocs, 0, termIndexInterval));
+    SegmentWriteStatePtr state(newLucene<SegmentWriteState>(DocumentsWriterPtr(), directory, segment, L"", mergedDocs, 0, termIndexInterval, useBlockPostings, useSkipImpacts));
 
     FormatPostingsFieldsConsumerPtr consumer(newLucene<FormatPostingsFieldsWriter>(state, fieldInfos));
 
@@ -532,11 +694,13 @@ void SegmentMerger::mergeTermInfos(const FormatPostingsFieldsConsumerPtr& consum
             FieldInfoPtr fieldInfo(fieldInfos->fieldInfo(currentField));
             termsConsumer = consumer->addField(fieldInfo);
             omitTermFreqAndPositions = fieldInfo->omitTermFreqAndPositions;
+            // the norms are only read for the impacts in the skip data
+            omitNorms = (!useSkipImpacts || !fieldInfo->isIndexed || fieldInfo->omitNorms);
         }
 
         int32_t df = appendPostings(termsConsumer, match, matchSize); // add new TermInfo
 
-        checkAbort->work(df / 3.0);
+        work(STAGE_TERMS, df / 3.0);
 
         while (matchSize > 0) {
             SegmentMergeInfoPtr smi(match[--matchSize]);
@@ -566,18 +730,20 @@ int32_t SegmentMerger::appendPostings(const FormatPostingsTermsConsumerPtr& term
         BOOST_ASSERT(postings);
         int32_t base = smi->base;
         Collection<int32_t> docMap(smi->getDocMap());
+        ByteArray norms(omitNorms ? ByteArray() : smi->getNorms(smi->term->_field));
         postings->seek(smi->termEnum);
 
         while (postings->next()) {
             ++df;
             int32_t doc = postings->doc();
+            uint8_t norm = norms ? norms[doc] : 0;
             if (docMap) {
                 doc = docMap[doc];    // map around deletions
             }
             doc += base; // convert to merged space
 
             int32_t freq = postings->freq();
-            FormatPostingsPositionsConsumerPtr posConsumer(docConsumer->addDoc(doc, freq));
+            FormatPostingsPositionsConsumerPtr posConsumer(docConsumer->addDoc(doc, freq, norm));
 
             if (!omitTermFreqAndPositions) {
                 for (int32_t j = 0; j < freq; ++j) {
@@ -638,7 +804,7 @@ void SegmentMerger::mergeNorms() {
                             }
                         }
                     }
-                    checkAbort->work(maxDoc);
+                    work(STAGE_NORMS, maxDoc);
                 }
             }
         }
@@ -651,6 +817,80 @@ void SegmentMerger::mergeNorms() {
     finally.throwException();
 }
 
+void SegmentMerger::mergeDocValues() {
+    // values are read from the segments of composite readers, passed to addIndexes
+    Collection< Collection<IndexReaderPtr> > subReaders(Collection< Collection<IndexReaderPtr> >::newInstance(readers.size()));
+    for (int32_t i = 0; i < readers.size(); ++i) {
+        subReaders[i] = Collection<IndexReaderPtr>::newInstance();
+        ReaderUtil::gatherSubReaders(subReaders[i], readers[i]);
+    }
+
+    Collection<int32_t> fieldNumbers(Collection<int32_t>::newInstance());
+    for (int32_t i = 0; i < fieldInfos->size(); ++i) {
+        String fieldName(fieldInfos->fieldName(i));
+        bool hasValues = false;
+        for (int32_t j = 0; j < readers.size() && !hasValues; ++j) {
+            for (Collection<IndexReaderPtr>::iterator subReader = subReaders[j].begin(); subReader != subReaders[j].end() && !hasValues; ++subReader) {
+                hasValues = (bool)(*subReader)->getNumericDocValues(fieldName);
+            }
+        }
+        if (hasValues) {
+            fieldNumbers.add(i);
+        }
+    }
+    if (fieldNumbers.empty()) {
+        return;
+    }
+
+    hasDocValues = true;
+    IndexOutputPtr output(directory->createOutput(segment + L"." + IndexFileNames::DOC_VALUES_EXTENSION()));
+    LuceneException finally;
+    try {
+        DocValuesWriter::writeHeader(output, fieldNumbers.size());
+        LongArray mergedValues(LongArray::newInstance(std::max(mergedDocs, 1)));
+        for (Collection<int32_t>::iterator fieldNumber = fieldNumbers.begin(); fieldNumber != fieldNumbers.end(); ++fieldNumber) {
+            String fieldName(fieldInfos->fieldName(*fieldNumber));
+
+            // the field is stored as double if any segment stores it as double
+            bool isDouble = false;
+            for (int32_t j = 0; j < readers.size(); ++j) {
+                for (Collection<IndexReaderPtr>::iterator subReader = subReaders[j].begin(); subReader != subReaders[j].end(); ++subReader) {
+                    NumericDocValuesPtr values((*subReader)->getNumericDocValues(fieldName));
+                    isDouble = isDouble || (values && values->getType() == NumericDocValues::TYPE_DOUBLE);
+                }
+            }
+
+            int32_t docUpto = 0;
+            for (int32_t j = 0; j < readers.size(); ++j) {
+                IndexReaderPtr reader(readers[j]);
+                bool hasDeletions = reader->hasDeletions();
+                int32_t docBase = 0;
+                for (Collection<IndexReaderPtr>::iterator subReader = subReaders[j].begin(); subReader != subReaders[j].end(); ++subReader) {
+                    NumericDocValuesPtr values((*subReader)->getNumericDocValues(fieldName));
+                    bool convert = (values && isDouble && values->getType() == NumericDocValues::TYPE_LONG);
+                    int32_t maxDoc = (*subReader)->maxDoc();
+                    for (int32_t k = 0; k < maxDoc; ++k) {
+                        if (hasDeletions && reader->isDeleted(docBase + k)) {
+                            continue;
+                        }
+                        int64_t value = values ? values->getRaw(k) : 0;
+                        mergedValues[docUpto++] = convert ? NumericUtils::doubleToSortableLong((double)value) : value;
+                    }
+                    docBase += maxDoc;
+                    work(STAGE_DOC_VALUES, maxDoc);
+                }
+            }
+            BOOST_ASSERT(docUpto == mergedDocs);
+
+            DocValuesWriter::writeField(output, *fieldNumber, isDouble ? NumericDocValues::TYPE_DOUBLE : NumericDocValues::TYPE_LONG, mergedValues, mergedDocs);
+        }
+    } catch (LuceneException& e) {
+        finally = e;
+    }
+    output->close();
+    finally.throwException();
+}
+
 CheckAbort::CheckAbort(const OneMergePtr& merge, const DirectoryPtr& dir) {
     workCount = 0;
     this->merge = merge;
@@ -661,6 +901,7 @@ CheckAbort::~CheckAbort() {
 }
 
 void CheckAbort::work(double units) {
+    SyncLock syncLock(this); // the stages of a merge run concurrently
     workCount += units;
     if (workCount >= 10000.0) {
         merge->checkAborted(DirectoryPtr(_dir));
@@ -17,6 +17,7 @@
 #include "TermInfo.h"
 #include "TermInfosReader.h"
 #include "TermVectorsReader.h"
+#include "DocValuesReader.h"
 #include "IndexOutput.h"
 #include "ReadOnlySegmentReader.h"
 #include "BitVector.h"
@@ -44,6 +45,7 @@ SegmentReader::SegmentReader() {
     readBufferSize = 0;
     pendingDeleteCount = 0;
     rollbackPendingDeleteCount = 0;
+    sharedDeletedDocs = NULL;
 }
 
 SegmentReader::~SegmentReader() {
@@ -306,7 +308,7 @@ void SegmentReader::doClose() {
     fieldsReaderLocal->close();
     if (deletedDocs) {
         deletedDocsRef->decRef();
-        deletedDocs.reset(); // null so if an app hangs on to us we still free most ram
+        boost::atomic_store(&deletedDocs, BitVectorPtr()); // null so if an app hangs on to us we still free most ram
     }
     for (MapStringNorm::iterator norm = _norms.begin(); norm != _norms.end(); ++norm) {
         norm->second->decRef();
@@ -323,7 +325,7 @@ bool SegmentReader::hasDeletions(const SegmentInfoPtr& si) {
 
 bool SegmentReader::hasDeletions() {
     // Don't call ensureOpen() here (it could affect performance)
-    return deletedDocs.get() != NULL;
+    return boost::atomic_load(&deletedDocs).get() != NULL;
 }
 
 bool SegmentReader::usesCompoundFile(const SegmentInfoPtr& si) {
@@ -335,21 +337,31 @@ bool SegmentReader::hasSeparateNorms(const SegmentInfoPtr& si) {
 }
 
 void SegmentReader::doDelete(int32_t docNum) {
+    // term docs or searches may be reading the current BitVector without a lock, so change a copy
+    BitVectorPtr newDeletedDocs;
     if (!deletedDocs) {
-        deletedDocs = newLucene<BitVector>(maxDoc());
-        deletedDocsRef = newLucene<SegmentReaderRef>();
+        newDeletedDocs = newLucene<BitVector>(maxDoc());
+    } else if (deletedDocsRef->refCount() > 1 || sharedDeletedDocs.load(std::memory_order_acquire) == deletedDocs.get()) {
+        newDeletedDocs = cloneDeletedDocs(deletedDocs);
     }
-    // there is more than 1 SegmentReader with a reference to this deletedDocs BitVector so decRef
-    // the current deletedDocsRef, clone the BitVector, create a new deletedDocsRef
-    if (deletedDocsRef->refCount() > 1) {
-        SegmentReaderRefPtr oldRef(deletedDocsRef);
-        deletedDocs = cloneDeletedDocs(deletedDocs);
-        deletedDocsRef = newLucene<SegmentReaderRef>();
-        oldRef->decRef();
+    // an invalid docNum throws here, before anything is changed
+    if (!(newDeletedDocs ? newDeletedDocs : deletedDocs)->getAndSet(docNum)) {
+        ++pendingDeleteCount;
     }
     deletedDocsDirty = true;
-    if (!deletedDocs->getAndSet(docNum)) {
-        ++pendingDeleteCount;
+    if (newDeletedDocs) {
+        if (!deletedDocs) {
+            deletedDocsRef = newLucene<SegmentReaderRef>();
+        } else if (deletedDocsRef->refCount() > 1) {
+            // there is more than 1 SegmentReader with a reference to this deletedDocs BitVector so decRef
+            // the current deletedDocsRef and create a new deletedDocsRef for the clone
+            SegmentReaderRefPtr oldRef(deletedDocsRef);
+            deletedDocsRef = newLucene<SegmentReaderRef>();
+            oldRef->decRef();
+        }
+        // only publish the copy once it holds the deletion
+        boost::atomic_store(&deletedDocs, newDeletedDocs);
+        sharedDeletedDocs.store(NULL, std::memory_order_release);
     }
 }
 
@@ -358,7 +370,8 @@ void SegmentReader::doUndeleteAll() {
     if (deletedDocs) {
         BOOST_ASSERT(deletedDocsRef);
         deletedDocsRef->decRef();
-        deletedDocs.reset();
+        boost::atomic_store(&deletedDocs, BitVectorPtr());
+        sharedDeletedDocs.store(NULL, std::memory_order_release);
         deletedDocsRef.reset();
         pendingDeleteCount = 0;
         si->clearDelGen();
@@ -393,8 +406,19 @@ DocumentPtr SegmentReader::document(int32_t n, const FieldSelectorPtr& fieldSele
 }
 
 bool SegmentReader::isDeleted(int32_t n) {
-    SyncLock syncLock(this);
-    return (deletedDocs && deletedDocs->get(n));
+    BitVectorPtr snapshot(getDeletedDocsSnapshot());
+    return (snapshot && snapshot->get(n));
+}
+
+BitVectorPtr SegmentReader::getDeletedDocsSnapshot() {
+    BitVectorPtr snapshot(boost::atomic_load(&deletedDocs));
+    if (snapshot && sharedDeletedDocs.load(std::memory_order_acquire) != snapshot.get()) {
+        // mark it as shared under the lock so that a deletion can't be changing it at the same time
+        SyncLock syncLock(this);
+        snapshot = deletedDocs;
+        sharedDeletedDocs.store(snapshot.get(), std::memory_order_release);
+    }
+    return snapshot;
 }
 
 TermDocsPtr SegmentReader::termDocs(const TermPtr& term) {
@@ -424,8 +448,9 @@ int32_t SegmentReader::docFreq(const TermPtr& t) {
 int32_t SegmentReader::numDocs() {
     // Don't call ensureOpen() here (it could affect performance)
     int32_t n = maxDoc();
-    if (deletedDocs) {
-        n -= deletedDocs->count();
+    BitVectorPtr snapshot(boost::atomic_load(&deletedDocs));
+    if (snapshot) {
+        n -= snapshot->count();
     }
     return n;
 }
@@ -467,6 +492,12 @@ HashSet<String> SegmentReader::getFieldNames(FieldOption fieldOption) {
     return fieldSet;
 }
 
+NumericDocValuesPtr SegmentReader::getNumericDocValues(const String& field) {
+    ensureOpen();
+    DocValuesReaderPtr docValuesReader(core->docValuesReader);
+    return docValuesReader ? docValuesReader->getDocValues(field) : NumericDocValuesPtr();
+}
+
 bool SegmentReader::hasNorms(const String& field) {
     SyncLock syncLock(this);
     ensureOpen();
@@ -499,6 +530,19 @@ void SegmentReader::doSetNorm(int32_t doc, const String& field, uint8_t value) {
     bytes[doc] = value; // set the value
 }
 
+int32_t SegmentReader::maxNorm(const String& field) {
+    SyncLock syncLock(this);
+    ensureOpen();
+    NormPtr norm(_norms.get(field));
+    return norm ? (int32_t)norm->maxByte() : -1;
+}
+
+bool SegmentReader::normsChanged(const String& field) {
+    SyncLock syncLock(this);
+    NormPtr norm(_norms.get(field));
+    return norm && (norm->dirty || si->hasSeparateNorms(norm->number));
+}
+
 void SegmentReader::norms(const String& field, ByteArray norms, int32_t offset) {
     SyncLock syncLock(this);
     ensureOpen();
@@ -700,7 +744,7 @@ LuceneObjectPtr SegmentReader::getFieldCacheKey() {
 }
 
 LuceneObjectPtr SegmentReader::getDeletesCacheKey() {
-    return deletedDocs;
+    return boost::atomic_load(&deletedDocs);
 }
 
 int64_t SegmentReader::getUniqueTermCount() {
@@ -770,6 +814,10 @@ CoreReaders::CoreReaders(const SegmentReaderPtr& origInstance, const DirectoryPt
             proxStream = cfsDir->openInput(segment + L"." + IndexFileNames::PROX_EXTENSION(), readBufferSize);
         }
 
+        if (cfsDir->fileExists(segment + L"." + IndexFileNames::DOC_VALUES_EXTENSION())) {
+            docValuesReader = newLucene<DocValuesReader>(cfsDir, segment, fieldInfos, si->docCount, readBufferSize);
+        }
+
         success = true;
     } catch (LuceneException& e) {
         finally = e;
@@ -854,6 +902,9 @@ void CoreReaders::decRef() {
         if (proxStream) {
             proxStream->close();
         }
+        if (docValuesReader) {
+            docValuesReader->close();
+        }
         if (termVectorsReaderOrig) {
             termVectorsReaderOrig->close();
         }
@@ -965,6 +1016,7 @@ Norm::Norm() {
     this->dirty = false;
     this->rollbackDirty = false;
     this->number = 0;
+    this->_maxByte = -1;
 }
 
 Norm::Norm(const SegmentReaderPtr& reader, const IndexInputPtr& in, int32_t number, int64_t normSeek) {
@@ -975,6 +1027,7 @@ Norm::Norm(const SegmentReaderPtr& reader, const IndexInputPtr& in, int32_t numb
     this->in = in;
     this->number = number;
     this->normSeek = normSeek;
+    this->_maxByte = -1;
 }
 
 Norm::~Norm() {
@@ -1094,6 +1147,16 @@ SegmentReaderRefPtr Norm::bytesRef() {
     return _bytesRef;
 }
 
+uint8_t Norm::maxByte() {
+    SyncLock syncLock(this);
+    if (_maxByte == -1) {
+        ByteArray normBytes(bytes());
+        uint8_t* bytesEnd = normBytes.get() + normBytes.size();
+        _maxByte = normBytes.size() == 0 ? 0 : *std::max_element(normBytes.get(), bytesEnd);
+    }
+    return (uint8_t)_maxByte;
+}
+
 ByteArray Norm::copyOnWrite() {
     SyncLock syncLock(this);
     BOOST_ASSERT(refCount > 0 && (!origNorm || origNorm->refCount > 0));
@@ -1110,6 +1173,7 @@ ByteArray Norm::copyOnWrite() {
         oldRef->decRef();
     }
     dirty = true;
+    _maxByte = -1; // about to change
     return _bytes;
 }
 
@@ -1128,6 +1192,7 @@ LuceneObjectPtr Norm::clone(const LuceneObjectPtr& other) {
     cloneNorm->dirty = dirty;
     cloneNorm->number = number;
     cloneNorm->rollbackDirty = rollbackDirty;
+    cloneNorm->_maxByte = _maxByte;
 
     cloneNorm->refCount = 1;
 
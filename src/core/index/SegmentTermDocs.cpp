@@ -16,7 +16,9 @@
 #include "Term.h"
 #include "TermInfo.h"
 #include "DefaultSkipListReader.h"
+#include "CompetitiveImpactAccumulator.h"
 #include "BitVector.h"
+#include "ForUtil.h"
 #include "MiscUtils.h"
 
 namespace Lucene {
@@ -33,15 +35,22 @@ SegmentTermDocs::SegmentTermDocs(const SegmentReaderPtr& parent) {
     this->haveSkipped = false;
     this->currentFieldStoresPayloads = false;
     this->currentFieldOmitTermFreqAndPositions = false;
+    this->blockDocs = 0;
+    this->termMaxFreq = 0;
+    this->termImpacts = Collection<int32_t>::newInstance();
+    this->changedMaxNorm = -2;
 
     this->_freqStream = boost::dynamic_pointer_cast<IndexInput>(parent->core->freqStream->clone());
-    {
-        SyncLock parentLock(parent);
-        this->deletedDocs = parent->deletedDocs;
-        this->__deletedDocs = this->deletedDocs.get();
-    }
+    this->deletedDocs = parent->getDeletedDocsSnapshot();
+    this->__deletedDocs = this->deletedDocs.get();
     this->skipInterval = parent->core->getTermsReader()->getSkipInterval();
     this->maxSkipLevels = parent->core->getTermsReader()->getMaxSkipLevels();
+    this->postingsBlockSize = parent->core->getTermsReader()->getPostingsBlockSize();
+    this->skipImpacts = parent->core->getTermsReader()->hasSkipImpacts();
+    if (postingsBlockSize != 0) {
+        docBuffer = IntArray::newInstance(postingsBlockSize);
+        freqBuffer = IntArray::newInstance(postingsBlockSize);
+    }
     this->__parent = parent.get();
     this->__freqStream = _freqStream.get();
 }
@@ -74,13 +83,19 @@ void SegmentTermDocs::seek(const TermEnumPtr& termEnum) {
 
 void SegmentTermDocs::seek(const TermInfoPtr& ti, const TermPtr& term) {
     count = 0;
+    termMaxFreq = 0;
+    termImpacts.clear();
+    changedMaxNorm = -2;
+    currentField = term->_field;
     FieldInfoPtr fi(__parent->core->fieldInfos->fieldInfo(term->_field));
     currentFieldOmitTermFreqAndPositions = fi ? fi->omitTermFreqAndPositions : false;
     currentFieldStoresPayloads = fi ? fi->storePayloads : false;
     if (!ti) {
         df = 0;
+        blockDocs = 0;
     } else {
         df = ti->docFreq;
+        blockDocs = postingsBlockSize == 0 ? 0 : df - (df % postingsBlockSize);
         _doc = 0;
         freqBasePointer = ti->freqPointer;
         proxBasePointer = ti->proxPointer;
@@ -108,11 +123,46 @@ int32_t SegmentTermDocs::freq() {
 void SegmentTermDocs::skippingDoc() {
 }
 
+void SegmentTermDocs::readBlock() {
+    // blocks hold doc deltas and freq - 1, turn them into docs and freqs
+    int32_t* __docBuffer = docBuffer.get();
+    int32_t* __freqBuffer = freqBuffer.get();
+    ForUtil::readBlock(__freqStream, __docBuffer);
+    int32_t doc = _doc;
+    for (int32_t i = 0; i < postingsBlockSize; ++i) {
+        doc += __docBuffer[i];
+        __docBuffer[i] = doc;
+    }
+    if (currentFieldOmitTermFreqAndPositions) {
+        std::fill(__freqBuffer, __freqBuffer + postingsBlockSize, 1);
+    } else {
+        ForUtil::readBlock(__freqStream, __freqBuffer);
+        for (int32_t i = 0; i < postingsBlockSize; ++i) {
+            ++__freqBuffer[i];
+        }
+    }
+}
+
 bool SegmentTermDocs::next() {
     while (true) {
         if (count == df) {
             return false;
         }
+        if (count < blockDocs) {
+            int32_t upto = count & (postingsBlockSize - 1);
+            if (upto == 0) {
+                readBlock();
+            }
+            _doc = docBuffer[upto];
+            _freq = freqBuffer[upto];
+            ++count;
+            if (!__deletedDocs || !__deletedDocs->get(_doc)) {
+                break;
+            }
+            skippingDoc();
+            continue;
+        }
+
         int32_t docCode = __freqStream->readVInt();
 
         if (currentFieldOmitTermFreqAndPositions) {
@@ -141,10 +191,10 @@ int32_t SegmentTermDocs::read(Collection<int32_t>& docs, Collection<int32_t>& fr
     auto* __docs = docs.get();
     auto* __freqs = freqs.get();
     int32_t length = __docs->size();
+    int32_t i = count < blockDocs ? readBlocks(docs, freqs, length) : 0;
     if (currentFieldOmitTermFreqAndPositions) {
-        return readNoTf(docs, freqs, length);
+        return readNoTf(docs, freqs, i, length);
     } else {
-        int32_t i = 0;
         while (i < length && count < df) {
             // manually inlined call to next() for speed
             int32_t docCode = __freqStream->readVInt();
@@ -166,8 +216,40 @@ int32_t SegmentTermDocs::read(Collection<int32_t>& docs, Collection<int32_t>& fr
     }
 }
 
-int32_t SegmentTermDocs::readNoTf(Collection<int32_t>& docs, Collection<int32_t>& freqs, int32_t length) {
+int32_t SegmentTermDocs::readBlocks(Collection<int32_t>& docs, Collection<int32_t>& freqs, int32_t length) {
+    int32_t* __docs = docs.get()->data();
+    int32_t* __freqs = freqs.get()->data();
     int32_t i = 0;
+    while (i < length && count < blockDocs) {
+        int32_t upto = count & (postingsBlockSize - 1);
+        if (upto == 0) {
+            readBlock();
+        }
+        int32_t n = std::min(postingsBlockSize - upto, length - i);
+        const int32_t* bufferDocs = docBuffer.get() + upto;
+        const int32_t* bufferFreqs = freqBuffer.get() + upto;
+        if (!__deletedDocs) {
+            std::copy(bufferDocs, bufferDocs + n, __docs + i);
+            std::copy(bufferFreqs, bufferFreqs + n, __freqs + i);
+            i += n;
+        } else {
+            for (int32_t j = 0; j < n; ++j) {
+                if (!__deletedDocs->get(bufferDocs[j])) {
+                    __docs[i] = bufferDocs[j];
+                    __freqs[i] = bufferFreqs[j];
+                    ++i;
+                }
+            }
+        }
+        count += n;
+        _doc = bufferDocs[n - 1];
+        _freq = bufferFreqs[n - 1];
+    }
+    return i;
+}
+
+int32_t SegmentTermDocs::readNoTf(Collection<int32_t>& docs, Collection<int32_t>& freqs, int32_t start, int32_t length) {
+    int32_t i = start;
     while (i < length && count < df) {
         // manually inlined call to next() for speed
         _doc += __freqStream->readVInt();
@@ -187,18 +269,27 @@ int32_t SegmentTermDocs::readNoTf(Collection<int32_t>& docs, Collection<int32_t>
 void SegmentTermDocs::skipProx(int64_t proxPointer, int32_t payloadLength) {
 }
 
+void SegmentTermDocs::initSkipping() {
+    if (!skipListReader) {
+        skipListReader = newLucene<DefaultSkipListReader>(boost::dynamic_pointer_cast<IndexInput>(__freqStream->clone()), maxSkipLevels, skipInterval, skipImpacts);    // lazily clone
+    }
+
+    if (!haveSkipped) { // lazily initialize skip stream
+        skipListReader->init(skipPointer, freqBasePointer, proxBasePointer, df, currentFieldStoresPayloads);
+        haveSkipped = true;
+    }
+}
+
 bool SegmentTermDocs::skipTo(int32_t target) {
     if (df >= skipInterval) { // optimized case
-        if (!skipListReader) {
-            skipListReader = newLucene<DefaultSkipListReader>(boost::dynamic_pointer_cast<IndexInput>(__freqStream->clone()), maxSkipLevels, skipInterval);    // lazily clone
-        }
-
-        if (!haveSkipped) { // lazily initialize skip stream
-            skipListReader->init(skipPointer, freqBasePointer, proxBasePointer, df, currentFieldStoresPayloads);
-            haveSkipped = true;
-        }
+        initSkipping();
 
         int32_t newCount = skipListReader->skipTo(target);
+        if (postingsBlockSize != 0) {
+            // block encoded skip points are written after the last doc of a block rather than before the
+            // first doc of the next one, so the skipped doc is included in the count
+            ++newCount;
+        }
         if (newCount > count) {
             __freqStream->seek(skipListReader->getFreqPointer());
             skipProx(skipListReader->getProxPointer(), skipListReader->getPayloadLength());
@@ -217,6 +308,89 @@ bool SegmentTermDocs::skipTo(int32_t target) {
     return true;
 }
 
+int32_t SegmentTermDocs::getMaxFreq() {
+    if (termMaxFreq == 0 && df > 0) {
+        Collection<int32_t> impacts(getTermImpacts());
+        if (impacts.empty()) {
+            return -1;
+        }
+        termMaxFreq = impacts[impacts.size() - 2];
+    }
+    return termMaxFreq;
+}
+
+Collection<int32_t> SegmentTermDocs::getTermImpacts() {
+    if (termImpacts.empty() && df > 0) {
+        if (df >= skipInterval) {
+            if (skipImpacts) {
+                initSkipping();
+                Collection<int32_t> impacts(resolveImpacts(skipListReader->getTermImpacts()));
+                termImpacts.addAll(impacts.begin(), impacts.end());
+            }
+        } else {
+            // short postings lists have no skip data, they are VInt encoded in every format so just scan them
+            ByteArray norms(__parent->norms(currentField));
+            CompetitiveImpactAccumulatorPtr accumulator(newLucene<CompetitiveImpactAccumulator>());
+            IndexInputPtr input(boost::dynamic_pointer_cast<IndexInput>(__freqStream->clone()));
+            input->seek(freqBasePointer);
+            int32_t doc = 0;
+            for (int32_t i = 0; i < df; ++i) {
+                int32_t docCode = input->readVInt();
+                int32_t freq = 1;
+                if (currentFieldOmitTermFreqAndPositions) {
+                    doc += docCode;
+                } else {
+                    doc += MiscUtils::unsignedShift(docCode, 1);
+                    if ((docCode & 1) == 0) {
+                        freq = input->readVInt();
+                    }
+                }
+                accumulator->add(freq, norms ? norms[doc] : 0);
+            }
+            input->close();
+            accumulator->getCompetitiveImpacts(termImpacts);
+        }
+    }
+    return termImpacts;
+}
+
+Collection<int32_t> SegmentTermDocs::resolveImpacts(Collection<int32_t> impacts) {
+    if (changedMaxNorm == -2) {
+        changedMaxNorm = __parent->normsChanged(currentField) ? __parent->maxNorm(currentField) : -1;
+    }
+    if (changedMaxNorm == -1) {
+        return impacts;
+    }
+    if (!changedImpacts) {
+        changedImpacts = Collection<int32_t>::newInstance(2);
+    }
+    changedImpacts[0] = impacts[impacts.size() - 2];
+    changedImpacts[1] = changedMaxNorm;
+    return changedImpacts;
+}
+
+int32_t SegmentTermDocs::advanceShallow(int32_t target) {
+    if (df < skipInterval || !skipImpacts) {
+        return INT_MAX;
+    }
+    initSkipping();
+    // skip entries always hold a doc greater than 0, so this reads the first one
+    skipListReader->skipTo(std::max(target, 1));
+    return skipListReader->getNextSkipDoc();
+}
+
+Collection<int32_t> SegmentTermDocs::getBlockImpacts() {
+    if (df < skipInterval || !skipImpacts || !haveSkipped || skipListReader->getNextSkipDoc() == INT_MAX) {
+        return getTermImpacts();
+    }
+    return resolveImpacts(skipListReader->getNextSkipImpacts());
+}
+
+int32_t SegmentTermDocs::getBlockMaxFreq() {
+    Collection<int32_t> impacts(getBlockImpacts());
+    return impacts.empty() ? -1 : impacts[impacts.size() - 2];
+}
+
 IndexInputPtr SegmentTermDocs::freqStream() {
     return _freqStream;
 }
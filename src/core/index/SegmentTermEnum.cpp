@@ -7,6 +7,7 @@
 #include "LuceneInc.h"
 #include "SegmentTermEnum.h"
 #include "TermInfosWriter.h"
+#include "ForUtil.h"
 #include "IndexInput.h"
 #include "TermBuffer.h"
 #include "TermInfo.h"
@@ -27,6 +28,8 @@ SegmentTermEnum::SegmentTermEnum() {
     indexInterval = 0;
     skipInterval = 0;
     maxSkipLevels = 0;
+    postingsBlockSize = 0;
+    skipImpacts = false;
 
     isIndex = false;
     maxSkipLevels = 0;
@@ -45,6 +48,8 @@ SegmentTermEnum::SegmentTermEnum(const IndexInputPtr& i, const FieldInfosPtr& fi
     indexInterval = 0;
     skipInterval = 0;
     maxSkipLevels = 0;
+    postingsBlockSize = 0;
+    skipImpacts = false;
 
     input = i;
     fieldInfos = fis;
@@ -85,6 +90,13 @@ SegmentTermEnum::SegmentTermEnum(const IndexInputPtr& i, const FieldInfosPtr& fi
                 // this new format introduces multi-level skipping
                 maxSkipLevels = input->readInt();
             }
+            if (format <= TermInfosWriter::FORMAT_BLOCK_POSTINGS) {
+                postingsBlockSize = input->readInt();
+                if (postingsBlockSize != 0 && postingsBlockSize != ForUtil::BLOCK_SIZE) {
+                    boost::throw_exception(CorruptIndexException(L"Unsupported postings block size:" + StringUtils::toString(postingsBlockSize)));
+                }
+            }
+            skipImpacts = (format <= TermInfosWriter::FORMAT_SKIP_IMPACTS);
         }
 
         BOOST_ASSERT(indexInterval > 0); // must not be negative
@@ -113,6 +125,8 @@ LuceneObjectPtr SegmentTermEnum::clone(const LuceneObjectPtr& other) {
     cloneEnum->indexInterval = indexInterval;
     cloneEnum->skipInterval = skipInterval;
     cloneEnum->maxSkipLevels = maxSkipLevels;
+    cloneEnum->postingsBlockSize = postingsBlockSize;
+    cloneEnum->skipImpacts = skipImpacts;
 
     cloneEnum->input = boost::dynamic_pointer_cast<IndexInput>(input->clone());
     cloneEnum->_termInfo = newLucene<TermInfo>(_termInfo);
@@ -132,6 +146,14 @@ void SegmentTermEnum::seek(int64_t pointer, int64_t p, const TermPtr& t, const T
     _termInfo->set(ti);
 }
 
+void SegmentTermEnum::seek(int64_t pointer, int64_t p, const String& field, const uint8_t* bytes, int32_t length, const TermInfoPtr& ti) {
+    input->seek(pointer);
+    position = p;
+    termBuffer->set(field, bytes, length);
+    prevBuffer->reset();
+    _termInfo->set(ti);
+}
+
 bool SegmentTermEnum::next() {
     if (position++ >= size - 1) {
         prevBuffer->set(termBuffer);
@@ -165,8 +187,12 @@ bool SegmentTermEnum::next() {
 
 int32_t SegmentTermEnum::scanTo(const TermPtr& term) {
     scanBuffer->set(term);
+    return scanTo(scanBuffer);
+}
+
+int32_t SegmentTermEnum::scanTo(const TermBufferPtr& target) {
     int32_t count = 0;
-    while (scanBuffer->compareTo(termBuffer) > 0 && next()) {
+    while (target->compareTo(termBuffer) > 0 && next()) {
         ++count;
     }
     return count;
@@ -180,6 +206,14 @@ TermPtr SegmentTermEnum::prev() {
     return prevBuffer->toTerm();
 }
 
+TermBufferPtr SegmentTermEnum::getTermBuffer() {
+    return termBuffer;
+}
+
+TermBufferPtr SegmentTermEnum::getPrevBuffer() {
+    return prevBuffer;
+}
+
 TermInfoPtr SegmentTermEnum::termInfo() {
     return newLucene<TermInfo>(_termInfo);
 }
@@ -11,7 +11,7 @@ namespace Lucene {
 
 SegmentWriteState::SegmentWriteState(const DocumentsWriterPtr& docWriter, const DirectoryPtr& directory, const String& segmentName,
                                      const String& docStoreSegmentName, int32_t numDocs, int32_t numDocsInStore,
-                                     int32_t termIndexInterval) {
+                                     int32_t termIndexInterval, bool blockPostings, bool skipImpacts) {
     this->_docWriter = docWriter;
     this->directory = directory;
     this->segmentName = segmentName;
@@ -19,6 +19,8 @@ SegmentWriteState::SegmentWriteState(const DocumentsWriterPtr& docWriter, const
     this->numDocs = numDocs;
     this->numDocsInStore = numDocsInStore;
     this->termIndexInterval = termIndexInterval;
+    this->blockPostings = blockPostings;
+    this->skipImpacts = skipImpacts;
     this->flushedFiles = HashSet<String>::newInstance();
 }
 
@@ -57,7 +57,9 @@ void StoredFieldsWriter::initFieldsWriter() {
         DocumentsWriterPtr docWriter(_docWriter);
         String docStoreSegment(docWriter->getDocStoreSegment());
         if (!docStoreSegment.empty()) {
-            fieldsWriter = newLucene<FieldsWriter>(docWriter->directory, docStoreSegment, fieldInfos);
+            // read from the DocumentsWriter, as asking the IndexWriter would take its lock while it may be
+            // flushing and waiting for this document
+            fieldsWriter = newLucene<FieldsWriter>(docWriter->directory, docStoreSegment, fieldInfos, docWriter->storedFieldsCompression);
             docWriter->addOpenFile(docStoreSegment + L"." + IndexFileNames::FIELDS_EXTENSION());
             docWriter->addOpenFile(docStoreSegment + L"." + IndexFileNames::FIELDS_INDEX_EXTENSION());
             lastDocID = 0;
@@ -17,7 +17,6 @@ namespace Lucene {
 
 TermBuffer::TermBuffer() {
     preUTF8Strings = false;
-    text = newLucene<UnicodeResult>();
     bytes = newLucene<UTF8Result>();
 }
 
@@ -26,23 +25,43 @@ TermBuffer::~TermBuffer() {
 
 int32_t TermBuffer::compareTo(const LuceneObjectPtr& other) {
     TermBufferPtr otherTermBuffer(boost::static_pointer_cast<TermBuffer>(other));
-    if (field == otherTermBuffer->field) {
-        return compareChars(text->result.get(), text->length, otherTermBuffer->text->result.get(), otherTermBuffer->text->length);
+    return compareTo(otherTermBuffer->field, otherTermBuffer->bytes->result.get(), otherTermBuffer->bytes->length);
+}
+
+int32_t TermBuffer::compareTo(const String& otherField, const uint8_t* otherBytes, int32_t otherLength) {
+    if (field == otherField) {
+        return compareBytes(bytes->result.get(), bytes->length, otherBytes, otherLength);
     } else {
-        return field.compare(otherTermBuffer->field);
+        return field.compare(otherField);
     }
 }
 
-int32_t TermBuffer::compareChars(wchar_t* chars1, int32_t len1, wchar_t* chars2, int32_t len2) {
+int32_t TermBuffer::compareBytes(const uint8_t* bytes1, int32_t len1, const uint8_t* bytes2, int32_t len2) {
     int32_t end = len1 < len2 ? len1 : len2;
-    for (int32_t k = 0; k < end; ++k) {
-        wchar_t c1 = chars1[k];
-        wchar_t c2 = chars2[k];
-        if (c1 != c2) {
-            return c1 - c2;
+#ifdef LPP_UNICODE_CHAR_SIZE_2
+    // terms are sorted by their UTF-16 code units, where the surrogates of the supplementary characters
+    // sort before U+E000 to U+FFFF, unlike in UTF-8.  Lead bytes 0xee and 0xef start U+E000 to U+FFFF
+    // and 0xf0 to 0xf4 the supplementary characters, so move the former above the latter at a difference.
+    // See http://icu-project.org/docs/papers/utf16_code_point_order.html#utf-8-in-utf-16-order
+    const uint8_t* diff = std::mismatch(bytes1, bytes1 + end, bytes2).first;
+    if (diff == bytes1 + end) {
+        return len1 - len2;
+    }
+    int32_t byte1 = *diff;
+    int32_t byte2 = bytes2[diff - bytes1];
+    if (byte1 >= 0xee && byte2 >= 0xee) {
+        if ((byte1 & 0xfe) == 0xee) {
+            byte1 += 0x0e;
+        }
+        if ((byte2 & 0xfe) == 0xee) {
+            byte2 += 0x0e;
         }
     }
-    return len1 - len2;
+    return byte1 - byte2;
+#else
+    int32_t diff = end == 0 ? 0 : std::memcmp(bytes1, bytes2, end);
+    return diff != 0 ? diff : len1 - len2;
+#endif
 }
 
 void TermBuffer::setPreUTF8Strings() {
@@ -55,13 +74,17 @@ void TermBuffer::read(const IndexInputPtr& input, const FieldInfosPtr& fieldInfo
     int32_t length = input->readVInt();
     int32_t totalLength = start + length;
     if (preUTF8Strings) {
+        // the shared prefix is counted in chars, so decode the previous term to append to it
+        if (!text) {
+            text = newLucene<UnicodeResult>();
+        }
+        StringUtils::toUnicode(bytes->result.get(), bytes->length, text);
         text->setLength(totalLength);
         text->setLength(start + input->readChars(text->result.get(), start, length));
-    } else {
         StringUtils::toUTF8(text->result.get(), text->length, bytes);
+    } else {
         bytes->setLength(totalLength);
         input->readBytes(bytes->result.get(), start, length);
-        StringUtils::toUnicode(bytes->result.get(), totalLength, text);
     }
     this->field = fieldInfos->fieldName(input->readVInt());
 }
@@ -72,32 +95,55 @@ void TermBuffer::set(const TermPtr& term) {
         return;
     }
     String termText(term->text());
-    int32_t termLen = termText.length();
-    text->setLength(termLen);
-    MiscUtils::arrayCopy(termText.begin(), 0, text->result.get(), 0, termLen);
+    StringUtils::toUTF8(termText.c_str(), termText.length(), bytes);
     field = term->field();
     this->term = term;
 }
 
 void TermBuffer::set(const TermBufferPtr& other) {
-    text->copyText(other->text);
+    bytes->copyText(other->bytes);
     field = other->field;
     term = other->term;
 }
 
+void TermBuffer::set(const String& field, const uint8_t* bytes, int32_t length) {
+    this->bytes->setLength(length);
+    if (length > 0) {
+        MiscUtils::arrayCopy(bytes, 0, this->bytes->result.get(), 0, length);
+    }
+    this->field = field;
+    term.reset();
+}
+
 void TermBuffer::reset() {
     field.clear();
-    text->setLength(0);
+    bytes->setLength(0);
     term.reset();
 }
 
+bool TermBuffer::empty() {
+    return field.empty();
+}
+
+const String& TermBuffer::getField() {
+    return field;
+}
+
+const uint8_t* TermBuffer::getBytes() {
+    return bytes->result.get();
+}
+
+int32_t TermBuffer::getLength() {
+    return bytes->length;
+}
+
 TermPtr TermBuffer::toTerm() {
     if (field.empty()) { // unset
         return TermPtr();
     }
 
     if (!term) {
-        term = newLucene<Term>(field, String(text->result.get(), text->length));
+        term = newLucene<Term>(field, StringUtils::toUnicode(bytes->result.get(), bytes->length));
     }
 
     return term;
@@ -111,8 +157,7 @@ LuceneObjectPtr TermBuffer::clone(const LuceneObjectPtr& other) {
     cloneBuffer->preUTF8Strings = preUTF8Strings;
 
     cloneBuffer->bytes = newLucene<UTF8Result>();
-    cloneBuffer->text = newLucene<UnicodeResult>();
-    cloneBuffer->text->copyText(text);
+    cloneBuffer->bytes->copyText(bytes);
     return cloneBuffer;
 }
 
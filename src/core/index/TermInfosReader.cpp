@@ -7,6 +7,11 @@
 #include "LuceneInc.h"
 #include "TermInfosReader.h"
 #include "SegmentTermEnum.h"
+#include "TermBuffer.h"
+#include "TermsIndex.h"
+#include "TermInfo.h"
+#include "MiscUtils.h"
+#include "UnicodeUtils.h"
 #include "Directory.h"
 #include "IndexFileNames.h"
 #include "Term.h"
@@ -38,23 +43,7 @@ TermInfosReader::TermInfosReader(const DirectoryPtr& dir, const String& seg, con
             SegmentTermEnumPtr indexEnum(newLucene<SegmentTermEnum>(directory->openInput(segment + L"." + IndexFileNames::TERMS_INDEX_EXTENSION(), readBufferSize), fieldInfos, true));
 
             try {
-                int32_t indexSize = 1 + ((int32_t)indexEnum->size - 1) / indexDivisor; // otherwise read index
-
-                indexTerms = Collection<TermPtr>::newInstance(indexSize);
-                indexInfos = Collection<TermInfoPtr>::newInstance(indexSize);
-                indexPointers = Collection<int64_t>::newInstance(indexSize);
-
-                for (int32_t i = 0; indexEnum->next(); ++i) {
-                    indexTerms[i] = indexEnum->term();
-                    indexInfos[i] = indexEnum->termInfo();
-                    indexPointers[i] = indexEnum->indexPointer;
-
-                    for (int32_t j = 1; j < indexDivisor; ++j) {
-                        if (!indexEnum->next()) {
-                            break;
-                        }
-                    }
-                }
+                index = newLucene<TermsIndex>(indexEnum, indexDivisor);
             } catch (LuceneException& e) {
                 finally = e;
             }
@@ -86,6 +75,14 @@ int32_t TermInfosReader::getSkipInterval() {
     return origEnum->skipInterval;
 }
 
+int32_t TermInfosReader::getPostingsBlockSize() {
+    return origEnum->postingsBlockSize;
+}
+
+bool TermInfosReader::hasSkipImpacts() {
+    return origEnum->skipImpacts;
+}
+
 void TermInfosReader::close() {
     if (origEnum) {
         origEnum->close();
@@ -105,19 +102,25 @@ TermInfosReaderThreadResourcesPtr TermInfosReader::getThreadResources() {
 
         // Cache does not have to be thread-safe, it is only used by one thread at the same time
         resources->termInfoCache = newInstance<TermInfoCache>(DEFAULT_CACHE_SIZE);
+        resources->lookupBuffer = newLucene<TermBuffer>();
+        resources->indexText = newLucene<UTF8Result>();
+        resources->indexInfo = newLucene<TermInfo>();
         threadResources.set(resources);
     }
     return resources;
 }
 
-int32_t TermInfosReader::getIndexOffset(const TermPtr& term) {
-    // binary search indexTerms
-    Collection<TermPtr>::iterator indexTerm = std::upper_bound(indexTerms.begin(), indexTerms.end(), term, luceneCompare<TermPtr>());
-    return (std::distance(indexTerms.begin(), indexTerm) - 1);
+int32_t TermInfosReader::compareIndexTerm(const TermBufferPtr& term, int32_t indexOffset) {
+    return index->compareTo(term->getField(), term->getBytes(), term->getLength(), indexOffset);
 }
 
-void TermInfosReader::seekEnum(const SegmentTermEnumPtr& enumerator, int32_t indexOffset) {
-    enumerator->seek(indexPointers[indexOffset], ((int64_t)indexOffset * (int64_t)totalIndexInterval) - 1, indexTerms[indexOffset], indexInfos[indexOffset]);
+int32_t TermInfosReader::getIndexOffset(const TermBufferPtr& term) {
+    return index->getIndexOffset(term->getField(), term->getBytes(), term->getLength());
+}
+
+void TermInfosReader::seekEnum(const TermInfosReaderThreadResourcesPtr& resources, int32_t indexOffset) {
+    int64_t indexPointer = index->getEntry(indexOffset, resources->indexText, resources->indexInfo);
+    resources->termEnum->seek(indexPointer, ((int64_t)indexOffset * (int64_t)totalIndexInterval) - 1, index->getField(indexOffset), resources->indexText->result.get(), resources->indexText->length, resources->indexInfo);
 }
 
 TermInfoPtr TermInfosReader::get(const TermPtr& term) {
@@ -147,15 +150,21 @@ TermInfoPtr TermInfosReader::get(const TermPtr& term, bool useCache) {
     // optimize sequential access: first try scanning cached enum without seeking
     SegmentTermEnumPtr enumerator = resources->termEnum;
 
-    if (enumerator->term() && // term is at or past current
-            ((enumerator->prev() && term->compareTo(enumerator->prev()) > 0) ||
-             term->compareTo(enumerator->term()) >= 0)) {
+    // compare the UTF-8 encoded term with the enumerated terms, without decoding them
+    TermBufferPtr lookup(resources->lookupBuffer);
+    lookup->set(term);
+    TermBufferPtr enumTerm(enumerator->getTermBuffer());
+    TermBufferPtr enumPrev(enumerator->getPrevBuffer());
+
+    if (!enumTerm->empty() && // term is at or past current
+            ((!enumPrev->empty() && lookup->compareTo(enumPrev) > 0) ||
+             lookup->compareTo(enumTerm) >= 0)) {
         int32_t enumOffset = (int32_t)(enumerator->position / totalIndexInterval ) + 1;
-        if (indexTerms.size() == enumOffset || // but before end of block
-                term->compareTo(indexTerms[enumOffset]) < 0) {
+        if (index->size() == enumOffset || // but before end of block
+                compareIndexTerm(lookup, enumOffset) < 0) {
             // no need to seek
-            int32_t numScans = enumerator->scanTo(term);
-            if (enumerator->term() && term->compareTo(enumerator->term()) == 0) {
+            int32_t numScans = enumerator->scanTo(lookup);
+            if (!enumTerm->empty() && lookup->compareTo(enumTerm) == 0) {
                 ti = enumerator->termInfo();
                 if (cache && numScans > 1) {
                     // we only want to put this TermInfo into the cache if scanEnum skipped more
@@ -171,9 +180,9 @@ TermInfoPtr TermInfosReader::get(const TermPtr& term, bool useCache) {
     }
 
     // random-access: must seek
-    seekEnum(enumerator, getIndexOffset(term));
-    enumerator->scanTo(term);
-    if (enumerator->term() && term->compareTo(enumerator->term()) == 0) {
+    seekEnum(resources, getIndexOffset(lookup));
+    enumerator->scanTo(lookup);
+    if (!enumTerm->empty() && lookup->compareTo(enumTerm) == 0) {
         ti = enumerator->termInfo();
         if (cache) {
             cache->put(term, ti);
@@ -185,7 +194,7 @@ TermInfoPtr TermInfosReader::get(const TermPtr& term, bool useCache) {
 }
 
 void TermInfosReader::ensureIndexIsRead() {
-    if (!indexTerms) {
+    if (!index) {
         boost::throw_exception(IllegalStateException(L"terms index was not loaded when this reader was created"));
     }
 }
@@ -196,15 +205,16 @@ int64_t TermInfosReader::getPosition(const TermPtr& term) {
     }
 
     ensureIndexIsRead();
-    int32_t indexOffset = getIndexOffset(term);
-
-    SegmentTermEnumPtr enumerator(getThreadResources()->termEnum);
-    seekEnum(enumerator, indexOffset);
+    TermInfosReaderThreadResourcesPtr resources(getThreadResources());
+    TermBufferPtr lookup(resources->lookupBuffer);
+    lookup->set(term);
 
-    while (term->compareTo(enumerator->term()) > 0 && enumerator->next()) {
-    }
+    SegmentTermEnumPtr enumerator(resources->termEnum);
+    seekEnum(resources, getIndexOffset(lookup));
+    enumerator->scanTo(lookup);
 
-    return term->compareTo(enumerator->term()) == 0 ? enumerator->position : -1;
+    TermBufferPtr enumTerm(enumerator->getTermBuffer());
+    return (!enumTerm->empty() && lookup->compareTo(enumTerm) == 0) ? enumerator->position : -1;
 }
 
 SegmentTermEnumPtr TermInfosReader::terms() {
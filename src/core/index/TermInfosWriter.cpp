@@ -23,16 +23,22 @@ const int32_t TermInfosWriter::FORMAT = -3;
 /// Changed strings to true utf8 with length-in-bytes not length-in-chars.
 const int32_t TermInfosWriter::FORMAT_VERSION_UTF8_LENGTH_IN_BYTES = -4;
 
+/// Added the postings block size, non-zero when doc deltas and freqs are stored in bit packed blocks.
+const int32_t TermInfosWriter::FORMAT_BLOCK_POSTINGS = -5;
+
+/// Added the competitive (term freq, norm) pairs of every skip interval and of the whole term to the skip data.
+const int32_t TermInfosWriter::FORMAT_SKIP_IMPACTS = -6;
+
 /// NOTE: always change this if you switch to a new format.
-const int32_t TermInfosWriter::FORMAT_CURRENT = TermInfosWriter::FORMAT_VERSION_UTF8_LENGTH_IN_BYTES;
+const int32_t TermInfosWriter::FORMAT_CURRENT = TermInfosWriter::FORMAT_SKIP_IMPACTS;
 
-TermInfosWriter::TermInfosWriter(const DirectoryPtr& directory, const String& segment, const FieldInfosPtr& fis, int32_t interval) {
-    initialize(directory, segment, fis, interval, false);
-    otherWriter = newLucene<TermInfosWriter>(directory, segment, fis, interval, true);
+TermInfosWriter::TermInfosWriter(const DirectoryPtr& directory, const String& segment, const FieldInfosPtr& fis, int32_t interval, int32_t postingsBlockSize, bool skipImpacts) {
+    initialize(directory, segment, fis, interval, postingsBlockSize, skipImpacts, false);
+    otherWriter = newLucene<TermInfosWriter>(directory, segment, fis, interval, postingsBlockSize, skipImpacts, true);
 }
 
-TermInfosWriter::TermInfosWriter(const DirectoryPtr& directory, const String& segment, const FieldInfosPtr& fis, int32_t interval, bool isIndex) {
-    initialize(directory, segment, fis, interval, isIndex);
+TermInfosWriter::TermInfosWriter(const DirectoryPtr& directory, const String& segment, const FieldInfosPtr& fis, int32_t interval, int32_t postingsBlockSize, bool skipImpacts, bool isIndex) {
+    initialize(directory, segment, fis, interval, postingsBlockSize, skipImpacts, isIndex);
 }
 
 TermInfosWriter::~TermInfosWriter() {
@@ -45,14 +51,16 @@ void TermInfosWriter::initialize() {
     }
 }
 
-void TermInfosWriter::initialize(const DirectoryPtr& directory, const String& segment, const FieldInfosPtr& fis, int32_t interval, bool isi) {
+void TermInfosWriter::initialize(const DirectoryPtr& directory, const String& segment, const FieldInfosPtr& fis, int32_t interval, int32_t postingsBlockSize, bool skipImpacts, bool isi) {
     lastTi = newLucene<TermInfo>();
     utf8Result = newLucene<UTF8Result>();
     lastTermBytes = ByteArray::newInstance(10);
     lastTermBytesLength = 0;
     lastFieldNumber = -1;
-    skipInterval = 16;
+    skipInterval = postingsBlockSize > 0 ? postingsBlockSize : 16;
     maxSkipLevels = 10;
+    this->postingsBlockSize = postingsBlockSize;
+    this->skipImpacts = skipImpacts;
     size = 0;
     lastIndexPointer = 0;
 
@@ -60,11 +68,15 @@ void TermInfosWriter::initialize(const DirectoryPtr& directory, const String& se
     fieldInfos = fis;
     isIndex = isi;
     output = directory->createOutput(segment + (isIndex ? L".tii" : L".tis"));
-    output->writeInt(FORMAT_CURRENT); // write format
+    int32_t format = getFormat();
+    output->writeInt(format); // write format
     output->writeLong(0); // leave space for size
     output->writeInt(indexInterval); // write indexInterval
     output->writeInt(skipInterval); // write skipInterval
     output->writeInt(maxSkipLevels); // write maxSkipLevels
+    if (format <= FORMAT_BLOCK_POSTINGS) {
+        output->writeInt(postingsBlockSize); // write postingsBlockSize
+    }
     BOOST_ASSERT(initUnicodeResults());
 }
 
@@ -73,6 +85,13 @@ void TermInfosWriter::add(const TermPtr& term, const TermInfoPtr& ti) {
     add(fieldInfos->fieldNumber(term->_field), utf8Result->result, utf8Result->length, ti);
 }
 
+int32_t TermInfosWriter::getFormat() {
+    if (skipImpacts) {
+        return FORMAT_SKIP_IMPACTS;
+    }
+    return postingsBlockSize != 0 ? FORMAT_BLOCK_POSTINGS : FORMAT_VERSION_UTF8_LENGTH_IN_BYTES;
+}
+
 bool TermInfosWriter::initUnicodeResults() {
     unicodeResult1 = newLucene<UnicodeResult>();
     unicodeResult2 = newLucene<UnicodeResult>();
@@ -0,0 +1,279 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "TermsIndex.h"
+#include "SegmentTermEnum.h"
+#include "TermBuffer.h"
+#include "TermInfo.h"
+#include "MiscUtils.h"
+#include "UnicodeUtils.h"
+
+namespace Lucene {
+
+const int32_t TermsIndex::BLOCK_SIZE = 16;
+
+static void writeVLong(ByteArray& bytes, int32_t& pos, int64_t i) {
+    if (pos + 10 > bytes.size()) {
+        bytes.resize(std::max(pos + 10, (int32_t)(1.5 * (double)bytes.size())));
+    }
+    while ((i & ~0x7f) != 0) {
+        bytes[pos++] = (uint8_t)((i & 0x7f) | 0x80);
+        i = MiscUtils::unsignedShift(i, (int64_t)7);
+    }
+    bytes[pos++] = (uint8_t)i;
+}
+
+static int64_t readVLong(const uint8_t* bytes, int32_t& pos) {
+    uint8_t b = bytes[pos++];
+    int64_t i = (b & 0x7f);
+    for (int32_t shift = 7; (b & 0x80) != 0; shift += 7) {
+        b = bytes[pos++];
+        i |= (int64_t)(b & 0x7f) << shift;
+    }
+    return i;
+}
+
+static int32_t readVInt(const uint8_t* bytes, int32_t& pos) {
+    return (int32_t)readVLong(bytes, pos);
+}
+
+TermsIndex::TermsIndex(const SegmentTermEnumPtr& indexEnum, int32_t indexDivisor) {
+    bytes = ByteArray::newInstance(1024);
+    numEntries = 0;
+    blockOffsets = Collection<int32_t>::newInstance();
+    blockEntries = Collection<int32_t>::newInstance();
+    fieldNames = Collection<String>::newInstance();
+    fieldBlocks = Collection<int32_t>::newInstance();
+
+    int32_t numBytes = 0;
+    ByteArray lastText(ByteArray::newInstance(64));
+    int32_t lastLength = 0;
+    TermInfoPtr termInfo(newLucene<TermInfo>());
+    int64_t lastFreqPointer = 0;
+    int64_t lastProxPointer = 0;
+    int64_t lastIndexPointer = 0;
+
+    while (indexEnum->next()) {
+        TermBufferPtr term(indexEnum->getTermBuffer());
+        const uint8_t* text = term->getBytes();
+        int32_t length = term->getLength();
+        indexEnum->termInfo(termInfo);
+
+        bool newField = (fieldNames.empty() || fieldNames[fieldNames.size() - 1] != term->getField());
+        if (newField) {
+            fieldNames.add(term->getField());
+            fieldBlocks.add(blockOffsets.size());
+        }
+        bool newBlock = (newField || numEntries - blockEntries[blockEntries.size() - 1] == BLOCK_SIZE);
+        if (newBlock) {
+            blockOffsets.add(numBytes);
+            blockEntries.add(numEntries);
+        }
+
+        int32_t prefix = 0;
+        if (!newBlock) {
+            int32_t end = std::min(length, lastLength);
+            while (prefix < end && text[prefix] == lastText[prefix]) {
+                ++prefix;
+            }
+        }
+        int32_t suffix = length - prefix;
+        writeVLong(bytes, numBytes, prefix);
+        writeVLong(bytes, numBytes, suffix);
+        if (numBytes + suffix > bytes.size()) {
+            bytes.resize(std::max(numBytes + suffix, (int32_t)(1.5 * (double)bytes.size())));
+        }
+        if (suffix > 0) {
+            MiscUtils::arrayCopy(text, prefix, bytes.get(), numBytes, suffix);
+        }
+        numBytes += suffix;
+
+        writeVLong(bytes, numBytes, termInfo->docFreq);
+        writeVLong(bytes, numBytes, termInfo->skipOffset);
+        if (newBlock) {
+            writeVLong(bytes, numBytes, termInfo->freqPointer);
+            writeVLong(bytes, numBytes, termInfo->proxPointer);
+            writeVLong(bytes, numBytes, indexEnum->indexPointer);
+        } else {
+            writeVLong(bytes, numBytes, termInfo->freqPointer - lastFreqPointer);
+            writeVLong(bytes, numBytes, termInfo->proxPointer - lastProxPointer);
+            writeVLong(bytes, numBytes, indexEnum->indexPointer - lastIndexPointer);
+        }
+        lastFreqPointer = termInfo->freqPointer;
+        lastProxPointer = termInfo->proxPointer;
+        lastIndexPointer = indexEnum->indexPointer;
+
+        if (length > lastText.size()) {
+            lastText.resize((int32_t)(1.5 * (double)length));
+        }
+        if (length > 0) {
+            MiscUtils::arrayCopy(text, 0, lastText.get(), 0, length);
+        }
+        lastLength = length;
+        ++numEntries;
+
+        for (int32_t j = 1; j < indexDivisor; ++j) {
+            if (!indexEnum->next()) {
+                break;
+            }
+        }
+    }
+
+    blockEntries.add(numEntries);
+    fieldBlocks.add(blockOffsets.size());
+    bytes.resize(std::max(numBytes, 1));
+}
+
+TermsIndex::~TermsIndex() {
+}
+
+int32_t TermsIndex::size() {
+    return numEntries;
+}
+
+int64_t TermsIndex::sizeInBytes() {
+    return bytes.size();
+}
+
+int32_t TermsIndex::getBlock(int32_t indexOffset) {
+    return (int32_t)(std::upper_bound(blockEntries.begin(), blockEntries.end(), indexOffset) - blockEntries.begin()) - 1;
+}
+
+int32_t TermsIndex::getFieldOfBlock(int32_t block) {
+    return (int32_t)(std::upper_bound(fieldBlocks.begin(), fieldBlocks.end(), block) - fieldBlocks.begin()) - 1;
+}
+
+const String& TermsIndex::getField(int32_t indexOffset) {
+    return fieldNames[getFieldOfBlock(getBlock(indexOffset))];
+}
+
+int32_t TermsIndex::scanBlock(int32_t block, const uint8_t* text, int32_t length, int32_t last, int32_t& cmp) {
+    const uint8_t* data = bytes.get();
+    int32_t pos = blockOffsets[block];
+    int32_t lcp = 0; // length of the prefix shared by text and the current entry
+    cmp = 0;
+    for (int32_t i = 0; i <= last; ++i) {
+        int32_t prefix = readVInt(data, pos);
+        int32_t suffix = readVInt(data, pos);
+        if (i == 0 || prefix == lcp) {
+            const uint8_t* suffixBytes = data + pos;
+            int32_t end = std::min(suffix, length - prefix);
+            int32_t j = 0;
+            while (j < end && suffixBytes[j] == text[prefix + j]) {
+                ++j;
+            }
+            lcp = prefix + j;
+            if (j < end) {
+                // in the same order as the block search, which may not be the order of the bytes
+                cmp = TermBuffer::compareBytes(suffixBytes + j, 1, text + lcp, 1) < 0 ? -1 : 1;
+            } else {
+                cmp = prefix + suffix == length ? 0 : (prefix + suffix < length ? -1 : 1);
+            }
+        } else if (prefix < lcp) {
+            // the entry differs from the previous one, which shares lcp bytes with text, before lcp
+            cmp = 1;
+        }
+        // otherwise the entry shares more than lcp bytes with the previous one, so compares the same
+        if (cmp > 0) {
+            return i;
+        }
+        pos += suffix;
+        readVInt(data, pos); // doc freq
+        readVInt(data, pos); // skip offset
+        readVLong(data, pos); // freq pointer
+        readVLong(data, pos); // prox pointer
+        readVLong(data, pos); // index pointer
+    }
+    return last + 1;
+}
+
+int32_t TermsIndex::getIndexOffset(const String& field, const uint8_t* text, int32_t length) {
+    if (numEntries == 0) {
+        return -1;
+    }
+    Collection<String>::iterator fieldName = std::lower_bound(fieldNames.begin(), fieldNames.end(), field);
+    int32_t fieldIndex = (int32_t)(fieldName - fieldNames.begin());
+    int32_t firstBlock = fieldBlocks[fieldIndex];
+    if (fieldName == fieldNames.end() || *fieldName != field) {
+        // every entry of the preceding fields is less than the term
+        return blockEntries[firstBlock] - 1;
+    }
+
+    // binary search for the last block of the field starting with an entry less than or equal to the term
+    const uint8_t* data = bytes.get();
+    int32_t low = firstBlock;
+    int32_t high = fieldBlocks[fieldIndex + 1] - 1;
+    int32_t block = firstBlock - 1;
+    while (low <= high) {
+        int32_t mid = (low + high) >> 1;
+        int32_t pos = blockOffsets[mid];
+        readVInt(data, pos); // prefix, always 0
+        int32_t firstLength = readVInt(data, pos);
+        if (TermBuffer::compareBytes(data + pos, firstLength, text, length) <= 0) {
+            block = mid;
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    if (block < firstBlock) {
+        return blockEntries[firstBlock] - 1;
+    }
+
+    int32_t cmp;
+    int32_t count = scanBlock(block, text, length, blockEntries[block + 1] - blockEntries[block] - 1, cmp);
+    return blockEntries[block] + count - 1;
+}
+
+int32_t TermsIndex::compareTo(const String& field, const uint8_t* text, int32_t length, int32_t indexOffset) {
+    int32_t block = getBlock(indexOffset);
+    int32_t fieldCmp = field.compare(fieldNames[getFieldOfBlock(block)]);
+    if (fieldCmp != 0) {
+        return fieldCmp;
+    }
+    int32_t last = indexOffset - blockEntries[block];
+    int32_t cmp;
+    if (scanBlock(block, text, length, last, cmp) <= last) {
+        return -1; // an entry up to indexOffset is greater than text
+    }
+    return -cmp;
+}
+
+int64_t TermsIndex::getEntry(int32_t indexOffset, const UTF8ResultPtr& text, const TermInfoPtr& termInfo) {
+    const uint8_t* data = bytes.get();
+    int32_t block = getBlock(indexOffset);
+    int32_t pos = blockOffsets[block];
+    int32_t docFreq = 0;
+    int32_t skipOffset = 0;
+    int64_t freqPointer = 0;
+    int64_t proxPointer = 0;
+    int64_t indexPointer = 0;
+    for (int32_t i = blockEntries[block]; i <= indexOffset; ++i) {
+        int32_t prefix = readVInt(data, pos);
+        int32_t suffix = readVInt(data, pos);
+        text->setLength(prefix + suffix);
+        if (suffix > 0) {
+            MiscUtils::arrayCopy(data, pos, text->result.get(), prefix, suffix);
+        }
+        pos += suffix;
+        docFreq = readVInt(data, pos);
+        skipOffset = readVInt(data, pos);
+        if (i == blockEntries[block]) {
+            freqPointer = readVLong(data, pos);
+            proxPointer = readVLong(data, pos);
+            indexPointer = readVLong(data, pos);
+        } else {
+            freqPointer += readVLong(data, pos);
+            proxPointer += readVLong(data, pos);
+            indexPointer += readVLong(data, pos);
+        }
+    }
+    termInfo->set(docFreq, freqPointer, proxPointer, skipOffset);
+    return indexPointer;
+}
+
+}
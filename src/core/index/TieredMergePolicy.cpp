@@ -0,0 +1,499 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "TieredMergePolicy.h"
+#include "IndexWriter.h"
+#include "SegmentInfo.h"
+#include "StringUtils.h"
+
+namespace Lucene {
+
+/// Default noCFSRatio.  If a merge's size is >= 10% of the index, then we disable compound file for it.
+const double TieredMergePolicy::DEFAULT_NO_CFS_RATIO = 0.1;
+
+typedef std::pair<int64_t, SegmentInfoPtr> SegmentSize;
+
+/// Orders segments by decreasing size, then by name so that the order is deterministic.
+static bool segmentByteSizeDescending(const SegmentSize& first, const SegmentSize& second) {
+    if (first.first != second.first) {
+        return first.first > second.first;
+    }
+    return first.second->name < second.second->name;
+}
+
+TieredMergePolicy::TieredMergePolicy(const IndexWriterPtr& writer) : MergePolicy(writer) {
+    maxMergeAtOnce = 10;
+    maxMergedSegmentBytes = (int64_t)5 * 1024 * 1024 * 1024;
+    maxMergeAtOnceExplicit = 30;
+    floorSegmentBytes = 2 * 1024 * 1024;
+    segsPerTier = 10.0;
+    expungeDeletesPctAllowed = 10.0;
+    _useCompoundFile = true;
+    _useCompoundDocStore = true;
+    noCFSRatio = DEFAULT_NO_CFS_RATIO;
+    reclaimDeletesWeight = 2.0;
+}
+
+TieredMergePolicy::~TieredMergePolicy() {
+}
+
+void TieredMergePolicy::setMaxMergeAtOnce(int32_t maxMergeAtOnce) {
+    if (maxMergeAtOnce < 2) {
+        boost::throw_exception(IllegalArgumentException(L"maxMergeAtOnce must be > 1 (got " + StringUtils::toString(maxMergeAtOnce) + L")"));
+    }
+    this->maxMergeAtOnce = maxMergeAtOnce;
+}
+
+int32_t TieredMergePolicy::getMaxMergeAtOnce() {
+    return maxMergeAtOnce;
+}
+
+void TieredMergePolicy::setMaxMergeAtOnceExplicit(int32_t maxMergeAtOnceExplicit) {
+    if (maxMergeAtOnceExplicit < 2) {
+        boost::throw_exception(IllegalArgumentException(L"maxMergeAtOnceExplicit must be > 1 (got " + StringUtils::toString(maxMergeAtOnceExplicit) + L")"));
+    }
+    this->maxMergeAtOnceExplicit = maxMergeAtOnceExplicit;
+}
+
+int32_t TieredMergePolicy::getMaxMergeAtOnceExplicit() {
+    return maxMergeAtOnceExplicit;
+}
+
+void TieredMergePolicy::setMaxMergedSegmentMB(double mb) {
+    if (mb <= 0.0) {
+        boost::throw_exception(IllegalArgumentException(L"maxMergedSegmentMB must be > 0 (got " + StringUtils::toString(mb) + L")"));
+    }
+    mb *= 1024.0 * 1024.0;
+    maxMergedSegmentBytes = mb > (double)LLONG_MAX ? LLONG_MAX : (int64_t)mb;
+}
+
+double TieredMergePolicy::getMaxMergedSegmentMB() {
+    return (double)maxMergedSegmentBytes / 1024.0 / 1024.0;
+}
+
+void TieredMergePolicy::setReclaimDeletesWeight(double weight) {
+    if (weight < 0.0) {
+        boost::throw_exception(IllegalArgumentException(L"reclaimDeletesWeight must be >= 0.0 (got " + StringUtils::toString(weight) + L")"));
+    }
+    reclaimDeletesWeight = weight;
+}
+
+double TieredMergePolicy::getReclaimDeletesWeight() {
+    return reclaimDeletesWeight;
+}
+
+void TieredMergePolicy::setFloorSegmentMB(double mb) {
+    if (mb <= 0.0) {
+        boost::throw_exception(IllegalArgumentException(L"floorSegmentMB must be > 0.0 (got " + StringUtils::toString(mb) + L")"));
+    }
+    mb *= 1024.0 * 1024.0;
+    floorSegmentBytes = mb > (double)LLONG_MAX ? LLONG_MAX : (int64_t)mb;
+}
+
+double TieredMergePolicy::getFloorSegmentMB() {
+    return (double)floorSegmentBytes / 1024.0 / 1024.0;
+}
+
+void TieredMergePolicy::setExpungeDeletesPctAllowed(double pct) {
+    if (pct < 0.0 || pct > 100.0) {
+        boost::throw_exception(IllegalArgumentException(L"expungeDeletesPctAllowed must be between 0.0 and 100.0 inclusive (got " + StringUtils::toString(pct) + L")"));
+    }
+    expungeDeletesPctAllowed = pct;
+}
+
+double TieredMergePolicy::getExpungeDeletesPctAllowed() {
+    return expungeDeletesPctAllowed;
+}
+
+void TieredMergePolicy::setSegmentsPerTier(double segsPerTier) {
+    if (segsPerTier < 2.0) {
+        boost::throw_exception(IllegalArgumentException(L"segmentsPerTier must be >= 2.0 (got " + StringUtils::toString(segsPerTier) + L")"));
+    }
+    this->segsPerTier = segsPerTier;
+}
+
+double TieredMergePolicy::getSegmentsPerTier() {
+    return segsPerTier;
+}
+
+void TieredMergePolicy::setUseCompoundFile(bool useCompoundFile) {
+    _useCompoundFile = useCompoundFile;
+}
+
+bool TieredMergePolicy::getUseCompoundFile() {
+    return _useCompoundFile;
+}
+
+void TieredMergePolicy::setUseCompoundDocStore(bool useCompoundDocStore) {
+    _useCompoundDocStore = useCompoundDocStore;
+}
+
+bool TieredMergePolicy::getUseCompoundDocStore() {
+    return _useCompoundDocStore;
+}
+
+void TieredMergePolicy::setNoCFSRatio(double noCFSRatio) {
+    if (noCFSRatio < 0.0 || noCFSRatio > 1.0) {
+        boost::throw_exception(IllegalArgumentException(L"noCFSRatio must be 0.0 to 1.0 inclusive; got " + StringUtils::toString(noCFSRatio)));
+    }
+    this->noCFSRatio = noCFSRatio;
+}
+
+double TieredMergePolicy::getNoCFSRatio() {
+    return noCFSRatio;
+}
+
+bool TieredMergePolicy::verbose() {
+    return (!_writer.expired() && IndexWriterPtr(_writer)->verbose());
+}
+
+void TieredMergePolicy::message(const String& message) {
+    if (verbose()) {
+        IndexWriterPtr(_writer)->message(L"TMP: " + message);
+    }
+}
+
+int64_t TieredMergePolicy::size(const SegmentInfoPtr& info) {
+    int64_t byteSize = info->sizeInBytes();
+    int32_t delCount = IndexWriterPtr(_writer)->numDeletedDocs(info);
+    double delRatio = info->docCount <= 0 ? 0.0 : ((double)delCount / (double)info->docCount);
+    BOOST_ASSERT(delRatio <= 1.0);
+    return info->docCount <= 0 ? byteSize : (int64_t)((double)byteSize * (1.0 - delRatio));
+}
+
+int64_t TieredMergePolicy::floorSize(int64_t bytes) {
+    return std::max(floorSegmentBytes, bytes);
+}
+
+Collection<SegmentInfoPtr> TieredMergePolicy::sortBySize(Collection<SegmentInfoPtr> infos) {
+    std::vector<SegmentSize> sizes;
+    sizes.reserve(infos.size());
+    for (Collection<SegmentInfoPtr>::iterator info = infos.begin(); info != infos.end(); ++info) {
+        sizes.push_back(SegmentSize(size(*info), *info));
+    }
+    std::sort(sizes.begin(), sizes.end(), segmentByteSizeDescending);
+    Collection<SegmentInfoPtr> sorted(Collection<SegmentInfoPtr>::newInstance(sizes.size()));
+    for (int32_t i = 0; i < (int32_t)sizes.size(); ++i) {
+        sorted[i] = sizes[i].second;
+    }
+    return sorted;
+}
+
+MergeSpecificationPtr TieredMergePolicy::findMerges(const SegmentInfosPtr& segmentInfos) {
+    if (verbose()) {
+        message(L"findMerges: " + StringUtils::toString(segmentInfos->size()) + L" segments");
+    }
+    if (segmentInfos->empty()) {
+        return MergeSpecificationPtr();
+    }
+    SetSegmentInfo merging(IndexWriterPtr(_writer)->getMergingSegments());
+    SetSegmentInfo toBeMerged(SetSegmentInfo::newInstance());
+
+    Collection<SegmentInfoPtr> infosSorted(Collection<SegmentInfoPtr>::newInstance());
+    for (int32_t i = 0; i < segmentInfos->size(); ++i) {
+        infosSorted.add(segmentInfos->info(i));
+    }
+    infosSorted = sortBySize(infosSorted);
+
+    // Compute total index bytes & print details about the index
+    int64_t totIndexBytes = 0;
+    int64_t minSegmentBytes = LLONG_MAX;
+    for (Collection<SegmentInfoPtr>::iterator info = infosSorted.begin(); info != infosSorted.end(); ++info) {
+        int64_t segBytes = size(*info);
+        if (verbose()) {
+            String extra(merging.contains(*info) ? L" [merging]" : L"");
+            if ((double)segBytes >= (double)maxMergedSegmentBytes / 2.0) {
+                extra += L" [skip: too large]";
+            } else if (segBytes < floorSegmentBytes) {
+                extra += L" [floored]";
+            }
+            message(L"  seg=" + (*info)->name + L" size=" + StringUtils::toString(segBytes) + L" bytes" + extra);
+        }
+        minSegmentBytes = std::min(segBytes, minSegmentBytes);
+        totIndexBytes += segBytes;
+    }
+
+    // If we have too-large segments, grace them out of the maxSegmentCount
+    int32_t tooBigCount = 0;
+    while (tooBigCount < infosSorted.size() && (double)size(infosSorted[tooBigCount]) >= (double)maxMergedSegmentBytes / 2.0) {
+        totIndexBytes -= size(infosSorted[tooBigCount]);
+        ++tooBigCount;
+    }
+
+    minSegmentBytes = floorSize(minSegmentBytes);
+
+    // Compute max allowed segs in the index
+    int64_t levelSize = minSegmentBytes;
+    int64_t bytesLeft = totIndexBytes;
+    double allowedSegCount = 0;
+    while (true) {
+        double segCountLevel = (double)bytesLeft / (double)levelSize;
+        if (segCountLevel < segsPerTier) {
+            allowedSegCount += std::ceil(segCountLevel);
+            break;
+        }
+        allowedSegCount += segsPerTier;
+        bytesLeft -= (int64_t)(segsPerTier * (double)levelSize);
+        levelSize *= maxMergeAtOnce;
+    }
+    int32_t allowedSegCountInt = (int32_t)allowedSegCount;
+
+    MergeSpecificationPtr spec;
+
+    // Cycle to possibly select more than one merge
+    while (true) {
+        int64_t mergingBytes = 0;
+
+        // Gather eligible segments for merging, ie segments not already being merged and not already picked
+        // (by a prior iteration of this loop) for merging
+        Collection<SegmentInfoPtr> eligible(Collection<SegmentInfoPtr>::newInstance());
+        for (int32_t idx = tooBigCount; idx < infosSorted.size(); ++idx) {
+            SegmentInfoPtr info(infosSorted[idx]);
+            if (merging.contains(info)) {
+                mergingBytes += info->sizeInBytes();
+            } else if (!toBeMerged.contains(info)) {
+                eligible.add(info);
+            }
+        }
+
+        bool maxMergeIsRunning = (mergingBytes >= maxMergedSegmentBytes);
+
+        if (verbose()) {
+            message(L"  allowedSegmentCount=" + StringUtils::toString(allowedSegCountInt) + L" vs count=" + StringUtils::toString(infosSorted.size()) +
+                    L" (eligible count=" + StringUtils::toString(eligible.size()) + L") tooBigCount=" + StringUtils::toString(tooBigCount));
+        }
+
+        if (eligible.empty() || eligible.size() < allowedSegCountInt) {
+            return spec;
+        }
+
+        // OK we are over budget -- find best merge!
+        double bestScore = 0.0;
+        Collection<SegmentInfoPtr> best;
+        bool bestTooLarge = false;
+        int64_t bestMergeBytes = 0;
+
+        // Consider all merge starts
+        for (int32_t startIdx = 0; startIdx <= eligible.size() - maxMergeAtOnce; ++startIdx) {
+            int64_t totAfterMergeBytes = 0;
+            Collection<SegmentInfoPtr> candidate(Collection<SegmentInfoPtr>::newInstance());
+            bool hitTooLarge = false;
+            for (int32_t idx = startIdx; idx < eligible.size() && candidate.size() < maxMergeAtOnce; ++idx) {
+                SegmentInfoPtr info(eligible[idx]);
+                int64_t segBytes = size(info);
+
+                if (totAfterMergeBytes + segBytes > maxMergedSegmentBytes) {
+                    hitTooLarge = true;
+                    // NOTE: we continue, so that we can try "packing" smaller segments into this merge to
+                    // see if we can get closer to the max size; this in general is not perfect since this
+                    // is really "bin packing" and we'd have to try different permutations.
+                    continue;
+                }
+                candidate.add(info);
+                totAfterMergeBytes += segBytes;
+            }
+
+            double mergeScore = score(candidate, hitTooLarge);
+            if (verbose()) {
+                message(L"  maybe=" + StringUtils::toString(candidate.size()) + L" segments score=" + StringUtils::toString(mergeScore) +
+                        L" tooLarge=" + StringUtils::toString(hitTooLarge) + L" size=" + StringUtils::toString(totAfterMergeBytes) + L" bytes");
+            }
+
+            // If we are already running a max sized merge (maxMergeIsRunning), don't allow another max
+            // sized merge to kick off
+            if ((!best || mergeScore < bestScore) && (!hitTooLarge || !maxMergeIsRunning)) {
+                best = candidate;
+                bestScore = mergeScore;
+                bestTooLarge = hitTooLarge;
+                bestMergeBytes = totAfterMergeBytes;
+            }
+        }
+
+        if (!best) {
+            return spec;
+        }
+
+        if (!spec) {
+            spec = newLucene<MergeSpecification>();
+        }
+        OneMergePtr merge(makeOneMerge(segmentInfos, best));
+        spec->add(merge);
+        toBeMerged.addAll(best.begin(), best.end());
+
+        if (verbose()) {
+            message(L"  add merge=" + merge->segString(IndexWriterPtr(_writer)->getDirectory()) + L" size=" + StringUtils::toString(bestMergeBytes) +
+                    L" bytes score=" + StringUtils::toString(bestScore) + (bestTooLarge ? L" [max merge]" : L""));
+        }
+    }
+}
+
+double TieredMergePolicy::score(Collection<SegmentInfoPtr> candidate, bool hitTooLarge) {
+    int64_t totBeforeMergeBytes = 0;
+    int64_t totAfterMergeBytes = 0;
+    int64_t totAfterMergeBytesFloored = 0;
+    for (Collection<SegmentInfoPtr>::iterator info = candidate.begin(); info != candidate.end(); ++info) {
+        int64_t segBytes = size(*info);
+        totAfterMergeBytes += segBytes;
+        totAfterMergeBytesFloored += floorSize(segBytes);
+        totBeforeMergeBytes += (*info)->sizeInBytes();
+    }
+
+    // Measure "skew" of the merge, which can range from 1.0 / numSegsBeingMerged (good) to 1.0 (poor)
+    double skew;
+    if (hitTooLarge) {
+        // Pretend the merge has perfect skew; skew doesn't matter in this case because this merge will
+        // not "cascade" and so it cannot lead to N^2 merge cost over time
+        skew = 1.0 / (double)maxMergeAtOnce;
+    } else {
+        skew = (double)floorSize(size(candidate[0])) / (double)totAfterMergeBytesFloored;
+    }
+
+    // Strongly favor merges with less skew (smaller mergeScore is better)
+    double mergeScore = skew;
+
+    // Gently favor smaller merges over bigger ones.  We don't want to make this exponent too large else we
+    // can end up doing poor merges of small segments in order to avoid the large merges
+    mergeScore *= std::pow((double)totAfterMergeBytes, 0.05);
+
+    // Strongly favor merges that reclaim deletes
+    double nonDelRatio = totBeforeMergeBytes == 0 ? 1.0 : (double)totAfterMergeBytes / (double)totBeforeMergeBytes;
+    mergeScore *= std::pow(nonDelRatio, reclaimDeletesWeight);
+
+    return mergeScore;
+}
+
+MergeSpecificationPtr TieredMergePolicy::findMergesForOptimize(const SegmentInfosPtr& segmentInfos, int32_t maxSegmentCount, SetSegmentInfo segmentsToOptimize) {
+    if (verbose()) {
+        message(L"findMergesForOptimize maxSegmentCount=" + StringUtils::toString(maxSegmentCount) + L" infos=" +
+                segmentInfos->segString(IndexWriterPtr(_writer)->getDirectory()));
+    }
+
+    Collection<SegmentInfoPtr> eligible(Collection<SegmentInfoPtr>::newInstance());
+    bool optimizeMergeRunning = false;
+    SetSegmentInfo merging(IndexWriterPtr(_writer)->getMergingSegments());
+    for (int32_t i = 0; i < segmentInfos->size(); ++i) {
+        SegmentInfoPtr info(segmentInfos->info(i));
+        if (segmentsToOptimize.contains(info)) {
+            if (!merging.contains(info)) {
+                eligible.add(info);
+            } else {
+                optimizeMergeRunning = true;
+            }
+        }
+    }
+
+    if (eligible.empty()) {
+        return MergeSpecificationPtr();
+    }
+
+    if ((maxSegmentCount > 1 && eligible.size() <= maxSegmentCount) || (maxSegmentCount == 1 && eligible.size() == 1 && isOptimized(eligible[0]))) {
+        if (verbose()) {
+            message(L"already optimized");
+        }
+        return MergeSpecificationPtr();
+    }
+
+    eligible = sortBySize(eligible);
+
+    MergeSpecificationPtr spec;
+    int32_t end = eligible.size();
+
+    // Do full merges, first, backwards
+    while (end >= maxMergeAtOnceExplicit + maxSegmentCount - 1) {
+        if (!spec) {
+            spec = newLucene<MergeSpecification>();
+        }
+        OneMergePtr merge(makeOneMerge(segmentInfos, Collection<SegmentInfoPtr>::newInstance(eligible.begin() + end - maxMergeAtOnceExplicit, eligible.begin() + end)));
+        spec->add(merge);
+        end -= maxMergeAtOnceExplicit;
+    }
+
+    if (!spec && !optimizeMergeRunning) {
+        // Do final merge
+        int32_t numToMerge = end - maxSegmentCount + 1;
+        spec = newLucene<MergeSpecification>();
+        spec->add(makeOneMerge(segmentInfos, Collection<SegmentInfoPtr>::newInstance(eligible.begin() + end - numToMerge, eligible.begin() + end)));
+    }
+
+    return spec;
+}
+
+MergeSpecificationPtr TieredMergePolicy::findMergesToExpungeDeletes(const SegmentInfosPtr& segmentInfos) {
+    if (verbose()) {
+        message(L"findMergesToExpungeDeletes infos=" + segmentInfos->segString(IndexWriterPtr(_writer)->getDirectory()) +
+                L" expungeDeletesPctAllowed=" + StringUtils::toString(expungeDeletesPctAllowed));
+    }
+    IndexWriterPtr writer(_writer);
+    Collection<SegmentInfoPtr> eligible(Collection<SegmentInfoPtr>::newInstance());
+    SetSegmentInfo merging(writer->getMergingSegments());
+    for (int32_t i = 0; i < segmentInfos->size(); ++i) {
+        SegmentInfoPtr info(segmentInfos->info(i));
+        double pctDeletes = info->docCount <= 0 ? 0.0 : 100.0 * (double)writer->numDeletedDocs(info) / (double)info->docCount;
+        if (pctDeletes > expungeDeletesPctAllowed && !merging.contains(info)) {
+            eligible.add(info);
+        }
+    }
+
+    if (eligible.empty()) {
+        return MergeSpecificationPtr();
+    }
+
+    eligible = sortBySize(eligible);
+
+    MergeSpecificationPtr spec(newLucene<MergeSpecification>());
+    int32_t start = 0;
+    while (start < eligible.size()) {
+        // Don't enforce max merged size here: app is explicitly calling expungeDeletes, and knows this may
+        // take a long time / produce big segments (like optimize)
+        int32_t end = std::min(start + maxMergeAtOnceExplicit, eligible.size());
+        spec->add(makeOneMerge(segmentInfos, Collection<SegmentInfoPtr>::newInstance(eligible.begin() + start, eligible.begin() + end)));
+        start = end;
+    }
+
+    return spec;
+}
+
+bool TieredMergePolicy::useCompoundFile(const SegmentInfosPtr& segments, const SegmentInfoPtr& newSegment) {
+    return _useCompoundFile;
+}
+
+bool TieredMergePolicy::useCompoundDocStore(const SegmentInfosPtr& segments) {
+    return _useCompoundDocStore;
+}
+
+void TieredMergePolicy::close() {
+}
+
+bool TieredMergePolicy::isOptimized(const SegmentInfoPtr& info) {
+    IndexWriterPtr writer(_writer);
+    bool hasDeletions = (writer->numDeletedDocs(info) > 0);
+    return (!hasDeletions && !info->hasSeparateNorms() && info->dir == writer->getDirectory() && (info->getUseCompoundFile() == _useCompoundFile || noCFSRatio < 1.0));
+}
+
+OneMergePtr TieredMergePolicy::makeOneMerge(const SegmentInfosPtr& infos, Collection<SegmentInfoPtr> infosToMerge) {
+    SegmentInfosPtr segments(newLucene<SegmentInfos>());
+    int64_t mergeSize = 0;
+    for (Collection<SegmentInfoPtr>::iterator info = infosToMerge.begin(); info != infosToMerge.end(); ++info) {
+        segments->add(*info);
+        mergeSize += (*info)->sizeInBytes();
+    }
+    bool doCFS;
+    if (!_useCompoundFile) {
+        doCFS = false;
+    } else if (noCFSRatio == 1.0) {
+        doCFS = true;
+    } else {
+        int64_t totSize = 0;
+        for (int32_t i = 0; i < infos->size(); ++i) {
+            totSize += infos->info(i)->sizeInBytes();
+        }
+        doCFS = ((double)mergeSize <= noCFSRatio * (double)totSize);
+    }
+    return newLucene<OneMerge>(segments, doCFS);
+}
+
+}
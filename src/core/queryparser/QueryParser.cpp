@@ -79,6 +79,7 @@ void QueryParser::ConstructParser(const QueryParserCharStreamPtr& stream, const
     phraseSlop = 0;
     fuzzyMinSim = FuzzyQuery::defaultMinSimilarity();
     fuzzyPrefixLength = FuzzyQuery::defaultPrefixLength;
+    fuzzyBoundEdits = false;
     locale = std::locale();
     dateResolution = DateTools::RESOLUTION_NULL;
 
@@ -141,6 +142,14 @@ void QueryParser::setFuzzyPrefixLength(int32_t fuzzyPrefixLength) {
     this->fuzzyPrefixLength = fuzzyPrefixLength;
 }
 
+void QueryParser::setFuzzyBoundEdits(bool fuzzyBoundEdits) {
+    this->fuzzyBoundEdits = fuzzyBoundEdits;
+}
+
+bool QueryParser::getFuzzyBoundEdits() {
+    return fuzzyBoundEdits;
+}
+
 void QueryParser::setPhraseSlop(int32_t phraseSlop) {
     this->phraseSlop = phraseSlop;
 }
@@ -531,6 +540,9 @@ QueryPtr QueryParser::newPrefixQuery(const TermPtr& prefix) {
 
 QueryPtr QueryParser::newFuzzyQuery(const TermPtr& term, double minimumSimilarity, int32_t prefixLength) {
     // FuzzyQuery doesn't yet allow constant score rewrite
+    if (fuzzyBoundEdits) {
+        return newLucene<FuzzyQuery>(term, minimumSimilarity, prefixLength, FuzzyQuery::floatToEdits(minimumSimilarity, term->text().length()));
+    }
     return newLucene<FuzzyQuery>(term, minimumSimilarity, prefixLength);
 }
 
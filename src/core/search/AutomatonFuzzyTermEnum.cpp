@@ -0,0 +1,115 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "AutomatonFuzzyTermEnum.h"
+#include "LevenshteinAutomata.h"
+#include "Automaton.h"
+#include "Term.h"
+#include "StringUtils.h"
+
+namespace Lucene {
+
+AutomatonFuzzyTermEnum::AutomatonFuzzyTermEnum(const IndexReaderPtr& reader, const TermPtr& term, double minSimilarity, int32_t prefixLength) {
+    int32_t maxEdits = maxEditsForSimilarity(term, minSimilarity);
+    if (maxEdits > LevenshteinAutomata::MAXIMUM_SUPPORTED_DISTANCE) {
+        boost::throw_exception(IllegalArgumentException(L"minimumSimilarity is too low for the length of the term"));
+    }
+    ConstructSimilarityTermEnum(reader, term, minSimilarity, prefixLength, maxEdits);
+}
+
+AutomatonFuzzyTermEnum::AutomatonFuzzyTermEnum(const IndexReaderPtr& reader, const TermPtr& term, double minSimilarity, int32_t prefixLength, int32_t maxEdits) {
+    if (maxEdits < 0 || maxEdits > LevenshteinAutomata::MAXIMUM_SUPPORTED_DISTANCE) {
+        boost::throw_exception(IllegalArgumentException(L"maxEdits must be between 0 and " + StringUtils::toString(LevenshteinAutomata::MAXIMUM_SUPPORTED_DISTANCE)));
+    }
+    ConstructSimilarityTermEnum(reader, term, minSimilarity, prefixLength, std::min(maxEdits, maxEditsForSimilarity(term, minSimilarity)));
+}
+
+AutomatonFuzzyTermEnum::AutomatonFuzzyTermEnum(const IndexReaderPtr& reader, const TermPtr& term, int32_t maxEdits, int32_t prefixLength, bool transpositions) {
+    if (maxEdits < 0 || maxEdits > LevenshteinAutomata::MAXIMUM_SUPPORTED_DISTANCE) {
+        boost::throw_exception(IllegalArgumentException(L"maxEdits must be between 0 and " + StringUtils::toString(LevenshteinAutomata::MAXIMUM_SUPPORTED_DISTANCE)));
+    }
+    if (prefixLength < 0) {
+        boost::throw_exception(IllegalArgumentException(L"prefixLength cannot be less than 0"));
+    }
+    this->maxEdits = maxEdits;
+    this->raw = true;
+    this->minimumSimilarity = 0.0;
+    this->scale_factor = 1.0;
+    ConstructFuzzyTermEnum(reader, term, prefixLength, transpositions);
+}
+
+AutomatonFuzzyTermEnum::~AutomatonFuzzyTermEnum() {
+}
+
+void AutomatonFuzzyTermEnum::ConstructSimilarityTermEnum(const IndexReaderPtr& reader, const TermPtr& term, double minSimilarity, int32_t prefixLength, int32_t maxEdits) {
+    if (minSimilarity >= 1.0) {
+        boost::throw_exception(IllegalArgumentException(L"minimumSimilarity cannot be greater than or equal to 1"));
+    } else if (minSimilarity < 0.0) {
+        boost::throw_exception(IllegalArgumentException(L"minimumSimilarity cannot be less than 0"));
+    }
+    if (prefixLength < 0) {
+        boost::throw_exception(IllegalArgumentException(L"prefixLength cannot be less than 0"));
+    }
+    this->maxEdits = maxEdits;
+    this->raw = false;
+    this->minimumSimilarity = minSimilarity;
+    this->scale_factor = 1.0 / (1.0 - minimumSimilarity);
+    ConstructFuzzyTermEnum(reader, term, prefixLength, false);
+}
+
+void AutomatonFuzzyTermEnum::ConstructFuzzyTermEnum(const IndexReaderPtr& reader, const TermPtr& term, int32_t prefixLength, bool transpositions) {
+    this->_similarity = 0.0;
+
+    // The prefix could be longer than the word, in which case the entire word must match
+    int32_t fullSearchTermLength = term->text().length();
+    int32_t realPrefixLength = prefixLength > fullSearchTermLength ? fullSearchTermLength : prefixLength;
+
+    this->text = term->text().substr(realPrefixLength);
+    this->prefix = term->text().substr(0, realPrefixLength);
+
+    LevenshteinAutomataPtr builder(newLucene<LevenshteinAutomata>(text, transpositions));
+    this->automata = Collection<AutomatonPtr>::newInstance(maxEdits + 1);
+    for (int32_t edits = 0; edits <= maxEdits; ++edits) {
+        automata[edits] = builder->toAutomaton(edits, prefix);
+    }
+
+    ConstructTermEnum(reader, term->field(), automata[maxEdits]);
+}
+
+int32_t AutomatonFuzzyTermEnum::maxEditsForSimilarity(const TermPtr& term, double minSimilarity) {
+    // the similarity of a term is 1 - edits / (prefix length + the smaller of the lengths after the prefix),
+    // which at most is the length of term
+    return (int32_t)((1.0 - minSimilarity) * (double)term->text().length());
+}
+
+bool AutomatonFuzzyTermEnum::termCompare(const TermPtr& term) {
+    if (!AutomatonTermEnum::termCompare(term)) {
+        return false;
+    }
+    const String& termText = term->text();
+    int32_t edits = maxEdits;
+    for (int32_t i = 0; i < maxEdits; ++i) {
+        if (automata[i]->run(termText)) {
+            edits = i;
+            break;
+        }
+    }
+    if (raw) {
+        _similarity = 1.0 - (double)edits / (double)(maxEdits + 1);
+        return true;
+    }
+    // the same similarity as FuzzyTermEnum
+    int32_t length = prefix.length() + std::min(text.length(), termText.length() - prefix.length());
+    _similarity = length == 0 ? 0.0 : 1.0 - ((double)edits / (double)length);
+    return (_similarity > minimumSimilarity);
+}
+
+double AutomatonFuzzyTermEnum::difference() {
+    return (_similarity - minimumSimilarity) * scale_factor;
+}
+
+}
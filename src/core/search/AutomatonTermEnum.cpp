@@ -0,0 +1,293 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "AutomatonTermEnum.h"
+#include "Automaton.h"
+#include "IndexReader.h"
+#include "Term.h"
+
+namespace Lucene {
+
+#ifdef LPP_UNICODE_CHAR_SIZE_2
+static const int32_t MAX_TERM_LABEL = 0xfffd;
+#else
+static const int32_t MAX_TERM_LABEL = 0x10ffff;
+#endif
+
+/// Returns the smallest label from label on that can appear in a term, as the characters that can't be
+/// encoded as UTF-8 never make it to the terms dictionary (and a seek to them would go to the wrong term).
+static int32_t nextValidLabel(int32_t label) {
+#ifdef LPP_UNICODE_CHAR_SIZE_4
+    if (label >= 0xd800 && label <= 0xdfff) {
+        return 0xe000; // surrogate
+    }
+    if (label == 0x1ffff) {
+        return 0x20000; // UTF8Base::UNICODE_TERMINATOR
+    }
+#endif
+    if (label == 0xfffe || label == 0xffff) {
+        return 0x10000; // non-character
+    }
+    return label;
+}
+
+AutomatonTermEnum::AutomatonTermEnum(const IndexReaderPtr& reader, const String& field, const AutomatonPtr& automaton) {
+    ConstructTermEnum(reader, field, automaton);
+}
+
+AutomatonTermEnum::AutomatonTermEnum() {
+    finite = false;
+    _endEnum = false;
+    curGen = 0;
+    linear = false;
+}
+
+AutomatonTermEnum::~AutomatonTermEnum() {
+}
+
+void AutomatonTermEnum::ConstructTermEnum(const IndexReaderPtr& reader, const String& field, const AutomatonPtr& automaton) {
+    if (!automaton->isDeterministic()) {
+        boost::throw_exception(IllegalArgumentException(L"automaton must be deterministic"));
+    }
+
+    this->reader = reader;
+    this->field = field;
+    this->automaton = automaton;
+    this->finite = automaton->isFinite();
+    this->_endEnum = false;
+    this->savedStates = Collection<int32_t>::newInstance(1);
+    this->visited = Collection<int32_t>::newInstance(automaton->getNumStates());
+    this->curGen = 0;
+    this->linear = false;
+
+    // start at the empty term if it's accepted, otherwise at the first string that could be
+    if (automaton->isAccept(0)) {
+        seek(L"");
+    } else if (nextString(L"")) {
+        seek(seekText);
+    } else {
+        _endEnum = true; // nothing can match
+        return;
+    }
+    findTerm();
+}
+
+bool AutomatonTermEnum::termCompare(const TermPtr& term) {
+    if (term->field() != field) {
+        _endEnum = true;
+        return false;
+    }
+    return automaton->run(term->text());
+}
+
+double AutomatonTermEnum::difference() {
+    return 1.0;
+}
+
+bool AutomatonTermEnum::endEnum() {
+    return _endEnum;
+}
+
+bool AutomatonTermEnum::next() {
+    currentTerm.reset();
+    if (!actualEnum || _endEnum) {
+        return false;
+    }
+    if (!actualEnum->next()) {
+        _endEnum = true;
+        return false;
+    }
+    return findTerm();
+}
+
+bool AutomatonTermEnum::findTerm() {
+    while (!_endEnum) {
+        TermPtr term(actualEnum->term());
+        if (!term) {
+            _endEnum = true;
+            break;
+        }
+        if (termCompare(term)) {
+            currentTerm = term;
+            return true;
+        }
+        if (_endEnum) {
+            break;
+        }
+        if (linear && term->text().compare(linearUpperBound) < 0) {
+            if (!actualEnum->next()) {
+                _endEnum = true;
+            }
+        } else if (nextString(term->text())) {
+            seek(seekText);
+        } else {
+            _endEnum = true; // no more terms can match
+        }
+    }
+    currentTerm.reset();
+    return false;
+}
+
+void AutomatonTermEnum::seek(const String& text) {
+    if (actualEnum) {
+        actualEnum->close();
+    }
+    actualEnum = reader->terms(newLucene<Term>(field, text));
+}
+
+bool AutomatonTermEnum::nextString(const String& text) {
+    seekText = text;
+    int32_t pos = 0;
+    while (true) {
+        if (savedStates.size() < (int32_t)seekText.length() + 1) {
+            savedStates.resize(seekText.length() + 1);
+        }
+        savedStates[0] = 0;
+        ++curGen;
+        linear = false;
+
+        // walk the automaton until a character is rejected
+        int32_t state = savedStates[pos];
+        for (; pos < (int32_t)seekText.length(); ++pos) {
+            visited[state] = curGen;
+            int32_t nextState = automaton->step(state, (int32_t)seekText[pos]);
+            if (nextState == -1) {
+                break;
+            }
+            savedStates[pos + 1] = nextState;
+            // we found a loop, record it for faster enumeration
+            if (!finite && !linear && visited[nextState] == curGen) {
+                setLinear(pos);
+            }
+            state = nextState;
+        }
+
+        // take the useful portion and the last non-rejecting state, and attempt to append characters that match
+        if (nextString(state, pos)) {
+            return true;
+        }
+
+        // no more solutions exist from the useful portion, backtrack
+        pos = backtrack(pos);
+        if (pos < 0) {
+            return false; // no more solutions at all
+        }
+        int32_t newState = automaton->step(savedStates[pos], (int32_t)seekText[pos]);
+        if (newState != -1 && automaton->isAccept(newState)) {
+            return true; // the string is good to go as it is
+        }
+        // otherwise advance further, restarting from scratch when the automaton loops as the loop
+        // detection relies on walking from the initial state
+        if (!finite) {
+            pos = 0;
+        }
+    }
+}
+
+bool AutomatonTermEnum::nextString(int32_t state, int32_t position) {
+    // the next character must be greater than the existing one, if there is one
+    int32_t c = 0;
+    if (position < (int32_t)seekText.length()) {
+        c = nextValidLabel((int32_t)seekText[position] + 1);
+        if (c > MAX_TERM_LABEL) {
+            return false;
+        }
+    }
+
+    seekText.resize(position);
+    visited[state] = curGen;
+
+    // find the minimal path (in term order) that is greater than or equal to c
+    int32_t numTransitions = automaton->getNumTransitions(state);
+    for (int32_t i = 0; i < numTransitions; ++i) {
+        const AutomatonTransition& transition = automaton->getTransition(state, i);
+        int32_t nextChar = nextValidLabel(std::max(c, transition.min));
+        if (nextChar > MAX_TERM_LABEL) {
+            return false;
+        }
+        if (nextChar > transition.max) {
+            continue;
+        }
+
+        // append either the next character in sequence, or the minimum of the transition
+        seekText += (wchar_t)nextChar;
+        state = transition.dest;
+
+        // as long as possible continue down the minimal path, stopping at a loop or accept state
+        while (visited[state] != curGen && !automaton->isAccept(state)) {
+            visited[state] = curGen;
+            // there are no transitions to dead states, so a state that doesn't accept has one
+            int32_t nextState = -1;
+            int32_t label = 0;
+            int32_t stateTransitions = automaton->getNumTransitions(state);
+            for (int32_t j = 0; j < stateTransitions && nextState == -1; ++j) {
+                const AutomatonTransition& minTransition = automaton->getTransition(state, j);
+                label = nextValidLabel(minTransition.min);
+                if (label <= minTransition.max && label <= MAX_TERM_LABEL) {
+                    nextState = minTransition.dest;
+                }
+            }
+            if (nextState == -1) {
+                break; // the string so far is still greater than the one we started from
+            }
+            seekText += (wchar_t)label;
+            state = nextState;
+            // we found a loop, record it for faster enumeration
+            if (!finite && !linear && visited[state] == curGen) {
+                setLinear(seekText.length() - 1);
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+int32_t AutomatonTermEnum::backtrack(int32_t position) {
+    while (position-- > 0) {
+        // the largest character can't be incremented, so is a dead end too
+        int32_t nextChar = nextValidLabel((int32_t)seekText[position] + 1);
+        if (nextChar <= MAX_TERM_LABEL) {
+            seekText[position] = (wchar_t)nextChar;
+            seekText.resize(position + 1);
+            return position;
+        }
+    }
+    return -1; // all solutions exhausted
+}
+
+void AutomatonTermEnum::setLinear(int32_t position) {
+    int32_t state = 0;
+    for (int32_t i = 0; i < position; ++i) {
+        state = automaton->step(state, (int32_t)seekText[i]);
+        BOOST_ASSERT(state != -1);
+    }
+    int32_t c = (int32_t)seekText[position];
+    int32_t maxInterval = MAX_TERM_LABEL;
+    int32_t numTransitions = automaton->getNumTransitions(state);
+    for (int32_t i = 0; i < numTransitions; ++i) {
+        const AutomatonTransition& transition = automaton->getTransition(state, i);
+        if (transition.min <= c && c <= transition.max) {
+            maxInterval = std::min(transition.max, MAX_TERM_LABEL);
+            break;
+        }
+    }
+    // the terms up to the end of the transition's interval all follow the loop
+    if (maxInterval != MAX_TERM_LABEL) {
+        ++maxInterval;
+    }
+    linearUpperBound = seekText.substr(0, position);
+    linearUpperBound += (wchar_t)maxInterval;
+    linear = true;
+}
+
+void AutomatonTermEnum::close() {
+    FilteredTermEnum::close();
+    reader.reset();
+    automaton.reset();
+}
+
+}
@@ -0,0 +1,209 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "BlockMaxDisjunctionScorer.h"
+#include "TermScorer.h"
+#include "SegmentTermDocs.h"
+#include "Similarity.h"
+
+namespace Lucene {
+
+/// Relative slack applied to score bounds so that rounding differences between a bound and the score
+/// it bounds never cause a competitive doc to be skipped.
+static const double BOUND_SLACK = 1.0 + 1e-9;
+
+BlockMaxDisjunctionScorer::BlockMaxDisjunctionScorer(const SimilarityPtr& similarity, Collection<TermScorerPtr> scorers, Collection<SegmentTermDocsPtr> impacts) : Scorer(similarity) {
+    this->scorers = scorers;
+    this->impacts = impacts;
+
+    int32_t numTerms = scorers.size();
+    coordFactors = Collection<double>::newInstance(numTerms + 1);
+    maxCoord = 0.0;
+    for (int32_t i = 0; i <= numTerms; ++i) {
+        coordFactors[i] = similarity->coord(i, numTerms);
+        maxCoord = std::max(maxCoord, coordFactors[i]);
+    }
+
+    blockMaxScores = Collection<double>::newInstance(numTerms);
+    order = Collection<int32_t>::newInstance(numTerms);
+    for (int32_t i = 0; i < numTerms; ++i) {
+        order[i] = i;
+    }
+    boundSums = Collection<double>::newInstance(numTerms + 1);
+    numNonEssential = 0;
+    termScores = Collection<double>::newInstance(numTerms);
+    termMatches = Collection<uint8_t>::newInstance(numTerms);
+
+    minCompetitiveScore = -std::numeric_limits<double>::infinity();
+    windowEnd = -1;
+    doc = -1;
+    currentScore = 0.0;
+}
+
+BlockMaxDisjunctionScorer::~BlockMaxDisjunctionScorer() {
+}
+
+int32_t BlockMaxDisjunctionScorer::docID() {
+    return doc;
+}
+
+int32_t BlockMaxDisjunctionScorer::nextDoc() {
+    return doc == NO_MORE_DOCS ? NO_MORE_DOCS : advance(doc + 1);
+}
+
+double BlockMaxDisjunctionScorer::score() {
+    return currentScore;
+}
+
+void BlockMaxDisjunctionScorer::setMinCompetitiveScore(double minScore) {
+    if (minScore <= minCompetitiveScore) {
+        return;
+    }
+    bool pruning = (minCompetitiveScore != -std::numeric_limits<double>::infinity());
+    minCompetitiveScore = minScore;
+    if (pruning) {
+        updatePartition(); // same window, fewer essential terms
+    } else {
+        windowEnd = -1; // the window without a threshold spans all docs, start bounded windows from the next doc
+    }
+}
+
+bool BlockMaxDisjunctionScorer::canPrune(double bound) {
+    return (bound * maxCoord * BOUND_SLACK <= minCompetitiveScore);
+}
+
+double BlockMaxDisjunctionScorer::blockMaxScore(int32_t term) {
+    Collection<int32_t> termImpacts(impacts[term]->getBlockImpacts());
+    double maxScore = 0.0;
+    for (int32_t i = 0; i < termImpacts.size(); i += 2) {
+        maxScore = std::max(maxScore, scorers[term]->getMaxScore(termImpacts[i], termImpacts[i + 1]));
+    }
+    return maxScore;
+}
+
+void BlockMaxDisjunctionScorer::updatePartition() {
+    Collection<double> bounds(blockMaxScores);
+    std::sort(order.begin(), order.end(), [&bounds](int32_t first, int32_t second) {
+        return bounds[first] < bounds[second];
+    });
+    numNonEssential = 0;
+    boundSums[0] = 0.0;
+    for (int32_t i = 0; i < order.size(); ++i) {
+        boundSums[i + 1] = boundSums[i] + blockMaxScores[order[i]];
+        if (numNonEssential == i && canPrune(boundSums[i + 1])) {
+            numNonEssential = i + 1;
+        }
+    }
+}
+
+int32_t BlockMaxDisjunctionScorer::updateWindow(int32_t target) {
+    int32_t numTerms = scorers.size();
+    if (minCompetitiveScore == -std::numeric_limits<double>::infinity()) {
+        // every doc may compete, no need to read any max freqs
+        windowEnd = NO_MORE_DOCS;
+        numNonEssential = 0;
+        return target;
+    }
+    while (true) {
+        windowEnd = NO_MORE_DOCS;
+        for (int32_t i = 0; i < numTerms; ++i) {
+            if (scorers[i]->docID() != NO_MORE_DOCS) {
+                windowEnd = std::min(windowEnd, impacts[i]->advanceShallow(target));
+            }
+        }
+        for (int32_t i = 0; i < numTerms; ++i) {
+            blockMaxScores[i] = scorers[i]->docID() == NO_MORE_DOCS ? 0.0 : blockMaxScore(i);
+        }
+        updatePartition();
+        if (numNonEssential < numTerms) {
+            return target;
+        }
+        // no doc in this window can compete
+        if (windowEnd == NO_MORE_DOCS) {
+            return NO_MORE_DOCS;
+        }
+        target = windowEnd + 1;
+    }
+}
+
+int32_t BlockMaxDisjunctionScorer::advance(int32_t target) {
+    int32_t numTerms = scorers.size();
+    while (true) {
+        if (target == NO_MORE_DOCS) {
+            doc = NO_MORE_DOCS;
+            return doc;
+        }
+        if (target > windowEnd) {
+            target = updateWindow(target);
+            continue;
+        }
+
+        // only docs matching an essential term can compete
+        int32_t candidate = NO_MORE_DOCS;
+        for (int32_t i = numNonEssential; i < numTerms; ++i) {
+            TermScorer* scorer = scorers[order[i]].get();
+            int32_t scorerDoc = scorer->docID();
+            if (scorerDoc < target) {
+                scorerDoc = scorer->advance(target);
+            }
+            candidate = std::min(candidate, scorerDoc);
+        }
+        if (candidate > windowEnd || candidate == NO_MORE_DOCS) {
+            target = windowEnd == NO_MORE_DOCS ? NO_MORE_DOCS : windowEnd + 1;
+            continue;
+        }
+
+        double partialScore = 0.0;
+        for (int32_t i = numNonEssential; i < numTerms; ++i) {
+            int32_t term = order[i];
+            termMatches[term] = (scorers[term]->docID() == candidate);
+            if (termMatches[term]) {
+                termScores[term] = scorers[term]->score();
+                partialScore += termScores[term];
+            }
+        }
+
+        // check non-essential terms from the highest bound down, as long as the candidate may compete
+        bool competitive = true;
+        for (int32_t i = numNonEssential - 1; i >= 0; --i) {
+            if (canPrune(partialScore + boundSums[i + 1])) {
+                competitive = false;
+                break;
+            }
+            int32_t term = order[i];
+            TermScorer* scorer = scorers[term].get();
+            int32_t scorerDoc = scorer->docID();
+            if (scorerDoc < candidate) {
+                scorerDoc = scorer->advance(candidate);
+            }
+            termMatches[term] = (scorerDoc == candidate);
+            if (termMatches[term]) {
+                termScores[term] = scorer->score();
+                partialScore += termScores[term];
+            }
+        }
+        if (!competitive) {
+            target = candidate + 1;
+            continue;
+        }
+
+        // sum up in the same order as BooleanScorer so that scores are identical
+        double sum = 0.0;
+        int32_t matches = 0;
+        for (int32_t term = numTerms - 1; term >= 0; --term) {
+            if (termMatches[term]) {
+                sum += termScores[term];
+                ++matches;
+            }
+        }
+        currentScore = sum * coordFactors[matches];
+        doc = candidate;
+        return doc;
+    }
+}
+
+}
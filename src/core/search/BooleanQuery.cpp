@@ -9,6 +9,13 @@
 #include "_BooleanQuery.h"
 #include "BooleanScorer.h"
 #include "BooleanScorer2.h"
+#include "BlockMaxDisjunctionScorer.h"
+#include "TermQuery.h"
+#include "_TermQuery.h"
+#include "TermScorer.h"
+#include "SegmentReader.h"
+#include "SegmentTermDocs.h"
+#include "Term.h"
 #include "ComplexExplanation.h"
 #include "MiscUtils.h"
 #include "StringUtils.h"
@@ -345,6 +352,30 @@ ScorerPtr BooleanWeight::scorer(const IndexReaderPtr& reader, bool scoreDocsInOr
     return newLucene<BooleanScorer2>(similarity, query->minNrShouldMatch, required, prohibited, optional);
 }
 
+ScorerPtr BooleanWeight::competitiveScorer(const IndexReaderPtr& reader) {
+    SegmentReaderPtr segmentReader(boost::dynamic_pointer_cast<SegmentReader>(reader));
+    if (!segmentReader || query->minNrShouldMatch != 0 || weights.size() < 2) {
+        return Weight::competitiveScorer(reader);
+    }
+    Collection<TermScorerPtr> scorers(Collection<TermScorerPtr>::newInstance());
+    Collection<SegmentTermDocsPtr> impacts(Collection<SegmentTermDocsPtr>::newInstance());
+    Collection<BooleanClausePtr>::iterator c = query->clauses.begin();
+    for (Collection<WeightPtr>::iterator w = weights.begin(); w != weights.end(); ++w, ++c) {
+        // score bounds need non-negative term weights
+        if ((*c)->getOccur() != BooleanClause::SHOULD || !boost::dynamic_pointer_cast<TermWeight>(*w) || (*w)->getValue() < 0) {
+            return Weight::competitiveScorer(reader);
+        }
+        TermPtr term(boost::static_pointer_cast<TermQuery>((*w)->getQuery())->getTerm());
+        SegmentTermDocsPtr termImpacts(boost::dynamic_pointer_cast<SegmentTermDocs>(segmentReader->termDocs(term)));
+        if (!termImpacts || termImpacts->getMaxFreq() < 0) { // segment written without impacts
+            return Weight::competitiveScorer(reader);
+        }
+        scorers.add(boost::static_pointer_cast<TermScorer>((*w)->scorer(reader, true, false)));
+        impacts.add(termImpacts);
+    }
+    return newLucene<BlockMaxDisjunctionScorer>(similarity, scorers, impacts);
+}
+
 bool BooleanWeight::scoresDocsOutOfOrder() {
     int32_t numProhibited = 0;
     for (Collection<BooleanClausePtr>::iterator c = query->clauses.begin(); c != query->clauses.end(); ++c) {
@@ -18,13 +18,14 @@ BooleanScorer::BooleanScorer(const SimilarityPtr& similarity, int32_t minNrShoul
     this->nextMask = 1;
     this->minNrShouldMatch = minNrShouldMatch;
     this->end = 0;
+    this->current = -1;
     this->doc = -1;
 
     if (optionalScorers && !optionalScorers.empty()) {
         for (Collection<ScorerPtr>::iterator scorer = optionalScorers.begin(); scorer != optionalScorers.end(); ++scorer) {
             ++maxCoord;
             if ((*scorer)->nextDoc() != NO_MORE_DOCS) {
-                scorers = newLucene<SubScorer>(*scorer, false, false, bucketTable->newCollector(0), scorers);
+                scorers = newLucene<SubScorer>(*scorer, false, false, 0, scorers);
             }
         }
     }
@@ -35,7 +36,7 @@ BooleanScorer::BooleanScorer(const SimilarityPtr& similarity, int32_t minNrShoul
             nextMask = nextMask << 1;
             prohibitedMask |= mask; // update prohibited mask
             if ((*scorer)->nextDoc() != NO_MORE_DOCS) {
-                scorers = newLucene<SubScorer>(*scorer, false, true, bucketTable->newCollector(mask), scorers);
+                scorers = newLucene<SubScorer>(*scorer, false, true, mask, scorers);
             }
         }
     }
@@ -51,61 +52,65 @@ BooleanScorer::~BooleanScorer() {
 }
 
 bool BooleanScorer::score(const CollectorPtr& collector, int32_t max, int32_t firstDocID) {
-    bool more = false;
-    Bucket* __tmp;
+    BucketTable* table = bucketTable.get();
     BucketScorerPtr bs(newLucene<BucketScorer>());
     // The internal loop will set the score and doc before calling collect.
     collector->setScorer(bs);
+    if (current != -1) {
+        --table->pos; // revisit the bucket nextDoc() stopped on
+        current = -1;
+    }
+    bool more = false;
     do {
-        bucketTable->__first = nullptr;
-
-        while (__current) { // more queued
+        const int32_t* docs = table->docs.get()->data();
+        const double* scores = table->scores.get()->data();
+        const int32_t* bits = table->bits.get()->data();
+        const int32_t* coords = table->coords.get()->data();
+        int32_t* valid = table->valid.get()->data();
+        int32_t kept = 0;
+        for (; table->pos < table->numValid; ++table->pos) {
+            int32_t bucket = valid[table->pos];
             // check prohibited & required
-            if ((__current->bits & prohibitedMask) == 0 && (__current->bits & requiredMask) == requiredMask) {
-                if (__current->doc >= max) {
-                    __tmp = __current;
-                    __current = __current->__next;
-                    __tmp->__next = bucketTable->__first;
-                    bucketTable->__first = __tmp;
+            if ((bits[bucket] & prohibitedMask) == 0 && (bits[bucket] & requiredMask) == requiredMask) {
+                if (docs[bucket] >= max) {
+                    valid[kept++] = bucket; // keep for the next call
                     continue;
                 }
 
-                if (__current->coord >= minNrShouldMatch) {
-                    auto s = coordFactors.size();
-                    bs->_score = __current->score * coordFactors[__current->coord];
-                    bs->doc = __current->doc;
-                    bs->freq = __current->coord;
-                    collector->collect(__current->doc);
+                if (coords[bucket] >= minNrShouldMatch) {
+                    bs->_score = scores[bucket] * coordFactors[coords[bucket]];
+                    bs->doc = docs[bucket];
+                    bs->freq = coords[bucket];
+                    collector->collect(docs[bucket]);
                 }
             }
-
-            __current = __current->__next; // pop the queue
         }
 
-        if (bucketTable->__first) {
-            __current = bucketTable->__first;
-            bucketTable->__first = __current->__next;
+        if (kept > 0) {
+            table->numValid = kept;
+            table->pos = 0;
             return true;
         }
 
-        // refill the queue
-        more = false;
-        end += BucketTable::SIZE;
-
-        for (SubScorerPtr sub(scorers); sub; sub = sub->next) {
-            int32_t subScorerDocID = sub->scorer->docID();
-            if (subScorerDocID != NO_MORE_DOCS) {
-                if (sub->scorer->score(sub->collector, end, subScorerDocID)) {
-                    more = true;
-                }
-            }
-        }
-        __current = bucketTable->__first;
-    } while (__current || more);
+        // refill the table
+        more = nextWindow();
+    } while (table->numValid > 0 || more);
 
     return false;
 }
 
+bool BooleanScorer::nextWindow() {
+    bool more = false;
+    bucketTable->clear();
+    end += BucketTable::SIZE;
+    for (SubScorer* sub = scorers.get(); sub; sub = sub->next.get()) {
+        if (sub->scorer->docID() != NO_MORE_DOCS && bucketTable->collect(sub->scorer, sub->mask, end) != NO_MORE_DOCS) {
+            more = true;
+        }
+    }
+    return more;
+}
+
 int32_t BooleanScorer::advance(int32_t target) {
     boost::throw_exception(UnsupportedOperationException());
     return 0;
@@ -116,43 +121,46 @@ int32_t BooleanScorer::docID() {
 }
 
 int32_t BooleanScorer::nextDoc() {
+    BucketTable* table = bucketTable.get();
     bool more = false;
     do {
-        while (bucketTable->__first) { // more queued
-            __current = bucketTable->__first;
-            bucketTable->__first = __current->__next; // pop the queue
+        while (table->pos < table->numValid) { // more queued
+            current = table->valid[table->pos++];
 
             // check prohibited & required and minNrShouldMatch
-            if ((__current->bits & prohibitedMask) == 0 && (__current->bits & requiredMask) == requiredMask && __current->coord >= minNrShouldMatch) {
-                doc = __current->doc;
+            int32_t bits = table->bits[current];
+            if ((bits & prohibitedMask) == 0 && (bits & requiredMask) == requiredMask && table->coords[current] >= minNrShouldMatch) {
+                doc = table->docs[current];
                 return doc;
             }
         }
 
-        // refill the queue
-        more = false;
-        end += BucketTable::SIZE;
-
-        for (SubScorerPtr sub(scorers); sub; sub = sub->next) {
-            ScorerPtr scorer(sub->scorer);
-            sub->collector->setScorer(scorer);
-            int32_t doc = scorer->docID();
-            while (doc < end) {
-                sub->collector->collect(doc);
-                doc = scorer->nextDoc();
-            }
-            if (doc != NO_MORE_DOCS) {
-                more = true;
-            }
-        }
-    } while (bucketTable->__first || more);
+        // refill the table
+        more = nextWindow();
+    } while (table->numValid > 0 || more);
 
+    current = -1;
     doc = NO_MORE_DOCS;
     return doc;
 }
 
-inline double BooleanScorer::score() {
-    return __current->score * coordFactors[__current->coord];
+double BooleanScorer::score() {
+    return bucketTable->scores[current] * coordFactors[bucketTable->coords[current]];
+}
+
+int32_t BooleanScorer::scoreBatch(Collection<int32_t> docs, Collection<double> scores, int32_t max) {
+    int32_t* batchDocs = docs.get()->data();
+    double* batchScores = scores.get()->data();
+    int32_t size = docs.size();
+    const double* bucketScores = bucketTable->scores.get()->data();
+    const int32_t* bucketCoords = bucketTable->coords.get()->data();
+    int32_t count = 0;
+    while (doc < max && count < size) {
+        batchDocs[count] = doc;
+        batchScores[count++] = bucketScores[current] * coordFactors[bucketCoords[current]];
+        BooleanScorer::nextDoc();
+    }
+    return count;
 }
 
 void BooleanScorer::score(const CollectorPtr& collector) {
@@ -169,54 +177,10 @@ String BooleanScorer::toString() {
     return buffer.str();
 }
 
-BooleanScorerCollector::BooleanScorerCollector(int32_t mask, const BucketTablePtr& bucketTable) {
-    this->mask = mask;
-    this->_bucketTable = bucketTable;
-    this->__bucketTable = bucketTable.get();
-}
-
-BooleanScorerCollector::~BooleanScorerCollector() {
-}
-
-void BooleanScorerCollector::collect(int32_t doc) {
-    auto* table = __bucketTable;
-    int32_t i = doc & BucketTable::MASK;
-    auto& bucket = table->buckets[i];
-    if (!bucket) {
-        bucket = newLucene<Bucket>();
-    }
-    auto* __bucket = bucket.get();
-    if (__bucket->doc != doc) { // invalid bucket
-        __bucket->doc = doc; // set doc
-        __bucket->score = __scorer->score(); // initialize score
-        __bucket->bits = mask; // initialize mask
-        __bucket->coord = 1; // initialize coord
-
-        __bucket->__next = table->__first; // push onto valid list
-        table->__first = __bucket;
-    } else {
-        __bucket->score += __scorer->score(); // increment score
-        __bucket->bits |= mask; // add bits in mask
-        ++__bucket->coord; // increment coord
-    }
-}
-
-void BooleanScorerCollector::setNextReader(const IndexReaderPtr& reader, int32_t docBase) {
-    // not needed by this implementation
-}
-
-void BooleanScorerCollector::setScorer(const ScorerPtr& scorer) {
-    this->_scorer = scorer;
-    this->__scorer = scorer.get();
-}
-
-bool BooleanScorerCollector::acceptsDocsOutOfOrder() {
-    return true;
-}
-
 BucketScorer::BucketScorer() : Scorer(SimilarityPtr()) {
     _score = 0;
     doc = NO_MORE_DOCS;
+    freq = 0;
 }
 
 BucketScorer::~BucketScorer() {
@@ -238,39 +202,80 @@ double BucketScorer::score() {
     return _score;
 }
 
-Bucket::Bucket() {
-    doc = -1;
-    score = 0;
-    bits = 0;
-    coord = 0;
-}
-
-Bucket::~Bucket() {
+float BucketScorer::termFreq() {
+    return (float)freq;
 }
 
 const int32_t BucketTable::SIZE = 1 << 11;
 const int32_t BucketTable::MASK = BucketTable::SIZE - 1;
+const int32_t BucketTable::BATCH_SIZE = 64;
 
 BucketTable::BucketTable() {
-    buckets = Collection<BucketPtr>::newInstance(SIZE);
+    docs = Collection<int32_t>::newInstance(SIZE);
+    scores = Collection<double>::newInstance(SIZE);
+    bits = Collection<int32_t>::newInstance(SIZE);
+    coords = Collection<int32_t>::newInstance(SIZE);
+    valid = Collection<int32_t>::newInstance(SIZE);
+    numValid = 0;
+    pos = 0;
+    docBuffer = Collection<int32_t>::newInstance(BATCH_SIZE);
+    scoreBuffer = Collection<double>::newInstance(BATCH_SIZE);
+    std::fill(docs.begin(), docs.end(), -1);
 }
 
 BucketTable::~BucketTable() {
 }
 
-CollectorPtr BucketTable::newCollector(int32_t mask) {
-    return newLucene<BooleanScorerCollector>(mask, shared_from_this());
+void BucketTable::clear() {
+    numValid = 0;
+    pos = 0;
+}
+
+int32_t BucketTable::collect(const ScorerPtr& scorer, int32_t mask, int32_t end) {
+    Scorer* __scorer = scorer.get();
+    int32_t* docs = this->docs.get()->data();
+    double* scores = this->scores.get()->data();
+    int32_t* bits = this->bits.get()->data();
+    int32_t* coords = this->coords.get()->data();
+    int32_t* valid = this->valid.get()->data();
+    int32_t* docBuffer = this->docBuffer.get()->data();
+    double* scoreBuffer = this->scoreBuffer.get()->data();
+
+    int32_t doc = __scorer->docID();
+    while (doc < end) {
+        // score a batch of postings
+        int32_t count = __scorer->scoreBatch(this->docBuffer, this->scoreBuffer, end);
+
+        // then add them to the buckets
+        for (int32_t i = 0; i < count; ++i) {
+            int32_t bucketDoc = docBuffer[i];
+            int32_t bucket = bucketDoc & MASK;
+            if (docs[bucket] != bucketDoc) { // invalid bucket
+                docs[bucket] = bucketDoc; // set doc
+                scores[bucket] = scoreBuffer[i]; // initialize score
+                bits[bucket] = mask; // initialize mask
+                coords[bucket] = 1; // initialize coord
+                valid[numValid++] = bucket;
+            } else {
+                scores[bucket] += scoreBuffer[i]; // increment score
+                bits[bucket] |= mask; // add bits in mask
+                ++coords[bucket]; // increment coord
+            }
+        }
+        doc = __scorer->docID();
+    }
+    return doc;
 }
 
 int32_t BucketTable::size() {
     return SIZE;
 }
 
-SubScorer::SubScorer(const ScorerPtr& scorer, bool required, bool prohibited, const CollectorPtr& collector, const SubScorerPtr& next) {
+SubScorer::SubScorer(const ScorerPtr& scorer, bool required, bool prohibited, int32_t mask, const SubScorerPtr& next) {
     this->scorer = scorer;
     this->required = required;
     this->prohibited = prohibited;
-    this->collector = collector;
+    this->mask = mask;
     this->next = next;
 }
 
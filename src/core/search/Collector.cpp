@@ -6,10 +6,45 @@
 
 #include "LuceneInc.h"
 #include "Collector.h"
+#include "_Collector.h"
 
 namespace Lucene {
 
 Collector::~Collector() {
 }
 
+void Collector::collectBatch(Collection<int32_t> docs, Collection<double> scores, int32_t count) {
+    BatchScorerPtr scorer(newLucene<BatchScorer>());
+    setScorer(scorer);
+    for (int32_t i = 0; i < count; ++i) {
+        scorer->doc = docs[i];
+        scorer->_score = scores[i];
+        collect(docs[i]);
+    }
+}
+
+BatchScorer::BatchScorer() : Scorer(SimilarityPtr()) {
+    _score = 0;
+    doc = -1;
+}
+
+BatchScorer::~BatchScorer() {
+}
+
+int32_t BatchScorer::advance(int32_t target) {
+    return NO_MORE_DOCS;
+}
+
+int32_t BatchScorer::docID() {
+    return doc;
+}
+
+int32_t BatchScorer::nextDoc() {
+    return NO_MORE_DOCS;
+}
+
+double BatchScorer::score() {
+    return _score;
+}
+
 }
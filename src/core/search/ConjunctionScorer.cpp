@@ -112,4 +112,19 @@ double ConjunctionScorer::score() {
     return sum * coord;
 }
 
+int32_t ConjunctionScorer::scoreBatch(Collection<int32_t> docs, Collection<double> scores, int32_t max) {
+    int32_t* batchDocs = docs.get()->data();
+    double* batchScores = scores.get()->data();
+    int32_t size = docs.size();
+    Scorer* __lastScorer = scorers[scorers.size() - 1].get();
+    int32_t count = 0;
+    while (lastDoc < max && count < size) {
+        batchDocs[count] = lastDoc;
+        batchScores[count++] = score(); // subclasses count the matchers as they score
+        __lastScorer->nextDoc();
+        lastDoc = doNext();
+    }
+    return count;
+}
+
 }
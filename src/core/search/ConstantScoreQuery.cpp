@@ -154,4 +154,16 @@ int32_t ConstantScorer::advance(int32_t target) {
     return docIdSetIterator->advance(target);
 }
 
+int32_t ConstantScorer::scoreBatch(Collection<int32_t> docs, Collection<double> scores, int32_t max) {
+    int32_t* batchDocs = docs.get()->data();
+    int32_t size = docs.size();
+    DocIdSetIterator* iterator = docIdSetIterator.get();
+    int32_t count = 0;
+    for (int32_t doc = iterator->docID(); doc < max && count < size; doc = iterator->nextDoc()) {
+        batchDocs[count++] = doc;
+    }
+    std::fill(scores.begin(), scores.begin() + count, theScore);
+    return count;
+}
+
 }
@@ -64,6 +64,19 @@ bool DisjunctionSumScorer::score(const CollectorPtr& collector, int32_t max, int
     return true;
 }
 
+int32_t DisjunctionSumScorer::scoreBatch(Collection<int32_t> docs, Collection<double> scores, int32_t max) {
+    int32_t* batchDocs = docs.get()->data();
+    double* batchScores = scores.get()->data();
+    int32_t size = docs.size();
+    int32_t count = 0;
+    while (currentDoc < max && count < size) {
+        batchDocs[count] = currentDoc;
+        batchScores[count++] = score(); // subclasses count the matchers as they score
+        DisjunctionSumScorer::nextDoc();
+    }
+    return count;
+}
+
 int32_t DisjunctionSumScorer::nextDoc() {
     if (scorerDocQueue->size() < minimumNrMatchers || !advanceAfterCurrent()) {
         currentDoc = NO_MORE_DOCS;
@@ -9,6 +9,7 @@
 #include "_FieldCache.h"
 #include "FieldCacheImpl.h"
 #include "NumericUtils.h"
+#include "PackedInts.h"
 #include "StringUtils.h"
 
 namespace Lucene {
@@ -141,6 +142,41 @@ StringIndexPtr FieldCache::getStringIndex(const IndexReaderPtr& reader, const St
     return StringIndexPtr(); // override
 }
 
+NumericDocValuesPtr FieldCache::getPackedInts(const IndexReaderPtr& reader, const String& field) {
+    BOOST_ASSERT(false);
+    return NumericDocValuesPtr(); // override
+}
+
+NumericDocValuesPtr FieldCache::getPackedInts(const IndexReaderPtr& reader, const String& field, const IntParserPtr& parser) {
+    BOOST_ASSERT(false);
+    return NumericDocValuesPtr(); // override
+}
+
+NumericDocValuesPtr FieldCache::getPackedLongs(const IndexReaderPtr& reader, const String& field) {
+    BOOST_ASSERT(false);
+    return NumericDocValuesPtr(); // override
+}
+
+NumericDocValuesPtr FieldCache::getPackedLongs(const IndexReaderPtr& reader, const String& field, const LongParserPtr& parser) {
+    BOOST_ASSERT(false);
+    return NumericDocValuesPtr(); // override
+}
+
+NumericDocValuesPtr FieldCache::getPackedDoubles(const IndexReaderPtr& reader, const String& field) {
+    BOOST_ASSERT(false);
+    return NumericDocValuesPtr(); // override
+}
+
+NumericDocValuesPtr FieldCache::getPackedDoubles(const IndexReaderPtr& reader, const String& field, const DoubleParserPtr& parser) {
+    BOOST_ASSERT(false);
+    return NumericDocValuesPtr(); // override
+}
+
+StringIndexPtr FieldCache::getPackedStringIndex(const IndexReaderPtr& reader, const String& field) {
+    BOOST_ASSERT(false);
+    return StringIndexPtr(); // override
+}
+
 void FieldCache::setInfoStream(const InfoStreamPtr& stream) {
     BOOST_ASSERT(false);
     // override
@@ -159,9 +195,18 @@ StringIndex::StringIndex(Collection<int32_t> values, Collection<String> lookup)
     this->lookup = lookup;
 }
 
+StringIndex::StringIndex(const PackedIntsPtr& values, Collection<String> lookup) {
+    this->packedOrder = values;
+    this->lookup = lookup;
+}
+
 StringIndex::~StringIndex() {
 }
 
+int32_t StringIndex::getOrd(int32_t doc) {
+    return packedOrder ? (int32_t)packedOrder->get(doc) : order[doc];
+}
+
 int32_t StringIndex::binarySearchLookup(const String& key) {
     Collection<String>::iterator search = std::lower_bound(lookup.begin(), lookup.end(), key);
     int32_t keyPos = std::distance(lookup.begin(), search);
@@ -8,6 +8,9 @@
 #include "FieldCacheImpl.h"
 #include "FieldCacheSanityChecker.h"
 #include "IndexReader.h"
+#include "NumericDocValues.h"
+#include "NumericUtils.h"
+#include "OpenBitSet.h"
 #include "InfoStream.h"
 #include "TermEnum.h"
 #include "TermDocs.h"
@@ -26,11 +29,11 @@ FieldCacheImpl::~FieldCacheImpl() {
 void FieldCacheImpl::initialize() {
     caches = MapStringCache::newInstance();
     caches.put(CACHE_BYTE, newLucene<ByteCache>(shared_from_this()));
-    caches.put(CACHE_INT, newLucene<IntCache>(shared_from_this()));
-    caches.put(CACHE_LONG, newLucene<LongCache>(shared_from_this()));
-    caches.put(CACHE_DOUBLE, newLucene<DoubleCache>(shared_from_this()));
     caches.put(CACHE_STRING, newLucene<StringCache>(shared_from_this()));
-    caches.put(CACHE_STRING_INDEX, newLucene<StringIndexCache>(shared_from_this()));
+    caches.put(CACHE_PACKED_INT, newLucene<PackedIntCache>(shared_from_this()));
+    caches.put(CACHE_PACKED_LONG, newLucene<PackedLongCache>(shared_from_this()));
+    caches.put(CACHE_PACKED_DOUBLE, newLucene<PackedDoubleCache>(shared_from_this()));
+    caches.put(CACHE_PACKED_STRING_INDEX, newLucene<PackedStringIndexCache>(shared_from_this()));
 }
 
 void FieldCacheImpl::purgeAllCaches() {
@@ -73,7 +76,9 @@ Collection<int32_t> FieldCacheImpl::getInts(const IndexReaderPtr& reader, const
 }
 
 Collection<int32_t> FieldCacheImpl::getInts(const IndexReaderPtr& reader, const String& field, const IntParserPtr& parser) {
-    return VariantUtils::get< Collection<int32_t> >(caches.get(CACHE_INT)->get(reader, newLucene<Entry>(field, parser)));
+    // the array is expanded from the packed entry, so that both views of the field share a single cache entry
+    FieldCacheNumericValuesPtr values(boost::static_pointer_cast<FieldCacheNumericValues>(getPackedInts(reader, field, parser)));
+    return values->getInts();
 }
 
 Collection<int64_t> FieldCacheImpl::getLongs(const IndexReaderPtr& reader, const String& field) {
@@ -81,7 +86,9 @@ Collection<int64_t> FieldCacheImpl::getLongs(const IndexReaderPtr& reader, const
 }
 
 Collection<int64_t> FieldCacheImpl::getLongs(const IndexReaderPtr& reader, const String& field, const LongParserPtr& parser) {
-    return VariantUtils::get< Collection<int64_t> >(caches.get(CACHE_LONG)->get(reader, newLucene<Entry>(field, parser)));
+    // the array is expanded from the packed entry, so that both views of the field share a single cache entry
+    FieldCacheNumericValuesPtr values(boost::static_pointer_cast<FieldCacheNumericValues>(getPackedLongs(reader, field, parser)));
+    return values->getLongs();
 }
 
 Collection<double> FieldCacheImpl::getDoubles(const IndexReaderPtr& reader, const String& field) {
@@ -89,7 +96,9 @@ Collection<double> FieldCacheImpl::getDoubles(const IndexReaderPtr& reader, cons
 }
 
 Collection<double> FieldCacheImpl::getDoubles(const IndexReaderPtr& reader, const String& field, const DoubleParserPtr& parser) {
-    return VariantUtils::get< Collection<double> >(caches.get(CACHE_DOUBLE)->get(reader, newLucene<Entry>(field, parser)));
+    // the array is expanded from the packed entry, so that both views of the field share a single cache entry
+    FieldCacheNumericValuesPtr values(boost::static_pointer_cast<FieldCacheNumericValues>(getPackedDoubles(reader, field, parser)));
+    return values->getDoubles();
 }
 
 Collection<String> FieldCacheImpl::getStrings(const IndexReaderPtr& reader, const String& field) {
@@ -97,7 +106,36 @@ Collection<String> FieldCacheImpl::getStrings(const IndexReaderPtr& reader, cons
 }
 
 StringIndexPtr FieldCacheImpl::getStringIndex(const IndexReaderPtr& reader, const String& field) {
-    return VariantUtils::get< StringIndexPtr >(caches.get(CACHE_STRING_INDEX)->get(reader, newLucene<Entry>(field, ParserPtr())));
+    FieldCacheStringIndexPtr index(boost::static_pointer_cast<FieldCacheStringIndex>(getPackedStringIndex(reader, field)));
+    return index->getUnpacked();
+}
+
+NumericDocValuesPtr FieldCacheImpl::getPackedInts(const IndexReaderPtr& reader, const String& field) {
+    return getPackedInts(reader, field, IntParserPtr());
+}
+
+NumericDocValuesPtr FieldCacheImpl::getPackedInts(const IndexReaderPtr& reader, const String& field, const IntParserPtr& parser) {
+    return VariantUtils::get<NumericDocValuesPtr>(caches.get(CACHE_PACKED_INT)->get(reader, newLucene<Entry>(field, parser)));
+}
+
+NumericDocValuesPtr FieldCacheImpl::getPackedLongs(const IndexReaderPtr& reader, const String& field) {
+    return getPackedLongs(reader, field, LongParserPtr());
+}
+
+NumericDocValuesPtr FieldCacheImpl::getPackedLongs(const IndexReaderPtr& reader, const String& field, const LongParserPtr& parser) {
+    return VariantUtils::get<NumericDocValuesPtr>(caches.get(CACHE_PACKED_LONG)->get(reader, newLucene<Entry>(field, parser)));
+}
+
+NumericDocValuesPtr FieldCacheImpl::getPackedDoubles(const IndexReaderPtr& reader, const String& field) {
+    return getPackedDoubles(reader, field, DoubleParserPtr());
+}
+
+NumericDocValuesPtr FieldCacheImpl::getPackedDoubles(const IndexReaderPtr& reader, const String& field, const DoubleParserPtr& parser) {
+    return VariantUtils::get<NumericDocValuesPtr>(caches.get(CACHE_PACKED_DOUBLE)->get(reader, newLucene<Entry>(field, parser)));
+}
+
+StringIndexPtr FieldCacheImpl::getPackedStringIndex(const IndexReaderPtr& reader, const String& field) {
+    return VariantUtils::get<StringIndexPtr>(caches.get(CACHE_PACKED_STRING_INDEX)->get(reader, newLucene<Entry>(field, ParserPtr())));
 }
 
 void FieldCacheImpl::setInfoStream(const InfoStreamPtr& stream) {
@@ -245,27 +283,16 @@ boost::any ByteCache::createValue(const IndexReaderPtr& reader, const EntryPtr&
     return retArray;
 }
 
-IntCache::IntCache(const FieldCachePtr& wrapper) : Cache(wrapper) {
+StringCache::StringCache(const FieldCachePtr& wrapper) : Cache(wrapper) {
 }
 
-IntCache::~IntCache() {
+StringCache::~StringCache() {
 }
 
-boost::any IntCache::createValue(const IndexReaderPtr& reader, const EntryPtr& key) {
+boost::any StringCache::createValue(const IndexReaderPtr& reader, const EntryPtr& key) {
     EntryPtr entry(key);
     String field(entry->field);
-    IntParserPtr parser(VariantUtils::get<IntParserPtr>(entry->custom));
-    if (!parser) {
-        FieldCachePtr wrapper(_wrapper);
-        boost::any ints;
-        try {
-            ints = wrapper->getInts(reader, field, FieldCache::DEFAULT_INT_PARSER());
-        } catch (NumberFormatException&) {
-            ints = wrapper->getInts(reader, field, FieldCache::NUMERIC_UTILS_INT_PARSER());
-        }
-        return ints;
-    }
-    Collection<int32_t> retArray;
+    Collection<String> retArray(Collection<String>::newInstance(reader->maxDoc()));
     TermDocsPtr termDocs(reader->termDocs());
     TermEnumPtr termEnum(reader->terms(newLucene<Term>(field)));
     LuceneException finally;
@@ -275,49 +302,42 @@ boost::any IntCache::createValue(const IndexReaderPtr& reader, const EntryPtr& k
             if (!term || term->field() != field) {
                 break;
             }
-            int32_t termval = parser->parseInt(term->text());
-            if (!retArray) { // late init
-                retArray = Collection<int32_t>::newInstance(reader->maxDoc());
-            }
+            String termval(term->text());
             termDocs->seek(termEnum);
             while (termDocs->next()) {
                 retArray[termDocs->doc()] = termval;
             }
         } while (termEnum->next());
-    } catch (StopFillCacheException&) {
     } catch (LuceneException& e) {
         finally = e;
     }
     termDocs->close();
     termEnum->close();
     finally.throwException();
-    if (!retArray) { // no values
-        retArray = Collection<int32_t>::newInstance(reader->maxDoc());
-    }
     return retArray;
 }
 
-LongCache::LongCache(const FieldCachePtr& wrapper) : Cache(wrapper) {
+static inline int64_t parseValue(const IntParserPtr& parser, const String& text) {
+    return parser->parseInt(text);
 }
 
-LongCache::~LongCache() {
+static inline int64_t parseValue(const LongParserPtr& parser, const String& text) {
+    return parser->parseLong(text);
 }
 
-boost::any LongCache::createValue(const IndexReaderPtr& reader, const EntryPtr& key) {
-    EntryPtr entry(key);
-    String field(entry->field);
-    LongParserPtr parser(VariantUtils::get<LongParserPtr>(entry->custom));
-    if (!parser) {
-        FieldCachePtr wrapper(_wrapper);
-        boost::any longs;
-        try {
-            longs = wrapper->getLongs(reader, field, FieldCache::DEFAULT_LONG_PARSER());
-        } catch (NumberFormatException&) {
-            longs = wrapper->getLongs(reader, field, FieldCache::NUMERIC_UTILS_LONG_PARSER());
-        }
-        return longs;
-    }
-    Collection<int64_t> retArray;
+static inline int64_t parseValue(const DoubleParserPtr& parser, const String& text) {
+    return NumericUtils::doubleToSortableLong(parser->parseDouble(text));
+}
+
+/// Un-invert field into values packed with as few bits as the range of the parsed values needs.  The terms
+/// are read twice, first to find that range, then to fill in the value of each document.
+template <class PARSER>
+static NumericDocValuesPtr packTerms(const IndexReaderPtr& reader, const String& field, NumericDocValues::Type type, const PARSER& parser) {
+    int32_t maxDoc = reader->maxDoc();
+    Collection<int64_t> termValues(Collection<int64_t>::newInstance());
+    int64_t minValue = 0;
+    int64_t maxValue = 0;
+    int64_t numPostings = 0;
     TermDocsPtr termDocs(reader->termDocs());
     TermEnumPtr termEnum(reader->terms(newLucene<Term>(field)));
     LuceneException finally;
@@ -327,168 +347,262 @@ boost::any LongCache::createValue(const IndexReaderPtr& reader, const EntryPtr&
             if (!term || term->field() != field) {
                 break;
             }
-            int64_t termval = parser->parseLong(term->text());
-            if (!retArray) { // late init
-                retArray = Collection<int64_t>::newInstance(reader->maxDoc());
+            int64_t termval = parseValue(parser, term->text());
+            if (termValues.empty() || termval < minValue) {
+                minValue = termval;
             }
-            termDocs->seek(termEnum);
-            while (termDocs->next()) {
-                retArray[termDocs->doc()] = termval;
+            if (termValues.empty() || termval > maxValue) {
+                maxValue = termval;
             }
+            termValues.add(termval);
+            numPostings += termEnum->docFreq();
         } while (termEnum->next());
     } catch (StopFillCacheException&) {
     } catch (LuceneException& e) {
         finally = e;
     }
+    termEnum->close();
+    if (!finally.isNull()) {
+        termDocs->close();
+        finally.throwException();
+    }
+
+    if (numPostings < maxDoc) {
+        // some documents have no value and must read as 0
+        minValue = std::min(minValue, (int64_t)0);
+        maxValue = std::max(maxValue, (int64_t)0);
+    }
+    PackedIntsPtr values(newLucene<PackedInts>(maxDoc, PackedInts::bitsRequired((int64_t)((uint64_t)maxValue - (uint64_t)minValue))));
+    OpenBitSetPtr docsWithValue(newLucene<OpenBitSet>(maxDoc));
+    termEnum = reader->terms(newLucene<Term>(field));
+    try {
+        for (Collection<int64_t>::iterator termval = termValues.begin(); termval != termValues.end(); ++termval) {
+            termDocs->seek(termEnum);
+            int64_t packed = (int64_t)((uint64_t)*termval - (uint64_t)minValue);
+            while (termDocs->next()) {
+                values->set(termDocs->doc(), packed);
+                docsWithValue->fastSet(termDocs->doc());
+            }
+            termEnum->next();
+        }
+    } catch (LuceneException& e) {
+        finally = e;
+    }
     termDocs->close();
     termEnum->close();
     finally.throwException();
-    if (!retArray) { // no values
-        retArray = Collection<int64_t>::newInstance(reader->maxDoc());
+
+    if (docsWithValue->cardinality() < maxDoc && (minValue > 0 || maxValue < 0)) {
+        // documents with more than one term hid the ones without any, widen the range to hold 0
+        int64_t newMin = std::min(minValue, (int64_t)0);
+        int64_t newMax = std::max(maxValue, (int64_t)0);
+        PackedIntsPtr widened(newLucene<PackedInts>(maxDoc, PackedInts::bitsRequired((int64_t)((uint64_t)newMax - (uint64_t)newMin))));
+        for (int32_t doc = 0; doc < maxDoc; ++doc) {
+            int64_t value = docsWithValue->fastGet(doc) ? (int64_t)((uint64_t)minValue + (uint64_t)values->get(doc)) : 0;
+            widened->set(doc, (int64_t)((uint64_t)value - (uint64_t)newMin));
+        }
+        values = widened;
+        minValue = newMin;
     }
-    return retArray;
+    return newLucene<FieldCacheNumericValues>(type, minValue, values);
+}
+
+PackedIntCache::PackedIntCache(const FieldCachePtr& wrapper) : Cache(wrapper) {
+}
+
+PackedIntCache::~PackedIntCache() {
+}
+
+boost::any PackedIntCache::createValue(const IndexReaderPtr& reader, const EntryPtr& key) {
+    EntryPtr entry(key);
+    String field(entry->field);
+    IntParserPtr parser(VariantUtils::get<IntParserPtr>(entry->custom));
+    if (!parser) {
+        // values written at index time are already packed
+        NumericDocValuesPtr docValues(reader->getNumericDocValues(field));
+        if (docValues) {
+            return NumericDocValuesPtr(newLucene<FieldCacheNumericValues>(docValues));
+        }
+        FieldCachePtr wrapper(_wrapper);
+        boost::any ints;
+        try {
+            ints = wrapper->getPackedInts(reader, field, FieldCache::DEFAULT_INT_PARSER());
+        } catch (NumberFormatException&) {
+            ints = wrapper->getPackedInts(reader, field, FieldCache::NUMERIC_UTILS_INT_PARSER());
+        }
+        return ints;
+    }
+    return packTerms(reader, field, NumericDocValues::TYPE_LONG, parser);
 }
 
-DoubleCache::DoubleCache(const FieldCachePtr& wrapper) : Cache(wrapper) {
+PackedLongCache::PackedLongCache(const FieldCachePtr& wrapper) : Cache(wrapper) {
 }
 
-DoubleCache::~DoubleCache() {
+PackedLongCache::~PackedLongCache() {
 }
 
-boost::any DoubleCache::createValue(const IndexReaderPtr& reader, const EntryPtr& key) {
+boost::any PackedLongCache::createValue(const IndexReaderPtr& reader, const EntryPtr& key) {
+    EntryPtr entry(key);
+    String field(entry->field);
+    LongParserPtr parser(VariantUtils::get<LongParserPtr>(entry->custom));
+    if (!parser) {
+        // values written at index time are already packed
+        NumericDocValuesPtr docValues(reader->getNumericDocValues(field));
+        if (docValues) {
+            return NumericDocValuesPtr(newLucene<FieldCacheNumericValues>(docValues));
+        }
+        FieldCachePtr wrapper(_wrapper);
+        boost::any longs;
+        try {
+            longs = wrapper->getPackedLongs(reader, field, FieldCache::DEFAULT_LONG_PARSER());
+        } catch (NumberFormatException&) {
+            longs = wrapper->getPackedLongs(reader, field, FieldCache::NUMERIC_UTILS_LONG_PARSER());
+        }
+        return longs;
+    }
+    return packTerms(reader, field, NumericDocValues::TYPE_LONG, parser);
+}
+
+PackedDoubleCache::PackedDoubleCache(const FieldCachePtr& wrapper) : Cache(wrapper) {
+}
+
+PackedDoubleCache::~PackedDoubleCache() {
+}
+
+boost::any PackedDoubleCache::createValue(const IndexReaderPtr& reader, const EntryPtr& key) {
     EntryPtr entry(key);
     String field(entry->field);
     DoubleParserPtr parser(VariantUtils::get<DoubleParserPtr>(entry->custom));
     if (!parser) {
+        // values written at index time are already packed
+        NumericDocValuesPtr docValues(reader->getNumericDocValues(field));
+        if (docValues) {
+            return NumericDocValuesPtr(newLucene<FieldCacheNumericValues>(docValues));
+        }
         FieldCachePtr wrapper(_wrapper);
         boost::any doubles;
         try {
-            doubles = wrapper->getDoubles(reader, field, FieldCache::DEFAULT_DOUBLE_PARSER());
+            doubles = wrapper->getPackedDoubles(reader, field, FieldCache::DEFAULT_DOUBLE_PARSER());
         } catch (NumberFormatException&) {
-            doubles = wrapper->getDoubles(reader, field, FieldCache::NUMERIC_UTILS_DOUBLE_PARSER());
+            doubles = wrapper->getPackedDoubles(reader, field, FieldCache::NUMERIC_UTILS_DOUBLE_PARSER());
         }
         return doubles;
     }
-    Collection<double> retArray;
-    TermDocsPtr termDocs(reader->termDocs());
-    TermEnumPtr termEnum(reader->terms(newLucene<Term>(field)));
-    LuceneException finally;
-    try {
-        do {
-            TermPtr term(termEnum->term());
-            if (!term || term->field() != field) {
-                break;
-            }
-            double termval = parser->parseDouble(term->text());
-            if (!retArray) { // late init
-                retArray = Collection<double>::newInstance(reader->maxDoc());
-            }
-            termDocs->seek(termEnum);
-            while (termDocs->next()) {
-                retArray[termDocs->doc()] = termval;
-            }
-        } while (termEnum->next());
-    } catch (StopFillCacheException&) {
-    } catch (LuceneException& e) {
-        finally = e;
-    }
-    termDocs->close();
-    termEnum->close();
-    finally.throwException();
-    if (!retArray) { // no values
-        retArray = Collection<double>::newInstance(reader->maxDoc());
-    }
-    return retArray;
+    return packTerms(reader, field, NumericDocValues::TYPE_DOUBLE, parser);
 }
 
-StringCache::StringCache(const FieldCachePtr& wrapper) : Cache(wrapper) {
+PackedStringIndexCache::PackedStringIndexCache(const FieldCachePtr& wrapper) : Cache(wrapper) {
 }
 
-StringCache::~StringCache() {
+PackedStringIndexCache::~PackedStringIndexCache() {
 }
 
-boost::any StringCache::createValue(const IndexReaderPtr& reader, const EntryPtr& key) {
+boost::any PackedStringIndexCache::createValue(const IndexReaderPtr& reader, const EntryPtr& key) {
     EntryPtr entry(key);
     String field(entry->field);
-    Collection<String> retArray(Collection<String>::newInstance(reader->maxDoc()));
+    int32_t maxDoc = reader->maxDoc();
+
+    // documents without a term in the field get the first entry, so they sort first
+    Collection<String> mterms(Collection<String>::newInstance());
+    mterms.add(L"");
     TermDocsPtr termDocs(reader->termDocs());
     TermEnumPtr termEnum(reader->terms(newLucene<Term>(field)));
     LuceneException finally;
     try {
         do {
             TermPtr term(termEnum->term());
-            if (!term || term->field() != field) {
+            if (!term || term->field() != field || mterms.size() > maxDoc) {
                 break;
             }
-            String termval(term->text());
+            mterms.add(term->text());
+        } while (termEnum->next());
+    } catch (LuceneException& e) {
+        finally = e;
+    }
+    termEnum->close();
+    if (!finally.isNull()) {
+        termDocs->close();
+        finally.throwException();
+    }
+
+    PackedIntsPtr ords(newLucene<PackedInts>(maxDoc, PackedInts::bitsRequired(mterms.size() - 1)));
+    termEnum = reader->terms(newLucene<Term>(field));
+    try {
+        for (int32_t t = 1; t < mterms.size(); ++t) {
             termDocs->seek(termEnum);
             while (termDocs->next()) {
-                retArray[termDocs->doc()] = termval;
+                ords->set(termDocs->doc(), t);
             }
-        } while (termEnum->next());
+            termEnum->next();
+        }
     } catch (LuceneException& e) {
         finally = e;
     }
     termDocs->close();
     termEnum->close();
     finally.throwException();
-    return retArray;
+
+    return StringIndexPtr(newLucene<FieldCacheStringIndex>(ords, mterms));
 }
 
-StringIndexCache::StringIndexCache(const FieldCachePtr& wrapper) : Cache(wrapper) {
+FieldCacheNumericValues::FieldCacheNumericValues(Type type, int64_t minValue, const PackedIntsPtr& values) : NumericDocValues(type, minValue, values) {
 }
 
-StringIndexCache::~StringIndexCache() {
+FieldCacheNumericValues::FieldCacheNumericValues(const NumericDocValuesPtr& values) : NumericDocValues(values) {
 }
 
-boost::any StringIndexCache::createValue(const IndexReaderPtr& reader, const EntryPtr& key) {
-    EntryPtr entry(key);
-    String field(entry->field);
-    Collection<int32_t> retArray(Collection<int32_t>::newInstance(reader->maxDoc()));
-    Collection<String> mterms(Collection<String>::newInstance(reader->maxDoc() + 1));
-    TermDocsPtr termDocs(reader->termDocs());
-    TermEnumPtr termEnum(reader->terms(newLucene<Term>(field)));
-    int32_t t = 0; // current term number
+FieldCacheNumericValues::~FieldCacheNumericValues() {
+}
 
-    // an entry for documents that have no terms in this field should a document with no terms be at
-    // top or bottom?  This puts them at the top - if it is changed, FieldDocSortedHitQueue needs to
-    // change as well.
-    mterms[t++] = L"";
+Collection<int32_t> FieldCacheNumericValues::getInts() {
+    SyncLock syncLock(this);
+    if (!ints) {
+        ints = Collection<int32_t>::newInstance(size());
+        for (int32_t doc = 0; doc < ints.size(); ++doc) {
+            ints[doc] = (int32_t)getLong(doc);
+        }
+    }
+    return ints;
+}
 
-    LuceneException finally;
-    try {
-        do {
-            TermPtr term(termEnum->term());
-            if (!term || term->field() != field || t >= mterms.size() ) {
-                break;
-            }
+Collection<int64_t> FieldCacheNumericValues::getLongs() {
+    SyncLock syncLock(this);
+    if (!longs) {
+        longs = Collection<int64_t>::newInstance(size());
+        for (int32_t doc = 0; doc < longs.size(); ++doc) {
+            longs[doc] = getLong(doc);
+        }
+    }
+    return longs;
+}
 
-            // store term text
-            mterms[t] = term->text();
+Collection<double> FieldCacheNumericValues::getDoubles() {
+    SyncLock syncLock(this);
+    if (!doubles) {
+        doubles = Collection<double>::newInstance(size());
+        for (int32_t doc = 0; doc < doubles.size(); ++doc) {
+            doubles[doc] = getDouble(doc);
+        }
+    }
+    return doubles;
+}
 
-            termDocs->seek(termEnum);
-            while (termDocs->next()) {
-                retArray[termDocs->doc()] = t;
-            }
+FieldCacheStringIndex::FieldCacheStringIndex(const PackedIntsPtr& values, Collection<String> lookup) : StringIndex(values, lookup) {
+}
 
-            ++t;
-        } while (termEnum->next());
-    } catch (LuceneException& e) {
-        finally = e;
-    }
-    termDocs->close();
-    termEnum->close();
-    finally.throwException();
+FieldCacheStringIndex::~FieldCacheStringIndex() {
+}
 
-    if (t == 0) {
-        // if there are no terms, make the term array have a single null entry
-        mterms = Collection<String>::newInstance(1);
-    } else if (t < mterms.size()) {
-        // if there are less terms than documents, trim off the dead array space
-        mterms.resize(t);
+StringIndexPtr FieldCacheStringIndex::getUnpacked() {
+    SyncLock syncLock(this);
+    if (!unpacked) {
+        Collection<int32_t> order(Collection<int32_t>::newInstance(packedOrder->size()));
+        for (int32_t doc = 0; doc < order.size(); ++doc) {
+            order[doc] = (int32_t)packedOrder->get(doc);
+        }
+        unpacked = newLucene<StringIndex>(order, lookup);
     }
-
-    return newLucene<StringIndex>(retArray, mterms);
+    return unpacked;
 }
 
 FieldCacheEntryImpl::FieldCacheEntryImpl(const LuceneObjectPtr& readerKey, const String& fieldName, int32_t cacheType, const boost::any& custom, const boost::any& value) {
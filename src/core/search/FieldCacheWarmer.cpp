@@ -0,0 +1,111 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include <boost/version.hpp>
+#if BOOST_VERSION >= 107300  // Boost 1.73.0+
+#include <boost/bind/bind.hpp>
+#else
+#include <boost/bind.hpp>
+#endif
+#include <boost/bind/protect.hpp>
+#include "FieldCacheWarmer.h"
+#include "_FieldCacheWarmer.h"
+#include "FieldCache.h"
+#include "SortField.h"
+#include "ReaderUtil.h"
+#include "ThreadPool.h"
+
+namespace Lucene {
+
+FieldCacheWarmer::FieldCacheWarmer(Collection<SortFieldPtr> sortFields, const ThreadPoolPtr& threadPool) {
+    this->sortFields = sortFields;
+    this->threadPool = threadPool ? threadPool : ThreadPool::getInstance();
+}
+
+FieldCacheWarmer::~FieldCacheWarmer() {
+}
+
+Collection<FieldCacheWarmerTaskPtr> FieldCacheWarmer::schedule(const IndexReaderPtr& reader, Collection<FuturePtr> futures) {
+    Collection<IndexReaderPtr> subReaders(Collection<IndexReaderPtr>::newInstance());
+    ReaderUtil::gatherSubReaders(subReaders, reader);
+    Collection<FieldCacheWarmerTaskPtr> tasks(Collection<FieldCacheWarmerTaskPtr>::newInstance(subReaders.size()));
+    for (int32_t i = 0; i < subReaders.size(); ++i) {
+        tasks[i] = newLucene<FieldCacheWarmerTask>(subReaders[i], sortFields);
+        futures.add(threadPool->scheduleTask(boost::protect(boost::bind<int32_t>(boost::mem_fn(&FieldCacheWarmerTask::call), tasks[i]))));
+    }
+    return tasks;
+}
+
+Collection<FuturePtr> FieldCacheWarmer::warmAsync(const IndexReaderPtr& reader) {
+    Collection<FuturePtr> futures(Collection<FuturePtr>::newInstance());
+    schedule(reader, futures);
+    return futures;
+}
+
+void FieldCacheWarmer::warm(const IndexReaderPtr& reader) {
+    Collection<FuturePtr> futures(Collection<FuturePtr>::newInstance());
+    Collection<FieldCacheWarmerTaskPtr> tasks(schedule(reader, futures));
+    for (Collection<FuturePtr>::iterator future = futures.begin(); future != futures.end(); ++future) {
+        (*future)->get<int32_t>();
+    }
+    for (Collection<FieldCacheWarmerTaskPtr>::iterator task = tasks.begin(); task != tasks.end(); ++task) {
+        (*task)->error.throwException();
+    }
+}
+
+bool FieldCacheWarmer::warmField(const IndexReaderPtr& reader, const SortFieldPtr& sortField) {
+    // load what the comparator of SortField::getComparator reads
+    FieldCachePtr cache(FieldCache::DEFAULT());
+    String field(sortField->getField());
+    ParserPtr parser(sortField->getParser());
+    if (sortField->getLocale()) {
+        cache->getStrings(reader, field);
+        return true;
+    }
+    int32_t type = sortField->getType();
+    if (type == SortField::SHORT || type == SortField::INT) {
+        cache->getPackedInts(reader, field, boost::static_pointer_cast<IntParser>(parser));
+    } else if (type == SortField::FLOAT || type == SortField::DOUBLE) {
+        cache->getPackedDoubles(reader, field, boost::static_pointer_cast<DoubleParser>(parser));
+    } else if (type == SortField::LONG) {
+        cache->getPackedLongs(reader, field, boost::static_pointer_cast<LongParser>(parser));
+    } else if (type == SortField::BYTE) {
+        cache->getBytes(reader, field, boost::static_pointer_cast<ByteParser>(parser));
+    } else if (type == SortField::STRING) {
+        cache->getPackedStringIndex(reader, field);
+    } else if (type == SortField::STRING_VAL) {
+        cache->getStrings(reader, field);
+    } else {
+        return false; // score, doc and custom sorts don't read the field cache here
+    }
+    return true;
+}
+
+FieldCacheWarmerTask::FieldCacheWarmerTask(const IndexReaderPtr& reader, Collection<SortFieldPtr> sortFields) {
+    this->reader = reader;
+    this->sortFields = sortFields;
+}
+
+FieldCacheWarmerTask::~FieldCacheWarmerTask() {
+}
+
+int32_t FieldCacheWarmerTask::call() {
+    int32_t loaded = 0;
+    try {
+        for (Collection<SortFieldPtr>::iterator sortField = sortFields.begin(); sortField != sortFields.end(); ++sortField) {
+            if (FieldCacheWarmer::warmField(reader, *sortField)) {
+                ++loaded;
+            }
+        }
+    } catch (LuceneException& e) {
+        error = e;
+        return -1;
+    }
+    return loaded;
+}
+
+}
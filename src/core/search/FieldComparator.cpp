@@ -7,6 +7,7 @@
 #include "LuceneInc.h"
 #include "FieldComparator.h"
 #include "FieldCache.h"
+#include "NumericDocValues.h"
 #include "ScoreCachingWrappingScorer.h"
 #include "Collator.h"
 
@@ -65,12 +66,16 @@ int32_t DoubleComparator::compare(int32_t slot1, int32_t slot2) {
 }
 
 int32_t DoubleComparator::compareBottom(int32_t doc) {
-    double v2 = currentReaderValues[doc];
+    double v2 = docValues->getDouble(doc);
     return bottom > v2 ? 1 : (bottom < v2 ? -1 : 0);
 }
 
+void DoubleComparator::copy(int32_t slot, int32_t doc) {
+    values[slot] = docValues->getDouble(doc);
+}
+
 void DoubleComparator::setNextReader(const IndexReaderPtr& reader, int32_t docBase) {
-    currentReaderValues = FieldCache::DEFAULT()->getDoubles(reader, field, parser);
+    docValues = FieldCache::DEFAULT()->getPackedDoubles(reader, field, parser);
 }
 
 IntComparator::IntComparator(int32_t numHits, const String& field, const ParserPtr& parser) : NumericComparator<int32_t>(numHits, field) {
@@ -87,12 +92,16 @@ int32_t IntComparator::compare(int32_t slot1, int32_t slot2) {
 }
 
 int32_t IntComparator::compareBottom(int32_t doc) {
-    int32_t v2 = currentReaderValues[doc];
+    int32_t v2 = (int32_t)docValues->getLong(doc);
     return bottom > v2 ? 1 : (bottom < v2 ? -1 : 0);
 }
 
+void IntComparator::copy(int32_t slot, int32_t doc) {
+    values[slot] = (int32_t)docValues->getLong(doc);
+}
+
 void IntComparator::setNextReader(const IndexReaderPtr& reader, int32_t docBase) {
-    currentReaderValues = FieldCache::DEFAULT()->getInts(reader, field, parser);
+    docValues = FieldCache::DEFAULT()->getPackedInts(reader, field, parser);
 }
 
 LongComparator::LongComparator(int32_t numHits, const String& field, const ParserPtr& parser) : NumericComparator<int64_t>(numHits, field) {
@@ -109,12 +118,16 @@ int32_t LongComparator::compare(int32_t slot1, int32_t slot2) {
 }
 
 int32_t LongComparator::compareBottom(int32_t doc) {
-    int64_t v2 = currentReaderValues[doc];
+    int64_t v2 = docValues->getLong(doc);
     return bottom > v2 ? 1 : (bottom < v2 ? -1 : 0);
 }
 
+void LongComparator::copy(int32_t slot, int32_t doc) {
+    values[slot] = docValues->getLong(doc);
+}
+
 void LongComparator::setNextReader(const IndexReaderPtr& reader, int32_t docBase) {
-    currentReaderValues = FieldCache::DEFAULT()->getLongs(reader, field, parser);
+    docValues = FieldCache::DEFAULT()->getPackedLongs(reader, field, parser);
 }
 
 RelevanceComparator::RelevanceComparator(int32_t numHits) : NumericComparator<double>(numHits) {
@@ -204,7 +217,7 @@ int32_t StringOrdValComparator::compare(int32_t slot1, int32_t slot2) {
 
 int32_t StringOrdValComparator::compareBottom(int32_t doc) {
     BOOST_ASSERT(bottomSlot != -1);
-    int32_t order = this->order[doc];
+    int32_t order = (int32_t)this->order->get(doc);
     int32_t cmp = bottomOrd - order;
     if (cmp != 0) {
         return cmp;
@@ -248,7 +261,7 @@ int32_t StringOrdValComparator::binarySearch(Collection<String> lookup, const St
 }
 
 void StringOrdValComparator::copy(int32_t slot, int32_t doc) {
-    int32_t ord = order[doc];
+    int32_t ord = (int32_t)order->get(doc);
     ords[slot] = ord;
     BOOST_ASSERT(ord >= 0);
     values[slot] = lookup[ord];
@@ -256,9 +269,9 @@ void StringOrdValComparator::copy(int32_t slot, int32_t doc) {
 }
 
 void StringOrdValComparator::setNextReader(const IndexReaderPtr& reader, int32_t docBase) {
-    StringIndexPtr currentReaderValues(FieldCache::DEFAULT()->getStringIndex(reader, field));
+    StringIndexPtr currentReaderValues(FieldCache::DEFAULT()->getPackedStringIndex(reader, field));
     ++currentReaderGen;
-    order = currentReaderValues->order;
+    order = currentReaderValues->packedOrder;
     lookup = currentReaderValues->lookup;
     BOOST_ASSERT(!lookup.empty());
     if (bottomSlot != -1) {
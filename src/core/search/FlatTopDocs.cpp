@@ -0,0 +1,35 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "FlatTopDocs.h"
+#include "TopDocs.h"
+#include "ScoreDoc.h"
+
+namespace Lucene {
+
+FlatTopDocs::FlatTopDocs(int32_t totalHits, Collection<FlatScoreDoc> scoreDocs, double maxScore) {
+    this->totalHits = totalHits;
+    this->scoreDocs = scoreDocs;
+    this->maxScore = maxScore;
+}
+
+FlatTopDocs::~FlatTopDocs() {
+}
+
+double FlatTopDocs::getMaxScore() {
+    return maxScore;
+}
+
+TopDocsPtr FlatTopDocs::toTopDocs() {
+    Collection<ScoreDocPtr> results(Collection<ScoreDocPtr>::newInstance(scoreDocs.size()));
+    for (int32_t i = 0; i < scoreDocs.size(); ++i) {
+        results[i] = newLucene<ScoreDoc>(scoreDocs[i].doc, scoreDocs[i].score);
+    }
+    return newLucene<TopDocs>(totalHits, results, maxScore);
+}
+
+}
@@ -0,0 +1,198 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "FlatTopScoreDocCollector.h"
+#include "_FlatTopScoreDocCollector.h"
+#include "FlatTopDocs.h"
+#include "TopDocs.h"
+#include "Scorer.h"
+#include "MiscUtils.h"
+
+namespace Lucene {
+
+/// Same order as {@link HitQueue}: lower scores first, and higher docs first among equal scores.
+static inline bool lessThan(const FlatScoreDoc& first, const FlatScoreDoc& second) {
+    if (first.score == second.score) {
+        return first.doc > second.doc;
+    } else {
+        return first.score < second.score;
+    }
+}
+
+/// Best hits first.
+static inline bool greaterThan(const FlatScoreDoc& first, const FlatScoreDoc& second) {
+    return lessThan(second, first);
+}
+
+FlatTopScoreDocCollector::FlatTopScoreDocCollector(int32_t numHits) {
+    if (numHits <= 0) {
+        boost::throw_exception(IllegalArgumentException(L"numHits must be > 0"));
+    }
+    this->numHits = numHits;
+    FlatScoreDoc sentinel;
+    sentinel.doc = INT_MAX;
+    sentinel.score = -std::numeric_limits<double>::infinity();
+    heap = Collection<FlatScoreDoc>::newInstance(numHits + 1);
+    std::fill(heap.begin(), heap.end(), sentinel);
+    heapArray = &heap[0];
+    totalHits = 0;
+    docBase = 0;
+    __scorer = NULL;
+}
+
+FlatTopScoreDocCollector::~FlatTopScoreDocCollector() {
+}
+
+FlatTopScoreDocCollectorPtr FlatTopScoreDocCollector::create(int32_t numHits, bool docsScoredInOrder) {
+    if (docsScoredInOrder) {
+        return newLucene<InOrderFlatTopScoreDocCollector>(numHits);
+    } else {
+        return newLucene<OutOfOrderFlatTopScoreDocCollector>(numHits);
+    }
+}
+
+void FlatTopScoreDocCollector::setNextReader(const IndexReaderPtr& reader, int32_t docBase) {
+    this->docBase = docBase;
+}
+
+void FlatTopScoreDocCollector::setScorer(const ScorerPtr& scorer) {
+    this->_scorer = scorer;
+    this->__scorer = scorer.get();
+}
+
+int32_t FlatTopScoreDocCollector::getTotalHits() {
+    return totalHits;
+}
+
+FlatTopDocsPtr FlatTopScoreDocCollector::flatTopDocs() {
+    return flatTopDocs(0, numHits);
+}
+
+FlatTopDocsPtr FlatTopScoreDocCollector::flatTopDocs(int32_t start, int32_t howMany) {
+    int32_t size = std::min(totalHits, numHits);
+    Collection<FlatScoreDoc> results(Collection<FlatScoreDoc>::newInstance());
+    double maxScore = std::numeric_limits<double>::quiet_NaN();
+    if (size > 0) {
+        // sorting a copy leaves the heap as it is; the sentinels sort after every hit
+        Collection<FlatScoreDoc> sorted(Collection<FlatScoreDoc>::newInstance(heap.begin() + 1, heap.end()));
+        std::sort(sorted.begin(), sorted.end(), greaterThan);
+        maxScore = sorted[0].score;
+        if (start >= 0 && start < size && howMany > 0) {
+            int32_t end = std::min(size, start + std::min(howMany, size));
+            results.addAll(sorted.begin() + start, sorted.begin() + end);
+        }
+    }
+    return newLucene<FlatTopDocs>(totalHits, results, maxScore);
+}
+
+TopDocsPtr FlatTopScoreDocCollector::topDocs() {
+    return flatTopDocs()->toTopDocs();
+}
+
+void FlatTopScoreDocCollector::updateTop(int32_t doc, double score) {
+    FlatScoreDoc node;
+    node.doc = doc;
+    node.score = score;
+    int32_t i = 1;
+    int32_t j = 2;
+    while (j <= numHits) {
+        int32_t k = j + 1;
+        if (k <= numHits && lessThan(heapArray[k], heapArray[j])) {
+            j = k;
+        }
+        if (!lessThan(heapArray[j], node)) {
+            break;
+        }
+        heapArray[i] = heapArray[j];
+        i = j;
+        j = i << 1;
+    }
+    heapArray[i] = node;
+}
+
+InOrderFlatTopScoreDocCollector::InOrderFlatTopScoreDocCollector(int32_t numHits) : FlatTopScoreDocCollector(numHits) {
+}
+
+InOrderFlatTopScoreDocCollector::~InOrderFlatTopScoreDocCollector() {
+}
+
+void InOrderFlatTopScoreDocCollector::collect(int32_t doc) {
+    double score = __scorer->score();
+
+    // This collector cannot handle these scores
+    BOOST_ASSERT(score != -std::numeric_limits<double>::infinity());
+    BOOST_ASSERT(!MiscUtils::isNaN(score));
+
+    ++totalHits;
+    if (score <= heapArray[1].score) {
+        // Since docs are returned in-order (ie., increasing doc Id), a document with equal score to the
+        // weakest hit cannot compete since docs with lower doc Ids are favoured.  Therefore reject those
+        // docs too.
+        return;
+    }
+    updateTop(doc + docBase, score);
+}
+
+void InOrderFlatTopScoreDocCollector::collectBatch(Collection<int32_t> docs, Collection<double> scores, int32_t count) {
+    const int32_t* batchDocs = docs.get()->data();
+    const double* batchScores = scores.get()->data();
+    totalHits += count;
+    for (int32_t i = 0; i < count; ++i) {
+        double score = batchScores[i];
+        BOOST_ASSERT(score != -std::numeric_limits<double>::infinity());
+        BOOST_ASSERT(!MiscUtils::isNaN(score));
+        if (score <= heapArray[1].score) {
+            continue; // see collect(int32_t)
+        }
+        updateTop(batchDocs[i] + docBase, score);
+    }
+}
+
+bool InOrderFlatTopScoreDocCollector::acceptsDocsOutOfOrder() {
+    return false;
+}
+
+OutOfOrderFlatTopScoreDocCollector::OutOfOrderFlatTopScoreDocCollector(int32_t numHits) : FlatTopScoreDocCollector(numHits) {
+}
+
+OutOfOrderFlatTopScoreDocCollector::~OutOfOrderFlatTopScoreDocCollector() {
+}
+
+void OutOfOrderFlatTopScoreDocCollector::collect(int32_t doc) {
+    double score = __scorer->score();
+
+    // This collector cannot handle NaN
+    BOOST_ASSERT(!MiscUtils::isNaN(score));
+
+    ++totalHits;
+    doc += docBase;
+    if (score < heapArray[1].score || (score == heapArray[1].score && doc > heapArray[1].doc)) {
+        return;
+    }
+    updateTop(doc, score);
+}
+
+void OutOfOrderFlatTopScoreDocCollector::collectBatch(Collection<int32_t> docs, Collection<double> scores, int32_t count) {
+    const int32_t* batchDocs = docs.get()->data();
+    const double* batchScores = scores.get()->data();
+    totalHits += count;
+    for (int32_t i = 0; i < count; ++i) {
+        double score = batchScores[i];
+        BOOST_ASSERT(!MiscUtils::isNaN(score));
+        int32_t doc = batchDocs[i] + docBase;
+        if (score < heapArray[1].score || (score == heapArray[1].score && doc > heapArray[1].doc)) {
+            continue;
+        }
+        updateTop(doc, score);
+    }
+}
+
+bool OutOfOrderFlatTopScoreDocCollector::acceptsDocsOutOfOrder() {
+    return true;
+}
+
+}
@@ -8,11 +8,14 @@
 #include "FuzzyQuery.h"
 #include "_FuzzyQuery.h"
 #include "FuzzyTermEnum.h"
+#include "AutomatonFuzzyTermEnum.h"
+#include "LevenshteinAutomata.h"
 #include "Term.h"
 #include "TermQuery.h"
 #include "BooleanQuery.h"
 #include "BooleanClause.h"
 #include "MiscUtils.h"
+#include "StringUtils.h"
 
 namespace Lucene {
 
@@ -30,6 +33,24 @@ FuzzyQuery::FuzzyQuery(const TermPtr& term) {
     ConstructQuery(term, defaultMinSimilarity(), defaultPrefixLength);
 }
 
+FuzzyQuery::FuzzyQuery(const TermPtr& term, double minimumSimilarity, int32_t prefixLength, int32_t maxEdits) {
+    if (maxEdits < 0 || maxEdits > LevenshteinAutomata::MAXIMUM_SUPPORTED_DISTANCE) {
+        boost::throw_exception(IllegalArgumentException(L"maxEdits must be between 0 and " + StringUtils::toString(LevenshteinAutomata::MAXIMUM_SUPPORTED_DISTANCE)));
+    }
+    ConstructQuery(term, minimumSimilarity, prefixLength);
+    this->maxSimilarityEdits = maxEdits;
+}
+
+FuzzyQuery::FuzzyQuery(const TermPtr& term, int32_t maxEdits, int32_t prefixLength, bool transpositions) {
+    if (maxEdits < 0 || maxEdits > LevenshteinAutomata::MAXIMUM_SUPPORTED_DISTANCE) {
+        boost::throw_exception(IllegalArgumentException(L"maxEdits must be between 0 and " + StringUtils::toString(LevenshteinAutomata::MAXIMUM_SUPPORTED_DISTANCE)));
+    }
+    ConstructQuery(term, 0.0, prefixLength);
+    this->maxEdits = maxEdits;
+    this->transpositions = transpositions;
+    this->termLongEnough = true;
+}
+
 FuzzyQuery::~FuzzyQuery() {
 }
 
@@ -49,6 +70,9 @@ void FuzzyQuery::ConstructQuery(const TermPtr& term, double minimumSimilarity, i
 
     this->minimumSimilarity = minimumSimilarity;
     this->prefixLength = prefixLength;
+    this->maxEdits = -1;
+    this->maxSimilarityEdits = -1;
+    this->transpositions = false;
     rewriteMethod = SCORING_BOOLEAN_QUERY_REWRITE();
 }
 
@@ -61,11 +85,33 @@ double FuzzyQuery::getMinSimilarity() {
     return minimumSimilarity;
 }
 
+int32_t FuzzyQuery::floatToEdits(double minimumSimilarity, int32_t termLength) {
+    return std::min((int32_t)((1.0 - minimumSimilarity) * (double)termLength), LevenshteinAutomata::MAXIMUM_SUPPORTED_DISTANCE);
+}
+
 int32_t FuzzyQuery::getPrefixLength() {
     return prefixLength;
 }
 
+int32_t FuzzyQuery::getMaxEdits() {
+    return maxEdits;
+}
+
+bool FuzzyQuery::getTranspositions() {
+    return transpositions;
+}
+
 FilteredTermEnumPtr FuzzyQuery::getEnum(const IndexReaderPtr& reader) {
+    if (maxEdits >= 0) {
+        return newLucene<AutomatonFuzzyTermEnum>(reader, getTerm(), maxEdits, prefixLength, transpositions);
+    }
+    if (maxSimilarityEdits >= 0) {
+        return newLucene<AutomatonFuzzyTermEnum>(reader, getTerm(), minimumSimilarity, prefixLength, maxSimilarityEdits);
+    }
+    // the automata get too large beyond a few edits, when scanning the terms is the better option anyway
+    if (AutomatonFuzzyTermEnum::maxEditsForSimilarity(getTerm(), minimumSimilarity) <= LevenshteinAutomata::MAXIMUM_SUPPORTED_DISTANCE) {
+        return newLucene<AutomatonFuzzyTermEnum>(reader, getTerm(), minimumSimilarity, prefixLength);
+    }
     return newLucene<FuzzyTermEnum>(reader, getTerm(), minimumSimilarity, prefixLength);
 }
 
@@ -128,6 +174,9 @@ LuceneObjectPtr FuzzyQuery::clone(const LuceneObjectPtr& other) {
     FuzzyQueryPtr cloneQuery(boost::dynamic_pointer_cast<FuzzyQuery>(clone));
     cloneQuery->minimumSimilarity = minimumSimilarity;
     cloneQuery->prefixLength = prefixLength;
+    cloneQuery->maxEdits = maxEdits;
+    cloneQuery->maxSimilarityEdits = maxSimilarityEdits;
+    cloneQuery->transpositions = transpositions;
     cloneQuery->termLongEnough = termLongEnough;
     cloneQuery->term = term;
     return cloneQuery;
@@ -138,7 +187,13 @@ String FuzzyQuery::toString(const String& field) {
     if (term->field() != field) {
         buffer << term->field() << L":";
     }
-    buffer << term->text() << L"~" << minimumSimilarity << boostString();
+    buffer << term->text() << L"~";
+    if (maxEdits >= 0) {
+        buffer << maxEdits;
+    } else {
+        buffer << minimumSimilarity;
+    }
+    buffer << boostString();
     return buffer.str();
 }
 
@@ -147,6 +202,9 @@ int32_t FuzzyQuery::hashCode() {
     int32_t result = MultiTermQuery::hashCode();
     result = prime * result + MiscUtils::doubleToIntBits(minimumSimilarity);
     result = prime * result + prefixLength;
+    result = prime * result + maxEdits;
+    result = prime * result + maxSimilarityEdits;
+    result = prime * result + (transpositions ? 1231 : 1237);
     result = prime * result + (term ? term->hashCode() : 0);
     return result;
 }
@@ -171,6 +229,9 @@ bool FuzzyQuery::equals(const LuceneObjectPtr& other) {
     if (prefixLength != otherFuzzyQuery->prefixLength) {
         return false;
     }
+    if (maxEdits != otherFuzzyQuery->maxEdits || maxSimilarityEdits != otherFuzzyQuery->maxSimilarityEdits || transpositions != otherFuzzyQuery->transpositions) {
+        return false;
+    }
     if (!term) {
         if (otherFuzzyQuery->term) {
             return false;
@@ -5,6 +5,13 @@
 /////////////////////////////////////////////////////////////////////////////
 
 #include "LuceneInc.h"
+#include <boost/version.hpp>
+#if BOOST_VERSION >= 107300  // Boost 1.73.0+
+#include <boost/bind/bind.hpp>
+#else
+#include <boost/bind.hpp>
+#endif
+#include <boost/bind/protect.hpp>
 #include "IndexSearcher.h"
 #include "IndexReader.h"
 #include "TopScoreDocCollector.h"
@@ -16,6 +23,11 @@
 #include "Filter.h"
 #include "Query.h"
 #include "ReaderUtil.h"
+#include "ThreadPool.h"
+#include "HitQueue.h"
+#include "FieldDocSortedHitQueue.h"
+#include "FieldDoc.h"
+#include "_MultiSearcher.h"
 
 namespace Lucene {
 
@@ -27,12 +39,25 @@ IndexSearcher::IndexSearcher(const IndexReaderPtr& reader) {
     ConstructSearcher(reader, false);
 }
 
+IndexSearcher::IndexSearcher(const IndexReaderPtr& reader, const ThreadPoolPtr& executor) {
+    ConstructSearcher(reader, false);
+    this->executor = executor;
+    if (executor) {
+        subSearchers = Collection<SearchablePtr>::newInstance(subReaders.size());
+        for (int32_t i = 0; i < subReaders.size(); ++i) {
+            subSearchers[i] = newLucene<IndexSearcher>(subReaders[i]);
+        }
+    }
+}
+
 IndexSearcher::IndexSearcher(const IndexReaderPtr& reader, Collection<IndexReaderPtr> subReaders, Collection<int32_t> docStarts) {
     this->fieldSortDoTrackScores = false;
     this->fieldSortDoMaxScore = false;
+    this->totalHitsLowerBound = false;
     this->reader = reader;
     this->subReaders = subReaders;
     this->docStarts = docStarts;
+    this->subSearchers = Collection<SearchablePtr>::newInstance();
     closeReader = false;
 }
 
@@ -42,8 +67,10 @@ IndexSearcher::~IndexSearcher() {
 void IndexSearcher::ConstructSearcher(const IndexReaderPtr& reader, bool closeReader) {
     this->fieldSortDoTrackScores = false;
     this->fieldSortDoMaxScore = false;
+    this->totalHitsLowerBound = false;
     this->reader = reader;
     this->closeReader = closeReader;
+    this->subSearchers = Collection<SearchablePtr>::newInstance(); // only searched concurrently with an executor
 
     Collection<IndexReaderPtr> subReadersList(Collection<IndexReaderPtr>::newInstance());
     gatherSubReaders(subReadersList, reader);
@@ -64,6 +91,10 @@ IndexReaderPtr IndexSearcher::getIndexReader() {
     return reader;
 }
 
+ThreadPoolPtr IndexSearcher::getExecutor() {
+    return executor;
+}
+
 void IndexSearcher::close() {
     if (closeReader) {
         reader->close();
@@ -90,8 +121,33 @@ TopDocsPtr IndexSearcher::search(const WeightPtr& weight, const FilterPtr& filte
     if (n <= 0) {
         boost::throw_exception(IllegalArgumentException(L"n must be > 0"));
     }
+    if (searchConcurrently()) {
+        return searchParallel(weight, filter, n);
+    }
+    if (totalHitsLowerBound && !filter) {
+        TopScoreDocCollectorPtr collector(TopScoreDocCollector::create(std::min(n, reader->maxDoc()), true, true));
+        for (int32_t i = 0; i < subReaders.size(); ++i) { // search each subreader
+            collector->setNextReader(subReaders[i], docStarts[i]);
+            ScorerPtr scorer(weight->competitiveScorer(subReaders[i]));
+            if (scorer) {
+                scorer->score(collector);
+            }
+        }
+        return collector->topDocs();
+    }
     TopScoreDocCollectorPtr collector(TopScoreDocCollector::create(std::min(n, reader->maxDoc()), !weight->scoresDocsOutOfOrder()));
-    search(weight, filter, collector);
+    if (filter) {
+        search(weight, filter, collector);
+    } else {
+        // the collector only needs the scores, so take them a batch at a time
+        for (int32_t i = 0; i < subReaders.size(); ++i) { // search each subreader
+            collector->setNextReader(subReaders[i], docStarts[i]);
+            ScorerPtr scorer(weight->scorer(subReaders[i], !collector->acceptsDocsOutOfOrder(), true));
+            if (scorer) {
+                scorer->scoreBatches(collector);
+            }
+        }
+    }
     return collector->topDocs();
 }
 
@@ -100,6 +156,10 @@ TopFieldDocsPtr IndexSearcher::search(const WeightPtr& weight, const FilterPtr&
 }
 
 TopFieldDocsPtr IndexSearcher::search(const WeightPtr& weight, const FilterPtr& filter, int32_t n, const SortPtr& sort, bool fillFields) {
+    // per-segment results can only be merged when their sort values are filled in
+    if (fillFields && searchConcurrently()) {
+        return searchParallel(weight, filter, n, sort);
+    }
     TopFieldCollectorPtr collector(TopFieldCollector::create(sort, std::min(n, reader->maxDoc()), fillFields, fieldSortDoTrackScores, fieldSortDoMaxScore, !weight->scoresDocsOutOfOrder()));
     search(weight, filter, collector);
     return boost::dynamic_pointer_cast<TopFieldDocs>(collector->topDocs());
@@ -122,6 +182,76 @@ void IndexSearcher::search(const WeightPtr& weight, const FilterPtr& filter, con
     }
 }
 
+bool IndexSearcher::searchConcurrently() {
+    return (executor && subSearchers.size() > 1);
+}
+
+TopDocsPtr IndexSearcher::searchParallel(const WeightPtr& weight, const FilterPtr& filter, int32_t n) {
+    HitQueuePtr hq(newLucene<HitQueue>(std::min(n, reader->maxDoc()), false));
+    SynchronizePtr lock(newInstance<Synchronize>());
+    Collection<FuturePtr> searchThreads(Collection<FuturePtr>::newInstance(subSearchers.size()));
+    Collection<MultiSearcherCallableNoSortPtr> segmentSearcher(Collection<MultiSearcherCallableNoSortPtr>::newInstance(subSearchers.size()));
+    for (int32_t i = 0; i < subSearchers.size(); ++i) { // search each segment
+        segmentSearcher[i] = newLucene<MultiSearcherCallableNoSort>(lock, subSearchers[i], weight, filter, n, hq, i, docStarts);
+        searchThreads[i] = executor->scheduleTask(boost::protect(boost::bind<TopDocsPtr>(boost::mem_fn(&MultiSearcherCallableNoSort::call), segmentSearcher[i])));
+    }
+
+    int32_t totalHits = 0;
+    bool totalHitsIsLowerBound = false;
+    double maxScore = -std::numeric_limits<double>::infinity();
+
+    for (int32_t i = 0; i < searchThreads.size(); ++i) {
+        TopDocsPtr topDocs(searchThreads[i]->get<TopDocsPtr>());
+        totalHits += topDocs->totalHits;
+        totalHitsIsLowerBound = totalHitsIsLowerBound || topDocs->totalHitsIsLowerBound;
+        maxScore = std::max(maxScore, topDocs->maxScore);
+    }
+
+    Collection<ScoreDocPtr> scoreDocs(Collection<ScoreDocPtr>::newInstance(hq->size()));
+    for (int32_t i = hq->size() - 1; i >= 0; --i) { // put docs in array
+        scoreDocs[i] = hq->pop();
+    }
+
+    if (maxScore == -std::numeric_limits<double>::infinity()) {
+        maxScore = std::numeric_limits<double>::quiet_NaN(); // no segment reported a max score
+    }
+
+    TopDocsPtr topDocs(newLucene<TopDocs>(totalHits, scoreDocs, maxScore));
+    topDocs->totalHitsIsLowerBound = totalHitsIsLowerBound;
+    return topDocs;
+}
+
+TopFieldDocsPtr IndexSearcher::searchParallel(const WeightPtr& weight, const FilterPtr& filter, int32_t n, const SortPtr& sort) {
+    FieldDocSortedHitQueuePtr hq(newLucene<FieldDocSortedHitQueue>(std::min(n, reader->maxDoc())));
+    SynchronizePtr lock(newInstance<Synchronize>());
+    Collection<FuturePtr> searchThreads(Collection<FuturePtr>::newInstance(subSearchers.size()));
+    Collection<MultiSearcherCallableWithSortPtr> segmentSearcher(Collection<MultiSearcherCallableWithSortPtr>::newInstance(subSearchers.size()));
+    for (int32_t i = 0; i < subSearchers.size(); ++i) { // search each segment
+        segmentSearcher[i] = newLucene<MultiSearcherCallableWithSort>(lock, subSearchers[i], weight, filter, n, hq, sort, i, docStarts);
+        searchThreads[i] = executor->scheduleTask(boost::protect(boost::bind<TopFieldDocsPtr>(boost::mem_fn(&MultiSearcherCallableWithSort::call), segmentSearcher[i])));
+    }
+
+    int32_t totalHits = 0;
+    double maxScore = -std::numeric_limits<double>::infinity();
+
+    for (int32_t i = 0; i < searchThreads.size(); ++i) {
+        TopFieldDocsPtr topDocs(searchThreads[i]->get<TopFieldDocsPtr>());
+        totalHits += topDocs->totalHits;
+        maxScore = std::max(maxScore, topDocs->maxScore);
+    }
+
+    Collection<ScoreDocPtr> scoreDocs(Collection<ScoreDocPtr>::newInstance(hq->size()));
+    for (int32_t i = hq->size() - 1; i >= 0; --i) { // put docs in array
+        scoreDocs[i] = hq->pop();
+    }
+
+    if (maxScore == -std::numeric_limits<double>::infinity()) {
+        maxScore = std::numeric_limits<double>::quiet_NaN(); // no segment reported a max score
+    }
+
+    return newLucene<TopFieldDocs>(totalHits, scoreDocs, hq->getFields(), maxScore);
+}
+
 void IndexSearcher::searchWithFilter(const IndexReaderPtr& reader, const WeightPtr& weight, const FilterPtr& filter, const CollectorPtr& collector) {
     BOOST_ASSERT(filter);
 
@@ -183,6 +313,20 @@ ExplanationPtr IndexSearcher::explain(const WeightPtr& weight, int32_t doc) {
 void IndexSearcher::setDefaultFieldSortScoring(bool doTrackScores, bool doMaxScore) {
     fieldSortDoTrackScores = doTrackScores;
     fieldSortDoMaxScore = doMaxScore;
+    for (int32_t i = 0; i < subSearchers.size(); ++i) {
+        boost::static_pointer_cast<IndexSearcher>(subSearchers[i])->setDefaultFieldSortScoring(doTrackScores, doMaxScore);
+    }
+}
+
+void IndexSearcher::setTotalHitsLowerBound(bool totalHitsLowerBound) {
+    this->totalHitsLowerBound = totalHitsLowerBound;
+    for (int32_t i = 0; i < subSearchers.size(); ++i) {
+        boost::static_pointer_cast<IndexSearcher>(subSearchers[i])->setTotalHitsLowerBound(totalHitsLowerBound);
+    }
+}
+
+bool IndexSearcher::getTotalHitsLowerBound() {
+    return totalHitsLowerBound;
 }
 
 }
@@ -0,0 +1,87 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "RegexpQuery.h"
+#include "AutomatonTermEnum.h"
+#include "RegExp.h"
+#include "Automaton.h"
+#include "Term.h"
+#include "MiscUtils.h"
+
+namespace Lucene {
+
+RegexpQuery::RegexpQuery(const TermPtr& term) {
+    this->term = term;
+    this->automaton = newLucene<RegExp>(term->text())->toAutomaton();
+}
+
+RegexpQuery::RegexpQuery(const TermPtr& term, int32_t maxDeterminizedStates) {
+    this->term = term;
+    this->automaton = newLucene<RegExp>(term->text())->toAutomaton(maxDeterminizedStates);
+}
+
+RegexpQuery::~RegexpQuery() {
+}
+
+TermPtr RegexpQuery::getTerm() {
+    return term;
+}
+
+FilteredTermEnumPtr RegexpQuery::getEnum(const IndexReaderPtr& reader) {
+    return newLucene<AutomatonTermEnum>(reader, term->field(), automaton);
+}
+
+String RegexpQuery::toString(const String& field) {
+    StringStream buffer;
+    if (term->field() != field) {
+        buffer << term->field() << L":";
+    }
+    buffer << L"/" << term->text() << L"/" << boostString();
+    return buffer.str();
+}
+
+LuceneObjectPtr RegexpQuery::clone(const LuceneObjectPtr& other) {
+    // no limit, the expression compiled within the limit it was given
+    LuceneObjectPtr clone = MultiTermQuery::clone(other ? other : newLucene<RegexpQuery>(term, INT_MAX));
+    RegexpQueryPtr cloneQuery(boost::dynamic_pointer_cast<RegexpQuery>(clone));
+    cloneQuery->term = term;
+    cloneQuery->automaton = automaton;
+    return cloneQuery;
+}
+
+int32_t RegexpQuery::hashCode() {
+    int32_t prime = 31;
+    int32_t result = MultiTermQuery::hashCode();
+    result = prime * result + (term ? term->hashCode() : 0);
+    return result;
+}
+
+bool RegexpQuery::equals(const LuceneObjectPtr& other) {
+    if (LuceneObject::equals(other)) {
+        return true;
+    }
+    if (!MultiTermQuery::equals(other)) {
+        return false;
+    }
+    if (!MiscUtils::equalTypes(shared_from_this(), other)) {
+        return false;
+    }
+    RegexpQueryPtr otherRegexpQuery(boost::dynamic_pointer_cast<RegexpQuery>(other));
+    if (!otherRegexpQuery) {
+        return false;
+    }
+    if (!term) {
+        if (otherRegexpQuery->term) {
+            return false;
+        }
+    } else if (!term->equals(otherRegexpQuery->term)) {
+        return false;
+    }
+    return true;
+}
+
+}
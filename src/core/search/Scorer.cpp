@@ -9,7 +9,9 @@
 #include "Collector.h"
 
 namespace Lucene {
-    
+
+    const int32_t Scorer::BATCH_SIZE = 128;
+
     Scorer::Scorer(const SimilarityPtr& similarity) {
         this->similarity = similarity;
     }
@@ -25,6 +27,9 @@ namespace Lucene {
         return similarity;
     }
 
+    void Scorer::setMinCompetitiveScore(double minScore) {
+    }
+
     void Scorer::score(const CollectorPtr& collector) {
         collector->setScorer(shared_from_this());
         int32_t doc;
@@ -42,7 +47,28 @@ namespace Lucene {
         }
         return (doc != NO_MORE_DOCS);
     }
-    
+
+    void Scorer::scoreBatches(const CollectorPtr& collector) {
+        Collection<int32_t> docs(Collection<int32_t>::newInstance(BATCH_SIZE));
+        Collection<double> scores(Collection<double>::newInstance(BATCH_SIZE));
+        Collector* __collector = collector.get();
+        nextDoc();
+        int32_t count;
+        while ((count = scoreBatch(docs, scores, NO_MORE_DOCS)) > 0) {
+            __collector->collectBatch(docs, scores, count);
+        }
+    }
+
+    int32_t Scorer::scoreBatch(Collection<int32_t> docs, Collection<double> scores, int32_t max) {
+        int32_t size = docs.size();
+        int32_t count = 0;
+        for (int32_t doc = docID(); doc < max && count < size; doc = nextDoc()) {
+            docs[count] = doc;
+            scores[count++] = score();
+        }
+        return count;
+    }
+
     void Scorer::visitSubScorers(QueryPtr parent, BooleanClause::Occur relationship,
                                  ScorerVisitor *visitor){
         QueryPtr q = weight->getQuery();
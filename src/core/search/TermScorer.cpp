@@ -97,6 +97,37 @@ double TermScorer::score() {
     return norms ? raw * SIM_NORM_DECODER()[norms[doc] & 0xff] : raw; // normalize for field
 }
 
+int32_t TermScorer::scoreBatch(Collection<int32_t> docs, Collection<double> scores, int32_t max) {
+    int32_t* batchDocs = docs.get()->data();
+    double* batchScores = scores.get()->data();
+    int32_t size = docs.size();
+    const double* cache = scoreCache.get()->data();
+    const double* normDecoder = &SIM_NORM_DECODER()[0];
+    const uint8_t* normBytes = norms ? norms.get() : NULL;
+    int32_t count = 0;
+    while (doc < max && count < size) {
+        const int32_t* bufferDocs = __docs->data();
+        const int32_t* bufferFreqs = __freqs->data();
+        int32_t last = std::min(pointerMax, pointer + size - count);
+        int32_t i = pointer;
+        for (; i < last && bufferDocs[i] < max; ++i) {
+            int32_t f = bufferFreqs[i];
+            double raw = f < SCORE_CACHE_SIZE ? cache[f] : similarity->tf(f) * weightValue; // compute tf(f) * weight
+            batchDocs[count] = bufferDocs[i];
+            batchScores[count++] = normBytes ? raw * normDecoder[normBytes[bufferDocs[i]]] : raw; // normalize for field
+        }
+        // move to the first posting not scored, refilling the buffers if they are used up
+        pointer = i - 1;
+        TermScorer::nextDoc();
+    }
+    return count;
+}
+
+double TermScorer::getMaxScore(int32_t maxFreq, int32_t maxNorm) {
+    double raw = maxFreq < SCORE_CACHE_SIZE ? scoreCache[maxFreq] : similarity->tf(maxFreq) * weightValue;
+    return norms ? raw * SIM_NORM_DECODER()[maxNorm & 0xff] : raw;
+}
+
 int32_t TermScorer::advance(int32_t target) {
     // first scan in cache
     for (++pointer; pointer < pointerMax; ++pointer) {
@@ -13,12 +13,14 @@ TopDocs::TopDocs(int32_t totalHits, Collection<ScoreDocPtr> scoreDocs) {
     this->totalHits = totalHits;
     this->scoreDocs = scoreDocs;
     this->maxScore = std::numeric_limits<double>::quiet_NaN();
+    this->totalHitsIsLowerBound = false;
 }
 
 TopDocs::TopDocs(int32_t totalHits, Collection<ScoreDocPtr> scoreDocs, double maxScore) {
     this->totalHits = totalHits;
     this->scoreDocs = scoreDocs;
     this->maxScore = maxScore;
+    this->totalHitsIsLowerBound = false;
 }
 
 TopDocs::~TopDocs() {
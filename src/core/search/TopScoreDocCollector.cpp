@@ -20,6 +20,8 @@ TopScoreDocCollector::TopScoreDocCollector(int32_t numHits) : TopDocsCollector(n
     // is already initialized.
     pqTop = pq->top();
     docBase = 0;
+    __scorer = NULL;
+    totalHitsLowerBound = false;
 }
 
 TopScoreDocCollector::~TopScoreDocCollector() {
@@ -33,6 +35,15 @@ TopScoreDocCollectorPtr TopScoreDocCollector::create(int32_t numHits, bool docsS
     }
 }
 
+TopScoreDocCollectorPtr TopScoreDocCollector::create(int32_t numHits, bool docsScoredInOrder, bool totalHitsLowerBound) {
+    if (totalHitsLowerBound && !docsScoredInOrder) {
+        boost::throw_exception(IllegalArgumentException(L"totalHitsLowerBound requires docs scored in order"));
+    }
+    TopScoreDocCollectorPtr collector(create(numHits, docsScoredInOrder));
+    collector->totalHitsLowerBound = totalHitsLowerBound;
+    return collector;
+}
+
 TopDocsPtr TopScoreDocCollector::newTopDocs(Collection<ScoreDocPtr> results, int32_t start) {
     if (!results) {
         return EMPTY_TOPDOCS();
@@ -51,7 +62,9 @@ TopDocsPtr TopScoreDocCollector::newTopDocs(Collection<ScoreDocPtr> results, int
         maxScore = pq->pop()->score;
     }
 
-    return newLucene<TopDocs>(totalHits, results, maxScore);
+    TopDocsPtr topDocs(newLucene<TopDocs>(totalHits, results, maxScore));
+    topDocs->totalHitsIsLowerBound = totalHitsLowerBound;
+    return topDocs;
 }
 
 void TopScoreDocCollector::setNextReader(const IndexReaderPtr& reader, int32_t docBase) {
@@ -61,6 +74,9 @@ void TopScoreDocCollector::setNextReader(const IndexReaderPtr& reader, int32_t d
 void TopScoreDocCollector::setScorer(const ScorerPtr& scorer) {
     this->_scorer = scorer;
     this->__scorer = scorer.get();
+    if (totalHitsLowerBound && pqTop->score != -std::numeric_limits<double>::infinity()) {
+        __scorer->setMinCompetitiveScore(pqTop->score);
+    }
 }
 
 InOrderTopScoreDocCollector::InOrderTopScoreDocCollector(int32_t numHits) : TopScoreDocCollector(numHits) {
@@ -86,6 +102,28 @@ void InOrderTopScoreDocCollector::collect(int32_t doc) {
     pqTop->doc = doc + docBase;
     pqTop->score = score;
     pqTop = pq->updateTop();
+    if (totalHitsLowerBound && pqTop->score != -std::numeric_limits<double>::infinity()) {
+        __scorer->setMinCompetitiveScore(pqTop->score);
+    }
+}
+
+void InOrderTopScoreDocCollector::collectBatch(Collection<int32_t> docs, Collection<double> scores, int32_t count) {
+    const int32_t* batchDocs = docs.get()->data();
+    const double* batchScores = scores.get()->data();
+    totalHits += count;
+    double minScore = pqTop->score;
+    for (int32_t i = 0; i < count; ++i) {
+        double score = batchScores[i];
+        BOOST_ASSERT(score != -std::numeric_limits<double>::infinity());
+        BOOST_ASSERT(!MiscUtils::isNaN(score));
+        if (score <= minScore) {
+            continue; // see collect(int32_t)
+        }
+        pqTop->doc = batchDocs[i] + docBase;
+        pqTop->score = score;
+        pqTop = pq->updateTop();
+        minScore = pqTop->score;
+    }
 }
 
 bool InOrderTopScoreDocCollector::acceptsDocsOutOfOrder() {
@@ -114,6 +152,23 @@ void OutOfOrderTopScoreDocCollector::collect(int32_t doc) {
     pqTop = pq->updateTop();
 }
 
+void OutOfOrderTopScoreDocCollector::collectBatch(Collection<int32_t> docs, Collection<double> scores, int32_t count) {
+    const int32_t* batchDocs = docs.get()->data();
+    const double* batchScores = scores.get()->data();
+    totalHits += count;
+    for (int32_t i = 0; i < count; ++i) {
+        double score = batchScores[i];
+        BOOST_ASSERT(!MiscUtils::isNaN(score));
+        int32_t doc = batchDocs[i] + docBase;
+        if (score < pqTop->score || (score == pqTop->score && doc > pqTop->doc)) {
+            continue;
+        }
+        pqTop->doc = doc;
+        pqTop->score = score;
+        pqTop = pq->updateTop();
+    }
+}
+
 bool OutOfOrderTopScoreDocCollector::acceptsDocsOutOfOrder() {
     return true;
 }
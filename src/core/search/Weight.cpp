@@ -6,12 +6,17 @@
 
 #include "LuceneInc.h"
 #include "Weight.h"
+#include "Scorer.h"
 
 namespace Lucene {
 
 Weight::~Weight() {
 }
 
+ScorerPtr Weight::competitiveScorer(const IndexReaderPtr& reader) {
+    return scorer(reader, true, true);
+}
+
 bool Weight::scoresDocsOutOfOrder() {
     return false;
 }
@@ -11,6 +11,7 @@
 #include "Term.h"
 #include "PrefixQuery.h"
 #include "SingleTermEnum.h"
+#include "Automaton.h"
 #include "MiscUtils.h"
 
 namespace Lucene {
@@ -39,6 +40,29 @@ TermPtr WildcardQuery::getTerm() {
     return term;
 }
 
+AutomatonPtr WildcardQuery::toAutomaton(const TermPtr& wildcardTerm) {
+    AutomatonPtr nfa(newLucene<Automaton>());
+    int32_t state = nfa->createState();
+    String text(wildcardTerm->text());
+    for (String::const_iterator c = text.begin(); c != text.end(); ++c) {
+        if (*c == WildcardTermEnum::WILDCARD_STRING) {
+            if (c == text.begin() || *(c - 1) != WildcardTermEnum::WILDCARD_STRING) {
+                nfa->addTransition(state, state, Automaton::MIN_LABEL, Automaton::MAX_LABEL);
+            }
+        } else {
+            int32_t next = nfa->createState();
+            if (*c == WildcardTermEnum::WILDCARD_CHAR) {
+                nfa->addTransition(state, next, Automaton::MIN_LABEL, Automaton::MAX_LABEL);
+            } else {
+                nfa->addTransition(state, next, (int32_t)*c);
+            }
+            state = next;
+        }
+    }
+    nfa->setAccept(state, true);
+    return nfa->minimize();
+}
+
 QueryPtr WildcardQuery::rewrite(const IndexReaderPtr& reader) {
     if (termIsPrefix) {
         MultiTermQueryPtr rewritten(newLucene<PrefixQuery>(term->createTerm(term->text().substr(0, term->text().find('*')))));
@@ -7,8 +7,10 @@
 #include "LuceneInc.h"
 #include <boost/algorithm/string.hpp>
 #include "WildcardTermEnum.h"
-#include "Term.h"
+#include "WildcardQuery.h"
+#include "Automaton.h"
 #include "IndexReader.h"
+#include "Term.h"
 
 namespace Lucene {
 
@@ -16,9 +18,7 @@ const wchar_t WildcardTermEnum::WILDCARD_STRING = L'*';
 const wchar_t WildcardTermEnum::WILDCARD_CHAR = L'?';
 
 WildcardTermEnum::WildcardTermEnum(const IndexReaderPtr& reader, const TermPtr& term) {
-    _endEnum = false;
     searchTerm = term;
-    field = searchTerm->field();
     String searchTermText(searchTerm->text());
 
     String::size_type sidx = searchTermText.find(WILDCARD_STRING);
@@ -33,13 +33,28 @@ WildcardTermEnum::WildcardTermEnum(const IndexReaderPtr& reader, const TermPtr&
 
     preLen = pre.length();
     text = searchTermText.substr(preLen);
-    setEnum(reader->terms(newLucene<Term>(searchTerm->field(), pre)));
+
+    AutomatonPtr automaton;
+    try {
+        automaton = WildcardQuery::toAutomaton(searchTerm);
+    } catch (IllegalArgumentException&) {
+        // the automaton has too many states, so test every term with the prefix against the pattern instead
+    }
+    if (automaton) {
+        ConstructTermEnum(reader, searchTerm->field(), automaton);
+    } else {
+        field = searchTerm->field();
+        setEnum(reader->terms(newLucene<Term>(field, pre)));
+    }
 }
 
 WildcardTermEnum::~WildcardTermEnum() {
 }
 
 bool WildcardTermEnum::termCompare(const TermPtr& term) {
+    if (automaton) {
+        return AutomatonTermEnum::termCompare(term);
+    }
     if (field == term->field()) {
         String searchText(term->text());
         if (boost::starts_with(searchText, pre)) {
@@ -50,12 +65,8 @@ bool WildcardTermEnum::termCompare(const TermPtr& term) {
     return false;
 }
 
-double WildcardTermEnum::difference() {
-    return 1.0;
-}
-
-bool WildcardTermEnum::endEnum() {
-    return _endEnum;
+bool WildcardTermEnum::next() {
+    return automaton ? AutomatonTermEnum::next() : FilteredTermEnum::next();
 }
 
 bool WildcardTermEnum::wildcardEquals(const String& pattern, int32_t patternIdx, const String& string, int32_t stringIdx) {
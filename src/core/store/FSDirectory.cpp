@@ -8,6 +8,7 @@
 #include "FSDirectory.h"
 #include "NativeFSLockFactory.h"
 #include "SimpleFSDirectory.h"
+#include "NIOFSDirectory.h"
 #include "BufferedIndexInput.h"
 #include "LuceneThread.h"
 #include "FileUtils.h"
@@ -76,7 +77,11 @@ FSDirectoryPtr FSDirectory::open(const String& path) {
 }
 
 FSDirectoryPtr FSDirectory::open(const String& path, const LockFactoryPtr& lockFactory) {
+#if defined(_WIN32) || defined(_WIN64)
     return newLucene<SimpleFSDirectory>(path, lockFactory);
+#else
+    return newLucene<NIOFSDirectory>(path, lockFactory);
+#endif
 }
 
 void FSDirectory::createDir() {
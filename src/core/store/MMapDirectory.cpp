@@ -15,15 +15,34 @@
 
 namespace Lucene {
 
+const int64_t MMapDirectory::DEFAULT_MAX_CHUNK_SIZE = sizeof(void*) == 8 ? ((int64_t)1 << 30) : ((int64_t)1 << 28);
+
 MMapDirectory::MMapDirectory(const String& path, const LockFactoryPtr& lockFactory) : FSDirectory(path, lockFactory) {
+    setMaxChunkSize(DEFAULT_MAX_CHUNK_SIZE);
 }
 
 MMapDirectory::~MMapDirectory() {
 }
 
+void MMapDirectory::setMaxChunkSize(int64_t maxChunkSize) {
+    if (maxChunkSize < (int64_t)boost::iostreams::mapped_file_source::alignment()) {
+        boost::throw_exception(IllegalArgumentException(L"Maximum chunk size must be at least " +
+                               StringUtils::toString((int32_t)boost::iostreams::mapped_file_source::alignment())));
+    }
+    int32_t power = 0;
+    while (power < 30 && ((int64_t)1 << (power + 1)) <= maxChunkSize) {
+        ++power;
+    }
+    chunkSizePower = power;
+}
+
+int64_t MMapDirectory::getMaxChunkSize() {
+    return (int64_t)1 << chunkSizePower;
+}
+
 IndexInputPtr MMapDirectory::openInput(const String& name, int32_t bufferSize) {
     ensureOpen();
-    return newLucene<MMapIndexInput>(FileUtils::joinPath(directory, name));
+    return newLucene<MMapIndexInput>(FileUtils::joinPath(directory, name), chunkSizePower);
 }
 
 IndexOutputPtr MMapDirectory::createOutput(const String& name) {
@@ -31,70 +50,169 @@ IndexOutputPtr MMapDirectory::createOutput(const String& name) {
     return newLucene<SimpleFSIndexOutput>(FileUtils::joinPath(directory, name));
 }
 
-MMapIndexInput::MMapIndexInput(const String& path) {
-    _length = path.empty() ? 0 : (int32_t)FileUtils::fileLength(path);
-    bufferPosition = 0;
-    if (!path.empty()) {
-        try {
-            file.open(boost::filesystem::path(path), _length);
-        } catch (...) {
-            boost::throw_exception(FileNotFoundException(path));
+MMapIndexInput::MMapIndexInput(const String& path, int32_t chunkSizePower) {
+    this->chunkSizePower = chunkSizePower;
+    _length = path.empty() ? 0 : FileUtils::fileLength(path);
+    int64_t chunkSize = (int64_t)1 << chunkSizePower;
+    int32_t numChunks = (int32_t)((_length + chunkSize - 1) >> chunkSizePower);
+    chunks = Collection<boost::iostreams::mapped_file_source>::newInstance(numChunks);
+    try {
+        for (int32_t i = 0; i < numChunks; ++i) {
+            int64_t offset = (int64_t)i << chunkSizePower;
+            chunks[i].open(boost::filesystem::path(path), (size_t)std::min(chunkSize, _length - offset), offset);
         }
+    } catch (...) {
+        for (int32_t i = 0; i < numChunks; ++i) {
+            if (chunks[i].is_open()) {
+                chunks[i].close();
+            }
+        }
+        boost::throw_exception(FileNotFoundException(path));
     }
     isClone = false;
+    setChunk(0, 0);
 }
 
 MMapIndexInput::~MMapIndexInput() {
 }
 
-uint8_t MMapIndexInput::readByte() {
-    try {
-        return file.data()[bufferPosition++];
-    } catch (...) {
+void MMapIndexInput::setChunk(int32_t chunkIndex, int32_t position) {
+    curChunkIndex = chunkIndex;
+    chunkPosition = position;
+    if (chunks && chunkIndex < chunks.size()) {
+        curChunk = (const uint8_t*)chunks[chunkIndex].data();
+        curChunkLength = (int32_t)chunks[chunkIndex].size();
+    } else {
+        curChunk = NULL;
+        curChunkLength = 0;
+    }
+}
+
+void MMapIndexInput::nextChunk() {
+    if (!chunks || curChunkIndex + 1 >= chunks.size()) {
         boost::throw_exception(IOException(L"Read past EOF"));
-        return 0;
     }
+    setChunk(curChunkIndex + 1, 0);
+}
+
+uint8_t MMapIndexInput::readByte() {
+    if (chunkPosition >= curChunkLength) {
+        nextChunk();
+    }
+    return curChunk[chunkPosition++];
 }
 
 void MMapIndexInput::readBytes(uint8_t* b, int32_t offset, int32_t length) {
-    try {
-        MiscUtils::arrayCopy(file.data(), bufferPosition, b, offset, length);
-        bufferPosition += length;
-    } catch (...) {
-        boost::throw_exception(IOException(L"Read past EOF"));
+    while (length > 0) {
+        if (chunkPosition >= curChunkLength) {
+            nextChunk();
+        }
+        int32_t available = std::min(length, curChunkLength - chunkPosition);
+        MiscUtils::arrayCopy(curChunk, chunkPosition, b, offset, available);
+        chunkPosition += available;
+        offset += available;
+        length -= available;
+    }
+}
+
+int32_t MMapIndexInput::readInt() {
+    if (curChunkLength - chunkPosition < 4) {
+        return IndexInput::readInt(); // value spans chunks
     }
+    const uint8_t* p = curChunk + chunkPosition;
+    chunkPosition += 4;
+    return ((int32_t)p[0] << 24) | ((int32_t)p[1] << 16) | ((int32_t)p[2] << 8) | (int32_t)p[3];
+}
+
+int32_t MMapIndexInput::readVInt() {
+    if (curChunkLength - chunkPosition < 5) {
+        return IndexInput::readVInt(); // value may span chunks
+    }
+    const uint8_t* p = curChunk + chunkPosition;
+    uint8_t b = *p++;
+    int32_t i = (b & 0x7f);
+    for (int32_t shift = 7; (b & 0x80) != 0 && shift <= 28; shift += 7) {
+        b = *p++;
+        i |= (b & 0x7f) << shift;
+    }
+    chunkPosition = (int32_t)(p - curChunk);
+    return i;
+}
+
+int64_t MMapIndexInput::readLong() {
+    if (curChunkLength - chunkPosition < 8) {
+        return IndexInput::readLong(); // value spans chunks
+    }
+    const uint8_t* p = curChunk + chunkPosition;
+    chunkPosition += 8;
+    int64_t i = 0;
+    for (int32_t j = 0; j < 8; ++j) {
+        i = (i << 8) | p[j];
+    }
+    return i;
+}
+
+int64_t MMapIndexInput::readVLong() {
+    if (curChunkLength - chunkPosition < 9) {
+        return IndexInput::readVLong(); // value may span chunks
+    }
+    const uint8_t* p = curChunk + chunkPosition;
+    uint8_t b = *p++;
+    int64_t i = (b & 0x7f);
+    for (int32_t shift = 7; (b & 0x80) != 0 && shift <= 56; shift += 7) {
+        b = *p++;
+        i |= (int64_t)(b & 0x7f) << shift;
+    }
+    chunkPosition = (int32_t)(p - curChunk);
+    return i;
 }
 
 int64_t MMapIndexInput::getFilePointer() {
-    return bufferPosition;
+    return ((int64_t)curChunkIndex << chunkSizePower) + chunkPosition;
 }
 
 void MMapIndexInput::seek(int64_t pos) {
-    bufferPosition = (int32_t)pos;
+    if (pos < 0 || pos > _length) {
+        boost::throw_exception(IOException(L"Seek past EOF"));
+    }
+    int32_t chunkIndex = (int32_t)(pos >> chunkSizePower);
+    int32_t position = (int32_t)(pos & (((int64_t)1 << chunkSizePower) - 1));
+    if (chunkIndex > 0 && chunkIndex == chunks.size()) {
+        // positioned exactly at the end of the last chunk
+        --chunkIndex;
+        position = (int32_t)(pos - ((int64_t)chunkIndex << chunkSizePower));
+    }
+    setChunk(chunkIndex, position);
 }
 
 int64_t MMapIndexInput::length() {
-    return (int64_t)_length;
+    return _length;
 }
 
 void MMapIndexInput::close() {
-    if (isClone || !file.is_open()) {
+    if (isClone || !chunks) {
         return;
     }
     _length = 0;
-    bufferPosition = 0;
-    file.close();
+    for (int32_t i = 0; i < chunks.size(); ++i) {
+        if (chunks[i].is_open()) {
+            chunks[i].close();
+        }
+    }
+    chunks.reset();
+    setChunk(0, 0);
 }
 
 LuceneObjectPtr MMapIndexInput::clone(const LuceneObjectPtr& other) {
-    if (!file.is_open()) {
+    if (!chunks) {
         boost::throw_exception(AlreadyClosedException(L"MMapIndexInput already closed"));
     }
     LuceneObjectPtr clone = IndexInput::clone(other ? other : newLucene<MMapIndexInput>());
     MMapIndexInputPtr cloneIndexInput(boost::dynamic_pointer_cast<MMapIndexInput>(clone));
     cloneIndexInput->_length = _length;
-    cloneIndexInput->file = file;
-    cloneIndexInput->bufferPosition = bufferPosition;
+    cloneIndexInput->chunkSizePower = chunkSizePower;
+    cloneIndexInput->chunks = chunks;
+    cloneIndexInput->setChunk(curChunkIndex, chunkPosition);
     cloneIndexInput->isClone = true;
     return cloneIndexInput;
 }
@@ -0,0 +1,167 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include <boost/filesystem/path.hpp>
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "NIOFSDirectory.h"
+#include "_NIOFSDirectory.h"
+#include "SimpleFSDirectory.h"
+#include "_SimpleFSDirectory.h"
+#include "FileUtils.h"
+
+namespace Lucene {
+
+NIOFSDirectory::NIOFSDirectory(const String& path, const LockFactoryPtr& lockFactory) : FSDirectory(path, lockFactory) {
+}
+
+NIOFSDirectory::~NIOFSDirectory() {
+}
+
+IndexInputPtr NIOFSDirectory::openInput(const String& name, int32_t bufferSize) {
+    ensureOpen();
+    return newLucene<NIOFSIndexInput>(FileUtils::joinPath(directory, name), bufferSize, getReadChunkSize());
+}
+
+IndexOutputPtr NIOFSDirectory::createOutput(const String& name) {
+    initOutput(name);
+    return newLucene<SimpleFSIndexOutput>(FileUtils::joinPath(directory, name));
+}
+
+PositionalInputFile::PositionalInputFile(const String& path) {
+#if defined(_WIN32) || defined(_WIN64)
+    file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        boost::throw_exception(FileNotFoundException(path));
+    }
+#else
+    file = ::open(boost::filesystem::path(path).c_str(), O_RDONLY);
+    if (file < 0) {
+        boost::throw_exception(FileNotFoundException(path));
+    }
+#endif
+    length = FileUtils::fileLength(path);
+}
+
+PositionalInputFile::~PositionalInputFile() {
+    close();
+}
+
+int32_t PositionalInputFile::read(uint8_t* b, int32_t offset, int32_t length, int64_t position) {
+#if defined(_WIN32) || defined(_WIN64)
+    OVERLAPPED overlapped;
+    ZeroMemory(&overlapped, sizeof(overlapped));
+    overlapped.Offset = (DWORD)(position & 0xffffffff);
+    overlapped.OffsetHigh = (DWORD)(position >> 32);
+    DWORD readCount = 0;
+    if (!ReadFile(file, b + offset, (DWORD)length, &readCount, &overlapped)) {
+        return GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+    }
+    return (int32_t)readCount;
+#else
+    while (true) {
+        ssize_t readCount = ::pread(file, b + offset, (size_t)length, (off_t)position);
+        if (readCount >= 0) {
+            return (int32_t)readCount;
+        }
+        if (errno != EINTR) {
+            return -1;
+        }
+    }
+#endif
+}
+
+int64_t PositionalInputFile::getLength() {
+    return length;
+}
+
+void PositionalInputFile::close() {
+#if defined(_WIN32) || defined(_WIN64)
+    if (file != INVALID_HANDLE_VALUE) {
+        CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (file >= 0) {
+        ::close(file);
+        file = -1;
+    }
+#endif
+}
+
+NIOFSIndexInput::NIOFSIndexInput() {
+    this->chunkSize = 0;
+    this->isClone = false;
+}
+
+NIOFSIndexInput::NIOFSIndexInput(const String& path, int32_t bufferSize, int32_t chunkSize) : BufferedIndexInput(bufferSize) {
+    this->file = newLucene<PositionalInputFile>(path);
+    this->chunkSize = chunkSize;
+    this->isClone = false;
+}
+
+NIOFSIndexInput::~NIOFSIndexInput() {
+}
+
+PositionalInputFilePtr NIOFSIndexInput::ensureOpen() {
+    PositionalInputFilePtr file(this->file);
+    if (!file) {
+        boost::throw_exception(AlreadyClosedException(L"NIOFSIndexInput already closed"));
+    }
+    return file;
+}
+
+void NIOFSIndexInput::readInternal(uint8_t* b, int32_t offset, int32_t length) {
+    // no locking required, each read supplies its own file position
+    PositionalInputFilePtr file(ensureOpen());
+    int64_t position = getFilePointer();
+    if (position + length > file->getLength()) {
+        boost::throw_exception(IOException(L"Read past EOF"));
+    }
+
+    int32_t total = 0;
+
+    while (total < length) {
+        int32_t readLength = total + chunkSize > length ? length - total : chunkSize;
+
+        int32_t i = file->read(b, offset + total, readLength, position + total);
+        if (i == 0) {
+            boost::throw_exception(IOException(L"Read past EOF"));
+        } else if (i < 0) {
+            boost::throw_exception(IOException(L"Error reading file"));
+        }
+        total += i;
+    }
+}
+
+void NIOFSIndexInput::seekInternal(int64_t pos) {
+}
+
+int64_t NIOFSIndexInput::length() {
+    return ensureOpen()->getLength();
+}
+
+void NIOFSIndexInput::close() {
+    // release the handle rather than close it, as clones may still read from it
+    if (!isClone) {
+        file.reset();
+    }
+}
+
+LuceneObjectPtr NIOFSIndexInput::clone(const LuceneObjectPtr& other) {
+    LuceneObjectPtr clone = BufferedIndexInput::clone(other ? other : newLucene<NIOFSIndexInput>());
+    NIOFSIndexInputPtr cloneIndexInput(boost::dynamic_pointer_cast<NIOFSIndexInput>(clone));
+    cloneIndexInput->file = file;
+    cloneIndexInput->chunkSize = chunkSize;
+    cloneIndexInput->isClone = true;
+    return cloneIndexInput;
+}
+
+}
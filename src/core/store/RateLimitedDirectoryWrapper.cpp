@@ -0,0 +1,86 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "RateLimitedDirectoryWrapper.h"
+#include "RateLimitedIndexOutput.h"
+#include "RateLimiter.h"
+
+namespace Lucene {
+
+RateLimitedDirectoryWrapper::RateLimitedDirectoryWrapper(const DirectoryPtr& delegate, const RateLimiterPtr& rateLimiter) {
+    this->delegate = delegate;
+    this->rateLimiter = rateLimiter;
+    this->lockFactory = delegate->getLockFactory();
+}
+
+RateLimitedDirectoryWrapper::~RateLimitedDirectoryWrapper() {
+}
+
+DirectoryPtr RateLimitedDirectoryWrapper::getDelegate() {
+    return delegate;
+}
+
+RateLimiterPtr RateLimitedDirectoryWrapper::getRateLimiter() {
+    return rateLimiter;
+}
+
+HashSet<String> RateLimitedDirectoryWrapper::listAll() {
+    return delegate->listAll();
+}
+
+bool RateLimitedDirectoryWrapper::fileExists(const String& name) {
+    return delegate->fileExists(name);
+}
+
+uint64_t RateLimitedDirectoryWrapper::fileModified(const String& name) {
+    return delegate->fileModified(name);
+}
+
+void RateLimitedDirectoryWrapper::touchFile(const String& name) {
+    delegate->touchFile(name);
+}
+
+void RateLimitedDirectoryWrapper::deleteFile(const String& name) {
+    delegate->deleteFile(name);
+}
+
+int64_t RateLimitedDirectoryWrapper::fileLength(const String& name) {
+    return delegate->fileLength(name);
+}
+
+IndexOutputPtr RateLimitedDirectoryWrapper::createOutput(const String& name) {
+    return newLucene<RateLimitedIndexOutput>(delegate->createOutput(name), rateLimiter);
+}
+
+IndexInputPtr RateLimitedDirectoryWrapper::openInput(const String& name) {
+    return delegate->openInput(name);
+}
+
+IndexInputPtr RateLimitedDirectoryWrapper::openInput(const String& name, int32_t bufferSize) {
+    return delegate->openInput(name, bufferSize);
+}
+
+void RateLimitedDirectoryWrapper::sync(const String& name) {
+    delegate->sync(name);
+}
+
+LockPtr RateLimitedDirectoryWrapper::makeLock(const String& name) {
+    return delegate->makeLock(name);
+}
+
+String RateLimitedDirectoryWrapper::getLockID() {
+    return delegate->getLockID();
+}
+
+void RateLimitedDirectoryWrapper::close() {
+}
+
+String RateLimitedDirectoryWrapper::toString() {
+    return L"RateLimitedDirectoryWrapper(" + delegate->toString() + L")";
+}
+
+}
@@ -0,0 +1,68 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "RateLimitedIndexOutput.h"
+#include "RateLimiter.h"
+
+namespace Lucene {
+
+RateLimitedIndexOutput::RateLimitedIndexOutput(const IndexOutputPtr& delegate, const RateLimiterPtr& rateLimiter) {
+    this->delegate = delegate;
+    this->rateLimiter = rateLimiter;
+    bytesSinceLastPause = 0;
+    currentMinPauseCheckBytes = rateLimiter->getMinPauseCheckBytes();
+}
+
+RateLimitedIndexOutput::~RateLimitedIndexOutput() {
+}
+
+void RateLimitedIndexOutput::writeByte(uint8_t b) {
+    ++bytesSinceLastPause;
+    checkRate();
+    delegate->writeByte(b);
+}
+
+void RateLimitedIndexOutput::writeBytes(const uint8_t* b, int32_t offset, int32_t length) {
+    bytesSinceLastPause += length;
+    checkRate();
+    delegate->writeBytes(b, offset, length);
+}
+
+void RateLimitedIndexOutput::flush() {
+    delegate->flush();
+}
+
+void RateLimitedIndexOutput::close() {
+    if (bytesSinceLastPause > 0) {
+        rateLimiter->pause(bytesSinceLastPause);
+        bytesSinceLastPause = 0;
+    }
+    delegate->close();
+}
+
+int64_t RateLimitedIndexOutput::getFilePointer() {
+    return delegate->getFilePointer();
+}
+
+void RateLimitedIndexOutput::seek(int64_t pos) {
+    delegate->seek(pos);
+}
+
+int64_t RateLimitedIndexOutput::length() {
+    return delegate->length();
+}
+
+void RateLimitedIndexOutput::checkRate() {
+    if (bytesSinceLastPause > currentMinPauseCheckBytes) {
+        rateLimiter->pause(bytesSinceLastPause);
+        bytesSinceLastPause = 0;
+        // the rate may have changed since
+        currentMinPauseCheckBytes = rateLimiter->getMinPauseCheckBytes();
+    }
+}
+
+}
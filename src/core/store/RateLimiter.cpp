@@ -0,0 +1,108 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "RateLimiter.h"
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <chrono>
+
+namespace Lucene {
+
+const int32_t RateLimiter::MIN_PAUSE_CHECK_MSEC = 5;
+
+/// Monotonic, so that a change of the system clock can't stall writers or lift the limit.
+static int64_t currentTimeMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+RateLimiter::RateLimiter(double mbPerSec, const RateLimiterPtr& parent) {
+    this->parent = parent;
+    lastMicros = 0;
+    totalBytes = 0;
+    bytesThrottled = 0;
+    pausedMicros = 0;
+    setMBPerSec(mbPerSec);
+}
+
+RateLimiter::~RateLimiter() {
+}
+
+void RateLimiter::setMBPerSec(double mbPerSec) {
+    SyncLock syncLock(this);
+    this->mbPerSec = std::max(mbPerSec, 0.0);
+    minPauseCheckBytes = (int64_t)((double)MIN_PAUSE_CHECK_MSEC / 1000.0 * this->mbPerSec * 1024.0 * 1024.0);
+}
+
+double RateLimiter::getMBPerSec() {
+    SyncLock syncLock(this);
+    return mbPerSec;
+}
+
+RateLimiterPtr RateLimiter::getParent() {
+    return parent;
+}
+
+int64_t RateLimiter::getMinPauseCheckBytes() {
+    SyncLock syncLock(this);
+    int64_t checkBytes = mbPerSec > 0.0 ? minPauseCheckBytes : INT64_MAX;
+    if (parent) {
+        checkBytes = std::min(checkBytes, parent->getMinPauseCheckBytes());
+    }
+    return std::max(checkBytes, (int64_t)1024);
+}
+
+int64_t RateLimiter::pause(int64_t bytes) {
+    int64_t paused = doPause(bytes);
+    if (parent) {
+        paused += parent->pause(bytes);
+    }
+    totalBytes += bytes;
+    if (paused > 0) {
+        bytesThrottled += bytes;
+        pausedMicros += paused;
+    }
+    return paused;
+}
+
+int64_t RateLimiter::doPause(int64_t bytes) {
+    int64_t startMicros = currentTimeMicros();
+    int64_t targetMicros;
+    {
+        SyncLock syncLock(this);
+        if (mbPerSec <= 0.0) {
+            return 0;
+        }
+        targetMicros = lastMicros + (int64_t)((double)bytes / (mbPerSec * 1024.0 * 1024.0) * 1000000.0);
+        if (startMicros >= targetMicros) {
+            // we're behind the rate, don't let the time we didn't write in be used for a burst
+            lastMicros = startMicros;
+            return 0;
+        }
+        lastMicros = targetMicros;
+    }
+    // sleep without holding the lock, so that other writers can reserve their share meanwhile
+    int64_t curMicros = startMicros;
+    while (curMicros < targetMicros) {
+        boost::this_thread::sleep(boost::posix_time::microseconds(targetMicros - curMicros));
+        curMicros = currentTimeMicros();
+    }
+    return curMicros - startMicros;
+}
+
+int64_t RateLimiter::getTotalBytes() {
+    return totalBytes;
+}
+
+int64_t RateLimiter::getBytesThrottled() {
+    return bytesThrottled;
+}
+
+int64_t RateLimiter::getPausedMillis() {
+    return pausedMicros / 1000;
+}
+
+}
@@ -0,0 +1,430 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "Automaton.h"
+#include "StringUtils.h"
+#include <map>
+
+namespace Lucene {
+
+const int32_t Automaton::MIN_LABEL = 0;
+const int32_t Automaton::MAX_LABEL = 0x10ffff;
+const int32_t Automaton::DEFAULT_MAX_DETERMINIZED_STATES = 10000;
+
+Automaton::Automaton() {
+    accept = Collection<uint8_t>::newInstance();
+    transitions = Collection< Collection<AutomatonTransition> >::newInstance();
+    epsilons = Collection< Collection<int32_t> >::newInstance();
+    deterministic = false;
+}
+
+Automaton::~Automaton() {
+}
+
+int32_t Automaton::createState() {
+    accept.add(0);
+    transitions.add(Collection<AutomatonTransition>::newInstance());
+    epsilons.add(Collection<int32_t>());
+    return accept.size() - 1;
+}
+
+int32_t Automaton::getNumStates() {
+    return accept.size();
+}
+
+void Automaton::setAccept(int32_t state, bool accept) {
+    this->accept[state] = accept ? 1 : 0;
+}
+
+bool Automaton::isAccept(int32_t state) {
+    return (accept[state] != 0);
+}
+
+void Automaton::addTransition(int32_t source, int32_t dest, int32_t min, int32_t max) {
+    BOOST_ASSERT(min <= max);
+    AutomatonTransition transition = {min, max, dest};
+    transitions[source].add(transition);
+}
+
+void Automaton::addTransition(int32_t source, int32_t dest, int32_t label) {
+    addTransition(source, dest, label, label);
+}
+
+void Automaton::addEpsilon(int32_t source, int32_t dest) {
+    if (!epsilons[source]) {
+        epsilons[source] = Collection<int32_t>::newInstance();
+    }
+    epsilons[source].add(dest);
+}
+
+int32_t Automaton::getNumTransitions(int32_t state) {
+    return transitions[state].size();
+}
+
+const AutomatonTransition& Automaton::getTransition(int32_t state, int32_t index) {
+    return transitions[state][index];
+}
+
+bool Automaton::isDeterministic() {
+    return deterministic;
+}
+
+void Automaton::closure(Collection<int32_t> states) {
+    Collection<int32_t> pending(Collection<int32_t>::newInstance(states.begin(), states.end()));
+    while (!pending.empty()) {
+        int32_t state = pending.removeLast();
+        if (!epsilons[state]) {
+            continue;
+        }
+        for (Collection<int32_t>::iterator dest = epsilons[state].begin(); dest != epsilons[state].end(); ++dest) {
+            Collection<int32_t>::iterator pos = std::lower_bound(states.begin(), states.end(), *dest);
+            if (pos == states.end() || *pos != *dest) {
+                states.insert(pos, *dest);
+                pending.add(*dest);
+            }
+        }
+    }
+}
+
+AutomatonPtr Automaton::determinize(int32_t maxDeterminizedStates) {
+    AutomatonPtr dfa(newLucene<Automaton>());
+
+    // each state of the deterministic automaton is the set of states it can be in
+    Collection< Collection<int32_t> > sets(Collection< Collection<int32_t> >::newInstance());
+    std::map<std::vector<int32_t>, int32_t> stateOfSet;
+
+    Collection<int32_t> initial(Collection<int32_t>::newInstance());
+    initial.add(0);
+    closure(initial);
+    sets.add(initial);
+    stateOfSet[std::vector<int32_t>(initial.begin(), initial.end())] = dfa->createState();
+
+    Collection<int32_t> points(Collection<int32_t>::newInstance());
+    for (int32_t dfaState = 0; dfaState < sets.size(); ++dfaState) {
+        Collection<int32_t> set(sets[dfaState]);
+
+        // the labels at which the transitions out of the set start or end split the labels into
+        // intervals that all lead to the same set
+        points.clear();
+        for (Collection<int32_t>::iterator state = set.begin(); state != set.end(); ++state) {
+            if (isAccept(*state)) {
+                dfa->setAccept(dfaState, true);
+            }
+            for (Collection<AutomatonTransition>::iterator transition = transitions[*state].begin(); transition != transitions[*state].end(); ++transition) {
+                points.add(transition->min);
+                points.add(transition->max + 1);
+            }
+        }
+        std::sort(points.begin(), points.end());
+        points.remove(std::unique(points.begin(), points.end()), points.end());
+
+        for (int32_t point = 0; point + 1 < points.size(); ++point) {
+            int32_t min = points[point];
+            Collection<int32_t> dests(Collection<int32_t>::newInstance());
+            for (Collection<int32_t>::iterator state = set.begin(); state != set.end(); ++state) {
+                for (Collection<AutomatonTransition>::iterator transition = transitions[*state].begin(); transition != transitions[*state].end(); ++transition) {
+                    if (transition->min <= min && min <= transition->max) {
+                        dests.add(transition->dest);
+                    }
+                }
+            }
+            if (dests.empty()) {
+                continue;
+            }
+            std::sort(dests.begin(), dests.end());
+            dests.remove(std::unique(dests.begin(), dests.end()), dests.end());
+            closure(dests);
+
+            std::vector<int32_t> key(dests.begin(), dests.end());
+            std::map<std::vector<int32_t>, int32_t>::iterator dest = stateOfSet.find(key);
+            int32_t destState;
+            if (dest == stateOfSet.end()) {
+                if (sets.size() >= maxDeterminizedStates) {
+                    boost::throw_exception(IllegalArgumentException(L"determinizing the automaton would result in more than " + StringUtils::toString(maxDeterminizedStates) + L" states"));
+                }
+                destState = dfa->createState();
+                stateOfSet[key] = destState;
+                sets.add(dests);
+            } else {
+                destState = dest->second;
+            }
+
+            // merge with the previous interval when it leads to the same state
+            Collection<AutomatonTransition> dfaTransitions(dfa->transitions[dfaState]);
+            if (!dfaTransitions.empty() && dfaTransitions[dfaTransitions.size() - 1].dest == destState && dfaTransitions[dfaTransitions.size() - 1].max == min - 1) {
+                dfaTransitions[dfaTransitions.size() - 1].max = points[point + 1] - 1;
+            } else {
+                dfa->addTransition(dfaState, destState, min, points[point + 1] - 1);
+            }
+        }
+    }
+
+    dfa->deterministic = true;
+    return dfa->removeDeadStates();
+}
+
+AutomatonPtr Automaton::minimize(int32_t maxDeterminizedStates) {
+    AutomatonPtr dfa(deterministic ? boost::static_pointer_cast<Automaton>(shared_from_this()) : determinize(maxDeterminizedStates));
+    int32_t numStates = dfa->getNumStates();
+
+    // refine the partition of the states, starting from accepting or not, until the states of each
+    // class go to the same classes on the same labels
+    Collection<int32_t> classes(Collection<int32_t>::newInstance(numStates));
+    for (int32_t state = 0; state < numStates; ++state) {
+        classes[state] = dfa->isAccept(state) ? 1 : 0;
+    }
+    int32_t numClasses = -1;
+    std::map<std::vector<int32_t>, int32_t> classOfSignature;
+    std::vector<int32_t> signature;
+    while (true) {
+        // classes are numbered in order of their first state, so the initial state stays in class 0
+        Collection<int32_t> newClasses(Collection<int32_t>::newInstance(numStates));
+        classOfSignature.clear();
+        for (int32_t state = 0; state < numStates; ++state) {
+            signature.clear();
+            signature.push_back(classes[state]);
+            for (Collection<AutomatonTransition>::iterator transition = dfa->transitions[state].begin(); transition != dfa->transitions[state].end(); ++transition) {
+                int32_t destClass = classes[transition->dest];
+                int32_t size = (int32_t)signature.size();
+                if (size > 1 && signature[size - 1] == destClass && signature[size - 2] == transition->min - 1) {
+                    signature[size - 2] = transition->max;
+                } else {
+                    signature.push_back(transition->min);
+                    signature.push_back(transition->max);
+                    signature.push_back(destClass);
+                }
+            }
+            std::map<std::vector<int32_t>, int32_t>::iterator existing = classOfSignature.find(signature);
+            if (existing == classOfSignature.end()) {
+                int32_t newClass = (int32_t)classOfSignature.size();
+                classOfSignature[signature] = newClass;
+                newClasses[state] = newClass;
+            } else {
+                newClasses[state] = existing->second;
+            }
+        }
+        classes = newClasses;
+        if ((int32_t)classOfSignature.size() == numClasses) {
+            break;
+        }
+        numClasses = (int32_t)classOfSignature.size();
+    }
+
+    // build the automaton from the first state of each class
+    AutomatonPtr automaton(newLucene<Automaton>());
+    Collection<uint8_t> built(Collection<uint8_t>::newInstance(numClasses));
+    for (int32_t i = 0; i < numClasses; ++i) {
+        automaton->createState();
+    }
+    for (int32_t state = 0; state < numStates; ++state) {
+        int32_t source = classes[state];
+        if (built[source] != 0) {
+            continue;
+        }
+        built[source] = 1;
+        automaton->setAccept(source, dfa->isAccept(state));
+        Collection<AutomatonTransition> sourceTransitions(automaton->transitions[source]);
+        for (Collection<AutomatonTransition>::iterator transition = dfa->transitions[state].begin(); transition != dfa->transitions[state].end(); ++transition) {
+            int32_t dest = classes[transition->dest];
+            if (!sourceTransitions.empty() && sourceTransitions[sourceTransitions.size() - 1].dest == dest && sourceTransitions[sourceTransitions.size() - 1].max == transition->min - 1) {
+                sourceTransitions[sourceTransitions.size() - 1].max = transition->max;
+            } else {
+                automaton->addTransition(source, dest, transition->min, transition->max);
+            }
+        }
+    }
+    automaton->deterministic = true;
+    return automaton;
+}
+
+AutomatonPtr Automaton::removeDeadStates() {
+    int32_t numStates = getNumStates();
+
+    // states reachable from the initial state
+    Collection<uint8_t> reachable(Collection<uint8_t>::newInstance(numStates));
+    Collection<int32_t> pending(Collection<int32_t>::newInstance());
+    reachable[0] = 1;
+    pending.add(0);
+    while (!pending.empty()) {
+        int32_t state = pending.removeLast();
+        for (Collection<AutomatonTransition>::iterator transition = transitions[state].begin(); transition != transitions[state].end(); ++transition) {
+            if (reachable[transition->dest] == 0) {
+                reachable[transition->dest] = 1;
+                pending.add(transition->dest);
+            }
+        }
+        if (epsilons[state]) {
+            for (Collection<int32_t>::iterator dest = epsilons[state].begin(); dest != epsilons[state].end(); ++dest) {
+                if (reachable[*dest] == 0) {
+                    reachable[*dest] = 1;
+                    pending.add(*dest);
+                }
+            }
+        }
+    }
+
+    // states that can reach an accepting state, following the transitions backwards
+    Collection< Collection<int32_t> > sources(Collection< Collection<int32_t> >::newInstance(numStates));
+    for (int32_t state = 0; state < numStates; ++state) {
+        for (Collection<AutomatonTransition>::iterator transition = transitions[state].begin(); transition != transitions[state].end(); ++transition) {
+            if (!sources[transition->dest]) {
+                sources[transition->dest] = Collection<int32_t>::newInstance();
+            }
+            sources[transition->dest].add(state);
+        }
+        if (epsilons[state]) {
+            for (Collection<int32_t>::iterator dest = epsilons[state].begin(); dest != epsilons[state].end(); ++dest) {
+                if (!sources[*dest]) {
+                    sources[*dest] = Collection<int32_t>::newInstance();
+                }
+                sources[*dest].add(state);
+            }
+        }
+    }
+    Collection<uint8_t> live(Collection<uint8_t>::newInstance(numStates));
+    for (int32_t state = 0; state < numStates; ++state) {
+        if (isAccept(state)) {
+            live[state] = 1;
+            pending.add(state);
+        }
+    }
+    while (!pending.empty()) {
+        int32_t state = pending.removeLast();
+        if (!sources[state]) {
+            continue;
+        }
+        for (Collection<int32_t>::iterator source = sources[state].begin(); source != sources[state].end(); ++source) {
+            if (live[*source] == 0) {
+                live[*source] = 1;
+                pending.add(*source);
+            }
+        }
+    }
+
+    // renumber the useful states in order, keeping the initial state even if it's dead
+    Collection<int32_t> newState(Collection<int32_t>::newInstance(numStates));
+    AutomatonPtr automaton(newLucene<Automaton>());
+    for (int32_t state = 0; state < numStates; ++state) {
+        if (state == 0 || (reachable[state] != 0 && live[state] != 0)) {
+            newState[state] = automaton->createState();
+            automaton->setAccept(newState[state], isAccept(state));
+        } else {
+            newState[state] = -1;
+        }
+    }
+    for (int32_t state = 0; state < numStates; ++state) {
+        if (newState[state] == -1) {
+            continue;
+        }
+        for (Collection<AutomatonTransition>::iterator transition = transitions[state].begin(); transition != transitions[state].end(); ++transition) {
+            if (newState[transition->dest] != -1 && live[transition->dest] != 0) {
+                automaton->addTransition(newState[state], newState[transition->dest], transition->min, transition->max);
+            }
+        }
+        if (epsilons[state]) {
+            for (Collection<int32_t>::iterator dest = epsilons[state].begin(); dest != epsilons[state].end(); ++dest) {
+                if (newState[*dest] != -1 && live[*dest] != 0) {
+                    automaton->addEpsilon(newState[state], newState[*dest]);
+                }
+            }
+        }
+    }
+    automaton->deterministic = deterministic;
+    return automaton;
+}
+
+int32_t Automaton::step(int32_t state, int32_t label) {
+    BOOST_ASSERT(deterministic);
+    Collection<AutomatonTransition> stateTransitions(transitions[state]);
+    int32_t low = 0;
+    int32_t high = stateTransitions.size() - 1;
+    while (low <= high) {
+        int32_t mid = (low + high) >> 1;
+        const AutomatonTransition& transition = stateTransitions[mid];
+        if (label < transition.min) {
+            high = mid - 1;
+        } else if (label > transition.max) {
+            low = mid + 1;
+        } else {
+            return transition.dest;
+        }
+    }
+    return -1;
+}
+
+bool Automaton::run(const String& text) {
+    int32_t state = 0;
+    for (String::const_iterator c = text.begin(); c != text.end(); ++c) {
+        state = step(state, (int32_t)*c);
+        if (state == -1) {
+            return false;
+        }
+    }
+    return isAccept(state);
+}
+
+bool Automaton::isEmpty() {
+    BOOST_ASSERT(deterministic);
+    return (!isAccept(0) && transitions[0].empty());
+}
+
+bool Automaton::isFinite() {
+    BOOST_ASSERT(deterministic);
+    // depth first search for a transition back to a state on the current path
+    int32_t numStates = getNumStates();
+    Collection<uint8_t> onPath(Collection<uint8_t>::newInstance(numStates));
+    Collection<uint8_t> visited(Collection<uint8_t>::newInstance(numStates));
+    Collection<int32_t> path(Collection<int32_t>::newInstance());
+    Collection<int32_t> nextTransition(Collection<int32_t>::newInstance());
+    path.add(0);
+    nextTransition.add(0);
+    onPath[0] = 1;
+    visited[0] = 1;
+    while (!path.empty()) {
+        int32_t state = path[path.size() - 1];
+        int32_t& next = nextTransition[nextTransition.size() - 1];
+        if (next == transitions[state].size()) {
+            onPath[state] = 0;
+            path.removeLast();
+            nextTransition.removeLast();
+            continue;
+        }
+        int32_t dest = transitions[state][next++].dest;
+        if (onPath[dest] != 0) {
+            return false;
+        }
+        if (visited[dest] == 0) {
+            visited[dest] = 1;
+            onPath[dest] = 1;
+            path.add(dest);
+            nextTransition.add(0);
+        }
+    }
+    return true;
+}
+
+String Automaton::toString() {
+    StringStream buffer;
+    for (int32_t state = 0; state < getNumStates(); ++state) {
+        buffer << L"state " << state << (isAccept(state) ? L" [accept]" : L" [reject]") << L":\n";
+        for (Collection<AutomatonTransition>::iterator transition = transitions[state].begin(); transition != transitions[state].end(); ++transition) {
+            buffer << L"  " << transition->min;
+            if (transition->max != transition->min) {
+                buffer << L"-" << transition->max;
+            }
+            buffer << L" -> " << transition->dest << L"\n";
+        }
+        if (epsilons[state]) {
+            for (Collection<int32_t>::iterator dest = epsilons[state].begin(); dest != epsilons[state].end(); ++dest) {
+                buffer << L"  epsilon -> " << *dest << L"\n";
+            }
+        }
+    }
+    return buffer.str();
+}
+
+}
@@ -0,0 +1,95 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "LevenshteinAutomata.h"
+#include "Automaton.h"
+
+namespace Lucene {
+
+const int32_t LevenshteinAutomata::MAXIMUM_SUPPORTED_DISTANCE = 2;
+
+LevenshteinAutomata::LevenshteinAutomata(const String& input, bool transpositions) {
+    this->input = input;
+    this->transpositions = transpositions;
+}
+
+LevenshteinAutomata::~LevenshteinAutomata() {
+}
+
+AutomatonPtr LevenshteinAutomata::toAutomaton(int32_t n) {
+    return toAutomaton(n, L"");
+}
+
+AutomatonPtr LevenshteinAutomata::toAutomaton(int32_t n, const String& prefix) {
+    if (n < 0) {
+        boost::throw_exception(IllegalArgumentException(L"n < 0"));
+    }
+    if (n > MAXIMUM_SUPPORTED_DISTANCE) {
+        return AutomatonPtr();
+    }
+
+    AutomatonPtr nfa(newLucene<Automaton>());
+
+    // the prefix must match exactly
+    int32_t state = nfa->createState();
+    for (String::const_iterator c = prefix.begin(); c != prefix.end(); ++c) {
+        int32_t next = nfa->createState();
+        nfa->addTransition(state, next, (int32_t)*c);
+        state = next;
+    }
+
+    // then the state (i, e) means i characters of the input were consumed with e edits, state (i, e)
+    // being first + i * (n + 1) + e
+    int32_t length = (int32_t)input.length();
+    int32_t first = state;
+    for (int32_t i = 0; i <= length; ++i) {
+        for (int32_t e = 0; e <= n; ++e) {
+            if (i != 0 || e != 0) {
+                nfa->createState();
+            }
+        }
+    }
+    // and the state reached halfway through transposing characters i and i + 1 with e edits is
+    // transposed + i * (n + 1) + e
+    int32_t transposed = nfa->getNumStates();
+    if (transpositions) {
+        for (int32_t i = 0; i + 1 < length; ++i) {
+            for (int32_t e = 0; e <= n; ++e) {
+                nfa->createState();
+            }
+        }
+    }
+
+    for (int32_t i = 0; i <= length; ++i) {
+        for (int32_t e = 0; e <= n; ++e) {
+            int32_t source = first + i * (n + 1) + e;
+            if (i == length) {
+                nfa->setAccept(source, true);
+            } else {
+                nfa->addTransition(source, source + (n + 1), (int32_t)input[i]); // match
+            }
+            if (e == n) {
+                continue;
+            }
+            nfa->addTransition(source, source + 1, Automaton::MIN_LABEL, Automaton::MAX_LABEL); // insertion
+            if (i < length) {
+                nfa->addTransition(source, source + (n + 1) + 1, Automaton::MIN_LABEL, Automaton::MAX_LABEL); // substitution
+                nfa->addEpsilon(source, source + (n + 1) + 1); // deletion
+            }
+            if (transpositions && i + 1 < length && input[i] != input[i + 1]) {
+                int32_t middle = transposed + i * (n + 1) + e + 1;
+                nfa->addTransition(source, middle, (int32_t)input[i + 1]);
+                nfa->addTransition(middle, source + 2 * (n + 1) + 1, (int32_t)input[i]);
+            }
+        }
+    }
+
+    // linear in the length of the input for the supported distances, so no need for a limit
+    return nfa->minimize(INT_MAX);
+}
+
+}
@@ -6,10 +6,26 @@
 
 #include "LuceneInc.h"
 #include "LuceneAllocator.h"
+#include <atomic>
 
 namespace Lucene {
 
-void* AllocMemory(size_t size) {
+/// Every block starts with a header holding its size, 16 bytes so that the memory returned stays aligned.
+static const size_t HEADER_SIZE = 16;
+
+/// Blocks up to MAX_POOLED_SIZE are rounded up to a multiple of SIZE_CLASS_GRANULARITY and can be cached.
+static const size_t SIZE_CLASS_GRANULARITY = 16;
+static const size_t MAX_POOLED_SIZE = 512;
+static const int32_t NUM_SIZE_CLASSES = (int32_t)(MAX_POOLED_SIZE / SIZE_CLASS_GRANULARITY);
+
+/// Most bytes a thread caches for each size class.
+static const size_t MAX_CACHED_BYTES = 64 * 1024;
+
+struct BlockHeader {
+    size_t size;
+};
+
+static void* defaultAlloc(size_t size) {
 #if (defined(_WIN32) || defined(_WIN64)) && !defined(NDEBUG)
     return _malloc_dbg(size, _NORMAL_BLOCK, __FILE__, __LINE__);
 #else
@@ -17,6 +33,111 @@ void* AllocMemory(size_t size) {
 #endif
 }
 
+static void* defaultRealloc(void* memory, size_t size) {
+#if defined(_WIN32) && !defined(NDEBUG)
+    return _realloc_dbg(memory, size, _NORMAL_BLOCK, __FILE__, __LINE__);
+#else
+    return realloc(memory, size);
+#endif
+}
+
+static void defaultFree(void* memory) {
+#if defined(_WIN32) && !defined(NDEBUG)
+    _free_dbg(memory, _NORMAL_BLOCK);
+#else
+    free(memory);
+#endif
+}
+
+static MemoryHooks memoryHooks = {defaultAlloc, defaultRealloc, defaultFree};
+static std::atomic<bool> memoryPooling(true);
+
+static std::atomic<bool> memoryStats(false);
+static std::atomic<int64_t> statAllocations(0);
+static std::atomic<int64_t> statFrees(0);
+static std::atomic<int64_t> statPooledAllocations(0);
+static std::atomic<int64_t> statBytesAllocated(0);
+static std::atomic<int64_t> statBytesInUse(0);
+
+/// Returns the size class of a block, or -1 if it is too large to be cached.
+static inline int32_t sizeClass(size_t size) {
+    if (size > MAX_POOLED_SIZE) {
+        return -1;
+    }
+    return size == 0 ? 0 : (int32_t)((size - 1) / SIZE_CLASS_GRANULARITY);
+}
+
+static inline size_t classCapacity(int32_t sizeClass) {
+    return (size_t)(sizeClass + 1) * SIZE_CLASS_GRANULARITY;
+}
+
+/// Free lists of cached blocks, linked through the first word of each block.
+class ThreadCache {
+public:
+    ThreadCache();
+    ~ThreadCache();
+
+    void* blocks[NUM_SIZE_CLASSES];
+    int32_t counts[NUM_SIZE_CLASSES];
+};
+
+static thread_local bool threadCacheDestroyed = false;
+static thread_local ThreadCache threadCache;
+
+ThreadCache::ThreadCache() {
+    std::fill(blocks, blocks + NUM_SIZE_CLASSES, (void*)NULL);
+    std::fill(counts, counts + NUM_SIZE_CLASSES, 0);
+}
+
+ThreadCache::~ThreadCache() {
+    threadCacheDestroyed = true; // blocks freed from now on by this thread go straight back
+    for (int32_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        while (blocks[i] != NULL) {
+            void* next = *(void**)blocks[i];
+            memoryHooks.free(blocks[i]);
+            blocks[i] = next;
+        }
+        counts[i] = 0;
+    }
+}
+
+static inline ThreadCache* getThreadCache() {
+    return threadCacheDestroyed ? NULL : &threadCache;
+}
+
+void* AllocMemory(size_t size) {
+    int32_t blockClass = sizeClass(size);
+    void* block = NULL;
+    bool pooled = false;
+    if (blockClass >= 0) {
+        ThreadCache* cache = memoryPooling.load(std::memory_order_relaxed) ? getThreadCache() : NULL;
+        if (cache != NULL && cache->blocks[blockClass] != NULL) {
+            block = cache->blocks[blockClass];
+            cache->blocks[blockClass] = *(void**)block;
+            --cache->counts[blockClass];
+            pooled = true;
+        } else {
+            // allocate the whole class so that the block can be reused for any size of the class
+            block = memoryHooks.alloc(HEADER_SIZE + classCapacity(blockClass));
+        }
+    } else {
+        block = memoryHooks.alloc(HEADER_SIZE + size);
+    }
+    if (block == NULL) {
+        return NULL;
+    }
+    static_cast<BlockHeader*>(block)->size = size;
+    if (memoryStats.load(std::memory_order_relaxed)) {
+        statAllocations.fetch_add(1, std::memory_order_relaxed);
+        if (pooled) {
+            statPooledAllocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        statBytesAllocated.fetch_add((int64_t)size, std::memory_order_relaxed);
+        statBytesInUse.fetch_add((int64_t)size, std::memory_order_relaxed);
+    }
+    return static_cast<uint8_t*>(block) + HEADER_SIZE;
+}
+
 void* ReallocMemory(void* memory, size_t size) {
     if (memory == NULL) {
         return AllocMemory(size);
@@ -25,22 +146,84 @@ void* ReallocMemory(void* memory, size_t size) {
         FreeMemory(memory);
         return NULL;
     }
-#if defined(_WIN32) && !defined(NDEBUG)
-    return _realloc_dbg(memory, size, _NORMAL_BLOCK, __FILE__, __LINE__);
-#else
-    return realloc(memory, size);
-#endif
+    void* block = static_cast<uint8_t*>(memory) - HEADER_SIZE;
+    size_t oldSize = static_cast<BlockHeader*>(block)->size;
+    int32_t oldClass = sizeClass(oldSize);
+    if (oldClass >= 0 ? size <= classCapacity(oldClass) : sizeClass(size) < 0) {
+        if (oldClass < 0) {
+            block = memoryHooks.realloc(block, HEADER_SIZE + size);
+            if (block == NULL) {
+                return NULL;
+            }
+        }
+        static_cast<BlockHeader*>(block)->size = size;
+        if (memoryStats.load(std::memory_order_relaxed)) {
+            statBytesInUse.fetch_add((int64_t)size - (int64_t)oldSize, std::memory_order_relaxed);
+        }
+        return static_cast<uint8_t*>(block) + HEADER_SIZE;
+    }
+    // moving between the cached sizes and the others
+    void* newMemory = AllocMemory(size);
+    if (newMemory != NULL) {
+        std::copy(static_cast<uint8_t*>(memory), static_cast<uint8_t*>(memory) + std::min(size, oldSize), static_cast<uint8_t*>(newMemory));
+        FreeMemory(memory);
+    }
+    return newMemory;
 }
 
 void FreeMemory(void* memory) {
     if (memory == NULL) {
         return;
     }
-#if defined(_WIN32) && !defined(NDEBUG)
-    _free_dbg(memory, _NORMAL_BLOCK);
-#else
-    free(memory);
-#endif
+    void* block = static_cast<uint8_t*>(memory) - HEADER_SIZE;
+    size_t size = static_cast<BlockHeader*>(block)->size;
+    if (memoryStats.load(std::memory_order_relaxed)) {
+        statFrees.fetch_add(1, std::memory_order_relaxed);
+        statBytesInUse.fetch_sub((int64_t)size, std::memory_order_relaxed);
+    }
+    int32_t blockClass = sizeClass(size);
+    if (blockClass >= 0 && memoryPooling.load(std::memory_order_relaxed)) {
+        ThreadCache* cache = getThreadCache();
+        if (cache != NULL && (size_t)cache->counts[blockClass] * classCapacity(blockClass) < MAX_CACHED_BYTES) {
+            *(void**)block = cache->blocks[blockClass];
+            cache->blocks[blockClass] = block;
+            ++cache->counts[blockClass];
+            return;
+        }
+    }
+    memoryHooks.free(block);
+}
+
+void SetMemoryHooks(const MemoryHooks& hooks) {
+    memoryHooks = hooks;
+}
+
+void SetMemoryPooling(bool pooling) {
+    memoryPooling.store(pooling);
+}
+
+bool GetMemoryPooling() {
+    return memoryPooling.load();
+}
+
+void SetMemoryStats(bool enabled) {
+    memoryStats.store(false);
+    statAllocations.store(0);
+    statFrees.store(0);
+    statPooledAllocations.store(0);
+    statBytesAllocated.store(0);
+    statBytesInUse.store(0);
+    memoryStats.store(enabled);
+}
+
+MemoryStats GetMemoryStats() {
+    MemoryStats stats;
+    stats.allocations = statAllocations.load();
+    stats.frees = statFrees.load();
+    stats.pooledAllocations = statPooledAllocations.load();
+    stats.bytesAllocated = statBytesAllocated.load();
+    stats.bytesInUse = statBytesInUse.load();
+    return stats;
 }
 
 }
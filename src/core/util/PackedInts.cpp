@@ -0,0 +1,86 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "PackedInts.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
+#include "MiscUtils.h"
+#include "StringUtils.h"
+
+namespace Lucene {
+
+PackedInts::PackedInts(int32_t size, int32_t bitsPerValue) {
+    if (size < 0 || bitsPerValue < 0 || bitsPerValue > 64) {
+        boost::throw_exception(IllegalArgumentException(L"invalid packed array of " + StringUtils::toString(size) +
+                               L" values with " + StringUtils::toString(bitsPerValue) + L" bits per value"));
+    }
+    this->_size = size;
+    this->bitsPerValue = bitsPerValue;
+    this->mask = bitsPerValue == 64 ? -1 : (((int64_t)1 << bitsPerValue) - 1);
+    this->words = LongArray::newInstance(numWords(size, bitsPerValue));
+    MiscUtils::arrayFill(words.get(), 0, words.size(), 0);
+}
+
+PackedInts::~PackedInts() {
+}
+
+int32_t PackedInts::bitsRequired(int64_t maxValue) {
+    int32_t bits = 0;
+    for (uint64_t value = (uint64_t)maxValue; value != 0; value >>= 1) {
+        ++bits;
+    }
+    return bits;
+}
+
+int32_t PackedInts::numWords(int32_t size, int32_t bitsPerValue) {
+    // always at least one word, so that an empty array is still valid
+    return std::max((int32_t)(((int64_t)size * bitsPerValue + 63) >> 6), 1);
+}
+
+void PackedInts::set(int32_t index, int64_t value) {
+    if (bitsPerValue == 0) {
+        return;
+    }
+    uint64_t bits = (uint64_t)(value & mask);
+    int64_t bitPos = (int64_t)index * bitsPerValue;
+    int32_t word = (int32_t)(bitPos >> 6);
+    int32_t shift = (int32_t)(bitPos & 63);
+    words[word] = (int64_t)(((uint64_t)words[word] & ~((uint64_t)mask << shift)) | (bits << shift));
+    if (shift + bitsPerValue > 64) {
+        int32_t spill = 64 - shift; // bits already stored in the first word
+        words[word + 1] = (int64_t)(((uint64_t)words[word + 1] & ~((uint64_t)mask >> spill)) | (bits >> spill));
+    }
+}
+
+int32_t PackedInts::size() {
+    return _size;
+}
+
+int32_t PackedInts::getBitsPerValue() {
+    return bitsPerValue;
+}
+
+int64_t PackedInts::sizeInBytes() {
+    return (int64_t)words.size() * sizeof(int64_t);
+}
+
+void PackedInts::write(const IndexOutputPtr& out) {
+    out->writeByte((uint8_t)bitsPerValue);
+    for (int32_t i = 0; i < words.size(); ++i) {
+        out->writeLong(words[i]);
+    }
+}
+
+PackedIntsPtr PackedInts::read(const IndexInputPtr& in, int32_t size) {
+    PackedIntsPtr packed(newLucene<PackedInts>(size, (int32_t)in->readByte()));
+    for (int32_t i = 0; i < packed->words.size(); ++i) {
+        packed->words[i] = in->readLong();
+    }
+    return packed;
+}
+
+}
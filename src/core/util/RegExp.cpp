@@ -0,0 +1,355 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "RegExp.h"
+#include "_RegExp.h"
+#include "Automaton.h"
+#include "StringUtils.h"
+
+namespace Lucene {
+
+RegExp::RegExp(const String& s) {
+    this->originalString = s;
+    this->pos = 0;
+    if (s.empty()) {
+        root = RegExpNode::makeString(L"");
+    } else {
+        root = parseUnionExp();
+        if (more()) {
+            boost::throw_exception(IllegalArgumentException(L"end of string expected at position " + StringUtils::toString(pos)));
+        }
+    }
+}
+
+RegExp::~RegExp() {
+}
+
+String RegExp::getOriginalString() {
+    return originalString;
+}
+
+AutomatonPtr RegExp::toAutomaton(int32_t maxDeterminizedStates) {
+    AutomatonPtr nfa(newLucene<Automaton>());
+    int32_t end = root->toNFA(nfa, nfa->createState(), maxDeterminizedStates);
+    nfa->setAccept(end, true);
+    return nfa->minimize(maxDeterminizedStates);
+}
+
+AutomatonPtr RegExp::toAutomaton() {
+    return toAutomaton(Automaton::DEFAULT_MAX_DETERMINIZED_STATES);
+}
+
+String RegExp::toString() {
+    return root->toString();
+}
+
+bool RegExp::more() {
+    return (pos < (int32_t)originalString.length());
+}
+
+bool RegExp::peek(const String& chars) {
+    return (more() && chars.find(originalString[pos]) != String::npos);
+}
+
+bool RegExp::match(wchar_t c) {
+    if (more() && originalString[pos] == c) {
+        ++pos;
+        return true;
+    }
+    return false;
+}
+
+wchar_t RegExp::next() {
+    if (!more()) {
+        boost::throw_exception(IllegalArgumentException(L"unexpected end of string"));
+    }
+    return originalString[pos++];
+}
+
+void RegExp::expect(wchar_t c) {
+    if (!match(c)) {
+        boost::throw_exception(IllegalArgumentException(L"expected '" + String(1, c) + L"' at position " + StringUtils::toString(pos)));
+    }
+}
+
+int32_t RegExp::parseNumber() {
+    int32_t start = pos;
+    while (peek(L"0123456789")) {
+        ++pos;
+    }
+    if (pos == start || pos - start > 9) {
+        boost::throw_exception(IllegalArgumentException(L"integer expected at position " + StringUtils::toString(start)));
+    }
+    return StringUtils::toInt(originalString.substr(start, pos - start));
+}
+
+RegExpNodePtr RegExp::parseUnionExp() {
+    RegExpNodePtr e(parseConcatExp());
+    if (match(L'|')) {
+        e = RegExpNode::makeUnion(e, parseUnionExp());
+    }
+    return e;
+}
+
+RegExpNodePtr RegExp::parseConcatExp() {
+    RegExpNodePtr e(parseRepeatExp());
+    while (more() && !peek(L")|")) {
+        e = RegExpNode::makeConcatenation(e, parseRepeatExp());
+    }
+    return e;
+}
+
+RegExpNodePtr RegExp::parseRepeatExp() {
+    RegExpNodePtr e(parseCharClassExp());
+    while (peek(L"?*+{")) {
+        if (match(L'?')) {
+            e = RegExpNode::makeRepeat(e, 0, 1);
+        } else if (match(L'*')) {
+            e = RegExpNode::makeRepeat(e, 0, -1);
+        } else if (match(L'+')) {
+            e = RegExpNode::makeRepeat(e, 1, -1);
+        } else if (match(L'{')) {
+            int32_t start = pos;
+            int32_t min = parseNumber();
+            int32_t max = min;
+            if (match(L',')) {
+                max = peek(L"0123456789") ? parseNumber() : -1;
+            }
+            expect(L'}');
+            if (max != -1 && max < min) {
+                boost::throw_exception(IllegalArgumentException(L"invalid repetition at position " + StringUtils::toString(start)));
+            }
+            e = RegExpNode::makeRepeat(e, min, max);
+        }
+    }
+    return e;
+}
+
+RegExpNodePtr RegExp::parseCharClassExp() {
+    if (match(L'[')) {
+        bool negate = match(L'^');
+        Collection<int32_t> ranges(Collection<int32_t>::newInstance());
+        do {
+            parseCharClass(ranges);
+        } while (more() && !peek(L"]"));
+        expect(L']');
+        return RegExpNode::makeChars(ranges, negate);
+    }
+    return parseSimpleExp();
+}
+
+void RegExp::parseCharClass(Collection<int32_t> ranges) {
+    int32_t start = pos;
+    int32_t from = (int32_t)parseCharExp();
+    int32_t to = from;
+    if (match(L'-')) {
+        to = (int32_t)parseCharExp();
+        if (to < from) {
+            boost::throw_exception(IllegalArgumentException(L"invalid range at position " + StringUtils::toString(start)));
+        }
+    }
+    ranges.add(from);
+    ranges.add(to);
+}
+
+RegExpNodePtr RegExp::parseSimpleExp() {
+    if (match(L'.')) {
+        return RegExpNode::makeChars(newCollection<int32_t>(Automaton::MIN_LABEL, Automaton::MAX_LABEL), false);
+    } else if (match(L'(')) {
+        if (match(L')')) {
+            return RegExpNode::makeString(L"");
+        }
+        RegExpNodePtr e(parseUnionExp());
+        expect(L')');
+        return e;
+    } else if (match(L'"')) {
+        int32_t start = pos;
+        while (more() && !peek(L"\"")) {
+            ++pos;
+        }
+        expect(L'"');
+        return RegExpNode::makeString(originalString.substr(start, pos - 1 - start));
+    }
+    return RegExpNode::makeString(String(1, parseCharExp()));
+}
+
+wchar_t RegExp::parseCharExp() {
+    match(L'\\');
+    return next();
+}
+
+RegExpNode::RegExpNode(Kind kind) {
+    this->kind = kind;
+    this->min = 0;
+    this->max = 0;
+}
+
+RegExpNode::~RegExpNode() {
+}
+
+RegExpNodePtr RegExpNode::makeUnion(const RegExpNodePtr& exp1, const RegExpNodePtr& exp2) {
+    RegExpNodePtr node(newLucene<RegExpNode>(REGEXP_UNION));
+    node->exp1 = exp1;
+    node->exp2 = exp2;
+    return node;
+}
+
+RegExpNodePtr RegExpNode::makeConcatenation(const RegExpNodePtr& exp1, const RegExpNodePtr& exp2) {
+    // join adjacent strings
+    if (exp1->kind == REGEXP_STRING && exp2->kind == REGEXP_STRING) {
+        return makeString(exp1->s + exp2->s);
+    }
+    if (exp1->kind == REGEXP_CONCATENATION && exp1->exp2->kind == REGEXP_STRING && exp2->kind == REGEXP_STRING) {
+        return makeConcatenation(exp1->exp1, makeString(exp1->exp2->s + exp2->s));
+    }
+    RegExpNodePtr node(newLucene<RegExpNode>(REGEXP_CONCATENATION));
+    node->exp1 = exp1;
+    node->exp2 = exp2;
+    return node;
+}
+
+RegExpNodePtr RegExpNode::makeRepeat(const RegExpNodePtr& exp, int32_t min, int32_t max) {
+    RegExpNodePtr node(newLucene<RegExpNode>(REGEXP_REPEAT));
+    node->exp1 = exp;
+    node->min = min;
+    node->max = max;
+    return node;
+}
+
+RegExpNodePtr RegExpNode::makeChars(Collection<int32_t> ranges, bool negate) {
+    // sort the ranges and merge those that overlap or touch
+    Collection< std::pair<int32_t, int32_t> > sorted(Collection< std::pair<int32_t, int32_t> >::newInstance());
+    for (int32_t i = 0; i + 1 < ranges.size(); i += 2) {
+        sorted.add(std::make_pair(ranges[i], ranges[i + 1]));
+    }
+    std::sort(sorted.begin(), sorted.end());
+    RegExpNodePtr node(newLucene<RegExpNode>(REGEXP_CHARS));
+    node->ranges = Collection<int32_t>::newInstance();
+    for (Collection< std::pair<int32_t, int32_t> >::iterator range = sorted.begin(); range != sorted.end(); ++range) {
+        int32_t size = node->ranges.size();
+        if (size > 0 && range->first <= node->ranges[size - 1] + 1) {
+            node->ranges[size - 1] = std::max(node->ranges[size - 1], range->second);
+        } else {
+            node->ranges.add(range->first);
+            node->ranges.add(range->second);
+        }
+    }
+    if (negate) {
+        Collection<int32_t> complement(Collection<int32_t>::newInstance());
+        int32_t from = Automaton::MIN_LABEL;
+        for (int32_t i = 0; i < node->ranges.size(); i += 2) {
+            if (node->ranges[i] > from) {
+                complement.add(from);
+                complement.add(node->ranges[i] - 1);
+            }
+            from = node->ranges[i + 1] + 1;
+        }
+        if (from <= Automaton::MAX_LABEL) {
+            complement.add(from);
+            complement.add(Automaton::MAX_LABEL);
+        }
+        node->ranges = complement;
+    }
+    return node;
+}
+
+RegExpNodePtr RegExpNode::makeString(const String& s) {
+    RegExpNodePtr node(newLucene<RegExpNode>(REGEXP_STRING));
+    node->s = s;
+    return node;
+}
+
+int32_t RegExpNode::toNFA(const AutomatonPtr& nfa, int32_t start, int32_t maxStates) {
+    // a large or nested repetition is expanded state by state, so stop once there are too many
+    if (nfa->getNumStates() > maxStates) {
+        boost::throw_exception(IllegalArgumentException(L"regular expression is too complex: more than " + StringUtils::toString(maxStates) + L" states"));
+    }
+    switch (kind) {
+    case REGEXP_UNION: {
+        int32_t end = nfa->createState();
+        nfa->addEpsilon(exp1->toNFA(nfa, start, maxStates), end);
+        nfa->addEpsilon(exp2->toNFA(nfa, start, maxStates), end);
+        return end;
+    }
+    case REGEXP_CONCATENATION:
+        return exp2->toNFA(nfa, exp1->toNFA(nfa, start, maxStates), maxStates);
+    case REGEXP_REPEAT: {
+        int32_t state = start;
+        for (int32_t i = 0; i < min; ++i) {
+            state = exp1->toNFA(nfa, state, maxStates);
+        }
+        if (max == -1) {
+            // a new state to loop on, so the loop can't reach what comes before it
+            int32_t loop = nfa->createState();
+            nfa->addEpsilon(state, loop);
+            nfa->addEpsilon(exp1->toNFA(nfa, loop, maxStates), loop);
+            return loop;
+        }
+        for (int32_t i = min; i < max; ++i) {
+            int32_t end = exp1->toNFA(nfa, state, maxStates);
+            nfa->addEpsilon(state, end);
+            state = end;
+        }
+        return state;
+    }
+    case REGEXP_CHARS: {
+        int32_t end = nfa->createState();
+        for (int32_t i = 0; i < ranges.size(); i += 2) {
+            nfa->addTransition(start, end, ranges[i], ranges[i + 1]);
+        }
+        return end;
+    }
+    case REGEXP_STRING: {
+        int32_t state = start;
+        for (String::const_iterator c = s.begin(); c != s.end(); ++c) {
+            int32_t next = nfa->createState();
+            nfa->addTransition(state, next, (int32_t)*c);
+            state = next;
+        }
+        return state;
+    }
+    }
+    return start;
+}
+
+String RegExpNode::toString() {
+    StringStream buffer;
+    switch (kind) {
+    case REGEXP_UNION:
+        buffer << L"(" << exp1->toString() << L"|" << exp2->toString() << L")";
+        break;
+    case REGEXP_CONCATENATION:
+        buffer << exp1->toString() << exp2->toString();
+        break;
+    case REGEXP_REPEAT:
+        buffer << L"(" << exp1->toString() << L"){" << min;
+        if (max != min) {
+            buffer << L",";
+            if (max != -1) {
+                buffer << max;
+            }
+        }
+        buffer << L"}";
+        break;
+    case REGEXP_CHARS:
+        buffer << L"[";
+        for (int32_t i = 0; i < ranges.size(); i += 2) {
+            buffer << L"\\" << (wchar_t)ranges[i];
+            if (ranges[i + 1] != ranges[i]) {
+                buffer << L"-\\" << (wchar_t)ranges[i + 1];
+            }
+        }
+        buffer << L"]";
+        break;
+    case REGEXP_STRING:
+        buffer << L"\"" << s << L"\"";
+        break;
+    }
+    return buffer.str();
+}
+
+}
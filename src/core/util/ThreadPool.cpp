@@ -5,33 +5,54 @@
 /////////////////////////////////////////////////////////////////////////////
 
 #include "LuceneInc.h"
-#include <boost/version.hpp>
-#if BOOST_VERSION >= 107300  // Boost 1.73.0+
-#include <boost/bind/bind.hpp>
-#else
-#include <boost/bind.hpp>
-#endif
 #include "ThreadPool.h"
 
 namespace Lucene {
 
+/// The pool and worker index of the current thread, if it is a pool worker.
+static thread_local ThreadPool* currentPool = NULL;
+static thread_local int32_t currentWorker = -1;
+
 Future::~Future() {
 }
 
-const int32_t ThreadPool::THREADPOOL_SIZE = 5;
-
-ThreadPool::ThreadPool()
-    :
-        work(boost::asio::make_work_guard(io_context))
-{
-    for (int32_t i = 0; i < THREADPOOL_SIZE; ++i) {
-        threadGroup.create_thread(boost::bind(&boost::asio::io_context::run, &io_context));
+ThreadPool::ThreadPool(int32_t threadCount) : shutdown(false), nextQueue(0), pendingTasks(0), completedTasks(0), stolenTasks(0) {
+    if (threadCount < 0) {
+        boost::throw_exception(IllegalArgumentException(L"threadCount must be >= 0"));
+    }
+    this->threadCount = threadCount == 0 ? getDefaultThreadCount() : threadCount;
+    queues.reset(new WorkerQueue[this->threadCount]);
+    threads = Collection<boost::thread*>::newInstance(this->threadCount);
+    for (int32_t i = 0; i < this->threadCount; ++i) {
+        threads[i] = threadGroup.create_thread(boost::bind(&ThreadPool::workerLoop, this, i));
     }
 }
 
 ThreadPool::~ThreadPool() {
-    io_context.stop();
+    {
+        boost::mutex::scoped_lock lock(idleMutex);
+        shutdown = true;
+    }
+    workAvailable.notify_all();
+    if (currentPool == this) {
+        // a task released the last reference to the pool from one of its workers, which can't wait for
+        // itself, so let it go and tell its worker loop to stop without touching the pool
+        boost::thread* self = threads[currentWorker];
+        threadGroup.remove_thread(self);
+        self->detach();
+        delete self;
+        currentPool = NULL;
+        currentWorker = -1;
+    }
     threadGroup.join_all(); // wait for all competition
+
+    // a worker that destroyed the pool leaves its queue behind, so run what is left to complete its futures
+    task_t task;
+    for (int32_t worker = 0; worker < threadCount; ++worker) {
+        while (takeTask(worker, task)) {
+            runTask(task);
+        }
+    }
 }
 
 ThreadPoolPtr ThreadPool::getInstance() {
@@ -43,4 +64,111 @@ ThreadPoolPtr ThreadPool::getInstance() {
     return threadPool;
 }
 
+int32_t ThreadPool::getDefaultThreadCount() {
+    return std::max((int32_t)boost::thread::hardware_concurrency(), (int32_t)1);
+}
+
+int32_t ThreadPool::getThreadCount() {
+    return threadCount;
+}
+
+int64_t ThreadPool::getQueueDepth() {
+    return pendingTasks;
+}
+
+int64_t ThreadPool::getCompletedTaskCount() {
+    return completedTasks;
+}
+
+int64_t ThreadPool::getStealCount() {
+    return stolenTasks;
+}
+
+void ThreadPool::submit(const task_t& task) {
+    // workers push onto their own queue, other threads spread tasks across all workers
+    int32_t worker = currentPool == this ? currentWorker : (int32_t)(nextQueue++ % (uint32_t)threadCount);
+    {
+        boost::mutex::scoped_lock lock(queues[worker].queueMutex);
+        queues[worker].tasks.push_back(task);
+    }
+    ++pendingTasks;
+    {
+        // taking the idle lock ensures a worker can't miss the notification between checking
+        // for pending tasks and going to sleep
+        boost::mutex::scoped_lock lock(idleMutex);
+    }
+    workAvailable.notify_one();
+}
+
+bool ThreadPool::takeTask(int32_t worker, task_t& task) {
+    {
+        boost::mutex::scoped_lock lock(queues[worker].queueMutex);
+        if (!queues[worker].tasks.empty()) {
+            task = queues[worker].tasks.back();
+            queues[worker].tasks.pop_back();
+            --pendingTasks;
+            return true;
+        }
+    }
+    for (int32_t i = 1; i < threadCount; ++i) {
+        WorkerQueue& victim = queues[(worker + i) % threadCount];
+        boost::mutex::scoped_lock lock(victim.queueMutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            --pendingTasks;
+            ++stolenTasks;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::runTask(const task_t& task) {
+    try {
+        task();
+    } catch (...) {
+    }
+    if (currentPool == this) { // unless the task destroyed the pool
+        ++completedTasks;
+    }
+}
+
+void ThreadPool::workerLoop(int32_t worker) {
+    currentPool = this;
+    currentWorker = worker;
+    task_t task;
+    while (true) {
+        if (takeTask(worker, task)) {
+            runTask(task);
+            task.clear();
+            if (currentPool != this) {
+                return; // the pool was destroyed by the task
+            }
+            continue;
+        }
+        boost::mutex::scoped_lock lock(idleMutex);
+        if (shutdown) {
+            break;
+        }
+        if (pendingTasks == 0) {
+            workAvailable.wait(lock);
+        }
+    }
+    currentPool = NULL;
+    currentWorker = -1;
+}
+
+bool ThreadPool::helpCurrentWorker() {
+    if (currentPool == NULL) {
+        return false;
+    }
+    task_t task;
+    if (!currentPool->takeTask(currentWorker, task)) {
+        return false;
+    }
+    currentPool->runTask(task);
+    return true;
+}
+
 }
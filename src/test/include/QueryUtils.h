@@ -58,6 +58,14 @@ public:
 
     /// Check that first skip on just created scorers always goes to the right doc
     static void checkFirstSkipTo(const QueryPtr& q, const IndexSearcherPtr& s);
+
+    /// Check that scoring batches, in windows that end within and between the batches, gives the same docs
+    /// and scores as next()
+    static void checkScoreBatch(const QueryPtr& q, const IndexSearcherPtr& s);
+
+    /// Check that actual scores the same docs in batches as expected does with next(), given two new scorers
+    /// of the same docs
+    static void checkScoreBatch(const ScorerPtr& expected, const ScorerPtr& actual);
 };
 
 }
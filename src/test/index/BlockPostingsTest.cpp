@@ -0,0 +1,236 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "ForUtil.h"
+#include "MockRAMDirectory.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "SegmentReader.h"
+#include "IndexInput.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "Term.h"
+#include "TermDocs.h"
+#include "TermPositions.h"
+#include "TermInfosWriter.h"
+#include "Random.h"
+
+using namespace Lucene;
+
+typedef LuceneTestFixture BlockPostingsTest;
+
+static const int32_t NUM_DOCS = 1000;
+
+static DirectoryPtr createIndex(bool useBlockPostings) {
+    DirectoryPtr dir = newLucene<MockRAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED);
+    writer->setUseBlockPostings(useBlockPostings);
+    writer->setMaxBufferedDocs(100);
+    writer->setMergeFactor(100); // keep the flushed segments apart
+    writer->setUseCompoundFile(false);
+    for (int32_t i = 0; i < NUM_DOCS; ++i) {
+        DocumentPtr doc = newLucene<Document>();
+        String body;
+        for (int32_t j = 0; j <= i % 3; ++j) {
+            body += L"all ";
+        }
+        if (i % 3 == 0) {
+            body += L"third ";
+        }
+        if (i % 97 == 0) {
+            body += L"sparse ";
+        }
+        if (i < 256) {
+            body += L"block ";
+        }
+        if (i % 500 < 130) {
+            body += L"gap ";
+        }
+        doc->add(newLucene<Field>(L"body", body, Field::STORE_NO, Field::INDEX_ANALYZED));
+        FieldPtr noTf = newLucene<Field>(L"notf", L"all " + body, Field::STORE_NO, Field::INDEX_ANALYZED);
+        noTf->setOmitTermFreqAndPositions(true);
+        doc->add(noTf);
+        writer->addDocument(doc);
+    }
+    writer->close();
+    return dir;
+}
+
+static void checkSameTermDocs(const IndexReaderPtr& expected, const IndexReaderPtr& actual, const TermPtr& term) {
+    // sequential iteration and positions
+    TermPositionsPtr expectedPositions = expected->termPositions(term);
+    TermPositionsPtr actualPositions = actual->termPositions(term);
+    while (expectedPositions->next()) {
+        EXPECT_TRUE(actualPositions->next());
+        EXPECT_EQ(expectedPositions->doc(), actualPositions->doc());
+        EXPECT_EQ(expectedPositions->freq(), actualPositions->freq());
+        if (term->field() == L"body") {
+            for (int32_t i = 0; i < expectedPositions->freq(); ++i) {
+                EXPECT_EQ(expectedPositions->nextPosition(), actualPositions->nextPosition());
+            }
+        }
+    }
+    EXPECT_TRUE(!actualPositions->next());
+
+    // bulk reads, using a buffer size that doesn't divide the block size; a read may stop short at the end
+    // of a segment, so compare what the reads add up to
+    Collection<int32_t> expectedRead = Collection<int32_t>::newInstance();
+    Collection<int32_t> actualRead = Collection<int32_t>::newInstance();
+    Collection<int32_t> docBuffer = Collection<int32_t>::newInstance(50);
+    Collection<int32_t> freqBuffer = Collection<int32_t>::newInstance(50);
+    TermDocsPtr expectedDocs = expected->termDocs(term);
+    for (int32_t count = expectedDocs->read(docBuffer, freqBuffer); count != 0; count = expectedDocs->read(docBuffer, freqBuffer)) {
+        for (int32_t i = 0; i < count; ++i) {
+            expectedRead.add(docBuffer[i]);
+            expectedRead.add(freqBuffer[i]);
+        }
+    }
+    TermDocsPtr actualDocs = actual->termDocs(term);
+    for (int32_t count = actualDocs->read(docBuffer, freqBuffer); count != 0; count = actualDocs->read(docBuffer, freqBuffer)) {
+        for (int32_t i = 0; i < count; ++i) {
+            actualRead.add(docBuffer[i]);
+            actualRead.add(freqBuffer[i]);
+        }
+    }
+    EXPECT_TRUE(expectedRead.equals(actualRead));
+
+    // skipping, both from a fresh enum and repeatedly on the same enum
+    static const int32_t targets[] = {0, 5, 127, 128, 129, 255, 256, 300, 640, 998, 999, 1000};
+    TermPositionsPtr expectedSkip = expected->termPositions(term);
+    TermPositionsPtr actualSkip = actual->termPositions(term);
+    bool exhausted = false;
+    for (int32_t i = 0; i < (int32_t)(sizeof(targets) / sizeof(targets[0])); ++i) {
+        TermDocsPtr expectedFresh = expected->termDocs(term);
+        TermDocsPtr actualFresh = actual->termDocs(term);
+        bool expectedFound = expectedFresh->skipTo(targets[i]);
+        EXPECT_EQ(expectedFound, actualFresh->skipTo(targets[i]));
+        if (expectedFound) {
+            EXPECT_EQ(expectedFresh->doc(), actualFresh->doc());
+            EXPECT_EQ(expectedFresh->freq(), actualFresh->freq());
+        }
+
+        if (!exhausted) {
+            bool found = expectedSkip->skipTo(targets[i]);
+            EXPECT_EQ(found, actualSkip->skipTo(targets[i]));
+            if (found) {
+                EXPECT_EQ(expectedSkip->doc(), actualSkip->doc());
+                if (term->field() == L"body") {
+                    EXPECT_EQ(expectedSkip->nextPosition(), actualSkip->nextPosition());
+                }
+            }
+            exhausted = !found;
+        }
+    }
+}
+
+static void checkSameIndex(const IndexReaderPtr& expected, const IndexReaderPtr& actual) {
+    static const wchar_t* terms[] = {L"all", L"third", L"sparse", L"block", L"gap", L"missing"};
+    for (int32_t i = 0; i < (int32_t)(sizeof(terms) / sizeof(terms[0])); ++i) {
+        checkSameTermDocs(expected, actual, newLucene<Term>(L"body", terms[i]));
+        checkSameTermDocs(expected, actual, newLucene<Term>(L"notf", terms[i]));
+    }
+}
+
+TEST_F(BlockPostingsTest, testPackUnpack) {
+    RandomPtr random = newLucene<Random>(42);
+    Collection<int32_t> values = Collection<int32_t>::newInstance(ForUtil::BLOCK_SIZE);
+    Collection<int32_t> decoded = Collection<int32_t>::newInstance(ForUtil::BLOCK_SIZE);
+    ByteArray packed = ByteArray::newInstance(ForUtil::encodedSize(32));
+    for (int32_t numBits = 0; numBits <= 32; ++numBits) {
+        for (int32_t i = 0; i < ForUtil::BLOCK_SIZE; ++i) {
+            int64_t max = numBits == 32 ? 0x7fffffff : ((int64_t)1 << numBits) - 1;
+            values[i] = max == 0 ? 0 : (int32_t)(random->nextInt(INT_MAX) % (max + 1));
+        }
+        values[ForUtil::BLOCK_SIZE - 1] = numBits == 32 ? -1 : (numBits == 0 ? 0 : (int32_t)(((int64_t)1 << numBits) - 1));
+        EXPECT_EQ(numBits, ForUtil::bitsRequired(values.get()->data()));
+        ForUtil::pack(values.get()->data(), numBits, packed.get());
+        ForUtil::unpack(packed.get(), numBits, decoded.get()->data());
+        for (int32_t i = 0; i < ForUtil::BLOCK_SIZE; ++i) {
+            EXPECT_EQ(values[i], decoded[i]);
+        }
+    }
+}
+
+TEST_F(BlockPostingsTest, testFormat) {
+    DirectoryPtr dir = createIndex(true);
+    IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), false, IndexWriter::MaxFieldLengthLIMITED);
+    writer->setUseBlockPostings(true);
+    writer->setUseCompoundFile(false);
+    writer->optimize();
+    writer->close();
+
+    IndexReaderPtr reader = IndexReader::open(dir, true);
+    String segment = SegmentReader::getOnlySegmentReader(reader)->getSegmentName();
+    reader->close();
+
+    IndexInputPtr input = dir->openInput(segment + L".tis");
+    EXPECT_EQ(TermInfosWriter::FORMAT_BLOCK_POSTINGS, input->readInt());
+    input->readLong(); // size
+    input->readInt(); // indexInterval
+    EXPECT_EQ(ForUtil::BLOCK_SIZE, input->readInt()); // skipInterval
+    input->readInt(); // maxSkipLevels
+    EXPECT_EQ(ForUtil::BLOCK_SIZE, input->readInt()); // postingsBlockSize
+    input->close();
+    dir->close();
+}
+
+TEST_F(BlockPostingsTest, testSameAsVIntPostings) {
+    DirectoryPtr expectedDir = createIndex(false);
+    DirectoryPtr actualDir = createIndex(true);
+
+    // multiple flushed segments
+    IndexReaderPtr expected = IndexReader::open(expectedDir, true);
+    IndexReaderPtr actual = IndexReader::open(actualDir, true);
+    EXPECT_TRUE(actual->getSequentialSubReaders().size() > 1);
+    checkSameIndex(expected, actual);
+    expected->close();
+    actual->close();
+
+    // merged segment
+    IndexWriterPtr writer = newLucene<IndexWriter>(actualDir, newLucene<WhitespaceAnalyzer>(), false, IndexWriter::MaxFieldLengthLIMITED);
+    writer->setUseBlockPostings(true);
+    writer->optimize();
+    writer->close();
+
+    expected = IndexReader::open(expectedDir, false);
+    actual = IndexReader::open(actualDir, false);
+    checkSameIndex(expected, actual);
+
+    // deleted docs
+    for (int32_t i = 0; i < NUM_DOCS; i += 7) {
+        expected->deleteDocument(i);
+        actual->deleteDocument(i);
+    }
+    checkSameIndex(expected, actual);
+    expected->close();
+    actual->close();
+
+    expectedDir->close();
+    actualDir->close();
+}
+
+TEST_F(BlockPostingsTest, testMixedFormatMerge) {
+    DirectoryPtr expectedDir = createIndex(false);
+    DirectoryPtr actualDir = createIndex(false);
+
+    // merge VInt encoded segments into a block encoded one
+    IndexWriterPtr writer = newLucene<IndexWriter>(actualDir, newLucene<WhitespaceAnalyzer>(), false, IndexWriter::MaxFieldLengthLIMITED);
+    writer->setUseBlockPostings(true);
+    writer->optimize();
+    writer->close();
+
+    IndexReaderPtr expected = IndexReader::open(expectedDir, true);
+    IndexReaderPtr actual = IndexReader::open(actualDir, true);
+    checkSameIndex(expected, actual);
+    expected->close();
+    actual->close();
+
+    expectedDir->close();
+    actualDir->close();
+}
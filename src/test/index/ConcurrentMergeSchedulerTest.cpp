@@ -22,6 +22,7 @@
 #include "IndexFileDeleter.h"
 #include "KeepOnlyLastCommitDeletionPolicy.h"
 #include "TestPoint.h"
+#include "ThreadPool.h"
 
 using namespace Lucene;
 
@@ -346,3 +347,98 @@ TEST_F(ConcurrentMergeSchedulerTest, testSubclassConcurrentMergeScheduler) {
     dir->close();
     EXPECT_TRUE(ConcurrentMergeScheduler::anyUnhandledExceptions());
 }
+
+TEST_F(ConcurrentMergeSchedulerTest, testThreadPool) {
+    RAMDirectoryPtr directory = newLucene<MockRAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(directory, newLucene<SimpleAnalyzer>(), true, IndexWriter::MaxFieldLengthUNLIMITED);
+    ThreadPoolPtr threadPool = newLucene<ThreadPool>(2);
+    ConcurrentMergeSchedulerPtr cms = newLucene<ConcurrentMergeScheduler>();
+    cms->setThreadPool(threadPool);
+    cms->setMaxThreadCount(2);
+    EXPECT_EQ(threadPool, cms->getThreadPool());
+    writer->setMergeScheduler(cms);
+    writer->setMaxBufferedDocs(2);
+    writer->setMergeFactor(3);
+
+    for (int32_t i = 0; i < 100; ++i) {
+        DocumentPtr doc = newLucene<Document>();
+        doc->add(newLucene<Field>(L"content", L"a b c " + StringUtils::toString(i), Field::STORE_NO, Field::INDEX_ANALYZED));
+        writer->addDocument(doc);
+    }
+
+    writer->optimize();
+    writer->close();
+    checkNoUnreferencedFiles(directory);
+    EXPECT_TRUE(threadPool->getCompletedTaskCount() > 0);
+
+    IndexReaderPtr reader = IndexReader::open(directory, true);
+    EXPECT_EQ(100, reader->numDocs());
+    EXPECT_EQ(1, reader->getSequentialSubReaders().size());
+    reader->close();
+    directory->close();
+}
+
+TEST_F(ConcurrentMergeSchedulerTest, testMergeRateLimit) {
+    RAMDirectoryPtr directory = newLucene<MockRAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(directory, newLucene<SimpleAnalyzer>(), true, IndexWriter::MaxFieldLengthUNLIMITED);
+    ConcurrentMergeSchedulerPtr cms = newLucene<ConcurrentMergeScheduler>();
+    EXPECT_EQ(0.0, cms->getMergeMBPerSec());
+    cms->setMergeMBPerSec(0.2);
+    EXPECT_EQ(0.2, cms->getMergeMBPerSec());
+    writer->setMergeScheduler(cms);
+    writer->setMaxBufferedDocs(20);
+    writer->setMergeFactor(5);
+
+    String text(L"some stored text to make the merged segments bigger");
+    for (int32_t i = 0; i < 200; ++i) {
+        DocumentPtr doc = newLucene<Document>();
+        doc->add(newLucene<Field>(L"content", text + L" " + StringUtils::toString(i), Field::STORE_YES, Field::INDEX_ANALYZED));
+        writer->addDocument(doc);
+    }
+
+    writer->optimize();
+    writer->close();
+    checkNoUnreferencedFiles(directory);
+    EXPECT_TRUE(cms->getMergeBytesThrottled() > 0);
+    EXPECT_TRUE(cms->getMergePausedMillis() > 0);
+
+    IndexReaderPtr reader = IndexReader::open(directory, true);
+    EXPECT_EQ(200, reader->numDocs());
+    EXPECT_EQ(1, reader->getSequentialSubReaders().size());
+    EXPECT_EQ(text + L" 199", reader->document(199)->get(L"content"));
+    reader->close();
+    directory->close();
+}
+
+TEST_F(ConcurrentMergeSchedulerTest, testAutoIOThrottle) {
+    ConcurrentMergeSchedulerPtr cms = newLucene<ConcurrentMergeScheduler>();
+    EXPECT_TRUE(!cms->getAutoIOThrottle());
+    cms->setAutoIOThrottle(true);
+    EXPECT_TRUE(cms->getAutoIOThrottle());
+    EXPECT_EQ(ConcurrentMergeScheduler::START_MERGE_MB_PER_SEC, cms->getMergeMBPerSec());
+
+    RAMDirectoryPtr directory = newLucene<MockRAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(directory, newLucene<SimpleAnalyzer>(), true, IndexWriter::MaxFieldLengthUNLIMITED);
+    writer->setMergeScheduler(cms);
+    writer->setMaxBufferedDocs(2);
+    writer->setMergeFactor(3);
+    for (int32_t i = 0; i < 100; ++i) {
+        DocumentPtr doc = newLucene<Document>();
+        doc->add(newLucene<Field>(L"content", L"a b c " + StringUtils::toString(i), Field::STORE_NO, Field::INDEX_ANALYZED));
+        writer->addDocument(doc);
+    }
+    writer->close();
+
+    // the rate was tuned, but stays within bounds
+    EXPECT_NE(ConcurrentMergeScheduler::START_MERGE_MB_PER_SEC, cms->getMergeMBPerSec());
+    EXPECT_TRUE(cms->getMergeMBPerSec() >= ConcurrentMergeScheduler::MIN_MERGE_MB_PER_SEC);
+    EXPECT_TRUE(cms->getMergeMBPerSec() <= ConcurrentMergeScheduler::MAX_MERGE_MB_PER_SEC);
+
+    IndexReaderPtr reader = IndexReader::open(directory, true);
+    EXPECT_EQ(100, reader->numDocs());
+    reader->close();
+    directory->close();
+
+    cms->setAutoIOThrottle(false);
+    EXPECT_EQ(0.0, cms->getMergeMBPerSec());
+}
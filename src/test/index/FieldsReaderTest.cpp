@@ -5,6 +5,7 @@
 /////////////////////////////////////////////////////////////////////////////
 
 #include "TestInc.h"
+#include <boost/algorithm/string.hpp>
 #include "LuceneTestFixture.h"
 #include "TestUtils.h"
 #include "RAMDirectory.h"
@@ -22,6 +23,9 @@
 #include "IndexReader.h"
 #include "MiscUtils.h"
 #include "FileUtils.h"
+#include "Term.h"
+#include "LogDocMergePolicy.h"
+#include "IndexFileNames.h"
 
 using namespace Lucene;
 
@@ -435,3 +439,110 @@ TEST_F(FieldsReaderTest, testExceptions) {
     FileUtils::removeDirectory(indexDir);
     finally.throwException();
 }
+
+static DocumentPtr compressedChunksDoc(int32_t i) {
+    DocumentPtr doc = newLucene<Document>();
+    doc->add(newLucene<Field>(L"id", StringUtils::toString(i), Field::STORE_YES, Field::INDEX_NOT_ANALYZED));
+    doc->add(newLucene<Field>(L"body", L"the quick brown fox " + StringUtils::toString(i % 7) + L" jumps over the lazy dog " + StringUtils::toString(i), Field::STORE_YES, Field::INDEX_ANALYZED));
+    ByteArray bytes(ByteArray::newInstance(i % 50));
+    for (int32_t j = 0; j < bytes.size(); ++j) {
+        bytes[j] = (uint8_t)(i + j);
+    }
+    doc->add(newLucene<Field>(L"binary", bytes, Field::STORE_YES));
+    return doc;
+}
+
+static void checkCompressedChunksDoc(const DocumentPtr& doc, int32_t i) {
+    DocumentPtr expected = compressedChunksDoc(i);
+    EXPECT_EQ(expected->get(L"id"), doc->get(L"id"));
+    EXPECT_EQ(expected->get(L"body"), doc->get(L"body"));
+    EXPECT_TRUE(expected->getBinaryValue(L"binary").equals(doc->getBinaryValue(L"binary")));
+}
+
+static DirectoryPtr createCompressedChunksIndex(int32_t compression, int32_t numDocs) {
+    DirectoryPtr dir = newLucene<RAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED);
+    writer->setStoredFieldsCompression(compression);
+    writer->setMaxBufferedDocs(170);
+    writer->setMergePolicy(newLucene<LogDocMergePolicy>(writer));
+    writer->setUseCompoundFile(false);
+    writer->setMergeFactor(1000);
+    for (int32_t i = 0; i < numDocs; ++i) {
+        writer->addDocument(compressedChunksDoc(i));
+    }
+    writer->close();
+    return dir;
+}
+
+static int64_t storedFieldsLength(const DirectoryPtr& dir) {
+    int64_t length = 0;
+    HashSet<String> files(dir->listAll());
+    for (HashSet<String>::iterator file = files.begin(); file != files.end(); ++file) {
+        if (boost::ends_with(*file, L"." + IndexFileNames::FIELDS_EXTENSION())) {
+            length += dir->fileLength(*file);
+        }
+    }
+    return length;
+}
+
+TEST_F(FieldsReaderTest, testCompressedChunks) {
+    static const int32_t NUM_DOCS = 1000;
+    DirectoryPtr uncompressed = createCompressedChunksIndex(IndexWriter::STORED_FIELDS_UNCOMPRESSED, NUM_DOCS);
+    static const int32_t compressions[] = {IndexWriter::STORED_FIELDS_COMPRESS_FAST, IndexWriter::STORED_FIELDS_COMPRESS_HIGH};
+    for (int32_t c = 0; c < 2; ++c) {
+        DirectoryPtr dir = createCompressedChunksIndex(compressions[c], NUM_DOCS);
+        EXPECT_TRUE(storedFieldsLength(dir) < storedFieldsLength(uncompressed) / 2);
+
+        IndexReaderPtr reader = IndexReader::open(dir, true);
+        EXPECT_EQ(NUM_DOCS, reader->maxDoc());
+        for (int32_t i = 0; i < NUM_DOCS; ++i) {
+            checkCompressedChunksDoc(reader->document(i), i);
+        }
+        // backwards, so that each chunk is decompressed again
+        for (int32_t i = NUM_DOCS - 1; i >= 0; i -= 3) {
+            checkCompressedChunksDoc(reader->document(i), i);
+        }
+
+        // lazy fields are loaded with the rest of the document
+        HashSet<String> lazyFieldNames = HashSet<String>::newInstance();
+        lazyFieldNames.add(L"body");
+        DocumentPtr doc = reader->document(42, newLucene<SetBasedFieldSelector>(HashSet<String>::newInstance(), lazyFieldNames));
+        EXPECT_EQ(compressedChunksDoc(42)->get(L"body"), doc->get(L"body"));
+        EXPECT_TRUE(!doc->getFieldable(L"id"));
+        reader->close();
+        dir->close();
+    }
+    uncompressed->close();
+}
+
+TEST_F(FieldsReaderTest, testMergeCompressedChunks) {
+    static const int32_t NUM_DOCS = 1000;
+    static const int32_t compressions[] = {IndexWriter::STORED_FIELDS_COMPRESS_FAST, IndexWriter::STORED_FIELDS_COMPRESS_HIGH, IndexWriter::STORED_FIELDS_UNCOMPRESSED};
+    for (int32_t c = 0; c < 3; ++c) {
+        for (int32_t merge = 0; merge < 3; ++merge) {
+            DirectoryPtr dir = createCompressedChunksIndex(compressions[c], NUM_DOCS);
+
+            // merge whole chunks, then with deletions that split chunks, with the same or another compression
+            IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), false, IndexWriter::MaxFieldLengthLIMITED);
+            writer->setUseCompoundFile(false);
+            writer->setStoredFieldsCompression(compressions[merge]);
+            writer->optimize();
+            for (int32_t i = 0; i < NUM_DOCS; i += 7) {
+                writer->deleteDocuments(newLucene<Term>(L"id", StringUtils::toString(i)));
+            }
+            writer->optimize();
+            writer->close();
+
+            IndexReaderPtr reader = IndexReader::open(dir, true);
+            EXPECT_EQ(NUM_DOCS - (NUM_DOCS + 6) / 7, reader->maxDoc());
+            for (int32_t i = 0; i < reader->maxDoc(); ++i) {
+                DocumentPtr doc = reader->document(i);
+                int32_t id = StringUtils::toInt(doc->get(L"id"));
+                EXPECT_NE(0, id % 7);
+                checkCompressedChunksDoc(doc, id);
+            }
+            reader->close();
+            dir->close();
+        }
+    }
+}
@@ -902,3 +902,134 @@ TEST_F(IndexWriterReaderTest, testSegmentWarmer) {
     w->close();
     dir->close();
 }
+
+TEST_F(IndexWriterReaderTest, testReopenUnchanged) {
+    DirectoryPtr dir = newLucene<MockRAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), IndexWriter::MaxFieldLengthLIMITED);
+    createIndexNoClose(false, L"test", writer);
+
+    IndexReaderPtr r1 = writer->getReader();
+    EXPECT_TRUE(r1->isCurrent());
+    EXPECT_EQ(r1, r1->reopen());
+
+    // a buffered delete makes the reader stale
+    writer->deleteDocuments(newLucene<Term>(L"id", L"7"));
+    EXPECT_TRUE(!r1->isCurrent());
+    IndexReaderPtr r2 = r1->reopen();
+    EXPECT_NE(r1, r2);
+    EXPECT_EQ(99, r2->numDocs());
+    EXPECT_EQ(100, r1->numDocs());
+    EXPECT_EQ(r2, r2->reopen());
+
+    // unchanged segments share their core, and so their field cache entries
+    Collection<IndexReaderPtr> subReaders1 = r1->getSequentialSubReaders();
+    Collection<IndexReaderPtr> subReaders2 = r2->getSequentialSubReaders();
+    EXPECT_EQ(subReaders1.size(), subReaders2.size());
+    for (int32_t i = 0; i < subReaders1.size(); ++i) {
+        EXPECT_EQ(subReaders1[i]->getFieldCacheKey(), subReaders2[i]->getFieldCacheKey());
+    }
+
+    r1->close();
+    r2->close();
+    writer->close();
+    dir->close();
+}
+
+TEST_F(IndexWriterReaderTest, testWarmFlushedSegments) {
+    DirectoryPtr dir = newLucene<MockRAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), IndexWriter::MaxFieldLengthLIMITED);
+    writer->setMergeFactor(100);
+    TestMergeWarmer::MyWarmerPtr warmer = newLucene<TestMergeWarmer::MyWarmer>();
+    writer->setMergedSegmentWarmer(warmer);
+
+    for (int32_t i = 0; i < 10; ++i) {
+        writer->addDocument(createDocument(i, L"test", 4));
+    }
+    IndexReaderPtr r1 = writer->getReader();
+    EXPECT_EQ(1, warmer->warmCount);
+    EXPECT_EQ(1, writer->getReaderCount());
+
+    // only the newly flushed segment is warmed
+    for (int32_t i = 10; i < 20; ++i) {
+        writer->addDocument(createDocument(i, L"test", 4));
+    }
+    IndexReaderPtr r2 = r1->reopen();
+    EXPECT_EQ(2, r2->getSequentialSubReaders().size());
+    EXPECT_EQ(2, warmer->warmCount);
+
+    // deletions don't add segments to warm
+    writer->deleteDocuments(newLucene<Term>(L"id", L"3"));
+    IndexReaderPtr r3 = r2->reopen();
+    EXPECT_EQ(19, r3->numDocs());
+    EXPECT_EQ(2, warmer->warmCount);
+
+    EXPECT_EQ(3, writer->getReaderCount());
+    EXPECT_TRUE(writer->getLastReaderLatency() >= 0);
+    EXPECT_TRUE(writer->getTotalReaderLatency() >= writer->getLastReaderLatency());
+
+    r1->close();
+    r2->close();
+    r3->close();
+    writer->close();
+    dir->close();
+}
+
+namespace TestFailedWarm {
+
+DECLARE_SHARED_PTR(FailOnceWarmer)
+
+class FailOnceWarmer : public IndexReaderWarmer {
+public:
+    FailOnceWarmer() {
+        warmCount = 0;
+    }
+
+    virtual ~FailOnceWarmer() {
+    }
+
+    LUCENE_CLASS(FailOnceWarmer);
+
+public:
+    int32_t warmCount;
+
+public:
+    virtual void warm(const IndexReaderPtr& reader) {
+        if (++warmCount == 1) {
+            boost::throw_exception(IOException(L"warm failed"));
+        }
+    }
+};
+
+}
+
+TEST_F(IndexWriterReaderTest, testFailedWarmIsRetried) {
+    DirectoryPtr dir = newLucene<MockRAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), IndexWriter::MaxFieldLengthLIMITED);
+    writer->setMergeFactor(100);
+    TestFailedWarm::FailOnceWarmerPtr warmer = newLucene<TestFailedWarm::FailOnceWarmer>();
+    writer->setMergedSegmentWarmer(warmer);
+
+    for (int32_t i = 0; i < 10; ++i) {
+        writer->addDocument(createDocument(i, L"test", 4));
+    }
+    try {
+        writer->getReader();
+    } catch (IOException& e) {
+        EXPECT_TRUE(check_exception(LuceneException::IO)(e));
+    }
+    EXPECT_EQ(1, warmer->warmCount);
+
+    // the segment whose warm failed is warmed again
+    IndexReaderPtr r = writer->getReader();
+    EXPECT_EQ(2, warmer->warmCount);
+    EXPECT_EQ(10, r->numDocs());
+
+    // and only once
+    IndexReaderPtr r2 = writer->getReader();
+    EXPECT_EQ(2, warmer->warmCount);
+
+    r->close();
+    r2->close();
+    writer->close();
+    dir->close();
+}
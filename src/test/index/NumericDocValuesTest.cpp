@@ -0,0 +1,173 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "MockRAMDirectory.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "IndexSearcher.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "DocValuesField.h"
+#include "NumericDocValues.h"
+#include "FieldCache.h"
+#include "MatchAllDocsQuery.h"
+#include "Sort.h"
+#include "SortField.h"
+#include "TopFieldDocs.h"
+#include "ScoreDoc.h"
+#include "Term.h"
+
+using namespace Lucene;
+
+typedef LuceneTestFixture NumericDocValuesTest;
+
+static int64_t longValue(int32_t id) {
+    return (id % 3 == 0) ? -(int64_t)id * 1000000007LL : (int64_t)id * 31;
+}
+
+static double doubleValue(int32_t id) {
+    return (double)(id % 17) / 4.0 - 2.0;
+}
+
+/// Every third document has no "double" value, every fifth none at all.
+static void addDocs(const IndexWriterPtr& writer, int32_t start, int32_t end) {
+    for (int32_t id = start; id < end; ++id) {
+        DocumentPtr doc(newLucene<Document>());
+        doc->add(newLucene<Field>(L"id", StringUtils::toString(id), Field::STORE_YES, Field::INDEX_NOT_ANALYZED));
+        if (id % 5 != 0) {
+            doc->add(newLucene<DocValuesField>(L"long")->setLongValue(longValue(id)));
+            if (id % 3 != 0) {
+                doc->add(newLucene<DocValuesField>(L"double")->setDoubleValue(doubleValue(id)));
+            }
+        }
+        writer->addDocument(doc);
+    }
+}
+
+static void checkValues(const IndexReaderPtr& reader, int32_t numDocs) {
+    Collection<IndexReaderPtr> subReaders(reader->getSequentialSubReaders());
+    int32_t count = 0;
+    for (Collection<IndexReaderPtr>::iterator subReader = subReaders.begin(); subReader != subReaders.end(); ++subReader) {
+        NumericDocValuesPtr longs((*subReader)->getNumericDocValues(L"long"));
+        NumericDocValuesPtr doubles((*subReader)->getNumericDocValues(L"double"));
+        EXPECT_TRUE(longs);
+        EXPECT_EQ(NumericDocValues::TYPE_LONG, longs->getType());
+        EXPECT_EQ((*subReader)->maxDoc(), longs->size());
+        EXPECT_TRUE(!(*subReader)->getNumericDocValues(L"id"));
+        for (int32_t doc = 0; doc < (*subReader)->maxDoc(); ++doc) {
+            if ((*subReader)->isDeleted(doc)) {
+                continue;
+            }
+            int32_t id = StringUtils::toInt((*subReader)->document(doc)->get(L"id"));
+            EXPECT_EQ(id % 5 != 0 ? longValue(id) : 0, longs->getLong(doc));
+            if (doubles) {
+                EXPECT_EQ(NumericDocValues::TYPE_DOUBLE, doubles->getType());
+                EXPECT_EQ(id % 5 != 0 && id % 3 != 0 ? doubleValue(id) : 0.0, doubles->getDouble(doc));
+            }
+            ++count;
+        }
+    }
+    EXPECT_EQ(numDocs, count);
+}
+
+TEST_F(NumericDocValuesTest, testFlushAndMerge) {
+    for (int32_t compound = 0; compound < 2; ++compound) {
+        DirectoryPtr dir(newLucene<MockRAMDirectory>());
+        IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthUNLIMITED));
+        writer->setUseCompoundFile(compound == 1);
+        writer->setMaxBufferedDocs(17);
+        writer->setMergeFactor(100);
+        addDocs(writer, 0, 200);
+        writer->commit();
+
+        IndexReaderPtr reader(IndexReader::open(dir, true));
+        EXPECT_TRUE(reader->getSequentialSubReaders().size() > 1);
+        checkValues(reader, 200);
+        reader->close();
+
+        // merge away deleted documents
+        for (int32_t id = 0; id < 200; id += 7) {
+            writer->deleteDocuments(newLucene<Term>(L"id", StringUtils::toString(id)));
+        }
+        writer->optimize();
+        writer->close();
+
+        reader = IndexReader::open(dir, true);
+        EXPECT_EQ(1, reader->getSequentialSubReaders().size());
+        checkValues(reader, 200 - 29);
+        reader->close();
+        dir->close();
+    }
+}
+
+TEST_F(NumericDocValuesTest, testMixedTypes) {
+    DirectoryPtr dir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthUNLIMITED));
+    DocumentPtr doc(newLucene<Document>());
+    doc->add(newLucene<DocValuesField>(L"value")->setIntValue(3));
+    writer->addDocument(doc);
+    writer->commit(); // a segment with a long value
+    doc = newLucene<Document>();
+    doc->add(newLucene<DocValuesField>(L"value")->setDoubleValue(-0.5));
+    writer->addDocument(doc);
+    writer->optimize();
+    writer->close();
+
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    NumericDocValuesPtr values(reader->getSequentialSubReaders()[0]->getNumericDocValues(L"value"));
+    EXPECT_EQ(NumericDocValues::TYPE_DOUBLE, values->getType());
+    EXPECT_EQ(3.0, values->getDouble(0));
+    EXPECT_EQ(-0.5, values->getDouble(1));
+    reader->close();
+}
+
+TEST_F(NumericDocValuesTest, testFieldCacheAndSort) {
+    DirectoryPtr dir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthUNLIMITED));
+    writer->setMaxBufferedDocs(10);
+    addDocs(writer, 0, 50);
+    writer->close();
+
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    Collection<IndexReaderPtr> subReaders(reader->getSequentialSubReaders());
+    for (Collection<IndexReaderPtr>::iterator subReader = subReaders.begin(); subReader != subReaders.end(); ++subReader) {
+        // the fields have no terms, so these can only come from the doc values
+        Collection<int64_t> longs(FieldCache::DEFAULT()->getLongs(*subReader, L"long"));
+        Collection<double> doubles(FieldCache::DEFAULT()->getDoubles(*subReader, L"double"));
+        Collection<int32_t> ints(FieldCache::DEFAULT()->getInts(*subReader, L"long"));
+        NumericDocValuesPtr values((*subReader)->getNumericDocValues(L"long"));
+        for (int32_t doc = 0; doc < (*subReader)->maxDoc(); ++doc) {
+            EXPECT_EQ(values->getLong(doc), longs[doc]);
+            EXPECT_EQ((int32_t)values->getLong(doc), ints[doc]);
+            EXPECT_EQ((*subReader)->getNumericDocValues(L"double")->getDouble(doc), doubles[doc]);
+        }
+    }
+
+    IndexSearcherPtr searcher(newLucene<IndexSearcher>(reader));
+    Collection<ScoreDocPtr> hits(searcher->search(newLucene<MatchAllDocsQuery>(), FilterPtr(), 50, newLucene<Sort>(newLucene<SortField>(L"long", SortField::LONG)))->scoreDocs);
+    EXPECT_EQ(50, hits.size());
+    int64_t last = LLONG_MIN;
+    for (int32_t i = 0; i < hits.size(); ++i) {
+        int32_t id = StringUtils::toInt(searcher->doc(hits[i]->doc)->get(L"id"));
+        int64_t value = id % 5 != 0 ? longValue(id) : 0;
+        EXPECT_TRUE(value >= last);
+        last = value;
+    }
+
+    hits = searcher->search(newLucene<MatchAllDocsQuery>(), FilterPtr(), 50, newLucene<Sort>(newLucene<SortField>(L"double", SortField::DOUBLE, true)))->scoreDocs;
+    double lastDouble = std::numeric_limits<double>::infinity();
+    for (int32_t i = 0; i < hits.size(); ++i) {
+        int32_t id = StringUtils::toInt(searcher->doc(hits[i]->doc)->get(L"id"));
+        double value = id % 5 != 0 && id % 3 != 0 ? doubleValue(id) : 0.0;
+        EXPECT_TRUE(value <= lastDouble);
+        lastDouble = value;
+    }
+    searcher->close();
+    reader->close();
+}
@@ -14,6 +14,7 @@
 #include "SegmentInfo.h"
 #include "IndexReader.h"
 #include "SegmentMerger.h"
+#include "ThreadPool.h"
 #include "TermDocs.h"
 #include "Term.h"
 #include "TermFreqVector.h"
@@ -135,3 +136,38 @@ TEST_F(SegmentMergerTest, testMerge) {
 
     checkNorms(mergedReader);
 }
+
+TEST_F(SegmentMergerTest, testMergeStagesConcurrently) {
+    DirectoryPtr serialDir = newLucene<RAMDirectory>();
+    SegmentMergerPtr serialMerger = newLucene<SegmentMerger>(serialDir, mergedSegment);
+    serialMerger->setThreadPool(ThreadPoolPtr());
+    serialMerger->add(reader1);
+    serialMerger->add(reader2);
+    EXPECT_EQ(2, serialMerger->merge());
+
+    SegmentMergerPtr merger = newLucene<SegmentMerger>(mergedDir, mergedSegment);
+    merger->setThreadPool(newLucene<ThreadPool>(4));
+    merger->add(reader1);
+    merger->add(reader2);
+    EXPECT_EQ(2, merger->merge());
+    merger->closeReaders();
+
+    // the stages write the same files whether or not they run at the same time
+    HashSet<String> files = merger->getMergedFiles();
+    EXPECT_EQ(serialMerger->getMergedFiles().size(), files.size());
+    for (HashSet<String>::iterator file = files.begin(); file != files.end(); ++file) {
+        EXPECT_EQ(serialDir->fileLength(*file), mergedDir->fileLength(*file));
+    }
+
+    EXPECT_TRUE(merger->getStageWork(SegmentMerger::STAGE_STORED_FIELDS) > 0);
+    EXPECT_TRUE(merger->getStageWork(SegmentMerger::STAGE_TERMS) > 0);
+    EXPECT_TRUE(merger->getStageWork(SegmentMerger::STAGE_NORMS) > 0);
+    EXPECT_TRUE(merger->getStageWork(SegmentMerger::STAGE_VECTORS) > 0);
+    EXPECT_EQ(0, merger->getStageWork(SegmentMerger::STAGE_DOC_VALUES));
+
+    SegmentReaderPtr mergedReader = SegmentReader::get(true, newLucene<SegmentInfo>(mergedSegment, 2, mergedDir, false, true), IndexReader::DEFAULT_TERMS_INDEX_DIVISOR);
+    EXPECT_EQ(2, mergedReader->numDocs());
+    EXPECT_TRUE(mergedReader->getTermFreqVectors(0));
+    checkNorms(mergedReader);
+    mergedReader->close();
+}
@@ -19,6 +19,7 @@
 #include "IndexReader.h"
 #include "TermDocs.h"
 #include "Field.h"
+#include "BitVector.h"
 
 using namespace Lucene;
 
@@ -236,3 +237,37 @@ TEST_F(SegmentTermDocsTest, testIndexDivisor) {
     checkBadSeek(2);
     checkSkipTo(2);
 }
+
+TEST_F(SegmentTermDocsTest, testDeletesAfterTermDocs) {
+    dir = newLucene<MockRAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), IndexWriter::MaxFieldLengthLIMITED);
+    for (int32_t i = 0; i < 10; ++i) {
+        DocumentPtr doc = newLucene<Document>();
+        doc->add(newLucene<Field>(L"content", L"aaa", Field::STORE_NO, Field::INDEX_ANALYZED));
+        writer->addDocument(doc);
+    }
+    writer->close();
+
+    SegmentReaderPtr reader = SegmentReader::getOnlySegmentReader(dir);
+    reader->deleteDocument(0);
+    TermDocsPtr tdocs = reader->termDocs(newLucene<Term>(L"content", L"aaa"));
+    BitVectorPtr deletedDocs = reader->getDeletedDocsSnapshot();
+
+    // the deletion goes to a copy, and the copy nobody has read yet is changed in place
+    reader->deleteDocument(1);
+    BitVectorPtr current = reader->deletedDocs;
+    EXPECT_NE(deletedDocs, current);
+    reader->deleteDocument(2);
+    EXPECT_EQ(current, reader->deletedDocs);
+    EXPECT_TRUE(reader->isDeleted(1));
+    EXPECT_TRUE(reader->isDeleted(2));
+    EXPECT_EQ(7, reader->numDocs());
+
+    // the term docs keep reading the deletions as they were when opened
+    EXPECT_TRUE(!deletedDocs->get(1));
+    EXPECT_TRUE(tdocs->next());
+    EXPECT_EQ(1, tdocs->doc());
+    tdocs->close();
+
+    reader->close();
+}
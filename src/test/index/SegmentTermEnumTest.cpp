@@ -101,3 +101,43 @@ TEST_F(SegmentTermEnumTest, testPrevTermAtEnd) {
     EXPECT_TRUE(!termEnum->next());
     EXPECT_EQ(L"bbb", termEnum->prev()->text());
 }
+
+TEST_F(SegmentTermEnumTest, testNonAsciiTermOrder) {
+    // terms are compared as UTF-8 bytes, which must give the same order as comparing the strings
+    static const wchar_t* prefixes[] = {L"a", L"\x00e9", L"\x0800", L"\xe000", L"\xffef", L"\x1f600", L"\x10fff0"};
+    Collection<String> terms = Collection<String>::newInstance();
+    DirectoryPtr dir = newLucene<MockRAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED);
+    for (int32_t i = 0; i < (int32_t)(sizeof(prefixes) / sizeof(prefixes[0])); ++i) {
+        for (int32_t j = 0; j < 100; ++j) {
+            String term(prefixes[i] + StringUtils::toString(j) + prefixes[(i + j) % 7]);
+            terms.add(term);
+            addDoc(writer, term);
+        }
+    }
+    writer->optimize();
+    writer->close();
+    std::sort(terms.begin(), terms.end());
+
+    IndexReaderPtr reader = IndexReader::open(dir, true);
+    TermEnumPtr termEnum = reader->terms();
+    for (Collection<String>::iterator term = terms.begin(); term != terms.end(); ++term) {
+        EXPECT_TRUE(termEnum->next());
+        EXPECT_EQ(*term, termEnum->term()->text());
+    }
+    EXPECT_TRUE(!termEnum->next());
+    termEnum->close();
+
+    // random access lookups, in reverse so that each one seeks
+    for (int32_t i = terms.size() - 1; i >= 0; --i) {
+        EXPECT_EQ(1, reader->docFreq(newLucene<Term>(L"content", terms[i])));
+        termEnum = reader->terms(newLucene<Term>(L"content", terms[i] + L"\x1f600"));
+        if (i < terms.size() - 1) {
+            EXPECT_EQ(terms[i + 1], termEnum->term()->text());
+        } else {
+            EXPECT_TRUE(!termEnum->term());
+        }
+        termEnum->close();
+    }
+    reader->close();
+}
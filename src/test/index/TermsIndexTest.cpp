@@ -0,0 +1,195 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "MockRAMDirectory.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "Term.h"
+#include "TermEnum.h"
+#include "TermBuffer.h"
+
+using namespace Lucene;
+
+typedef LuceneTestFixture TermsIndexTest;
+
+static const wchar_t* FIELDS[] = {L"a", L"b", L"c"};
+static const int32_t NUM_FIELDS = 3;
+
+static String termText(int32_t i) {
+    static const wchar_t* prefixes[] = {L"term", L"terms", L"\x00e9t\x00e9", L"\x1f600"};
+    String number(StringUtils::toString(i));
+    return prefixes[i % 4] + String(5 - number.length(), L'0') + number;
+}
+
+static DirectoryPtr createIndex(Collection<String> terms) {
+    DirectoryPtr dir = newLucene<MockRAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED);
+    writer->setTermIndexInterval(4);
+    for (int32_t i = 0; i < 2000; ++i) {
+        String text(termText(i));
+        terms.add(text);
+        DocumentPtr doc = newLucene<Document>();
+        for (int32_t field = 0; field < NUM_FIELDS; ++field) {
+            doc->add(newLucene<Field>(FIELDS[field], text, Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+        }
+        writer->addDocument(doc);
+    }
+    writer->optimize();
+    writer->close();
+    std::sort(terms.begin(), terms.end());
+    return dir;
+}
+
+static void checkSeek(const IndexReaderPtr& reader, const TermPtr& target, const TermPtr& expected) {
+    TermEnumPtr termEnum = reader->terms(target);
+    if (expected) {
+        EXPECT_TRUE(termEnum->term() && expected->equals(termEnum->term()));
+    } else {
+        EXPECT_TRUE(!termEnum->term());
+    }
+    termEnum->close();
+}
+
+TEST_F(TermsIndexTest, testLookups) {
+    Collection<String> terms = Collection<String>::newInstance();
+    DirectoryPtr dir = createIndex(terms);
+    static const int32_t divisors[] = {1, 2, 5};
+    for (int32_t d = 0; d < (int32_t)(sizeof(divisors) / sizeof(divisors[0])); ++d) {
+        IndexReaderPtr reader = IndexReader::open(dir, IndexDeletionPolicyPtr(), true, divisors[d]);
+
+        TermEnumPtr termEnum = reader->terms();
+        for (int32_t field = 0; field < NUM_FIELDS; ++field) {
+            for (Collection<String>::iterator term = terms.begin(); term != terms.end(); ++term) {
+                EXPECT_TRUE(termEnum->next());
+                EXPECT_EQ(FIELDS[field], termEnum->term()->field());
+                EXPECT_EQ(*term, termEnum->term()->text());
+            }
+        }
+        EXPECT_TRUE(!termEnum->next());
+        termEnum->close();
+
+        for (int32_t field = 0; field < NUM_FIELDS; ++field) {
+            // backwards, so that every lookup seeks
+            for (int32_t i = terms.size() - 1; i >= 0; --i) {
+                EXPECT_EQ(1, reader->docFreq(newLucene<Term>(FIELDS[field], terms[i])));
+                EXPECT_EQ(0, reader->docFreq(newLucene<Term>(FIELDS[field], terms[i] + L"0")));
+                checkSeek(reader, newLucene<Term>(FIELDS[field], terms[i]), newLucene<Term>(FIELDS[field], terms[i]));
+            }
+
+            // seek by prefix
+            checkSeek(reader, newLucene<Term>(FIELDS[field], L""), newLucene<Term>(FIELDS[field], terms[0]));
+            checkSeek(reader, newLucene<Term>(FIELDS[field], L"term"), newLucene<Term>(FIELDS[field], L"term00000"));
+            checkSeek(reader, newLucene<Term>(FIELDS[field], L"terms"), newLucene<Term>(FIELDS[field], L"terms00001"));
+            checkSeek(reader, newLucene<Term>(FIELDS[field], L"term01"), newLucene<Term>(FIELDS[field], L"term01000"));
+            checkSeek(reader, newLucene<Term>(FIELDS[field], L"terms0199"), newLucene<Term>(FIELDS[field], L"terms01993"));
+            checkSeek(reader, newLucene<Term>(FIELDS[field], L"\x00e9t\x00e9"), newLucene<Term>(FIELDS[field], L"\x00e9t\x00e9" L"00002"));
+            checkSeek(reader, newLucene<Term>(FIELDS[field], L"\x1f600"), newLucene<Term>(FIELDS[field], L"\x1f600" L"00003"));
+        }
+
+        // fields without terms
+        checkSeek(reader, newLucene<Term>(L"aa", L"term"), newLucene<Term>(L"b", terms[0]));
+        checkSeek(reader, newLucene<Term>(L"b", terms[terms.size() - 1] + L"0"), newLucene<Term>(L"c", terms[0]));
+        checkSeek(reader, newLucene<Term>(L"d", L""), TermPtr());
+        EXPECT_EQ(0, reader->docFreq(newLucene<Term>(L"aa", L"term00000")));
+
+        reader->close();
+    }
+    dir->close();
+}
+
+TEST_F(TermsIndexTest, testTermOrderMatchesStringOrder) {
+    // the characters from U+E000 sort after the surrogates in UTF-16 but before them in UTF-8
+    static const wchar_t* texts[] = {L"a", L"\x00e9", L"\xd7ff", L"\xe000", L"\xe000z", L"\xfb01", L"\xfffd", L"\U00010400", L"\U0001f600", L"\U0001f600z"};
+    int32_t count = (int32_t)(sizeof(texts) / sizeof(texts[0]));
+    Collection<String> terms = Collection<String>::newInstance();
+    for (int32_t i = 0; i < count; ++i) {
+        for (int32_t j = 0; j < 100; ++j) {
+            terms.add(texts[i] + StringUtils::toString(j));
+        }
+    }
+
+    for (int32_t i = 0; i < count; ++i) {
+        for (int32_t j = 0; j < count; ++j) {
+            String text1(texts[i]);
+            String text2(texts[j]);
+            ByteArray bytes1(ByteArray::newInstance(text1.length() * 4));
+            ByteArray bytes2(ByteArray::newInstance(text2.length() * 4));
+            int32_t length1 = StringUtils::toUTF8(text1.c_str(), text1.length(), bytes1);
+            int32_t length2 = StringUtils::toUTF8(text2.c_str(), text2.length(), bytes2);
+            int32_t expected = text1.compare(text2);
+            int32_t actual = TermBuffer::compareBytes(bytes1.get(), length1, bytes2.get(), length2);
+            EXPECT_EQ(expected < 0, actual < 0);
+            EXPECT_EQ(expected == 0, actual == 0);
+        }
+    }
+
+    DirectoryPtr dir = newLucene<MockRAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED);
+    writer->setTermIndexInterval(4);
+    for (Collection<String>::iterator term = terms.begin(); term != terms.end(); ++term) {
+        DocumentPtr doc = newLucene<Document>();
+        doc->add(newLucene<Field>(L"a", *term, Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+        writer->addDocument(doc);
+    }
+    writer->optimize();
+    writer->close();
+    std::sort(terms.begin(), terms.end());
+
+    IndexReaderPtr reader = IndexReader::open(dir, true);
+    TermEnumPtr termEnum = reader->terms();
+    for (Collection<String>::iterator term = terms.begin(); term != terms.end(); ++term) {
+        EXPECT_TRUE(termEnum->next());
+        EXPECT_EQ(*term, termEnum->term()->text());
+    }
+    EXPECT_TRUE(!termEnum->next());
+    termEnum->close();
+    for (int32_t i = terms.size() - 1; i >= 0; --i) {
+        EXPECT_EQ(1, reader->docFreq(newLucene<Term>(L"a", terms[i])));
+        checkSeek(reader, newLucene<Term>(L"a", terms[i]), newLucene<Term>(L"a", terms[i]));
+    }
+    reader->close();
+    dir->close();
+}
+
+TEST_F(TermsIndexTest, testBlockMixesSurrogateAndPrivateUseTerms) {
+    // fewer terms than a block, all indexed, so that the scan within the block compares them
+    static const wchar_t* texts[] = {L"x", L"xa", L"x\xd7ff", L"x\xe000", L"x\xe000" L"a", L"x\xfffd", L"x\U00010400", L"x\U0001f600", L"x\U0001f600a", L"y"};
+    int32_t count = (int32_t)(sizeof(texts) / sizeof(texts[0]));
+    DirectoryPtr dir = newLucene<MockRAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED);
+    writer->setTermIndexInterval(1);
+    Collection<String> terms = Collection<String>::newInstance();
+    for (int32_t i = 0; i < count; ++i) {
+        terms.add(texts[i]);
+        DocumentPtr doc = newLucene<Document>();
+        doc->add(newLucene<Field>(L"a", texts[i], Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+        writer->addDocument(doc);
+    }
+    writer->optimize();
+    writer->close();
+    std::sort(terms.begin(), terms.end());
+
+    IndexReaderPtr reader = IndexReader::open(dir, true);
+    for (int32_t i = 0; i < count; ++i) {
+        EXPECT_EQ(1, reader->docFreq(newLucene<Term>(L"a", terms[i])));
+        checkSeek(reader, newLucene<Term>(L"a", terms[i]), newLucene<Term>(L"a", terms[i]));
+    }
+    // terms between those of the two ranges seek to the next one in string order
+    static const wchar_t* missing[] = {L"x\xe001", L"x\xfff0", L"x\U00010401", L"x\U0001f600b"};
+    for (int32_t i = 0; i < (int32_t)(sizeof(missing) / sizeof(missing[0])); ++i) {
+        String text(missing[i]);
+        EXPECT_EQ(0, reader->docFreq(newLucene<Term>(L"a", text)));
+        Collection<String>::iterator next = std::upper_bound(terms.begin(), terms.end(), text);
+        checkSeek(reader, newLucene<Term>(L"a", text), newLucene<Term>(L"a", *next));
+    }
+    reader->close();
+    dir->close();
+}
@@ -0,0 +1,283 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "MockRAMDirectory.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "TieredMergePolicy.h"
+#include "SerialMergeScheduler.h"
+#include "ConcurrentMergeScheduler.h"
+#include "MergePolicy.h"
+#include "MergeDocIDRemapper.h"
+#include "SegmentInfos.h"
+#include "SegmentInfo.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "Term.h"
+#include "TermDocs.h"
+#include "Random.h"
+
+using namespace Lucene;
+
+typedef LuceneTestFixture TieredMergePolicyTest;
+
+static DocumentPtr createDocument(int32_t id) {
+    DocumentPtr doc = newLucene<Document>();
+    doc->add(newLucene<Field>(L"id", StringUtils::toString(id), Field::STORE_YES, Field::INDEX_NOT_ANALYZED));
+    doc->add(newLucene<Field>(L"content", L"aaa " + StringUtils::toString(id % 7), Field::STORE_NO, Field::INDEX_ANALYZED));
+    return doc;
+}
+
+/// Checks that no id maps to more than one document and that the documents store their ids, returns the
+/// number of ids found.
+static int32_t checkIds(const IndexReaderPtr& reader, int32_t numIds) {
+    int32_t found = 0;
+    for (int32_t id = 0; id < numIds; ++id) {
+        TermDocsPtr termDocs = reader->termDocs(newLucene<Term>(L"id", StringUtils::toString(id)));
+        if (termDocs->next()) {
+            EXPECT_EQ(StringUtils::toString(id), reader->document(termDocs->doc())->get(L"id"));
+            EXPECT_TRUE(!termDocs->next());
+            ++found;
+        }
+        termDocs->close();
+    }
+    return found;
+}
+
+TEST_F(TieredMergePolicyTest, testExpungeDeletes) {
+    DirectoryPtr dir = newLucene<MockRAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthUNLIMITED);
+    TieredMergePolicyPtr tmp = newLucene<TieredMergePolicy>(writer);
+    tmp->setMaxMergeAtOnce(100);
+    tmp->setSegmentsPerTier(100);
+    tmp->setExpungeDeletesPctAllowed(30.0);
+    writer->setMergePolicy(tmp);
+    writer->setMergeScheduler(newLucene<SerialMergeScheduler>());
+    writer->setMaxBufferedDocs(4);
+
+    for (int32_t i = 0; i < 80; ++i) {
+        writer->addDocument(createDocument(i));
+    }
+    writer->commit();
+    EXPECT_EQ(20, writer->getSegmentCount());
+
+    // half of the documents of every other segment of the first ten, and one of the eleventh
+    for (int32_t i = 0; i < 40; i += 8) {
+        writer->deleteDocuments(newLucene<Term>(L"id", StringUtils::toString(i)));
+        writer->deleteDocuments(newLucene<Term>(L"id", StringUtils::toString(i + 1)));
+    }
+    writer->deleteDocuments(newLucene<Term>(L"id", L"40"));
+    writer->commit();
+    EXPECT_EQ(69, writer->numDocs());
+
+    // the five segments over the threshold, which aren't adjacent, are merged into one
+    writer->expungeDeletes();
+    EXPECT_EQ(16, writer->getSegmentCount());
+    writer->close();
+
+    IndexReaderPtr reader = IndexReader::open(dir, true);
+    EXPECT_EQ(69, reader->numDocs());
+    EXPECT_EQ(1, reader->numDeletedDocs());
+    EXPECT_EQ(69, checkIds(reader, 80));
+    for (int32_t i = 0; i < 40; i += 8) {
+        EXPECT_EQ(0, reader->docFreq(newLucene<Term>(L"id", StringUtils::toString(i))));
+    }
+    reader->close();
+    dir->close();
+}
+
+TEST_F(TieredMergePolicyTest, testOptimize) {
+    DirectoryPtr dir = newLucene<MockRAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthUNLIMITED);
+    TieredMergePolicyPtr tmp = newLucene<TieredMergePolicy>(writer);
+    tmp->setMaxMergeAtOnce(100);
+    tmp->setSegmentsPerTier(100);
+    tmp->setMaxMergeAtOnceExplicit(4);
+    writer->setMergePolicy(tmp);
+    writer->setMaxBufferedDocs(2);
+
+    for (int32_t i = 0; i < 40; ++i) {
+        writer->addDocument(createDocument(i));
+    }
+    writer->commit();
+    EXPECT_EQ(20, writer->getSegmentCount());
+
+    writer->optimize(5);
+    EXPECT_TRUE(writer->getSegmentCount() <= 5);
+    writer->optimize();
+    EXPECT_EQ(1, writer->getSegmentCount());
+    writer->close();
+
+    IndexReaderPtr reader = IndexReader::open(dir, true);
+    EXPECT_EQ(40, reader->numDocs());
+    EXPECT_EQ(40, checkIds(reader, 40));
+    reader->close();
+    dir->close();
+}
+
+TEST_F(TieredMergePolicyTest, testSegmentCountIsBounded) {
+    DirectoryPtr dir = newLucene<MockRAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthUNLIMITED);
+    TieredMergePolicyPtr tmp = newLucene<TieredMergePolicy>(writer);
+    tmp->setMaxMergeAtOnce(3);
+    tmp->setSegmentsPerTier(3);
+    writer->setMergePolicy(tmp);
+    writer->setMergeScheduler(newLucene<SerialMergeScheduler>());
+    writer->setMaxBufferedDocs(2);
+
+    RandomPtr random = newLucene<Random>(17);
+    for (int32_t i = 0; i < 500; ++i) {
+        // updates delete the previous version of their document
+        int32_t id = random->nextInt(200);
+        writer->updateDocument(newLucene<Term>(L"id", StringUtils::toString(id)), createDocument(id));
+        // every segment is below the floor size, so they all make up one tier
+        EXPECT_TRUE(writer->getSegmentCount() <= 4);
+    }
+    writer->close();
+
+    IndexReaderPtr reader = IndexReader::open(dir, true);
+    EXPECT_EQ(reader->numDocs(), checkIds(reader, 200));
+    reader->close();
+    dir->close();
+}
+
+TEST_F(TieredMergePolicyTest, testMaxMergedSegmentSize) {
+    DirectoryPtr dir = newLucene<MockRAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthUNLIMITED);
+    TieredMergePolicyPtr tmp = newLucene<TieredMergePolicy>(writer);
+    tmp->setMaxMergeAtOnce(2);
+    tmp->setSegmentsPerTier(2);
+    tmp->setFloorSegmentMB(0.001);
+    tmp->setMaxMergedSegmentMB(0.01);
+    writer->setMergePolicy(tmp);
+    writer->setMergeScheduler(newLucene<SerialMergeScheduler>());
+    writer->setMaxBufferedDocs(10);
+
+    for (int32_t i = 0; i < 1000; ++i) {
+        writer->addDocument(createDocument(i));
+    }
+    writer->commit();
+
+    // no merge produced a segment much over the limit, so many segments remain
+    SegmentInfosPtr infos = newLucene<SegmentInfos>();
+    infos->read(dir);
+    EXPECT_TRUE(infos->size() > 1);
+    for (int32_t i = 0; i < infos->size(); ++i) {
+        EXPECT_TRUE(infos->info(i)->sizeInBytes() < 2 * 1024 * 1024 * tmp->getMaxMergedSegmentMB());
+    }
+    writer->close();
+
+    IndexReaderPtr reader = IndexReader::open(dir, true);
+    EXPECT_EQ(1000, reader->numDocs());
+    EXPECT_EQ(1000, checkIds(reader, 1000));
+    reader->close();
+    dir->close();
+}
+
+TEST_F(TieredMergePolicyTest, testConcurrentUpdates) {
+    DirectoryPtr dir = newLucene<MockRAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthUNLIMITED);
+    TieredMergePolicyPtr tmp = newLucene<TieredMergePolicy>(writer);
+    tmp->setMaxMergeAtOnce(4);
+    tmp->setSegmentsPerTier(4);
+    writer->setMergePolicy(tmp);
+    ConcurrentMergeSchedulerPtr cms = newLucene<ConcurrentMergeScheduler>();
+    cms->setMaxThreadCount(2);
+    writer->setMergeScheduler(cms);
+    writer->setMaxBufferedDocs(3);
+
+    RandomPtr random = newLucene<Random>(42);
+    for (int32_t i = 0; i < 1000; ++i) {
+        int32_t id = random->nextInt(300);
+        writer->updateDocument(newLucene<Term>(L"id", StringUtils::toString(id)), createDocument(id));
+    }
+    writer->expungeDeletes();
+    writer->close();
+
+    IndexReaderPtr reader = IndexReader::open(dir, true);
+    EXPECT_EQ(reader->numDocs(), checkIds(reader, 300));
+    reader->close();
+    dir->close();
+}
+
+TEST_F(TieredMergePolicyTest, testSetters) {
+    DirectoryPtr dir = newLucene<MockRAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthUNLIMITED);
+    TieredMergePolicyPtr tmp = newLucene<TieredMergePolicy>(writer);
+
+    tmp->setMaxMergedSegmentMB(0.5);
+    EXPECT_NEAR(0.5, tmp->getMaxMergedSegmentMB(), 0.00001);
+    tmp->setMaxMergedSegmentMB(DBL_MAX);
+    EXPECT_NEAR((double)LLONG_MAX / 1024.0 / 1024.0, tmp->getMaxMergedSegmentMB(), 1.0);
+    tmp->setFloorSegmentMB(2.0);
+    EXPECT_NEAR(2.0, tmp->getFloorSegmentMB(), 0.00001);
+
+    try {
+        tmp->setMaxMergeAtOnce(1);
+    } catch (IllegalArgumentException& e) {
+        EXPECT_TRUE(check_exception(LuceneException::IllegalArgument)(e));
+    }
+    try {
+        tmp->setMaxMergedSegmentMB(0.0);
+    } catch (IllegalArgumentException& e) {
+        EXPECT_TRUE(check_exception(LuceneException::IllegalArgument)(e));
+    }
+    try {
+        tmp->setSegmentsPerTier(1.0);
+    } catch (IllegalArgumentException& e) {
+        EXPECT_TRUE(check_exception(LuceneException::IllegalArgument)(e));
+    }
+    try {
+        tmp->setExpungeDeletesPctAllowed(101.0);
+    } catch (IllegalArgumentException& e) {
+        EXPECT_TRUE(check_exception(LuceneException::IllegalArgument)(e));
+    }
+    EXPECT_EQ(10, tmp->getMaxMergeAtOnce());
+    EXPECT_EQ(10.0, tmp->getSegmentsPerTier());
+    EXPECT_EQ(10.0, tmp->getExpungeDeletesPctAllowed());
+    writer->close();
+    dir->close();
+}
+
+TEST_F(TieredMergePolicyTest, testRemapNonAdjacentMerge) {
+    DirectoryPtr dir = newLucene<MockRAMDirectory>();
+    SegmentInfosPtr infos = newLucene<SegmentInfos>();
+    infos->add(newLucene<SegmentInfo>(L"_0", 10, dir));
+    infos->add(newLucene<SegmentInfo>(L"_1", 5, dir));
+    infos->add(newLucene<SegmentInfo>(L"_2", 8, dir));
+
+    // merge _2, which has two deletions, with _0, skipping _1
+    SegmentInfosPtr mergeInfos = newLucene<SegmentInfos>();
+    mergeInfos->add(infos->info(2));
+    mergeInfos->add(infos->info(0));
+    OneMergePtr merge = newLucene<OneMerge>(mergeInfos, false);
+    Collection< Collection<int32_t> > docMaps = Collection< Collection<int32_t> >::newInstance(2);
+    docMaps[0] = Collection<int32_t>::newInstance();
+    static const int32_t docMap[] = {0, -1, 1, -1, 2, 3, 4, 5};
+    docMaps[0].addAll(docMap, docMap + 8);
+    Collection<int32_t> delCounts = Collection<int32_t>::newInstance(2);
+    delCounts[0] = 2;
+    delCounts[1] = 0;
+
+    MergeDocIDRemapperPtr remapper = newLucene<MergeDocIDRemapper>(infos, docMaps, delCounts, merge, 16);
+    EXPECT_EQ(2, remapper->docShift);
+
+    // the merged segment, _2 then _0, takes the place of _0
+    EXPECT_EQ(6, remapper->remap(0));
+    EXPECT_EQ(15, remapper->remap(9));
+    EXPECT_EQ(16, remapper->remap(10));
+    EXPECT_EQ(20, remapper->remap(14));
+    EXPECT_EQ(0, remapper->remap(15));
+    EXPECT_EQ(1, remapper->remap(17));
+    EXPECT_EQ(5, remapper->remap(22));
+
+    // buffered documents shift down by the deletions
+    EXPECT_EQ(21, remapper->remap(23));
+    dir->close();
+}
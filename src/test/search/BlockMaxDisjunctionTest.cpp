@@ -0,0 +1,294 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "MockRAMDirectory.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "IndexSearcher.h"
+#include "SegmentReader.h"
+#include "SegmentTermDocs.h"
+#include "TermInfosWriter.h"
+#include "IndexInput.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "Term.h"
+#include "TermDocs.h"
+#include "TermQuery.h"
+#include "TermScorer.h"
+#include "Weight.h"
+#include "BooleanQuery.h"
+#include "PrefixQuery.h"
+#include "TopDocs.h"
+#include "ScoreDoc.h"
+#include "ThreadPool.h"
+#include "Random.h"
+
+using namespace Lucene;
+
+typedef LuceneTestFixture BlockMaxDisjunctionTest;
+
+static DirectoryPtr createIndex(bool useBlockPostings, bool optimize, bool useSkipImpacts = true) {
+    DirectoryPtr dir = newLucene<MockRAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED);
+    writer->setUseBlockPostings(useBlockPostings);
+    writer->setUseSkipImpacts(useSkipImpacts);
+    writer->setMaxBufferedDocs(1000);
+    RandomPtr random = newLucene<Random>(17);
+    for (int32_t i = 0; i < 5000; ++i) {
+        String body;
+        int32_t fillers = random->nextInt(20);
+        for (int32_t j = 0; j < fillers; ++j) {
+            body += L"filler ";
+        }
+        if (random->nextInt(10) != 0) {
+            for (int32_t j = random->nextInt(3); j >= 0; --j) {
+                body += L"common ";
+            }
+        }
+        if (random->nextInt(3) == 0) {
+            for (int32_t j = random->nextInt(5); j >= 0; --j) {
+                body += L"medium ";
+            }
+        }
+        if (random->nextInt(40) == 0) {
+            for (int32_t j = random->nextInt(10); j >= 0; --j) {
+                body += L"rare ";
+            }
+        }
+        DocumentPtr doc = newLucene<Document>();
+        doc->add(newLucene<Field>(L"body", body, Field::STORE_NO, Field::INDEX_ANALYZED));
+        FieldPtr noTf = newLucene<Field>(L"notf", body, Field::STORE_NO, Field::INDEX_ANALYZED);
+        noTf->setOmitTermFreqAndPositions(true);
+        doc->add(noTf);
+        writer->addDocument(doc);
+    }
+    if (optimize) {
+        writer->optimize();
+    }
+    writer->close();
+    return dir;
+}
+
+static BooleanQueryPtr disjunction(const String& field, const String& terms) {
+    BooleanQueryPtr query = newLucene<BooleanQuery>();
+    Collection<String> words(StringUtils::split(terms, L" "));
+    for (Collection<String>::iterator word = words.begin(); word != words.end(); ++word) {
+        query->add(newLucene<TermQuery>(newLucene<Term>(field, *word)), BooleanClause::SHOULD);
+    }
+    return query;
+}
+
+static void checkSameTopHits(const IndexSearcherPtr& expectedSearcher, const IndexSearcherPtr& actualSearcher, const QueryPtr& query, int32_t n) {
+    TopDocsPtr expected = expectedSearcher->search(query, n);
+    TopDocsPtr actual = actualSearcher->search(query, n);
+    EXPECT_TRUE(!expected->totalHitsIsLowerBound);
+    EXPECT_TRUE(actual->totalHitsIsLowerBound);
+    EXPECT_TRUE(actual->totalHits <= expected->totalHits);
+    EXPECT_EQ(expected->scoreDocs.size(), actual->scoreDocs.size());
+    for (int32_t i = 0; i < std::min(expected->scoreDocs.size(), actual->scoreDocs.size()); ++i) {
+        EXPECT_EQ(expected->scoreDocs[i]->doc, actual->scoreDocs[i]->doc);
+        EXPECT_EQ(expected->scoreDocs[i]->score, actual->scoreDocs[i]->score);
+    }
+}
+
+static void checkSameTopHits(const IndexReaderPtr& reader) {
+    IndexSearcherPtr expectedSearcher = newLucene<IndexSearcher>(reader);
+    IndexSearcherPtr actualSearcher = newLucene<IndexSearcher>(reader);
+    actualSearcher->setTotalHitsLowerBound(true);
+    static const wchar_t* queries[] = {L"common rare", L"common medium", L"common medium rare", L"filler rare", L"rare missing", L"common filler medium rare"};
+    static const int32_t hits[] = {1, 10, 100};
+    for (int32_t i = 0; i < (int32_t)(sizeof(queries) / sizeof(queries[0])); ++i) {
+        for (int32_t j = 0; j < (int32_t)(sizeof(hits) / sizeof(hits[0])); ++j) {
+            checkSameTopHits(expectedSearcher, actualSearcher, disjunction(L"body", queries[i]), hits[j]);
+            checkSameTopHits(expectedSearcher, actualSearcher, disjunction(L"notf", queries[i]), hits[j]);
+        }
+    }
+}
+
+TEST_F(BlockMaxDisjunctionTest, testBlockMaxFreqs) {
+    DirectoryPtr dir = createIndex(true, true);
+    IndexReaderPtr reader = IndexReader::open(dir, true);
+    SegmentReaderPtr segmentReader = SegmentReader::getOnlySegmentReader(reader);
+    static const wchar_t* terms[] = {L"common", L"medium", L"filler"};
+    for (int32_t i = 0; i < (int32_t)(sizeof(terms) / sizeof(terms[0])); ++i) {
+        TermPtr term = newLucene<Term>(L"body", terms[i]);
+        SegmentTermDocsPtr impacts = boost::dynamic_pointer_cast<SegmentTermDocs>(segmentReader->termDocs(term));
+        TermDocsPtr termDocs = segmentReader->termDocs(term);
+        int32_t maxFreq = 0;
+        int32_t blockEnd = -1;
+        int32_t blocks = 0;
+        while (termDocs->next()) {
+            if (termDocs->doc() > blockEnd) {
+                blockEnd = impacts->advanceShallow(termDocs->doc());
+                ++blocks;
+            }
+            EXPECT_TRUE(termDocs->doc() <= blockEnd);
+            EXPECT_TRUE(termDocs->freq() <= impacts->getBlockMaxFreq());
+            maxFreq = std::max(maxFreq, termDocs->freq());
+        }
+        EXPECT_EQ(maxFreq, impacts->getMaxFreq());
+        EXPECT_TRUE(blocks > 1);
+    }
+    reader->close();
+    dir->close();
+}
+
+/// Checks that every doc of the term is covered by one of the impacts of its interval
+static void checkBlockImpacts(const SegmentReaderPtr& reader, const TermPtr& term) {
+    ByteArray norms = reader->norms(term->field());
+    SegmentTermDocsPtr impacts = boost::dynamic_pointer_cast<SegmentTermDocs>(reader->termDocs(term));
+    TermDocsPtr termDocs = reader->termDocs(term);
+    int32_t blockEnd = -1;
+    Collection<int32_t> blockImpacts;
+    while (termDocs->next()) {
+        if (termDocs->doc() > blockEnd) {
+            blockEnd = impacts->advanceShallow(termDocs->doc());
+            blockImpacts = impacts->getBlockImpacts();
+            EXPECT_TRUE(!blockImpacts.empty());
+            for (int32_t i = 2; i < blockImpacts.size(); i += 2) {
+                // competitive pairs are ordered by descending norm and ascending freq
+                EXPECT_TRUE(blockImpacts[i] > blockImpacts[i - 2]);
+                EXPECT_TRUE(blockImpacts[i + 1] < blockImpacts[i - 1]);
+            }
+        }
+        bool covered = false;
+        for (int32_t i = 0; i < blockImpacts.size() && !covered; i += 2) {
+            covered = (termDocs->freq() <= blockImpacts[i] && norms[termDocs->doc()] <= blockImpacts[i + 1]);
+        }
+        EXPECT_TRUE(covered);
+    }
+}
+
+TEST_F(BlockMaxDisjunctionTest, testBlockImpacts) {
+    for (int32_t blockPostings = 0; blockPostings < 2; ++blockPostings) {
+        DirectoryPtr dir = createIndex(blockPostings == 1, true);
+        IndexReaderPtr reader = IndexReader::open(dir, false);
+        SegmentReaderPtr segmentReader = SegmentReader::getOnlySegmentReader(reader);
+        static const wchar_t* terms[] = {L"common", L"medium", L"filler", L"rare"};
+        for (int32_t i = 0; i < (int32_t)(sizeof(terms) / sizeof(terms[0])); ++i) {
+            checkBlockImpacts(segmentReader, newLucene<Term>(L"body", terms[i]));
+        }
+
+        // docs of a block hold different norms, so a block bound is below the bound using the field's largest norm
+        TermQueryPtr query = newLucene<TermQuery>(newLucene<Term>(L"body", L"common"));
+        IndexSearcherPtr searcher = newLucene<IndexSearcher>(reader);
+        TermScorerPtr scorer = boost::dynamic_pointer_cast<TermScorer>(query->weight(searcher)->scorer(segmentReader, true, false));
+        SegmentTermDocsPtr impacts = boost::dynamic_pointer_cast<SegmentTermDocs>(segmentReader->termDocs(query->getTerm()));
+        impacts->advanceShallow(0);
+        Collection<int32_t> blockImpacts = impacts->getBlockImpacts();
+        double blockBound = 0.0;
+        for (int32_t i = 0; i < blockImpacts.size(); i += 2) {
+            blockBound = std::max(blockBound, scorer->getMaxScore(blockImpacts[i], blockImpacts[i + 1]));
+        }
+        EXPECT_TRUE(blockBound < scorer->getMaxScore(impacts->getBlockMaxFreq(), segmentReader->maxNorm(L"body")));
+
+        // norms set after the segment was written aren't in the impacts, so they are bounded by the largest norm
+        reader->setNorm(0, L"body", (uint8_t)255);
+        reader->setNorm(1, L"body", (uint8_t)255);
+        for (int32_t i = 0; i < (int32_t)(sizeof(terms) / sizeof(terms[0])); ++i) {
+            checkBlockImpacts(segmentReader, newLucene<Term>(L"body", terms[i]));
+        }
+        reader->close();
+        dir->close();
+    }
+}
+
+TEST_F(BlockMaxDisjunctionTest, testSameTopHits) {
+    for (int32_t blockPostings = 0; blockPostings < 2; ++blockPostings) {
+        DirectoryPtr dir = createIndex(blockPostings == 1, false);
+        IndexReaderPtr reader = IndexReader::open(dir, false);
+        EXPECT_TRUE(reader->getSequentialSubReaders().size() > 1);
+        checkSameTopHits(reader);
+
+        // deleted docs are still counted by the max freqs
+        for (int32_t i = 0; i < reader->maxDoc(); i += 3) {
+            reader->deleteDocument(i);
+        }
+        checkSameTopHits(reader);
+
+        // raised norms aren't in the impacts of the skip data
+        for (int32_t i = 1; i < reader->maxDoc(); i += 50) {
+            reader->setNorm(i, L"body", (uint8_t)255);
+        }
+        checkSameTopHits(reader);
+        reader->close();
+        dir->close();
+    }
+}
+
+TEST_F(BlockMaxDisjunctionTest, testSkipsUncompetitiveDocs) {
+    DirectoryPtr dir = createIndex(true, true);
+    IndexSearcherPtr searcher = newLucene<IndexSearcher>(dir, true);
+    QueryPtr query = disjunction(L"body", L"common rare");
+    int32_t exactHits = searcher->search(query, 10)->totalHits;
+    searcher->setTotalHitsLowerBound(true);
+    TopDocsPtr topDocs = searcher->search(query, 10);
+    EXPECT_TRUE(topDocs->totalHitsIsLowerBound);
+    EXPECT_TRUE(topDocs->totalHits < exactHits);
+    searcher->close();
+    dir->close();
+}
+
+TEST_F(BlockMaxDisjunctionTest, testConcurrentSearch) {
+    DirectoryPtr dir = createIndex(false, false);
+    IndexReaderPtr reader = IndexReader::open(dir, true);
+    IndexSearcherPtr expectedSearcher = newLucene<IndexSearcher>(reader);
+    IndexSearcherPtr actualSearcher = newLucene<IndexSearcher>(reader, newLucene<ThreadPool>(2));
+    actualSearcher->setTotalHitsLowerBound(true);
+    checkSameTopHits(expectedSearcher, actualSearcher, disjunction(L"body", L"common medium rare"), 10);
+    reader->close();
+    dir->close();
+}
+
+TEST_F(BlockMaxDisjunctionTest, testUnsupportedQueries) {
+    DirectoryPtr dir = createIndex(false, true);
+    IndexSearcherPtr searcher = newLucene<IndexSearcher>(dir, true);
+
+    // required clauses and non-term clauses are scored exhaustively
+    BooleanQueryPtr query = disjunction(L"body", L"common rare");
+    query->add(newLucene<TermQuery>(newLucene<Term>(L"body", L"medium")), BooleanClause::MUST);
+    int32_t exactHits = searcher->search(query, 10)->totalHits;
+    searcher->setTotalHitsLowerBound(true);
+    EXPECT_EQ(exactHits, searcher->search(query, 10)->totalHits);
+
+    query = disjunction(L"body", L"common rare");
+    query->add(newLucene<PrefixQuery>(newLucene<Term>(L"body", L"med")), BooleanClause::SHOULD);
+    searcher->setTotalHitsLowerBound(false);
+    exactHits = searcher->search(query, 10)->totalHits;
+    searcher->setTotalHitsLowerBound(true);
+    EXPECT_EQ(exactHits, searcher->search(query, 10)->totalHits);
+
+    searcher->close();
+    dir->close();
+}
+
+TEST_F(BlockMaxDisjunctionTest, testNoImpactsByDefault) {
+    DirectoryPtr dir = createIndex(false, true, false);
+    IndexReaderPtr reader = IndexReader::open(dir, true);
+    SegmentReaderPtr segmentReader = SegmentReader::getOnlySegmentReader(reader);
+
+    // written in the format older versions read
+    IndexInputPtr input = dir->openInput(segmentReader->getSegmentName() + L".tis");
+    EXPECT_EQ(TermInfosWriter::FORMAT_VERSION_UTF8_LENGTH_IN_BYTES, input->readInt());
+    input->close();
+
+    SegmentTermDocsPtr impacts = boost::dynamic_pointer_cast<SegmentTermDocs>(segmentReader->termDocs(newLucene<Term>(L"body", L"common")));
+    EXPECT_EQ(-1, impacts->getMaxFreq());
+
+    // searched without skipping
+    IndexSearcherPtr searcher = newLucene<IndexSearcher>(reader);
+    searcher->setTotalHitsLowerBound(true);
+    QueryPtr query = disjunction(L"body", L"common rare");
+    TopDocsPtr topDocs = searcher->search(query, 10);
+    searcher->setTotalHitsLowerBound(false);
+    EXPECT_EQ(searcher->search(query, 10)->totalHits, topDocs->totalHits);
+
+    reader->close();
+    dir->close();
+}
@@ -19,6 +19,11 @@
 #include "TopDocs.h"
 #include "Similarity.h"
 #include "BooleanScorer.h"
+#include "Weight.h"
+#include "IndexReader.h"
+#include "TopScoreDocCollector.h"
+#include "Random.h"
+#include "MiscUtils.h"
 
 using namespace Lucene;
 
@@ -99,3 +104,75 @@ TEST_F(BooleanScorerTest, testEmptyBucketWithMoreDocs) {
     EXPECT_EQ(3000, bs->nextDoc());
     EXPECT_EQ(DocIdSetIterator::NO_MORE_DOCS, bs->nextDoc());
 }
+
+/// Scores the query with BooleanScorer and BooleanScorer2, through both collect and nextDoc, over several bucket table windows.
+static void checkScorers(const IndexSearcherPtr& searcher, const BooleanQueryPtr& query) {
+    int32_t maxDoc = searcher->maxDoc();
+    TopScoreDocCollectorPtr outOfOrder = TopScoreDocCollector::create(maxDoc, false);
+    TopScoreDocCollectorPtr inOrder = TopScoreDocCollector::create(maxDoc, true);
+    searcher->search(query, outOfOrder);
+    searcher->search(query, inOrder);
+    Collection<ScoreDocPtr> expected = inOrder->topDocs()->scoreDocs;
+    Collection<ScoreDocPtr> actual = outOfOrder->topDocs()->scoreDocs;
+    EXPECT_EQ(expected.size(), actual.size());
+    MapIntDouble expectedScores(MapIntDouble::newInstance());
+    for (int32_t i = 0; i < expected.size(); ++i) {
+        expectedScores.put(expected[i]->doc, expected[i]->score);
+    }
+    for (int32_t i = 0; i < actual.size(); ++i) {
+        EXPECT_TRUE(expectedScores.contains(actual[i]->doc));
+        EXPECT_NEAR(expectedScores.get(actual[i]->doc), actual[i]->score, 0.00001);
+    }
+
+    WeightPtr weight = query->weight(searcher);
+    ScorerPtr scorer = weight->scorer(searcher->getIndexReader(), false, true);
+    int32_t count = 0;
+    if (scorer) {
+        EXPECT_TRUE(MiscUtils::typeOf<BooleanScorer>(scorer));
+        for (int32_t doc = scorer->nextDoc(); doc != DocIdSetIterator::NO_MORE_DOCS; doc = scorer->nextDoc()) {
+            EXPECT_TRUE(expectedScores.contains(doc));
+            EXPECT_NEAR(expectedScores.get(doc), scorer->score(), 0.00001);
+            ++count;
+        }
+    }
+    EXPECT_EQ(expected.size(), count);
+}
+
+TEST_F(BooleanScorerTest, testMatchesInOrderScorer) {
+    static const String FIELD = L"field";
+
+    RAMDirectoryPtr directory = newLucene<RAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(directory, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED);
+    RandomPtr random = newLucene<Random>(17);
+    for (int32_t i = 0; i < 7000; ++i) {
+        StringStream text;
+        for (wchar_t term = L'a'; term <= L'j'; ++term) {
+            // term 'a' is in nearly every doc, term 'j' in one doc in ten
+            for (int32_t freq = random->nextInt(3); freq > 0 && random->nextInt(10) <= L'j' - term; --freq) {
+                text << term << L" ";
+            }
+        }
+        DocumentPtr doc = newLucene<Document>();
+        doc->add(newLucene<Field>(FIELD, text.str(), Field::STORE_NO, Field::INDEX_ANALYZED));
+        writer->addDocument(doc);
+    }
+    writer->optimize();
+    writer->close();
+
+    IndexSearcherPtr searcher = newLucene<IndexSearcher>(directory, true);
+    for (int32_t clauses = 2; clauses <= 10; ++clauses) {
+        BooleanQueryPtr query = newLucene<BooleanQuery>();
+        for (int32_t i = 0; i < clauses; ++i) {
+            query->add(newLucene<TermQuery>(newLucene<Term>(FIELD, String(1, (wchar_t)(L'a' + i)))), BooleanClause::SHOULD);
+        }
+        checkScorers(searcher, query);
+
+        query->setMinimumNumberShouldMatch(clauses / 2);
+        checkScorers(searcher, query);
+
+        query->setMinimumNumberShouldMatch(0);
+        query->add(newLucene<TermQuery>(newLucene<Term>(FIELD, L"j")), BooleanClause::MUST_NOT);
+        checkScorers(searcher, query);
+    }
+    searcher->close();
+}
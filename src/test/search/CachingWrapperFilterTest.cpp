@@ -243,6 +243,8 @@ TEST_F(CachingWrapperFilterTest, testEnforceDeletions) {
     EXPECT_EQ(1, docs->totalHits);
 
     // make sure we get a cache hit when we reopen reader that had no change to deletions
+    // a delete matching nothing, as reopening an unchanged near real-time reader returns the same reader
+    writer->deleteDocuments(newLucene<Term>(L"foo", L"bar"));
     IndexReaderPtr newReader = refreshReader(reader);
     EXPECT_NE(reader, newReader);
     reader = newReader;
@@ -0,0 +1,112 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "RAMDirectory.h"
+#include "IndexWriter.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "IndexReader.h"
+#include "IndexSearcher.h"
+#include "TermQuery.h"
+#include "BooleanQuery.h"
+#include "Term.h"
+#include "Sort.h"
+#include "SortField.h"
+#include "ScoreDoc.h"
+#include "TopDocs.h"
+#include "TopFieldDocs.h"
+#include "ThreadPool.h"
+
+using namespace Lucene;
+
+class ConcurrentIndexSearcherTest : public LuceneTestFixture {
+public:
+    ConcurrentIndexSearcherTest() {
+        directory = newLucene<RAMDirectory>();
+        IndexWriterPtr writer = newLucene<IndexWriter>(directory, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED);
+        writer->setMaxBufferedDocs(7);
+        writer->setMergeFactor(1000);
+        for (int32_t i = 0; i < 100; ++i) {
+            DocumentPtr doc = newLucene<Document>();
+            String contents = L"all";
+            if (i % 2 == 0) {
+                contents += L" even";
+            }
+            if (i % 3 == 0) {
+                contents += L" three three";
+            }
+            doc->add(newLucene<Field>(L"contents", contents, Field::STORE_NO, Field::INDEX_ANALYZED));
+            doc->add(newLucene<Field>(L"id", StringUtils::toString(i), Field::STORE_YES, Field::INDEX_NOT_ANALYZED));
+            doc->add(newLucene<Field>(L"value", StringUtils::toString((i * 37) % 101), Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+            writer->addDocument(doc);
+        }
+        writer->close();
+
+        reader = IndexReader::open(directory, true);
+        sequential = newLucene<IndexSearcher>(reader);
+        concurrent = newLucene<IndexSearcher>(reader, newLucene<ThreadPool>());
+    }
+
+    virtual ~ConcurrentIndexSearcherTest() {
+        reader->close();
+    }
+
+protected:
+    DirectoryPtr directory;
+    IndexReaderPtr reader;
+    IndexSearcherPtr sequential;
+    IndexSearcherPtr concurrent;
+
+public:
+    void checkSameHits(const TopDocsPtr& expected, const TopDocsPtr& actual, bool checkScores = true) {
+        EXPECT_EQ(expected->totalHits, actual->totalHits);
+        EXPECT_EQ(expected->scoreDocs.size(), actual->scoreDocs.size());
+        for (int32_t i = 0; i < expected->scoreDocs.size(); ++i) {
+            EXPECT_EQ(expected->scoreDocs[i]->doc, actual->scoreDocs[i]->doc);
+            if (checkScores) {
+                EXPECT_NEAR(expected->scoreDocs[i]->score, actual->scoreDocs[i]->score, 0.00001);
+            }
+        }
+    }
+};
+
+TEST_F(ConcurrentIndexSearcherTest, testMultipleSegments) {
+    EXPECT_TRUE(reader->getSequentialSubReaders().size() > 1);
+    EXPECT_TRUE(concurrent->getExecutor());
+    EXPECT_TRUE(!sequential->getExecutor());
+}
+
+TEST_F(ConcurrentIndexSearcherTest, testTermQuery) {
+    QueryPtr query = newLucene<TermQuery>(newLucene<Term>(L"contents", L"three"));
+    checkSameHits(sequential->search(query, FilterPtr(), 10), concurrent->search(query, FilterPtr(), 10));
+    checkSameHits(sequential->search(query, FilterPtr(), 1000), concurrent->search(query, FilterPtr(), 1000));
+}
+
+TEST_F(ConcurrentIndexSearcherTest, testBooleanQuery) {
+    BooleanQueryPtr query = newLucene<BooleanQuery>();
+    query->add(newLucene<TermQuery>(newLucene<Term>(L"contents", L"even")), BooleanClause::SHOULD);
+    query->add(newLucene<TermQuery>(newLucene<Term>(L"contents", L"three")), BooleanClause::SHOULD);
+    checkSameHits(sequential->search(query, FilterPtr(), 25), concurrent->search(query, FilterPtr(), 25));
+}
+
+TEST_F(ConcurrentIndexSearcherTest, testNoHits) {
+    QueryPtr query = newLucene<TermQuery>(newLucene<Term>(L"contents", L"missing"));
+    TopDocsPtr docs = concurrent->search(query, FilterPtr(), 10);
+    EXPECT_EQ(0, docs->totalHits);
+    EXPECT_EQ(0, docs->scoreDocs.size());
+}
+
+TEST_F(ConcurrentIndexSearcherTest, testSort) {
+    QueryPtr query = newLucene<TermQuery>(newLucene<Term>(L"contents", L"all"));
+    SortPtr sort = newLucene<Sort>(newLucene<SortField>(L"value", SortField::INT, true));
+    checkSameHits(sequential->search(query, FilterPtr(), 20, sort), concurrent->search(query, FilterPtr(), 20, sort), false);
+
+    sort = newLucene<Sort>(newCollection<SortFieldPtr>(newLucene<SortField>(L"id", SortField::STRING), SortField::FIELD_DOC()));
+    checkSameHits(sequential->search(query, FilterPtr(), 20, sort), concurrent->search(query, FilterPtr(), 20, sort), false);
+}
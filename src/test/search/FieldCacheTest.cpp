@@ -14,6 +14,10 @@
 #include "Field.h"
 #include "IndexReader.h"
 #include "FieldCache.h"
+#include "FieldCacheSanityChecker.h"
+#include "NumericDocValues.h"
+#include "PackedInts.h"
+#include "VariantUtils.h"
 
 using namespace Lucene;
 
@@ -90,3 +94,97 @@ TEST_F(FieldCacheTest, testFieldCache) {
         EXPECT_EQ(ints[i], (INT_MAX - i));
     }
 }
+
+TEST_F(FieldCacheTest, testPackedFieldCache) {
+    FieldCachePtr cache = FieldCache::DEFAULT();
+    NumericDocValuesPtr longs = cache->getPackedLongs(reader, L"theLong");
+    EXPECT_EQ(longs, cache->getPackedLongs(reader, L"theLong", FieldCache::DEFAULT_LONG_PARSER()));
+    EXPECT_EQ(longs->size(), NUM_DOCS);
+    EXPECT_TRUE(longs->sizeInBytes() <= (NUM_DOCS * 10 + 63) / 64 * 8); // 10 bits per document
+    for (int32_t i = 0; i < longs->size(); ++i) {
+        EXPECT_EQ(longs->getLong(i), (LLONG_MAX - i));
+    }
+
+    NumericDocValuesPtr ints = cache->getPackedInts(reader, L"theInt");
+    EXPECT_EQ(ints, cache->getPackedInts(reader, L"theInt", FieldCache::DEFAULT_INT_PARSER()));
+    EXPECT_EQ(ints->size(), NUM_DOCS);
+    for (int32_t i = 0; i < ints->size(); ++i) {
+        EXPECT_EQ(ints->getLong(i), (INT_MAX - i));
+    }
+
+    Collection<double> doubles = cache->getDoubles(reader, L"theDouble");
+    NumericDocValuesPtr packedDoubles = cache->getPackedDoubles(reader, L"theDouble");
+    EXPECT_EQ(packedDoubles->size(), NUM_DOCS);
+    for (int32_t i = 0; i < packedDoubles->size(); ++i) {
+        EXPECT_EQ(packedDoubles->getDouble(i), doubles[i]);
+    }
+
+    StringIndexPtr stringIndex = cache->getStringIndex(reader, L"theInt");
+    StringIndexPtr packedIndex = cache->getPackedStringIndex(reader, L"theInt");
+    EXPECT_TRUE(!packedIndex->order);
+    EXPECT_EQ(packedIndex->packedOrder->getBitsPerValue(), PackedInts::bitsRequired(NUM_DOCS));
+    EXPECT_EQ(stringIndex->lookup.size(), packedIndex->lookup.size());
+    for (int32_t i = 0; i < NUM_DOCS; ++i) {
+        EXPECT_EQ(stringIndex->order[i], packedIndex->getOrd(i));
+        EXPECT_EQ(stringIndex->lookup[stringIndex->order[i]], packedIndex->lookup[packedIndex->getOrd(i)]);
+    }
+}
+
+TEST_F(FieldCacheTest, testUnpackedValuesSharePackedEntry) {
+    FieldCachePtr cache = FieldCache::DEFAULT();
+    cache->purgeAllCaches();
+
+    Collection<int32_t> ints = cache->getInts(reader, L"theInt");
+    NumericDocValuesPtr packedInts = cache->getPackedInts(reader, L"theInt");
+    EXPECT_EQ(ints.hashCode(), cache->getInts(reader, L"theInt", FieldCache::DEFAULT_INT_PARSER()).hashCode());
+
+    StringIndexPtr stringIndex = cache->getStringIndex(reader, L"theLong");
+    StringIndexPtr packedIndex = cache->getPackedStringIndex(reader, L"theLong");
+    EXPECT_EQ(stringIndex, cache->getStringIndex(reader, L"theLong"));
+    EXPECT_EQ(stringIndex->lookup.hashCode(), packedIndex->lookup.hashCode());
+    EXPECT_TRUE(!packedIndex->order);
+
+    // a single entry for each field, holding the packed values
+    Collection<FieldCacheEntryPtr> entries = cache->getCacheEntries();
+    EXPECT_EQ(2, entries.size());
+    for (Collection<FieldCacheEntryPtr>::iterator entry = entries.begin(); entry != entries.end(); ++entry) {
+        if ((*entry)->getFieldName() == L"theInt") {
+            EXPECT_EQ(FieldCache::CACHE_PACKED_INT, (*entry)->getCacheType());
+            EXPECT_EQ(packedInts, VariantUtils::get<NumericDocValuesPtr>((*entry)->getValue()));
+        } else {
+            EXPECT_EQ(FieldCache::CACHE_PACKED_STRING_INDEX, (*entry)->getCacheType());
+            EXPECT_EQ(packedIndex, VariantUtils::get<StringIndexPtr>((*entry)->getValue()));
+        }
+    }
+    EXPECT_EQ(0, FieldCacheSanityChecker::checkSanity(entries).size());
+
+    cache->purgeAllCaches();
+}
+
+TEST_F(FieldCacheTest, testPackedMissingValues) {
+    RAMDirectoryPtr directory = newLucene<RAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(directory, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED);
+    for (int32_t i = 0; i < 100; ++i) {
+        DocumentPtr doc = newLucene<Document>();
+        if (i % 2 == 0) {
+            // documents with several values take the largest, there are more values than documents
+            doc->add(newLucene<Field>(L"sparse", L"1000 1001 " + StringUtils::toString(1002 + i), Field::STORE_NO, Field::INDEX_ANALYZED));
+        }
+        writer->addDocument(doc);
+    }
+    writer->close();
+    IndexReaderPtr sparseReader = IndexReader::open(directory, true);
+
+    NumericDocValuesPtr ints = FieldCache::DEFAULT()->getPackedInts(sparseReader, L"sparse");
+    Collection<int32_t> expected = FieldCache::DEFAULT()->getInts(sparseReader, L"sparse");
+    EXPECT_EQ(ints->size(), 100);
+    for (int32_t i = 0; i < 100; ++i) {
+        EXPECT_EQ(ints->getLong(i), i % 2 == 0 ? 1002 + i : 0);
+        EXPECT_EQ(ints->getLong(i), expected[i]);
+    }
+
+    NumericDocValuesPtr missing = FieldCache::DEFAULT()->getPackedLongs(sparseReader, L"nofield");
+    EXPECT_EQ(missing->size(), 100);
+    EXPECT_EQ(missing->getLong(50), 0);
+    sparseReader->close();
+}
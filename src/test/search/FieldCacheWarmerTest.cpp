@@ -0,0 +1,121 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "RAMDirectory.h"
+#include "IndexWriter.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "DirectoryReader.h"
+#include "FieldCache.h"
+#include "FieldCacheWarmer.h"
+#include "NumericDocValues.h"
+#include "SortField.h"
+#include "ThreadPool.h"
+
+using namespace Lucene;
+
+typedef LuceneTestFixture FieldCacheWarmerTest;
+
+static void addDocuments(const DirectoryPtr& dir, int32_t start, int32_t count, bool create) {
+    IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), create, IndexWriter::MaxFieldLengthLIMITED);
+    writer->setMaxBufferedDocs(10);
+    writer->setMergeFactor(100);
+    for (int32_t i = start; i < start + count; ++i) {
+        DocumentPtr doc = newLucene<Document>();
+        doc->add(newLucene<Field>(L"int", StringUtils::toString(i), Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+        doc->add(newLucene<Field>(L"string", L"s" + StringUtils::toString(i % 7), Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+        writer->addDocument(doc);
+    }
+    writer->close();
+}
+
+/// Returns the number of cache entries held for the given reader.
+static int32_t countEntries(const IndexReaderPtr& reader) {
+    int32_t count = 0;
+    Collection<FieldCacheEntryPtr> entries = FieldCache::DEFAULT()->getCacheEntries();
+    for (Collection<FieldCacheEntryPtr>::iterator entry = entries.begin(); entry != entries.end(); ++entry) {
+        if ((*entry)->getReaderKey() == reader->getFieldCacheKey()) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+static Collection<SortFieldPtr> sortFields() {
+    return newCollection<SortFieldPtr>(newLucene<SortField>(L"int", SortField::INT), newLucene<SortField>(L"string", SortField::STRING), SortField::FIELD_SCORE());
+}
+
+TEST_F(FieldCacheWarmerTest, testWarm) {
+    FieldCache::DEFAULT()->purgeAllCaches();
+    DirectoryPtr dir = newLucene<RAMDirectory>();
+    addDocuments(dir, 0, 50, true);
+    IndexReaderPtr reader = IndexReader::open(dir, true);
+    Collection<IndexReaderPtr> subReaders = reader->getSequentialSubReaders();
+    EXPECT_EQ(5, subReaders.size());
+
+    FieldCacheWarmerPtr warmer = newLucene<FieldCacheWarmer>(sortFields(), newLucene<ThreadPool>(2));
+    warmer->warm(reader);
+    for (Collection<IndexReaderPtr>::iterator subReader = subReaders.begin(); subReader != subReaders.end(); ++subReader) {
+        EXPECT_EQ(2, countEntries(*subReader));
+        NumericDocValuesPtr values = FieldCache::DEFAULT()->getPackedInts(*subReader, L"int");
+        EXPECT_EQ(2, countEntries(*subReader)); // already loaded
+    }
+    EXPECT_EQ(0, countEntries(reader));
+    reader->close();
+    FieldCache::DEFAULT()->purgeAllCaches();
+}
+
+TEST_F(FieldCacheWarmerTest, testWarmAsync) {
+    FieldCache::DEFAULT()->purgeAllCaches();
+    DirectoryPtr dir = newLucene<RAMDirectory>();
+    addDocuments(dir, 0, 30, true);
+    IndexReaderPtr reader = IndexReader::open(dir, true);
+
+    FieldCacheWarmerPtr warmer = newLucene<FieldCacheWarmer>(sortFields());
+    Collection<FuturePtr> futures = warmer->warmAsync(reader);
+    EXPECT_EQ(3, futures.size());
+    for (Collection<FuturePtr>::iterator future = futures.begin(); future != futures.end(); ++future) {
+        EXPECT_EQ(2, (*future)->get<int32_t>());
+    }
+    Collection<IndexReaderPtr> subReaders = reader->getSequentialSubReaders();
+    for (Collection<IndexReaderPtr>::iterator subReader = subReaders.begin(); subReader != subReaders.end(); ++subReader) {
+        EXPECT_EQ(2, countEntries(*subReader));
+    }
+    reader->close();
+    FieldCache::DEFAULT()->purgeAllCaches();
+}
+
+TEST_F(FieldCacheWarmerTest, testReopenWarmer) {
+    FieldCache::DEFAULT()->purgeAllCaches();
+    DirectoryPtr dir = newLucene<RAMDirectory>();
+    addDocuments(dir, 0, 20, true);
+    IndexReaderPtr reader = IndexReader::open(dir, true);
+    DirectoryReaderPtr directoryReader = boost::dynamic_pointer_cast<DirectoryReader>(reader);
+    directoryReader->setReopenWarmer(newLucene<FieldCacheWarmer>(sortFields()));
+    EXPECT_EQ(0, countEntries(reader->getSequentialSubReaders()[0]));
+
+    // nothing changed, the same reader is returned
+    EXPECT_EQ(reader, reader->reopen());
+
+    addDocuments(dir, 20, 10, false);
+    IndexReaderPtr newReader = reader->reopen();
+    EXPECT_NE(reader, newReader);
+    EXPECT_TRUE(boost::dynamic_pointer_cast<DirectoryReader>(newReader)->getReopenWarmer());
+    Collection<IndexReaderPtr> subReaders = newReader->getSequentialSubReaders();
+    EXPECT_EQ(3, subReaders.size());
+    for (Collection<IndexReaderPtr>::iterator subReader = subReaders.begin(); subReader != subReaders.end(); ++subReader) {
+        EXPECT_EQ(2, countEntries(*subReader));
+    }
+    NumericDocValuesPtr values = FieldCache::DEFAULT()->getPackedInts(subReaders[2], L"int");
+    EXPECT_EQ(29, values->getLong(9));
+
+    reader->close();
+    newReader->close();
+    FieldCache::DEFAULT()->purgeAllCaches();
+}
@@ -0,0 +1,144 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "RAMDirectory.h"
+#include "IndexWriter.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "IndexSearcher.h"
+#include "TermQuery.h"
+#include "BooleanQuery.h"
+#include "MatchAllDocsQuery.h"
+#include "Term.h"
+#include "TopScoreDocCollector.h"
+#include "FlatTopScoreDocCollector.h"
+#include "FlatTopDocs.h"
+#include "TopDocs.h"
+#include "ScoreDoc.h"
+#include "Random.h"
+
+using namespace Lucene;
+
+class FlatTopScoreDocCollectorTest : public LuceneTestFixture {
+public:
+    FlatTopScoreDocCollectorTest() {
+        static const wchar_t* words[] = {L"aaa", L"bbb", L"ccc", L"ddd", L"eee"};
+        dir = newLucene<RAMDirectory>();
+        IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), IndexWriter::MaxFieldLengthUNLIMITED);
+        writer->setMaxBufferedDocs(50);
+        RandomPtr random = newLucene<Random>(7);
+        for (int32_t i = 0; i < 300; ++i) {
+            String text;
+            int32_t numWords = random->nextInt(5) + 1;
+            for (int32_t j = 0; j < numWords; ++j) {
+                text += String(words[random->nextInt(5)]) + L" ";
+            }
+            DocumentPtr doc = newLucene<Document>();
+            doc->add(newLucene<Field>(L"content", text, Field::STORE_NO, Field::INDEX_ANALYZED));
+            writer->addDocument(doc);
+        }
+        writer->close();
+        searcher = newLucene<IndexSearcher>(dir, true);
+    }
+
+    virtual ~FlatTopScoreDocCollectorTest() {
+        searcher->close();
+        dir->close();
+    }
+
+protected:
+    DirectoryPtr dir;
+    IndexSearcherPtr searcher;
+
+public:
+    void checkSameHits(const QueryPtr& query, int32_t numHits, bool inOrder) {
+        TopScoreDocCollectorPtr expectedCollector = TopScoreDocCollector::create(numHits, inOrder);
+        searcher->search(query, expectedCollector);
+        TopDocsPtr expected = expectedCollector->topDocs();
+
+        FlatTopScoreDocCollectorPtr collector = FlatTopScoreDocCollector::create(numHits, inOrder);
+        searcher->search(query, collector);
+        FlatTopDocsPtr actual = collector->flatTopDocs();
+
+        EXPECT_EQ(expected->totalHits, actual->totalHits);
+        EXPECT_EQ(expected->totalHits, collector->getTotalHits());
+        EXPECT_EQ(expected->scoreDocs.size(), actual->scoreDocs.size());
+        EXPECT_EQ(expected->maxScore, actual->maxScore);
+        for (int32_t i = 0; i < expected->scoreDocs.size(); ++i) {
+            EXPECT_EQ(expected->scoreDocs[i]->doc, actual->scoreDocs[i].doc);
+            EXPECT_EQ(expected->scoreDocs[i]->score, actual->scoreDocs[i].score);
+        }
+    }
+};
+
+TEST_F(FlatTopScoreDocCollectorTest, testInOrderCollection) {
+    EXPECT_EQ(L"InOrderFlatTopScoreDocCollector", FlatTopScoreDocCollector::create(10, true)->getClassName());
+    static const int32_t numHits[] = {1, 10, 100, 1000};
+    for (int32_t i = 0; i < 4; ++i) {
+        checkSameHits(newLucene<TermQuery>(newLucene<Term>(L"content", L"aaa")), numHits[i], true);
+        checkSameHits(newLucene<MatchAllDocsQuery>(), numHits[i], true);
+    }
+}
+
+TEST_F(FlatTopScoreDocCollectorTest, testOutOfOrderCollection) {
+    EXPECT_EQ(L"OutOfOrderFlatTopScoreDocCollector", FlatTopScoreDocCollector::create(10, false)->getClassName());
+    BooleanQueryPtr query = newLucene<BooleanQuery>();
+    query->add(newLucene<TermQuery>(newLucene<Term>(L"content", L"aaa")), BooleanClause::SHOULD);
+    query->add(newLucene<TermQuery>(newLucene<Term>(L"content", L"ccc")), BooleanClause::SHOULD);
+    query->add(newLucene<TermQuery>(newLucene<Term>(L"content", L"eee")), BooleanClause::SHOULD);
+    static const int32_t numHits[] = {1, 10, 100, 1000};
+    for (int32_t i = 0; i < 4; ++i) {
+        checkSameHits(query, numHits[i], false);
+        checkSameHits(query, numHits[i], true);
+    }
+}
+
+TEST_F(FlatTopScoreDocCollectorTest, testPaging) {
+    QueryPtr query = newLucene<TermQuery>(newLucene<Term>(L"content", L"bbb"));
+    FlatTopScoreDocCollectorPtr collector = FlatTopScoreDocCollector::create(50, true);
+    searcher->search(query, collector);
+    FlatTopDocsPtr all = collector->flatTopDocs();
+    EXPECT_EQ(50, all->scoreDocs.size());
+    EXPECT_TRUE(collector->getTotalHits() > 50);
+
+    // pages can be asked for repeatedly, in any order
+    for (int32_t start = 40; start >= 0; start -= 20) {
+        FlatTopDocsPtr page = collector->flatTopDocs(start, 20);
+        EXPECT_EQ(std::min(20, 50 - start), page->scoreDocs.size());
+        EXPECT_EQ(all->maxScore, page->maxScore);
+        for (int32_t i = 0; i < page->scoreDocs.size(); ++i) {
+            EXPECT_EQ(all->scoreDocs[start + i].doc, page->scoreDocs[i].doc);
+        }
+    }
+    EXPECT_EQ(0, collector->flatTopDocs(50, 10)->scoreDocs.size());
+    EXPECT_EQ(0, collector->flatTopDocs(-1, 10)->scoreDocs.size());
+
+    TopDocsPtr topDocs = collector->topDocs();
+    EXPECT_EQ(all->totalHits, topDocs->totalHits);
+    EXPECT_EQ(50, topDocs->scoreDocs.size());
+    for (int32_t i = 0; i < 50; ++i) {
+        EXPECT_EQ(all->scoreDocs[i].doc, topDocs->scoreDocs[i]->doc);
+        EXPECT_EQ(all->scoreDocs[i].score, topDocs->scoreDocs[i]->score);
+    }
+}
+
+TEST_F(FlatTopScoreDocCollectorTest, testNoHits) {
+    FlatTopScoreDocCollectorPtr collector = FlatTopScoreDocCollector::create(10, true);
+    searcher->search(newLucene<TermQuery>(newLucene<Term>(L"content", L"zzz")), collector);
+    FlatTopDocsPtr topDocs = collector->flatTopDocs();
+    EXPECT_EQ(0, topDocs->totalHits);
+    EXPECT_EQ(0, topDocs->scoreDocs.size());
+    EXPECT_TRUE(MiscUtils::isNaN(topDocs->getMaxScore()));
+
+    try {
+        FlatTopScoreDocCollector::create(0, true);
+    } catch (IllegalArgumentException& e) {
+        EXPECT_TRUE(check_exception(LuceneException::IllegalArgument)(e));
+    }
+}
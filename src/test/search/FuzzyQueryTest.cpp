@@ -20,6 +20,8 @@
 #include "StandardAnalyzer.h"
 #include "QueryParser.h"
 #include "IndexReader.h"
+#include "FuzzyTermEnum.h"
+#include "AutomatonFuzzyTermEnum.h"
 
 using namespace Lucene;
 
@@ -332,3 +334,174 @@ TEST_F(FuzzyQueryTest, testGiga) {
     EXPECT_EQ(L"Giga byte", searcher->doc(hits[0]->doc)->get(L"field"));
     r->close();
 }
+
+TEST_F(FuzzyQueryTest, testAutomatonMatchesScan) {
+    RAMDirectoryPtr directory = newLucene<RAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(directory, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED);
+    // every string of up to 4 characters from a, b and c, plus a few others, in two fields
+    Collection<String> terms(newCollection<String>(L"\x00e9t\x00e9", L"ab\x1f600", L"zzz"));
+    Collection<String> shorter(newCollection<String>(L""));
+    for (int32_t length = 1; length <= 4; ++length) {
+        Collection<String> strings(Collection<String>::newInstance());
+        for (Collection<String>::iterator prefix = shorter.begin(); prefix != shorter.end(); ++prefix) {
+            for (wchar_t c = L'a'; c <= L'c'; ++c) {
+                strings.add(*prefix + c);
+            }
+        }
+        terms.addAll(strings.begin(), strings.end());
+        shorter = strings;
+    }
+    for (Collection<String>::iterator term = terms.begin(); term != terms.end(); ++term) {
+        DocumentPtr doc = newLucene<Document>();
+        doc->add(newLucene<Field>(L"field", *term, Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+        doc->add(newLucene<Field>(L"other", *term, Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+        writer->addDocument(doc);
+    }
+    writer->close();
+    IndexReaderPtr reader = IndexReader::open(directory, true);
+
+    static const wchar_t* queries[] = {L"a", L"ab", L"abc", L"cab", L"aaaa", L"bcbc", L"abcab", L"\x00e9t\x00e9"};
+    static const double similarities[] = {0.4, 0.5, 0.6, 0.75, 0.8};
+    int32_t checked = 0;
+    for (int32_t q = 0; q < (int32_t)(sizeof(queries) / sizeof(queries[0])); ++q) {
+        TermPtr term = newLucene<Term>(L"field", queries[q]);
+        for (int32_t s = 0; s < (int32_t)(sizeof(similarities) / sizeof(similarities[0])); ++s) {
+            if (AutomatonFuzzyTermEnum::maxEditsForSimilarity(term, similarities[s]) > 2) {
+                continue;
+            }
+            for (int32_t prefixLength = 0; prefixLength <= 2; ++prefixLength) {
+                FilteredTermEnumPtr scan = newLucene<FuzzyTermEnum>(reader, term, similarities[s], prefixLength);
+                FilteredTermEnumPtr automaton = newLucene<AutomatonFuzzyTermEnum>(reader, term, similarities[s], prefixLength);
+                while (true) {
+                    TermPtr scanTerm = scan->term();
+                    TermPtr automatonTerm = automaton->term();
+                    if (!scanTerm) {
+                        EXPECT_TRUE(!automatonTerm);
+                        break;
+                    }
+                    EXPECT_TRUE(automatonTerm && scanTerm->equals(automatonTerm));
+                    if (!automatonTerm) {
+                        break;
+                    }
+                    EXPECT_NEAR(scan->difference(), automaton->difference(), 1e-9);
+                    EXPECT_EQ(scan->docFreq(), automaton->docFreq());
+                    ++checked;
+                    scan->next();
+                    automaton->next();
+                }
+                scan->close();
+                automaton->close();
+            }
+        }
+    }
+    EXPECT_TRUE(checked > 100);
+    reader->close();
+}
+
+TEST_F(FuzzyQueryTest, testMaxEdits) {
+    RAMDirectoryPtr directory = newLucene<RAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(directory, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED);
+    addDoc(L"abcd", writer);
+    addDoc(L"abdc", writer);
+    addDoc(L"bacd", writer);
+    addDoc(L"badc", writer);
+    addDoc(L"abc", writer);
+    addDoc(L"abcde", writer);
+    addDoc(L"xbcd", writer);
+    addDoc(L"bcd", writer);
+    addDoc(L"abcdef", writer);
+    writer->close();
+    IndexSearcherPtr searcher = newLucene<IndexSearcher>(directory, true);
+
+    FuzzyQueryPtr query = newLucene<FuzzyQuery>(newLucene<Term>(L"field", L"abcd"), 1, 0, true);
+    EXPECT_EQ(1, query->getMaxEdits());
+    EXPECT_TRUE(query->getTranspositions());
+    EXPECT_EQ(L"abcd~1", query->toString(L"field"));
+    Collection<ScoreDocPtr> hits = searcher->search(query, FilterPtr(), 1000)->scoreDocs;
+    EXPECT_EQ(7, hits.size());
+    EXPECT_EQ(L"abcd", searcher->doc(hits[0]->doc)->get(L"field"));
+
+    // without transpositions, swapping two characters takes two edits
+    query = newLucene<FuzzyQuery>(newLucene<Term>(L"field", L"abcd"), 1, 0, false);
+    hits = searcher->search(query, FilterPtr(), 1000)->scoreDocs;
+    EXPECT_EQ(5, hits.size());
+    query = newLucene<FuzzyQuery>(newLucene<Term>(L"field", L"abcd"), 2, 0, false);
+    hits = searcher->search(query, FilterPtr(), 1000)->scoreDocs;
+    EXPECT_EQ(8, hits.size());
+
+    // with a prefix
+    query = newLucene<FuzzyQuery>(newLucene<Term>(L"field", L"abcd"), 1, 1, true);
+    hits = searcher->search(query, FilterPtr(), 1000)->scoreDocs;
+    EXPECT_EQ(4, hits.size());
+    query = newLucene<FuzzyQuery>(newLucene<Term>(L"field", L"abcd"), 0, 0, true);
+    hits = searcher->search(query, FilterPtr(), 1000)->scoreDocs;
+    EXPECT_EQ(1, hits.size());
+
+    FuzzyQueryPtr other = newLucene<FuzzyQuery>(newLucene<Term>(L"field", L"abcd"), 1, 0, true);
+    EXPECT_TRUE(other->equals(newLucene<FuzzyQuery>(newLucene<Term>(L"field", L"abcd"), 1, 0, true)));
+    EXPECT_TRUE(other->equals(other->clone()));
+    EXPECT_TRUE(!other->equals(newLucene<FuzzyQuery>(newLucene<Term>(L"field", L"abcd"), 1, 0, false)));
+    EXPECT_TRUE(!other->equals(newLucene<FuzzyQuery>(newLucene<Term>(L"field", L"abcd"), 2, 0, true)));
+
+    try {
+        newLucene<FuzzyQuery>(newLucene<Term>(L"field", L"abcd"), 3, 0, true);
+    } catch (IllegalArgumentException& e) {
+        EXPECT_TRUE(check_exception(LuceneException::IllegalArgument)(e));
+    }
+    searcher->close();
+}
+
+TEST_F(FuzzyQueryTest, testBoundedSimilarityEdits) {
+    RAMDirectoryPtr directory = newLucene<RAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(directory, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED);
+    addDoc(L"aaaaaaa", writer);
+    addDoc(L"aaaaacc", writer);
+    addDoc(L"segment", writer);
+    writer->close();
+    IndexSearcherPtr searcher = newLucene<IndexSearcher>(directory, true);
+
+    EXPECT_EQ(2, FuzzyQuery::floatToEdits(0.5, 7));
+    EXPECT_EQ(1, FuzzyQuery::floatToEdits(0.5, 3));
+    EXPECT_EQ(0, FuzzyQuery::floatToEdits(0.9, 4));
+
+    // "aaaaaaa" is 3 edits away, which the similarity allows but the bound doesn't
+    FuzzyQueryPtr query = newLucene<FuzzyQuery>(newLucene<Term>(L"field", L"aaaaccc"), FuzzyQuery::defaultMinSimilarity(), 0);
+    Collection<ScoreDocPtr> hits = searcher->search(query, FilterPtr(), 1000)->scoreDocs;
+    EXPECT_EQ(2, hits.size());
+    query = newLucene<FuzzyQuery>(newLucene<Term>(L"field", L"aaaaccc"), FuzzyQuery::defaultMinSimilarity(), 0, 2);
+    EXPECT_EQ(-1, query->getMaxEdits());
+    EXPECT_EQ(L"aaaaccc~0.5", query->toString(L"field"));
+    hits = searcher->search(query, FilterPtr(), 1000)->scoreDocs;
+    EXPECT_EQ(1, hits.size());
+    EXPECT_EQ(L"aaaaacc", searcher->doc(hits[0]->doc)->get(L"field"));
+
+    // the similarity still applies within the bound
+    query = newLucene<FuzzyQuery>(newLucene<Term>(L"field", L"aaaaccc"), 0.8, 0, 2);
+    hits = searcher->search(query, FilterPtr(), 1000)->scoreDocs;
+    EXPECT_EQ(1, hits.size());
+    query = newLucene<FuzzyQuery>(newLucene<Term>(L"field", L"aaaaccc"), 0.9, 0, 2);
+    hits = searcher->search(query, FilterPtr(), 1000)->scoreDocs;
+    EXPECT_EQ(0, hits.size());
+
+    // the query parser only bounds the edits when asked to
+    QueryParserPtr parser = newLucene<QueryParser>(LuceneVersion::LUCENE_CURRENT, L"field", newLucene<WhitespaceAnalyzer>());
+    EXPECT_TRUE(!parser->getFuzzyBoundEdits());
+    QueryPtr parsed = parser->parse(L"aaaaccc~");
+    EXPECT_TRUE(parsed->equals(newLucene<FuzzyQuery>(newLucene<Term>(L"field", L"aaaaccc"), FuzzyQuery::defaultMinSimilarity(), 0)));
+    hits = searcher->search(parsed, FilterPtr(), 1000)->scoreDocs;
+    EXPECT_EQ(2, hits.size());
+    parser->setFuzzyBoundEdits(true);
+    parsed = parser->parse(L"aaaaccc~");
+    EXPECT_TRUE(parsed->equals(newLucene<FuzzyQuery>(newLucene<Term>(L"field", L"aaaaccc"), FuzzyQuery::defaultMinSimilarity(), 0, 2)));
+    EXPECT_TRUE(!parsed->equals(newLucene<FuzzyQuery>(newLucene<Term>(L"field", L"aaaaccc"), FuzzyQuery::defaultMinSimilarity(), 0)));
+    EXPECT_TRUE(parsed->equals(parsed->clone()));
+    hits = searcher->search(parsed, FilterPtr(), 1000)->scoreDocs;
+    EXPECT_EQ(1, hits.size());
+
+    try {
+        newLucene<FuzzyQuery>(newLucene<Term>(L"field", L"aaaaccc"), 0.5, 0, 3);
+    } catch (IllegalArgumentException& e) {
+        EXPECT_TRUE(check_exception(LuceneException::IllegalArgument)(e));
+    }
+    searcher->close();
+}
@@ -93,6 +93,7 @@ void QueryUtils::check(const QueryPtr& q1, const SearcherPtr& s, bool wrap) {
         if (is) {
             checkFirstSkipTo(q1, is);
             checkSkipTo(q1, is);
+            checkScoreBatch(q1, is);
             if (wrap) {
                 check(q1, wrapUnderlyingReader(is, -1), false);
                 check(q1, wrapUnderlyingReader(is,  0), false);
@@ -406,4 +407,38 @@ void QueryUtils::checkFirstSkipTo(const QueryPtr& q, const IndexSearcherPtr& s)
     }
 }
 
+void QueryUtils::checkScoreBatch(const QueryPtr& q, const IndexSearcherPtr& s) {
+    WeightPtr w = q->weight(s);
+    Collection<IndexReaderPtr> readers = Collection<IndexReaderPtr>::newInstance();
+    ReaderUtil::gatherSubReaders(readers, s->getIndexReader());
+    for (Collection<IndexReaderPtr>::iterator reader = readers.begin(); reader != readers.end(); ++reader) {
+        ScorerPtr expected = w->scorer(*reader, true, false);
+        ScorerPtr actual = w->scorer(*reader, true, false);
+        EXPECT_EQ(!expected, !actual);
+        if (expected && actual) {
+            checkScoreBatch(expected, actual);
+        }
+    }
+}
+
+void QueryUtils::checkScoreBatch(const ScorerPtr& expected, const ScorerPtr& actual) {
+    Collection<int32_t> docs = Collection<int32_t>::newInstance(5);
+    Collection<double> scores = Collection<double>::newInstance(5);
+    int32_t doc = expected->nextDoc();
+    actual->nextDoc();
+    for (int32_t max = 7; doc != DocIdSetIterator::NO_MORE_DOCS; max += 7) {
+        int32_t count = actual->scoreBatch(docs, scores, max);
+        if (count == 0 && doc < max) {
+            FAIL() << "no docs scored before " << max;
+        }
+        for (int32_t i = 0; i < count; ++i) {
+            EXPECT_EQ(doc, docs[i]);
+            EXPECT_NEAR(expected->score(), scores[i], 0.00001);
+            doc = expected->nextDoc();
+        }
+        EXPECT_EQ(doc, actual->docID());
+    }
+    EXPECT_EQ(0, actual->scoreBatch(docs, scores, DocIdSetIterator::NO_MORE_DOCS));
+}
+
 }
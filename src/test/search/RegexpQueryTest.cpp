@@ -0,0 +1,131 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "RAMDirectory.h"
+#include "IndexWriter.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "RegexpQuery.h"
+#include "RegExp.h"
+#include "Automaton.h"
+#include "Term.h"
+#include "IndexSearcher.h"
+#include "ScoreDoc.h"
+#include "TopDocs.h"
+
+using namespace Lucene;
+
+class RegexpQueryTest : public LuceneTestFixture {
+public:
+    RegexpQueryTest() {
+        terms = newCollection<String>(L"apple", L"apricot", L"banana", L"blueberry", L"cherry", L"cranberry");
+        terms.add(L"date");
+        terms.add(L"elderberry");
+        terms.add(L"fig");
+        terms.add(L"grape");
+        terms.add(L"\x00e9" L"clair");
+        terms.add(L"kiwi\x1f600");
+        directory = newLucene<RAMDirectory>();
+        IndexWriterPtr writer = newLucene<IndexWriter>(directory, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED);
+        for (int32_t i = 0; i < terms.size(); ++i) {
+            DocumentPtr doc = newLucene<Document>();
+            // fields sorting either side of "field", so the enumeration has terms to skip on both
+            doc->add(newLucene<Field>(L"alpha", terms[i], Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+            doc->add(newLucene<Field>(L"field", terms[i], Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+            doc->add(newLucene<Field>(L"zulu", terms[i] + L"s", Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+            writer->addDocument(doc);
+        }
+        writer->close();
+        searcher = newLucene<IndexSearcher>(directory, true);
+    }
+
+    virtual ~RegexpQueryTest() {
+        searcher->close();
+    }
+
+protected:
+    Collection<String> terms;
+    RAMDirectoryPtr directory;
+    IndexSearcherPtr searcher;
+
+public:
+    int32_t regexQueryNrHits(const String& regex) {
+        return searcher->search(newLucene<RegexpQuery>(newLucene<Term>(L"field", regex)), FilterPtr(), 100)->totalHits;
+    }
+
+    /// The number of indexed terms the expression matches, tested one by one.
+    int32_t bruteForceHits(const String& regex) {
+        AutomatonPtr automaton(newLucene<RegExp>(regex)->toAutomaton());
+        int32_t hits = 0;
+        for (int32_t i = 0; i < terms.size(); ++i) {
+            if (automaton->run(terms[i])) {
+                ++hits;
+            }
+        }
+        return hits;
+    }
+};
+
+TEST_F(RegexpQueryTest, testRegex) {
+    EXPECT_EQ(1, regexQueryNrHits(L"apple"));
+    EXPECT_EQ(2, regexQueryNrHits(L"ap.*"));
+    EXPECT_EQ(3, regexQueryNrHits(L".*berry"));
+    EXPECT_EQ(3, regexQueryNrHits(L"[bc].*rry"));
+    EXPECT_EQ(1, regexQueryNrHits(L"...."));
+    EXPECT_EQ(0, regexQueryNrHits(L"applex?s"));
+    EXPECT_EQ(1, regexQueryNrHits(L"\x00e9.*"));
+    EXPECT_EQ(1, regexQueryNrHits(L"kiwi."));
+    EXPECT_EQ(0, regexQueryNrHits(L"zzz.*"));
+}
+
+TEST_F(RegexpQueryTest, testMatchesBruteForce) {
+    static const wchar_t* regexes[] = {L".*", L"a.*", L".*e", L"[a-d].*", L"[^a-d].*", L"(cherry|date|fig)", L".*rr.*",
+                                       L"b(an)+a", L"b(an){1,3}a", L".{3,4}", L"[e-z]+", L"(.*e.*){2}", L".*\x1f600"
+                                      };
+    for (int32_t i = 0; i < (int32_t)(sizeof(regexes) / sizeof(regexes[0])); ++i) {
+        EXPECT_EQ(bruteForceHits(regexes[i]), regexQueryNrHits(regexes[i])) << regexes[i];
+    }
+}
+
+TEST_F(RegexpQueryTest, testToString) {
+    RegexpQueryPtr query = newLucene<RegexpQuery>(newLucene<Term>(L"field", L"a.*c"));
+    EXPECT_EQ(L"/a.*c/", query->toString(L"field"));
+    EXPECT_EQ(L"field:/a.*c/", query->toString(L"other"));
+}
+
+TEST_F(RegexpQueryTest, testEqualsAndClone) {
+    RegexpQueryPtr query1 = newLucene<RegexpQuery>(newLucene<Term>(L"field", L"a.*c"));
+    RegexpQueryPtr query2 = newLucene<RegexpQuery>(newLucene<Term>(L"field", L"a.*c"));
+    RegexpQueryPtr query3 = newLucene<RegexpQuery>(newLucene<Term>(L"field", L"a.*d"));
+    EXPECT_TRUE(query1->equals(query2));
+    EXPECT_EQ(query1->hashCode(), query2->hashCode());
+    EXPECT_TRUE(!query1->equals(query3));
+
+    RegexpQueryPtr clone = boost::dynamic_pointer_cast<RegexpQuery>(query1->clone());
+    EXPECT_TRUE(query1->equals(clone));
+    EXPECT_EQ(regexQueryNrHits(L"a.*c"), searcher->search(clone, FilterPtr(), 100)->totalHits);
+}
+
+TEST_F(RegexpQueryTest, testInvalid) {
+    try {
+        newLucene<RegexpQuery>(newLucene<Term>(L"field", L"(ab"));
+    } catch (LuceneException& e) {
+        EXPECT_TRUE(check_exception(LuceneException::IllegalArgument)(e));
+    }
+}
+
+TEST_F(RegexpQueryTest, testTooComplex) {
+    EXPECT_THROW(newLucene<RegexpQuery>(newLucene<Term>(L"field", L".*a.{30}")), IllegalArgumentException);
+    EXPECT_THROW(newLucene<RegexpQuery>(newLucene<Term>(L"field", L".*e.{4}"), 16), IllegalArgumentException);
+
+    // a larger limit lets it through, also for its clones
+    RegexpQueryPtr query = newLucene<RegexpQuery>(newLucene<Term>(L"field", L".*e.{4}"), 100);
+    EXPECT_EQ(bruteForceHits(L".*e.{4}"), searcher->search(query, FilterPtr(), 100)->totalHits);
+    EXPECT_TRUE(query->equals(query->clone()));
+}
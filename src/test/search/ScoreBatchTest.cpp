@@ -0,0 +1,275 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "QueryUtils.h"
+#include "RAMDirectory.h"
+#include "IndexWriter.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "IndexSearcher.h"
+#include "IndexReader.h"
+#include "TermQuery.h"
+#include "BooleanQuery.h"
+#include "ConstantScoreQuery.h"
+#include "QueryWrapperFilter.h"
+#include "Term.h"
+#include "Weight.h"
+#include "ConjunctionScorer.h"
+#include "DisjunctionSumScorer.h"
+#include "BooleanScorer.h"
+#include "Similarity.h"
+#include "Collector.h"
+#include "TopScoreDocCollector.h"
+#include "FlatTopScoreDocCollector.h"
+#include "FlatTopDocs.h"
+#include "TopDocs.h"
+#include "ScoreDoc.h"
+#include "ReaderUtil.h"
+#include "Random.h"
+#include "MiscUtils.h"
+
+using namespace Lucene;
+
+class ScoreBatchTest : public LuceneTestFixture {
+public:
+    ScoreBatchTest() {
+        static const wchar_t* words[] = {L"aaa", L"bbb", L"ccc", L"ddd", L"eee"};
+        dir = newLucene<RAMDirectory>();
+        IndexWriterPtr writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), IndexWriter::MaxFieldLengthUNLIMITED);
+        writer->setMaxBufferedDocs(500);
+        RandomPtr random = newLucene<Random>(11);
+        for (int32_t i = 0; i < 2000; ++i) {
+            String text;
+            for (int32_t word = 0; word < 5; ++word) {
+                // "aaa" is in most docs, "eee" in few, and some docs have a word many times
+                if (random->nextInt(6) > word) {
+                    for (int32_t freq = random->nextInt(40) == 0 ? 40 : random->nextInt(3) + 1; freq > 0; --freq) {
+                        text += String(words[word]) + L" ";
+                    }
+                }
+            }
+            DocumentPtr doc = newLucene<Document>();
+            doc->add(newLucene<Field>(L"content", text, Field::STORE_NO, Field::INDEX_ANALYZED));
+            writer->addDocument(doc);
+        }
+        writer->close();
+        searcher = newLucene<IndexSearcher>(dir, true);
+        readers = Collection<IndexReaderPtr>::newInstance();
+        ReaderUtil::gatherSubReaders(readers, searcher->getIndexReader());
+    }
+
+    virtual ~ScoreBatchTest() {
+        searcher->close();
+        dir->close();
+    }
+
+protected:
+    DirectoryPtr dir;
+    IndexSearcherPtr searcher;
+    Collection<IndexReaderPtr> readers;
+
+public:
+    QueryPtr termQuery(const String& text) {
+        return newLucene<TermQuery>(newLucene<Term>(L"content", text));
+    }
+
+    ScorerPtr termScorer(const String& text, const IndexReaderPtr& reader) {
+        return termQuery(text)->weight(searcher)->scorer(reader, true, false);
+    }
+
+    /// Collects every segment's docs through Scorer::scoreBatches.
+    void collectBatches(const QueryPtr& query, const CollectorPtr& collector) {
+        WeightPtr weight = query->weight(searcher);
+        int32_t docBase = 0;
+        for (Collection<IndexReaderPtr>::iterator reader = readers.begin(); reader != readers.end(); ++reader) {
+            collector->setNextReader(*reader, docBase);
+            ScorerPtr scorer = weight->scorer(*reader, !collector->acceptsDocsOutOfOrder(), true);
+            if (scorer) {
+                scorer->scoreBatches(collector);
+            }
+            docBase += (*reader)->maxDoc();
+        }
+    }
+
+    /// IndexSearcher::search(query, n) collects a batch at a time, while searching with a collector
+    /// collects one doc at a time.
+    void checkSameTopDocs(const QueryPtr& query, int32_t numHits) {
+        TopDocsPtr actual = searcher->search(query, numHits);
+        TopScoreDocCollectorPtr collector = TopScoreDocCollector::create(numHits, !query->weight(searcher)->scoresDocsOutOfOrder());
+        searcher->search(query, collector);
+        TopDocsPtr expected = collector->topDocs();
+
+        EXPECT_EQ(expected->totalHits, actual->totalHits);
+        EXPECT_EQ(expected->scoreDocs.size(), actual->scoreDocs.size());
+        for (int32_t i = 0; i < expected->scoreDocs.size(); ++i) {
+            EXPECT_EQ(expected->scoreDocs[i]->doc, actual->scoreDocs[i]->doc);
+            EXPECT_EQ(expected->scoreDocs[i]->score, actual->scoreDocs[i]->score);
+        }
+    }
+
+    void checkSameFlatTopDocs(const QueryPtr& query, int32_t numHits, bool inOrder) {
+        FlatTopScoreDocCollectorPtr expectedCollector = FlatTopScoreDocCollector::create(numHits, inOrder);
+        searcher->search(query, expectedCollector);
+        FlatTopDocsPtr expected = expectedCollector->flatTopDocs();
+
+        FlatTopScoreDocCollectorPtr collector = FlatTopScoreDocCollector::create(numHits, inOrder);
+        collectBatches(query, collector);
+        FlatTopDocsPtr actual = collector->flatTopDocs();
+
+        EXPECT_EQ(expected->totalHits, actual->totalHits);
+        EXPECT_EQ(expected->scoreDocs.size(), actual->scoreDocs.size());
+        for (int32_t i = 0; i < expected->scoreDocs.size(); ++i) {
+            EXPECT_EQ(expected->scoreDocs[i].doc, actual->scoreDocs[i].doc);
+            EXPECT_EQ(expected->scoreDocs[i].score, actual->scoreDocs[i].score);
+        }
+    }
+};
+
+TEST_F(ScoreBatchTest, testTermScorer) {
+    for (Collection<IndexReaderPtr>::iterator reader = readers.begin(); reader != readers.end(); ++reader) {
+        QueryUtils::checkScoreBatch(termScorer(L"aaa", *reader), termScorer(L"aaa", *reader));
+        QueryUtils::checkScoreBatch(termScorer(L"eee", *reader), termScorer(L"eee", *reader));
+    }
+}
+
+TEST_F(ScoreBatchTest, testConjunctionScorer) {
+    for (Collection<IndexReaderPtr>::iterator reader = readers.begin(); reader != readers.end(); ++reader) {
+        ScorerPtr expected = newLucene<ConjunctionScorer>(Similarity::getDefault(), newCollection<ScorerPtr>(termScorer(L"aaa", *reader), termScorer(L"ddd", *reader)));
+        ScorerPtr actual = newLucene<ConjunctionScorer>(Similarity::getDefault(), newCollection<ScorerPtr>(termScorer(L"aaa", *reader), termScorer(L"ddd", *reader)));
+        QueryUtils::checkScoreBatch(expected, actual);
+    }
+}
+
+TEST_F(ScoreBatchTest, testDisjunctionSumScorer) {
+    for (int32_t minimumNrMatchers = 1; minimumNrMatchers <= 2; ++minimumNrMatchers) {
+        for (Collection<IndexReaderPtr>::iterator reader = readers.begin(); reader != readers.end(); ++reader) {
+            ScorerPtr expected = newLucene<DisjunctionSumScorer>(newCollection<ScorerPtr>(termScorer(L"bbb", *reader), termScorer(L"ddd", *reader), termScorer(L"eee", *reader)), minimumNrMatchers);
+            ScorerPtr actual = newLucene<DisjunctionSumScorer>(newCollection<ScorerPtr>(termScorer(L"bbb", *reader), termScorer(L"ddd", *reader), termScorer(L"eee", *reader)), minimumNrMatchers);
+            QueryUtils::checkScoreBatch(expected, actual);
+        }
+    }
+}
+
+TEST_F(ScoreBatchTest, testConstantScorer) {
+    QueryPtr query = newLucene<ConstantScoreQuery>(newLucene<QueryWrapperFilter>(termQuery(L"ccc")));
+    query->setBoost(2.5);
+    WeightPtr weight = query->weight(searcher);
+    for (Collection<IndexReaderPtr>::iterator reader = readers.begin(); reader != readers.end(); ++reader) {
+        QueryUtils::checkScoreBatch(weight->scorer(*reader, true, false), weight->scorer(*reader, true, false));
+    }
+}
+
+TEST_F(ScoreBatchTest, testBooleanScorer) {
+    BooleanQueryPtr query = newLucene<BooleanQuery>();
+    query->add(termQuery(L"aaa"), BooleanClause::SHOULD);
+    query->add(termQuery(L"ccc"), BooleanClause::SHOULD);
+    query->add(termQuery(L"eee"), BooleanClause::SHOULD);
+    WeightPtr weight = query->weight(searcher);
+    for (Collection<IndexReaderPtr>::iterator reader = readers.begin(); reader != readers.end(); ++reader) {
+        ScorerPtr expected = weight->scorer(*reader, false, true);
+        EXPECT_TRUE(MiscUtils::typeOf<BooleanScorer>(expected));
+        QueryUtils::checkScoreBatch(expected, weight->scorer(*reader, false, true));
+    }
+}
+
+TEST_F(ScoreBatchTest, testQueryUtils) {
+    BooleanQueryPtr query = newLucene<BooleanQuery>();
+    query->add(termQuery(L"bbb"), BooleanClause::MUST);
+    query->add(termQuery(L"ccc"), BooleanClause::SHOULD);
+    query->add(termQuery(L"eee"), BooleanClause::MUST_NOT);
+    QueryUtils::checkScoreBatch(query, searcher);
+    QueryUtils::checkScoreBatch(termQuery(L"ddd"), searcher);
+}
+
+TEST_F(ScoreBatchTest, testSearchMatchesCollect) {
+    BooleanQueryPtr disjunction = newLucene<BooleanQuery>();
+    disjunction->add(termQuery(L"aaa"), BooleanClause::SHOULD);
+    disjunction->add(termQuery(L"ddd"), BooleanClause::SHOULD);
+    BooleanQueryPtr conjunction = newLucene<BooleanQuery>();
+    conjunction->add(termQuery(L"aaa"), BooleanClause::MUST);
+    conjunction->add(termQuery(L"ddd"), BooleanClause::MUST);
+    static const int32_t numHits[] = {1, 10, 1000};
+    for (int32_t i = 0; i < 3; ++i) {
+        checkSameTopDocs(termQuery(L"bbb"), numHits[i]);
+        checkSameTopDocs(disjunction, numHits[i]);
+        checkSameTopDocs(conjunction, numHits[i]);
+        checkSameTopDocs(newLucene<ConstantScoreQuery>(newLucene<QueryWrapperFilter>(termQuery(L"ccc"))), numHits[i]);
+    }
+}
+
+TEST_F(ScoreBatchTest, testFlatCollectBatch) {
+    BooleanQueryPtr disjunction = newLucene<BooleanQuery>();
+    disjunction->add(termQuery(L"bbb"), BooleanClause::SHOULD);
+    disjunction->add(termQuery(L"eee"), BooleanClause::SHOULD);
+    static const int32_t numHits[] = {1, 10, 1000};
+    for (int32_t i = 0; i < 3; ++i) {
+        checkSameFlatTopDocs(termQuery(L"ccc"), numHits[i], true);
+        checkSameFlatTopDocs(disjunction, numHits[i], true);
+        checkSameFlatTopDocs(disjunction, numHits[i], false);
+    }
+}
+
+namespace TestCollectBatch {
+
+DECLARE_SHARED_PTR(RecordingCollector)
+
+/// Relies on the default Collector::collectBatch.
+class RecordingCollector : public Collector {
+public:
+    RecordingCollector() {
+        docs = Collection<int32_t>::newInstance();
+        scores = Collection<double>::newInstance();
+        docBase = 0;
+    }
+
+    virtual ~RecordingCollector() {
+    }
+
+public:
+    Collection<int32_t> docs;
+    Collection<double> scores;
+    ScorerPtr scorer;
+    int32_t docBase;
+
+public:
+    virtual void setScorer(const ScorerPtr& scorer) {
+        this->scorer = scorer;
+    }
+
+    virtual void collect(int32_t doc) {
+        EXPECT_EQ(doc, scorer->docID());
+        docs.add(docBase + doc);
+        scores.add(scorer->score());
+    }
+
+    virtual void setNextReader(const IndexReaderPtr& reader, int32_t docBase) {
+        this->docBase = docBase;
+    }
+
+    virtual bool acceptsDocsOutOfOrder() {
+        return false;
+    }
+};
+
+}
+
+TEST_F(ScoreBatchTest, testCollectBatch) {
+    BooleanQueryPtr query = newLucene<BooleanQuery>();
+    query->add(termQuery(L"ccc"), BooleanClause::MUST);
+    query->add(termQuery(L"ddd"), BooleanClause::SHOULD);
+
+    TestCollectBatch::RecordingCollectorPtr expected = newLucene<TestCollectBatch::RecordingCollector>();
+    searcher->search(query, expected);
+    TestCollectBatch::RecordingCollectorPtr actual = newLucene<TestCollectBatch::RecordingCollector>();
+    collectBatches(query, actual);
+
+    EXPECT_TRUE(expected->docs.size() > Scorer::BATCH_SIZE);
+    EXPECT_TRUE(expected->docs.equals(actual->docs));
+    EXPECT_TRUE(expected->scores.equals(actual->scores));
+}
@@ -24,6 +24,8 @@
 #include "QueryParser.h"
 #include "WhitespaceAnalyzer.h"
 #include "MiscUtils.h"
+#include "WildcardTermEnum.h"
+#include "IndexReader.h"
 
 using namespace Lucene;
 
@@ -300,3 +302,77 @@ TEST_F(WildcardTest, testParsingAndSearching) {
 
     searcher->close();
 }
+
+TEST_F(WildcardTest, testAutomatonMatchesPattern) {
+    // every string of up to 4 characters from a, b and c, plus a few others
+    Collection<String> terms(newCollection<String>(L"\x00e9t\x00e9", L"ab\x1f600", L"\x1f600" L"c", L"zzz"));
+    Collection<String> shorter(newCollection<String>(L""));
+    for (int32_t length = 1; length <= 4; ++length) {
+        Collection<String> strings(Collection<String>::newInstance());
+        for (Collection<String>::iterator prefix = shorter.begin(); prefix != shorter.end(); ++prefix) {
+            for (wchar_t c = L'a'; c <= L'c'; ++c) {
+                strings.add(*prefix + c);
+            }
+        }
+        terms.addAll(strings.begin(), strings.end());
+        shorter = strings;
+    }
+    RAMDirectoryPtr indexStore = newLucene<RAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(indexStore, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED);
+    for (Collection<String>::iterator term = terms.begin(); term != terms.end(); ++term) {
+        DocumentPtr doc = newLucene<Document>();
+        doc->add(newLucene<Field>(L"body", *term, Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+        doc->add(newLucene<Field>(L"title", *term, Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+        writer->addDocument(doc);
+    }
+    writer->close();
+    std::sort(terms.begin(), terms.end());
+    IndexReaderPtr reader = IndexReader::open(indexStore, true);
+
+    static const wchar_t* patterns[] = {L"*", L"?", L"*a", L"a*b", L"?b*", L"*b?c", L"**c", L"a??", L"*?*", L"c*a*b",
+                                        L"ab?c", L"\x00e9*", L"*\x1f600", L"?\x1f600*", L"*z", L"d*", L"abcab*"
+                                       };
+    for (int32_t i = 0; i < (int32_t)(sizeof(patterns) / sizeof(patterns[0])); ++i) {
+        Collection<String> expected(Collection<String>::newInstance());
+        for (Collection<String>::iterator term = terms.begin(); term != terms.end(); ++term) {
+            if (WildcardTermEnum::wildcardEquals(patterns[i], 0, *term, 0)) {
+                expected.add(*term);
+            }
+        }
+        Collection<String> found(Collection<String>::newInstance());
+        FilteredTermEnumPtr termEnum = newLucene<WildcardTermEnum>(reader, newLucene<Term>(L"body", patterns[i]));
+        do {
+            TermPtr term = termEnum->term();
+            if (!term) {
+                break;
+            }
+            EXPECT_EQ(L"body", term->field());
+            EXPECT_EQ(1, termEnum->docFreq());
+            found.add(term->text());
+        } while (termEnum->next());
+        termEnum->close();
+        EXPECT_TRUE(expected.equals(found)) << patterns[i];
+    }
+    reader->close();
+}
+
+TEST_F(WildcardTest, testTooComplexPattern) {
+    String b13(13, L'b');
+    RAMDirectoryPtr indexStore = getIndexStore(L"body", newCollection<String>(L"a" + b13, L"ca" + b13, L"aa" + b13, L"a" + b13 + L"b", L"ba" + b13, String(15, L'b'), L"a" + String(12, L'b')));
+    IndexSearcherPtr searcher = newLucene<IndexSearcher>(indexStore, true);
+
+    // a * followed by an a and 13 ? needs more states than an automaton is allowed
+    String pattern(L"*a" + String(13, L'?'));
+    try {
+        WildcardQuery::toAutomaton(newLucene<Term>(L"body", pattern));
+    } catch (IllegalArgumentException& e) {
+        EXPECT_TRUE(check_exception(LuceneException::IllegalArgument)(e));
+    }
+
+    checkMatches(searcher, newLucene<WildcardQuery>(newLucene<Term>(L"body", pattern)), 4);
+    checkMatches(searcher, newLucene<WildcardQuery>(newLucene<Term>(L"body", L"c" + pattern)), 1);
+    checkMatches(searcher, newLucene<WildcardQuery>(newLucene<Term>(L"body", L"b" + pattern)), 1);
+    checkMatches(searcher, newLucene<WildcardQuery>(newLucene<Term>(L"body", L"d" + pattern)), 0);
+
+    searcher->close();
+}
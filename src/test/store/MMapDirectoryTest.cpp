@@ -16,6 +16,8 @@
 #include "Field.h"
 #include "Random.h"
 #include "FileUtils.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
 
 using namespace Lucene;
 
@@ -65,3 +67,70 @@ TEST_F(MMapDirectoryTest, testMmapIndex) {
 
     FileUtils::removeDirectory(storePathname);
 }
+
+TEST_F(MMapDirectoryTest, testChunkSize) {
+    String storePathname(FileUtils::joinPath(getTempDir(), L"testLuceneMmapChunks"));
+    MMapDirectoryPtr storeDirectory(newLucene<MMapDirectory>(storePathname));
+
+    EXPECT_EQ(MMapDirectory::DEFAULT_MAX_CHUNK_SIZE, storeDirectory->getMaxChunkSize());
+    EXPECT_THROW(storeDirectory->setMaxChunkSize(1), IllegalArgumentException);
+    storeDirectory->setMaxChunkSize(100000);
+    EXPECT_EQ(65536, storeDirectory->getMaxChunkSize());
+    storeDirectory->setMaxChunkSize(65536);
+    EXPECT_EQ(65536, storeDirectory->getMaxChunkSize());
+
+    storeDirectory->close();
+    FileUtils::removeDirectory(storePathname);
+}
+
+TEST_F(MMapDirectoryTest, testReadAcrossChunks) {
+    String storePathname(FileUtils::joinPath(getTempDir(), L"testLuceneMmapChunks"));
+    MMapDirectoryPtr storeDirectory(newLucene<MMapDirectory>(storePathname));
+    storeDirectory->setMaxChunkSize(65536);
+
+    // mix of values so that every kind of read straddles a chunk boundary at some point
+    IndexOutputPtr output = storeDirectory->createOutput(L"chunks");
+    for (int32_t i = 0; i < 20000; ++i) {
+        output->writeByte((uint8_t)i);
+        output->writeVInt(i * 1777);
+        output->writeInt(i * -31);
+        output->writeVLong((int64_t)i * 123456789LL);
+        output->writeLong((int64_t)i * -987654321LL);
+    }
+    output->close();
+
+    IndexInputPtr input = storeDirectory->openInput(L"chunks");
+    int64_t length = input->length();
+    EXPECT_TRUE(length > 3 * storeDirectory->getMaxChunkSize());
+    int64_t midPointer = 0;
+    for (int32_t i = 0; i < 20000; ++i) {
+        if (i == 10000) {
+            midPointer = input->getFilePointer();
+        }
+        EXPECT_EQ((uint8_t)i, input->readByte());
+        EXPECT_EQ(i * 1777, input->readVInt());
+        EXPECT_EQ(i * -31, input->readInt());
+        EXPECT_EQ((int64_t)i * 123456789LL, input->readVLong());
+        EXPECT_EQ((int64_t)i * -987654321LL, input->readLong());
+    }
+    EXPECT_EQ(length, input->getFilePointer());
+    EXPECT_THROW(input->readByte(), IOException);
+
+    // bulk read the whole file and compare against a clone reading byte by byte
+    ByteArray bytes(ByteArray::newInstance((int32_t)length));
+    input->seek(0);
+    input->readBytes(bytes.get(), 0, (int32_t)length);
+    IndexInputPtr clone = boost::dynamic_pointer_cast<IndexInput>(input->clone());
+    clone->seek(midPointer);
+    for (int64_t pos = midPointer; pos < length; ++pos) {
+        EXPECT_EQ(bytes[(int32_t)pos], clone->readByte());
+    }
+
+    input->seek(length);
+    EXPECT_EQ(length, input->getFilePointer());
+    EXPECT_THROW(input->seek(length + 1), IOException);
+
+    input->close();
+    storeDirectory->close();
+    FileUtils::removeDirectory(storePathname);
+}
@@ -0,0 +1,163 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "TestUtils.h"
+#include "NIOFSDirectory.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
+#include "IndexWriter.h"
+#include "IndexSearcher.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "TermQuery.h"
+#include "Term.h"
+#include "TopDocs.h"
+#include "LuceneThread.h"
+#include "FileUtils.h"
+
+using namespace Lucene;
+
+typedef LuceneTestFixture NIOFSDirectoryTest;
+
+DECLARE_SHARED_PTR(NIOFSReaderThread)
+
+class NIOFSReaderThread : public LuceneThread {
+public:
+    NIOFSReaderThread(const IndexInputPtr& input, int32_t count) {
+        this->input = input;
+        this->count = count;
+        failed = false;
+    }
+
+    virtual ~NIOFSReaderThread() {
+    }
+
+    LUCENE_CLASS(NIOFSReaderThread);
+
+public:
+    IndexInputPtr input;
+    int32_t count;
+    bool failed;
+
+public:
+    virtual void run() {
+        try {
+            // read the file backwards in steps so clones are constantly repositioned
+            for (int32_t i = count - 1; i >= 0; i -= 7) {
+                input->seek((int64_t)i * 4);
+                if (input->readInt() != i) {
+                    failed = true;
+                }
+            }
+        } catch (...) {
+            failed = true;
+        }
+    }
+};
+
+TEST_F(NIOFSDirectoryTest, testConcurrentClones) {
+    String storePathname(FileUtils::joinPath(getTempDir(), L"testLuceneNIOFS"));
+    NIOFSDirectoryPtr directory(newLucene<NIOFSDirectory>(storePathname));
+
+    int32_t count = 50000;
+    IndexOutputPtr output = directory->createOutput(L"ints");
+    for (int32_t i = 0; i < count; ++i) {
+        output->writeInt(i);
+    }
+    output->close();
+
+    IndexInputPtr input = directory->openInput(L"ints");
+    EXPECT_EQ((int64_t)count * 4, input->length());
+
+    Collection<NIOFSReaderThreadPtr> threads(Collection<NIOFSReaderThreadPtr>::newInstance(4));
+    for (int32_t i = 0; i < threads.size(); ++i) {
+        threads[i] = newLucene<NIOFSReaderThread>(boost::dynamic_pointer_cast<IndexInput>(input->clone()), count);
+        threads[i]->start();
+    }
+    for (int32_t i = 0; i < count; ++i) {
+        EXPECT_EQ(i, input->readInt());
+    }
+    for (int32_t i = 0; i < threads.size(); ++i) {
+        threads[i]->join();
+        EXPECT_TRUE(!threads[i]->failed);
+    }
+
+    EXPECT_THROW(input->readInt(), IOException);
+
+    input->close();
+    directory->close();
+    FileUtils::removeDirectory(storePathname);
+}
+
+TEST_F(NIOFSDirectoryTest, testCloneOutlivesClose) {
+    String storePathname(FileUtils::joinPath(getTempDir(), L"testLuceneNIOFS"));
+    NIOFSDirectoryPtr directory(newLucene<NIOFSDirectory>(storePathname));
+
+    int32_t count = 1000;
+    IndexOutputPtr output = directory->createOutput(L"ints");
+    for (int32_t i = 0; i < count; ++i) {
+        output->writeInt(i);
+    }
+    output->close();
+
+    IndexInputPtr input = directory->openInput(L"ints");
+    IndexInputPtr clone = boost::dynamic_pointer_cast<IndexInput>(input->clone());
+    input->close();
+    EXPECT_THROW(input->length(), AlreadyClosedException);
+    input->seek(0);
+    EXPECT_THROW(input->readInt(), AlreadyClosedException);
+
+    // open another file, which may be given the descriptor of a closed one
+    IndexOutputPtr otherOutput = directory->createOutput(L"other");
+    for (int32_t i = 0; i < count; ++i) {
+        otherOutput->writeInt(-1);
+    }
+    otherOutput->close();
+    IndexInputPtr other = directory->openInput(L"other");
+
+    // the clone still reads its own file
+    EXPECT_EQ((int64_t)count * 4, clone->length());
+    for (int32_t i = count - 1; i >= 0; i -= 7) {
+        clone->seek((int64_t)i * 4);
+        EXPECT_EQ(i, clone->readInt());
+    }
+
+    other->close();
+    clone.reset();
+    directory->close();
+    FileUtils::removeDirectory(storePathname);
+}
+
+TEST_F(NIOFSDirectoryTest, testIndexAndSearch) {
+    String storePathname(FileUtils::joinPath(getTempDir(), L"testLuceneNIOFS"));
+    DirectoryPtr directory(newLucene<NIOFSDirectory>(storePathname));
+
+    IndexWriterPtr writer = newLucene<IndexWriter>(directory, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED);
+    for (int32_t i = 0; i < 100; ++i) {
+        DocumentPtr doc = newLucene<Document>();
+        doc->add(newLucene<Field>(L"field", i % 2 == 0 ? L"even" : L"odd", Field::STORE_YES, Field::INDEX_ANALYZED));
+        writer->addDocument(doc);
+    }
+    writer->close();
+
+    IndexSearcherPtr searcher = newLucene<IndexSearcher>(directory, true);
+    EXPECT_EQ(50, searcher->search(newLucene<TermQuery>(newLucene<Term>(L"field", L"even")), 10)->totalHits);
+    searcher->close();
+
+    directory->close();
+    FileUtils::removeDirectory(storePathname);
+}
+
+TEST_F(NIOFSDirectoryTest, testFileNotFound) {
+    String storePathname(FileUtils::joinPath(getTempDir(), L"testLuceneNIOFS"));
+    DirectoryPtr directory(newLucene<NIOFSDirectory>(storePathname));
+    EXPECT_THROW(directory->openInput(L"doesnotexist"), FileNotFoundException);
+    directory->close();
+    FileUtils::removeDirectory(storePathname);
+}
@@ -0,0 +1,97 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "RateLimiter.h"
+#include "RateLimitedDirectoryWrapper.h"
+#include "RAMDirectory.h"
+#include "IndexOutput.h"
+#include "IndexInput.h"
+
+using namespace Lucene;
+
+typedef LuceneTestFixture RateLimiterTest;
+
+static const int64_t MB = 1024 * 1024;
+
+TEST_F(RateLimiterTest, testPause) {
+    RateLimiterPtr limiter = newLucene<RateLimiter>(1.0);
+    EXPECT_EQ(1.0, limiter->getMBPerSec());
+    EXPECT_EQ(5242, limiter->getMinPauseCheckBytes()); // 5 msec at 1 MB/sec
+
+    // nothing was written before, so the first bytes go through at once
+    EXPECT_EQ(0, limiter->pause(MB / 4));
+    int64_t paused = limiter->pause(MB / 4);
+    EXPECT_TRUE(paused >= 200 * 1000);
+    EXPECT_EQ(MB / 2, limiter->getTotalBytes());
+    EXPECT_EQ(MB / 4, limiter->getBytesThrottled());
+    EXPECT_EQ(paused / 1000, limiter->getPausedMillis());
+}
+
+TEST_F(RateLimiterTest, testUnlimited) {
+    RateLimiterPtr limiter = newLucene<RateLimiter>(0.0);
+    EXPECT_EQ(INT64_MAX, limiter->getMinPauseCheckBytes());
+    for (int32_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(0, limiter->pause(100 * MB));
+    }
+    EXPECT_EQ(1000 * MB, limiter->getTotalBytes());
+    EXPECT_EQ(0, limiter->getBytesThrottled());
+}
+
+TEST_F(RateLimiterTest, testParent) {
+    RateLimiterPtr parent = newLucene<RateLimiter>(1.0);
+    RateLimiterPtr first = newLucene<RateLimiter>(0.0, parent);
+    RateLimiterPtr second = newLucene<RateLimiter>(10.0, parent);
+    EXPECT_EQ(parent->getMinPauseCheckBytes(), first->getMinPauseCheckBytes());
+    EXPECT_EQ(parent->getMinPauseCheckBytes(), second->getMinPauseCheckBytes());
+
+    // the children share the rate of the parent
+    first->pause(MB / 4);
+    EXPECT_TRUE(second->pause(MB / 4) >= 200 * 1000);
+    EXPECT_TRUE(first->pause(MB / 4) >= 200 * 1000);
+    EXPECT_EQ(3 * MB / 4, parent->getTotalBytes());
+    EXPECT_EQ(MB / 4, first->getBytesThrottled());
+    EXPECT_EQ(MB / 4, second->getBytesThrottled());
+
+    parent->setMBPerSec(0.0);
+    EXPECT_EQ(0, first->pause(MB));
+}
+
+TEST_F(RateLimiterTest, testRateLimitedDirectory) {
+    RAMDirectoryPtr ramDir = newLucene<RAMDirectory>();
+    RateLimiterPtr limiter = newLucene<RateLimiter>(1.0);
+    RateLimitedDirectoryWrapperPtr dir = newLucene<RateLimitedDirectoryWrapper>(ramDir, limiter);
+
+    ByteArray bytes(ByteArray::newInstance(MB / 32));
+    for (int32_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = (uint8_t)i;
+    }
+    IndexOutputPtr output = dir->createOutput(L"test");
+    for (int32_t i = 0; i < 16; ++i) {
+        output->writeBytes(bytes.get(), bytes.size());
+    }
+    output->writeByte(1);
+    output->close();
+
+    // the bytes written up to closing are accounted for
+    EXPECT_EQ(MB / 2 + 1, limiter->getTotalBytes());
+    EXPECT_TRUE(limiter->getBytesThrottled() > 0);
+    EXPECT_TRUE(limiter->getPausedMillis() >= 300);
+
+    EXPECT_TRUE(ramDir->fileExists(L"test"));
+    EXPECT_EQ(MB / 2 + 1, dir->fileLength(L"test"));
+    IndexInputPtr input = dir->openInput(L"test");
+    input->seek(MB / 2 - 1);
+    EXPECT_EQ(bytes[bytes.size() - 1], input->readByte());
+    EXPECT_EQ(1, input->readByte());
+    input->close();
+
+    // closing the wrapper leaves the wrapped directory open
+    dir->close();
+    EXPECT_TRUE(ramDir->fileExists(L"test"));
+    ramDir->close();
+}
@@ -7,6 +7,7 @@
 #include "TestInc.h"
 #include "LuceneTestFixture.h"
 #include "CompressionTools.h"
+#include "Random.h"
 
 using namespace Lucene;
 
@@ -19,3 +20,41 @@ TEST_F(CompressionToolsTest, testCompressDecompress) {
     String decompress(CompressionTools::decompressString(compress));
     EXPECT_EQ(decompress, L"test compressed string");
 }
+
+TEST_F(CompressionToolsTest, testCompressFast) {
+    RandomPtr random = newLucene<Random>(123);
+    for (int32_t iter = 0; iter < 50; ++iter) {
+        int32_t length = iter == 0 ? 0 : random->nextInt(20000);
+        ByteArray bytes(ByteArray::newInstance(std::max(length, 1)));
+        int32_t alphabet = 1 + random->nextInt(iter % 2 == 0 ? 4 : 256);
+        for (int32_t i = 0; i < length; ++i) {
+            // runs and repeats as well as random bytes
+            bytes[i] = (i > 100 && random->nextInt(3) == 0) ? bytes[i - 1 - random->nextInt(100)] : (uint8_t)random->nextInt(alphabet);
+        }
+        ByteArray compressed(CompressionTools::compressFast(bytes.get(), 0, length));
+        if (alphabet <= 4) {
+            EXPECT_TRUE(compressed.size() <= length * 3 / 4 + 16);
+        }
+        ByteArray decompressed(ByteArray::newInstance(std::max(length, 1)));
+        CompressionTools::decompressFast(compressed.get(), compressed.size(), decompressed.get(), length);
+        for (int32_t i = 0; i < length; ++i) {
+            EXPECT_EQ(bytes[i], decompressed[i]);
+        }
+
+        // corrupt data is detected rather than read out of bounds
+        if (length > 0) {
+            try {
+                CompressionTools::decompressFast(compressed.get(), compressed.size(), decompressed.get(), length - 1);
+                EXPECT_TRUE(false);
+            } catch (CompressionException& e) {
+                EXPECT_TRUE(check_exception(LuceneException::Compression)(e));
+            }
+            try {
+                CompressionTools::decompressFast(compressed.get(), compressed.size() - 1, decompressed.get(), length);
+                EXPECT_TRUE(false);
+            } catch (CompressionException& e) {
+                EXPECT_TRUE(check_exception(LuceneException::Compression)(e));
+            }
+        }
+    }
+}
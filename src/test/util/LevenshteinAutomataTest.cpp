@@ -0,0 +1,151 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "LevenshteinAutomata.h"
+#include "Automaton.h"
+
+using namespace Lucene;
+
+typedef LuceneTestFixture LevenshteinAutomataTest;
+
+/// Optimal string alignment distance, or the Levenshtein distance without transpositions.
+static int32_t editDistance(const String& s1, const String& s2, bool transpositions) {
+    int32_t n = s1.length();
+    int32_t m = s2.length();
+    Collection< Collection<int32_t> > d = Collection< Collection<int32_t> >::newInstance(n + 1);
+    for (int32_t i = 0; i <= n; ++i) {
+        d[i] = Collection<int32_t>::newInstance(m + 1);
+        d[i][0] = i;
+    }
+    for (int32_t j = 0; j <= m; ++j) {
+        d[0][j] = j;
+    }
+    for (int32_t i = 1; i <= n; ++i) {
+        for (int32_t j = 1; j <= m; ++j) {
+            int32_t cost = s1[i - 1] == s2[j - 1] ? 0 : 1;
+            d[i][j] = std::min(std::min(d[i - 1][j] + 1, d[i][j - 1] + 1), d[i - 1][j - 1] + cost);
+            if (transpositions && i > 1 && j > 1 && s1[i - 1] == s2[j - 2] && s1[i - 2] == s2[j - 1]) {
+                d[i][j] = std::min(d[i][j], d[i - 2][j - 2] + 1);
+            }
+        }
+    }
+    return d[n][m];
+}
+
+/// All the strings of up to maxLength characters from alphabet.
+static Collection<String> allStrings(const String& alphabet, int32_t maxLength) {
+    Collection<String> strings(newCollection<String>(L""));
+    for (int32_t start = 0, length = 1; length <= maxLength; ++length) {
+        int32_t end = strings.size();
+        for (int32_t i = start; i < end; ++i) {
+            for (String::const_iterator c = alphabet.begin(); c != alphabet.end(); ++c) {
+                strings.add(strings[i] + *c);
+            }
+        }
+        start = end;
+    }
+    return strings;
+}
+
+static void checkAutomata(const String& input, bool transpositions) {
+    Collection<String> strings(allStrings(L"abc", (int32_t)input.length() + 2));
+    LevenshteinAutomataPtr builder(newLucene<LevenshteinAutomata>(input, transpositions));
+    for (int32_t n = 0; n <= LevenshteinAutomata::MAXIMUM_SUPPORTED_DISTANCE; ++n) {
+        AutomatonPtr automaton(builder->toAutomaton(n));
+        EXPECT_TRUE(automaton->isDeterministic());
+        EXPECT_TRUE(automaton->isFinite());
+        for (Collection<String>::iterator s = strings.begin(); s != strings.end(); ++s) {
+            EXPECT_EQ(editDistance(input, *s, transpositions) <= n, automaton->run(*s)) << input << L" " << *s << L" " << n;
+        }
+        // characters outside the alphabet are edits too
+        EXPECT_EQ(n >= 1, automaton->run(input + L"\x1f600"));
+        EXPECT_EQ(n >= 1 || input.empty(), automaton->run(input.empty() ? String() : L"\x00e9" + input.substr(1)));
+    }
+}
+
+TEST_F(LevenshteinAutomataTest, testLevenshtein) {
+    static const wchar_t* inputs[] = {L"", L"a", L"ab", L"abc", L"aab", L"abca", L"cbaa"};
+    for (int32_t i = 0; i < (int32_t)(sizeof(inputs) / sizeof(inputs[0])); ++i) {
+        checkAutomata(inputs[i], false);
+    }
+}
+
+TEST_F(LevenshteinAutomataTest, testTranspositions) {
+    static const wchar_t* inputs[] = {L"", L"a", L"ab", L"abc", L"aab", L"abca", L"cbaa"};
+    for (int32_t i = 0; i < (int32_t)(sizeof(inputs) / sizeof(inputs[0])); ++i) {
+        checkAutomata(inputs[i], true);
+    }
+    AutomatonPtr automaton(newLucene<LevenshteinAutomata>(L"abcd", true)->toAutomaton(1));
+    EXPECT_TRUE(automaton->run(L"bacd"));
+    EXPECT_TRUE(automaton->run(L"abdc"));
+    EXPECT_TRUE(!automaton->run(L"badc"));
+    automaton = newLucene<LevenshteinAutomata>(L"abcd", false)->toAutomaton(1);
+    EXPECT_TRUE(!automaton->run(L"bacd"));
+}
+
+TEST_F(LevenshteinAutomataTest, testPrefix) {
+    LevenshteinAutomataPtr builder(newLucene<LevenshteinAutomata>(L"bcd", false));
+    AutomatonPtr automaton(builder->toAutomaton(1, L"aa"));
+    EXPECT_TRUE(automaton->run(L"aabcd"));
+    EXPECT_TRUE(automaton->run(L"aabd"));
+    EXPECT_TRUE(automaton->run(L"aabcde"));
+    EXPECT_TRUE(automaton->run(L"aaxcd"));
+    EXPECT_TRUE(!automaton->run(L"abbcd"));
+    EXPECT_TRUE(!automaton->run(L"bcd"));
+    EXPECT_TRUE(!automaton->run(L"aab"));
+}
+
+TEST_F(LevenshteinAutomataTest, testMaximumSupportedDistance) {
+    LevenshteinAutomataPtr builder(newLucene<LevenshteinAutomata>(L"lucene", true));
+    EXPECT_TRUE(builder->toAutomaton(LevenshteinAutomata::MAXIMUM_SUPPORTED_DISTANCE));
+    EXPECT_TRUE(!builder->toAutomaton(LevenshteinAutomata::MAXIMUM_SUPPORTED_DISTANCE + 1));
+    try {
+        builder->toAutomaton(-1);
+    } catch (IllegalArgumentException& e) {
+        EXPECT_TRUE(check_exception(LuceneException::IllegalArgument)(e));
+    }
+}
+
+TEST_F(LevenshteinAutomataTest, testDeterminize) {
+    // (a|ab)b* with an epsilon transition
+    AutomatonPtr nfa(newLucene<Automaton>());
+    int32_t start = nfa->createState();
+    int32_t a = nfa->createState();
+    int32_t ab = nfa->createState();
+    int32_t loop = nfa->createState();
+    int32_t dead = nfa->createState();
+    nfa->addTransition(start, a, L'a');
+    nfa->addTransition(start, ab, L'a');
+    nfa->addTransition(ab, loop, L'b');
+    nfa->addEpsilon(a, loop);
+    nfa->addTransition(loop, loop, L'b');
+    nfa->addTransition(loop, dead, L'c');
+    nfa->setAccept(loop, true);
+    EXPECT_TRUE(!nfa->isDeterministic());
+
+    AutomatonPtr dfa(nfa->determinize());
+    EXPECT_TRUE(dfa->isDeterministic());
+    EXPECT_TRUE(!dfa->isFinite());
+    EXPECT_TRUE(!dfa->isEmpty());
+    EXPECT_TRUE(dfa->run(L"a"));
+    EXPECT_TRUE(dfa->run(L"ab"));
+    EXPECT_TRUE(dfa->run(L"abbb"));
+    EXPECT_TRUE(!dfa->run(L""));
+    EXPECT_TRUE(!dfa->run(L"abc"));
+    EXPECT_TRUE(!dfa->run(L"b"));
+    // the dead state is gone, so every state but the initial one can reach an accepting state
+    for (int32_t state = 0; state < dfa->getNumStates(); ++state) {
+        EXPECT_TRUE(dfa->isAccept(state) || dfa->getNumTransitions(state) > 0);
+        for (int32_t i = 1; i < dfa->getNumTransitions(state); ++i) {
+            EXPECT_TRUE(dfa->getTransition(state, i - 1).max < dfa->getTransition(state, i).min);
+        }
+    }
+
+    nfa->setAccept(loop, false);
+    EXPECT_TRUE(nfa->determinize()->isEmpty());
+}
@@ -0,0 +1,82 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "Term.h"
+
+using namespace Lucene;
+
+class LuceneAllocatorTest : public LuceneTestFixture {
+public:
+    virtual ~LuceneAllocatorTest() {
+        SetMemoryStats(false);
+        SetMemoryPooling(true);
+    }
+};
+
+TEST_F(LuceneAllocatorTest, testRealloc) {
+    // grow from a cached size to an uncached one and back, keeping the contents
+    uint8_t* memory = (uint8_t*)AllocMemory(10);
+    for (int32_t i = 0; i < 10; ++i) {
+        memory[i] = (uint8_t)i;
+    }
+    static const size_t sizes[] = {16, 100, 512, 513, 4000, 600, 300, 5};
+    size_t size = 10;
+    for (int32_t s = 0; s < (int32_t)(sizeof(sizes) / sizeof(sizes[0])); ++s) {
+        memory = (uint8_t*)ReallocMemory(memory, sizes[s]);
+        for (size_t i = size; i < sizes[s]; ++i) {
+            memory[i] = (uint8_t)i;
+        }
+        size = sizes[s];
+        for (size_t i = 0; i < size; ++i) {
+            EXPECT_EQ((uint8_t)i, memory[i]);
+        }
+    }
+    FreeMemory(memory);
+    EXPECT_TRUE(ReallocMemory(AllocMemory(10), 0) == NULL);
+}
+
+TEST_F(LuceneAllocatorTest, testPooledBlocksAreReused) {
+    SetMemoryPooling(true);
+    FreeMemory(AllocMemory(40)); // so the first block comes from the pool too, whatever earlier tests left in it
+    SetMemoryStats(true);
+    void* memory = AllocMemory(40);
+    FreeMemory(memory);
+    EXPECT_EQ(memory, AllocMemory(48)); // same size class
+    FreeMemory(memory);
+    MemoryStats stats = GetMemoryStats();
+    EXPECT_EQ(2, stats.allocations);
+    EXPECT_EQ(2, stats.frees);
+    EXPECT_EQ(2, stats.pooledAllocations);
+    EXPECT_EQ(88, stats.bytesAllocated);
+    EXPECT_EQ(0, stats.bytesInUse);
+}
+
+TEST_F(LuceneAllocatorTest, testWithoutPooling) {
+    SetMemoryPooling(false);
+    SetMemoryStats(true);
+    for (int32_t i = 0; i < 10; ++i) {
+        FreeMemory(AllocMemory(32));
+    }
+    MemoryStats stats = GetMemoryStats();
+    EXPECT_EQ(10, stats.allocations);
+    EXPECT_EQ(0, stats.pooledAllocations);
+    EXPECT_EQ(0, stats.bytesInUse);
+}
+
+TEST_F(LuceneAllocatorTest, testObjectsArePooled) {
+    SetMemoryPooling(true);
+    SetMemoryStats(true);
+    for (int32_t i = 0; i < 100; ++i) {
+        TermPtr term = newLucene<Term>(L"field", L"text");
+        EXPECT_EQ(L"text", term->text());
+    }
+    MemoryStats stats = GetMemoryStats();
+    EXPECT_TRUE(stats.allocations >= 100);
+    EXPECT_TRUE(stats.pooledAllocations >= 99);
+    EXPECT_EQ(0, stats.bytesInUse);
+}
@@ -0,0 +1,66 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "PackedInts.h"
+#include "RAMDirectory.h"
+#include "IndexOutput.h"
+#include "IndexInput.h"
+#include "Random.h"
+
+using namespace Lucene;
+
+typedef LuceneTestFixture PackedIntsTest;
+
+TEST_F(PackedIntsTest, testBitsRequired) {
+    EXPECT_EQ(0, PackedInts::bitsRequired(0));
+    EXPECT_EQ(1, PackedInts::bitsRequired(1));
+    EXPECT_EQ(2, PackedInts::bitsRequired(3));
+    EXPECT_EQ(3, PackedInts::bitsRequired(4));
+    EXPECT_EQ(31, PackedInts::bitsRequired(INT_MAX));
+    EXPECT_EQ(63, PackedInts::bitsRequired(LLONG_MAX));
+    EXPECT_EQ(64, PackedInts::bitsRequired(-1));
+}
+
+TEST_F(PackedIntsTest, testSetAndGet) {
+    RandomPtr random(newLucene<Random>(42));
+    DirectoryPtr dir(newLucene<RAMDirectory>());
+    for (int32_t bits = 0; bits <= 64; ++bits) {
+        int32_t size = 1 + random->nextInt(300);
+        PackedIntsPtr packed(newLucene<PackedInts>(size, bits));
+        EXPECT_EQ(bits, packed->getBitsPerValue());
+        EXPECT_EQ(size, packed->size());
+
+        uint64_t mask = bits == 64 ? (uint64_t)-1 : (((uint64_t)1 << bits) - 1);
+        Collection<int64_t> values(Collection<int64_t>::newInstance(size));
+        for (int32_t i = 0; i < size; ++i) {
+            uint64_t value = ((uint64_t)random->nextInt() << 33) ^ ((uint64_t)random->nextInt() << 2) ^ (uint64_t)random->nextInt(4);
+            values[i] = (int64_t)(value & mask);
+            packed->set(i, values[i]);
+        }
+        // overwriting a value leaves its neighbours alone
+        if (size > 2) {
+            values[1] = (int64_t)mask;
+            packed->set(1, values[1]);
+        }
+        for (int32_t i = 0; i < size; ++i) {
+            EXPECT_EQ(values[i], packed->get(i));
+        }
+
+        IndexOutputPtr out(dir->createOutput(L"packed"));
+        packed->write(out);
+        out->close();
+        IndexInputPtr in(dir->openInput(L"packed"));
+        PackedIntsPtr read(PackedInts::read(in, size));
+        EXPECT_EQ(in->length(), in->getFilePointer());
+        in->close();
+        EXPECT_EQ(bits, read->getBitsPerValue());
+        for (int32_t i = 0; i < size; ++i) {
+            EXPECT_EQ(values[i], read->get(i));
+        }
+    }
+}
@@ -0,0 +1,134 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include <regex>
+#include "LuceneTestFixture.h"
+#include "RegExp.h"
+#include "Automaton.h"
+#include "MiscUtils.h"
+
+using namespace Lucene;
+
+typedef LuceneTestFixture RegExpTest;
+
+/// All the strings of up to maxLength characters from alphabet.
+static Collection<String> allStrings(const String& alphabet, int32_t maxLength) {
+    Collection<String> strings(newCollection<String>(L""));
+    for (int32_t start = 0, length = 1; length <= maxLength; ++length) {
+        int32_t end = strings.size();
+        for (int32_t i = start; i < end; ++i) {
+            for (String::const_iterator c = alphabet.begin(); c != alphabet.end(); ++c) {
+                strings.add(strings[i] + *c);
+            }
+        }
+        start = end;
+    }
+    return strings;
+}
+
+static void checkAgainstRegex(const String& pattern) {
+    AutomatonPtr automaton(newLucene<RegExp>(pattern)->toAutomaton());
+    EXPECT_TRUE(automaton->isDeterministic());
+    std::wregex regex(pattern);
+    Collection<String> strings(allStrings(L"abcd", 5));
+    for (Collection<String>::iterator s = strings.begin(); s != strings.end(); ++s) {
+        EXPECT_EQ(std::regex_match(*s, regex), automaton->run(*s)) << pattern << L" on " << *s;
+    }
+}
+
+static void checkInvalid(const String& pattern) {
+    try {
+        newLucene<RegExp>(pattern);
+    } catch (LuceneException& e) {
+        EXPECT_TRUE(check_exception(LuceneException::IllegalArgument)(e));
+    }
+}
+
+TEST_F(RegExpTest, testMatchesStandardRegex) {
+    checkAgainstRegex(L"abc");
+    checkAgainstRegex(L"a|bc|d");
+    checkAgainstRegex(L"(a|b)*c");
+    checkAgainstRegex(L"a+b?c*");
+    checkAgainstRegex(L"a{2}");
+    checkAgainstRegex(L"(ab){1,2}c");
+    checkAgainstRegex(L"a{2,}b");
+    checkAgainstRegex(L"a{0,3}");
+    checkAgainstRegex(L"[ab]c");
+    checkAgainstRegex(L"[^ab]+");
+    checkAgainstRegex(L"[a-c]*d");
+    checkAgainstRegex(L"[b-da]{2}");
+    checkAgainstRegex(L".b.");
+    checkAgainstRegex(L".*d.*");
+    checkAgainstRegex(L"((a|b)(c|d))+");
+    checkAgainstRegex(L"(a*)*b");
+    checkAgainstRegex(L"a\\*|b");
+}
+
+TEST_F(RegExpTest, testQuotedAndEmpty) {
+    AutomatonPtr automaton(newLucene<RegExp>(L"\"a*b\"c?")->toAutomaton());
+    EXPECT_TRUE(automaton->run(L"a*b"));
+    EXPECT_TRUE(automaton->run(L"a*bc"));
+    EXPECT_FALSE(automaton->run(L"aab"));
+
+    automaton = newLucene<RegExp>(L"")->toAutomaton();
+    EXPECT_TRUE(automaton->run(L""));
+    EXPECT_FALSE(automaton->run(L"a"));
+
+    automaton = newLucene<RegExp>(L"a()b")->toAutomaton();
+    EXPECT_TRUE(automaton->run(L"ab"));
+    EXPECT_FALSE(automaton->run(L"a"));
+}
+
+TEST_F(RegExpTest, testNonAscii) {
+    AutomatonPtr automaton(newLucene<RegExp>(L"[\x00e0-\x00ff]+\x1f600?")->toAutomaton());
+    EXPECT_TRUE(automaton->run(L"\x00e9\x00e8\x00e9"));
+    EXPECT_TRUE(automaton->run(L"\x00e9\x1f600"));
+    EXPECT_FALSE(automaton->run(L"\x1f600"));
+    EXPECT_FALSE(automaton->run(L"ete"));
+}
+
+TEST_F(RegExpTest, testMinimize) {
+    EXPECT_EQ(1, newLucene<RegExp>(L"(a|b)*")->toAutomaton()->getNumStates());
+    EXPECT_EQ(1, newLucene<RegExp>(L"[ab]*")->toAutomaton()->getNumStates());
+    EXPECT_EQ(1, newLucene<RegExp>(L".*")->toAutomaton()->getNumStates());
+    EXPECT_EQ(2, newLucene<RegExp>(L"a+")->toAutomaton()->getNumStates());
+    EXPECT_EQ(newLucene<RegExp>(L"(ab|ac)d")->toAutomaton()->getNumStates(), newLucene<RegExp>(L"a[bc]d")->toAutomaton()->getNumStates());
+    EXPECT_EQ(newLucene<RegExp>(L"a{2,}")->toAutomaton()->getNumStates(), newLucene<RegExp>(L"aaa*")->toAutomaton()->getNumStates());
+}
+
+TEST_F(RegExpTest, testFinite) {
+    EXPECT_TRUE(newLucene<RegExp>(L"a{1,5}b?")->toAutomaton()->isFinite());
+    EXPECT_FALSE(newLucene<RegExp>(L"ab*")->toAutomaton()->isFinite());
+}
+
+TEST_F(RegExpTest, testInvalid) {
+    checkInvalid(L"a{3,2}");
+    checkInvalid(L"(a");
+    checkInvalid(L"[a");
+    checkInvalid(L"a)");
+    checkInvalid(L"[c-a]");
+    checkInvalid(L"a{x}");
+    checkInvalid(L"a|");
+    checkInvalid(L"\"ab");
+}
+
+TEST_F(RegExpTest, testTooComplex) {
+    int64_t start = MiscUtils::currentTimeMillis();
+    EXPECT_THROW(newLucene<RegExp>(L"a{0,999999999}")->toAutomaton(), IllegalArgumentException);
+    EXPECT_THROW(newLucene<RegExp>(L"(a{1000}){1000}")->toAutomaton(), IllegalArgumentException);
+    EXPECT_THROW(newLucene<RegExp>(L"(a|b)*a(a|b){25}")->toAutomaton(), IllegalArgumentException);
+    EXPECT_THROW(newLucene<RegExp>(L".*a.{30}")->toAutomaton(), IllegalArgumentException);
+    EXPECT_THROW(newLucene<RegExp>(L"(a|b)*a(a|b){5}")->toAutomaton(16), IllegalArgumentException);
+    EXPECT_TRUE(MiscUtils::currentTimeMillis() - start < 10000);
+
+    // within the limit
+    EXPECT_TRUE(newLucene<RegExp>(L"a{0,50}")->toAutomaton()->run(String(50, L'a')));
+    AutomatonPtr automaton(newLucene<RegExp>(L"(a|b)*a(a|b){5}")->toAutomaton());
+    EXPECT_EQ(64, automaton->getNumStates());
+    EXPECT_TRUE(automaton->run(L"bbabbbbb"));
+    EXPECT_FALSE(automaton->run(L"bbbabbbb"));
+}
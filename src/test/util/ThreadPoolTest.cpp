@@ -0,0 +1,117 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2014 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include <boost/bind/protect.hpp>
+#include "ThreadPool.h"
+#include "LuceneThread.h"
+
+using namespace Lucene;
+
+typedef LuceneTestFixture ThreadPoolTest;
+
+static int32_t square(int32_t value) {
+    return value * value;
+}
+
+static int32_t slowSquare(int32_t value) {
+    LuceneThread::threadSleep(5);
+    return value * value;
+}
+
+static int32_t slowThreadCount(const ThreadPoolPtr& threadPool) {
+    LuceneThread::threadSleep(5);
+    return threadPool->getThreadCount();
+}
+
+static int32_t failingTask(int32_t value) {
+    boost::throw_exception(IOException(L"task failed"));
+    return value;
+}
+
+static int32_t sumOfSquares(const ThreadPoolPtr& threadPool, int32_t count) {
+    Collection<FuturePtr> futures(Collection<FuturePtr>::newInstance(count));
+    for (int32_t i = 0; i < count; ++i) {
+        futures[i] = threadPool->scheduleTask(boost::protect(boost::bind<int32_t>(square, i)));
+    }
+    int32_t sum = 0;
+    for (int32_t i = 0; i < count; ++i) {
+        sum += futures[i]->get<int32_t>();
+    }
+    return sum;
+}
+
+TEST_F(ThreadPoolTest, testThreadCount) {
+    EXPECT_EQ(3, newLucene<ThreadPool>(3)->getThreadCount());
+    EXPECT_EQ(ThreadPool::getDefaultThreadCount(), newLucene<ThreadPool>()->getThreadCount());
+    EXPECT_TRUE(ThreadPool::getDefaultThreadCount() >= 1);
+    EXPECT_THROW(newLucene<ThreadPool>(-1), IllegalArgumentException);
+}
+
+TEST_F(ThreadPoolTest, testScheduleTasks) {
+    ThreadPoolPtr threadPool = newLucene<ThreadPool>(4);
+    Collection<FuturePtr> futures(Collection<FuturePtr>::newInstance(100));
+    for (int32_t i = 0; i < futures.size(); ++i) {
+        futures[i] = threadPool->scheduleTask(boost::protect(boost::bind<int32_t>(slowSquare, i)));
+    }
+    for (int32_t i = 0; i < futures.size(); ++i) {
+        EXPECT_EQ(i * i, futures[i]->get<int32_t>());
+        EXPECT_TRUE(futures[i]->isDone());
+    }
+    EXPECT_TRUE(threadPool->getCompletedTaskCount() >= 99);
+    EXPECT_EQ(0, threadPool->getQueueDepth());
+}
+
+TEST_F(ThreadPoolTest, testNestedTasks) {
+    // a single worker must not deadlock when a task waits on sub-tasks scheduled on the same pool
+    ThreadPoolPtr threadPool = newLucene<ThreadPool>(1);
+    FuturePtr future = threadPool->scheduleTask(boost::protect(boost::bind<int32_t>(sumOfSquares, threadPool, 10)));
+    EXPECT_EQ(285, future->get<int32_t>());
+    EXPECT_TRUE(threadPool->getCompletedTaskCount() >= 10);
+}
+
+TEST_F(ThreadPoolTest, testTaskException) {
+    ThreadPoolPtr threadPool = newLucene<ThreadPool>(2);
+    FuturePtr failed = threadPool->scheduleTask(boost::protect(boost::bind<int32_t>(failingTask, 1)));
+    FuturePtr succeeded = threadPool->scheduleTask(boost::protect(boost::bind<int32_t>(square, 3)));
+    try {
+        failed->get<int32_t>();
+        FAIL() << "expected the task's exception";
+    } catch (IOException& e) {
+        EXPECT_EQ(L"task failed", e.getError());
+    }
+    EXPECT_TRUE(failed->isDone());
+    EXPECT_EQ(9, succeeded->get<int32_t>());
+}
+
+TEST_F(ThreadPoolTest, testQueuedTasksComplete) {
+    ThreadPoolPtr threadPool = newLucene<ThreadPool>(1);
+    Collection<FuturePtr> futures(Collection<FuturePtr>::newInstance(100));
+    for (int32_t i = 0; i < futures.size(); ++i) {
+        futures[i] = threadPool->scheduleTask(boost::protect(boost::bind<int32_t>(square, i)));
+    }
+    threadPool.reset(); // tasks may still be queued
+    for (int32_t i = 0; i < futures.size(); ++i) {
+        EXPECT_TRUE(futures[i]->isDone());
+        EXPECT_EQ(i * i, futures[i]->get<int32_t>());
+    }
+}
+
+TEST_F(ThreadPoolTest, testReleasedByTask) {
+    // the last reference to a pool may be held by one of its own tasks
+    for (int32_t i = 0; i < 10; ++i) {
+        ThreadPoolPtr threadPool = newLucene<ThreadPool>(2);
+        FuturePtr future = threadPool->scheduleTask(boost::protect(boost::bind<int32_t>(slowThreadCount, threadPool)));
+        threadPool.reset();
+        EXPECT_EQ(2, future->get<int32_t>());
+    }
+}
+
+TEST_F(ThreadPoolTest, testInstance) {
+    EXPECT_EQ(ThreadPool::getInstance(), ThreadPool::getInstance());
+    EXPECT_EQ(ThreadPool::getDefaultThreadCount(), ThreadPool::getInstance()->getThreadCount());
+}